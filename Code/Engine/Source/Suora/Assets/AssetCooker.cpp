@@ -0,0 +1,474 @@
+#include "Precompiled.h"
+#include "AssetCooker.h"
+#include <unordered_map>
+#include <unordered_set>
+#include <fstream>
+#include <chrono>
+#include <cstring>
+#include "AssetManager.h"
+#include "DerivedDataCache.h"
+#include "VirtualFileSystem.h"
+#include "SuoraProject.h"
+#include "Level.h"
+#include "Mesh.h"
+#include "Font.h"
+#include "Texture2D.h"
+#include "Suora/Renderer/TexturePipeline.h"
+#include "Suora/Platform/Platform.h"
+
+namespace Suora
+{
+	static constexpr uint32_t CookedYamlMagic = 0x31425953; // "SYB1"
+	static constexpr uint32_t CookedYamlMaxDepth = 256;
+
+	static void WriteVarUInt(std::vector<uint8_t>& data, uint64_t value)
+	{
+		while (value >= 0x80)
+		{
+			data.push_back((uint8_t)(value | 0x80));
+			value >>= 7;
+		}
+		data.push_back((uint8_t)value);
+	}
+
+	static bool ReadVarUInt(const uint8_t* data, size_t size, size_t& offset, uint64_t& value)
+	{
+		value = 0;
+		for (uint32_t shift = 0; shift < 64; shift += 7)
+		{
+			if (offset >= size) return false;
+			const uint8_t byte = data[offset++];
+			value |= (uint64_t)(byte & 0x7F) << shift;
+			if (!(byte & 0x80)) return true;
+		}
+		return false;
+	}
+
+	static void WriteString(std::vector<uint8_t>& data, const String& str)
+	{
+		WriteVarUInt(data, str.size());
+		data.insert(data.end(), str.begin(), str.end());
+	}
+
+	static bool ReadString(const uint8_t* data, size_t size, size_t& offset, String& str)
+	{
+		uint64_t length = 0;
+		if (!ReadVarUInt(data, size, offset, length) || length > size - offset) return false;
+		str.assign((const char*)data + offset, (size_t)length);
+		offset += (size_t)length;
+		return true;
+	}
+
+	static void WriteYamlNode(std::vector<uint8_t>& data, const Yaml::Node& node)
+	{
+		data.push_back((uint8_t)node.Type());
+		switch (node.Type())
+		{
+		case Yaml::Node::ScalarType:
+			WriteString(data, node.As<String>());
+			break;
+		case Yaml::Node::MapType:
+			WriteVarUInt(data, node.Size());
+			for (auto it = node.Begin(); it != node.End(); it++)
+			{
+				WriteString(data, (*it).first);
+				WriteYamlNode(data, (*it).second);
+			}
+			break;
+		case Yaml::Node::SequenceType:
+			WriteVarUInt(data, node.Size());
+			for (auto it = node.Begin(); it != node.End(); it++)
+			{
+				WriteYamlNode(data, (*it).second);
+			}
+			break;
+		default:
+			break;
+		}
+	}
+
+	static bool ReadYamlNode(const uint8_t* data, size_t size, size_t& offset, Yaml::Node& node, uint32_t depth)
+	{
+		if (offset >= size || depth > CookedYamlMaxDepth) return false;
+
+		const uint8_t type = data[offset++];
+		uint64_t count = 0;
+		String str;
+		switch (type)
+		{
+		case Yaml::Node::None:
+			return true;
+		case Yaml::Node::ScalarType:
+			if (!ReadString(data, size, offset, str)) return false;
+			node = str;
+			return true;
+		case Yaml::Node::MapType:
+			if (!ReadVarUInt(data, size, offset, count)) return false;
+			for (uint64_t i = 0; i < count; i++)
+			{
+				if (!ReadString(data, size, offset, str) || !ReadYamlNode(data, size, offset, node[str], depth + 1)) return false;
+			}
+			return true;
+		case Yaml::Node::SequenceType:
+			if (!ReadVarUInt(data, size, offset, count)) return false;
+			for (uint64_t i = 0; i < count; i++)
+			{
+				if (!ReadYamlNode(data, size, offset, node.PushBack(), depth + 1)) return false;
+			}
+			return true;
+		default:
+			return false;
+		}
+	}
+
+	void AssetCooker::WriteCookedYaml(const Yaml::Node& root, std::vector<uint8_t>& data)
+	{
+		data.clear();
+		const uint8_t* magic = (const uint8_t*)&CookedYamlMagic;
+		data.insert(data.end(), magic, magic + sizeof(CookedYamlMagic));
+		WriteYamlNode(data, root);
+	}
+
+	bool AssetCooker::ReadCookedYaml(const uint8_t* data, size_t size, Yaml::Node& root)
+	{
+		if (!IsCookedYaml(data, size))
+		{
+			return false;
+		}
+		size_t offset = sizeof(CookedYamlMagic);
+		return ReadYamlNode(data, size, offset, root, 0);
+	}
+
+	bool AssetCooker::IsCookedYaml(const uint8_t* data, size_t size)
+	{
+		return size >= sizeof(CookedYamlMagic) && memcmp(data, &CookedYamlMagic, sizeof(CookedYamlMagic)) == 0;
+	}
+
+	static bool IsHexDigit(char c)
+	{
+		return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+	}
+
+	std::vector<String> AssetCooker::FindAssetReferences(const String& text)
+	{
+		constexpr size_t length = 36;
+		std::vector<String> ids;
+		for (size_t i = 0; i + length <= text.size(); i++)
+		{
+			bool match = (i == 0 || !IsHexDigit(text[i - 1])) && (i + length == text.size() || !IsHexDigit(text[i + length]));
+			for (size_t j = 0; match && j < length; j++)
+			{
+				const char c = text[i + j];
+				match = (j == 8 || j == 13 || j == 18 || j == 23) ? c == '-' : IsHexDigit(c);
+			}
+			if (match)
+			{
+				ids.push_back(text.substr(i, length));
+				i += length - 1;
+			}
+		}
+		return ids;
+	}
+
+	std::vector<String> AssetCooker::WalkAssetReferences(const std::vector<String>& roots, const std::function<bool(const String&, String&)>& readAsset)
+	{
+		std::vector<String> reachable;
+		std::vector<String> queue;
+		std::unordered_set<String> visited;
+		for (const String& id : roots)
+		{
+			if (visited.insert(id).second) queue.push_back(id);
+		}
+
+		// Breadth first, the queue grows while it is walked
+		String text;
+		for (size_t i = 0; i < queue.size(); i++)
+		{
+			// UUIDs of unknown Assets are skipped, the pattern also matches e.g. in Strings
+			if (!readAsset(queue[i], text)) continue;
+			reachable.push_back(queue[i]);
+			for (const String& id : FindAssetReferences(text))
+			{
+				if (visited.insert(id).second) queue.push_back(id);
+			}
+		}
+		return reachable;
+	}
+
+	static bool ReadBinaryFile(const Path& path, std::vector<uint8_t>& data)
+	{
+		std::ifstream file(path, std::ios::binary | std::ios::ate);
+		if (!file) return false;
+		const std::streamsize size = file.tellg();
+		file.seekg(0);
+		data.resize((size_t)size);
+		return (bool)file.read((char*)data.data(), size);
+	}
+
+	std::vector<Asset*> AssetCooker::GatherReachableAssets()
+	{
+		std::unordered_map<String, Asset*> assetsByID;
+		for (Asset* asset : AssetManager::GetAssets<Asset>())
+		{
+			if (!asset->IsMissing() && !asset->m_Path.empty())
+			{
+				assetsByID[asset->m_UUID.GetString()] = asset;
+			}
+		}
+
+		std::vector<String> roots;
+		auto addRoot = [&](Asset* asset)
+		{
+			if (asset) roots.push_back(asset->m_UUID.GetString());
+		};
+		if (ProjectSettings* project = ProjectSettings::Get())
+		{
+			addRoot(project);
+			addRoot(project->m_DefaultLevel);
+			addRoot(project->m_ProjectIconTexture);
+		}
+		const Path engineContent = Path(AssetManager::GetEngineAssetPath()) / "EngineContent";
+		for (auto& It : assetsByID)
+		{
+			if (FileUtils::IsPathSubpathOf(engineContent, It.second->m_Path)) addRoot(It.second);
+		}
+
+		std::vector<Asset*> reachable;
+		const std::vector<String> reachableIDs = WalkAssetReferences(roots, [&assetsByID](const String& id, String& text)
+		{
+			auto It = assetsByID.find(id);
+			if (It == assetsByID.end()) return false;
+			text = Platform::ReadFromFile(It->second->m_Path);
+			return true;
+		});
+		for (const String& id : reachableIDs)
+		{
+			reachable.push_back(assetsByID[id]);
+		}
+
+		std::sort(reachable.begin(), reachable.end(), [](Asset* a, Asset* b) { return a->m_Path < b->m_Path; });
+		return reachable;
+	}
+
+	String AssetCooker::GetPackagePath(const Path& file)
+	{
+		// The exported Content directory holds the engine and the project Content side by side
+		const Path projectPath = AssetManager::GetProjectAssetPath();
+		if (!projectPath.empty() && FileUtils::IsPathSubpathOf(projectPath, file))
+		{
+			return PackageArchive::NormalizePath(file.lexically_relative(projectPath));
+		}
+		return PackageArchive::NormalizePath(file.lexically_relative(AssetManager::GetEngineAssetPath()));
+	}
+
+	bool AssetCooker::CookAsset(PackageWriter& writer, Asset* asset, const AssetCookSettings& settings, AssetCookStats& stats)
+	{
+		Yaml::Node root;
+		if (ProjectSettings* project = asset->As<ProjectSettings>())
+		{
+			// Exported projects carry the EngineContent themselves
+			const String enginePath = project->GetEnginePath();
+			project->SetEnginePath("");
+			project->Serialize(root);
+			project->SetEnginePath(enginePath);
+		}
+		else
+		{
+			Yaml::Parse(root, Platform::ReadFromFile(asset->m_Path));
+		}
+
+		std::vector<uint8_t> cooked;
+		WriteCookedYaml(root, cooked);
+		if (!writer.AddFile(GetPackagePath(asset->m_Path), cooked, settings.Compression, PackageEntryFlags::CookedAsset))
+		{
+			return false;
+		}
+		stats.CookedAssets++;
+
+		if (StreamableAsset* streamable = asset->As<StreamableAsset>())
+		{
+			CookSource(writer, streamable, settings, stats);
+		}
+		return true;
+	}
+
+	void AssetCooker::CookSource(PackageWriter& writer, StreamableAsset* asset, const AssetCookSettings& settings, AssetCookStats& stats)
+	{
+		const Path source = asset->GetSourceAssetPath();
+		const String packagePath = GetPackagePath(source);
+		if (writer.Contains(packagePath))
+		{
+			return;
+		}
+
+		std::error_code error;
+		const uint64_t sourceSize = std::filesystem::file_size(source, error);
+		if (error)
+		{
+			SUORA_WARN(Log::CustomCategory("Export"), "The Source of {0} is missing: '{1}'", asset->m_Name, source.string());
+			return;
+		}
+
+		const std::vector<String> keys = GetDerivedDataKeys(asset);
+		bool isCooked = !keys.empty();
+		for (const String& key : keys)
+		{
+			const String entryPath = "DerivedData/" + key + ".ddc";
+			std::vector<uint8_t> data;
+			if (writer.Contains(entryPath))
+			{
+				continue;
+			}
+			if (!DerivedDataCache::ReadEntry(key, data) || !writer.AddFile(entryPath, data, settings.Compression))
+			{
+				isCooked = false;
+				continue;
+			}
+			stats.DerivedDataEntries++;
+		}
+
+		// The window icon is decoded from the Source directly
+		ProjectSettings* project = ProjectSettings::Get();
+		const bool isProjectIcon = project && project->m_ProjectIconTexture == asset;
+		if (settings.StripCookedSources && isCooked && !isProjectIcon)
+		{
+			writer.AddHashOnly(packagePath, DerivedDataCache::HashFile(source), sourceSize);
+			stats.StrippedSources++;
+		}
+		else
+		{
+			std::vector<uint8_t> data;
+			if (ReadBinaryFile(source, data)) writer.AddFile(packagePath, data, settings.Compression);
+		}
+
+		if (asset->IsA<Font>())
+		{
+			// The atlas texture is loaded next to the Source, see Font::InitializeAsset()
+			String texturePath = source.string();
+			StringUtil::ReplaceSequence(texturePath, ".atlas", ".png");
+			std::vector<uint8_t> data;
+			if (!writer.Contains(GetPackagePath(texturePath)) && ReadBinaryFile(texturePath, data))
+			{
+				writer.AddFile(GetPackagePath(texturePath), data, settings.Compression);
+			}
+		}
+	}
+
+	std::vector<String> AssetCooker::GetDerivedDataKeys(StreamableAsset* asset)
+	{
+		const String source = asset->GetSourceAssetPath().string();
+
+		if (Texture2D* texture = asset->As<Texture2D>())
+		{
+			const TextureCookSettings settings = texture->GetCookSettings();
+			const String key = Texture2D::MakeDerivedDataKey(source, settings);
+			if (key.empty())
+			{
+				return {};
+			}
+			std::vector<uint8_t> data;
+			if (!DerivedDataCache::ReadEntry(key, data))
+			{
+				// Textures cook without side effects on the Asset, so uncooked ones are cooked right here
+				texture->Async_LoadTexture(source, settings);
+			}
+			return { key };
+		}
+
+		if (Mesh* mesh = asset->As<Mesh>())
+		{
+			const String key = mesh->GetDerivedDataKey(source);
+			MeshBuffer buffer;
+			Ref<Cluster> mainCluster;
+			uint32_t submeshCount = 0;
+			if (!DerivedDataCache::LoadMesh(key, buffer, mainCluster, submeshCount))
+			{
+				// Meshes are only imported by the streaming, their Source is packaged instead
+				return {};
+			}
+			if (submeshCount <= 1)
+			{
+				return { key };
+			}
+
+			// The keys of the Submeshes are only known, once the Mesh was loaded
+			if (!mesh->IsMasterMesh() || mesh->m_Submeshes.Size() != submeshCount)
+			{
+				return {};
+			}
+			std::vector<String> keys = { key };
+			for (const Ref<Mesh>& submesh : mesh->m_Submeshes)
+			{
+				keys.push_back(submesh->GetDerivedDataKey(source));
+			}
+			return keys;
+		}
+
+		return {};
+	}
+
+	bool AssetCooker::CookPackage(const AssetCookSettings& settings, AssetCookStats* outStats)
+	{
+		const auto begin = std::chrono::high_resolution_clock::now();
+		AssetCookStats stats;
+
+		if (!ProjectSettings::Get())
+		{
+			SUORA_ERROR(Log::CustomCategory("Export"), "Cannot cook without ProjectSettings!");
+			return false;
+		}
+
+		PackageWriter writer;
+		if (!writer.Open(settings.OutputPath))
+		{
+			return false;
+		}
+
+		const std::vector<Asset*> assets = GatherReachableAssets();
+		for (Asset* asset : assets)
+		{
+			if (!CookAsset(writer, asset, settings, stats))
+			{
+				SUORA_WARN(Log::CustomCategory("Export"), "Failed to cook {0}", asset->m_Name);
+			}
+		}
+
+		// Shaders and other files, that the engine loads by path
+		const Path engineContent = Path(AssetManager::GetEngineAssetPath()) / "EngineContent";
+		if (std::filesystem::exists(engineContent))
+		{
+			for (const DirectoryEntry& file : FileUtils::GetAllAbsoluteEntriesOfPath(engineContent))
+			{
+				const String packagePath = GetPackagePath(file.path());
+				if (writer.Contains(packagePath) || Asset::GetAssetClassByExtension(FileUtils::GetFileExtension(file)) != Asset::StaticClass())
+				{
+					continue;
+				}
+				std::vector<uint8_t> data;
+				if (ReadBinaryFile(file.path(), data) && writer.AddFile(packagePath, data, settings.Compression))
+				{
+					stats.RuntimeFiles++;
+				}
+			}
+		}
+
+		if (!writer.Finish())
+		{
+			return false;
+		}
+
+		for (Asset* asset : AssetManager::GetAssets<Asset>())
+		{
+			if (!asset->IsMissing() && !asset->m_Path.empty() && std::find(assets.begin(), assets.end(), asset) == assets.end()) stats.SkippedAssets++;
+		}
+		stats.RawSize = writer.GetStats().RawSize;
+		stats.PackageSize = writer.GetStats().StoredSize;
+		stats.Seconds = std::chrono::duration<float>(std::chrono::high_resolution_clock::now() - begin).count();
+		SUORA_INFO(Log::CustomCategory("Export"), "Cooked {0} Assets ({1} unreferenced skipped), {2} DerivedData entries, {3} stripped Sources, {4} runtime files: {5} MB -> {6} MB in {7}s",
+			stats.CookedAssets, stats.SkippedAssets, stats.DerivedDataEntries, stats.StrippedSources, stats.RuntimeFiles, stats.RawSize / (1024 * 1024), stats.PackageSize / (1024 * 1024), stats.Seconds);
+
+		if (outStats) *outStats = stats;
+		return true;
+	}
+
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include <stdint.h>
+#include <vector>
+#include <functional>
+#include "PackageArchive.h"
+#include "Suora/Common/Filesystem.h"
+#include "Suora/Serialization/Yaml.h"
+
+namespace Suora
+{
+	class Asset;
+	class StreamableAsset;
+
+	struct AssetCookSettings
+	{
+		/** The package file, usually <Content>/VirtualFileSystem::s_ContentPackageName */
+		Path OutputPath;
+		PackageCompression Compression = PackageCompression::LZ4;
+		/** Packages only the hash of Mesh and Texture Sources, whose DerivedData is packaged instead */
+		bool StripCookedSources = true;
+	};
+
+	struct AssetCookStats
+	{
+		uint32_t CookedAssets = 0;
+		/** Assets that are not reachable from the ProjectSettings, the default Level or the EngineContent */
+		uint32_t SkippedAssets = 0;
+		uint32_t DerivedDataEntries = 0;
+		uint32_t StrippedSources = 0;
+		uint32_t RuntimeFiles = 0;
+		uint64_t RawSize = 0;
+		uint64_t PackageSize = 0;
+		float Seconds = 0.0f;
+	};
+
+	/* Cooks the Content of the current project into a single PackageArchive for exported projects.
+	 * Only Assets that are reachable from the ProjectSettings (including the default Level) are packaged; references are
+	 * found by scanning the Asset files for the UUIDs of other Assets. All of the EngineContent is kept, since the
+	 * engine refers to it from code. Asset files are converted into a binary Yaml form, which loads without parsing
+	 * text, and imported Meshes and Textures are packaged with their DerivedData, so the runtime never imports them. */
+	class AssetCooker
+	{
+	public:
+		static bool CookPackage(const AssetCookSettings& settings, AssetCookStats* outStats = nullptr);
+		/** In the order of their paths */
+		static std::vector<Asset*> GatherReachableAssets();
+
+		static void WriteCookedYaml(const Yaml::Node& root, std::vector<uint8_t>& data);
+		static bool ReadCookedYaml(const uint8_t* data, size_t size, Yaml::Node& root);
+		static bool IsCookedYaml(const uint8_t* data, size_t size);
+
+		/** Finds all tokens in the format of a SuoraID (8-4-4-4-12 hex digits) */
+		static std::vector<String> FindAssetReferences(const String& text);
+		/** Breadth first from the roots. readAsset returns false for unknown Assets, otherwise the text of their file.
+		 *  Returns the reached Assets in the order of the walk. */
+		static std::vector<String> WalkAssetReferences(const std::vector<String>& roots, const std::function<bool(const String&, String&)>& readAsset);
+
+	private:
+		static String GetPackagePath(const Path& file);
+		static bool CookAsset(PackageWriter& writer, Asset* asset, const AssetCookSettings& settings, AssetCookStats& stats);
+		static void CookSource(PackageWriter& writer, StreamableAsset* asset, const AssetCookSettings& settings, AssetCookStats& stats);
+		/** Empty, if the DerivedData of the Asset cannot be determined without importing it */
+		static std::vector<String> GetDerivedDataKeys(StreamableAsset* asset);
+	};
+
+}
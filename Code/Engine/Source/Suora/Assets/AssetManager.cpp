@@ -7,6 +7,12 @@
 #include "Suora/Assets/SuoraProject.h"
 #include "Suora/Core/Engine.h"
 #include "Suora/Platform/Platform.h"
+#include "Suora/Platform/FileWatcher.h"
+#include "AssetResidencyManager.h"
+#include "DerivedDataCache.h"
+#include "VirtualFileSystem.h"
+#include "AssetCooker.h"
+#include "Suora/Debug/Profiler.h"
 
 #include "Mesh.h"
 #include "Material.h"
@@ -36,15 +42,24 @@ namespace Suora
 
 	Asset* AssetManager::CreateMissingAsset(const Class& cls, const SuoraID& id)
 	{
+		std::lock_guard<std::recursive_mutex> lock(s_Mutex);
 		Asset* asset = Cast<Asset>(New(cls));
 		asset->m_UUID = id;
 		s_Assets.Add(asset);
+		s_AssetsByPathDirty = true;
 		asset->SetFlag(AssetFlags::Missing);
 		return asset;
 	}
 
 	void AssetManager::Initialize(const Path& contentPath)
 	{
+		// Exported projects ship their Content cooked into a package, see AssetCooker
+		const Path packagePath = contentPath / VirtualFileSystem::s_ContentPackageName;
+		if (std::filesystem::exists(packagePath))
+		{
+			VirtualFileSystem::Mount(packagePath, contentPath);
+		}
+
 		ProjectSettings::s_SeekingProjectSettings = true;
 		HotReload(contentPath, ProjectSettings::StaticClass());
 		ProjectSettings::s_SeekingProjectSettings = false;
@@ -67,6 +82,8 @@ namespace Suora
 			s_EngineAssetPath = contentPath.string();
 		}
 
+		DerivedDataCache::Initialize(Path(s_ProjectAssetPath != "" ? s_ProjectAssetPath : s_EngineAssetPath).parent_path() / "Cache" / "DerivedData");
+
 		// Now, actually load all Assets...
 		HotReload(s_EngineAssetPath);
 		if (s_ProjectAssetPath != "" && s_ProjectAssetPath != s_EngineAssetPath)
@@ -78,6 +95,7 @@ namespace Suora
 
 	AssetManager::~AssetManager()
 	{
+		std::lock_guard<std::recursive_mutex> lock(s_Mutex);
 		for (Asset* asset : s_Assets.GetData())
 		{
 			delete asset;
@@ -86,15 +104,22 @@ namespace Suora
 
 	void AssetManager::HotReload(const std::filesystem::path& contentPath, const Class& baseClass)
 	{
-		std::vector<DirectoryEntry> Entries = FileUtils::GetAllAbsoluteEntriesOfPath(contentPath);
+		std::vector<Path> files = VirtualFileSystem::ListFiles(contentPath);
+		if (std::filesystem::exists(contentPath))
+		{
+			for (const DirectoryEntry& entry : FileUtils::GetAllAbsoluteEntriesOfPath(contentPath))
+			{
+				if (!VirtualFileSystem::Exists(entry.path())) files.push_back(entry.path());
+			}
+		}
 		
-		for (auto& file : Entries)
+		for (const Path& file : files)
 		{
 			if (GetAssetByPath(file)) continue;
 
 			Asset* asset = nullptr;
 
-			const String ext = FileUtils::GetFileExtension(file);
+			const String ext = file.extension().string();
 			const Class cls = Asset::GetAssetClassByExtension(ext);
 			if (!cls.Inherits(baseClass)) continue;
 			if (cls != Asset::StaticClass()) asset = Cast<Asset>(New(cls));
@@ -104,7 +129,9 @@ namespace Suora
 				const Path path = file;
 				asset->m_Path = path;
 				asset->m_Name = path.filename().string();
+				std::lock_guard<std::recursive_mutex> lock(s_Mutex);
 				s_Assets.Add(asset);
+				s_AssetsByPathDirty = true;
 			}
 
 		}
@@ -115,108 +142,234 @@ namespace Suora
 
 	void AssetManager::InitializeAllAssets()
 	{
-		for (int i = 0; i < s_Assets.Size(); i++)
+		// Loader threads may add missing Assets meanwhile. Those are skipped anyway, so the passes that call into
+		// the Assets work on a copy and only the resolving pass, that removes from s_Assets, holds the lock.
+		Array<Asset*> assets;
+		{
+			std::lock_guard<std::recursive_mutex> lock(s_Mutex);
+			assets = s_Assets;
+		}
+		for (Asset* asset : assets)
 		{
-			if (!s_Assets[i]->IsFlagSet(AssetFlags::WasPreInitialized) && !s_Assets[i]->IsFlagSet(AssetFlags::Missing))
+			if (!asset->IsFlagSet(AssetFlags::WasPreInitialized) && !asset->IsFlagSet(AssetFlags::Missing))
 			{
-				const String str = Platform::ReadFromFile(s_Assets[i]->m_Path.string());
 				Yaml::Node root;
-				Yaml::Parse(root, str);
-				s_Assets[i]->PreInitializeAsset(root);
+				ParseAssetFile(asset->m_Path, root);
+				asset->PreInitializeAsset(root);
 			}
 		}
-		std::unordered_map<String, Asset*> UsedUUIDs;
-		for (int i = 0; i < s_Assets.Size(); i++)
 		{
-			if (s_Assets[i]->IsFlagSet(AssetFlags::Missing))
+			std::lock_guard<std::recursive_mutex> lock(s_Mutex);
+			std::unordered_map<String, Asset*> UsedUUIDs;
+			for (int i = 0; i < s_Assets.Size(); i++)
 			{
-				for (int j = i + 1; j < s_Assets.Size(); j++)
+				if (s_Assets[i]->IsFlagSet(AssetFlags::Missing))
 				{
-					if (s_Assets[i]->m_UUID == s_Assets[j]->m_UUID && s_Assets[i]->GetClass() == s_Assets[j]->GetClass() && !s_Assets[j]->IsFlagSet(AssetFlags::Missing))
+					for (int j = i + 1; j < s_Assets.Size(); j++)
 					{
-						s_Assets[i]->ClearFlag(AssetFlags::Missing);
-						s_Assets[i]->m_Path = s_Assets[j]->m_Path;
-						s_Assets[i]->m_Name = s_Assets[j]->m_Name;
-						const String str = Platform::ReadFromFile(s_Assets[i]->m_Path.string());
-						Yaml::Node root;
-						Yaml::Parse(root, str);
-						s_Assets[i]->PreInitializeAsset(root);
-
-						delete s_Assets[j];
-						s_Assets.RemoveAt(j);
-						break;
+						if (s_Assets[i]->m_UUID == s_Assets[j]->m_UUID && s_Assets[i]->GetClass() == s_Assets[j]->GetClass() && !s_Assets[j]->IsFlagSet(AssetFlags::Missing))
+						{
+							s_Assets[i]->ClearFlag(AssetFlags::Missing);
+							s_Assets[i]->m_Path = s_Assets[j]->m_Path;
+							s_Assets[i]->m_Name = s_Assets[j]->m_Name;
+							Yaml::Node root;
+							ParseAssetFile(s_Assets[i]->m_Path, root);
+							s_Assets[i]->PreInitializeAsset(root);
+
+							delete s_Assets[j];
+							s_Assets.RemoveAt(j);
+							break;
+						}
 					}
 				}
-			}
-			
-			if (s_Assets[i]->IsFlagSet(AssetFlags::Missing))
-			{
-				// In this case, the Missing Asset was not resolved! -> skip
-				continue;
-			}
 
-			if (UsedUUIDs.find(s_Assets[i]->m_UUID.GetString()) != UsedUUIDs.end())
-			{
-				SuoraError("Colliding Asset UUIDs: {0}", s_Assets[i]->m_UUID.GetString());
-				SuoraError("   -> {0}", s_Assets[i]->m_Name);
-				SuoraError("   -> {0}", UsedUUIDs[s_Assets[i]->m_UUID.GetString()]->m_Name);
-				SuoraAssert(false);
+				if (s_Assets[i]->IsFlagSet(AssetFlags::Missing))
+				{
+					// In this case, the Missing Asset was not resolved! -> skip
+					continue;
+				}
+
+				if (UsedUUIDs.find(s_Assets[i]->m_UUID.GetString()) != UsedUUIDs.end())
+				{
+					SuoraError("Colliding Asset UUIDs: {0}", s_Assets[i]->m_UUID.GetString());
+					SuoraError("   -> {0}", s_Assets[i]->m_Name);
+					SuoraError("   -> {0}", UsedUUIDs[s_Assets[i]->m_UUID.GetString()]->m_Name);
+					SuoraAssert(false);
+				}
+				else
+				{
+					UsedUUIDs[s_Assets[i]->m_UUID.GetString()] = s_Assets[i];
+				}
 			}
-			else
+			assets = s_Assets;
+		}
+		for (Asset* asset : assets)
+		{
+			if (!asset->IsFlagSet(AssetFlags::WasInitialized) && !asset->IsFlagSet(AssetFlags::Missing))
 			{
-				UsedUUIDs[s_Assets[i]->m_UUID.GetString()] = s_Assets[i];
+				Yaml::Node root;
+				ParseAssetFile(asset->m_Path, root);
+				asset->InitializeAsset(root);
 			}
 		}
-		for (int i = 0; i < s_Assets.Size(); i++)
+		// Missing Assets may have been resolved to a path
+		s_AssetsByPathDirty = true;
+	}
+
+	void AssetManager::ParseAssetFile(const Path& path, Yaml::Node& root)
+	{
+		std::vector<uint8_t> data;
+		if (VirtualFileSystem::ReadFile(path, data) && AssetCooker::IsCookedYaml(data.data(), data.size()))
 		{
-			if (!s_Assets[i]->IsFlagSet(AssetFlags::WasInitialized) && !s_Assets[i]->IsFlagSet(AssetFlags::Missing))
+			if (!AssetCooker::ReadCookedYaml(data.data(), data.size(), root))
 			{
-				const String str = Platform::ReadFromFile(s_Assets[i]->m_Path.string());
-				Yaml::Node root;
-				Yaml::Parse(root, str);
-				s_Assets[i]->InitializeAsset(root);
+				SUORA_ERROR(LogCategory::AssetManagement, "The cooked Asset '{0}' is corrupted.", path.string());
 			}
+			return;
 		}
+		Yaml::Parse(root, data.empty() ? Platform::ReadFromFile(path) : String((const char*)data.data(), data.size()));
 	}
 
 	void AssetManager::Update(float deltaTime)
 	{
-		for (int i = s_AssetStreamPool.Size() - 1; i >= 0; i--)
+		SUORA_PROFILE_SCOPE("AssetManager::Update");
+		SUORA_PROFILE_COUNTER_SET("Assets Streaming", s_AssetStreamPool.Size());
+
+		if (s_AssetHotReloading)
+		{
+			UpdateHotReloading();
+		}
+		else if (!s_FileWatchers.IsEmpty())
 		{
-			if (Mesh* mesh = s_AssetStreamPool[i]->As<Mesh>())
+			s_FileWatchers.Clear();
+		}
+
+		AssetResidencyManager::Update(deltaTime);
+	}
+	
+	void AssetManager::UpdateHotReloading()
+	{
+		if (s_FileWatchers.IsEmpty())
+		{
+			if (s_EngineAssetPath != "") s_FileWatchers.Add(CreateRef<FileWatcher>(s_EngineAssetPath));
+			if (s_ProjectAssetPath != "" && s_ProjectAssetPath != s_EngineAssetPath) s_FileWatchers.Add(CreateRef<FileWatcher>(s_ProjectAssetPath));
+		}
+
+		Array<FileWatchEvent> events;
+		for (const Ref<FileWatcher>& watcher : s_FileWatchers)
+		{
+			Array<FileWatchEvent> watcherEvents = watcher->PollEvents();
+			events += watcherEvents;
+		}
+		if (events.IsEmpty())
+		{
+			return;
+		}
+
+		// Loader threads may add Assets while the reloads run
+		std::lock_guard<std::recursive_mutex> lock(s_Mutex);
+		if (s_AssetsByPathDirty)
+		{
+			RebuildAssetsByPath();
+		}
+		// Assets that went missing since the last rebuild are skipped
+		auto reload = [](Asset* asset, const FileWatchEvent& event)
+		{
+			if (!asset->IsMissing() && asset->IsFlagSet(AssetFlags::WasPreInitialized)) ReloadAssetIfRequired(asset, event);
+		};
+
+		for (const FileWatchEvent& event : events)
+		{
+			if (event.m_Action == FileWatchAction::Rescan)
 			{
-				//m_MeshAsset->GetVertexArray();
+				SuoraWarn("AssetManager: Lost file change notifications for '{0}', checking all Assets.", event.m_Path.string());
+				s_HotReloadStats.Rescans++;
+				for (auto& It : s_AssetsByPath)
+				{
+					for (Asset* asset : It.second)
+					{
+						reload(asset, event);
+					}
+				}
+				continue;
 			}
-			else if (Texture2D* texture = s_AssetStreamPool[i]->As<Texture2D>())
+
+			if (event.m_Action == FileWatchAction::Removed)
 			{
-				//texture->GetTexture();
+				continue;
 			}
-			else
+
+			auto It = s_AssetsByPath.find(event.m_Path.lexically_normal().generic_string());
+			if (It != s_AssetsByPath.end())
 			{
-				SuoraError("AssetManager::Update(float): Missing 'StreamAssetClass' implementation. Cannot resolve possible stream blockage!");
+				for (Asset* asset : It->second)
+				{
+					reload(asset, event);
+				}
+			}
+			else if (event.m_Action == FileWatchAction::Added && std::filesystem::is_regular_file(event.m_Path))
+			{
+				// Asset files that were added outside of the Editor
+				const Class cls = Asset::GetAssetClassByExtension(event.m_Path.extension().string());
+				if (cls.Inherits(Asset::StaticClass()) && cls != Asset::StaticClass())
+				{
+					LoadAsset(event.m_Path.string());
+				}
 			}
 		}
+	}
 
-		if (s_AssetHotReloading)
+	void AssetManager::RebuildAssetsByPath()
+	{
+		std::lock_guard<std::recursive_mutex> lock(s_Mutex);
+		s_AssetsByPath.clear();
+		for (Asset* asset : s_Assets)
 		{
-			for (int i = 0; i < s_AssetHotReloadingCount; i++)
+			if (asset->IsMissing())
 			{
-				s_AssetHotReloadingIteratorIndex %= s_Assets.Size();
-				Asset* asset = s_Assets[s_AssetHotReloadingIteratorIndex++];
+				continue;
+			}
+			s_AssetsByPath[asset->m_Path.lexically_normal().generic_string()].Add(asset);
+			if (StreamableAsset* streamable = asset->As<StreamableAsset>())
+			{
+				s_AssetsByPath[streamable->GetSourceAssetPath().lexically_normal().generic_string()].Add(asset);
+			}
+		}
+		s_AssetsByPathDirty = false;
+	}
 
-				if (asset->IsMissing() || !asset->IsFlagSet(AssetFlags::WasPreInitialized))
-				{
-					continue;
-				}
+	void AssetManager::ReloadAssetIfRequired(Asset* asset, const FileWatchEvent& event)
+	{
+		std::error_code error;
+		if (!std::filesystem::exists(asset->m_Path, error))
+		{
+			return;
+		}
+		if (StreamableAsset* streamable = asset->As<StreamableAsset>())
+		{
+			if (!streamable->IsSourceAssetPathValid()) return;
+		}
 
-				if (asset->IsAssetReloadRequired())
-				{
-					asset->ReloadAsset();
-				}
-			}
+		if (asset->IsAssetReloadRequired())
+		{
+			asset->ReloadAsset();
+			// The Source file may have changed with the reload
+			s_AssetsByPathDirty = true;
+
+			const float latency = Platform::GetTime() - event.m_DetectionTime;
+			s_HotReloadStats.ReloadedAssets++;
+			s_HotReloadStats.LastLatency = latency;
+			s_HotReloadStats.MaxLatency = glm::max(s_HotReloadStats.MaxLatency, latency);
+			s_HotReloadStats.AverageLatency += (latency - s_HotReloadStats.AverageLatency) / (float)s_HotReloadStats.ReloadedAssets;
+			SUORA_LOG(LogCategory::AssetManagement, LogLevel::Info, "Reloaded {0} ({1}ms after the change)", asset->m_Name, (int32_t)(latency * 1000.0f));
 		}
 	}
-	
+
+	const AssetHotReloadStats& AssetManager::GetHotReloadStats()
+	{
+		return s_HotReloadStats;
+	}
+
 	void AssetManager::RemoveAsset(Asset* asset)
 	{
 		if (!asset) return;
@@ -231,6 +384,7 @@ namespace Suora
 		asset->m_Name = name;
 		const String ext = asset->m_Path.extension().string();
 		asset->m_Path = asset->m_Path.parent_path() / (name + ext);
+		s_AssetsByPathDirty = true;
 	}
 
 	void AssetManager::LoadAsset(const String& path)
@@ -249,11 +403,14 @@ namespace Suora
 			const Path path = file;
 			asset->m_Path = path;
 			asset->m_Name = path.filename().string();
-			s_Assets.Add(asset);
+			{
+				std::lock_guard<std::recursive_mutex> lock(s_Mutex);
+				s_Assets.Add(asset);
+				s_AssetsByPathDirty = true;
+			}
 
-			const String str = Platform::ReadFromFile(asset->m_Path.string());
 			Yaml::Node root;
-			Yaml::Parse(root, str);
+			ParseAssetFile(asset->m_Path, root);
 			asset->PreInitializeAsset(root);
 			asset->InitializeAsset(root);
 		}
@@ -263,10 +420,11 @@ namespace Suora
 	{
 		if (id.GetString() == "0") return nullptr;
 
-		Array<Asset*> assets = GetAssetsByClass(assetClass);
-		for (Asset* asset : assets)
+		// The lock covers the lookup and the creation of a missing Asset, so loader threads never create duplicates
+		std::lock_guard<std::recursive_mutex> lock(s_Mutex);
+		for (Asset* asset : s_Assets)
 		{
-			if (asset->m_UUID == id)
+			if (asset->m_UUID == id && Cast(asset, assetClass))
 			{
 				return asset;
 			}
@@ -276,6 +434,7 @@ namespace Suora
 
 	Array<Asset*> AssetManager::GetAssetsByClass(Class type)
 	{
+		std::lock_guard<std::recursive_mutex> lock(s_Mutex);
 		Array<Asset*> array;
 		for (Asset* asset : s_Assets)
 		{
@@ -286,6 +445,7 @@ namespace Suora
 
 	Asset* AssetManager::GetAssetByPath(const std::filesystem::path& path)
 	{
+		std::lock_guard<std::recursive_mutex> lock(s_Mutex);
 		for (Asset* asset : s_Assets)
 		{
 			if (asset->m_Path == path) return asset;
@@ -297,7 +457,11 @@ namespace Suora
 	{
 		Asset* asset = New(assetClass)->As<Asset>();
 		std::vector<String> exts = asset->GetAssetExtensions();
-		s_Assets.Add(asset);
+		{
+			std::lock_guard<std::recursive_mutex> lock(s_Mutex);
+			s_Assets.Add(asset);
+			s_AssetsByPathDirty = true;
+		}
 		asset->m_Name = name;
 		asset->m_Path = dir + "/" + name + (exts.size() > 0 ? exts[0] : ".asset");
 		asset->m_UUID = SuoraID::Generate();
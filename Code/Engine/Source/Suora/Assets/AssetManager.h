@@ -1,7 +1,10 @@
 #pragma once
 #include <vector>
 #include <string>
+#include <atomic>
 #include <filesystem>
+#include <mutex>
+#include <unordered_map>
 #include "Asset.h"
 #include "Suora/Core/Object/Object.h"
 #include "Suora/Common/Filesystem.h"
@@ -14,6 +17,18 @@ namespace Suora
 	class Mesh;
 	class Font;
 	class Texture2D;
+	class FileWatcher;
+	struct FileWatchEvent;
+
+	/** Measured from the first change notification of a file to the completed Asset reload */
+	struct AssetHotReloadStats
+	{
+		uint64_t ReloadedAssets = 0;
+		uint64_t Rescans = 0;
+		float LastLatency = 0.0f;
+		float AverageLatency = 0.0f;
+		float MaxLatency = 0.0f;
+	};
 
 	/* The AssetManager class is responsible for managing assets in the Suora Engine. */
 	class AssetManager
@@ -22,16 +37,29 @@ namespace Suora
 		// Static members
 		inline static Array<Asset*> s_Assets;
 		inline static String s_EngineAssetPath = "", s_ProjectAssetPath = "";
-		inline static uint32_t s_AssetHotReloadingIteratorIndex = 0;
 		inline static Array<Asset*> s_AssetStreamPool;
+		inline static Array<Ref<FileWatcher>> s_FileWatchers;
+		inline static AssetHotReloadStats s_HotReloadStats;
+		/** Asset and Source files to their Assets, for the hot reload. Rebuilt once Assets were added, moved or changed their Source. */
+		inline static std::unordered_map<String, Array<Asset*>> s_AssetsByPath;
+		inline static std::atomic<bool> s_AssetsByPathDirty = true;
+		/** Guards s_Assets. Loader threads add missing Assets while they deserialize (see LevelStreamer),
+		*   so every read and write of s_Assets takes it, on the main thread as well. */
+		inline static std::recursive_mutex s_Mutex;
 
 		// Private Function to create a missing Asset of a specified Class and ID.
 		static Asset* CreateMissingAsset(const Class& cls, const SuoraID& id);
 
+		/** Reads text Yaml and cooked Asset files from mounted packages alike */
+		static void ParseAssetFile(const Path& path, Yaml::Node& root);
+
+		static void UpdateHotReloading();
+		static void RebuildAssetsByPath();
+		static void ReloadAssetIfRequired(Asset* asset, const FileWatchEvent& event);
+
 	public:
 		// Static public members
 		inline static bool s_AssetHotReloading = false;
-		inline static uint32_t s_AssetHotReloadingCount = 8;
 
 		// Initializes the AssetManager with the provided content path.
 		static void Initialize(const Path& contentPath);
@@ -48,7 +76,9 @@ namespace Suora
 		template<class T>
 		static void RegisterAsset(T* asset)
 		{
+			std::lock_guard<std::recursive_mutex> lock(s_Mutex);
 			s_Assets.Add(asset);
+			s_AssetsByPathDirty = true;
 		}
 
 		/* Removes the specified asset from the AssetManager.
@@ -60,6 +90,7 @@ namespace Suora
 		template<class T>
 		static T* GetFirstAssetOfType()
 		{
+			std::lock_guard<std::recursive_mutex> lock(s_Mutex);
 			for (Asset* asset : s_Assets)
 			{
 				if (T* a = Cast<T>(asset)) return a;
@@ -75,6 +106,7 @@ namespace Suora
 		template<class T>
 		static T* GetAssetByName(const String& name)
 		{
+			std::lock_guard<std::recursive_mutex> lock(s_Mutex);
 			for (Asset* asset : s_Assets)
 			{
 				if (T* a = Cast<T>(asset))
@@ -87,6 +119,7 @@ namespace Suora
 		template<class T>
 		static Array<T*> GetAssets()
 		{
+			std::lock_guard<std::recursive_mutex> lock(s_Mutex);
 			Array<T*> array;
 			for (Asset* asset : s_Assets)
 			{
@@ -105,6 +138,7 @@ namespace Suora
 		}
 
 		static uint32_t GetAssetStreamCountLimit();
+		static const AssetHotReloadStats& GetHotReloadStats();
 
 		static String GetEngineAssetPath()
 		{
@@ -122,6 +156,7 @@ namespace Suora
 		friend class Engine;
 		friend class Mesh;
 		friend class Texture2D;
+		friend class StreamableAsset;
 		friend class AssetPreview;
 		friend struct EditorUI;
 		friend class EditorWindow;
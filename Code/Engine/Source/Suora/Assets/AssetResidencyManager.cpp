@@ -0,0 +1,255 @@
+#include "Precompiled.h"
+#include "AssetResidencyManager.h"
+#include "StreamableAsset.h"
+
+namespace Suora
+{
+
+	void AssetResidencyManager::Update(float deltaTime)
+	{
+		s_FrameIndex++;
+		s_Stats.EvictionsLastFrame = 0;
+
+		uint64_t cpuMemory = 0, gpuMemory = 0;
+		uint32_t evictableAssets = 0;
+		for (StreamableAsset* asset : s_ResidentAssets)
+		{
+			cpuMemory += asset->GetResidentCPUMemory();
+			gpuMemory += asset->GetResidentGPUMemory();
+			if (IsEvictable(asset)) evictableAssets++;
+		}
+		// Counted with their expected size until they are resident, so prefetches started in earlier frames cannot overshoot the Budget
+		for (int32_t i = s_StreamingAssets.Last(); i >= 0; i--)
+		{
+			if (!s_StreamingAssets[i].Asset->IsStreamingInProgress())
+			{
+				s_StreamingAssets.RemoveAt(i);
+				continue;
+			}
+			cpuMemory += s_StreamingAssets[i].CPUMemory;
+			gpuMemory += s_StreamingAssets[i].GPUMemory;
+		}
+
+		if (IsOverBudget(cpuMemory, gpuMemory))
+		{
+			Array<StreamableAsset*> candidates;
+			for (StreamableAsset* asset : s_ResidentAssets)
+			{
+				if (IsEvictable(asset) && s_FrameIndex - asset->m_LastUsedFrame > s_EvictionGraceFrames)
+				{
+					candidates.Add(asset);
+				}
+			}
+
+			// Least recently used first, lower priority first
+			candidates.Sort([](StreamableAsset* const& a, StreamableAsset* const& b)
+			{
+				if (a->m_LastUsedFrame != b->m_LastUsedFrame) return a->m_LastUsedFrame < b->m_LastUsedFrame;
+				return a->m_StreamingPriority < b->m_StreamingPriority;
+			});
+
+			for (StreamableAsset* asset : candidates)
+			{
+				if (!IsOverBudget(cpuMemory, gpuMemory) || s_Stats.EvictionsLastFrame >= s_MaxEvictionsPerFrame)
+				{
+					break;
+				}
+
+				const uint64_t cpu = asset->GetResidentCPUMemory();
+				const uint64_t gpu = asset->GetResidentGPUMemory();
+				cpuMemory -= cpu;
+				gpuMemory -= gpu;
+
+				asset->StreamOut();
+				NotifyReleased(asset);
+				evictableAssets--;
+
+				s_Stats.EvictionsLastFrame++;
+				s_Stats.TotalEvictions++;
+				s_Stats.TotalEvictedMemory += cpu + gpu;
+			}
+		}
+
+		ProcessPrefetches(cpuMemory, gpuMemory);
+
+		s_Stats.ResidentAssets = s_ResidentAssets.Size();
+		s_Stats.EvictableAssets = evictableAssets;
+		s_Stats.PendingPrefetches = s_PrefetchQueue.Size();
+		s_Stats.StreamingAssets = s_StreamingAssets.Size();
+		s_Stats.ResidentCPUMemory = cpuMemory;
+		s_Stats.ResidentGPUMemory = gpuMemory;
+		s_Stats.CPUMemoryBudget = s_CPUMemoryBudget;
+		s_Stats.GPUMemoryBudget = s_GPUMemoryBudget;
+	}
+
+	void AssetResidencyManager::MarkUsed(StreamableAsset* asset)
+	{
+		if (!asset) return;
+
+		if (asset->m_LastUsedFrame != s_FrameIndex)
+		{
+			asset->m_LastUsedFrame = s_FrameIndex;
+			asset->m_StreamingPriority = 0.0f;
+		}
+	}
+
+	void AssetResidencyManager::MarkUsed(StreamableAsset* asset, float priority)
+	{
+		if (!asset) return;
+
+		MarkUsed(asset);
+		asset->m_StreamingPriority = glm::max(asset->m_StreamingPriority, priority);
+	}
+
+	void AssetResidencyManager::NotifyResident(StreamableAsset* asset)
+	{
+		if (!asset || asset->m_IsResidencyTracked) return;
+
+		asset->m_IsResidencyTracked = true;
+		s_ResidentAssets.Add(asset);
+		RemoveStreaming(asset);
+		MarkUsed(asset);
+	}
+
+	void AssetResidencyManager::NotifyReleased(StreamableAsset* asset)
+	{
+		if (!asset) return;
+
+		if (asset->m_IsResidencyTracked)
+		{
+			// Remembered as the expected size of the next StreamIn()
+			asset->m_LastResidentCPUMemory = asset->GetResidentCPUMemory();
+			asset->m_LastResidentGPUMemory = asset->GetResidentGPUMemory();
+			asset->m_IsResidencyTracked = false;
+			s_ResidentAssets.Remove(asset);
+		}
+		RemoveStreaming(asset);
+		CancelPrefetch(asset);
+	}
+
+	void AssetResidencyManager::RemoveStreaming(StreamableAsset* asset)
+	{
+		for (int32_t i = s_StreamingAssets.Last(); i >= 0; i--)
+		{
+			if (s_StreamingAssets[i].Asset == asset)
+			{
+				s_StreamingAssets.RemoveAt(i);
+			}
+		}
+	}
+
+	void AssetResidencyManager::Prefetch(StreamableAsset* asset, float priority)
+	{
+		if (!asset || asset->IsMissing()) return;
+
+		for (PrefetchRequest& request : s_PrefetchQueue)
+		{
+			if (request.Asset == asset)
+			{
+				request.Priority = glm::max(request.Priority, priority);
+				return;
+			}
+		}
+
+		asset->m_IsPrefetchQueued = true;
+		s_PrefetchQueue.Add({ asset, priority });
+	}
+
+	void AssetResidencyManager::CancelPrefetch(StreamableAsset* asset)
+	{
+		if (!asset || !asset->m_IsPrefetchQueued) return;
+
+		asset->m_IsPrefetchQueued = false;
+		for (int32_t i = s_PrefetchQueue.Last(); i >= 0; i--)
+		{
+			if (s_PrefetchQueue[i].Asset == asset)
+			{
+				s_PrefetchQueue.RemoveAt(i);
+			}
+		}
+	}
+
+	float AssetResidencyManager::CalculateStreamingPriority(const Vec3& viewPosition, float verticalFOV, const Vec3& boundsCenter, float boundsRadius)
+	{
+		const float distance = glm::max(glm::distance(viewPosition, boundsCenter), 0.001f);
+		return boundsRadius / (distance * glm::sin(glm::radians(verticalFOV)));
+	}
+
+	void AssetResidencyManager::SetMemoryBudget(uint64_t cpuBytes, uint64_t gpuBytes)
+	{
+		s_CPUMemoryBudget = cpuBytes;
+		s_GPUMemoryBudget = gpuBytes;
+	}
+	uint64_t AssetResidencyManager::GetCPUMemoryBudget()
+	{
+		return s_CPUMemoryBudget;
+	}
+	uint64_t AssetResidencyManager::GetGPUMemoryBudget()
+	{
+		return s_GPUMemoryBudget;
+	}
+
+	const AssetResidencyStats& AssetResidencyManager::GetStats()
+	{
+		return s_Stats;
+	}
+	uint64_t AssetResidencyManager::GetFrameIndex()
+	{
+		return s_FrameIndex;
+	}
+
+	bool AssetResidencyManager::IsEvictable(const StreamableAsset* asset)
+	{
+		return asset->GetAssetStreamMode() == AssetStreamMode::StreamOnDemand && asset->CanStreamOut() && !asset->IsStreamingInProgress();
+	}
+
+	bool AssetResidencyManager::IsOverBudget(uint64_t cpuMemory, uint64_t gpuMemory)
+	{
+		return (s_CPUMemoryBudget != 0 && cpuMemory > s_CPUMemoryBudget) || (s_GPUMemoryBudget != 0 && gpuMemory > s_GPUMemoryBudget);
+	}
+
+	void AssetResidencyManager::ProcessPrefetches(uint64_t& cpuMemory, uint64_t& gpuMemory)
+	{
+		if (s_PrefetchQueue.IsEmpty()) return;
+
+		s_PrefetchQueue.Sort([](const PrefetchRequest& a, const PrefetchRequest& b) { return a.Priority > b.Priority; });
+
+		for (int32_t i = 0; i < s_PrefetchQueue.Size(); i++)
+		{
+			StreamableAsset* asset = s_PrefetchQueue[i].Asset;
+			// Resident or already streaming in, e.g. because it was used in the meantime
+			if (asset->IsStreamedIn() || asset->IsMissing() || asset->IsStreamingInProgress())
+			{
+				asset->m_IsPrefetchQueued = false;
+				s_PrefetchQueue.RemoveAt(i--);
+				continue;
+			}
+
+			// Prefetching must never be the reason for evictions
+			const uint64_t cpu = asset->GetExpectedCPUMemory();
+			const uint64_t gpu = asset->GetExpectedGPUMemory();
+			if (IsOverBudget(cpuMemory + cpu, gpuMemory + gpu))
+			{
+				break;
+			}
+
+			MarkUsed(asset, s_PrefetchQueue[i].Priority);
+			asset->StreamIn();
+			if (!asset->IsStreamingInProgress() && !asset->IsStreamedIn())
+			{
+				// Not started, e.g. because the AssetManager's stream limit is reached; retried next Frame
+				continue;
+			}
+
+			cpuMemory += cpu;
+			gpuMemory += gpu;
+			if (asset->IsStreamingInProgress())
+			{
+				s_StreamingAssets.Add({ asset, cpu, gpu });
+			}
+			asset->m_IsPrefetchQueued = false;
+			s_PrefetchQueue.RemoveAt(i--);
+		}
+	}
+
+}
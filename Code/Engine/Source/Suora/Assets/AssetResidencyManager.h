@@ -0,0 +1,92 @@
+#pragma once
+#include <stdint.h>
+#include "Suora/Common/Array.h"
+#include "Suora/Common/VectorUtils.h"
+
+namespace Suora
+{
+	class StreamableAsset;
+
+	/** Snapshot of the current Asset Residency, updated once per Frame */
+	struct AssetResidencyStats
+	{
+		uint32_t ResidentAssets = 0;
+		uint32_t EvictableAssets = 0;
+		uint32_t PendingPrefetches = 0;
+		/** Prefetched Assets that are still streaming in. Their expected memory is included in the resident memory. */
+		uint32_t StreamingAssets = 0;
+		uint64_t ResidentCPUMemory = 0;
+		uint64_t ResidentGPUMemory = 0;
+		uint64_t CPUMemoryBudget = 0;
+		uint64_t GPUMemoryBudget = 0;
+		uint32_t EvictionsLastFrame = 0;
+		uint64_t TotalEvictions = 0;
+		uint64_t TotalEvictedMemory = 0;
+	};
+
+	/* The AssetResidencyManager keeps streamed Assets within a CPU and GPU Memory Budget.
+	 * Assets report their usage from the render path. If a Budget is exceeded, the least recently used
+	 * Assets with AssetStreamMode::StreamOnDemand are streamed out first.                             */
+	class AssetResidencyManager
+	{
+	public:
+		// Called once per Frame by the AssetManager
+		static void Update(float deltaTime);
+
+		/** Stamps the Asset as used in the current Frame.
+		 *  The priority is the highest reported one during this Frame (e.g. approximate screen size). */
+		static void MarkUsed(StreamableAsset* asset);
+		static void MarkUsed(StreamableAsset* asset, float priority);
+
+		/** Has to be called by StreamableAssets, once their streamed data becomes resident or gets released. */
+		static void NotifyResident(StreamableAsset* asset);
+		static void NotifyReleased(StreamableAsset* asset);
+
+		/** Hints that the Asset will be needed soon. Prefetches are streamed in by priority, as long as the Budget allows it. */
+		static void Prefetch(StreamableAsset* asset, float priority = 1.0f);
+		static void CancelPrefetch(StreamableAsset* asset);
+
+		/** Approximate fraction of the screen covered by a bounding sphere. Used as the streaming priority. */
+		static float CalculateStreamingPriority(const Vec3& viewPosition, float verticalFOV, const Vec3& boundsCenter, float boundsRadius);
+
+		/** A Budget of 0 Bytes disables the Budget. */
+		static void SetMemoryBudget(uint64_t cpuBytes, uint64_t gpuBytes);
+		static uint64_t GetCPUMemoryBudget();
+		static uint64_t GetGPUMemoryBudget();
+
+		static const AssetResidencyStats& GetStats();
+		static uint64_t GetFrameIndex();
+
+		// Assets used within this amount of Frames will never be evicted
+		inline static uint32_t s_EvictionGraceFrames = 60;
+		// Upper limit to avoid hitches, if a large amount of Assets goes out of use at once
+		inline static uint32_t s_MaxEvictionsPerFrame = 16;
+
+	private:
+		static bool IsEvictable(const StreamableAsset* asset);
+		static bool IsOverBudget(uint64_t cpuMemory, uint64_t gpuMemory);
+		static void ProcessPrefetches(uint64_t& cpuMemory, uint64_t& gpuMemory);
+		static void RemoveStreaming(StreamableAsset* asset);
+
+		struct PrefetchRequest
+		{
+			StreamableAsset* Asset = nullptr;
+			float Priority = 0.0f;
+		};
+		struct StreamingRequest
+		{
+			StreamableAsset* Asset = nullptr;
+			uint64_t CPUMemory = 0;
+			uint64_t GPUMemory = 0;
+		};
+
+		inline static Array<StreamableAsset*> s_ResidentAssets;
+		inline static Array<PrefetchRequest> s_PrefetchQueue;
+		inline static Array<StreamingRequest> s_StreamingAssets;
+		inline static uint64_t s_CPUMemoryBudget = 0;
+		inline static uint64_t s_GPUMemoryBudget = 0;
+		inline static uint64_t s_FrameIndex = 1;
+		inline static AssetResidencyStats s_Stats;
+	};
+
+}
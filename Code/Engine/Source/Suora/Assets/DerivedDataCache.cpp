@@ -0,0 +1,663 @@
+#include "Precompiled.h"
+#include "DerivedDataCache.h"
+#include "Suora/Assets/Mesh.h"
+#include "Suora/Renderer/Vertex.h"
+#include "Suora/Renderer/Texture.h"
+#include "VirtualFileSystem.h"
+#include <fstream>
+#include <thread>
+#include <cstring>
+
+namespace Suora
+{
+	static constexpr uint32_t DerivedDataMagic = 0x43444453; // "SDDC"
+	static constexpr uint32_t DerivedDataFormatVersion = 2;
+	static constexpr uint64_t DerivedDataAlignment = 16;
+
+	enum class DerivedDataType : uint32_t
+	{
+		Mesh = 1,
+		Texture,
+		ShaderProgram
+	};
+
+	struct DerivedDataHeader
+	{
+		uint32_t Magic = DerivedDataMagic;
+		uint32_t FormatVersion = DerivedDataFormatVersion;
+		DerivedDataType Type = DerivedDataType::Mesh;
+		uint32_t Reserved = 0;
+	};
+
+	struct DerivedMeshHeader
+	{
+		DerivedDataHeader Header;
+		uint64_t SubmeshCount = 0;
+		uint64_t VertexCount = 0, VertexOffset = 0;
+		uint64_t IndexCount = 0, IndexOffset = 0;
+		uint64_t ClusterCount = 0, ClusterOffset = 0;
+		uint64_t ClusterIndexCount = 0, ClusterIndexOffset = 0;
+	};
+
+	/** Flattened Cluster hierarchy in pre-order */
+	struct DerivedCluster
+	{
+		Vec3 LocalPosition;
+		Vec3 Normal;
+		float ClusterRadius = 0.0f;
+		uint32_t IndexOffset = 0;
+		uint32_t IndexCount = 0;
+		int32_t Child1 = -1;
+		int32_t Child2 = -1;
+	};
+
+	struct DerivedTextureHeader
+	{
+		DerivedDataHeader Header;
+		uint32_t Format = 0;
+		uint32_t Width = 0, Height = 0;
+		uint32_t MipCount = 0;
+		uint64_t MipTableOffset = 0;
+	};
+
+	struct DerivedTextureMip
+	{
+		uint64_t Offset = 0, Size = 0;
+	};
+
+	struct DerivedShaderProgramHeader
+	{
+		DerivedDataHeader Header;
+		uint32_t BinaryFormat = 0;
+		uint32_t Reserved = 0;
+		uint64_t BinaryOffset = 0, BinarySize = 0;
+	};
+
+	static_assert(std::is_trivially_copyable_v<Vertex>, "Vertices are stored as raw bytes!");
+
+	static uint64_t Align(uint64_t offset)
+	{
+		return (offset + DerivedDataAlignment - 1) & ~(DerivedDataAlignment - 1);
+	}
+
+	static void WriteSection(std::vector<uint8_t>& data, uint64_t offset, const void* src, uint64_t size)
+	{
+		if (size > 0) memcpy(data.data() + offset, src, size);
+	}
+
+	static bool IsSectionValid(const std::vector<uint8_t>& data, uint64_t offset, uint64_t count, uint64_t stride)
+	{
+		return offset <= data.size() && count <= (data.size() - offset) / stride;
+	}
+
+	static int32_t FlattenCluster(const Ref<Cluster>& cluster, std::vector<DerivedCluster>& clusters, std::vector<uint32_t>& indices)
+	{
+		const int32_t index = (int32_t)clusters.size();
+		clusters.push_back(DerivedCluster());
+		clusters[index].LocalPosition = cluster->LocalPosition;
+		clusters[index].Normal = cluster->Normal;
+		clusters[index].ClusterRadius = cluster->ClusterRadius;
+		clusters[index].IndexOffset = (uint32_t)indices.size();
+		clusters[index].IndexCount = (uint32_t)cluster->Indices.size();
+		indices.insert(indices.end(), cluster->Indices.begin(), cluster->Indices.end());
+
+		if (cluster->Child1)
+		{
+			const int32_t child = FlattenCluster(cluster->Child1, clusters, indices);
+			clusters[index].Child1 = child;
+		}
+		if (cluster->Child2)
+		{
+			const int32_t child = FlattenCluster(cluster->Child2, clusters, indices);
+			clusters[index].Child2 = child;
+		}
+		return index;
+	}
+
+	static Ref<Cluster> UnflattenCluster(int32_t index, const DerivedCluster* clusters, uint64_t clusterCount, const uint32_t* indices, uint64_t indexCount)
+	{
+		if (index < 0 || index >= (int64_t)clusterCount) return nullptr;
+
+		const DerivedCluster& src = clusters[index];
+		if ((uint64_t)src.IndexOffset + src.IndexCount > indexCount) return nullptr;
+
+		Ref<Cluster> cluster = CreateRef<Cluster>();
+		cluster->LocalPosition = src.LocalPosition;
+		cluster->Normal = src.Normal;
+		cluster->ClusterRadius = src.ClusterRadius;
+		cluster->Indices.assign(indices + src.IndexOffset, indices + src.IndexOffset + src.IndexCount);
+		// Children are always stored after their parent, which rules out cycles
+		if (src.Child1 > index) cluster->Child1 = UnflattenCluster(src.Child1, clusters, clusterCount, indices, indexCount);
+		if (src.Child2 > index) cluster->Child2 = UnflattenCluster(src.Child2, clusters, clusterCount, indices, indexCount);
+		return cluster;
+	}
+
+	void DerivedDataCache::Initialize(const Path& cacheDirectory)
+	{
+		std::lock_guard<std::mutex> lock(s_Mutex);
+
+		std::error_code error;
+		std::filesystem::create_directories(cacheDirectory, error);
+		if (error)
+		{
+			SuoraError("DerivedDataCache: Cannot create '{0}': {1}", cacheDirectory.string(), error.message());
+			s_CacheDirectory = Path();
+			return;
+		}
+		s_CacheDirectory = cacheDirectory;
+
+		uint64_t size = 0, entries = 0;
+		for (auto it = std::filesystem::directory_iterator(s_CacheDirectory, error); !error && it != std::filesystem::directory_iterator(); it.increment(error))
+		{
+			if (!it->is_regular_file()) continue;
+
+			// Leftovers of interrupted writes
+			if (it->path().extension() == ".tmp")
+			{
+				std::error_code removeError;
+				std::filesystem::remove(it->path(), removeError);
+				continue;
+			}
+			size += it->file_size();
+			entries++;
+		}
+		s_CacheSize = size;
+		SUORA_LOG(LogCategory::AssetManagement, LogLevel::Info, "DerivedDataCache: {0} entries, {1} MB in '{2}'", entries, size / (1024 * 1024), s_CacheDirectory.string());
+	}
+
+	bool DerivedDataCache::IsInitialized()
+	{
+		std::lock_guard<std::mutex> lock(s_Mutex);
+		return !s_CacheDirectory.empty();
+	}
+
+	uint64_t DerivedDataCache::HashBytes(const void* data, size_t size, uint64_t seed)
+	{
+		// FNV-1a
+		uint64_t hash = seed;
+		const uint8_t* bytes = (const uint8_t*)data;
+		for (size_t i = 0; i < size; i++)
+		{
+			hash ^= bytes[i];
+			hash *= 1099511628211ull;
+		}
+		return hash;
+	}
+
+	uint64_t DerivedDataCache::HashFile(const Path& path)
+	{
+		// Packages store the same hash, even for Sources that are not packaged themselves
+		uint64_t packagedSize = 0, packagedHash = 0;
+		if (VirtualFileSystem::GetFileInfo(path, packagedSize, packagedHash))
+		{
+			return packagedHash;
+		}
+
+		std::error_code timeError, sizeError;
+		const auto lastWriteTime = std::filesystem::last_write_time(path, timeError);
+		const uint64_t fileSize = std::filesystem::file_size(path, sizeError);
+		if (timeError || sizeError)
+		{
+			return 0;
+		}
+
+		const String key = path.lexically_normal().generic_string();
+		{
+			std::lock_guard<std::mutex> lock(s_Mutex);
+			auto It = s_FileHashes.find(key);
+			if (It != s_FileHashes.end() && It->second.LastWriteTime == lastWriteTime && It->second.FileSize == fileSize)
+			{
+				return It->second.Hash;
+			}
+		}
+
+		std::ifstream file(path, std::ios::binary);
+		if (!file)
+		{
+			return 0;
+		}
+		std::vector<char> chunk(1024 * 1024);
+		uint64_t hash = HashBytes(&fileSize, sizeof(fileSize));
+		uint64_t bytesRead = 0;
+		while (file)
+		{
+			file.read(chunk.data(), chunk.size());
+			hash = HashBytes(chunk.data(), (size_t)file.gcount(), hash);
+			bytesRead += (uint64_t)file.gcount();
+		}
+		if (file.bad() || bytesRead != fileSize)
+		{
+			return 0;
+		}
+
+		std::lock_guard<std::mutex> lock(s_Mutex);
+		s_FileHashes[key] = FileHash{ lastWriteTime, fileSize, hash };
+		return hash;
+	}
+
+	String DerivedDataCache::MakeKey(const Path& sourcePath, uint32_t importVersion, const String& importSettings)
+	{
+		const uint64_t sourceHash = HashFile(sourcePath);
+		if (sourceHash == 0)
+		{
+			// Every missing Source would share the same key otherwise
+			return String();
+		}
+		uint64_t settingsHash = HashBytes(&importVersion, sizeof(importVersion));
+		settingsHash = HashBytes(&DerivedDataFormatVersion, sizeof(DerivedDataFormatVersion), settingsHash);
+		settingsHash = HashBytes(importSettings.data(), importSettings.size(), settingsHash);
+
+		char key[40];
+		snprintf(key, sizeof(key), "%016llx%016llx", (unsigned long long)sourceHash, (unsigned long long)settingsHash);
+		return String(key);
+	}
+
+	Path DerivedDataCache::GetCacheDirectory()
+	{
+		std::lock_guard<std::mutex> lock(s_Mutex);
+		return s_CacheDirectory;
+	}
+
+	bool DerivedDataCache::Contains(const String& key)
+	{
+		if (key.empty())
+		{
+			return false;
+		}
+
+		const Path directory = GetCacheDirectory();
+		std::error_code error;
+		if (!directory.empty() && std::filesystem::is_regular_file(directory / (key + ".ddc"), error))
+		{
+			return true;
+		}
+		return VirtualFileSystem::HasContentInMounts("DerivedData/" + key + ".ddc");
+	}
+
+	bool DerivedDataCache::ReadEntry(const String& key, std::vector<uint8_t>& data)
+	{
+		if (key.empty())
+		{
+			return false;
+		}
+
+		const Path directory = GetCacheDirectory();
+		if (directory.empty())
+		{
+			return ReadPackagedEntry(key, data);
+		}
+
+		const Path path = directory / (key + ".ddc");
+		std::ifstream file(path, std::ios::binary | std::ios::ate);
+		if (!file)
+		{
+			return ReadPackagedEntry(key, data);
+		}
+
+		const std::streamsize size = file.tellg();
+		file.seekg(0);
+		data.resize((size_t)size);
+		if (size < (std::streamsize)sizeof(DerivedDataHeader) || !file.read((char*)data.data(), size))
+		{
+			s_Misses++;
+			return false;
+		}
+		file.close();
+
+		const DerivedDataHeader* header = (const DerivedDataHeader*)data.data();
+		if (header->Magic != DerivedDataMagic || header->FormatVersion != DerivedDataFormatVersion)
+		{
+			s_Misses++;
+			return false;
+		}
+
+		// The last write time doubles as the LRU timestamp
+		std::error_code error;
+		std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now(), error);
+
+		s_Hits++;
+		s_BytesRead += (uint64_t)size;
+		return true;
+	}
+
+	bool DerivedDataCache::ReadPackagedEntry(const String& key, std::vector<uint8_t>& data)
+	{
+		if (!VirtualFileSystem::ReadFileInMounts("DerivedData/" + key + ".ddc", data) || data.size() < sizeof(DerivedDataHeader))
+		{
+			s_Misses++;
+			return false;
+		}
+
+		const DerivedDataHeader* header = (const DerivedDataHeader*)data.data();
+		if (header->Magic != DerivedDataMagic || header->FormatVersion != DerivedDataFormatVersion)
+		{
+			s_Misses++;
+			return false;
+		}
+
+		s_Hits++;
+		s_BytesRead += data.size();
+		return true;
+	}
+
+	void DerivedDataCache::WriteEntry(const String& key, const std::vector<uint8_t>& data)
+	{
+		const Path directory = GetCacheDirectory();
+		if (directory.empty() || key.empty())
+		{
+			return;
+		}
+
+		// Write to a temporary file first, so that concurrent readers never see partial entries
+		const Path path = directory / (key + ".ddc");
+		const Path tempPath = directory / (key + "." + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id())) + ".tmp");
+		{
+			std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+			if (!file || !file.write((const char*)data.data(), data.size()))
+			{
+				SuoraWarn("DerivedDataCache: Failed to write '{0}'", tempPath.string());
+				return;
+			}
+		}
+
+		std::error_code error;
+		const uint64_t previousSize = std::filesystem::exists(path, error) ? std::filesystem::file_size(path, error) : 0;
+		std::filesystem::rename(tempPath, path, error);
+		if (error)
+		{
+			std::filesystem::remove(tempPath, error);
+			return;
+		}
+
+		s_Writes++;
+		s_BytesWritten += data.size();
+		s_CacheSize += data.size() - previousSize;
+
+		if (s_CacheSize > s_MaxCacheSize)
+		{
+			Trim();
+		}
+	}
+
+	bool DerivedDataCache::LoadMesh(const String& key, MeshBuffer& buffer, Ref<Cluster>& mainCluster, uint32_t& submeshCount)
+	{
+		std::vector<uint8_t> data;
+		if (!ReadEntry(key, data))
+		{
+			return false;
+		}
+
+		if (data.size() < sizeof(DerivedMeshHeader))
+		{
+			return false;
+		}
+		DerivedMeshHeader header;
+		memcpy(&header, data.data(), sizeof(header));
+		if (header.Header.Type != DerivedDataType::Mesh
+			|| !IsSectionValid(data, header.VertexOffset, header.VertexCount, sizeof(Vertex))
+			|| !IsSectionValid(data, header.IndexOffset, header.IndexCount, sizeof(uint32_t))
+			|| !IsSectionValid(data, header.ClusterOffset, header.ClusterCount, sizeof(DerivedCluster))
+			|| !IsSectionValid(data, header.ClusterIndexOffset, header.ClusterIndexCount, sizeof(uint32_t)))
+		{
+			SuoraWarn("DerivedDataCache: Corrupted Mesh entry {0}", key);
+			s_Hits--;
+			s_Misses++;
+			return false;
+		}
+
+		submeshCount = (uint32_t)header.SubmeshCount;
+		buffer.Vertices.resize(header.VertexCount);
+		if (header.VertexCount > 0) memcpy(buffer.Vertices.data(), data.data() + header.VertexOffset, header.VertexCount * sizeof(Vertex));
+		buffer.Indices.resize(header.IndexCount);
+		if (header.IndexCount > 0) memcpy(buffer.Indices.data(), data.data() + header.IndexOffset, header.IndexCount * sizeof(uint32_t));
+
+		mainCluster = nullptr;
+		if (header.ClusterCount > 0)
+		{
+			std::vector<DerivedCluster> clusters(header.ClusterCount);
+			std::vector<uint32_t> clusterIndices(header.ClusterIndexCount);
+			memcpy(clusters.data(), data.data() + header.ClusterOffset, header.ClusterCount * sizeof(DerivedCluster));
+			if (header.ClusterIndexCount > 0) memcpy(clusterIndices.data(), data.data() + header.ClusterIndexOffset, header.ClusterIndexCount * sizeof(uint32_t));
+			mainCluster = UnflattenCluster(0, clusters.data(), clusters.size(), clusterIndices.data(), clusterIndices.size());
+		}
+
+		return true;
+	}
+
+	void DerivedDataCache::StoreMesh(const String& key, const MeshBuffer& buffer, const Ref<Cluster>& mainCluster, uint32_t submeshCount)
+	{
+		std::vector<DerivedCluster> clusters;
+		std::vector<uint32_t> clusterIndices;
+		if (mainCluster)
+		{
+			FlattenCluster(mainCluster, clusters, clusterIndices);
+		}
+
+		DerivedMeshHeader header;
+		header.Header.Type = DerivedDataType::Mesh;
+		header.SubmeshCount = submeshCount;
+		header.VertexCount = buffer.Vertices.size();
+		header.VertexOffset = Align(sizeof(DerivedMeshHeader));
+		header.IndexCount = buffer.Indices.size();
+		header.IndexOffset = Align(header.VertexOffset + header.VertexCount * sizeof(Vertex));
+		header.ClusterCount = clusters.size();
+		header.ClusterOffset = Align(header.IndexOffset + header.IndexCount * sizeof(uint32_t));
+		header.ClusterIndexCount = clusterIndices.size();
+		header.ClusterIndexOffset = Align(header.ClusterOffset + header.ClusterCount * sizeof(DerivedCluster));
+
+		std::vector<uint8_t> data(header.ClusterIndexOffset + header.ClusterIndexCount * sizeof(uint32_t), 0);
+		WriteSection(data, 0, &header, sizeof(header));
+		WriteSection(data, header.VertexOffset, buffer.Vertices.data(), header.VertexCount * sizeof(Vertex));
+		WriteSection(data, header.IndexOffset, buffer.Indices.data(), header.IndexCount * sizeof(uint32_t));
+		WriteSection(data, header.ClusterOffset, clusters.data(), header.ClusterCount * sizeof(DerivedCluster));
+		WriteSection(data, header.ClusterIndexOffset, clusterIndices.data(), header.ClusterIndexCount * sizeof(uint32_t));
+
+		WriteEntry(key, data);
+	}
+
+	Ref<CookedTexture> DerivedDataCache::LoadTexture(const String& key)
+	{
+		std::vector<uint8_t> data;
+		if (!ReadEntry(key, data))
+		{
+			return nullptr;
+		}
+
+		DerivedTextureHeader header;
+		bool valid = data.size() >= sizeof(DerivedTextureHeader);
+		if (valid)
+		{
+			memcpy(&header, data.data(), sizeof(header));
+			valid = header.Header.Type == DerivedDataType::Texture && header.Width > 0 && header.Height > 0 && header.MipCount > 0
+				&& IsSectionValid(data, header.MipTableOffset, header.MipCount, sizeof(DerivedTextureMip));
+		}
+
+		Ref<CookedTexture> texture = CreateRef<CookedTexture>();
+		if (valid)
+		{
+			texture->m_Format = (ETextureFormat)header.Format;
+			texture->m_Width = header.Width;
+			texture->m_Height = header.Height;
+			texture->m_Mips.resize(header.MipCount);
+
+			const DerivedTextureMip* mips = (const DerivedTextureMip*)(data.data() + header.MipTableOffset);
+			for (uint32_t i = 0; i < header.MipCount && valid; i++)
+			{
+				valid = IsSectionValid(data, mips[i].Offset, mips[i].Size, 1);
+				if (valid)
+				{
+					texture->m_Mips[i].assign(data.begin() + mips[i].Offset, data.begin() + mips[i].Offset + mips[i].Size);
+				}
+			}
+		}
+
+		if (!valid)
+		{
+			SuoraWarn("DerivedDataCache: Corrupted Texture entry {0}", key);
+			s_Hits--;
+			s_Misses++;
+			return nullptr;
+		}
+		return texture;
+	}
+
+	void DerivedDataCache::StoreTexture(const String& key, const CookedTexture& texture)
+	{
+		if (texture.m_Mips.empty())
+		{
+			return;
+		}
+
+		DerivedTextureHeader header;
+		header.Header.Type = DerivedDataType::Texture;
+		header.Format = (uint32_t)texture.m_Format;
+		header.Width = texture.m_Width;
+		header.Height = texture.m_Height;
+		header.MipCount = (uint32_t)texture.m_Mips.size();
+		header.MipTableOffset = Align(sizeof(DerivedTextureHeader));
+
+		std::vector<DerivedTextureMip> mips(texture.m_Mips.size());
+		uint64_t offset = Align(header.MipTableOffset + mips.size() * sizeof(DerivedTextureMip));
+		for (size_t i = 0; i < mips.size(); i++)
+		{
+			mips[i].Offset = offset;
+			mips[i].Size = texture.m_Mips[i].size();
+			offset = Align(offset + mips[i].Size);
+		}
+
+		std::vector<uint8_t> data(offset, 0);
+		WriteSection(data, 0, &header, sizeof(header));
+		WriteSection(data, header.MipTableOffset, mips.data(), mips.size() * sizeof(DerivedTextureMip));
+		for (size_t i = 0; i < mips.size(); i++)
+		{
+			WriteSection(data, mips[i].Offset, texture.m_Mips[i].data(), mips[i].Size);
+		}
+
+		WriteEntry(key, data);
+	}
+
+	bool DerivedDataCache::LoadShaderProgram(const String& key, uint32_t& binaryFormat, std::vector<uint8_t>& binary)
+	{
+		std::vector<uint8_t> data;
+		if (!ReadEntry(key, data))
+		{
+			return false;
+		}
+
+		DerivedShaderProgramHeader header;
+		bool valid = data.size() >= sizeof(DerivedShaderProgramHeader);
+		if (valid)
+		{
+			memcpy(&header, data.data(), sizeof(header));
+			valid = header.Header.Type == DerivedDataType::ShaderProgram && header.BinarySize > 0 && IsSectionValid(data, header.BinaryOffset, header.BinarySize, 1);
+		}
+
+		if (!valid)
+		{
+			SuoraWarn("DerivedDataCache: Corrupted ShaderProgram entry {0}", key);
+			s_Hits--;
+			s_Misses++;
+			return false;
+		}
+
+		binaryFormat = header.BinaryFormat;
+		binary.assign(data.begin() + header.BinaryOffset, data.begin() + header.BinaryOffset + header.BinarySize);
+		return true;
+	}
+
+	void DerivedDataCache::StoreShaderProgram(const String& key, uint32_t binaryFormat, const std::vector<uint8_t>& binary)
+	{
+		if (binary.empty())
+		{
+			return;
+		}
+
+		DerivedShaderProgramHeader header;
+		header.Header.Type = DerivedDataType::ShaderProgram;
+		header.BinaryFormat = binaryFormat;
+		header.BinaryOffset = Align(sizeof(DerivedShaderProgramHeader));
+		header.BinarySize = binary.size();
+
+		std::vector<uint8_t> data(Align(header.BinaryOffset + header.BinarySize), 0);
+		WriteSection(data, 0, &header, sizeof(header));
+		WriteSection(data, header.BinaryOffset, binary.data(), header.BinarySize);
+
+		WriteEntry(key, data);
+	}
+
+	void DerivedDataCache::Trim()
+	{
+		std::lock_guard<std::mutex> lock(s_Mutex);
+		if (s_CacheDirectory.empty())
+		{
+			return;
+		}
+
+		struct Entry
+		{
+			Path FilePath;
+			std::filesystem::file_time_type LastUsed;
+			uint64_t Size = 0;
+		};
+		std::vector<Entry> entries;
+		uint64_t size = 0;
+
+		std::error_code error;
+		for (auto it = std::filesystem::directory_iterator(s_CacheDirectory, error); !error && it != std::filesystem::directory_iterator(); it.increment(error))
+		{
+			if (!it->is_regular_file() || it->path().extension() != ".ddc") continue;
+			std::error_code entryError;
+			Entry entry{ it->path(), it->last_write_time(entryError), it->file_size(entryError) };
+			if (entryError) continue;
+			size += entry.Size;
+			entries.push_back(entry);
+		}
+
+		// Leave some headroom, so that the next write does not trim again
+		const uint64_t targetSize = s_MaxCacheSize - s_MaxCacheSize / 10;
+		if (size > targetSize)
+		{
+			std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.LastUsed < b.LastUsed; });
+			for (const Entry& entry : entries)
+			{
+				if (size <= targetSize) break;
+				if (std::filesystem::remove(entry.FilePath, error))
+				{
+					size -= entry.Size;
+					s_Evictions++;
+				}
+			}
+		}
+		s_CacheSize = size;
+	}
+
+	void DerivedDataCache::Clear()
+	{
+		std::lock_guard<std::mutex> lock(s_Mutex);
+		if (s_CacheDirectory.empty())
+		{
+			return;
+		}
+
+		std::error_code error;
+		for (auto it = std::filesystem::directory_iterator(s_CacheDirectory, error); !error && it != std::filesystem::directory_iterator(); it.increment(error))
+		{
+			if (it->is_regular_file()) std::filesystem::remove(it->path(), error);
+		}
+		s_CacheSize = 0;
+	}
+
+	DerivedDataCacheStats DerivedDataCache::GetStats()
+	{
+		DerivedDataCacheStats stats;
+		stats.Hits = s_Hits;
+		stats.Misses = s_Misses;
+		stats.Writes = s_Writes;
+		stats.Evictions = s_Evictions;
+		stats.BytesRead = s_BytesRead;
+		stats.BytesWritten = s_BytesWritten;
+		stats.CacheSize = s_CacheSize;
+		return stats;
+	}
+
+}
@@ -0,0 +1,98 @@
+#pragma once
+#include <stdint.h>
+#include <filesystem>
+#include <mutex>
+#include <atomic>
+#include <unordered_map>
+#include "Suora/Common/Filesystem.h"
+
+namespace Suora
+{
+	struct MeshBuffer;
+	struct Cluster;
+	struct CookedTexture;
+
+	struct DerivedDataCacheStats
+	{
+		uint64_t Hits = 0;
+		uint64_t Misses = 0;
+		uint64_t Writes = 0;
+		uint64_t Evictions = 0;
+		uint64_t BytesRead = 0;
+		uint64_t BytesWritten = 0;
+		uint64_t CacheSize = 0;
+	};
+
+	/* Local cache for the results of expensive Asset imports (e.g. Assimp imports, Decima clustering, Texture cooking).
+	 * Entries are keyed by a hash of the source file bytes, the import settings and an import version.
+	 * The entries are stored in a flat binary layout with aligned sections, so they can be read in
+	 * a single pass or memory-mapped. The least recently used entries are removed once s_MaxCacheSize is exceeded.
+	 * Entries and Source hashes of cooked packages are looked up in the VirtualFileSystem as well.
+	 * All functions can be called from asynchronous loading threads.                                              */
+	class DerivedDataCache
+	{
+	public:
+		static void Initialize(const Path& cacheDirectory);
+		static bool IsInitialized();
+
+		/** The importVersion has to be increased, whenever the import produces different results.
+		 *  Returns an empty key, if the Source cannot be read. Empty keys are never loaded or stored. */
+		static String MakeKey(const Path& sourcePath, uint32_t importVersion, const String& importSettings);
+
+		/** Whether an entry exists, without reading it */
+		static bool Contains(const String& key);
+
+		static bool LoadMesh(const String& key, MeshBuffer& buffer, Ref<Cluster>& mainCluster, uint32_t& submeshCount);
+		static void StoreMesh(const String& key, const MeshBuffer& buffer, const Ref<Cluster>& mainCluster, uint32_t submeshCount);
+
+		static Ref<CookedTexture> LoadTexture(const String& key);
+		static void StoreTexture(const String& key, const CookedTexture& texture);
+
+		/** Linked shader programs in the binary format of the graphics driver */
+		static bool LoadShaderProgram(const String& key, uint32_t& binaryFormat, std::vector<uint8_t>& binary);
+		static void StoreShaderProgram(const String& key, uint32_t binaryFormat, const std::vector<uint8_t>& binary);
+
+		/** Removes the least recently used entries, until the cache fits into s_MaxCacheSize */
+		static void Trim();
+		static void Clear();
+
+		static DerivedDataCacheStats GetStats();
+
+		static uint64_t HashBytes(const void* data, size_t size, uint64_t seed = 14695981039346656037ull);
+		/** Hash of the file content. Hashes are remembered as long as the file size and last write time do not change.
+		 *  Returns 0, if the file is missing or cannot be read. */
+		static uint64_t HashFile(const Path& path);
+
+		inline static uint64_t s_MaxCacheSize = 4ull * 1024ull * 1024ull * 1024ull;
+
+	private:
+		/** A copy, Initialize() may change the directory while loader threads read and write entries */
+		static Path GetCacheDirectory();
+		static bool ReadEntry(const String& key, std::vector<uint8_t>& data);
+		/** Entries that were cooked into a mounted package, see AssetCooker */
+		static bool ReadPackagedEntry(const String& key, std::vector<uint8_t>& data);
+		static void WriteEntry(const String& key, const std::vector<uint8_t>& data);
+
+		struct FileHash
+		{
+			std::filesystem::file_time_type LastWriteTime;
+			uint64_t FileSize = 0;
+			uint64_t Hash = 0;
+		};
+
+		inline static Path s_CacheDirectory;
+		inline static std::mutex s_Mutex;
+		inline static std::unordered_map<String, FileHash> s_FileHashes;
+
+		inline static std::atomic<uint64_t> s_Hits = 0;
+		inline static std::atomic<uint64_t> s_Misses = 0;
+		inline static std::atomic<uint64_t> s_Writes = 0;
+		inline static std::atomic<uint64_t> s_Evictions = 0;
+		inline static std::atomic<uint64_t> s_BytesRead = 0;
+		inline static std::atomic<uint64_t> s_BytesWritten = 0;
+		inline static std::atomic<uint64_t> s_CacheSize = 0;
+
+		friend class AssetCooker;
+	};
+
+}
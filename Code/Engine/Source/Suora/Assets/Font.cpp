@@ -1,5 +1,7 @@
 #include "Precompiled.h"
 #include "Font.h"
+#include "Suora/Platform/Platform.h"
+#include <sstream>
 
 
 namespace Suora
@@ -21,8 +23,9 @@ namespace Suora
 		m_FontPath = texturePath.string();
 		//Instance = this;
 
-		std::ifstream reader(path.c_str());
-		if (reader.is_open())
+		// The atlas may be inside a mounted package
+		std::istringstream reader(Platform::ReadFromFile(path));
+		if (reader)
 		{
 			while (!reader.eof())
 			{
@@ -64,7 +67,6 @@ namespace Suora
 
 			}
 		}
-		reader.close();
 	}
     void Font::LoadAtlas()
     {
@@ -6,10 +6,13 @@
 #include "Suora/Renderer/VertexArray.h"
 #include "Suora/Renderer/Vertex.h"
 #include "Suora/Renderer/Decima.h"
-#include "Suora/Core/Threading.h"
+#include "Suora/Core/TaskScheduler.h"
+#include "Suora/Debug/Profiler.h"
 #include "Suora/Assets/AssetManager.h"
+#include "Suora/Assets/AssetResidencyManager.h"
+#include "Suora/Assets/DerivedDataCache.h"
+#include "Suora/Assets/VirtualFileSystem.h"
 #include <fstream>
-#include <future>
 
 #include <assimp/Importer.hpp>
 #include <assimp/scene.h>
@@ -18,6 +21,9 @@
 namespace Suora
 {
 	
+	// Has to be increased, whenever the import or the Decima clustering produce different results
+	static constexpr uint32_t MeshImportVersion = 1;
+
 	// Primitive Shapes
 	Mesh* Mesh::Quad = AssetManager::GetAsset<Mesh>(SuoraID("75f466f7-baec-4c5a-a23b-a5e3dc3d22bc"));
 	Mesh* Mesh::Plane = AssetManager::GetAsset<Mesh>(SuoraID("45d16e2b-822e-44bf-a686-abde5552f67a"));
@@ -31,12 +37,9 @@ namespace Suora
 
 	Mesh::~Mesh()
 	{
-		if (m_AsyncMeshBuffer.get())
-		{
-			// TextureBuffer_stbi has to be destroyed here (!)
-			// We also wait for the async load task to finish
-			m_AsyncMeshBuffer->get();
-		}
+		// A load that is still running refers to this Mesh; the continuation is dropped by cancelling
+		m_AsyncMeshBuffer.Cancel();
+		m_AsyncMeshBuffer.Wait();
 		if (m_VertexArray)
 		{
 			m_VertexArray = nullptr;
@@ -94,7 +97,7 @@ namespace Suora
 
 		if (IsSourceAssetPathValid())
 		{
-			meshSize = std::filesystem::file_size(GetSourceAssetPath());
+			meshSize = (uint32_t)GetSourceAssetFileSize();
 		}
 
 		return baseSize + meshSize;
@@ -416,6 +419,8 @@ namespace Suora
 			return nullptr;
 		}
 
+		AssetResidencyManager::MarkUsed(this);
+
 		if (m_VertexArray)
 		{
 			return m_VertexArray.get();
@@ -427,41 +432,123 @@ namespace Suora
 				return nullptr;
 			}
 
-			if (!m_AsyncMeshBuffer.get() && AssetManager::s_AssetStreamPool.Size() < AssetManager::GetAssetStreamCountLimit())
+			if (!m_AsyncMeshBuffer.IsValid() && AssetManager::s_AssetStreamPool.Size() < AssetManager::GetAssetStreamCountLimit())
 			{
 				AssetManager::s_AssetStreamPool.Add(this);
-				String filePath = GetSourceAssetPath().string();
 
-				m_AsyncMeshBuffer = CreateRef<std::future<Ref<MeshBuffer>>>(std::async(std::launch::async, &Mesh::Async_LoadMeshBuffer, this, filePath, m_MeshBuffer.Vertices, m_MeshBuffer.Indices));
+				// The VertexArray is created in FinishAsyncLoad(), within the frame budget of the TaskScheduler
+				m_AsyncMeshBuffer = TaskScheduler::Run([this, path = GetSourceAssetPath().string(), vertices = m_MeshBuffer.Vertices, indices = m_MeshBuffer.Indices]()
+				{
+					return Async_LoadMeshBuffer(path, vertices, indices);
+				}, [this]() { FinishAsyncLoad(); }, TaskPriority::Normal, "Mesh::Load");
 			}
-			else if (m_AsyncMeshBuffer.get() && IsFutureReady(*m_AsyncMeshBuffer.get()))
+		}
+
+		return nullptr;
+	}
+
+	bool Mesh::IsStreamedIn() const
+	{
+		if (IsMasterMesh())
+		{
+			for (const Ref<Mesh>& It : m_Submeshes)
 			{
-				AssetManager::s_AssetStreamPool.Remove(this);
+				if (!It->IsStreamedIn()) return false;
+			}
+			return true;
+		}
+		return m_VertexArray != nullptr;
+	}
 
-				if (IsSubMesh() && AssetManager::s_AssetStreamPool.Contains(m_ParentMesh))
-					AssetManager::s_AssetStreamPool.Remove(m_ParentMesh);
+	void Mesh::FinishAsyncLoad()
+	{
+		SUORA_PROFILE_SCOPE("Mesh::FinishAsyncLoad");
+		SUORA_PROFILE_COUNTER_ADD("Assets Streamed", 1);
+		AssetManager::s_AssetStreamPool.Remove(this);
 
-				const Ref<MeshBuffer> buffer = m_AsyncMeshBuffer->get();
+		if (IsSubMesh() && AssetManager::s_AssetStreamPool.Contains(m_ParentMesh))
+			AssetManager::s_AssetStreamPool.Remove(m_ParentMesh);
 
-				if (m_MeshBuffer.Indices.empty())
-				{
-					m_MeshBuffer = *buffer.get();
-				}
+		const Ref<MeshBuffer> buffer = m_AsyncMeshBuffer.Get();
 
-				m_AsyncMeshBuffer = nullptr;
+		if (m_MeshBuffer.Indices.empty())
+		{
+			m_MeshBuffer = *buffer.get();
+		}
 
-				if (!IsMasterMesh())
-				{
-					m_VertexArray = Ref<VertexArray>(VertexArray::Create(IsDecimaMesh() ? MeshBuffer(m_MeshBuffer.Vertices, m_MainCluster->Indices) : m_MeshBuffer));
-				}
+		m_AsyncMeshBuffer = Task<Ref<MeshBuffer>>();
+
+		if (!IsMasterMesh())
+		{
+			m_VertexArray = Ref<VertexArray>(VertexArray::Create(IsDecimaMesh() ? MeshBuffer(m_MeshBuffer.Vertices, m_MainCluster->Indices) : m_MeshBuffer));
+			AssetResidencyManager::NotifyResident(this);
+		}
+		else
+		{
+			// Master Meshes are done, once their Submeshes are created
+			for (auto& It : m_Submeshes)
+			{
+				It->SetAssetStreamMode(GetAssetStreamMode());
 			}
 		}
+	}
 
-		return nullptr;
+	bool Mesh::IsStreamingInProgress() const
+	{
+		if (IsMasterMesh())
+		{
+			for (const Ref<Mesh>& It : m_Submeshes)
+			{
+				if (It->IsStreamingInProgress()) return true;
+			}
+			return false;
+		}
+		return m_AsyncMeshBuffer.IsValid();
+	}
+
+	uint64_t Mesh::GetResidentCPUMemory() const
+	{
+		return m_MeshBuffer.Vertices.capacity() * sizeof(Vertex) + m_MeshBuffer.Indices.capacity() * sizeof(uint32_t);
+	}
+
+	uint64_t Mesh::GetResidentGPUMemory() const
+	{
+		return m_VertexArray ? m_MeshBuffer.Vertices.size() * sizeof(Vertex) + m_MeshBuffer.Indices.size() * sizeof(uint32_t) : 0;
+	}
+
+	bool Mesh::CanStreamOut() const
+	{
+		// Decima Clusters and the Submesh hierarchy are only built once
+		return !IsDecimaMesh() && !IsMasterMesh();
+	}
+
+	void Mesh::StreamIn()
+	{
+		if (IsMasterMesh())
+		{
+			for (auto& It : m_Submeshes)
+			{
+				It->GetVertexArray();
+			}
+			return;
+		}
+		GetVertexArray();
+	}
+
+	void Mesh::StreamOut()
+	{
+		if (!CanStreamOut() || IsStreamingInProgress())
+		{
+			return;
+		}
+
+		m_VertexArray = nullptr;
+		m_MeshBuffer = MeshBuffer();
 	}
 
 	void Mesh::RebuildMesh()
 	{
+		AssetResidencyManager::NotifyReleased(this);
 		m_VertexArray = nullptr;
 		m_MeshBuffer = MeshBuffer();
 		m_MainCluster = nullptr;
@@ -477,9 +564,47 @@ namespace Suora
 	{
 		Ref<MeshBuffer> buffer = CreateRef<MeshBuffer>(v, i);
 
+		// Skip the import, if the processed buffers are still in the DerivedDataCache
+		const String cacheKey = v.empty() && i.empty() ? GetDerivedDataKey(path) : String();
+		const bool useCache = !cacheKey.empty();
+		if (useCache)
+		{
+			uint32_t submeshCount = 0;
+			Ref<Cluster> mainCluster;
+			if (DerivedDataCache::LoadMesh(cacheKey, *buffer.get(), mainCluster, submeshCount) && AreSubmeshesCached(path, submeshCount))
+			{
+				if (!IsSubMesh() && submeshCount > 1)
+				{
+					CreateSubmeshes(submeshCount, nullptr, nullptr);
+					return buffer;
+				}
+
+				m_SubmeshImporter = nullptr;
+				m_SubmeshScene = nullptr;
+				if (IsDecimaMesh() && !m_MainCluster)
+				{
+					if (mainCluster) m_MainCluster = mainCluster;
+					else Clusterfication(*buffer.get());
+				}
+				return buffer;
+			}
+		}
+
 		// read file via ASSIMP
 		Ref<Assimp::Importer> importer = CreateRef<Assimp::Importer>();
-		const aiScene* scene = m_SubmeshScene ? m_SubmeshScene : importer->ReadFile(path, aiProcess_Triangulate | aiProcess_GenSmoothNormals | aiProcess_FixInfacingNormals/*| aiProcess_FlipUVs*/ | aiProcess_CalcTangentSpace | aiProcess_JoinIdenticalVertices);
+		const uint32_t importFlags = aiProcess_Triangulate | aiProcess_GenSmoothNormals | aiProcess_FixInfacingNormals/*| aiProcess_FlipUVs*/ | aiProcess_CalcTangentSpace | aiProcess_JoinIdenticalVertices;
+		const aiScene* scene = m_SubmeshScene;
+		std::vector<uint8_t> packagedSource;
+		if (!scene && VirtualFileSystem::ReadFile(path, packagedSource))
+		{
+			// Sources in cooked packages, the extension tells Assimp the format
+			const String hint = Path(path).extension().string();
+			scene = importer->ReadFileFromMemory(packagedSource.data(), packagedSource.size(), importFlags, hint.empty() ? "" : hint.c_str() + 1);
+		}
+		else if (!scene)
+		{
+			scene = importer->ReadFile(path, importFlags);
+		}
 		// check for errors
 		if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode) // if is Not Zero
 		{
@@ -494,20 +619,8 @@ namespace Suora
 		if (!IsSubMesh() && scene->mNumMeshes > 1)
 		{
 			// Read Submeshes
-			m_IsMasterMesh = true;
-			for (int i = 0; i < scene->mNumMeshes; i++)
-			{
-				Ref<Mesh> submesh = Ref<Mesh>(new Mesh());
-				submesh->m_ParentMesh = this;
-				submesh->m_SubmeshIndex = i;
-				submesh->SetSourceAssetName(GetSourceAssetName());
-				submesh->m_SubmeshImporter = importer;
-				submesh->m_SubmeshScene = scene;
-				submesh->m_ImportScale = m_ImportScale;
-				submesh->m_Path = m_Path;
-				submesh->m_IsDecimaMesh = m_IsDecimaMesh;
-				m_Submeshes.Add(submesh);
-			}
+			CreateSubmeshes(scene->mNumMeshes, importer, scene);
+			if (useCache) DerivedDataCache::StoreMesh(cacheKey, MeshBuffer(), nullptr, scene->mNumMeshes);
 			return buffer;
 		}
 
@@ -577,9 +690,61 @@ namespace Suora
 
 		if (IsDecimaMesh() && !m_MainCluster) Clusterfication(*buffer.get());
 
+		if (useCache) DerivedDataCache::StoreMesh(cacheKey, *buffer.get(), IsDecimaMesh() ? m_MainCluster : nullptr, 0);
+
 		return buffer;
 	}
 
+	bool Mesh::AreSubmeshesCached(const String& path, uint32_t submeshCount) const
+	{
+		if (IsSubMesh() || submeshCount <= 1)
+		{
+			return true;
+		}
+		// Submeshes without a scene import the whole Source on their own. One import for the master is cheaper.
+		for (uint32_t i = 0; i < submeshCount; i++)
+		{
+			if (!DerivedDataCache::Contains(GetDerivedDataKey(path, (int32_t)i)))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	void Mesh::CreateSubmeshes(uint32_t count, const Ref<Assimp::Importer>& importer, const aiScene* scene)
+	{
+		m_IsMasterMesh = true;
+		for (int i = 0; i < count; i++)
+		{
+			Ref<Mesh> submesh = Ref<Mesh>(new Mesh());
+			submesh->m_ParentMesh = this;
+			submesh->m_SubmeshIndex = i;
+			submesh->SetSourceAssetName(GetSourceAssetName());
+			submesh->m_SubmeshImporter = importer;
+			submesh->m_SubmeshScene = scene;
+			submesh->m_ImportScale = m_ImportScale;
+			submesh->m_FlipNormals = m_FlipNormals;
+			submesh->m_Path = m_Path;
+			submesh->m_IsDecimaMesh = m_IsDecimaMesh;
+			m_Submeshes.Add(submesh);
+		}
+	}
+
+	String Mesh::GetImportSettingsString(int32_t submeshIndex) const
+	{
+		return "Scale=" + Vec::ToString(m_ImportScale) + ";FlipNormals=" + (m_FlipNormals ? "1" : "0") + ";Decima=" + (m_IsDecimaMesh ? "1" : "0")
+			+ ";TrianglesPerCluster=" + std::to_string(Decima::s_TrianglesPerCluster) + ";Submesh=" + std::to_string(submeshIndex);
+	}
+	String Mesh::GetDerivedDataKey(const String& path) const
+	{
+		return GetDerivedDataKey(path, m_SubmeshIndex);
+	}
+	String Mesh::GetDerivedDataKey(const String& path, int32_t submeshIndex) const
+	{
+		return DerivedDataCache::MakeKey(path, MeshImportVersion, GetImportSettingsString(submeshIndex));
+	}
+
 
 	void Mesh::Serialize(Yaml::Node& root)
 	{
@@ -706,16 +871,13 @@ namespace Suora
 		}
 		if (Parents.size() > 1)
 		{
-			std::vector<std::future<void>> jobs;
-			for (const Ref<Cluster>& cluster : Parents)
-			{
-				//Decimate_Cluster(buffer, cluster);
-				jobs.push_back(std::async(std::launch::async, &Decimate_Cluster, buffer, cluster));
-			}
-			for (auto& job : jobs)
+			TaskScheduler::ParallelFor((uint32_t)Parents.size(), [&buffer, &Parents](uint32_t begin, uint32_t end)
 			{
-				job.get();
-			}
+				for (uint32_t i = begin; i < end; i++)
+				{
+					Decimate_Cluster(buffer, Parents[i]);
+				}
+			});
 			GroupClusters(buffer, Parents);
 		}
 		else
@@ -2,7 +2,7 @@
 #include "StreamableAsset.h"
 #include <vector>
 #include <string>
-#include <future>
+#include "Suora/Core/TaskScheduler.h"
 #include "Suora/Common/VectorUtils.h"
 #include "Suora/Renderer/Vertex.h"
 #include "Suora/Renderer/VertexArray.h"
@@ -72,12 +72,20 @@ namespace Suora
 		float m_NegativeY_Bounds = 0.0f;
 		MeshBuffer m_MeshBuffer;
 		Ref<VertexArray> m_VertexArray = nullptr;
-		Ref<std::future<Ref<MeshBuffer>>> m_AsyncMeshBuffer;
+		Task<Ref<MeshBuffer>> m_AsyncMeshBuffer;
 
 		inline bool IsMasterMesh() const { return m_IsMasterMesh; }
 		inline bool IsSubMesh() const { return m_ParentMesh; }
 		inline bool IsDecimaMesh() const { return m_IsDecimaMesh; }
 
+		virtual bool IsStreamedIn() const override;
+		virtual bool IsStreamingInProgress() const override;
+		virtual uint64_t GetResidentCPUMemory() const override;
+		virtual uint64_t GetResidentGPUMemory() const override;
+		virtual bool CanStreamOut() const override;
+		virtual void StreamIn() override;
+		virtual void StreamOut() override;
+
 		// Primitive Shapes
 		static Mesh* Quad;
 		static Mesh* Plane;
@@ -93,8 +101,18 @@ namespace Suora
 		Ref<Assimp::Importer> m_SubmeshImporter;
 		const aiScene* m_SubmeshScene = nullptr;
 
+		void CreateSubmeshes(uint32_t count, const Ref<Assimp::Importer>& importer, const aiScene* scene);
+		/** Whether every Submesh of a master with submeshCount Submeshes has its own DerivedDataCache entry */
+		bool AreSubmeshesCached(const String& path, uint32_t submeshCount) const;
+		/** Everything that influences the import result, used as part of the DerivedDataCache key */
+		String GetImportSettingsString(int32_t submeshIndex) const;
+		String GetDerivedDataKey(const String& path) const;
+		String GetDerivedDataKey(const String& path, int32_t submeshIndex) const;
+		/** Main thread continuation of the load, creates the VertexArray */
+		void FinishAsyncLoad();
 
 		friend class DetailsPanel;
 		friend class Decima;
+		friend class AssetCooker;
 	};
 }
\ No newline at end of file
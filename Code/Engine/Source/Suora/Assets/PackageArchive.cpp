@@ -0,0 +1,415 @@
+#include "Precompiled.h"
+#include "PackageArchive.h"
+#include "DerivedDataCache.h"
+#include <cstring>
+
+namespace Suora
+{
+	struct PackageHeader
+	{
+		uint32_t Magic = PackageArchive::s_Magic;
+		uint32_t FormatVersion = PackageArchive::s_FormatVersion;
+		uint64_t EntryCount = 0;
+		uint64_t TableOffset = 0;
+		uint64_t TableSize = 0;
+		uint64_t TableHash = 0;
+	};
+
+	static constexpr size_t LZ4MinMatch = 4;
+	static constexpr size_t LZ4LastLiterals = 5;
+	static constexpr size_t LZ4MatchFindLimit = 12;
+	static constexpr size_t LZ4MaxOffset = 65535;
+	static constexpr uint32_t LZ4HashBits = 16;
+
+	static uint32_t Read32(const uint8_t* src)
+	{
+		uint32_t value;
+		memcpy(&value, src, sizeof(value));
+		return value;
+	}
+
+	static void WriteLZ4Length(std::vector<uint8_t>& out, size_t length)
+	{
+		while (length >= 255)
+		{
+			out.push_back(255);
+			length -= 255;
+		}
+		out.push_back((uint8_t)length);
+	}
+
+	static void WriteLZ4Literals(std::vector<uint8_t>& out, const uint8_t* literals, size_t length, uint8_t matchCode)
+	{
+		out.push_back((uint8_t)((std::min<size_t>(length, 15) << 4) | matchCode));
+		if (length >= 15) WriteLZ4Length(out, length - 15);
+		out.insert(out.end(), literals, literals + length);
+	}
+
+	void PackageCompressor::Compress(const uint8_t* src, size_t size, std::vector<uint8_t>& out)
+	{
+		out.clear();
+		out.reserve(size + size / 255 + 16);
+
+		size_t anchor = 0;
+		if (size >= LZ4MatchFindLimit)
+		{
+			// Positions of the last occurrence of every 4 byte sequence, by hash
+			std::vector<uint32_t> table((size_t)1 << LZ4HashBits, UINT32_MAX);
+			const size_t matchLimit = size - LZ4LastLiterals;
+			const size_t searchLimit = size - LZ4MatchFindLimit;
+
+			size_t pos = 0;
+			while (pos <= searchLimit)
+			{
+				const uint32_t sequence = Read32(src + pos);
+				const uint32_t hash = (sequence * 2654435761u) >> (32 - LZ4HashBits);
+				const uint32_t candidate = table[hash];
+				table[hash] = (uint32_t)pos;
+
+				if (candidate == UINT32_MAX || pos - candidate > LZ4MaxOffset || Read32(src + candidate) != sequence)
+				{
+					// Skip faster through data that does not compress, like LZ4's acceleration
+					pos += 1 + ((pos - anchor) >> 6);
+					continue;
+				}
+
+				size_t length = LZ4MinMatch;
+				while (pos + length < matchLimit && src[candidate + length] == src[pos + length])
+				{
+					length++;
+				}
+
+				const size_t matchCode = length - LZ4MinMatch;
+				const size_t offset = pos - candidate;
+				WriteLZ4Literals(out, src + anchor, pos - anchor, (uint8_t)std::min<size_t>(matchCode, 15));
+				out.push_back((uint8_t)(offset & 0xFF));
+				out.push_back((uint8_t)(offset >> 8));
+				if (matchCode >= 15) WriteLZ4Length(out, matchCode - 15);
+
+				pos += length;
+				anchor = pos;
+			}
+		}
+
+		// The last sequence only consists of literals
+		WriteLZ4Literals(out, src + anchor, size - anchor, 0);
+	}
+
+	bool PackageCompressor::Decompress(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstSize)
+	{
+		size_t in = 0, out = 0;
+		auto readLength = [&](size_t& length) -> bool
+		{
+			uint8_t byte = 0;
+			do
+			{
+				if (in >= srcSize) return false;
+				byte = src[in++];
+				length += byte;
+			} while (byte == 255);
+			return true;
+		};
+
+		while (in < srcSize)
+		{
+			const uint8_t token = src[in++];
+
+			size_t literalLength = token >> 4;
+			if (literalLength == 15 && !readLength(literalLength)) return false;
+			if (literalLength > srcSize - in || literalLength > dstSize - out) return false;
+			if (literalLength > 0) memcpy(dst + out, src + in, literalLength);
+			in += literalLength;
+			out += literalLength;
+
+			if (in == srcSize)
+			{
+				break;
+			}
+
+			if (srcSize - in < 2) return false;
+			const size_t offset = (size_t)src[in] | ((size_t)src[in + 1] << 8);
+			in += 2;
+			if (offset == 0 || offset > out) return false;
+
+			size_t matchLength = token & 15;
+			if (matchLength == 15 && !readLength(matchLength)) return false;
+			matchLength += LZ4MinMatch;
+			if (matchLength > dstSize - out) return false;
+
+			const uint8_t* match = dst + out - offset;
+			if (offset >= matchLength)
+			{
+				memcpy(dst + out, match, matchLength);
+			}
+			else
+			{
+				// Overlapping matches repeat the last <offset> bytes
+				for (size_t i = 0; i < matchLength; i++) dst[out + i] = match[i];
+			}
+			out += matchLength;
+		}
+
+		return out == dstSize;
+	}
+
+	static uint64_t HashContent(const uint8_t* data, uint64_t size)
+	{
+		// Equal to DerivedDataCache::HashFile()
+		return DerivedDataCache::HashBytes(data, (size_t)size, DerivedDataCache::HashBytes(&size, sizeof(size)));
+	}
+
+	template<class T>
+	static void WriteValue(std::vector<uint8_t>& data, const T& value)
+	{
+		const uint8_t* bytes = (const uint8_t*)&value;
+		data.insert(data.end(), bytes, bytes + sizeof(T));
+	}
+
+	template<class T>
+	static bool ReadValue(const std::vector<uint8_t>& data, size_t& offset, T& value)
+	{
+		if (data.size() - offset < sizeof(T)) return false;
+		memcpy(&value, data.data() + offset, sizeof(T));
+		offset += sizeof(T);
+		return true;
+	}
+
+	PackageWriter::~PackageWriter()
+	{
+		if (m_File.is_open())
+		{
+			// Never leave a package without a table of contents behind
+			m_File.close();
+			std::error_code error;
+			std::filesystem::remove(m_Path, error);
+		}
+	}
+
+	bool PackageWriter::Open(const Path& archivePath)
+	{
+		m_Path = archivePath;
+		m_File.open(archivePath, std::ios::binary | std::ios::trunc);
+		if (!m_File)
+		{
+			SuoraError("PackageWriter: Cannot create '{0}'", archivePath.string());
+			return false;
+		}
+
+		const PackageHeader header;
+		m_File.write((const char*)&header, sizeof(header));
+		m_Offset = sizeof(header);
+		return (bool)m_File;
+	}
+
+	bool PackageWriter::AddFile(const String& path, const std::vector<uint8_t>& data, PackageCompression compression, uint32_t flags)
+	{
+		if (!m_File.is_open() || Contains(path)) return false;
+
+		PackageEntry entry;
+		entry.Path = path;
+		entry.Offset = m_Offset;
+		entry.RawSize = data.size();
+		entry.Hash = HashContent(data.data(), data.size());
+		entry.Flags = flags;
+
+		std::vector<uint8_t> compressed;
+		if (compression == PackageCompression::LZ4 && !data.empty())
+		{
+			PackageCompressor::Compress(data.data(), data.size(), compressed);
+		}
+		const bool useCompressed = !compressed.empty() && compressed.size() < data.size();
+		const std::vector<uint8_t>& stored = useCompressed ? compressed : data;
+		entry.Compression = useCompressed ? compression : PackageCompression::None;
+		entry.StoredSize = stored.size();
+
+		if (!m_File.write((const char*)stored.data(), stored.size()))
+		{
+			SuoraError("PackageWriter: Failed to write '{0}' into '{1}'", path, m_Path.string());
+			return false;
+		}
+		m_Offset += stored.size();
+
+		m_Stats.Entries++;
+		m_Stats.RawSize += entry.RawSize;
+		m_Stats.StoredSize += entry.StoredSize;
+		m_EntryIndices[entry.Path] = m_Entries.size();
+		m_Entries.push_back(entry);
+		return true;
+	}
+
+	bool PackageWriter::AddHashOnly(const String& path, uint64_t hash, uint64_t rawSize)
+	{
+		if (!m_File.is_open() || Contains(path)) return false;
+
+		PackageEntry entry;
+		entry.Path = path;
+		entry.Offset = m_Offset;
+		entry.RawSize = rawSize;
+		entry.Hash = hash;
+		entry.Flags = PackageEntryFlags::HashOnly;
+
+		m_Stats.Entries++;
+		m_EntryIndices[entry.Path] = m_Entries.size();
+		m_Entries.push_back(entry);
+		return true;
+	}
+
+	bool PackageWriter::Contains(const String& path) const
+	{
+		return m_EntryIndices.find(path) != m_EntryIndices.end();
+	}
+
+	bool PackageWriter::Finish()
+	{
+		if (!m_File.is_open()) return false;
+
+		std::vector<uint8_t> table;
+		for (const PackageEntry& entry : m_Entries)
+		{
+			WriteValue(table, (uint32_t)entry.Path.size());
+			table.insert(table.end(), entry.Path.begin(), entry.Path.end());
+			WriteValue(table, entry.Offset);
+			WriteValue(table, entry.StoredSize);
+			WriteValue(table, entry.RawSize);
+			WriteValue(table, entry.Hash);
+			WriteValue(table, (uint32_t)entry.Compression);
+			WriteValue(table, entry.Flags);
+		}
+
+		PackageHeader header;
+		header.EntryCount = m_Entries.size();
+		header.TableOffset = m_Offset;
+		header.TableSize = table.size();
+		header.TableHash = DerivedDataCache::HashBytes(table.data(), table.size());
+
+		m_File.write((const char*)table.data(), table.size());
+		m_File.seekp(0);
+		m_File.write((const char*)&header, sizeof(header));
+		m_File.close();
+
+		if (m_File.fail())
+		{
+			SuoraError("PackageWriter: Failed to write the table of contents of '{0}'", m_Path.string());
+			std::error_code error;
+			std::filesystem::remove(m_Path, error);
+			return false;
+		}
+		m_Stats.StoredSize += sizeof(header) + table.size();
+		return true;
+	}
+
+	Ref<PackageArchive> PackageArchive::Open(const Path& archivePath)
+	{
+		Ref<PackageArchive> archive = CreateRef<PackageArchive>();
+		archive->m_Path = archivePath;
+		archive->m_File.open(archivePath, std::ios::binary);
+		if (!archive->m_File)
+		{
+			return nullptr;
+		}
+
+		PackageHeader header;
+		if (!archive->m_File.read((char*)&header, sizeof(header)) || header.Magic != s_Magic || header.FormatVersion != s_FormatVersion)
+		{
+			SuoraError("PackageArchive: '{0}' is not a package of this version.", archivePath.string());
+			return nullptr;
+		}
+
+		std::vector<uint8_t> table((size_t)header.TableSize);
+		archive->m_File.seekg((std::streamoff)header.TableOffset);
+		if (!archive->m_File.read((char*)table.data(), table.size()) || DerivedDataCache::HashBytes(table.data(), table.size()) != header.TableHash)
+		{
+			SuoraError("PackageArchive: The table of contents of '{0}' is corrupted.", archivePath.string());
+			return nullptr;
+		}
+
+		size_t offset = 0;
+		archive->m_Entries.resize((size_t)header.EntryCount);
+		for (size_t i = 0; i < archive->m_Entries.size(); i++)
+		{
+			PackageEntry& entry = archive->m_Entries[i];
+			uint32_t pathLength = 0, compression = 0;
+			if (!ReadValue(table, offset, pathLength) || table.size() - offset < pathLength)
+			{
+				return nullptr;
+			}
+			entry.Path.assign((const char*)table.data() + offset, pathLength);
+			offset += pathLength;
+
+			if (!ReadValue(table, offset, entry.Offset) || !ReadValue(table, offset, entry.StoredSize) || !ReadValue(table, offset, entry.RawSize)
+				|| !ReadValue(table, offset, entry.Hash) || !ReadValue(table, offset, compression) || !ReadValue(table, offset, entry.Flags))
+			{
+				return nullptr;
+			}
+			entry.Compression = (PackageCompression)compression;
+			archive->m_EntryIndices[entry.Path] = i;
+		}
+
+		return archive;
+	}
+
+	String PackageArchive::NormalizePath(const Path& path)
+	{
+		return path.lexically_normal().generic_string();
+	}
+
+	const PackageEntry* PackageArchive::Find(const String& path) const
+	{
+		auto It = m_EntryIndices.find(path);
+		return It != m_EntryIndices.end() ? &m_Entries[It->second] : nullptr;
+	}
+
+	bool PackageArchive::Read(const PackageEntry& entry, std::vector<uint8_t>& data)
+	{
+		if (entry.Flags & PackageEntryFlags::HashOnly)
+		{
+			return false;
+		}
+
+		std::vector<uint8_t> stored((size_t)entry.StoredSize);
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_File.clear();
+			m_File.seekg((std::streamoff)entry.Offset);
+			if (!m_File.read((char*)stored.data(), stored.size()))
+			{
+				SuoraError("PackageArchive: Failed to read '{0}' from '{1}'", entry.Path, m_Path.string());
+				return false;
+			}
+		}
+
+		switch (entry.Compression)
+		{
+		case PackageCompression::None:
+			data = std::move(stored);
+			if (data.size() != entry.RawSize)
+			{
+				data.clear();
+				return false;
+			}
+			break;
+		case PackageCompression::LZ4:
+			data.resize((size_t)entry.RawSize);
+			if (!PackageCompressor::Decompress(stored.data(), stored.size(), data.data(), data.size()))
+			{
+				SuoraError("PackageArchive: '{0}' in '{1}' is corrupted.", entry.Path, m_Path.string());
+				data.clear();
+				return false;
+			}
+			break;
+		default:
+			SuoraError("PackageArchive: '{0}' uses an unknown compression.", entry.Path);
+			return false;
+		}
+
+		// Damaged blobs can still decompress to the right size, and uncompressed ones are not validated at all
+		if (HashContent(data.data(), data.size()) != entry.Hash)
+		{
+			SuoraError("PackageArchive: '{0}' in '{1}' does not match its hash.", entry.Path, m_Path.string());
+			data.clear();
+			return false;
+		}
+		return true;
+	}
+
+}
@@ -0,0 +1,111 @@
+#pragma once
+#include <stdint.h>
+#include <vector>
+#include <fstream>
+#include <mutex>
+#include <unordered_map>
+#include "Suora/Common/Filesystem.h"
+
+namespace Suora
+{
+
+	enum class PackageCompression : uint32_t
+	{
+		None = 0,
+		/** LZ4 block format, see PackageCompressor */
+		LZ4
+	};
+
+	namespace PackageEntryFlags
+	{
+		enum : uint32_t
+		{
+			None = 0,
+			/** Asset files, that were converted to the binary Yaml form of the AssetCooker */
+			CookedAsset = 1 << 0,
+			/** Only the size and hash of the file are packaged, e.g. Sources that were replaced by their DerivedData */
+			HashOnly = 1 << 1
+		};
+	}
+
+	struct PackageEntry
+	{
+		/** Relative to the mount point, lexically normal with forward slashes */
+		String Path;
+		uint64_t Offset = 0;
+		uint64_t StoredSize = 0;
+		uint64_t RawSize = 0;
+		/** Same hash as DerivedDataCache::HashFile(), so DerivedData keys of packaged Sources stay valid */
+		uint64_t Hash = 0;
+		PackageCompression Compression = PackageCompression::None;
+		uint32_t Flags = PackageEntryFlags::None;
+	};
+
+	struct PackageStats
+	{
+		uint64_t Entries = 0;
+		uint64_t RawSize = 0;
+		uint64_t StoredSize = 0;
+	};
+
+	/* In-house implementation of the LZ4 block format (greedy matching, 64 KB window), so packages do not
+	 * depend on an external compression library. Decompression validates all lengths and offsets.          */
+	struct PackageCompressor
+	{
+		static void Compress(const uint8_t* src, size_t size, std::vector<uint8_t>& out);
+		/** Returns false, if the block is malformed or does not decompress to exactly dstSize bytes */
+		static bool Decompress(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstSize);
+	};
+
+	/* Streams files into a single package: a header, the (compressed) file blobs and a table of contents at the end.
+	 * Entries are written as they are added, so only one file is held in memory at a time.                          */
+	class PackageWriter
+	{
+	public:
+		~PackageWriter();
+
+		bool Open(const Path& archivePath);
+		/** Entries that do not shrink are stored uncompressed */
+		bool AddFile(const String& path, const std::vector<uint8_t>& data, PackageCompression compression, uint32_t flags = PackageEntryFlags::None);
+		bool AddHashOnly(const String& path, uint64_t hash, uint64_t rawSize);
+		bool Contains(const String& path) const;
+		/** Writes the table of contents. The package is incomplete, until this succeeded. */
+		bool Finish();
+
+		const PackageStats& GetStats() const { return m_Stats; }
+
+	private:
+		std::ofstream m_File;
+		Path m_Path;
+		std::vector<PackageEntry> m_Entries;
+		std::unordered_map<String, size_t> m_EntryIndices;
+		uint64_t m_Offset = 0;
+		PackageStats m_Stats;
+	};
+
+	/* Read access to a package written by the PackageWriter. Reading entries is thread-safe. */
+	class PackageArchive
+	{
+	public:
+		static Ref<PackageArchive> Open(const Path& archivePath);
+
+		static String NormalizePath(const Path& path);
+
+		const PackageEntry* Find(const String& path) const;
+		bool Read(const PackageEntry& entry, std::vector<uint8_t>& data);
+
+		const std::vector<PackageEntry>& GetEntries() const { return m_Entries; }
+		const Path& GetPath() const { return m_Path; }
+
+		static constexpr uint32_t s_Magic = 0x4b505553; // "SUPK"
+		static constexpr uint32_t s_FormatVersion = 1;
+
+	private:
+		Path m_Path;
+		std::ifstream m_File;
+		std::mutex m_Mutex;
+		std::vector<PackageEntry> m_Entries;
+		std::unordered_map<String, size_t> m_EntryIndices;
+	};
+
+}
@@ -4,6 +4,8 @@
 #include "Suora/Platform/Platform.h"
 #include "Suora/NodeScript/ShaderNodeGraph.h"
 #include "Suora/Renderer/Shader.h"
+#include "Suora/Renderer/ShaderCache.h"
+#include "DerivedDataCache.h"
 #include "Suora/Common/Common.h"
 
 namespace Suora
@@ -15,6 +17,10 @@ namespace Suora
 	}
 	ShaderGraph::~ShaderGraph()
 	{
+		for (const ShaderPermutation& permutation : m_Permutations)
+		{
+			ShaderCache::Release(permutation.Key);
+		}
 	}
 
 	void ShaderGraph::PreInitializeAsset(Yaml::Node& root)
@@ -65,93 +71,59 @@ namespace Suora
 
 	Shader* ShaderGraph::GetShader()
 	{
-		if (!m_Shader.get())
-		{
-			if (m_ShaderSource == "")
-			{
-				return nullptr;
-			}
-			m_Shader = Ref<Shader>(Shader::CreatePtr(*this));
-		}
-		return m_Shader.get();
+		return GetPermutationShader(MaterialType::Material, m_Shader);
 	}
 	Shader* ShaderGraph::GetDepthShader()
 	{
-		// TODO: Opacity in Fragment shader
-		if (!m_DepthShader.get())
-		{
-			const String vertex = Shader::PreProcess(m_ShaderSource)["vertex"];
-			String fragment = "\
-#version 330 core\n\
-\n\
-in vec2 UV;\n\
-out float out_Depth;\n\
-\n\
-\n\
-void main(void)\n\
-{\n\
-	float ndcDepth =\
-	(2.0 * gl_FragCoord.z - gl_DepthRange.near - gl_DepthRange.far) / (gl_DepthRange.far - gl_DepthRange.near);\
-	float clipDepth = ndcDepth / gl_FragCoord.w;\
-	out_Depth = vec4((clipDepth * 0.5) + 0.5).r; \n\
-}\n";
-
-			fragment = "\
-#version 330 core\n\
-\n\
-in vec2 UV;\n\
-out float out_Depth;\n\
-\n\
-\n\
-void main(void)\n\
-{\n\
-	 \n\
-}\n";
-			m_DepthShader = Shader::Create("MaterialDepth", vertex, fragment);
-		}
-		return m_DepthShader.get();
+		return GetPermutationShader(MaterialType::Depth, m_DepthShader);
 	}
 	Shader* ShaderGraph::GetFlatWhiteShader()
 	{
-		if (!m_FlatWhiteShader.get())
+		return GetPermutationShader(MaterialType::FlatWhite, m_FlatWhiteShader);
+	}
+	Shader* ShaderGraph::GetIDShader()
+	{
+		Shader* shader = GetPermutationShader(MaterialType::ObjectID, m_IDShader);
+		if (shader) shader->Bind();
+		//m_IDShader->SetInt("u_ID", 13);
+		return shader;
+	}
+
+	Shader* ShaderGraph::GetPermutationShader(MaterialType type, Ref<Shader>& shader)
+	{
+		if (!shader.get())
 		{
-			const String vertex = Shader::PreProcess(m_ShaderSource)["vertex"];
-			const String fragment = "\
-#version 330 core\n\
-\n\
-in vec2 UV;\n\
-out vec4 out_Color;\n\
-\n\
-\n\
-void main(void)\n\
-{\n\
-	out_Color = vec4(1.0);\n\
-}\n";
-			m_FlatWhiteShader = Shader::Create("FlatWhite", vertex, fragment);
+			for (const ShaderPermutation& permutation : m_Permutations)
+			{
+				if (permutation.Type == type)
+				{
+					shader = ShaderCache::Get(permutation);
+					break;
+				}
+			}
 		}
-		return m_FlatWhiteShader.get();
+		return shader.get();
 	}
-	Shader* ShaderGraph::GetIDShader()
+
+	void ShaderGraph::UpdatePermutations()
 	{
-		if (!m_IDShader.get())
+		// Prepared before the old ones are released, so unchanged permutations keep their programs
+		Array<ShaderPermutation> previous = std::move(m_Permutations);
+		m_Permutations = ShaderPermutation::EnumerateShaderGraph(m_Name, m_ShaderSource);
+		for (const ShaderPermutation& permutation : m_Permutations)
 		{
-			const String vertex = Shader::PreProcess(m_ShaderSource)["vertex"];
-			const String fragment = "\
-#version 330 core\n\
-\n\
-in vec2 UV;\n\
-out int out_ID;\n\
-uniform int u_ID;\n\
-\n\
-void main(void)\n\
-{\n\
-	out_ID = u_ID;\n\
-}\n";
-			m_IDShader = Shader::Create("IDShader", vertex, fragment);
+			ShaderCache::Prepare(permutation);
 		}
-		m_IDShader->Bind();
-		//m_IDShader->SetInt("u_ID", 13);
-		return m_IDShader.get();
+		for (const ShaderPermutation& permutation : previous)
+		{
+			ShaderCache::Release(permutation.Key);
+		}
+
+		// Programs of the previous source are outdated
+		m_Shader = nullptr;
+		m_DepthShader = nullptr;
+		m_FlatWhiteShader = nullptr;
+		m_IDShader = nullptr;
 	}
 
 	bool ShaderGraph::IsDeferred() const
@@ -165,6 +137,149 @@ void main(void)\n\
 	}
 
 
+	Ref<ShaderGraphTemplate> ShaderGraphTemplate::Parse(const String& source)
+	{
+		Ref<ShaderGraphTemplate> result = CreateRef<ShaderGraphTemplate>();
+		result->Hash = DerivedDataCache::HashBytes(source.data(), source.size());
+
+		String str = source;
+		StringUtil::RemoveCommentsFromString(str);
+
+		Array<BaseShaderInput> fragmentInputs;
+		Array<int32_t> openBlocks;
+		int32_t temporaries = -1;
+		size_t sourceBegin = 0, stageBegin = 0, pos = 0;
+		auto addToken = [&](size_t end, TokenType type, const String& text)
+		{
+			if (end > sourceBegin)
+			{
+				for (size_t i = sourceBegin; i < end; i++)
+				{
+					if (str[i] == '{')
+					{
+						openBlocks.Add(result->BlockParents.Size());
+						result->BlockParents.Add(openBlocks.Size() > 1 ? openBlocks[openBlocks.Last() - 1] : -1);
+					}
+					else if (str[i] == '}' && !openBlocks.IsEmpty())
+					{
+						openBlocks.RemoveLastItem();
+					}
+				}
+				result->Tokens.Add(Token{ TokenType::Source, str.substr(sourceBegin, end - sourceBegin) });
+			}
+			if (type != TokenType::Source) result->Tokens.Add(Token{ type, text, openBlocks.IsEmpty() ? -1 : openBlocks[openBlocks.Last()] });
+		};
+		// Start of the line of the statement around the placeholder, npos if it starts before 'begin' or cannot be split
+		auto findStatement = [&str](size_t begin, size_t placeholder)
+		{
+			size_t statement = String::npos;
+			int32_t parentheses = 0;
+			for (size_t i = begin; i < placeholder; i++)
+			{
+				if (str[i] == '(') parentheses++;
+				else if (str[i] == ')') parentheses--;
+				else if (str[i] == '{' || str[i] == '}' || (str[i] == ';' && parentheses <= 0))
+				{
+					statement = i + 1;
+					parentheses = 0;
+				}
+			}
+			if (statement == String::npos) return statement;
+
+			const size_t lineEnd = str.find('\n', statement);
+			if (lineEnd < placeholder && str.find_first_not_of(" \t\r", statement) == lineEnd) statement = lineEnd + 1;
+			// Nothing can be declared between a block and its "else"
+			const size_t next = str.find_first_not_of(" \t\r\n", statement);
+			return str.compare(next, 4, "else") == 0 ? String::npos : statement;
+		};
+
+		while (true)
+		{
+			const size_t placeholder = str.find('$', pos);
+			const size_t stage = str.find("#type", pos);
+			const size_t next = std::min(placeholder, stage);
+			if (next == String::npos) break;
+
+			if (next == stage)
+			{
+				// The stage switches stay in the source, Shader::PreProcess() splits at them
+				temporaries = -1;
+				stageBegin = pos = stage + 5;
+			}
+			else if (str.compare(placeholder, 12, "$VERT_INPUTS") == 0 || str.compare(placeholder, 12, "$FRAG_INPUTS") == 0)
+			{
+				addToken(placeholder, str[placeholder + 1] == 'V' ? TokenType::VertexInputs : TokenType::FragmentInputs, "");
+				sourceBegin = pos = placeholder + 12;
+			}
+			else if (str.compare(placeholder, 9, "$DEFERRED") == 0)
+			{
+				addToken(placeholder, TokenType::Deferred, "");
+				result->IsDeferred = true;
+				sourceBegin = pos = placeholder + 9;
+			}
+			else if (str.compare(placeholder, 11, "$VERT_INPUT") == 0 || str.compare(placeholder, 11, "$FRAG_INPUT") == 0)
+			{
+				const bool vertex = str[placeholder + 1] == 'V';
+				BaseShaderInput input;
+				input.m_InVertexShader = vertex;
+				int64_t begin = placeholder, end = 0;
+				ShaderGraph::LoadBaseShaderInput(input, begin, end, str);
+				(vertex ? result->Inputs : fragmentInputs).Add(input);
+
+				// The placeholder ends with the bracket that closes "$VERT_INPUT("
+				end = placeholder;
+				while (str[end++] != '"');
+				end++;
+				while (str[end++] != '"');
+				int brackets = 1;
+				while (brackets > 0)
+				{
+					if (str[end] == '(') brackets++;
+					if (str[end] == ')') brackets--;
+					end++;
+				}
+				const size_t statement = findStatement(std::max(sourceBegin, stageBegin), placeholder);
+				if (statement != String::npos)
+				{
+					addToken(statement, TokenType::Temporaries, "");
+					temporaries = result->Tokens.Last();
+					sourceBegin = statement;
+				}
+				addToken(placeholder, vertex ? TokenType::VertexInput : TokenType::FragmentInput, input.m_Label);
+				result->Tokens.LastItem().Temporaries = temporaries;
+				sourceBegin = pos = end;
+			}
+			else
+			{
+				pos = placeholder + 1;
+			}
+		}
+		addToken(str.size(), TokenType::Source, "");
+
+		for (BaseShaderInput& input : fragmentInputs)
+		{
+			result->Inputs.Add(input);
+		}
+		return result;
+	}
+
+	Ref<ShaderGraphTemplate> ShaderGraphTemplate::Load(const String& path)
+	{
+		std::error_code error;
+		const std::filesystem::file_time_type writeTime = std::filesystem::last_write_time(path, error);
+
+		std::lock_guard<std::mutex> lock(s_CacheMutex);
+		auto it = s_Cache.find(path);
+		if (it != s_Cache.end() && !error && it->second.WriteTime == writeTime)
+		{
+			return it->second.Template;
+		}
+
+		Ref<ShaderGraphTemplate> result = Parse(Platform::ReadFromFile(path));
+		s_Cache[path] = CacheEntry{ writeTime, result };
+		return result;
+	}
+
 	void ShaderGraph::LoadBaseShaderInput(BaseShaderInput& input, int64_t& begin, int64_t& end, const String& str)
 	{
 		while (str[begin++] != '"');
@@ -187,67 +302,29 @@ void main(void)\n\
 
 	void ShaderGraph::LoadBaseShaderInputs(const String& path)
 	{
-		String str = Platform::ReadFromFile(path);
-		StringUtil::RemoveCommentsFromString(str);
-		int64_t begin = 0, end = 0;
-		m_BaseShaderInputs.Clear();
-		while (true)
-		{
-			begin = str.find("$VERT_INPUT", begin);
-			if (begin == String::npos) break;
-			BaseShaderInput input;
-			input.m_InVertexShader = true;
-			LoadBaseShaderInput(input, begin, end, str);
-			m_BaseShaderInputs.Add(input);
-		}
-		begin = 0;
-		while (true)
-		{
-			begin = str.find("$FRAG_INPUT", begin);
-			if (begin == String::npos) break;
-			BaseShaderInput input;
-			input.m_InVertexShader = false;
-			LoadBaseShaderInput(input, begin, end, str);
-			m_BaseShaderInputs.Add(input);
-		}
+		m_BaseShaderInputs = ShaderGraphTemplate::Load(path)->Inputs;
 	}
 
-	void ShaderGraph::GenerateShaderInput(String& str, int64_t begin, VisualNode* master, bool vertex, bool& error)
+	void ShaderGraph::FindShaderInput(const String& label, VisualNode* master, bool vertex, VisualNodePin*& pin, const BaseShaderInput*& input)
 	{
-		int64_t labelBegin = begin;
-		int64_t end = begin;
-		while (str[labelBegin++] != '"');
-		end = labelBegin + 1;
-		while (str[end++] != '"');
-		String label = str.substr(labelBegin, end - labelBegin - 1);
-		int brackets = 1;
-		while (brackets > 0)
-		{
-			if (str[end] == '(') brackets++;
-			if (str[end] == ')') brackets--;
-			end++;
-		}
-		str.erase(begin, end - begin);
+		FindShaderInput(m_BaseShaderInputs, label, master, vertex, pin, input);
+	}
 
-		for (VisualNodePin& pin : master->m_InputPins)
+	void ShaderGraph::FindShaderInput(const Array<BaseShaderInput>& inputs, const String& label, VisualNode* master, bool vertex, VisualNodePin*& pin, const BaseShaderInput*& input)
+	{
+		pin = nullptr;
+		input = nullptr;
+		for (VisualNodePin& masterPin : master->m_InputPins)
 		{
-			if (pin.Label == label)
+			if (masterPin.Label == label)
 			{
-				for (BaseShaderInput& input : m_BaseShaderInputs)
+				for (const BaseShaderInput& it : inputs)
 				{
-					if (pin.PinID == (int64_t)input.m_Type && pin.Label == input.m_Label && input.m_InVertexShader == vertex)
+					if (masterPin.PinID == (int64_t)it.m_Type && masterPin.Label == it.m_Label && it.m_InVertexShader == vertex)
 					{
-						if (pin.Target)
-						{
-							String src = ShaderGraphCompiler::CompileShaderNode(*(pin.Target->GetNode()), *(pin.Target), vertex, error);
-							str.insert(begin, src);
-							return;
-						}
-						else
-						{
-							str.insert(begin, input.m_DefaultSource);
-							return;
-						}
+						pin = &masterPin;
+						input = &it;
+						return;
 					}
 				}
 				return;
@@ -255,12 +332,86 @@ void main(void)\n\
 		}
 	}
 
+	bool ShaderGraph::GenerateSource(const ShaderGraphTemplate& baseShader, VisualNode* master, const String& uniforms, String& source)
+	{
+		using TokenType = ShaderGraphTemplate::TokenType;
+
+		// All roots of a stage are known before the first one is compiled, so shared Nodes can be found
+		ShaderGraphStageCompiler vertexStage(true, baseShader.BlockParents), fragmentStage(false, baseShader.BlockParents);
+		Array<const BaseShaderInput*> inputs;
+		Array<int32_t> roots;
+		for (const ShaderGraphTemplate::Token& token : baseShader.Tokens)
+		{
+			if (token.Type != TokenType::VertexInput && token.Type != TokenType::FragmentInput) continue;
+
+			const bool vertex = token.Type == TokenType::VertexInput;
+			VisualNodePin* pin = nullptr;
+			const BaseShaderInput* input = nullptr;
+			FindShaderInput(baseShader.Inputs, token.Text, master, vertex, pin, input);
+			inputs.Add(input);
+
+			const int32_t declarationBlock = token.Temporaries != -1 ? baseShader.Tokens[token.Temporaries].Block : -1;
+			roots.Add(pin && pin->Target ? (vertex ? vertexStage : fragmentStage).AddRoot(*pin->Target, token.Block, declarationBlock) : -1);
+		}
+
+		// Temporaries are declared in front of the statement of their first use
+		Array<String> temporaries(baseShader.Tokens.Size());
+		Array<String> inputSources;
+		int32_t inputIndex = 0;
+		for (const ShaderGraphTemplate::Token& token : baseShader.Tokens)
+		{
+			if (token.Type != TokenType::VertexInput && token.Type != TokenType::FragmentInput) continue;
+
+			const BaseShaderInput* input = inputs[inputIndex];
+			const int32_t root = roots[inputIndex++];
+			if (!input)
+			{
+				inputSources.Add(String());
+			}
+			else if (root != -1)
+			{
+				String unused;
+				ShaderGraphStageCompiler& stage = input->m_InVertexShader ? vertexStage : fragmentStage;
+				inputSources.Add(stage.Compile(root, token.Temporaries != -1 ? temporaries[token.Temporaries] : unused));
+			}
+			else
+			{
+				inputSources.Add(input->m_DefaultSource);
+			}
+		}
+
+		if (vertexStage.HasError() || fragmentStage.HasError())
+		{
+			return false;
+		}
+
+		source.clear();
+		inputIndex = 0;
+		for (int32_t i = 0; i < baseShader.Tokens.Size(); i++)
+		{
+			const ShaderGraphTemplate::Token& token = baseShader.Tokens[i];
+			switch (token.Type)
+			{
+			case TokenType::Source:				source += token.Text; break;
+			case TokenType::VertexInputs:
+			case TokenType::FragmentInputs:		source += uniforms; break;
+			case TokenType::Deferred:			source += "/* DEFERRED */"; break;
+			case TokenType::VertexInput:
+			case TokenType::FragmentInput:		source += inputSources[inputIndex++]; break;
+			case TokenType::Temporaries:		source += temporaries[i]; break;
+			default: break;
+			}
+		}
+		return true;
+	}
+
 	void ShaderGraph::GenerateShaderGraphSource(ShaderNodeGraph& graph)
 	{
-		LoadBaseShaderInputs(GetBaseShaderPath());
-		m_Flags = ShaderGraphFlags::None;
+		Ref<ShaderGraphTemplate> baseShader = ShaderGraphTemplate::Load(GetBaseShaderPath());
+		m_BaseShaderInputs = baseShader->Inputs;
+		// $DEFERRED is replaced with a comment, but marks the generated Source
+		m_Flags = baseShader->IsDeferred ? ShaderGraphFlags::Deferred : ShaderGraphFlags::None;
 
-		bool error = false;
 		VisualNode* master = nullptr;
 		bool isMasterNodeTemporary = false;
 		for (Ref<VisualNode> node : graph.m_Nodes)
@@ -283,9 +434,6 @@ void main(void)\n\
 			graph.TickAllVisualNodesInShaderGraphContext(this);
 		}
 
-		String src = Platform::ReadFromFile(GetBaseShaderPath());
-		StringUtil::RemoveCommentsFromString(src);
-
 		// Uniforms
 		Array<UniformSlot> oldSlots = m_UniformSlots;
 		m_UniformSlots.Clear();
@@ -333,40 +481,43 @@ void main(void)\n\
 			}
 		}
 
-		// Proccess BaseShader
-		while (src.find("$VERT_INPUTS") != String::npos) StringUtil::ReplaceSequence(src, "$VERT_INPUTS", "" + uniforms);
-		while (src.find("$FRAG_INPUTS") != String::npos) StringUtil::ReplaceSequence(src, "$FRAG_INPUTS", "" + uniforms);
-
-		while (src.find("$DEFERRED") != String::npos)
+		// Hash everything the Source depends on
+		std::unordered_map<const VisualNodePin*, uint64_t> subgraphHashes;
+		uint64_t sourceHash = DerivedDataCache::HashBytes(&baseShader->Hash, sizeof(baseShader->Hash));
+		sourceHash = DerivedDataCache::HashBytes(uniforms.data(), uniforms.size(), sourceHash);
+		for (const ShaderGraphTemplate::Token& token : baseShader->Tokens)
 		{
-			// This removes the $Symbol, but marks the generated Source with a comment
-			StringUtil::ReplaceSequence(src, "$DEFERRED", "/* DEFERRED */");
-			m_Flags = m_Flags | ShaderGraphFlags::Deferred;
-		}
+			if (token.Type != ShaderGraphTemplate::TokenType::VertexInput && token.Type != ShaderGraphTemplate::TokenType::FragmentInput) continue;
 
-		int64_t begin = 0;
-		while (true)
-		{
-			begin = src.find("$VERT_INPUT", begin);
-			if (begin == String::npos) break;
-			GenerateShaderInput(src, begin, master, true, error);
-		}
-		begin = 0;
-		while (true)
-		{
-			begin = src.find("$FRAG_INPUT", begin);
-			if (begin == String::npos) break;
-			GenerateShaderInput(src, begin, master, false, error);
+			const bool vertex = token.Type == ShaderGraphTemplate::TokenType::VertexInput;
+			VisualNodePin* pin = nullptr;
+			const BaseShaderInput* input = nullptr;
+			FindShaderInput(token.Text, master, vertex, pin, input);
+
+			uint64_t inputHash = 0;
+			if (pin && pin->Target)
+			{
+				inputHash = ShaderGraphCompiler::HashSubgraph(*pin->Target, vertex, subgraphHashes);
+			}
+			else if (input)
+			{
+				inputHash = DerivedDataCache::HashBytes(input->m_DefaultSource.data(), input->m_DefaultSource.size());
+			}
+			sourceHash = DerivedDataCache::HashBytes(&inputHash, sizeof(inputHash), sourceHash);
 		}
 
-		if (!error)
+		if (sourceHash != m_ShaderSourceHash || m_ShaderSource.empty())
 		{
+			String src;
+			if (!GenerateSource(*baseShader, master, uniforms, src))
+			{
+				SuoraError("ShaderGraph compilation failed!");
+				return;
+			}
+
 			m_ShaderSource = src;
-		}
-		else
-		{
-			SuoraError("ShaderGraph compilation failed!");
-			return;
+			m_ShaderSourceHash = sourceHash;
+			UpdatePermutations();
 		}
 
 		// Remove Master-node, if it was just temporary
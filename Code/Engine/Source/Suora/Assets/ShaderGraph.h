@@ -1,14 +1,19 @@
 #pragma once
 #include "Material.h"
+#include "Suora/Renderer/ShaderPermutation.h"
 #include <vector>
 #include <string>
 #include <chrono>
+#include <filesystem>
+#include <mutex>
+#include <unordered_map>
 #include "ShaderGraph.generated.h"
 
 namespace Suora
 {
 	class Shader;
 	struct VisualNode;
+	struct VisualNodePin;
 	struct ShaderNodeGraph;
 
 	enum class ShaderGraphFlags : uint32_t
@@ -29,6 +34,54 @@ namespace Suora
 		bool m_InVertexShader = false;
 	};
 
+	/** A BaseShader, split into literal source and its $-placeholders. Every file is parsed once and cached until it
+	 *  changes on disk, so regenerating a ShaderGraph only has to concatenate the Tokens. */
+	struct ShaderGraphTemplate
+	{
+		enum class TokenType : uint8_t
+		{
+			Source = 0,
+			VertexInputs,
+			FragmentInputs,
+			Deferred,
+			VertexInput,
+			FragmentInput,
+			/** In front of the statement of the following inputs, the temporaries they share are declared here */
+			Temporaries
+		};
+		struct Token
+		{
+			TokenType Type = TokenType::Source;
+			/** The source, or the label of an input */
+			String Text;
+			/** Innermost block ('{') around the token, -1 at global scope */
+			int32_t Block = -1;
+			/** Inputs only: index of the Temporaries token in front of their statement, -1 if they have none */
+			int32_t Temporaries = -1;
+		};
+
+		Array<Token> Tokens;
+		/** Parent of every block in source order, -1 for blocks at global scope */
+		Array<int32_t> BlockParents;
+		/** Vertex inputs first, in source order */
+		Array<BaseShaderInput> Inputs;
+		bool IsDeferred = false;
+		/** Hash of the unprocessed file */
+		uint64_t Hash = 0;
+
+		static Ref<ShaderGraphTemplate> Parse(const String& source);
+		static Ref<ShaderGraphTemplate> Load(const String& path);
+
+	private:
+		struct CacheEntry
+		{
+			std::filesystem::file_time_type WriteTime;
+			Ref<ShaderGraphTemplate> Template;
+		};
+		inline static std::mutex s_CacheMutex;
+		inline static std::unordered_map<String, CacheEntry> s_Cache;
+	};
+
 	class ShaderGraph : public Material
 	{
 		SUORA_CLASS(564364364);
@@ -50,14 +103,27 @@ namespace Suora
 		virtual bool IsDeferred() const override;
 		inline bool IsFlagSet(ShaderGraphFlags flag) const;
 
+	private:
+		Shader* GetPermutationShader(MaterialType type, Ref<Shader>& shader);
+	public:
+
 		Array<BaseShaderInput> m_BaseShaderInputs;
-		void LoadBaseShaderInput(BaseShaderInput& input, int64_t& begin, int64_t& end, const String& str);
+		static void LoadBaseShaderInput(BaseShaderInput& input, int64_t& begin, int64_t& end, const String& str);
 		void LoadBaseShaderInputs(const String& path);
-		void GenerateShaderInput(String& str, int64_t begin, VisualNode* master, bool vertex, bool& error);
+		/** Returns the master pin and BaseShaderInput of a $VERT_INPUT/$FRAG_INPUT placeholder, pin is nullptr if the input is left empty */
+		void FindShaderInput(const String& label, VisualNode* master, bool vertex, VisualNodePin*& pin, const BaseShaderInput*& input);
+		static void FindShaderInput(const Array<BaseShaderInput>& inputs, const String& label, VisualNode* master, bool vertex, VisualNodePin*& pin, const BaseShaderInput*& input);
+		/** Fills the placeholders of the BaseShader with the uniforms and the inputs of the master Node, returns false if a Node failed to compile */
+		static bool GenerateSource(const ShaderGraphTemplate& baseShader, VisualNode* master, const String& uniforms, String& source);
+		/** Regenerates m_ShaderSource, nothing is done if neither the graph nor the BaseShader changed since the last call */
 		void GenerateShaderGraphSource(ShaderNodeGraph& graph);
+		/** Enumerates the ShaderPermutations of m_ShaderSource and queues them for background compilation */
+		void UpdatePermutations();
 
 		String m_BaseShader;
 		String m_ShaderSource;
+		uint64_t m_ShaderSourceHash = 0;
+		Array<ShaderPermutation> m_Permutations;
 		Ref<Shader> m_Shader, m_DepthShader, m_FlatWhiteShader, m_IDShader;
 		ShaderGraphFlags m_Flags = ShaderGraphFlags::None;
 	};
@@ -1,8 +1,16 @@
 #include "Precompiled.h"
 #include "StreamableAsset.h"
+#include "AssetResidencyManager.h"
+#include "VirtualFileSystem.h"
+#include "AssetManager.h"
 
 namespace Suora
 {
+	StreamableAsset::~StreamableAsset()
+	{
+		AssetResidencyManager::NotifyReleased(this);
+	}
+
 	std::filesystem::path StreamableAsset::GetSourceAssetPath() const
 	{
 		std::filesystem::path p = m_Path;
@@ -11,7 +19,31 @@ namespace Suora
 
 	bool StreamableAsset::IsSourceAssetPathValid() const
 	{
-		return std::filesystem::exists(GetSourceAssetPath());
+		const std::filesystem::path path = GetSourceAssetPath();
+		return VirtualFileSystem::Exists(path) || std::filesystem::exists(path);
+	}
+
+	uint64_t StreamableAsset::GetExpectedCPUMemory() const
+	{
+		return m_LastResidentCPUMemory ? m_LastResidentCPUMemory : GetSourceAssetFileSize();
+	}
+
+	uint64_t StreamableAsset::GetExpectedGPUMemory() const
+	{
+		return m_LastResidentGPUMemory ? m_LastResidentGPUMemory : GetSourceAssetFileSize();
+	}
+
+	uint64_t StreamableAsset::GetSourceAssetFileSize() const
+	{
+		const std::filesystem::path path = GetSourceAssetPath();
+		uint64_t size = 0, hash = 0;
+		if (VirtualFileSystem::GetFileInfo(path, size, hash))
+		{
+			return size;
+		}
+		std::error_code error;
+		size = std::filesystem::file_size(path, error);
+		return error ? 0 : size;
 	}
 
 	void StreamableAsset::PreInitializeAsset(Yaml::Node& root)
@@ -21,9 +53,12 @@ namespace Suora
 		Yaml::Node& streamable = root["StreamableAsset"];
 
 		m_SourceAssetName = streamable["m_SourceAssetName"].As<String>();
+		AssetManager::s_AssetsByPathDirty = true;
 		m_StreamMode = (AssetStreamMode)std::stoi(streamable["m_StreamMode"].As<String>());
 
-		m_LastWriteTimeOfSource = std::filesystem::last_write_time(GetSourceAssetPath());
+		// Packaged Sources have no write time, the error leaves it at the minimum
+		std::error_code error;
+		m_LastWriteTimeOfSource = std::filesystem::last_write_time(GetSourceAssetPath(), error);
 	}
 	void StreamableAsset::InitializeAsset(Yaml::Node& root)
 	{
@@ -47,19 +82,22 @@ namespace Suora
 			return true;
 		}
 
-		return m_LastWriteTimeOfSource != std::filesystem::last_write_time(GetSourceAssetPath());
+		std::error_code error;
+		return m_LastWriteTimeOfSource != std::filesystem::last_write_time(GetSourceAssetPath(), error);
 	}
 
 	void StreamableAsset::ReloadAsset()
 	{
 		Super::ReloadAsset();
 
-		m_LastWriteTimeOfSource = std::filesystem::last_write_time(GetSourceAssetPath());
+		std::error_code error;
+		m_LastWriteTimeOfSource = std::filesystem::last_write_time(GetSourceAssetPath(), error);
 	}
 
 	void StreamableAsset::SetSourceAssetName(const String& name)
 	{
 		m_SourceAssetName = name;
+		AssetManager::s_AssetsByPathDirty = true;
 	}
 	String StreamableAsset::GetSourceAssetName() const
 	{
@@ -15,8 +15,12 @@ namespace Suora
 	{
 		SUORA_CLASS(175815436);
 	public:
+		~StreamableAsset();
+
 		std::filesystem::path GetSourceAssetPath() const;
+		/** Sources can be files on disk or in a mounted package, see VirtualFileSystem */
 		bool IsSourceAssetPathValid() const;
+		uint64_t GetSourceAssetFileSize() const;
 
 		void PreInitializeAsset(Yaml::Node& root) override;
 		void InitializeAsset(Yaml::Node& root) override;
@@ -30,10 +34,33 @@ namespace Suora
 		void SetAssetStreamMode(AssetStreamMode streamMode);
 		AssetStreamMode GetAssetStreamMode() const;
 
+		/** Residency, see AssetResidencyManager */
+		virtual bool IsStreamedIn() const { return IsLoaded(); }
+		virtual bool IsStreamingInProgress() const { return false; }
+		virtual uint64_t GetResidentCPUMemory() const { return 0; }
+		virtual uint64_t GetResidentGPUMemory() const { return 0; }
+		/** Estimated memory once streamed in; the last resident size, if the Asset was resident before */
+		virtual uint64_t GetExpectedCPUMemory() const;
+		virtual uint64_t GetExpectedGPUMemory() const;
+		virtual bool CanStreamOut() const { return false; }
+		virtual void StreamIn() { }
+		virtual void StreamOut() { }
+		uint64_t GetLastUsedFrame() const { return m_LastUsedFrame; }
+		float GetStreamingPriority() const { return m_StreamingPriority; }
+
 	private:
 		String m_SourceAssetName;
 		AssetStreamMode m_StreamMode = AssetStreamMode::AlwaysLoaded;
 		std::filesystem::file_time_type m_LastWriteTimeOfSource;
+
+		uint64_t m_LastUsedFrame = 0;
+		uint64_t m_LastResidentCPUMemory = 0;
+		uint64_t m_LastResidentGPUMemory = 0;
+		float m_StreamingPriority = 0.0f;
+		bool m_IsResidencyTracked = false;
+		bool m_IsPrefetchQueued = false;
+
+		friend class AssetResidencyManager;
 	};
 
 }
\ No newline at end of file
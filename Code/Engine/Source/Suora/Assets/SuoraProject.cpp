@@ -5,6 +5,7 @@
 #include "Suora/Assets/Level.h"
 #include "Suora/Assets/AssetManager.h"
 #include "Suora/Assets/Texture2D.h"
+#include "Suora/Assets/AssetResidencyManager.h"
 #include "Suora/Renderer/RenderPipeline.h"
 
 namespace Suora
@@ -49,6 +50,17 @@ namespace Suora
 		m_DefaultLevel = settings["Game"]["m_DefaultLevel"].IsNone() ? nullptr : AssetManager::GetAsset<Level>(SuoraID(settings["Game"]["m_DefaultLevel"].As<String>()));
 
 		m_ProjectIconTexture = settings["Game"]["m_ProjectIconTexture"].As<String>() != "NULL" ? AssetManager::GetAsset<Texture2D>(SuoraID(settings["Game"]["m_ProjectIconTexture"].As<String>())) : nullptr;
+
+		m_StreamingCPUBudgetMB = settings["Streaming"]["m_StreamingCPUBudgetMB"].IsNone() ? 0.0f : std::stof(settings["Streaming"]["m_StreamingCPUBudgetMB"].As<String>());
+		m_StreamingGPUBudgetMB = settings["Streaming"]["m_StreamingGPUBudgetMB"].IsNone() ? 0.0f : std::stof(settings["Streaming"]["m_StreamingGPUBudgetMB"].As<String>());
+		ApplyStreamingBudget();
+
+		for (uint32_t i = 0; i < Physics::CollisionMatrix::s_LayerCount; i++)
+		{
+			Yaml::Node& mask = settings["Physics"]["m_CollisionMatrix"]["Layer" + std::to_string(i)];
+			m_CollisionMatrix[i] = mask.IsNone() ? Physics::CollisionMatrix::s_AllLayers : (uint32_t)std::stoul(mask.As<String>());
+		}
+		ApplyCollisionMatrix();
 	}
 
 	void ProjectSettings::Serialize(Yaml::Node& root)
@@ -71,6 +83,27 @@ namespace Suora
 		settings["Game"]["m_DefaultLevel"] = m_DefaultLevel ? m_DefaultLevel->m_UUID.GetString() : "0";
 
 		settings["Game"]["m_ProjectIconTexture"] = m_ProjectIconTexture ? m_ProjectIconTexture->m_UUID.GetString() : "NULL";
+
+		settings["Streaming"]["m_StreamingCPUBudgetMB"] = std::to_string(m_StreamingCPUBudgetMB);
+		settings["Streaming"]["m_StreamingGPUBudgetMB"] = std::to_string(m_StreamingGPUBudgetMB);
+
+		for (uint32_t i = 0; i < Physics::CollisionMatrix::s_LayerCount; i++)
+		{
+			settings["Physics"]["m_CollisionMatrix"]["Layer" + std::to_string(i)] = std::to_string(m_CollisionMatrix[i]);
+		}
+	}
+
+	void ProjectSettings::ApplyStreamingBudget()
+	{
+		const uint64_t cpuBytes = (uint64_t)(glm::max(m_StreamingCPUBudgetMB, 0.0f) * 1024.0f * 1024.0f);
+		const uint64_t gpuBytes = (uint64_t)(glm::max(m_StreamingGPUBudgetMB, 0.0f) * 1024.0f * 1024.0f);
+		AssetResidencyManager::SetMemoryBudget(cpuBytes, gpuBytes);
+	}
+
+	void ProjectSettings::ApplyCollisionMatrix()
+	{
+		Physics::CollisionMatrix::SetMasks(m_CollisionMatrix);
+		m_CollisionMatrix = Physics::CollisionMatrix::GetMasks();
 	}
 
 	String ProjectSettings::GetEnginePath() const
@@ -1,5 +1,7 @@
 #pragma once
+#include <array>
 #include "Asset.h"
+#include "Suora/Physics/CollisionMatrix.h"
 #include "SuoraProject.generated.h"
 
 namespace Suora
@@ -27,11 +29,23 @@ namespace Suora
 		static ProjectSettings* Get();
 		static String GetProjectName();
 
+		/** Forwards the Streaming Budget to the AssetResidencyManager */
+		void ApplyStreamingBudget();
+		/** Forwards the Collision Matrix to the physics backends */
+		void ApplyCollisionMatrix();
+
 		float m_TargetFramerate = 60.0f;
 		bool m_EnableDeferredRendering = true;
 		Level* m_DefaultLevel = nullptr;
 		Texture2D* m_ProjectIconTexture = nullptr;
 
+		// Budgets in MB, 0 means unlimited
+		float m_StreamingCPUBudgetMB = 0.0f;
+		float m_StreamingGPUBudgetMB = 0.0f;
+
+		/** Bit j of entry i is set, if physics layers i and j collide */
+		std::array<uint32_t, Physics::CollisionMatrix::s_LayerCount> m_CollisionMatrix = Physics::CollisionMatrix::GetMasks();
+
 		Asset* m_EditorStartupAsset = nullptr;
 		bool m_IsNativeProject = true;
 	private:
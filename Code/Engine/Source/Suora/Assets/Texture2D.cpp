@@ -1,25 +1,29 @@
 #include "Precompiled.h"
 #include "Texture2D.h"
 #include "Suora/Renderer/Texture.h"
-#include "Suora/Core/Threading.h"
+#include "Suora/Renderer/TexturePipeline.h"
+#include "Suora/Core/TaskScheduler.h"
+#include "Suora/Debug/Profiler.h"
 #include "Suora/Assets/AssetManager.h"
+#include "Suora/Assets/AssetResidencyManager.h"
+#include "Suora/Assets/DerivedDataCache.h"
 #include "Suora/Common/Common.h"
 
 namespace Suora
 {
+	// Has to be increased, whenever the cooked data changes (e.g. different flipping or encoders)
+	static constexpr uint32_t TextureImportVersion = 2;
 
 	Texture2D::Texture2D()
 	{
 		m_TextureFilter = ETextureFilter::Linear;
+		m_Compression = ETextureCompression::Auto;
 	}
 	Texture2D::~Texture2D()
 	{
-		if (m_AsyncTextureBuffer.get())
-		{
-			// TextureBuffer_stbi has to be destroyed here (!)
-			// We also wait for the async load task to finish
-			m_AsyncTextureBuffer->get();
-		}
+		// A load that is still running refers to this Texture; the continuation is dropped by cancelling
+		m_AsyncTextureBuffer.Cancel();
+		m_AsyncTextureBuffer.Wait();
 		if (m_Texture)
 		{
 			delete m_Texture;
@@ -35,6 +39,14 @@ namespace Suora
 	{
 		Super::PreInitializeAsset(root);
 
+		Yaml::Node& texture = root["Texture2D"];
+		if (!texture.IsNone())
+		{
+			m_Compression = (ETextureCompression)texture["m_Compression"].As<uint32_t>();
+			m_GenerateMips = texture["m_GenerateMips"].As<String>() != "false";
+			m_IsNormalMap = texture["m_IsNormalMap"].As<String>() == "true";
+			m_IsSRGB = texture["m_IsSRGB"].As<String>() != "false";
+		}
 	}
 
 	uint32_t Texture2D::GetAssetFileSize()
@@ -44,7 +56,7 @@ namespace Suora
 
 		if (IsSourceAssetPathValid())
 		{
-			textureSize = std::filesystem::file_size(GetSourceAssetPath());
+			textureSize = (uint32_t)GetSourceAssetFileSize();
 		}
 
 		return baseSize + textureSize;
@@ -54,12 +66,30 @@ namespace Suora
 	{
 		Super::Serialize(root);
 
+		Yaml::Node& texture = root["Texture2D"];
+		texture["m_Compression"] = std::to_string((uint32_t)m_Compression);
+		texture["m_GenerateMips"] = m_GenerateMips ? "true" : "false";
+		texture["m_IsNormalMap"] = m_IsNormalMap ? "true" : "false";
+		texture["m_IsSRGB"] = m_IsSRGB ? "true" : "false";
 	}
 
 	void Texture2D::ReloadAsset()
 	{
 		Super::ReloadAsset();
 
+		AssetResidencyManager::NotifyReleased(this);
+		if (m_AsyncTextureBuffer.IsValid())
+		{
+			// The pending result was cooked with the old source or settings
+			m_AsyncTextureBuffer.Cancel();
+			m_AsyncTextureBuffer.Wait();
+			m_AsyncTextureBuffer = Task<Ref<CookedTexture>>();
+			AssetManager::s_AssetStreamPool.Remove(this);
+		}
+		if (m_Texture)
+		{
+			delete m_Texture;
+		}
 		m_Texture = nullptr;
 	}
 
@@ -70,6 +100,8 @@ namespace Suora
 			return Texture::GetOrCreateDefaultTexture();
 		}
 
+		AssetResidencyManager::MarkUsed(this);
+
 		if (IsLoaded())
 		{
 			return m_Texture;
@@ -81,19 +113,15 @@ namespace Suora
 				return Texture::GetOrCreateDefaultTexture();
 			}
 
-			if (!m_AsyncTextureBuffer.get() && AssetManager::s_AssetStreamPool.Size() < AssetManager::GetAssetStreamCountLimit())
+			if (!m_AsyncTextureBuffer.IsValid() && AssetManager::s_AssetStreamPool.Size() < AssetManager::GetAssetStreamCountLimit())
 			{
 				AssetManager::s_AssetStreamPool.Add(this);
 
-				m_AsyncTextureBuffer = CreateRef<std::future<Ref<TextureBuffer_stbi>>>(std::async(std::launch::async, &Texture2D::Async_LoadTexture, this, GetSourceAssetPath().string()));
-			}
-			else if (m_AsyncTextureBuffer.get() && IsFutureReady(*m_AsyncTextureBuffer.get()))
-			{
-				AssetManager::s_AssetStreamPool.Remove(this);
-				Ref<TextureBuffer_stbi> buffer = m_AsyncTextureBuffer->get();
-				m_AsyncTextureBuffer = nullptr;
-				m_Texture = Texture::CreatePtr(*buffer.get());
-				m_Texture->SetFilter(m_TextureFilter);
+				// The upload happens in FinishAsyncLoad(), within the frame budget of the TaskScheduler
+				m_AsyncTextureBuffer = TaskScheduler::Run([this, path = GetSourceAssetPath().string(), settings = GetCookSettings()]()
+				{
+					return Async_LoadTexture(path, settings);
+				}, [this]() { FinishAsyncLoad(); }, TaskPriority::Normal, "Texture2D::Load");
 			}
 
 			return Texture::GetOrCreateDefaultTexture();
@@ -102,9 +130,106 @@ namespace Suora
 		return Texture::GetOrCreateDefaultTexture();
 	}
 
-	Ref<TextureBuffer_stbi> Texture2D::Async_LoadTexture(const String& path)
+	void Texture2D::FinishAsyncLoad()
+	{
+		SUORA_PROFILE_SCOPE("Texture2D::FinishAsyncLoad");
+		SUORA_PROFILE_COUNTER_ADD("Assets Streamed", 1);
+		AssetManager::s_AssetStreamPool.Remove(this);
+		Ref<CookedTexture> cooked = m_AsyncTextureBuffer.Get();
+		m_AsyncTextureBuffer = Task<Ref<CookedTexture>>();
+		if (!cooked)
+		{
+			SuoraError("Failed to load Texture2D {0}", GetSourceAssetPath().string());
+			SetFlag(AssetFlags::Missing);
+			return;
+		}
+		m_Texture = Texture::CreatePtr(*cooked.get());
+		m_Texture->SetFilter(m_TextureFilter);
+		AssetResidencyManager::NotifyResident(this);
+	}
+
+	bool Texture2D::IsStreamingInProgress() const
+	{
+		return m_AsyncTextureBuffer.IsValid();
+	}
+
+	uint64_t Texture2D::GetResidentGPUMemory() const
+	{
+		return m_Texture ? m_Texture->GetMemorySize() : 0;
+	}
+
+	uint64_t Texture2D::GetExpectedCPUMemory() const
+	{
+		return GetExpectedGPUMemory();
+	}
+
+	bool Texture2D::CanStreamOut() const
+	{
+		return this != Default;
+	}
+
+	void Texture2D::StreamIn()
+	{
+		GetTexture();
+	}
+
+	void Texture2D::StreamOut()
 	{
-		return CreateRef<TextureBuffer_stbi>(path);
+		if (!CanStreamOut() || IsStreamingInProgress() || !m_Texture)
+		{
+			return;
+		}
+
+		delete m_Texture;
+		m_Texture = nullptr;
+	}
+
+	TextureCookSettings Texture2D::GetCookSettings() const
+	{
+		TextureCookSettings settings;
+		settings.Compression = m_Compression;
+		settings.GenerateMips = m_GenerateMips;
+		settings.IsNormalMap = m_IsNormalMap;
+		settings.IsSRGB = m_IsSRGB && !m_IsNormalMap;
+		return settings;
+	}
+
+	String Texture2D::MakeDerivedDataKey(const String& path, const TextureCookSettings& settings)
+	{
+		return DerivedDataCache::MakeKey(path, TextureImportVersion, "FlipVertically=1;" + settings.ToString());
+	}
+
+	Ref<CookedTexture> Texture2D::Async_LoadTexture(const String& path, const TextureCookSettings& settings)
+	{
+		const String cacheKey = MakeDerivedDataKey(path, settings);
+		if (Ref<CookedTexture> cached = DerivedDataCache::LoadTexture(cacheKey))
+		{
+			return cached;
+		}
+
+		Ref<CookedTexture> cooked;
+		{
+			TextureBuffer_stbi buffer(path);
+			TextureCookStats stats;
+			cooked = TexturePipeline::Cook(buffer, settings, &stats);
+			if (!cooked)
+			{
+				return nullptr;
+			}
+			if (stats.PSNR > 0.0f)
+			{
+				SUORA_LOG(LogCategory::AssetManagement, LogLevel::Info, "Cooked {0} ({1}x{2}, {3} Mips): {4} KB -> {5} KB, {6} dB PSNR, {7} MPix/s",
+					path, buffer.m_Width, buffer.m_Height, stats.MipCount, stats.SourceSize / 1024, stats.CookedSize / 1024, stats.PSNR, stats.MegapixelsPerSecond);
+			}
+			else
+			{
+				SUORA_LOG(LogCategory::AssetManagement, LogLevel::Info, "Cooked {0} ({1}x{2}, {3} Mips): {4} KB -> {5} KB, {6} MPix/s",
+					path, buffer.m_Width, buffer.m_Height, stats.MipCount, stats.SourceSize / 1024, stats.CookedSize / 1024, stats.MegapixelsPerSecond);
+			}
+		}
+
+		DerivedDataCache::StoreTexture(cacheKey, *cooked.get());
+		return cooked;
 	}
 
 }
\ No newline at end of file
@@ -2,13 +2,15 @@
 #include "StreamableAsset.h"
 #include <vector>
 #include <string>
-#include <future>
+#include "Suora/Core/TaskScheduler.h"
 #include "Texture2D.generated.h"
 
 namespace Suora
 {
 	enum class ETextureFilter : uint32_t;
-	struct TextureBuffer_stbi;
+	enum class ETextureCompression : uint32_t;
+	struct CookedTexture;
+	struct TextureCookSettings;
 	class Texture;
 
 	class Texture2D : public StreamableAsset
@@ -35,13 +37,34 @@ namespace Suora
 		}
 
 		Texture* GetTexture();
-		Ref<TextureBuffer_stbi> Async_LoadTexture(const String& path);
 
-		Ref<std::future<Ref<TextureBuffer_stbi>>> m_AsyncTextureBuffer;
+		virtual bool IsStreamingInProgress() const override;
+		virtual uint64_t GetResidentGPUMemory() const override;
+		/** No CPU copy is kept after the upload, so the cooked data only counts against the CPU Budget while it streams in */
+		virtual uint64_t GetExpectedCPUMemory() const override;
+		virtual bool CanStreamOut() const override;
+		virtual void StreamIn() override;
+		virtual void StreamOut() override;
+
+		TextureCookSettings GetCookSettings() const;
+		/** Decodes the source image and cooks it, unless the DerivedDataCache already holds the result */
+		Ref<CookedTexture> Async_LoadTexture(const String& path, const TextureCookSettings& settings);
+		static String MakeDerivedDataKey(const String& path, const TextureCookSettings& settings);
+
+		Task<Ref<CookedTexture>> m_AsyncTextureBuffer;
 
 		ETextureFilter m_TextureFilter;
 
+		// Cook Settings
+		ETextureCompression m_Compression;
+		bool m_GenerateMips = true;
+		bool m_IsNormalMap = false;
+		bool m_IsSRGB = true;
+
 	private:
+		/** Main thread continuation of the load, uploads the cooked Texture */
+		void FinishAsyncLoad();
+
 		Texture* m_Texture = nullptr;
 		inline static Texture2D* Default = nullptr;
 	};
@@ -0,0 +1,193 @@
+#include "Precompiled.h"
+#include "VirtualFileSystem.h"
+#include "PackageArchive.h"
+#include <algorithm>
+#include <unordered_set>
+
+namespace Suora
+{
+
+	bool VirtualFileSystem::Mount(const Path& archivePath, const Path& mountPoint)
+	{
+		Ref<PackageArchive> archive = PackageArchive::Open(archivePath);
+		if (!archive)
+		{
+			return false;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(s_Mutex);
+			s_Archives.push_back(MountedArchive{ archive, mountPoint });
+			RebuildFileTable();
+		}
+		SUORA_LOG(LogCategory::AssetManagement, LogLevel::Info, "Mounted '{0}' ({1} files) at '{2}'", archivePath.string(), archive->GetEntries().size(), mountPoint.string());
+		return true;
+	}
+
+	void VirtualFileSystem::Unmount(const Path& archivePath)
+	{
+		std::lock_guard<std::mutex> lock(s_Mutex);
+		const String key = MakeKey(archivePath);
+		s_Archives.erase(std::remove_if(s_Archives.begin(), s_Archives.end(), [&key](const MountedArchive& mounted) { return MakeKey(mounted.Archive->GetPath()) == key; }), s_Archives.end());
+		RebuildFileTable();
+	}
+
+	void VirtualFileSystem::UnmountAll()
+	{
+		std::lock_guard<std::mutex> lock(s_Mutex);
+		s_Archives.clear();
+		s_Files.clear();
+	}
+
+	bool VirtualFileSystem::IsAnythingMounted()
+	{
+		std::lock_guard<std::mutex> lock(s_Mutex);
+		return !s_Archives.empty();
+	}
+
+	bool VirtualFileSystem::Exists(const Path& path)
+	{
+		MountedFile file;
+		return FindFile(path, file);
+	}
+
+	bool VirtualFileSystem::HasContent(const Path& path)
+	{
+		MountedFile file;
+		return FindFile(path, file) && !(file.Archive->GetEntries()[file.Entry].Flags & PackageEntryFlags::HashOnly);
+	}
+
+	bool VirtualFileSystem::ReadFile(const Path& path, std::vector<uint8_t>& data)
+	{
+		MountedFile file;
+		if (!FindFile(path, file))
+		{
+			return false;
+		}
+		// Reading happens outside of s_Mutex, the archive only locks its own file
+		return file.Archive->Read(file.Archive->GetEntries()[file.Entry], data);
+	}
+
+	bool VirtualFileSystem::ReadFile(const Path& path, String& text)
+	{
+		std::vector<uint8_t> data;
+		if (!ReadFile(path, data))
+		{
+			return false;
+		}
+		text.assign((const char*)data.data(), data.size());
+		return true;
+	}
+
+	bool VirtualFileSystem::ReadFileInMounts(const String& relativePath, std::vector<uint8_t>& data)
+	{
+		std::vector<Path> candidates;
+		{
+			std::lock_guard<std::mutex> lock(s_Mutex);
+			for (auto It = s_Archives.rbegin(); It != s_Archives.rend(); It++)
+			{
+				candidates.push_back(It->MountPoint / relativePath);
+			}
+		}
+		for (const Path& candidate : candidates)
+		{
+			if (ReadFile(candidate, data)) return true;
+		}
+		return false;
+	}
+
+	bool VirtualFileSystem::HasContentInMounts(const String& relativePath)
+	{
+		std::vector<Path> candidates;
+		{
+			std::lock_guard<std::mutex> lock(s_Mutex);
+			for (const MountedArchive& mounted : s_Archives)
+			{
+				candidates.push_back(mounted.MountPoint / relativePath);
+			}
+		}
+		for (const Path& candidate : candidates)
+		{
+			if (HasContent(candidate)) return true;
+		}
+		return false;
+	}
+
+	bool VirtualFileSystem::GetFileInfo(const Path& path, uint64_t& size, uint64_t& hash, uint32_t* flags)
+	{
+		MountedFile file;
+		if (!FindFile(path, file))
+		{
+			return false;
+		}
+		const PackageEntry& entry = file.Archive->GetEntries()[file.Entry];
+		size = entry.RawSize;
+		hash = entry.Hash;
+		if (flags) *flags = entry.Flags;
+		return true;
+	}
+
+	std::vector<Path> VirtualFileSystem::ListFiles(const Path& directory)
+	{
+		std::vector<Path> files;
+		std::unordered_set<String> listed;
+		String prefix = MakeKey(directory);
+		if (!prefix.empty() && prefix.back() != '/') prefix += '/';
+
+		std::lock_guard<std::mutex> lock(s_Mutex);
+		for (const MountedArchive& mounted : s_Archives)
+		{
+			for (const PackageEntry& entry : mounted.Archive->GetEntries())
+			{
+				const Path path = (mounted.MountPoint / entry.Path).lexically_normal();
+				const String key = MakeKey(path);
+				if (key.rfind(prefix, 0) == 0 && listed.insert(key).second)
+				{
+					files.push_back(path);
+				}
+			}
+		}
+		return files;
+	}
+
+	String VirtualFileSystem::MakeKey(const Path& path)
+	{
+		std::error_code error;
+		const Path absolute = std::filesystem::absolute(path, error);
+		String key = PackageArchive::NormalizePath(error ? path : absolute);
+#ifdef SUORA_PLATFORM_WINDOWS
+		std::transform(key.begin(), key.end(), key.begin(), [](char c) { return (char)::tolower(c); });
+#endif
+		return key;
+	}
+
+	bool VirtualFileSystem::FindFile(const Path& path, MountedFile& file)
+	{
+		std::lock_guard<std::mutex> lock(s_Mutex);
+		if (s_Files.empty())
+		{
+			return false;
+		}
+		auto It = s_Files.find(MakeKey(path));
+		if (It == s_Files.end())
+		{
+			return false;
+		}
+		file = It->second;
+		return true;
+	}
+
+	void VirtualFileSystem::RebuildFileTable()
+	{
+		s_Files.clear();
+		for (const MountedArchive& mounted : s_Archives)
+		{
+			const std::vector<PackageEntry>& entries = mounted.Archive->GetEntries();
+			for (size_t i = 0; i < entries.size(); i++)
+			{
+				s_Files[MakeKey(mounted.MountPoint / entries[i].Path)] = MountedFile{ mounted.Archive, i };
+			}
+		}
+	}
+
+}
@@ -0,0 +1,62 @@
+#pragma once
+#include <stdint.h>
+#include <vector>
+#include <mutex>
+#include <unordered_map>
+#include "Suora/Common/Filesystem.h"
+
+namespace Suora
+{
+	class PackageArchive;
+
+	/* Makes the files of PackageArchives appear at a directory (the mount point), e.g. the cooked Content of an
+	 * exported project. Platform::ReadFromFile(), the AssetManager, the DerivedDataCache and the image and mesh
+	 * importers consult the mounted files before the disk. Archives mounted later take precedence.
+	 * All functions are thread-safe.                                                                          */
+	class VirtualFileSystem
+	{
+	public:
+		/** Packages of exported projects are placed in their Content directory under this name */
+		inline static const String s_ContentPackageName = "Content.pak";
+
+		static bool Mount(const Path& archivePath, const Path& mountPoint);
+		static void Unmount(const Path& archivePath);
+		static void UnmountAll();
+		static bool IsAnythingMounted();
+
+		/** True for all mounted files, including HashOnly entries that have no content */
+		static bool Exists(const Path& path);
+		static bool HasContent(const Path& path);
+		static bool ReadFile(const Path& path, std::vector<uint8_t>& data);
+		static bool ReadFile(const Path& path, String& text);
+		/** Looks for the path relative to each mount point */
+		static bool ReadFileInMounts(const String& relativePath, std::vector<uint8_t>& data);
+		static bool HasContentInMounts(const String& relativePath);
+		/** Size and hash (see DerivedDataCache::HashFile()) without reading the file, flags are PackageEntryFlags */
+		static bool GetFileInfo(const Path& path, uint64_t& size, uint64_t& hash, uint32_t* flags = nullptr);
+
+		/** All mounted files inside the directory and its subdirectories */
+		static std::vector<Path> ListFiles(const Path& directory);
+
+	private:
+		struct MountedArchive
+		{
+			Ref<PackageArchive> Archive;
+			Path MountPoint;
+		};
+		struct MountedFile
+		{
+			Ref<PackageArchive> Archive;
+			size_t Entry = 0;
+		};
+
+		static String MakeKey(const Path& path);
+		static bool FindFile(const Path& path, MountedFile& file);
+		static void RebuildFileTable();
+
+		inline static std::mutex s_Mutex;
+		inline static std::vector<MountedArchive> s_Archives;
+		inline static std::unordered_map<String, MountedFile> s_Files;
+	};
+
+}
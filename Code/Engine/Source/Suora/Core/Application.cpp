@@ -3,9 +3,12 @@
 
 #include "Suora/Core/Log.h"
 #include "Suora/Core/Engine.h"
+#include "Suora/Core/TaskScheduler.h"
+#include "Suora/Debug/Profiler.h"
 
 #include "Suora/Renderer/RendererAPI.h"
 #include "Suora/Renderer/GraphicsContext.h"
+#include "Suora/Renderer/ShaderCache.h"
 
 #include "Suora/Core/NativeInput.h"
 #include "Suora/Platform/Platform.h"
@@ -24,6 +27,8 @@ namespace Suora
 
 		PrintSuoraEngineAsciiArt();
 
+		TaskScheduler::Initialize();
+		Profiler::Initialize();
 		m_Engine = Engine::Create();
 
 		NativeInput::Init();
@@ -32,7 +37,9 @@ namespace Suora
 
 	Application::~Application()
 	{
-
+		Profiler::Shutdown();
+		TaskScheduler::Shutdown();
+		ShaderCache::Shutdown();
 	}
 
 	Window* Application::CreateAppWindow(const WindowProps& props)
@@ -44,6 +51,7 @@ namespace Suora
 		{
 			init = true;
 			RendererAPI::Create();
+			ShaderCache::Initialize(*(GraphicsContext*)window->GetGraphicsContext());
 		}
 
 		return window;
@@ -79,6 +87,8 @@ namespace Suora
 			m_Engine->Tick();
 
 			Update(m_Engine->GetDeltaTime());
+
+			SUORA_PROFILE_END_FRAME();
 		}
 	}
 
@@ -11,6 +11,11 @@
 	#define SUORA_ENABLE_ASSERTS
 #endif
 
+// Profiler zones are compiled out of shipping builds
+#ifndef SUORA_DIST
+	#define SUORA_ENABLE_PROFILER
+#endif
+
 #ifdef SUORA_RELEASE
 
 #endif
@@ -2,6 +2,7 @@
 #include "Engine.h"
 #include "Application.h"
 #include "NativeInput.h"
+#include "TaskScheduler.h"
 
 #include "Suora/Assets/AssetManager.h"
 #include "Suora/Assets/SuoraProject.h"
@@ -10,6 +11,8 @@
 #include "Suora/NodeScript/Scripting/ScriptVM.h"
 #include "Suora/Physics/PhysicsEngine.h"
 #include "Suora/NodeScript/External/ScriptEngine.h"
+#include "Suora/Debug/VirtualConsole.h"
+#include "Suora/Debug/Profiler.h"
 
 namespace Suora
 {
@@ -139,6 +142,8 @@ namespace Suora
 	}
 	void Engine::Update(float deltaTime)
 	{
+		SUORA_PROFILE_SCOPE("Engine::Update");
+
 		m_FramesThisSecond++;
 		m_FrameDeltaTimeAccumulator += deltaTime;
 		if (m_FrameDeltaTimeAccumulator >= 1.0f)
@@ -149,14 +154,22 @@ namespace Suora
 		}
 
 		NativeInput::Tick(deltaTime);
+		VirtualConsole::Tick();
 
-		for (const auto It : m_Subsystems)
 		{
-			It->Tick(deltaTime);
+			SUORA_PROFILE_SCOPE("EngineSubSystem::Tick");
+			for (const auto It : m_Subsystems)
+			{
+				It->Tick(deltaTime);
+			}
 		}
 		BlueprintScriptEngine::CleanUp();
 
 		AssetManager::Update(deltaTime);
+		{
+			SUORA_PROFILE_SCOPE("TaskScheduler::PumpMainThread");
+			TaskScheduler::PumpMainThread();
+		}
 
 		if (m_GameInstance)
 		{
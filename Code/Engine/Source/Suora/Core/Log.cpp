@@ -40,7 +40,7 @@ namespace Suora
 		{
 			for (const auto& msg : m_MessageBuffer)
 			{
-				VirtualConsole::PushMessage(*msg.get());
+				VirtualConsole::PushMessage(std::move(*msg.get()));
 			}
 
 			m_MessagesBuffered = 0;
@@ -139,6 +139,7 @@ namespace Suora
 		case LogCategory::Gameplay: return "[Gameplay]";
 		case LogCategory::Scripting: return "[Scripting]";
 		case LogCategory::Editor: return "[Editor]";
+		case LogCategory::Networking: return "[Networking]";
 		case LogCategory::None:
 		case LogCategory::COUNT:
 		default:
@@ -23,6 +23,7 @@ namespace Suora
 		Gameplay,
 		Scripting,
 		Editor,
+		Networking,
 		COUNT
 	};
 
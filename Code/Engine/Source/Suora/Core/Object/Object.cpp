@@ -3,6 +3,7 @@
 #include "Interface.h"
 #include "Suora/NodeScript/NodeScriptObject.h"
 #include "Suora/NodeScript/ScriptStack.h"
+#include "Suora/Reflection/PropertyObserver.h"
 
 
 namespace Suora
@@ -16,6 +17,7 @@ namespace Suora
 
 	Object::~Object()
 	{
+		PropertyObserver::Unobserve(this);
 		UnimplementAllInterfaces();
 		InternalPtr::Nullify(this);
 	}
@@ -75,6 +77,11 @@ namespace Suora
 		return nullptr;
 	}
 
+	void Object::NotifyPropertyChange(uint32_t propertyIndex)
+	{
+		PropertyObserver::MarkDirty(this, propertyIndex);
+	}
+
 	bool Object::IsA(const Class& cls) const
 	{
 		return CastImpl(cls);
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <inttypes.h>
+#include <concepts>
+#include <utility>
 #include <vector>
 
 #include "Suora/Core/Object/NativeFunctionManager.h"
@@ -14,6 +16,7 @@ namespace Suora
 {
 	struct ScriptStack;
 	class INodeScriptObject;
+	struct PropertyObservation;
 
     template <class To, class From> static To* Cast(From* Src);
 
@@ -22,6 +25,7 @@ namespace Suora
 	{
 	private:
 		std::vector<Ref<Object>> m_Interfaces;
+		PropertyObservation* m_PropertyObservation = nullptr;
 	public:
 		Object();
 		virtual ~Object();
@@ -29,6 +33,32 @@ namespace Suora
 		static Class StaticClass() { return Class(1); }
 		virtual Class GetNativeClass() { return Class(1); }
 		Class GetClass();
+
+		/** Generated for every SUORA_CLASS, continuing the indices of its Super */
+		struct PropertyIndex
+		{
+			enum : uint32_t
+			{
+				PropertyCount = 0
+			};
+		};
+
+		/** Reports a change of a reflected property to the PropertyObserver. Only tests a pointer, if the Object is not observed */
+		void MarkPropertyDirty(uint32_t propertyIndex)
+		{
+			if (m_PropertyObservation) NotifyPropertyChange(propertyIndex);
+		}
+		/** Assigns a reflected property, e.g. SetProperty(m_Mesh, mesh, PropertyIndex::m_Mesh). Observed Objects ignore writes of an equal value */
+		template<class T, class U>
+		void SetProperty(T& member, U&& value, uint32_t propertyIndex)
+		{
+			if constexpr (std::equality_comparable_with<const T&, const U&>)
+			{
+				if (m_PropertyObservation && member == value) return;
+			}
+			member = std::forward<U>(value);
+			MarkPropertyDirty(propertyIndex);
+		}
 		
 		virtual bool CastImpl(const Class& cls) const
 		{
@@ -77,6 +107,10 @@ namespace Suora
 		void __NodeEventDispatch(size_t hash, ScriptStack& stack);
 		void __NodeEventDispatch(size_t hash);
 
+	private:
+		void NotifyPropertyChange(uint32_t propertyIndex);
+
+		friend class PropertyObserver;
 	};
 }
 
@@ -5,6 +5,7 @@ namespace Suora
 {
 	void InternalPtr::Nullify(Object* obj)
 	{
+		std::lock_guard<std::recursive_mutex> lock(s_Mutex);
 		const Array<InternalPtr*>& pointers = s_PtrTable[obj];
 		for (InternalPtr* ptr : pointers)
 		{
@@ -26,6 +27,7 @@ namespace Suora
 			return;
 		}
 
+		std::lock_guard<std::recursive_mutex> lock(s_Mutex);
 		if (InternalPtr::s_PtrTable[m_Value].Contains(this))
 		{
 			InternalPtr::s_PtrTable[m_Value].Remove(this);
@@ -44,6 +46,7 @@ namespace Suora
 			// No change needed...
 			return;
 		}
+		std::lock_guard<std::recursive_mutex> lock(s_Mutex);
 
 		if (m_Value)
 		{
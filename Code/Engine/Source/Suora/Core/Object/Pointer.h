@@ -3,6 +3,7 @@
 #include "Suora/Common/Array.h"
 #include <unordered_map>
 #include <memory>
+#include <mutex>
 
 namespace Suora
 {
@@ -25,6 +26,8 @@ namespace Suora
 	private:
 		inline static std::unordered_map<Object*, Array<InternalPtr*>> s_PtrTable;
 		inline static std::unordered_map<Object*, uint32_t> s_RefCounts;
+		/** Objects may be created on loader threads, recursive since releasing the last reference deletes an Object */
+		inline static std::recursive_mutex s_Mutex;
 
 		Object* m_Value = nullptr;
 		bool m_RefCounting;
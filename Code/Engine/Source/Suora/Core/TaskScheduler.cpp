@@ -0,0 +1,433 @@
+#include "Precompiled.h"
+#include "Suora/Core/TaskScheduler.h"
+
+#include <algorithm>
+
+namespace Suora
+{
+
+	void TaskScheduler::Initialize(uint32_t workerCount)
+	{
+		s_MainThreadID = std::this_thread::get_id();
+		StartWorkers(workerCount);
+	}
+
+	void TaskScheduler::StartWorkers(uint32_t workerCount)
+	{
+		std::lock_guard<std::mutex> lock(s_Mutex);
+		if (s_Running)
+		{
+			return;
+		}
+
+		if (workerCount == 0)
+		{
+			const uint32_t cores = std::thread::hardware_concurrency();
+			workerCount = cores > 1 ? cores - 1 : 1;
+		}
+
+		s_Running = true;
+		s_IsShutDown = false;
+		for (uint32_t i = 0; i < workerCount; i++)
+		{
+			s_Workers.emplace_back(&TaskScheduler::WorkerThread, (int32_t)i);
+		}
+	}
+
+	void TaskScheduler::Shutdown()
+	{
+		{
+			std::lock_guard<std::mutex> lock(s_Mutex);
+			s_Running = false;
+			s_IsShutDown = true;
+		}
+		s_QueueCondition.notify_all();
+
+		for (std::thread& worker : s_Workers)
+		{
+			if (worker.joinable())
+			{
+				worker.join();
+			}
+		}
+		s_Workers.clear();
+
+		std::deque<Ref<TaskState>> remaining;
+		{
+			std::lock_guard<std::mutex> lock(s_Mutex);
+			for (std::deque<Ref<TaskState>>& queue : s_Queues)
+			{
+				remaining.insert(remaining.end(), queue.begin(), queue.end());
+				queue.clear();
+			}
+			s_QueuedTasks = 0;
+		}
+		{
+			std::lock_guard<std::mutex> lock(s_MainThreadMutex);
+			for (std::deque<MainThreadJob>& queue : s_MainThreadQueues)
+			{
+				for (const MainThreadJob& job : queue)
+				{
+					if (!job.IsContinuation) remaining.push_back(job.State);
+				}
+				queue.clear();
+			}
+		}
+		// Nobody would run them anymore, so anyone waiting for them is released
+		for (const Ref<TaskState>& state : remaining)
+		{
+			Cancel(*state);
+		}
+	}
+
+	void TaskScheduler::Submit(const Ref<TaskState>& state)
+	{
+		s_Scheduled++;
+		{
+			std::unique_lock<std::mutex> lock(s_Mutex);
+			if (!s_Running)
+			{
+				lock.unlock();
+				if (s_IsShutDown)
+				{
+					// E.g. Assets that are loaded while the Application is closing
+					Execute(state);
+					return;
+				}
+				StartWorkers(0);
+				lock.lock();
+			}
+			s_Queues[(size_t)state->Priority].push_back(state);
+			s_QueuedTasks++;
+		}
+		s_QueueCondition.notify_one();
+	}
+
+	void TaskScheduler::EnqueueMainThread(const Ref<TaskState>& state, bool isContinuation)
+	{
+		if (!isContinuation) s_Scheduled++;
+
+		std::lock_guard<std::mutex> lock(s_MainThreadMutex);
+		s_MainThreadQueues[(size_t)state->Priority].push_back({ state, isContinuation });
+	}
+
+	void TaskScheduler::WorkerThread(int32_t index)
+	{
+		s_WorkerIndex = index;
+
+		while (true)
+		{
+			Ref<TaskState> state;
+			{
+				std::unique_lock<std::mutex> lock(s_Mutex);
+				s_QueueCondition.wait(lock, []() { return !s_Running || s_QueuedTasks > 0; });
+				if (!s_Running)
+				{
+					return;
+				}
+
+				for (std::deque<Ref<TaskState>>& queue : s_Queues)
+				{
+					if (!queue.empty())
+					{
+						state = queue.front();
+						queue.pop_front();
+						break;
+					}
+				}
+				s_QueuedTasks--;
+			}
+
+			// Skipped if it was cancelled or taken over by Wait() in the meantime
+			Execute(state);
+		}
+	}
+
+	bool TaskScheduler::Execute(const Ref<TaskState>& ref)
+	{
+		TaskState& state = *ref;
+		TaskStatus expected = TaskStatus::Pending;
+		if (!state.Status.compare_exchange_strong(expected, TaskStatus::Running))
+		{
+			return false;
+		}
+
+		TaskState* previous = s_CurrentTask;
+		s_CurrentTask = &state;
+		const auto begin = std::chrono::steady_clock::now();
+		state.Work();
+		Report(state, false, begin);
+		s_CurrentTask = previous;
+
+		// Releases everything the work captured
+		state.Work = nullptr;
+
+		const bool hasContinuation = state.Continuation && !state.CancelRequested;
+		state.Status = TaskStatus::Completed;
+		state.Status.notify_all();
+		s_Completed++;
+
+		if (hasContinuation)
+		{
+			EnqueueMainThread(ref, true);
+		}
+		return true;
+	}
+
+	void TaskScheduler::Cancel(TaskState& state)
+	{
+		state.CancelRequested = true;
+
+		TaskStatus expected = TaskStatus::Pending;
+		if (state.Status.compare_exchange_strong(expected, TaskStatus::Cancelled))
+		{
+			state.Work = nullptr;
+			state.Status.notify_all();
+			s_Cancelled++;
+		}
+	}
+
+	void TaskScheduler::Wait(const Ref<TaskState>& ref)
+	{
+		TaskState& state = *ref;
+		// Run it right here instead of waiting for a worker, unless it has to run on the main thread
+		if (!state.IsMainThread || IsMainThread())
+		{
+			Execute(ref);
+		}
+
+		TaskStatus status = state.Status.load();
+		while (status == TaskStatus::Pending || status == TaskStatus::Running)
+		{
+			state.Status.wait(status);
+			status = state.Status.load();
+		}
+	}
+
+	void TaskScheduler::ParallelFor(uint32_t count, const std::function<void(uint32_t begin, uint32_t end)>& func, uint32_t maxThreads)
+	{
+		if (count == 0)
+		{
+			return;
+		}
+
+		uint32_t threads = GetWorkerCount() + 1;
+		if (maxThreads > 0) threads = std::min(threads, maxThreads);
+		threads = std::min(threads, count);
+		if (threads <= 1)
+		{
+			func(0, count);
+			return;
+		}
+
+		// More ranges than threads, so threads that finish early take over the rest
+		struct ParallelForState
+		{
+			const std::function<void(uint32_t, uint32_t)>* Func = nullptr;
+			uint32_t Count = 0, RangeSize = 0, RangeCount = 0;
+			std::atomic<uint32_t> NextRange = 0;
+			std::atomic<uint32_t> DoneRanges = 0;
+		};
+		Ref<ParallelForState> shared = CreateRef<ParallelForState>();
+		shared->Func = &func;
+		shared->Count = count;
+		shared->RangeSize = (count + threads * 4 - 1) / (threads * 4);
+		shared->RangeCount = (count + shared->RangeSize - 1) / shared->RangeSize;
+
+		// Helpers that start after all ranges are taken return right away, without touching func
+		auto runRanges = [shared]()
+		{
+			while (true)
+			{
+				const uint32_t range = shared->NextRange++;
+				if (range >= shared->RangeCount)
+				{
+					return;
+				}
+				const uint32_t begin = range * shared->RangeSize;
+				(*shared->Func)(begin, std::min(begin + shared->RangeSize, shared->Count));
+				if (++shared->DoneRanges == shared->RangeCount)
+				{
+					shared->DoneRanges.notify_all();
+				}
+			}
+		};
+
+		for (uint32_t i = 1; i < threads; i++)
+		{
+			Run(runRanges, TaskPriority::High, "ParallelFor");
+		}
+		runRanges();
+
+		uint32_t done = shared->DoneRanges.load();
+		while (done != shared->RangeCount)
+		{
+			shared->DoneRanges.wait(done);
+			done = shared->DoneRanges.load();
+		}
+	}
+
+	void TaskScheduler::PumpMainThread()
+	{
+		PumpMainThread(s_MainThreadBudgetMs);
+	}
+
+	void TaskScheduler::PumpMainThread(float budgetMs)
+	{
+		SUORA_ASSERT(IsMainThread() || s_MainThreadID == std::thread::id(), "PumpMainThread() has to be called on the main thread!");
+
+		const auto start = std::chrono::steady_clock::now();
+		auto elapsedMs = [start]() { return std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count(); };
+		uint32_t executed = 0;
+		uint32_t deferred = 0;
+
+		while (true)
+		{
+			MainThreadJob job;
+			{
+				std::lock_guard<std::mutex> lock(s_MainThreadMutex);
+				std::deque<MainThreadJob>* queue = nullptr;
+				for (std::deque<MainThreadJob>& it : s_MainThreadQueues)
+				{
+					if (!it.empty())
+					{
+						queue = &it;
+						break;
+					}
+				}
+				if (!queue)
+				{
+					break;
+				}
+				if (queue->front().State->Priority != TaskPriority::High && executed > 0 && elapsedMs() >= budgetMs)
+				{
+					for (const std::deque<MainThreadJob>& it : s_MainThreadQueues)
+					{
+						deferred += (uint32_t)it.size();
+					}
+					break;
+				}
+				job = queue->front();
+				queue->pop_front();
+			}
+
+			TaskState& state = *job.State;
+			if (!job.IsContinuation)
+			{
+				if (Execute(job.State)) executed++;
+				continue;
+			}
+			if (state.CancelRequested)
+			{
+				state.Continuation = nullptr;
+				continue;
+			}
+
+			const auto begin = std::chrono::steady_clock::now();
+			state.Continuation();
+			state.Continuation = nullptr;
+			Report(state, true, begin);
+			executed++;
+		}
+
+		s_MainThreadJobsExecuted += executed;
+		s_MainThreadJobsDeferred = deferred;
+		s_MainThreadTimeMs = elapsedMs();
+	}
+
+	bool TaskScheduler::IsCancellationRequested()
+	{
+		return s_CurrentTask && s_CurrentTask->CancelRequested;
+	}
+
+	bool TaskScheduler::IsMainThread()
+	{
+		return std::this_thread::get_id() == s_MainThreadID;
+	}
+
+	uint32_t TaskScheduler::GetWorkerCount()
+	{
+		std::lock_guard<std::mutex> lock(s_Mutex);
+		return (uint32_t)s_Workers.size();
+	}
+
+	TaskSchedulerStats TaskScheduler::GetStats()
+	{
+		TaskSchedulerStats stats;
+		{
+			std::lock_guard<std::mutex> lock(s_Mutex);
+			stats.WorkerCount = (uint32_t)s_Workers.size();
+			stats.QueuedTasks = s_QueuedTasks;
+		}
+		{
+			std::lock_guard<std::mutex> lock(s_MainThreadMutex);
+			for (const std::deque<MainThreadJob>& queue : s_MainThreadQueues)
+			{
+				stats.QueuedMainThreadJobs += (uint32_t)queue.size();
+			}
+		}
+		stats.Scheduled = s_Scheduled;
+		stats.Completed = s_Completed;
+		stats.Cancelled = s_Cancelled;
+		stats.MainThreadJobsExecuted = s_MainThreadJobsExecuted;
+		stats.MainThreadJobsDeferred = s_MainThreadJobsDeferred;
+		stats.MainThreadTimeMs = s_MainThreadTimeMs;
+		return stats;
+	}
+
+	uint64_t TaskScheduler::AddObserver(const TaskObserver& observer)
+	{
+		std::lock_guard<std::mutex> lock(s_ObserverMutex);
+		const uint64_t handle = s_NextObserverHandle++;
+		const std::shared_ptr<const ObserverList> current = s_Observers.load();
+		auto observers = current ? std::make_shared<ObserverList>(*current) : std::make_shared<ObserverList>();
+		observers->push_back({ handle, observer });
+		s_Observers.store(std::move(observers));
+		s_HasObservers = true;
+		return handle;
+	}
+
+	void TaskScheduler::RemoveObserver(uint64_t handle)
+	{
+		std::lock_guard<std::mutex> lock(s_ObserverMutex);
+		const std::shared_ptr<const ObserverList> current = s_Observers.load();
+		if (!current)
+		{
+			return;
+		}
+		auto observers = std::make_shared<ObserverList>(*current);
+		observers->erase(std::remove_if(observers->begin(), observers->end(), [handle](const auto& it) { return it.first == handle; }), observers->end());
+		s_HasObservers = !observers->empty();
+		s_Observers.store(observers->empty() ? nullptr : std::move(observers));
+	}
+
+	void TaskScheduler::Report(const TaskState& state, bool isContinuation, std::chrono::steady_clock::time_point begin)
+	{
+		// Without observers, instrumentation costs one atomic load per Task
+		if (!s_HasObservers)
+		{
+			return;
+		}
+
+		TaskEvent event;
+		event.Name = state.Name;
+		event.Priority = state.Priority;
+		event.IsContinuation = isContinuation;
+		event.IsMainThread = IsMainThread();
+		event.WorkerIndex = s_WorkerIndex;
+		event.Begin = begin;
+		event.End = std::chrono::steady_clock::now();
+
+		// The snapshot is never modified once published; a Task that already loaded it may still call a removed observer
+		const std::shared_ptr<const ObserverList> observers = s_Observers.load();
+		if (!observers)
+		{
+			return;
+		}
+		for (const auto& [handle, observer] : *observers)
+		{
+			observer(event);
+		}
+	}
+
+}
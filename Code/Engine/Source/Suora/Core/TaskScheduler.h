@@ -0,0 +1,256 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <variant>
+#include <vector>
+#include "Suora/Core/Base.h"
+
+namespace Suora
+{
+
+	enum class TaskPriority : uint8_t
+	{
+		/** Work someone waits for, e.g. ParallelFor(). Main thread continuations with High priority ignore the frame budget */
+		High = 0,
+		Normal,
+		/** Prefetching and other work nobody waits for yet */
+		Low,
+		COUNT
+	};
+
+	enum class TaskStatus : uint8_t
+	{
+		Pending = 0,
+		Running,
+		Completed,
+		/** Cancelled before it started, the Task has no result */
+		Cancelled
+	};
+
+	/** Shared by all handles of a Task and the TaskScheduler */
+	struct TaskState
+	{
+		const char* Name = "Task";
+		TaskPriority Priority = TaskPriority::Normal;
+		bool IsMainThread = false;
+		std::atomic<TaskStatus> Status = TaskStatus::Pending;
+		std::atomic<bool> CancelRequested = false;
+		std::function<void()> Work;
+		/** Queued on the main thread once Work completed, unless the Task was cancelled by then */
+		std::function<void()> Continuation;
+	};
+
+	template<class R>
+	class Task
+	{
+		using Storage = std::conditional_t<std::is_void_v<R>, std::monostate, R>;
+	public:
+		Task() = default;
+
+		bool IsValid() const { return m_State != nullptr; }
+		TaskStatus GetStatus() const { return m_State ? m_State->Status.load() : TaskStatus::Cancelled; }
+		/** The work completed; the main thread continuation may still be queued */
+		bool IsReady() const { return GetStatus() == TaskStatus::Completed; }
+		bool IsCancelled() const { return m_State && m_State->CancelRequested; }
+
+		/** A Task that did not start yet is skipped. Running work can poll TaskScheduler::IsCancellationRequested().
+		 *  The main thread continuation is dropped in both cases, so it is safe to destroy what it refers to after Wait(). */
+		void Cancel();
+		/** Blocks until the work completed or was cancelled. A Task that did not start yet is run on the calling thread. */
+		void Wait() const;
+
+		/** Waits for the result. Not valid for cancelled Tasks. */
+		Storage& Get() requires (!std::is_void_v<R>)
+		{
+			Wait();
+			SUORA_ASSERT(m_Result->has_value(), "The Task was cancelled and has no result!");
+			return **m_Result;
+		}
+
+	private:
+		Ref<TaskState> m_State;
+		Ref<std::optional<Storage>> m_Result;
+
+		friend class TaskScheduler;
+	};
+
+	struct TaskEvent
+	{
+		const char* Name = "";
+		TaskPriority Priority = TaskPriority::Normal;
+		/** A main thread continuation, not the work of the Task itself */
+		bool IsContinuation = false;
+		bool IsMainThread = false;
+		/** Index of the worker thread, -1 for other threads */
+		int32_t WorkerIndex = -1;
+		std::chrono::steady_clock::time_point Begin;
+		std::chrono::steady_clock::time_point End;
+	};
+	using TaskObserver = std::function<void(const TaskEvent& event)>;
+
+	struct TaskSchedulerStats
+	{
+		uint32_t WorkerCount = 0;
+		uint64_t Scheduled = 0;
+		uint64_t Completed = 0;
+		uint64_t Cancelled = 0;
+		uint32_t QueuedTasks = 0;
+		uint32_t QueuedMainThreadJobs = 0;
+		uint64_t MainThreadJobsExecuted = 0;
+		/** Main thread jobs left queued after the last PumpMainThread(), because the budget was spent */
+		uint32_t MainThreadJobsDeferred = 0;
+		/** Time spent in the last PumpMainThread() */
+		float MainThreadTimeMs = 0.0f;
+	};
+
+	/* One pool of worker threads for all background work of the engine and the editor. Tasks are taken by priority,
+	 * first in first out within the same priority. Work that has to happen on the main thread, e.g. GPU uploads and
+	 * the finalization of Assets, is queued as a continuation and run by PumpMainThread() once per frame, within a
+	 * time budget, so many Assets finishing at once are spread over several frames instead of stalling one.
+	 * Observers get an event for every Task and continuation that ran, e.g. for profiling. */
+	class TaskScheduler
+	{
+	public:
+		/** Call on the main thread. A workerCount of 0 uses one thread per core, minus the main thread. */
+		static void Initialize(uint32_t workerCount = 0);
+		/** Joins the workers; Tasks that did not start yet are cancelled */
+		static void Shutdown();
+
+		template<class F, class R = std::invoke_result_t<F>>
+		static Task<R> Run(F&& work, TaskPriority priority = TaskPriority::Normal, const char* name = "Task")
+		{
+			return Run(std::forward<F>(work), std::function<void()>(), priority, name);
+		}
+		/** onMainThread is run by PumpMainThread() once the work completed */
+		template<class F, class R = std::invoke_result_t<F>>
+		static Task<R> Run(F&& work, std::function<void()> onMainThread, TaskPriority priority = TaskPriority::Normal, const char* name = "Task")
+		{
+			Task<R> task = CreateTask<R>(std::forward<F>(work), priority, name);
+			task.m_State->Continuation = std::move(onMainThread);
+			Submit(task.m_State);
+			return task;
+		}
+		/** Can be called from any thread */
+		template<class F, class R = std::invoke_result_t<F>>
+		static Task<R> RunOnMainThread(F&& work, TaskPriority priority = TaskPriority::Normal, const char* name = "MainThreadTask")
+		{
+			Task<R> task = CreateTask<R>(std::forward<F>(work), priority, name);
+			task.m_State->IsMainThread = true;
+			EnqueueMainThread(task.m_State, false);
+			return task;
+		}
+
+		/** Calls func with consecutive ranges [begin, end) that cover [0, count), on the workers and the calling thread.
+		 *  Returns once all ranges are done. maxThreads limits the threads involved, 0 for no limit. */
+		static void ParallelFor(uint32_t count, const std::function<void(uint32_t begin, uint32_t end)>& func, uint32_t maxThreads = 0);
+
+		/** Runs main thread jobs until the budget is spent. High priority jobs always run, and so does the first one. */
+		static void PumpMainThread();
+		static void PumpMainThread(float budgetMs);
+		static void SetMainThreadBudget(float budgetMs) { s_MainThreadBudgetMs = budgetMs; }
+		static float GetMainThreadBudget() { return s_MainThreadBudgetMs; }
+
+		/** For work that checks for cancellation while running */
+		static bool IsCancellationRequested();
+		static bool IsMainThread();
+		static uint32_t GetWorkerCount();
+
+		static TaskSchedulerStats GetStats();
+		/** Returns the handle for RemoveObserver(). Observers are called on the thread that ran the Task. */
+		static uint64_t AddObserver(const TaskObserver& observer);
+		/** Tasks that already started reporting may call the removed observer once more */
+		static void RemoveObserver(uint64_t handle);
+
+	private:
+		template<class R, class F>
+		static Task<R> CreateTask(F&& work, TaskPriority priority, const char* name)
+		{
+			Task<R> task;
+			task.m_State = CreateRef<TaskState>();
+			task.m_State->Name = name;
+			task.m_State->Priority = priority;
+			task.m_Result = CreateRef<std::optional<typename Task<R>::Storage>>();
+			task.m_State->Work = [result = task.m_Result, work = std::forward<F>(work)]() mutable
+			{
+				if constexpr (std::is_void_v<R>)
+				{
+					work();
+					result->emplace();
+				}
+				else
+				{
+					result->emplace(work());
+				}
+			};
+			return task;
+		}
+
+		static void Submit(const Ref<TaskState>& state);
+		static void EnqueueMainThread(const Ref<TaskState>& state, bool isContinuation);
+		static void StartWorkers(uint32_t workerCount);
+		static void WorkerThread(int32_t index);
+		/** Runs the work, if the Task is still pending; returns false otherwise */
+		static bool Execute(const Ref<TaskState>& state);
+		static void Cancel(TaskState& state);
+		static void Wait(const Ref<TaskState>& state);
+		static void Report(const TaskState& state, bool isContinuation, std::chrono::steady_clock::time_point begin);
+
+		struct MainThreadJob
+		{
+			Ref<TaskState> State;
+			bool IsContinuation = false;
+		};
+
+		inline static std::mutex s_Mutex;
+		inline static std::condition_variable s_QueueCondition;
+		inline static std::deque<Ref<TaskState>> s_Queues[(size_t)TaskPriority::COUNT];
+		inline static uint32_t s_QueuedTasks = 0;
+		inline static std::vector<std::thread> s_Workers;
+		inline static bool s_Running = false;
+		inline static bool s_IsShutDown = false;
+		inline static std::thread::id s_MainThreadID;
+
+		inline static std::mutex s_MainThreadMutex;
+		inline static std::deque<MainThreadJob> s_MainThreadQueues[(size_t)TaskPriority::COUNT];
+		inline static float s_MainThreadBudgetMs = 2.0f;
+
+		using ObserverList = std::vector<std::pair<uint64_t, TaskObserver>>;
+		/** Serializes AddObserver() and RemoveObserver(); Report() reads the published snapshot without it */
+		inline static std::mutex s_ObserverMutex;
+		inline static std::atomic<std::shared_ptr<const ObserverList>> s_Observers;
+		inline static std::atomic<bool> s_HasObservers = false;
+		inline static uint64_t s_NextObserverHandle = 1;
+
+		inline static std::atomic<uint64_t> s_Scheduled = 0, s_Completed = 0, s_Cancelled = 0;
+		inline static uint64_t s_MainThreadJobsExecuted = 0;
+		inline static uint32_t s_MainThreadJobsDeferred = 0;
+		inline static float s_MainThreadTimeMs = 0.0f;
+
+		inline static thread_local TaskState* s_CurrentTask = nullptr;
+		inline static thread_local int32_t s_WorkerIndex = -1;
+
+		template<class R> friend class Task;
+	};
+
+	template<class R>
+	inline void Task<R>::Cancel()
+	{
+		if (m_State) TaskScheduler::Cancel(*m_State);
+	}
+
+	template<class R>
+	inline void Task<R>::Wait() const
+	{
+		if (m_State) TaskScheduler::Wait(m_State);
+	}
+
+}
@@ -0,0 +1,403 @@
+#include "Precompiled.h"
+#include "Profiler.h"
+#include "Suora/Core/TaskScheduler.h"
+#include "Suora/Renderer/GPUTimer.h"
+#include <algorithm>
+#include <fstream>
+#include <thread>
+
+namespace Suora
+{
+	/** Timers that never resolve, e.g. because the GPU zones were recorded without a GraphicsContext, are dropped beyond this */
+	static constexpr size_t MaxPendingGPUZones = 4096;
+	/** tids of the tracks in the Chrome trace that are not threads */
+	static constexpr uint32_t TraceFrameTrack = 100000;
+	static constexpr uint32_t TraceGPUTrack = 100001;
+
+	static std::thread::id s_MainThreadID;
+
+	ProfileCounter::ProfileCounter(const char* name, ProfileCounterType type)
+		: Name(name), Type(type)
+	{
+		std::lock_guard<std::mutex> lock(Profiler::s_CounterMutex);
+		Profiler::s_Counters.push_back(this);
+	}
+
+	/** Sorts the zones of one thread by begin, and sets the depth by counting the zones that enclose them */
+	static void AssignDepths(std::vector<ProfileZone>::iterator begin, std::vector<ProfileZone>::iterator end)
+	{
+		std::sort(begin, end, [](const ProfileZone& a, const ProfileZone& b)
+		{
+			return a.BeginNs != b.BeginNs ? a.BeginNs < b.BeginNs : a.EndNs > b.EndNs;
+		});
+
+		std::vector<uint64_t> openEnds;
+		for (auto it = begin; it != end; it++)
+		{
+			while (!openEnds.empty() && openEnds.back() <= it->BeginNs)
+			{
+				openEnds.pop_back();
+			}
+			it->Depth = (uint32_t)openEnds.size();
+			openEnds.push_back(it->EndNs);
+		}
+	}
+
+	void Profiler::Initialize()
+	{
+		s_MainThreadID = std::this_thread::get_id();
+		s_Epoch = std::chrono::steady_clock::now();
+		s_FrameBeginNs = 0;
+		SetThreadName("Main");
+		Calibrate();
+
+		// Tasks are recorded on the thread that ran them, after they finished
+		s_TaskObserver = TaskScheduler::AddObserver([](const TaskEvent& event)
+		{
+			if (!IsEnabled()) return;
+
+			ProfilerThreadBuffer& buffer = GetThreadBuffer();
+			if (event.WorkerIndex >= 0 && buffer.ThreadName.empty())
+			{
+				SetThreadName("Worker " + std::to_string(event.WorkerIndex));
+			}
+			buffer.Push(event.Name,
+				(uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(event.Begin - s_Epoch).count(),
+				(uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(event.End - s_Epoch).count());
+		});
+
+		s_Initialized = true;
+	}
+
+	void Profiler::Shutdown()
+	{
+		if (!s_Initialized) return;
+
+		TaskScheduler::RemoveObserver(s_TaskObserver);
+		// GPUTimers have to go while the GraphicsContext still exists
+		s_PendingGPUZones.clear();
+		s_FreeGPUTimers.clear();
+		s_OpenGPUZones.clear();
+		s_Frames.clear();
+		s_Initialized = false;
+	}
+
+	void Profiler::Calibrate()
+	{
+		constexpr uint32_t iterations = 10000;
+		const bool wasEnabled = IsEnabled();
+		ProfilerThreadBuffer& buffer = GetThreadBuffer();
+
+		SetEnabled(true);
+		const uint64_t enabledBegin = Now();
+		for (uint32_t i = 0; i < iterations; i++)
+		{
+			ProfileScope scope("Profiler::Calibrate");
+		}
+		const uint64_t enabledEnd = Now();
+
+		SetEnabled(false);
+		for (uint32_t i = 0; i < iterations; i++)
+		{
+			ProfileScope scope("Profiler::Calibrate");
+		}
+		const uint64_t disabledEnd = Now();
+
+		SetEnabled(wasEnabled);
+		buffer.ReadIndex = buffer.WriteIndex.load();
+
+		s_Stats.ZoneCostNs = (float)(enabledEnd - enabledBegin) / iterations;
+		s_Stats.DisabledZoneCostNs = (float)(disabledEnd - enabledEnd) / iterations;
+	}
+
+	ProfilerThreadBuffer& Profiler::GetThreadBuffer()
+	{
+		if (!s_ThreadBuffer)
+		{
+			// Constructed on the first zone of a thread only, so the zones themselves do not pay for its destructor
+			static thread_local ThreadBufferLease lease;
+			std::lock_guard<std::mutex> lock(s_ThreadMutex);
+			if (!s_FreeThreadBuffers.empty())
+			{
+				// The events of the last thread are still collected, the indices of the ring carry on
+				s_ThreadBuffer = s_FreeThreadBuffers.back();
+				s_FreeThreadBuffers.pop_back();
+			}
+			else
+			{
+				Scope<ProfilerThreadBuffer> buffer = CreateScope<ProfilerThreadBuffer>();
+				buffer->ThreadIndex = (uint32_t)s_ThreadBuffers.size();
+				s_ThreadBuffer = buffer.get();
+				s_ThreadBuffers.push_back(std::move(buffer));
+			}
+			lease.Buffer = s_ThreadBuffer;
+		}
+		return *s_ThreadBuffer;
+	}
+
+	Profiler::ThreadBufferLease::~ThreadBufferLease()
+	{
+		if (!Buffer) return;
+
+		// Like the ids of the OS, the ThreadIndex goes to the next thread; the frames in the history show its name
+		std::lock_guard<std::mutex> lock(s_ThreadMutex);
+		Buffer->ThreadName.clear();
+		s_FreeThreadBuffers.push_back(Buffer);
+		s_ThreadBuffer = nullptr;
+	}
+
+	void Profiler::SetThreadName(const String& name)
+	{
+		ProfilerThreadBuffer& buffer = GetThreadBuffer();
+		std::lock_guard<std::mutex> lock(s_ThreadMutex);
+		buffer.ThreadName = name;
+	}
+
+	void Profiler::EndFrame()
+	{
+		const uint64_t now = Now();
+
+		ProfilerFrame frame;
+		frame.Index = s_FrameIndex++;
+		frame.BeginNs = s_FrameBeginNs;
+		frame.EndNs = now;
+		s_FrameBeginNs = now;
+
+		// Drained even while disabled or paused, so the buffers start empty once recording resumes
+		CollectZones(frame);
+
+		{
+			std::lock_guard<std::mutex> lock(s_CounterMutex);
+			for (ProfileCounter* counter : s_Counters)
+			{
+				const int64_t value = counter->Type == ProfileCounterType::PerFrame ? counter->Value.exchange(0, std::memory_order_relaxed) : counter->Value.load(std::memory_order_relaxed);
+				frame.Counters.push_back({ counter->Name, value });
+			}
+		}
+
+		if (!s_PendingGPUZones.empty())
+		{
+			ResolveGPUZones();
+		}
+
+		if (IsEnabled() && !s_Paused)
+		{
+			s_Frames.push_back(std::move(frame));
+			while (s_Frames.size() > s_MaxFrames)
+			{
+				s_Frames.pop_front();
+			}
+		}
+
+		s_Stats.CollectTimeMs = (Now() - now) / 1000000.0f;
+	}
+
+	void Profiler::CollectZones(ProfilerFrame& frame)
+	{
+		std::lock_guard<std::mutex> lock(s_ThreadMutex);
+		for (const Scope<ProfilerThreadBuffer>& buffer : s_ThreadBuffers)
+		{
+			const uint64_t write = buffer->WriteIndex.load(std::memory_order_acquire);
+			uint64_t read = buffer->ReadIndex;
+			if (write - read > ProfilerThreadBuffer::s_Capacity)
+			{
+				s_Stats.DroppedZones += write - read - ProfilerThreadBuffer::s_Capacity;
+				read = write - ProfilerThreadBuffer::s_Capacity;
+			}
+
+			const size_t first = frame.Zones.size();
+			for (uint64_t i = read; i < write; i++)
+			{
+				const ProfileEvent& event = buffer->Events[i % ProfilerThreadBuffer::s_Capacity];
+				if (event.Sequence.load(std::memory_order_acquire) != i + 1)
+				{
+					s_Stats.DroppedZones++;
+					continue;
+				}
+				const ProfileZone zone = { event.Name.load(std::memory_order_relaxed), event.BeginNs.load(std::memory_order_relaxed), event.EndNs.load(std::memory_order_relaxed), buffer->ThreadIndex, 0 };
+
+				// The thread kept recording while the event was copied, and might have started to overwrite it
+				std::atomic_thread_fence(std::memory_order_acquire);
+				if (event.Sequence.load(std::memory_order_relaxed) != i + 1)
+				{
+					s_Stats.DroppedZones++;
+					continue;
+				}
+				frame.Zones.push_back(zone);
+			}
+
+			buffer->ReadIndex = write;
+			s_Stats.RecordedZones += frame.Zones.size() - first;
+			AssignDepths(frame.Zones.begin() + first, frame.Zones.end());
+		}
+	}
+
+	void Profiler::BeginGPUZone(const char* name)
+	{
+		if (std::this_thread::get_id() != s_MainThreadID) return;
+		if (s_PendingGPUZones.size() >= MaxPendingGPUZones)
+		{
+			// Keeps EndGPUZone() balanced
+			s_OpenGPUZones.push_back(SIZE_MAX);
+			return;
+		}
+
+		if (!s_GPUClockCalibrated)
+		{
+			s_GPUClockOffsetNs = (int64_t)Now() - (int64_t)GPUTimer::GetGPUTime();
+			s_GPUClockCalibrated = true;
+		}
+
+		Ref<GPUTimer> timer;
+		if (!s_FreeGPUTimers.empty())
+		{
+			timer = s_FreeGPUTimers.back();
+			s_FreeGPUTimers.pop_back();
+		}
+		else
+		{
+			timer = GPUTimer::Create();
+		}
+		timer->Begin();
+
+		s_OpenGPUZones.push_back(s_PendingGPUZones.size());
+		s_PendingGPUZones.push_back({ name, s_FrameIndex, timer });
+	}
+
+	void Profiler::EndGPUZone()
+	{
+		if (std::this_thread::get_id() != s_MainThreadID || s_OpenGPUZones.empty()) return;
+
+		const size_t index = s_OpenGPUZones.back();
+		s_OpenGPUZones.pop_back();
+		if (index != SIZE_MAX)
+		{
+			s_PendingGPUZones[index].Timer->End();
+		}
+	}
+
+	void Profiler::ResolveGPUZones()
+	{
+		// Zones still open belong to a frame that is not over yet
+		if (!s_OpenGPUZones.empty()) return;
+
+		size_t resolved = 0;
+		uint64_t frameIndex = UINT64_MAX;
+		ProfilerFrame* frame = nullptr;
+		for (; resolved < s_PendingGPUZones.size(); resolved++)
+		{
+			PendingGPUZone& pending = s_PendingGPUZones[resolved];
+			// The GPU finishes queries in order
+			if (!pending.Timer->IsResultAvailable()) break;
+
+			if (pending.FrameIndex != frameIndex)
+			{
+				if (frame) AssignDepths(frame->GPUZones.begin(), frame->GPUZones.end());
+				frameIndex = pending.FrameIndex;
+				auto it = std::find_if(s_Frames.rbegin(), s_Frames.rend(), [frameIndex](const ProfilerFrame& it) { return it.Index == frameIndex; });
+				frame = it != s_Frames.rend() ? &*it : nullptr;
+			}
+			if (frame)
+			{
+				ProfileZone zone;
+				zone.Name = pending.Name;
+				zone.BeginNs = (uint64_t)((int64_t)pending.Timer->GetBeginNs() + s_GPUClockOffsetNs);
+				zone.EndNs = (uint64_t)((int64_t)pending.Timer->GetEndNs() + s_GPUClockOffsetNs);
+				frame->GPUZones.push_back(zone);
+			}
+			s_FreeGPUTimers.push_back(pending.Timer);
+		}
+		if (frame) AssignDepths(frame->GPUZones.begin(), frame->GPUZones.end());
+
+		s_PendingGPUZones.erase(s_PendingGPUZones.begin(), s_PendingGPUZones.begin() + resolved);
+	}
+
+	std::vector<ProfilerThreadInfo> Profiler::GetThreads()
+	{
+		std::lock_guard<std::mutex> lock(s_ThreadMutex);
+		std::vector<ProfilerThreadInfo> threads;
+		for (const Scope<ProfilerThreadBuffer>& buffer : s_ThreadBuffers)
+		{
+			threads.push_back({ buffer->ThreadIndex, buffer->ThreadName.empty() ? "Thread " + std::to_string(buffer->ThreadIndex) : buffer->ThreadName });
+		}
+		return threads;
+	}
+
+	ProfilerStats Profiler::GetStats()
+	{
+		return s_Stats;
+	}
+
+	static String EscapeJson(const char* str)
+	{
+		String result;
+		for (const char* c = str ? str : ""; *c; c++)
+		{
+			if (*c == '"' || *c == '\\') result += '\\';
+			if ((unsigned char)*c < 0x20) continue;
+			result += *c;
+		}
+		return result;
+	}
+
+	bool Profiler::ExportChromeTrace(const Path& path)
+	{
+		std::error_code error;
+		if (path.has_parent_path())
+		{
+			std::filesystem::create_directories(path.parent_path(), error);
+		}
+		std::ofstream out(path, std::ios::out | std::ios::trunc);
+		if (!out)
+		{
+			SuoraError("Profiler: Failed to write '{0}'", path.string());
+			return false;
+		}
+
+		// Microseconds, the unit of the trace format
+		auto ts = [](uint64_t ns) { return std::to_string(ns / 1000) + "." + std::to_string(ns % 1000 / 100); };
+		bool first = true;
+		auto next = [&out, &first]() -> std::ofstream&
+		{
+			out << (first ? "\n" : ",\n");
+			first = false;
+			return out;
+		};
+
+		out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+		next() << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"Suora\"}}";
+		for (const ProfilerThreadInfo& thread : GetThreads())
+		{
+			next() << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << thread.Index << ",\"args\":{\"name\":\"" << EscapeJson(thread.Name.c_str()) << "\"}}";
+		}
+		next() << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << TraceFrameTrack << ",\"args\":{\"name\":\"Frames\"}}";
+		next() << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << TraceGPUTrack << ",\"args\":{\"name\":\"GPU\"}}";
+
+		for (const ProfilerFrame& frame : s_Frames)
+		{
+			next() << "{\"name\":\"Frame " << frame.Index << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << TraceFrameTrack << ",\"ts\":" << ts(frame.BeginNs) << ",\"dur\":" << ts(frame.EndNs - frame.BeginNs) << "}";
+			for (const ProfileZone& zone : frame.Zones)
+			{
+				next() << "{\"name\":\"" << EscapeJson(zone.Name) << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << zone.ThreadIndex << ",\"ts\":" << ts(zone.BeginNs) << ",\"dur\":" << ts(zone.EndNs - zone.BeginNs) << "}";
+			}
+			for (const ProfileZone& zone : frame.GPUZones)
+			{
+				next() << "{\"name\":\"" << EscapeJson(zone.Name) << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << TraceGPUTrack << ",\"ts\":" << ts(zone.BeginNs) << ",\"dur\":" << ts(zone.EndNs - zone.BeginNs) << "}";
+			}
+			for (const ProfileCounterSample& counter : frame.Counters)
+			{
+				next() << "{\"name\":\"" << EscapeJson(counter.Name) << "\",\"ph\":\"C\",\"pid\":1,\"ts\":" << ts(frame.EndNs) << ",\"args\":{\"value\":" << counter.Value << "}}";
+			}
+		}
+		out << "\n]}\n";
+
+		if (!out)
+		{
+			SuoraError("Profiler: Failed to write '{0}'", path.string());
+			return false;
+		}
+		SuoraLog("Profiler: Exported {0} frames to '{1}'", s_Frames.size(), path.string());
+		return true;
+	}
+
+}
@@ -0,0 +1,290 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "Suora/Core/Base.h"
+#include "Suora/Common/StringUtils.h"
+#include "Suora/Common/Filesystem.h"
+
+namespace Suora
+{
+	class GPUTimer;
+
+	/* A finished zone in a ProfilerThreadBuffer. The fields are atomics, because the main thread may read a slot while
+	 * its thread overwrites it: Sequence is the index of the event plus one, and zero while the fields are written.
+	 * The reader keeps an event only if Sequence holds its index before and after it copied the fields. */
+	struct ProfileEvent
+	{
+		std::atomic<uint64_t> Sequence = 0;
+		std::atomic<const char*> Name = nullptr;
+		std::atomic<uint64_t> BeginNs = 0;
+		std::atomic<uint64_t> EndNs = 0;
+	};
+
+	/* The zones of one thread, in a ring that only this thread writes to. Profiler::EndFrame() reads it on the main
+	 * thread without a lock; events the producer overwrote before they were read are counted as dropped.
+	 * Once its thread exits, the buffer goes to the next thread that records zones. */
+	struct ProfilerThreadBuffer
+	{
+		static constexpr uint32_t s_Capacity = 1 << 15;
+
+		std::unique_ptr<ProfileEvent[]> Events = std::make_unique<ProfileEvent[]>(s_Capacity);
+		std::atomic<uint64_t> WriteIndex = 0;
+		/** Only touched by the main thread */
+		uint64_t ReadIndex = 0;
+		uint32_t ThreadIndex = 0;
+		String ThreadName;
+
+		void Push(const char* name, uint64_t beginNs, uint64_t endNs)
+		{
+			const uint64_t index = WriteIndex.load(std::memory_order_relaxed);
+			ProfileEvent& event = Events[index % s_Capacity];
+			event.Sequence.store(0, std::memory_order_relaxed);
+			// Keeps the fields from being written before the reader can see the zero
+			std::atomic_thread_fence(std::memory_order_release);
+			event.Name.store(name, std::memory_order_relaxed);
+			event.BeginNs.store(beginNs, std::memory_order_relaxed);
+			event.EndNs.store(endNs, std::memory_order_relaxed);
+			event.Sequence.store(index + 1, std::memory_order_release);
+			WriteIndex.store(index + 1, std::memory_order_release);
+		}
+	};
+
+	enum class ProfileCounterType : uint8_t
+	{
+		/** Summed up over a frame and reset after it, e.g. draw calls */
+		PerFrame = 0,
+		/** Keeps its value, e.g. the size of a pool */
+		Value
+	};
+
+	/** Created once per call site by the SUORA_PROFILE_COUNTER macros, and never destroyed */
+	struct ProfileCounter
+	{
+		ProfileCounter(const char* name, ProfileCounterType type);
+
+		void Add(int64_t value) { Value.fetch_add(value, std::memory_order_relaxed); }
+		void Set(int64_t value) { Value.store(value, std::memory_order_relaxed); }
+
+		const char* Name = nullptr;
+		ProfileCounterType Type = ProfileCounterType::PerFrame;
+		std::atomic<int64_t> Value = 0;
+	};
+
+	struct ProfileZone
+	{
+		const char* Name = nullptr;
+		uint64_t BeginNs = 0;
+		uint64_t EndNs = 0;
+		uint32_t ThreadIndex = 0;
+		/** Number of enclosing zones on the same thread */
+		uint32_t Depth = 0;
+
+		float GetDurationMs() const { return (EndNs - BeginNs) / 1000000.0f; }
+	};
+
+	struct ProfileCounterSample
+	{
+		const char* Name = nullptr;
+		int64_t Value = 0;
+	};
+
+	struct ProfilerFrame
+	{
+		uint64_t Index = 0;
+		uint64_t BeginNs = 0;
+		uint64_t EndNs = 0;
+		/** Zones that ended during the frame, sorted by thread and begin */
+		std::vector<ProfileZone> Zones;
+		/** Resolved a few frames later, once the GPU is done with the frame. Timestamps are on the CPU clock. */
+		std::vector<ProfileZone> GPUZones;
+		std::vector<ProfileCounterSample> Counters;
+
+		float GetDurationMs() const { return (EndNs - BeginNs) / 1000000.0f; }
+	};
+
+	struct ProfilerThreadInfo
+	{
+		uint32_t Index = 0;
+		String Name;
+	};
+
+	struct ProfilerStats
+	{
+		uint64_t RecordedZones = 0;
+		/** Zones that were overwritten in a full ProfilerThreadBuffer before EndFrame() got to them */
+		uint64_t DroppedZones = 0;
+		/** Cost of one zone, measured by Initialize() */
+		float ZoneCostNs = 0.0f;
+		/** Cost of one zone while the Profiler is disabled at runtime; compiled out zones cost nothing */
+		float DisabledZoneCostNs = 0.0f;
+		/** Time the last EndFrame() took to collect the zones */
+		float CollectTimeMs = 0.0f;
+	};
+
+	/* Low-overhead CPU frame profiler. Zones are recorded with the SUORA_PROFILE_* macros into per-thread buffers and
+	 * collected once per frame by EndFrame(), which also samples the counters and resolves GPU timers. The last frames
+	 * are kept for the editor and can be exported as Chrome trace JSON, which chrome://tracing and Perfetto open.
+	 * Tasks of the TaskScheduler show up as zones on their worker threads.
+	 * Defining SUORA_ENABLE_PROFILER (all configurations but Dist) compiles the macros in. */
+	class Profiler
+	{
+	public:
+		/** Call on the main thread */
+		static void Initialize();
+		static void Shutdown();
+
+		/** Closes the current frame and starts the next one. Call once per frame on the main thread. */
+		static void EndFrame();
+
+		static bool IsEnabled() { return s_Enabled.load(std::memory_order_relaxed); }
+		static void SetEnabled(bool enabled) { s_Enabled = enabled; }
+		/** GPU zones need a current GraphicsContext on the main thread, and are off by default */
+		static bool IsGPUTimingEnabled() { return s_GPUTimingEnabled; }
+		static void SetGPUTimingEnabled(bool enabled) { s_GPUTimingEnabled = enabled; }
+		/** Frames are still collected, but not added to the history */
+		static bool IsPaused() { return s_Paused; }
+		static void SetPaused(bool paused) { s_Paused = paused; }
+
+		/** Nanoseconds since Initialize() */
+		static uint64_t Now()
+		{
+			return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - s_Epoch).count();
+		}
+		static ProfilerThreadBuffer& GetThreadBuffer();
+		static void SetThreadName(const String& name);
+
+		static void BeginGPUZone(const char* name);
+		static void EndGPUZone();
+
+		/** Main thread only, oldest first */
+		static const std::deque<ProfilerFrame>& GetFrames() { return s_Frames; }
+		static std::vector<ProfilerThreadInfo> GetThreads();
+		static ProfilerStats GetStats();
+
+		/** Writes the frames in the history. Returns false, if the file could not be written. */
+		static bool ExportChromeTrace(const Path& path);
+
+		inline static uint32_t s_MaxFrames = 300;
+
+	private:
+		static void CollectZones(ProfilerFrame& frame);
+		static void ResolveGPUZones();
+		static void Calibrate();
+
+		/** Hands the buffer of a thread to s_FreeThreadBuffers, when the thread exits */
+		struct ThreadBufferLease
+		{
+			ProfilerThreadBuffer* Buffer = nullptr;
+			~ThreadBufferLease();
+		};
+
+		struct PendingGPUZone
+		{
+			const char* Name = nullptr;
+			uint64_t FrameIndex = 0;
+			Ref<GPUTimer> Timer;
+		};
+
+		inline static std::atomic<bool> s_Enabled = true;
+		inline static bool s_GPUTimingEnabled = false;
+		inline static bool s_Paused = false;
+		inline static bool s_Initialized = false;
+		inline static std::chrono::steady_clock::time_point s_Epoch = std::chrono::steady_clock::now();
+
+		inline static std::mutex s_ThreadMutex;
+		inline static std::vector<Scope<ProfilerThreadBuffer>> s_ThreadBuffers;
+		/** Buffers of threads that exited, reused before new ones are created */
+		inline static std::vector<ProfilerThreadBuffer*> s_FreeThreadBuffers;
+		inline static thread_local ProfilerThreadBuffer* s_ThreadBuffer = nullptr;
+
+		inline static std::mutex s_CounterMutex;
+		inline static std::vector<ProfileCounter*> s_Counters;
+
+		inline static std::deque<ProfilerFrame> s_Frames;
+		inline static uint64_t s_FrameIndex = 0;
+		inline static uint64_t s_FrameBeginNs = 0;
+
+		inline static std::vector<PendingGPUZone> s_PendingGPUZones;
+		inline static std::vector<Ref<GPUTimer>> s_FreeGPUTimers;
+		inline static std::vector<size_t> s_OpenGPUZones;
+		/** CPU time minus GPU time, measured once */
+		inline static int64_t s_GPUClockOffsetNs = 0;
+		inline static bool s_GPUClockCalibrated = false;
+
+		inline static uint64_t s_TaskObserver = 0;
+		inline static ProfilerStats s_Stats;
+
+		friend struct ProfileCounter;
+	};
+
+	class ProfileScope
+	{
+	public:
+		ProfileScope(const char* name)
+			: m_Name(name)
+		{
+			if (Profiler::IsEnabled())
+			{
+				m_Buffer = &Profiler::GetThreadBuffer();
+				m_BeginNs = Profiler::Now();
+			}
+		}
+		~ProfileScope()
+		{
+			if (m_Buffer)
+			{
+				m_Buffer->Push(m_Name, m_BeginNs, Profiler::Now());
+			}
+		}
+
+	private:
+		const char* m_Name = nullptr;
+		ProfilerThreadBuffer* m_Buffer = nullptr;
+		uint64_t m_BeginNs = 0;
+	};
+
+	class GPUProfileScope
+	{
+	public:
+		GPUProfileScope(const char* name)
+		{
+			m_Active = Profiler::IsEnabled() && Profiler::IsGPUTimingEnabled();
+			if (m_Active) Profiler::BeginGPUZone(name);
+		}
+		~GPUProfileScope()
+		{
+			if (m_Active) Profiler::EndGPUZone();
+		}
+
+	private:
+		bool m_Active = false;
+	};
+
+}
+
+#define SUORA_PROFILE_CONCAT_IMPL(a, b) a##b
+#define SUORA_PROFILE_CONCAT(a, b) SUORA_PROFILE_CONCAT_IMPL(a, b)
+
+#ifdef SUORA_ENABLE_PROFILER
+	/** name has to outlive the Profiler, e.g. a string literal */
+	#define SUORA_PROFILE_SCOPE(name) ::Suora::ProfileScope SUORA_PROFILE_CONCAT(_suoraProfileScope, __LINE__)(name)
+	#define SUORA_PROFILE_FUNCTION() SUORA_PROFILE_SCOPE(__FUNCTION__)
+	#define SUORA_PROFILE_GPU_SCOPE(name) ::Suora::GPUProfileScope SUORA_PROFILE_CONCAT(_suoraGPUProfileScope, __LINE__)(name)
+	#define SUORA_PROFILE_COUNTER_ADD(name, value) do { static ::Suora::ProfileCounter _suoraCounter(name, ::Suora::ProfileCounterType::PerFrame); _suoraCounter.Add((int64_t)(value)); } while (0)
+	#define SUORA_PROFILE_COUNTER_SET(name, value) do { static ::Suora::ProfileCounter _suoraCounter(name, ::Suora::ProfileCounterType::Value); _suoraCounter.Set((int64_t)(value)); } while (0)
+	#define SUORA_PROFILE_THREAD(name) ::Suora::Profiler::SetThreadName(name)
+	#define SUORA_PROFILE_END_FRAME() ::Suora::Profiler::EndFrame()
+#else
+	#define SUORA_PROFILE_SCOPE(name)
+	#define SUORA_PROFILE_FUNCTION()
+	#define SUORA_PROFILE_GPU_SCOPE(name)
+	#define SUORA_PROFILE_COUNTER_ADD(name, value)
+	#define SUORA_PROFILE_COUNTER_SET(name, value)
+	#define SUORA_PROFILE_THREAD(name)
+	#define SUORA_PROFILE_END_FRAME()
+#endif
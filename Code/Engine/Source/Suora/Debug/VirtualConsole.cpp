@@ -5,54 +5,230 @@
 namespace Suora
 {
 
-	void VirtualConsole::Tick()
+	ConsoleMessageView::ConsoleMessageView(std::span<const ConsoleMessage> ring, uint64_t firstSequence, size_t count)
+		: m_Ring(ring), m_FirstSequence(firstSequence), m_Count(count), m_IsFiltered(false)
 	{
-		if (m_Messages.size() > m_MaxMessageCount)
-			m_Messages.erase(m_Messages.begin(), m_Messages.begin() + (m_Messages.size() - m_MaxMessageCount));
 	}
-	void VirtualConsole::Clear()
+	ConsoleMessageView::ConsoleMessageView(std::span<const ConsoleMessage> ring, std::span<const uint64_t> first, std::span<const uint64_t> second)
+		: m_Ring(ring), m_Count(first.size() + second.size()), m_IsFiltered(true)
 	{
-		m_Messages.clear();
+		m_Sequences[0] = first;
+		m_Sequences[1] = second;
 	}
-	std::vector<ConsoleMessage> VirtualConsole::GetMessagesWithLevel(LogLevel level)
+	const ConsoleMessage& ConsoleMessageView::operator[](size_t index) const
 	{
-		std::vector<ConsoleMessage> vec;
+		uint64_t sequence = m_FirstSequence + index;
+		if (m_IsFiltered)
+		{
+			sequence = index < m_Sequences[0].size() ? m_Sequences[0][index] : m_Sequences[1][index - m_Sequences[0].size()];
+		}
+		return m_Ring[sequence % VirtualConsole::s_Capacity];
+	}
 
-		for (auto& It : m_Messages)
+	void ConsoleMessageIndex::Push(uint64_t sequence)
+	{
+		if (Sequences.empty()) Sequences.resize(VirtualConsole::s_Capacity);
+		Sequences[(Head + Size) % VirtualConsole::s_Capacity] = sequence;
+		Size++;
+	}
+	void ConsoleMessageIndex::PopFront(uint64_t sequence)
+	{
+		// Messages leave the ring buffer in order, so an evicted message is always the oldest one of its index
+		if (Size > 0 && Sequences[Head] == sequence)
+		{
+			Head = (Head + 1) % VirtualConsole::s_Capacity;
+			Size--;
+		}
+	}
+	ConsoleMessageView ConsoleMessageIndex::View() const
+	{
+		if (Size == 0) return ConsoleMessageView();
+		const std::span<const uint64_t> sequences(Sequences);
+		const uint32_t firstSize = std::min(Size, VirtualConsole::s_Capacity - Head);
+		return ConsoleMessageView(VirtualConsole::s_Messages, sequences.subspan(Head, firstSize), sequences.subspan(0, Size - firstSize));
+	}
+
+	/** Compares two messages without the timestamp that the Log prefixes them with */
+	static bool IsDuplicateMessage(const ConsoleMessage& a, const ConsoleMessage& b)
+	{
+		if (a.m_Level != b.m_Level || a.m_Category != b.m_Category || a.m_CallerLine != b.m_CallerLine
+			|| a.m_CallerFunction != b.m_CallerFunction || a.m_CallerPath != b.m_CallerPath)
+		{
+			return false;
+		}
+		auto skipTimestamp = [](const String& str) -> std::string_view
 		{
-			if (It.m_Level == level)
+			std::string_view view = str;
+			const size_t begin = view.find('[');
+			const size_t end = view.find(']');
+			if (begin != std::string_view::npos && end != std::string_view::npos && begin < end && end < 16)
 			{
-				vec.push_back(It);
+				view.remove_prefix(end + 1);
 			}
+			return view;
+		};
+		return skipTimestamp(a.m_Message) == skipTimestamp(b.m_Message);
+	}
+
+	void VirtualConsole::Tick()
+	{
+		// Stops at the first slot that is still being written, the messages behind it follow in the next Tick
+		uint32_t count = 0;
+		while (true)
+		{
+			PendingSlot& slot = s_PendingSlots[s_PendingHead % s_MaxPendingMessages];
+			const uint64_t lap = s_PendingHead / s_MaxPendingMessages;
+			if (slot.Turn.load(std::memory_order_acquire) != lap * 2 + 1) break;
+
+			AddMessage(std::move(*slot.Message));
+			slot.Message.reset();
+			slot.Turn.store(lap * 2 + 2, std::memory_order_release);
+			s_PendingHead++;
+			count++;
 		}
+		s_Stats.PushedMessages += count;
+		s_Stats.DroppedMessages = s_DroppedMessages.load(std::memory_order_relaxed);
 
-		return vec;
+		s_MessagesInRateWindow += count;
+		const auto now = std::chrono::steady_clock::now();
+		const float seconds = std::chrono::duration<float>(now - s_RateWindowBegin).count();
+		if (seconds >= 1.0f)
+		{
+			s_Stats.MessagesPerSecond = s_MessagesInRateWindow / seconds;
+			s_Stats.PeakMessagesPerSecond = std::max(s_Stats.PeakMessagesPerSecond, s_Stats.MessagesPerSecond);
+			s_MessagesInRateWindow = 0;
+			s_RateWindowBegin = now;
+		}
 	}
+	void VirtualConsole::AddMessage(ConsoleMessage&& msg)
+	{
+		if (s_CollapseDuplicates && s_NextSequence > s_FirstSequence)
+		{
+			ConsoleMessage& last = s_Messages[(s_NextSequence - 1) % s_Capacity];
+			if (IsDuplicateMessage(last, msg))
+			{
+				msg.m_Count = last.m_Count + 1;
+				last = std::move(msg);
+				s_Stats.CollapsedMessages++;
+				return;
+			}
+		}
+
+		if (s_NextSequence - s_FirstSequence == s_Capacity)
+		{
+			const ConsoleMessage& oldest = s_Messages[s_FirstSequence % s_Capacity];
+			if ((uint32_t)oldest.m_Level < s_LevelCount) s_LevelIndices[(uint32_t)oldest.m_Level].PopFront(s_FirstSequence);
+			GetCategoryIndex(oldest.m_Category).PopFront(s_FirstSequence);
+			s_FirstSequence++;
+			s_Stats.OverwrittenMessages++;
+		}
+
+		const uint64_t sequence = s_NextSequence++;
+		if ((uint32_t)msg.m_Level < s_LevelCount) s_LevelIndices[(uint32_t)msg.m_Level].Push(sequence);
+		GetCategoryIndex(msg.m_Category).Push(sequence);
 
-	std::vector<ConsoleMessage> VirtualConsole::GetLogMessages()
+		if (s_Messages.size() < s_Capacity)
+		{
+			if (s_Messages.empty()) s_Messages.reserve(s_Capacity);
+			s_Messages.push_back(std::move(msg));
+		}
+		else
+		{
+			s_Messages[sequence % s_Capacity] = std::move(msg);
+		}
+	}
+	ConsoleMessageIndex& VirtualConsole::GetCategoryIndex(LogCategory category)
+	{
+		// Custom categories are appended behind LogCategory::COUNT
+		if ((size_t)category >= s_CategoryIndices.size()) s_CategoryIndices.resize((size_t)category + 1);
+		return s_CategoryIndices[(size_t)category];
+	}
+
+	void VirtualConsole::Clear()
+	{
+		s_Messages.clear();
+		s_FirstSequence = 0;
+		s_NextSequence = 0;
+		for (ConsoleMessageIndex& index : s_LevelIndices)
+		{
+			index.Head = 0;
+			index.Size = 0;
+		}
+		for (ConsoleMessageIndex& index : s_CategoryIndices)
+		{
+			index.Head = 0;
+			index.Size = 0;
+		}
+	}
+	ConsoleMessageView VirtualConsole::GetMessages()
+	{
+		return ConsoleMessageView(s_Messages, s_FirstSequence, s_NextSequence - s_FirstSequence);
+	}
+	ConsoleMessageView VirtualConsole::GetMessagesWithLevel(LogLevel level)
+	{
+		return (uint32_t)level < s_LevelCount ? s_LevelIndices[(uint32_t)level].View() : ConsoleMessageView();
+	}
+	ConsoleMessageView VirtualConsole::GetMessagesWithCategory(LogCategory category)
+	{
+		return (size_t)category < s_CategoryIndices.size() ? s_CategoryIndices[(size_t)category].View() : ConsoleMessageView();
+	}
+
+	ConsoleMessageView VirtualConsole::GetLogMessages()
 	{
 		return GetMessagesWithLevel(LogLevel::Info);
 	}
-	std::vector<ConsoleMessage> VirtualConsole::GetDebugMessages()
+	ConsoleMessageView VirtualConsole::GetDebugMessages()
 	{
 		return GetMessagesWithLevel(LogLevel::Debug);
 	}
-	std::vector<ConsoleMessage> VirtualConsole::GetWarnMessages()
+	ConsoleMessageView VirtualConsole::GetWarnMessages()
 	{
 		return GetMessagesWithLevel(LogLevel::Warn);
 	}
-	std::vector<ConsoleMessage> VirtualConsole::GetErrorMessages()
+	ConsoleMessageView VirtualConsole::GetErrorMessages()
 	{
 		return GetMessagesWithLevel(LogLevel::Error);
 	}
+	const VirtualConsoleStats& VirtualConsole::GetStats()
+	{
+		return s_Stats;
+	}
 
 	void VirtualConsole::PushMessage(ConsoleMessage msg)
 	{
-		while (StringUtil::ReplaceSequence(msg.m_Message, "\r", ""));
-		m_Messages.push_back(msg);
+		static_assert((s_MaxPendingMessages & (s_MaxPendingMessages - 1)) == 0, "The positions have to wrap around with the slots");
+		msg.m_Message.erase(std::remove(msg.m_Message.begin(), msg.m_Message.end(), '\r'), msg.m_Message.end());
+
+		uint64_t position = s_PendingTail.load(std::memory_order_relaxed);
+		while (true)
+		{
+			PendingSlot& slot = s_PendingSlots[position % s_MaxPendingMessages];
+			const uint64_t turn = position / s_MaxPendingMessages * 2;
+			const uint64_t slotTurn = slot.Turn.load(std::memory_order_acquire);
+			if (slotTurn == turn)
+			{
+				if (s_PendingTail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+				{
+					slot.Message.emplace(std::move(msg));
+					slot.Turn.store(turn + 1, std::memory_order_release);
+					return;
+				}
+			}
+			else if (slotTurn < turn)
+			{
+				// The slot still holds the message of the previous lap, the console was not ticked for a while
+				s_DroppedMessages.fetch_add(1, std::memory_order_relaxed);
+				return;
+			}
+			else
+			{
+				// Another thread claimed this position first
+				position = s_PendingTail.load(std::memory_order_relaxed);
+			}
+		}
 	}
 	void VirtualConsole::IssueCommand(const String& cmd)
 	{
 		SuoraError("Command: {0}", cmd);
 	}
-}
\ No newline at end of file
+}
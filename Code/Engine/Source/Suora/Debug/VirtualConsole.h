@@ -1,4 +1,8 @@
 #pragma once
+#include <atomic>
+#include <chrono>
+#include <optional>
+#include <span>
 #include <vector>
 #include "Suora/Common/StringUtils.h"
 #include <cstdint>
@@ -23,24 +27,112 @@ namespace Suora
 		const char* m_CallerPath = nullptr;
 		const char* m_CallerFunction = nullptr;
 		int32_t m_CallerLine = 0;
+
+		/** Identical messages in a row are collapsed into one, this counts them */
+		uint32_t m_Count = 1;
+	};
+
+	/** Messages of the VirtualConsole, oldest first. Reads straight from the ring buffer instead of copying,
+	 *  so a view is only valid until the next VirtualConsole::Tick() or Clear(). */
+	class ConsoleMessageView
+	{
+	public:
+		ConsoleMessageView() = default;
+		/** All messages from firstSequence on */
+		ConsoleMessageView(std::span<const ConsoleMessage> ring, uint64_t firstSequence, size_t count);
+		/** The messages with the given sequence numbers, an index ring may wrap around and consist of two spans */
+		ConsoleMessageView(std::span<const ConsoleMessage> ring, std::span<const uint64_t> first, std::span<const uint64_t> second);
+
+		size_t Size() const { return m_Count; }
+		bool IsEmpty() const { return m_Count == 0; }
+		const ConsoleMessage& operator[](size_t index) const;
+
+	private:
+		std::span<const ConsoleMessage> m_Ring;
+		std::span<const uint64_t> m_Sequences[2];
+		uint64_t m_FirstSequence = 0;
+		size_t m_Count = 0;
+		bool m_IsFiltered = false;
 	};
 
+	struct VirtualConsoleStats
+	{
+		uint64_t PushedMessages = 0;
+		/** Messages that were merged into the previous one */
+		uint64_t CollapsedMessages = 0;
+		/** Messages that were overwritten, because the ring buffer was full */
+		uint64_t OverwrittenMessages = 0;
+		/** Messages that never made it into the ring buffer, because nobody ticked the console */
+		uint64_t DroppedMessages = 0;
+		float MessagesPerSecond = 0.0f;
+		float PeakMessagesPerSecond = 0.0f;
+	};
+
+	/** Sequence numbers of the messages of one level or category, in a ring of its own */
+	struct ConsoleMessageIndex
+	{
+		/** Allocated with VirtualConsole::s_Capacity entries on the first push */
+		std::vector<uint64_t> Sequences;
+		uint32_t Head = 0;
+		uint32_t Size = 0;
+
+		void Push(uint64_t sequence);
+		void PopFront(uint64_t sequence);
+		ConsoleMessageView View() const;
+	};
+
+	/* Any thread can push messages without taking a lock: they claim a slot in a preallocated queue and are moved into
+	 * a fixed-capacity ring buffer by Tick() on the main thread. Reading (Get*Messages) is main thread only. */
 	struct VirtualConsole
 	{
-		inline static std::vector<ConsoleMessage> m_Messages;
-		inline static uint64_t m_MaxMessageCount = 250;
+		static constexpr uint32_t s_Capacity = 1024;
+		/** Slots of the pending queue, pushing fails while all of them are taken. Has to be a power of two. */
+		static constexpr uint32_t s_MaxPendingMessages = 4 * s_Capacity;
 
 		static void Tick();
 		static void Clear();
-		static std::vector<ConsoleMessage> GetMessagesWithLevel(LogLevel level);
-		static std::vector<ConsoleMessage> GetLogMessages();
-		static std::vector<ConsoleMessage> GetDebugMessages();
-		static std::vector<ConsoleMessage> GetWarnMessages();
-		static std::vector<ConsoleMessage> GetErrorMessages();
+		static ConsoleMessageView GetMessages();
+		static ConsoleMessageView GetMessagesWithLevel(LogLevel level);
+		static ConsoleMessageView GetMessagesWithCategory(LogCategory category);
+		static ConsoleMessageView GetLogMessages();
+		static ConsoleMessageView GetDebugMessages();
+		static ConsoleMessageView GetWarnMessages();
+		static ConsoleMessageView GetErrorMessages();
 		static void PushMessage(ConsoleMessage msg);
+		static const VirtualConsoleStats& GetStats();
 
 		static void IssueCommand(const String& cmd);
 
+		inline static bool s_CollapseDuplicates = true;
+
+	private:
+		/** Turn is even while the slot is free for the lap Turn / 2, and odd once that lap's message is written.
+		 *  Zero-initialized slots are free, so pushing works before any static constructor ran. */
+		struct PendingSlot
+		{
+			std::atomic<uint64_t> Turn;
+			std::optional<ConsoleMessage> Message;
+		};
+		friend struct ConsoleMessageIndex;
+		static constexpr uint32_t s_LevelCount = (uint32_t)LogLevel::Critical + 1;
+
+		static void AddMessage(ConsoleMessage&& msg);
+		static ConsoleMessageIndex& GetCategoryIndex(LogCategory category);
+
+		inline static PendingSlot s_PendingSlots[s_MaxPendingMessages];
+		inline static std::atomic<uint64_t> s_PendingTail = 0;
+		inline static uint64_t s_PendingHead = 0;
+		inline static std::atomic<uint64_t> s_DroppedMessages = 0;
+
+		inline static std::vector<ConsoleMessage> s_Messages;
+		inline static uint64_t s_FirstSequence = 0;
+		inline static uint64_t s_NextSequence = 0;
+		inline static ConsoleMessageIndex s_LevelIndices[s_LevelCount];
+		inline static std::vector<ConsoleMessageIndex> s_CategoryIndices;
+
+		inline static VirtualConsoleStats s_Stats;
+		inline static uint64_t s_MessagesInRateWindow = 0;
+		inline static std::chrono::steady_clock::time_point s_RateWindowBegin = std::chrono::steady_clock::now();
 	};
 
-}
\ No newline at end of file
+}
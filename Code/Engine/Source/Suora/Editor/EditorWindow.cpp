@@ -11,8 +11,10 @@
 #include "Panels/MinorTab.h"
 #include "Panels/DockspacePanel.h"
 #include "Panels/Minor/EditorConsolePanel.h"
+#include "Panels/Minor/FrameProfilerPanel.h"
 #include "Panels/Major/NodeClassEditor.h"
 #include "Panels/Major/ShaderGraphEditorPanel.h"
+#include "Suora/Debug/Profiler.h"
 #include "Suora/Debug/VirtualConsole.h"
 #include "Util/EditorPreferences.h"
 #include "Util/Icon.h"
@@ -59,6 +61,8 @@ namespace Suora
 		m_PrivateMajorTab->m_EditorWindow = this;
 		m_HeroTools.Add(Ref<MinorTab>(new ContentBrowser(m_PrivateMajorTab.get())));
 		m_HeroTools.Add(Ref<MinorTab>(new EditorConsolePanel(m_PrivateMajorTab.get())));
+		m_FrameProfilerHeroTool = (uint32_t)m_HeroTools.Size();
+		m_HeroTools.Add(Ref<MinorTab>(new FrameProfilerPanel(m_PrivateMajorTab.get())));
 	}
 
 	EditorWindow::~EditorWindow()
@@ -68,6 +72,7 @@ namespace Suora
 
 	void EditorWindow::Update(float deltaTime)
 	{
+		SUORA_PROFILE_SCOPE("EditorWindow::Update");
 		GraphicsContext* context = (GraphicsContext*)(m_Window->GetGraphicsContext());
 		context->MakeCurrent();
 
@@ -392,9 +397,9 @@ namespace Suora
 					}
 					m_SelectedHeroTool = 1;
 				}
-				m_ConsoleDebugs = VirtualConsole::GetDebugMessages().size();
-				m_ConsoleWarnings = VirtualConsole::GetWarnMessages().size();
-				m_ConsoleErrors = VirtualConsole::GetErrorMessages().size();
+				m_ConsoleDebugs = VirtualConsole::GetDebugMessages().Size();
+				m_ConsoleWarnings = VirtualConsole::GetWarnMessages().Size();
+				m_ConsoleErrors = VirtualConsole::GetErrorMessages().Size();
 				const String textErrors = m_ConsoleErrors >= 10 ? std::to_string(m_ConsoleErrors) : "0" + std::to_string(m_ConsoleErrors);
 				const Color colorErrors = m_ConsoleErrors > 0 ? Color(0.6745098f, 0.2078431f, 0.2745098f, 1) : EditorPreferences::Get()->UiBackgroundColor * 0.5f;
 				EditorUI::Text(textErrors, Font::Instance, 150.0f * ui + 10.0f * ui, 3.0f, 25.0f * ui, 9.0f * ui, 18.0f, Vec2(), colorErrors);
@@ -411,9 +416,21 @@ namespace Suora
 				EditorUI::DrawTexturedRect(Icon::Bug, 150.0f * ui + 73.5f * ui, 13.0f * ui, 18.0f * ui, 18.0f * ui, 0, colorDebugs);
 			}
 
+			EditorUI::ButtonParams StatsParams = SideBarParams;
 			SideBarParams.ButtonColorHover = SideBarParams.ButtonColor;
 			SideBarParams.HoverCursor = Cursor::Default;
 			EditorUI::Button("", x, 0.0f, m_Window->GetWidth() - x, 35.0f * ui, SideBarParams);
+
+			// Profiler, opened through the Stats
+			StatsParams.TooltipText = "Frame Profiler";
+			if (EditorUI::Button("", m_Window->GetWidth() - 170.0f * ui, 0.0f, 170.0f * ui, 35.0f * ui, StatsParams))
+			{
+				if (!(m_HeroToolOpened && m_SelectedHeroTool != m_FrameProfilerHeroTool))
+				{
+					m_HeroToolOpened = !m_HeroToolOpened;
+				}
+				m_SelectedHeroTool = m_FrameProfilerHeroTool;
+			}
 		}
 
 		// Draw HeroTool
@@ -83,6 +83,7 @@ namespace Suora
 		float m_HeroToolHeight = 0.0f;
 		Array<Ref<MinorTab>> m_HeroTools;
 		uint32_t m_SelectedHeroTool = 0;
+		uint32_t m_FrameProfilerHeroTool = 0;
 
 		uint32_t m_ConsoleDebugs = 0;
 		uint32_t m_ConsoleWarnings = 0;
@@ -255,6 +255,7 @@ namespace Suora
 **/obj/\n\
 **/Build/\n\
 **/Scripts/\n\
+**/Cache/\n\
 \n\
 # Suora files\n\
 *.log\n\
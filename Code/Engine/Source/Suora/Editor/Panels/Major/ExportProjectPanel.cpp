@@ -1,6 +1,8 @@
 #include "Precompiled.h"
 #include "ExportProjectPanel.h"
 #include "Suora/Assets/AssetManager.h"
+#include "Suora/Assets/AssetCooker.h"
+#include "Suora/Assets/VirtualFileSystem.h"
 #include "Suora/Platform/Platform.h"
 
 #include <chrono>
@@ -69,8 +71,29 @@ namespace Suora
 		}
 	}
 
+	static void CookContent(ExportSettings* settings)
+	{
+		Platform::CreateDirectory(settings->m_OutputPath / "Content");
+
+		AssetCookSettings cookSettings;
+		cookSettings.OutputPath = settings->m_OutputPath / "Content" / VirtualFileSystem::s_ContentPackageName;
+		cookSettings.Compression = settings->m_CompressContent ? PackageCompression::LZ4 : PackageCompression::None;
+		cookSettings.StripCookedSources = settings->m_StripCookedSources;
+
+		if (!AssetCooker::CookPackage(cookSettings))
+		{
+			SUORA_ERROR(Log::CustomCategory("Export"), "Failed to cook the Content!");
+		}
+	}
+
 	static void ExportContent(ExportSettings* settings)
 	{
+		if (settings->m_CookContent)
+		{
+			CookContent(settings);
+			return;
+		}
+
 		Platform::CreateDirectory(settings->m_OutputPath / "Content");
 
 		Platform::CopyDirectory(AssetManager::GetEngineAssetPath(),  settings->m_OutputPath / "Content");
@@ -13,6 +13,12 @@ namespace Suora
 
 		std::filesystem::path m_OutputPath;
 
+		// Content
+		/** Packs only the referenced Assets into a single package, instead of copying all Content */
+		bool m_CookContent = true;
+		bool m_CompressContent = true;
+		bool m_StripCookedSources = true;
+
 		// Platform Windows
 		std::filesystem::path m_MSBuildPath;
 	};
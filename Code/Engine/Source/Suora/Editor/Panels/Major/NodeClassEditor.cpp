@@ -10,6 +10,7 @@
 #include "Suora/Editor/Panels/Minor/LevelOutliner.h"
 #include "Suora/Editor/Panels/Minor/EditorConsolePanel.h"
 #include "Suora/NodeScript/BlueprintNodeGraph.h"
+#include "Suora/Editor/Util/NodeTransaction.h"
 
 #define NODE_ID_EVENT 14
 #define NODE_ID_NATIVE_FUNC 15
@@ -130,6 +131,7 @@ namespace Suora
 		if (m_NodeOutliner)
 		{
 			m_NodeOutliner->m_RootNode = nullptr;
+			m_NodeOutliner->SetModelWorld(nullptr);
 		}
 	}
 
@@ -186,7 +188,7 @@ namespace Suora
 			if (m_SelectedObject->As<Node>()->m_IsActorLayer)
 			{
 				if (m_SelectedObject == m_DetailsPanel->m_Data) m_DetailsPanel->m_Data = nullptr;
-				m_SelectedObject->As<Node>()->Destroy();
+				MakeEditorChange(NodeLifetimeChange::Destroy(m_SelectedObject->As<Node>()));
 				m_SelectedObject = nullptr;
 			}
 		}
@@ -7,6 +7,7 @@
 #include "Suora/Assets/SuoraProject.h"
 #include "Suora/Editor/AssetPreview.h"
 #include "Suora/Editor/Panels/Major/ExportProjectPanel.h"
+#include "Suora/NodeScript/BlueprintNodeGraph.h"
 
 namespace Suora
 {
@@ -17,6 +18,10 @@ namespace Suora
 	}
 	void MajorTab::Update(float deltaTime)
 	{
+		if (NativeInput::GetMouseButtonDown(Mouse::ButtonLeft))
+		{
+			m_UndoInteraction++;
+		}
 		if ((NativeInput::GetKey(Key::LeftControl) || NativeInput::GetKey(Key::RightControl)) && NativeInput::GetKeyDown(Key::S))
 		{
 			SaveAsset();
@@ -28,6 +33,102 @@ namespace Suora
 		m_DockspacePanel.m_PanelHeight = height;
 	}
 
+	void MajorTab::Undo()
+	{
+		if (UndoStackIndex < 0) return;
+
+		m_UndoInteraction++;
+		// Changes may grow or shrink, e.g. by taking a snapshot of what they remove
+		EditorTransaction& change = *UndoStack[UndoStackIndex--];
+		m_UndoMemoryUsage -= change.GetMemorySize();
+		change.Undo();
+		m_UndoMemoryUsage += change.GetMemorySize();
+	}
+
+	void MajorTab::Redo()
+	{
+		if (UndoStackIndex + 1 >= UndoStack.Size()) return;
+
+		m_UndoInteraction++;
+		EditorTransaction& change = *UndoStack[++UndoStackIndex];
+		m_UndoMemoryUsage -= change.GetMemorySize();
+		change.Redo();
+		m_UndoMemoryUsage += change.GetMemorySize();
+	}
+
+	void MajorTab::MakeEditorChange(Ref<EditorTransaction> change)
+	{
+		for (int i = UndoStack.Size() - 1; i > UndoStackIndex; i--)
+		{
+			m_UndoMemoryUsage -= UndoStack[i]->GetMemorySize();
+			UndoStack.RemoveAt(i);
+		}
+
+		// Continuous edits, like dragging a gizmo or a slider, only keep their first and last state
+		if (UndoStackIndex >= 0 && change->m_CoalesceKey != 0)
+		{
+			EditorTransaction& last = *UndoStack[UndoStackIndex];
+			const size_t lastSize = last.GetMemorySize();
+			if (last.m_CoalesceKey == change->m_CoalesceKey && last.m_Interaction == m_UndoInteraction && last.Merge(*change))
+			{
+				m_UndoMemoryUsage = m_UndoMemoryUsage - lastSize + last.GetMemorySize();
+				return;
+			}
+		}
+
+		change->m_MajorTab = this;
+		change->m_Interaction = m_UndoInteraction;
+		UndoStack.Add(change);
+		UndoStackIndex++;
+		m_UndoMemoryUsage += change->GetMemorySize();
+
+		EnforceUndoMemoryBudget();
+	}
+
+	void MajorTab::EnforceUndoMemoryBudget()
+	{
+		if (m_UndoMemoryUsage <= UndoMemoryBudget) return;
+
+		// Compaction: neighbouring entries that were made in different interactions, but change the same thing, become one.
+		// Only applied entries are merged, so the redo history stays untouched.
+		Array<Ref<EditorTransaction>> compacted;
+		int32_t compactedIndex = -1;
+		for (int32_t i = 0; i < UndoStack.Size(); i++)
+		{
+			const Ref<EditorTransaction>& change = UndoStack[i];
+			if (i <= UndoStackIndex && compacted.Size() > 0 && change->m_CoalesceKey != 0)
+			{
+				EditorTransaction& previous = *compacted[compacted.Last()];
+				const size_t previousSize = previous.GetMemorySize();
+				const size_t changeSize = change->GetMemorySize();
+				if (previous.m_CoalesceKey == change->m_CoalesceKey && previous.Merge(*change))
+				{
+					m_UndoMemoryUsage = m_UndoMemoryUsage - previousSize - changeSize + previous.GetMemorySize();
+					continue;
+				}
+			}
+			compacted.Add(change);
+			if (i <= UndoStackIndex)
+			{
+				compactedIndex = compacted.Last();
+			}
+		}
+
+		// Still over budget: forget the oldest applied entries
+		int32_t dropCount = 0;
+		while (m_UndoMemoryUsage > UndoMemoryBudget && dropCount <= compactedIndex)
+		{
+			m_UndoMemoryUsage -= compacted[dropCount++]->GetMemorySize();
+		}
+
+		UndoStack.Clear();
+		for (int32_t i = dropCount; i < compacted.Size(); i++)
+		{
+			UndoStack.Add(compacted[i]);
+		}
+		UndoStackIndex = compactedIndex - dropCount;
+	}
+
 	void MajorTab::DrawToolbar(float& x, float y, float height)
 	{
 		EditorUI::ButtonParams params;
@@ -78,6 +179,7 @@ namespace Suora
 			}
 			editItems.push_back(EditorUI::ContextMenuElement{ {}, [&]() { GetEditorWindow()->OpenAsset(ProjectSettings::Get()); }, "Edit ProjectSettings", nullptr });
 			editItems.push_back(EditorUI::ContextMenuElement{ {}, [&]() { GetEditorWindow()->OpenAsset(EditorPreferences::Get()); }, "Edit EditorPreferences", nullptr });
+			editItems.push_back(EditorUI::ContextMenuElement{ {}, []() { BlueprintCompiler::LogOptimizationReport(); }, "Report Blueprint Bytecode", nullptr });
 			EditorUI::CreateContextMenu(editItems, x + 90, y + height * 0.2f);
 		}
 		if (EditorUI::Button("Window", x + 150, y + height * 0.2f, 80, height * 0.6f))
@@ -52,6 +52,8 @@ namespace Suora
 
 		int UndoStackIndex = -1;
 		Array<Ref<EditorTransaction>> UndoStack;
+		/** Beyond it, the UndoStack is compacted first and then loses its oldest entries */
+		size_t UndoMemoryBudget = 256ull * 1024ull * 1024ull;
 
 		MajorTab() { }
 
@@ -74,34 +76,20 @@ namespace Suora
 			return false;
 		}
 
-		void Undo()
-		{
-			if (UndoStackIndex < 0) return;
-			
-			UndoStack[UndoStackIndex--]->Undo();
-		}
-		void Redo()
-		{
-			if (UndoStackIndex+1 >= UndoStack.Size()) return;
-
-			UndoStack[++UndoStackIndex]->Redo();
-		}
-		void MakeEditorChange(Ref<EditorTransaction> change)
-		{
-
-			for (int i = UndoStack.Size()-1; i >= 0; i--)
-			{
-				if (i > UndoStackIndex) UndoStack.RemoveAt(i);
-			}
-
-			change->m_MajorTab = this;
-			UndoStack.Add(change);
-			UndoStackIndex++;
-		}
+		void Undo();
+		void Redo();
+		/** Records a change that was already applied; coalesces it with the last entry if possible */
+		void MakeEditorChange(Ref<EditorTransaction> change);
+		size_t GetUndoMemoryUsage() const { return m_UndoMemoryUsage; }
 	private:
 		EditorWindow* m_EditorWindow = nullptr;
 
 		void OpenExportProjectTab();
+		void EnforceUndoMemoryBudget();
+
+		size_t m_UndoMemoryUsage = 0;
+		/** Incremented by every click, Undo and Redo, so that coalescing never spans two interactions */
+		uint64_t m_UndoInteraction = 0;
 
 	protected:
 		Class m_AssetClass = Class::None;
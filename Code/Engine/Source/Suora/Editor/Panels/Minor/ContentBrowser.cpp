@@ -45,18 +45,15 @@ namespace Suora
 			s_BrowseToAsset = nullptr;
 		}
 
-		Array<Asset*> assets = AssetManager::GetAssets<Asset>();
-		Array<Folder> folders;
-		const Vec2 size = Vec2(96, 144) * EditorPreferences::Get()->UiScale * m_ScaleBrowser;
-
-		for (auto file : std::filesystem::directory_iterator(m_CurrentPath))
+		if (m_CachedPath != m_CurrentPath || (m_DirectoryWatcher && !m_DirectoryWatcher->PollEvents().IsEmpty()))
 		{
-			if (file.is_directory())
-			{
-				folders.Add(Folder{file.path().filename().string(), file.path().string()});
-			}
+			RefreshCurrentDirectory();
 		}
 
+		Array<Asset*> assets = AssetManager::GetAssets<Asset>();
+		Array<Folder>& folders = m_CachedFolders;
+		const Vec2 size = Vec2(96, 144) * EditorPreferences::Get()->UiScale * m_ScaleBrowser;
+
 		float x = 15, y = GetHeight() - size.y - 15 - 30 + m_ScrollY;
 		bool rightClickPossible = true;
 		int index = 0;
@@ -146,6 +143,24 @@ namespace Suora
 		EditorUI::ScrollbarVertical(GetWidth() - 10, 0, 10, GetHeight(), 0, 0, GetWidth(), GetHeight(), 0, scrollDown > 0 ? 0 : Math::Abs(scrollDown), &m_ScrollY);
 	}
 
+	void ContentBrowser::RefreshCurrentDirectory()
+	{
+		if (m_CachedPath != m_CurrentPath)
+		{
+			m_CachedPath = m_CurrentPath;
+			m_DirectoryWatcher = CreateRef<FileWatcher>(m_CurrentPath, false);
+		}
+
+		m_CachedFolders.Clear();
+		for (auto file : std::filesystem::directory_iterator(m_CurrentPath))
+		{
+			if (file.is_directory())
+			{
+				m_CachedFolders.Add(Folder{file.path().filename().string(), file.path().string()});
+			}
+		}
+	}
+
 	void ContentBrowser::DrawFolder(Folder& folder, float& x, float& y, int& index, const Vec2& size, bool& rightClickPossible)
 	{
 		static bool Hover = false;
@@ -1,6 +1,7 @@
 #pragma once
 #include "Suora/Assets/AssetManager.h"
 #include "Suora/Editor/Panels/MinorTab.h"
+#include "Suora/Platform/FileWatcher.h"
 
 namespace Suora
 {
@@ -25,6 +26,7 @@ namespace Suora
 		void DrawAsset(Asset* asset, float& x, float& y, int& index, const Vec2& size, bool& rightClickPossible);
 		void DrawContentPaths();
 		void OpenAsset(Asset* asset);
+		void RefreshCurrentDirectory();
 
 		bool ProcessElementClick(int i, Asset* selectAsset);
 
@@ -43,6 +45,10 @@ namespace Suora
 		Ref<Texture> m_ShadowTexture = Texture::Create(AssetManager::GetEngineAssetPath() + "/EditorContent/Textures/AssetEntryShadow.png");
 		Ref<Texture> m_ArrowRight = Texture::Create(AssetManager::GetEngineAssetPath() + "/EditorContent/Icons/ArrowRight.png");
 		String m_CurrentPath = AssetManager::GetEngineAssetPath();
+		// The current directory is only iterated again, once the FileWatcher reports changes
+		String m_CachedPath;
+		Array<Folder> m_CachedFolders;
+		Ref<FileWatcher> m_DirectoryWatcher;
 		PathMode m_CurrentMode = PathMode::ProjectPath;
 		float m_ScrollY = 0.0f;
 
@@ -31,6 +31,16 @@ namespace Suora
 			}
 		}
 		y -= 35.0f;
+		if (EditorUI::CategoryShutter(2, "Content", 0, y, GetDetailWidth(), 35.0f, ShutterPanelParams()))
+		{
+			DrawBool(&settings->m_CookContent, "Cook Content", y, false);
+			if (settings->m_CookContent)
+			{
+				DrawBool(&settings->m_CompressContent, "Compress Package", y, false);
+				DrawBool(&settings->m_StripCookedSources, "Strip Cooked Sources", y, false);
+			}
+		}
+		y -= 35.0f;
 		if (EditorUI::CategoryShutter(1, "Platform Windows", 0, y, GetDetailWidth(), 35.0f, ShutterPanelParams()))
 		{
 			y -= 34.0f;
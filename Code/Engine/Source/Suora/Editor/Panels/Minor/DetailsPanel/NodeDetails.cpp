@@ -4,6 +4,7 @@
 #include "Suora/Assets/Texture2D.h"
 #include "Suora/GameFramework/Node.h"
 #include "Suora/Editor/Panels/Major/NodeClassEditor.h"
+#include "Suora/Editor/Util/NodeTransaction.h"
 
 namespace Suora
 {
@@ -46,7 +47,15 @@ namespace Suora
 		EditorUI::DrawTexturedRect(EditorUI::GetClassIcon(node->GetClass())->GetTexture(), 5.0f, y + 5.0f, 30.0f, 30.0f, 0.0f, Color(1));
 		EditorUI::Button("", 40.0f, y, GetDetailWidth() - 80.0f, 40.0f, ShutterPanelParams());
 		EditorUI::TextField(&node->m_Name, 45.0f, y + 7.5f, (GetDetailWidth() - 40.0f) / 2.0f, 25.0f);
-		node->SetName(node->GetName());
+		// The TextField edits m_Name in place, the edit is reapplied through SetName(), so the World journals the rename
+		if (Name_LastNode == node && node->m_Name != Name_LastName)
+		{
+			const String name = node->m_Name;
+			node->m_Name = Name_LastName;
+			node->SetName(name);
+		}
+		Name_LastNode = node;
+		Name_LastName = node->m_Name;
 		EditorUI::Button("", GetDetailWidth() - 40.0f, y, 40.0f, 40.0f, ShutterPanelParams());
 		EditorUI::Checkbox(&node->m_Enabled, GetDetailWidth() - 40.0f + 7.5f, y + 7.5f, 25.0f, 25.0f);
 		y -= 10;
@@ -131,8 +140,10 @@ namespace Suora
 
 		// Node Derivates
 		Array<Class> derivates = node->GetClass().GetInheritanceTree();
-		int memberIndex = 0;
-		for (int64_t i = skipFirstDerivative ? 3 : 2; i < derivates.Size(); i++)
+		// memberIndex is the PropertyIndex of the member, which also counts the properties of the skipped Classes
+		const int64_t firstDerivative = skipFirstDerivative ? 3 : 2;
+		int memberIndex = (derivates.Size() > firstDerivative) ? ClassReflector::GetByClass(derivates[firstDerivative - 1]).GetAllClassMemberProperties().Size() : 0;
+		for (int64_t i = firstDerivative; i < derivates.Size(); i++)
 		{
 			if (!derivates[i].IsNative())
 			{
@@ -166,6 +177,7 @@ namespace Suora
 		const auto type = member->m_Property->GetType();
 		const auto mname = member->m_MemberName;
 		const bool valueChangedBefore = obj->m_OverwrittenProperties.Contains(mname);
+		const NodePropertyValue valueBefore = NodePropertyValue::Read(obj, *member);
 		DetailsPanel::Result result = DetailsPanel::Result::None;
 
 		if (type == PropertyType::Int32)
@@ -230,6 +242,7 @@ namespace Suora
 		if (result == DetailsPanel::Result::ValueReset)
 		{
 			obj->ResetProperty(*member);
+			obj->MarkPropertyDirty(memberIndex);
 		}
 		else if (result == DetailsPanel::Result::ValueChange)
 		{
@@ -237,6 +250,12 @@ namespace Suora
 			{
 				obj->m_OverwrittenProperties.Add(mname);
 			}
+			obj->MarkPropertyDirty(memberIndex);
+		}
+
+		if ((result == DetailsPanel::Result::ValueReset || result == DetailsPanel::Result::ValueChange) && type != PropertyType::Delegate && GetMajorTab())
+		{
+			GetMajorTab()->MakeEditorChange(CreateRef<NodePropertyChange>(obj, *member, (uint32_t)memberIndex, valueBefore, valueChangedBefore));
 		}
 	}
 
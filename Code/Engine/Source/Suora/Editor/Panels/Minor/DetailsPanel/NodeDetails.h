@@ -21,6 +21,10 @@ namespace Suora
 		Vec3 Transform_Pos = Vec::Zero;
 		Vec3 Transform_Rot = Vec::Zero;
 		Vec3 Transform_Scale = Vec::One;
+
+		// Name Util
+		void* Name_LastNode = nullptr;
+		String Name_LastName;
 	};
 
 }
\ No newline at end of file
@@ -35,6 +35,47 @@ namespace Suora
 		{
 			DrawAsset((Asset**)&(settings->m_EditorStartupAsset), Asset::StaticClass(), "Editor Startup Asset", y, false);
 		}
+		y -= 35.0f;
+		if (EditorUI::CategoryShutter(3, "Streaming", 0, y, GetDetailWidth() - 100.0f, 35.0f, ShutterPanelParams()))
+		{
+			bool budgetChanged = false;
+			budgetChanged |= DrawFloat(&settings->m_StreamingCPUBudgetMB, "CPU Budget (MB)", y, false) == DetailsPanel::Result::ValueChange;
+			budgetChanged |= DrawFloat(&settings->m_StreamingGPUBudgetMB, "GPU Budget (MB)", y, false) == DetailsPanel::Result::ValueChange;
+			if (budgetChanged)
+			{
+				settings->ApplyStreamingBudget();
+			}
+		}
+		y -= 35.0f;
+		if (EditorUI::CategoryShutter(4, "Physics", 0, y, GetDetailWidth() - 100.0f, 35.0f, ShutterPanelParams()))
+		{
+			// One row per layer, the columns are the layers it collides with
+			constexpr uint32_t layerCount = Physics::CollisionMatrix::s_LayerCount;
+			const float x = GetDetailWidth() * GetSeperator() + 5.0f;
+			const float cellSize = glm::min(25.0f, (GetDetailWidth() * (1.0f - GetSeperator()) - 10.0f) / layerCount);
+			bool matrixChanged = false;
+
+			for (uint32_t i = 0; i < layerCount; i++)
+			{
+				y -= cellSize + 4.0f;
+				DrawLabel("Layer " + std::to_string(i), y, cellSize + 5.0f);
+				for (uint32_t j = 0; j < layerCount; j++)
+				{
+					bool collide = (settings->m_CollisionMatrix[i] & (1u << j)) != 0;
+					if (EditorUI::Checkbox(&collide, x + j * cellSize, y + 2.0f, cellSize - 2.0f, cellSize - 2.0f))
+					{
+						const uint32_t bitJ = 1u << j, bitI = 1u << i;
+						settings->m_CollisionMatrix[i] = collide ? (settings->m_CollisionMatrix[i] | bitJ) : (settings->m_CollisionMatrix[i] & ~bitJ);
+						settings->m_CollisionMatrix[j] = collide ? (settings->m_CollisionMatrix[j] | bitI) : (settings->m_CollisionMatrix[j] & ~bitI);
+						matrixChanged = true;
+					}
+				}
+			}
+			if (matrixChanged)
+			{
+				settings->ApplyCollisionMatrix();
+			}
+		}
 
 	}
 
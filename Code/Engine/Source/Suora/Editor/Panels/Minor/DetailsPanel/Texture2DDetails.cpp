@@ -2,6 +2,7 @@
 #include "Texture2DDetails.h"
 
 #include "Suora/Assets/Texture2D.h"
+#include "Suora/Renderer/Texture.h"
 
 namespace Suora
 {
@@ -16,7 +17,36 @@ namespace Suora
 
 	void Texture2DDetails::ViewTexture2D(float& y, Texture2D* texture)
 	{
+		y -= 35.0f;
+		if (EditorUI::CategoryShutter(0, "Texture", 0, y, GetDetailWidth(), 35.0f, ShutterPanelParams()))
+		{
+			const bool generateMips = texture->m_GenerateMips, isNormalMap = texture->m_IsNormalMap, isSRGB = texture->m_IsSRGB;
+
+			static const std::pair<String, ETextureCompression> compressions[] =
+			{
+				{ "Auto", ETextureCompression::Auto }, { "None", ETextureCompression::None }, { "BC1", ETextureCompression::BC1 },
+				{ "BC3", ETextureCompression::BC3 }, { "BC5", ETextureCompression::BC5 }, { "BC7", ETextureCompression::BC7 }
+			};
+			int index = 0;
+			std::vector<std::pair<String, std::function<void(void)>>> options;
+			for (int i = 0; i < sizeof(compressions) / sizeof(compressions[0]); i++)
+			{
+				if (compressions[i].second == texture->m_Compression) index = i;
+				const ETextureCompression value = compressions[i].second;
+				options.push_back({ compressions[i].first, [texture, value]() { if (texture->m_Compression != value) { texture->m_Compression = value; texture->ReloadAsset(); } } });
+			}
+			DrawDropDown("Compression", options, index, y);
+			DrawBool(&texture->m_GenerateMips, "Generate Mips", y, false);
+			DrawBool(&texture->m_IsNormalMap, "Normal Map", y, false);
+			DrawBool(&texture->m_IsSRGB, "sRGB", y, false);
+			y -= 20;
 
+			// The cooked Texture is rebuilt with the new settings
+			if (generateMips != texture->m_GenerateMips || isNormalMap != texture->m_IsNormalMap || isSRGB != texture->m_IsSRGB)
+			{
+				texture->ReloadAsset();
+			}
+		}
 	}
 
 }
\ No newline at end of file
@@ -28,9 +28,10 @@ namespace Suora
 		const float LineHeight = 20.0f * EditorPreferences::Get()->UiScale;
 		float y = 0.0f + m_ScrollY;// GetHeight() - LineHeight + m_ScrollY;
 
-		for (int32_t i = VirtualConsole::m_Messages.size() - 1; i >= 0; i--)
+		const ConsoleMessageView messages = VirtualConsole::GetMessages();
+		for (int32_t i = (int32_t)messages.Size() - 1; i >= 0; i--)
 		{
-			auto& It = VirtualConsole::m_Messages[i];
+			const ConsoleMessage& It = messages[i];
 			if (y < GetHeight() && y > -200.0f)
 			{
 				Params.ButtonColor = i % 2 == 0 ? EditorPreferences::Get()->UiBackgroundColor : Math::Lerp(EditorPreferences::Get()->UiBackgroundColor, EditorPreferences::Get()->UiForgroundColor, 0.3f);
@@ -65,7 +66,7 @@ namespace Suora
 					Params.TextColor = Color(0.33725f, 0.25294f, 0.594117f, 1);
 				}
 
-				EditorUI::Button(It.m_Message, 20.0f, y, GetWidth() - 50.0f, LineHeight-1.0f, Params);
+				EditorUI::Button(It.m_Count > 1 ? It.m_Message + "  (x" + std::to_string(It.m_Count) + ")" : It.m_Message, 20.0f, y, GetWidth() - 50.0f, LineHeight-1.0f, Params);
 				EditorUI::DrawTexturedRect(EditorConsolePanel::GetLogLevelIcon(It.m_Level), 8.0f, y + 2.0f, LineHeight - 4.0f, LineHeight - 4.0f, 0.0f, Params.TextColor * Color(1, 1, 1, 0.5f));
 			}
 
@@ -0,0 +1,259 @@
+#include "Precompiled.h"
+#include "FrameProfilerPanel.h"
+#include <algorithm>
+#include "Suora/Assets/AssetManager.h"
+#include "Suora/Debug/Profiler.h"
+#include "Suora/Editor/Util/EditorPreferences.h"
+
+namespace Suora
+{
+	static constexpr float s_TargetFrameMs = 1000.0f / 60.0f;
+
+	static Color GetZoneColor(const char* name)
+	{
+		static const Color palette[] =
+		{
+			Color(0.33725f, 0.55294f, 0.76412f, 1.0f),
+			Color(0.33725f, 0.60294f, 0.29412f, 1.0f),
+			Color(0.80784f, 0.65098f, 0.27058f, 1.0f),
+			Color(0.67451f, 0.36078f, 0.27451f, 1.0f),
+			Color(0.55294f, 0.40392f, 0.72941f, 1.0f),
+			Color(0.27058f, 0.65098f, 0.64705f, 1.0f),
+			Color(0.72941f, 0.40392f, 0.55294f, 1.0f),
+			Color(0.52549f, 0.56078f, 0.30588f, 1.0f)
+		};
+		const size_t hash = std::hash<std::string_view>()(name ? name : "");
+		return palette[hash % (sizeof(palette) / sizeof(palette[0]))];
+	}
+
+	FrameProfilerPanel::FrameProfilerPanel(MajorTab* majorTab)
+		: MinorTab(majorTab)
+	{
+		Name = "Profiler";
+	}
+
+	void FrameProfilerPanel::Render(float deltaTime)
+	{
+		const float ui = EditorPreferences::Get()->UiScale;
+		EditorUI::DrawRect(0, 0, GetWidth(), GetHeight(), 0, EditorPreferences::Get()->UiBackgroundColor);
+
+#ifndef SUORA_ENABLE_PROFILER
+		EditorUI::Text("The Profiler is compiled out of this configuration.", Font::Instance, 0, 0, GetWidth(), GetHeight(), 24.0f, Vec2(0, 0), Color(1));
+		return;
+#endif
+
+		const float toolbarHeight = 30.0f * ui;
+		const float graphHeight = 80.0f * ui;
+		DrawToolbar(GetHeight() - toolbarHeight, toolbarHeight);
+		DrawFrameGraph(GetHeight() - toolbarHeight - graphHeight, graphHeight);
+
+		const std::deque<ProfilerFrame>& frames = Profiler::GetFrames();
+		if (frames.empty())
+		{
+			EditorUI::Text(Profiler::IsEnabled() ? "Waiting for frames..." : "Profiling is disabled.", Font::Instance, 0, 0, GetWidth(), GetHeight() - toolbarHeight - graphHeight, 24.0f, Vec2(0, 0), Color(1));
+			return;
+		}
+
+		const ProfilerFrame* frame = &frames.back();
+		if (m_HasSelection)
+		{
+			auto it = std::find_if(frames.begin(), frames.end(), [this](const ProfilerFrame& it) { return it.Index == m_SelectedFrame; });
+			if (it != frames.end()) frame = &*it;
+		}
+
+		const float countersWidth = 250.0f * ui;
+		DrawTimeline(*frame, GetWidth() - countersWidth, GetHeight() - toolbarHeight - graphHeight);
+		DrawCounters(*frame, GetWidth() - countersWidth, countersWidth, GetHeight() - toolbarHeight - graphHeight);
+	}
+
+	void FrameProfilerPanel::DrawToolbar(float y, float height)
+	{
+		const float ui = EditorPreferences::Get()->UiScale;
+
+		EditorUI::ButtonParams PanelParams;
+		PanelParams.ButtonColor = EditorPreferences::Get()->UiForgroundColor;
+		PanelParams.ButtonColorHover = PanelParams.ButtonColor;
+		PanelParams.ButtonRoundness = 0;
+		PanelParams.HoverCursor = Cursor::Default;
+		EditorUI::Button("", 0, y, GetWidth(), height, PanelParams);
+
+		EditorUI::ButtonParams Params;
+		Params.TextSize = 20.0f;
+		float x = 5.0f * ui;
+		auto button = [&](const String& text, float width, const String& tooltip)
+		{
+			Params.TooltipText = tooltip;
+			const bool clicked = EditorUI::Button(text, x, y + 3.0f * ui, width * ui, height - 6.0f * ui, Params);
+			x += (width + 5.0f) * ui;
+			return clicked;
+		};
+
+		if (button(Profiler::IsPaused() ? "Resume" : "Pause", 80.0f, "Paused frames are still collected, but not added to the history"))
+		{
+			Profiler::SetPaused(!Profiler::IsPaused());
+			if (!Profiler::IsPaused()) m_HasSelection = false;
+		}
+		if (button(Profiler::IsEnabled() ? "Profiling: On" : "Profiling: Off", 120.0f, "Disabled zones still cost a branch; compiled out ones cost nothing"))
+		{
+			Profiler::SetEnabled(!Profiler::IsEnabled());
+		}
+		if (button(Profiler::IsGPUTimingEnabled() ? "GPU Timing: On" : "GPU Timing: Off", 130.0f, "Times the render passes with GPU timer queries"))
+		{
+			Profiler::SetGPUTimingEnabled(!Profiler::IsGPUTimingEnabled());
+		}
+		if (button("Export Trace", 110.0f, "Writes the history as Chrome trace JSON, for chrome://tracing or Perfetto"))
+		{
+			ExportTrace();
+		}
+
+		const ProfilerStats stats = Profiler::GetStats();
+		const String text = "Zone: " + StringUtil::FloatToString(stats.ZoneCostNs, 1) + " ns (disabled: " + StringUtil::FloatToString(stats.DisabledZoneCostNs, 1) + " ns)"
+			+ "   Collect: " + StringUtil::FloatToString(stats.CollectTimeMs) + " ms"
+			+ "   Dropped: " + std::to_string(stats.DroppedZones);
+		EditorUI::Text(text, Font::Instance, x, y, GetWidth() - x - 10.0f * ui, height, 20.0f, Vec2(1, 0), Color(1));
+	}
+
+	void FrameProfilerPanel::DrawFrameGraph(float y, float height)
+	{
+		const float ui = EditorPreferences::Get()->UiScale;
+		const std::deque<ProfilerFrame>& frames = Profiler::GetFrames();
+
+		EditorUI::DrawRect(0, y, GetWidth(), height, 0, EditorPreferences::Get()->UiBackgroundColor * 0.8f);
+
+		// Twice the target frame time fills the graph, longer frames are cut off
+		const float scaleMs = s_TargetFrameMs * 2.0f;
+		const float barWidth = (float)GetWidth() / std::max<uint32_t>(Profiler::s_MaxFrames, 1);
+		float x = GetWidth() - barWidth * frames.size();
+
+		EditorUI::ButtonParams Params = EditorUI::ButtonParams::Invisible();
+		Params.ButtonRoundness = 0;
+		Params.ButtonColorHover = Color(1.0f, 1.0f, 1.0f, 0.1f);
+		for (const ProfilerFrame& frame : frames)
+		{
+			const float ms = frame.GetDurationMs();
+			const bool selected = m_HasSelection && frame.Index == m_SelectedFrame;
+			const Color color = selected ? EditorPreferences::Get()->UiHighlightColor
+				: ms <= s_TargetFrameMs ? Color(0.33725f, 0.60294f, 0.29412f, 1.0f)
+				: ms <= scaleMs ? Color(0.80784f, 0.65098f, 0.27058f, 1.0f)
+				: Color(0.6745098f, 0.2078431f, 0.2745098f, 1.0f);
+			EditorUI::DrawRect(x, y, std::max(barWidth - 1.0f, 1.0f), std::min(ms / scaleMs, 1.0f) * height, 0, color);
+
+			Params.TooltipText = "Frame " + std::to_string(frame.Index) + ": " + StringUtil::FloatToString(ms) + " ms";
+			if (EditorUI::Button("", x, y, barWidth, height, Params))
+			{
+				// The selected frame would leave the history otherwise
+				m_SelectedFrame = frame.Index;
+				m_HasSelection = true;
+				Profiler::SetPaused(true);
+			}
+			x += barWidth;
+		}
+
+		const float targetY = y + s_TargetFrameMs / scaleMs * height;
+		EditorUI::DrawRect(0, targetY, GetWidth(), 1.0f, 0, Color(1.0f, 1.0f, 1.0f, 0.35f));
+		EditorUI::Text("16.6 ms", Font::Instance, 5.0f * ui, targetY, 100.0f * ui, 16.0f * ui, 16.0f, Vec2(-1, 0), Color(1.0f, 1.0f, 1.0f, 0.5f));
+	}
+
+	void FrameProfilerPanel::DrawTimeline(const ProfilerFrame& frame, float width, float height)
+	{
+		const float ui = EditorPreferences::Get()->UiScale;
+		const float headerHeight = 20.0f * ui;
+		const float rowHeight = 18.0f * ui;
+
+		const double durationNs = (double)std::max<uint64_t>(frame.EndNs - frame.BeginNs, 1);
+		auto toX = [&](uint64_t ns)
+		{
+			// Tasks may have started before the frame began
+			const double t = ((double)ns - (double)frame.BeginNs) / durationNs;
+			return (float)std::clamp(t, 0.0, 1.0) * width;
+		};
+
+		EditorUI::ButtonParams Params;
+		Params.ButtonRoundness = 0;
+		Params.ButtonOutlineColor = Color(0.0f, 0.0f, 0.0f, 0.5f);
+		Params.TextOrientation = Vec2(-1, 0);
+		Params.TextOffsetLeft = 3.0f;
+		Params.TextSize = 18.0f;
+		Params.HoverCursor = Cursor::Default;
+
+		float y = height + m_ScrollY;
+		auto drawLane = [&](const String& laneName, const std::vector<ProfileZone>& zones, size_t first, size_t last)
+		{
+			uint32_t maxDepth = 0;
+			for (size_t i = first; i < last; i++) maxDepth = std::max(maxDepth, zones[i].Depth);
+
+			y -= headerHeight;
+			if (y < height && y + headerHeight > 0)
+			{
+				EditorUI::DrawRect(0, y, width, headerHeight, 0, EditorPreferences::Get()->UiForgroundColor);
+				EditorUI::Text(laneName, Font::Instance, 5.0f * ui, y, width, headerHeight, 18.0f, Vec2(-1, 0), Color(1));
+			}
+
+			const float laneTop = y;
+			for (size_t i = first; i < last; i++)
+			{
+				const ProfileZone& zone = zones[i];
+				const float zoneY = laneTop - (zone.Depth + 1) * rowHeight;
+				if (zoneY >= height || zoneY + rowHeight <= 0) continue;
+
+				const float x0 = toX(zone.BeginNs);
+				const float zoneWidth = toX(zone.EndNs) - x0;
+				const Color color = GetZoneColor(zone.Name);
+				if (zoneWidth < 3.0f)
+				{
+					EditorUI::DrawRect(x0, zoneY, std::max(zoneWidth, 1.0f), rowHeight - 1.0f, 0, color);
+					continue;
+				}
+				Params.ButtonColor = color;
+				Params.ButtonColorHover = Math::Lerp(color, Color(1.0f), 0.2f);
+				Params.ButtonColorClicked = Params.ButtonColorHover;
+				Params.TooltipText = String(zone.Name) + "\n" + StringUtil::FloatToString(zone.GetDurationMs(), 4) + " ms";
+				EditorUI::Button(zoneWidth > 40.0f * ui ? zone.Name : "", x0, zoneY, zoneWidth, rowHeight - 1.0f, Params);
+			}
+			y -= (maxDepth + 1) * rowHeight + 4.0f * ui;
+		};
+
+		for (const ProfilerThreadInfo& thread : Profiler::GetThreads())
+		{
+			// The zones are sorted by thread, threads without zones in this frame are skipped
+			auto first = std::find_if(frame.Zones.begin(), frame.Zones.end(), [&](const ProfileZone& it) { return it.ThreadIndex == thread.Index; });
+			if (first == frame.Zones.end()) continue;
+			auto last = std::find_if(first, frame.Zones.end(), [&](const ProfileZone& it) { return it.ThreadIndex != thread.Index; });
+			drawLane(thread.Name, frame.Zones, first - frame.Zones.begin(), last - frame.Zones.begin());
+		}
+		if (!frame.GPUZones.empty())
+		{
+			drawLane("GPU", frame.GPUZones, 0, frame.GPUZones.size());
+		}
+
+		const float scrollDown = (height + m_ScrollY - y) - height;
+		EditorUI::ScrollbarVertical(width - 10.0f, 0, 10.0f, height, 0, 0, width, height, 0, scrollDown < 0 ? 0 : scrollDown, &m_ScrollY);
+	}
+
+	void FrameProfilerPanel::DrawCounters(const ProfilerFrame& frame, float x, float width, float height)
+	{
+		const float ui = EditorPreferences::Get()->UiScale;
+		const float lineHeight = 20.0f * ui;
+
+		EditorUI::DrawRect(x, 0, width, height, 0, EditorPreferences::Get()->UiBackgroundColor * 0.8f);
+
+		float y = height - lineHeight;
+		EditorUI::Text("Frame " + std::to_string(frame.Index) + ": " + StringUtil::FloatToString(frame.GetDurationMs()) + " ms", Font::Instance, x + 5.0f * ui, y, width - 10.0f * ui, lineHeight, 20.0f, Vec2(-1, 0), Color(1));
+		y -= lineHeight;
+		for (const ProfileCounterSample& counter : frame.Counters)
+		{
+			if (y < 0) break;
+			EditorUI::Text(counter.Name, Font::Instance, x + 5.0f * ui, y, width - 10.0f * ui, lineHeight, 18.0f, Vec2(-1, 0), Color(0.8f));
+			EditorUI::Text(std::to_string(counter.Value), Font::Instance, x + 5.0f * ui, y, width - 10.0f * ui, lineHeight, 18.0f, Vec2(1, 0), Color(1));
+			y -= lineHeight;
+		}
+	}
+
+	void FrameProfilerPanel::ExportTrace()
+	{
+		const String assetPath = AssetManager::GetProjectAssetPath().empty() ? AssetManager::GetEngineAssetPath() : AssetManager::GetProjectAssetPath();
+		const uint64_t index = Profiler::GetFrames().empty() ? 0 : Profiler::GetFrames().back().Index;
+		Profiler::ExportChromeTrace(Path(assetPath).parent_path() / "Saved" / "Profiler" / ("Trace_" + std::to_string(index) + ".json"));
+	}
+
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include "Suora/Editor/Panels/MinorTab.h"
+
+namespace Suora
+{
+	struct ProfilerFrame;
+
+	/* Shows the frame history of the Profiler: frame times as a graph, the zones of the selected frame on a timeline
+	 * with one lane per thread, and the counters of that frame. */
+	class FrameProfilerPanel : public MinorTab
+	{
+	public:
+		FrameProfilerPanel(MajorTab* majorTab);
+
+		virtual void Render(float deltaTime) override;
+
+	private:
+		void DrawToolbar(float y, float height);
+		void DrawFrameGraph(float y, float height);
+		void DrawTimeline(const ProfilerFrame& frame, float width, float height);
+		void DrawCounters(const ProfilerFrame& frame, float x, float width, float height);
+		void ExportTrace();
+
+		/** Frame index of the selected frame; the latest frame, if it is not in the history */
+		uint64_t m_SelectedFrame = 0;
+		bool m_HasSelection = false;
+		float m_ScrollY = 0.0f;
+	};
+}
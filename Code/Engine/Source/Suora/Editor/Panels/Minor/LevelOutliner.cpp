@@ -12,35 +12,47 @@
 #include "Suora/GameFramework/Nodes/DecalNode.h"
 #include "Suora/GameFramework/Nodes/OrganizationNodes.h"
 #include "Suora/Editor/Overlays/SelectClassOverlay.h"
+#include "Suora/Editor/Util/NodeTransaction.h"
+#include <unordered_set>
 
 namespace Suora
 {
-	static float scrollY = 0;
 	static float BaseEntryHeight = 20.0f;
 	static float EntryHeight = BaseEntryHeight;
 
-	std::vector<EditorUI::ContextMenuElement> LevelOutliner::CreateNodeMenu(World* world, Node* node)
+	static void RecordSpawn(MajorTab* majorTab, Node* node)
+	{
+		if (majorTab && node)
+		{
+			majorTab->MakeEditorChange(NodeLifetimeChange::Spawn(node));
+		}
+	}
+
+	std::vector<EditorUI::ContextMenuElement> LevelOutliner::CreateNodeMenu(World* world, Node* node, MajorTab* majorTab)
 	{
 		std::vector<EditorUI::ContextMenuElement> out;
 
-		out.push_back(EditorUI::ContextMenuElement{ {}, [world, node]()
+		out.push_back(EditorUI::ContextMenuElement{ {}, [world, node, majorTab]()
 		{
-			EditorUI::CreateOverlay<SelectAnyClassOverlay>(EditorUI::CurrentWindow->GetWindow()->GetWidth() / 2 - 300, EditorUI::CurrentWindow->GetWindow()->GetHeight() / 2 - 400, 600, 800, "Select a Class", Node::StaticClass(), [world, node](const Class& cls)
+			EditorUI::CreateOverlay<SelectAnyClassOverlay>(EditorUI::CurrentWindow->GetWindow()->GetWidth() / 2 - 300, EditorUI::CurrentWindow->GetWindow()->GetHeight() / 2 - 400, 600, 800, "Select a Class", Node::StaticClass(), [world, node, majorTab](const Class& cls)
 			{
 				Node* n = world ? world->Spawn(cls) : node->CreateChild(cls);
+				RecordSpawn(majorTab, n);
 				n->m_IsActorLayer = true;
 			});
 
 		}, "Custom Class", nullptr });
-		out.push_back(EditorUI::ContextMenuElement{ {}, [world, node]()
+		out.push_back(EditorUI::ContextMenuElement{ {}, [world, node, majorTab]()
 		{
 			FolderNode* folder = world ? world->Spawn<FolderNode>() : node->CreateChild<FolderNode>();
+			RecordSpawn(majorTab, folder);
 			folder->SetName("New Folder");
 			folder->m_IsActorLayer = true;
 		}, "Folder", nullptr });
-		out.push_back(EditorUI::ContextMenuElement{ {}, [world, node]()
+		out.push_back(EditorUI::ContextMenuElement{ {}, [world, node, majorTab]()
 		{
 			Node* n = world ? world->Spawn<Node>() : node->CreateChild<Node>();
+			RecordSpawn(majorTab, n);
 			n->SetName("New Node");
 			n->m_IsActorLayer = true;
 		}, "Empty Node", nullptr });
@@ -48,23 +60,26 @@ namespace Suora
 
 		std::vector<EditorUI::ContextMenuElement> _3D;
 		{
-			_3D.push_back(EditorUI::ContextMenuElement{ {}, [world, node]()
+			_3D.push_back(EditorUI::ContextMenuElement{ {}, [world, node, majorTab]()
 			{
 				Node3D* node3D = world ? world->Spawn<Node3D>() : node->CreateChild<Node3D>();
+				RecordSpawn(majorTab, node3D);
 				node3D->SetName("Node3D");
 				node3D->m_IsActorLayer = true;
 			}, "Node3D", nullptr });
-			_3D.push_back(EditorUI::ContextMenuElement{ {}, [world, node]()
+			_3D.push_back(EditorUI::ContextMenuElement{ {}, [world, node, majorTab]()
 			{
 				MeshNode* cube = world ? world->Spawn<MeshNode>() : node->CreateChild<MeshNode>();
+				RecordSpawn(majorTab, cube);
 				cube->SetName("Cube");
 				cube->m_IsActorLayer = true;
 				cube->m_OverwrittenProperties.Add("m_Mesh");
 				cube->SetMesh(AssetManager::GetAsset<Mesh>(SuoraID("33b79a6d-2f4a-40fc-93e5-3f01794c33b8")));
 			}, "Cube", nullptr });
-			_3D.push_back(EditorUI::ContextMenuElement{ {}, [world, node]()
+			_3D.push_back(EditorUI::ContextMenuElement{ {}, [world, node, majorTab]()
 			{
 				MeshNode* sphere = world ? world->Spawn<MeshNode>() : node->CreateChild<MeshNode>();
+				RecordSpawn(majorTab, sphere);
 				sphere->SetName("Sphere");
 				sphere->m_IsActorLayer = true;
 				sphere->m_OverwrittenProperties.Add("m_Mesh");
@@ -75,22 +90,25 @@ namespace Suora
 
 		std::vector<EditorUI::ContextMenuElement> _Lights;
 		{
-			_Lights.push_back(EditorUI::ContextMenuElement{ {}, [world, node]()
+			_Lights.push_back(EditorUI::ContextMenuElement{ {}, [world, node, majorTab]()
 			{
 				SkyLightNode* sky = world ? world->Spawn<SkyLightNode>() : node->CreateChild<SkyLightNode>();
+				RecordSpawn(majorTab, sky);
 				sky->SetName("SkyLightNode");
 				sky->m_IsActorLayer = true;
 			}, "SkyLightNode", nullptr });
-			_Lights.push_back(EditorUI::ContextMenuElement{ {}, [world, node]()
+			_Lights.push_back(EditorUI::ContextMenuElement{ {}, [world, node, majorTab]()
 			{
 				DirectionalLightNode* directionalLightNode = world ? world->Spawn<DirectionalLightNode>() : node->CreateChild<DirectionalLightNode>();
+				RecordSpawn(majorTab, directionalLightNode);
 				directionalLightNode->SetName("DirectionalLightNode");
 				directionalLightNode->SetEulerRotation(Vec3(45.0f, 45.0f, 0.0f));
 				directionalLightNode->m_IsActorLayer = true;
 			}, "DirectionalLightNode", nullptr });
-			_Lights.push_back(EditorUI::ContextMenuElement{ {}, [world, node]()
+			_Lights.push_back(EditorUI::ContextMenuElement{ {}, [world, node, majorTab]()
 			{
 				PointLightNode* pointLight = world ? world->Spawn<PointLightNode>() : node->CreateChild<PointLightNode>();
+				RecordSpawn(majorTab, pointLight);
 				pointLight->SetName("PointLightNode");
 				pointLight->m_IsActorLayer = true;
 			}, "PointLightNode", nullptr });
@@ -99,15 +117,17 @@ namespace Suora
 
 		std::vector<EditorUI::ContextMenuElement> _UI;
 		{
-			_UI.push_back(EditorUI::ContextMenuElement{ {}, [world, node]()
+			_UI.push_back(EditorUI::ContextMenuElement{ {}, [world, node, majorTab]()
 			{
 				UINode* nodeUI = world ? world->Spawn<UINode>() : node->CreateChild<UINode>();
+				RecordSpawn(majorTab, nodeUI);
 				nodeUI->SetName("UINode");
 				nodeUI->m_IsActorLayer = true;
 			}, "UINode", nullptr });
-			_UI.push_back(EditorUI::ContextMenuElement{ {}, [world, node]()
+			_UI.push_back(EditorUI::ContextMenuElement{ {}, [world, node, majorTab]()
 			{
 				UINode* nodeUI = world ? world->Spawn<UIImage>() : node->CreateChild<UIImage>();
+				RecordSpawn(majorTab, nodeUI);
 				nodeUI->SetName("UIImage");
 				nodeUI->m_IsActorLayer = true;
 			}, "UIImage", nullptr });
@@ -131,7 +151,7 @@ namespace Suora
 
 	LevelOutliner::~LevelOutliner()
 	{
-
+		SetModelWorld(nullptr);
 	}
 
 	Texture* LevelOutliner::GetNodeIconTexture(const Class& cls)
@@ -173,9 +193,6 @@ namespace Suora
 	{
 		EditorUI::DrawRect(0, 0, GetWidth(), GetHeight(), 0, Math::Lerp(EditorPreferences::Get()->UiBackgroundColor, EditorPreferences::Get()->UiColor, 0.55f));
 
-		// Reset
-		m_TempYValuesOfParentNodes = std::unordered_map<Node*, float>();
-
 		// Get Level
 		World* level = GetEditorWorld();
 		if (!level) return;
@@ -185,22 +202,44 @@ namespace Suora
 			SetSelectedObject(nullptr);
 		}
 
-		Array<Node*> allNodes = level->GetAllNodes();
+		SyncHierarchy(level);
+		UpdateSearch();
+
+		Node* selection = GetSelectedObject();
+		if (selection != m_LastSelection)
+		{
+			m_LastSelection = selection;
+			if (selection) ScrollToNode(selection);
+		}
 
 		EntryHeight = BaseEntryHeight * EditorPreferences::Get()->UiScale * 1.277f;
-		float y = GetHeight() - 35.0f - EntryHeight + scrollY;
-		_EntryCount = 0;
-		for (int i = 0; i < allNodes.Size(); i++)
+		if (m_RowsDirty)
 		{
-			if (!allNodes[i]->GetParent())
+			RebuildRows(level);
+		}
+		if (m_ScrollTarget)
+		{
+			auto It = m_RowIndices.find(m_ScrollTarget.Get());
+			if (It != m_RowIndices.end())
 			{
-				if (GetMajorTab()->IsA<NodeClassEditor>() && GetMajorTab()->As<NodeClassEditor>()->m_CurrentPlayState == PlayState::Editor && m_RootNode && allNodes[i] != m_RootNode)
-				{
-					allNodes[i]->SetParent(m_RootNode);
-					continue;
-				}
-				float x = 0;
-				DrawNode(x, y, allNodes[i]);
+				const float y = GetRowY(It->second);
+				if (y + EntryHeight > GetHeight() - 35.0f) m_ScrollY += (GetHeight() - 35.0f) - (y + EntryHeight);
+				else if (y < 35.0f) m_ScrollY += 35.0f - y;
+			}
+			m_ScrollTarget = nullptr;
+		}
+		m_ScrollY = glm::clamp(m_ScrollY, 0.0f, GetMaxScroll());
+
+		// Only the rows between header and footer are drawn
+		const int32_t rowCount = (int32_t)m_Rows.size();
+		const int32_t firstRow = glm::max(0, (int32_t)glm::floor(m_ScrollY / EntryHeight) - 1);
+		const int32_t lastRow = glm::min(rowCount - 1, (int32_t)glm::ceil((GetHeight() - 70.0f + m_ScrollY) / EntryHeight));
+		if (firstRow <= lastRow)
+		{
+			DrawConnectors(firstRow, lastRow);
+			for (int32_t row = firstRow; row <= lastRow; row++)
+			{
+				DrawRow(row);
 			}
 		}
 
@@ -214,7 +253,9 @@ namespace Suora
 		// Footer
 		{
 			EditorUI::DrawRect(0.0f, 0.0f, GetWidth(), 35.0f, 0.0f, EditorPreferences::Get()->UiForgroundColor);
-			EditorUI::Text(std::to_string(allNodes.Size()) + " Nodes", Font::Instance, 10.0f, 0.0f, 200.0f, 35.0f, 28.0f, Vec2(-1.0f, 0.0f), Color(0.8f));
+			EditorUI::Text(std::to_string(m_Entries.size()) + " Nodes", Font::Instance, 10.0f, 0.0f, 200.0f, 35.0f, 28.0f, Vec2(-1.0f, 0.0f), Color(0.8f));
+			EditorUI::TextField(&m_SearchLabel, 210.0f, 5.0f, GetWidth() - 220.0f, 25.0f);
+			if (m_SearchLabel == "") EditorUI::Text("Search...", Font::Instance, 210.0f, 5.0f, GetWidth() - 220.0f, 25.0f, 18.0f, Vec2(-0.95f, 0.0f), Color(1.0f));
 		}
 
 		if (NativeInput::GetMouseButtonUp(Mouse::ButtonLeft))
@@ -222,12 +263,10 @@ namespace Suora
 
 		if (IsInputValid() && IsInputMode(EditorInputEvent::None) && NativeInput::GetMouseButtonDown(Mouse::ButtonRight) && glm::distance(NativeInput::GetMouseDelta(), Vec2(0)) <= 10.0f)
 		{
-			EditorUI::CreateContextMenu({ EditorUI::ContextMenuElement{ CreateNodeMenu(GetEditorWorld(), nullptr), []() {},"Create Node", nullptr } });
+			EditorUI::CreateContextMenu({ EditorUI::ContextMenuElement{ CreateNodeMenu(GetEditorWorld(), nullptr, GetMajorTab()), []() {},"Create Node", nullptr } });
 		}
 
-
-		float scrollDown = GetHeight() - 35.0f - 35.0f - 5.0f - EntryHeight * _EntryCount - EntryHeight;
-		EditorUI::ScrollbarVertical(GetWidth()-10, 35, 10, GetHeight()-70, 0, 35, GetWidth(), GetHeight()-70, 0, scrollDown > 0 ? 0 : Math::Abs(scrollDown), &scrollY);
+		EditorUI::ScrollbarVertical(GetWidth()-10, 35, 10, GetHeight()-70, 0, 35, GetWidth(), GetHeight()-70, 0, GetMaxScroll(), &m_ScrollY);
 	}
 
 	World* LevelOutliner::GetEditorWorld()
@@ -236,32 +275,268 @@ namespace Suora
 		return GetMajorTab()->As<NodeClassEditor>()->GetEditorWorld();
 	}
 
-	void LevelOutliner::DrawNode(float& x, float& y, Node* node)
+	void LevelOutliner::ScrollToNode(Node* node)
+	{
+		for (Node* parent = node->GetParent(); parent; parent = parent->GetParent())
+		{
+			if (!IsExpanded(parent))
+			{
+				m_DropDowns[parent] = true;
+				m_RowsDirty = true;
+			}
+		}
+		m_ScrollTarget = node;
+	}
+
+	void LevelOutliner::SetModelWorld(World* world)
+	{
+		if (world == m_ModelWorld.Get())
+		{
+			return;
+		}
+		// A destroyed World nulls the Ptr, and takes its subscription with it
+		if (m_ModelWorld)
+		{
+			m_ModelWorld->UnsubscribeFromHierarchyChanges();
+		}
+		m_ModelWorld = world;
+		if (world)
+		{
+			m_ModelRevision = world->SubscribeToHierarchyChanges();
+		}
+	}
+
+	void LevelOutliner::SyncHierarchy(World* world)
+	{
+		if (world != m_ModelWorld.Get())
+		{
+			RebuildModel(world);
+			return;
+		}
+
+		m_HierarchyChanges.Clear();
+		if (!world->GetHierarchyChanges(m_ModelRevision, m_HierarchyChanges))
+		{
+			RebuildModel(world);
+			return;
+		}
+		if (m_HierarchyChanges.Size() == 0)
+		{
+			return;
+		}
+
+		// Only the latest change of a Node tells, whether it is still alive and may be dereferenced
+		std::unordered_map<Node*, bool> alive;
+		std::unordered_set<Node*> renamed;
+		for (const WorldHierarchyChange& change : m_HierarchyChanges)
+		{
+			alive[change.ChangedNode] = (change.Event != WorldHierarchyEvent::Removed);
+			if (change.Event == WorldHierarchyEvent::Added || change.Event == WorldHierarchyEvent::Renamed)
+			{
+				renamed.insert(change.ChangedNode);
+			}
+			else if (change.Event == WorldHierarchyEvent::Reparented || change.Event == WorldHierarchyEvent::Removed)
+			{
+				m_RowsDirty = true;
+			}
+		}
+
+		for (auto& [node, isAlive] : alive)
+		{
+			if (!isAlive)
+			{
+				m_Entries.erase(node);
+				m_DropDowns.erase(node);
+				m_RowsDirty = true;
+				continue;
+			}
+			if (!renamed.contains(node))
+			{
+				continue;
+			}
+			auto It = m_Entries.find(node);
+			if (It == m_Entries.end())
+			{
+				UpdateEntry(node, m_Entries[node]);
+				m_RowsDirty = true;
+			}
+			else
+			{
+				// A rename only changes the rows, if it changes the result of the search
+				const bool matchedSearch = It->second.MatchesSearch;
+				UpdateEntry(node, It->second);
+				m_RowsDirty |= (matchedSearch != It->second.MatchesSearch);
+			}
+		}
+	}
+
+	void LevelOutliner::RebuildModel(World* world)
+	{
+		SetModelWorld(world);
+		m_ModelRevision = world->GetHierarchyRevision();
+		m_Entries.clear();
+		for (Node* node : world->GetAllNodes())
+		{
+			UpdateEntry(node, m_Entries[node]);
+		}
+		for (auto It = m_DropDowns.begin(); It != m_DropDowns.end();)
+		{
+			It = m_Entries.contains(It->first) ? std::next(It) : m_DropDowns.erase(It);
+		}
+		m_RowsDirty = true;
+	}
+
+	void LevelOutliner::UpdateEntry(Node* node, OutlinerEntry& entry) const
+	{
+		entry.LowerName = StringUtil::ToLower(node->GetName());
+		entry.MatchesSearch = m_LowerSearchLabel.empty() || entry.LowerName.find(m_LowerSearchLabel) != String::npos;
+	}
+
+	void LevelOutliner::UpdateSearch()
+	{
+		if (m_SearchLabel == m_LastSearchLabel)
+		{
+			return;
+		}
+		m_LastSearchLabel = m_SearchLabel;
+		m_LowerSearchLabel = StringUtil::ToLower(m_SearchLabel);
+		for (auto& [node, entry] : m_Entries)
+		{
+			entry.MatchesSearch = m_LowerSearchLabel.empty() || entry.LowerName.find(m_LowerSearchLabel) != String::npos;
+		}
+		m_RowsDirty = true;
+		m_ScrollY = 0.0f;
+	}
+
+	void LevelOutliner::RebuildRows(World* world)
 	{
-		m_TempYValuesOfParentNodes[node] = y;
+		m_RowsDirty = false;
+		m_Rows.clear();
+		m_RowIndices.clear();
+
+		Array<Node*> roots;
+		for (Node* node : world->GetAllNodes())
+		{
+			if (node->GetParent()) continue;
+
+			if (!m_RootNode)
+			{
+				m_RootNode = node;
+				m_DropDowns[node] = true;
+			}
+			// In the editor, everything is part of the edited Node
+			if (GetMajorTab()->IsA<NodeClassEditor>() && GetMajorTab()->As<NodeClassEditor>()->m_CurrentPlayState == PlayState::Editor && node != m_RootNode.Get())
+			{
+				node->SetParent(m_RootNode.Get());
+				continue;
+			}
+			roots.Add(node);
+		}
 
-		if (!m_RootNode)
+		// While searching, the matching Nodes are shown with all of their parents expanded
+		const bool searching = !m_LowerSearchLabel.empty();
+		std::unordered_set<Node*> searchResults;
+		if (searching)
 		{
-			m_RootNode = node;
-			m_DropDowns[node] = true;
+			for (auto& [node, entry] : m_Entries)
+			{
+				if (!entry.MatchesSearch) continue;
+				for (Node* it = node; it && searchResults.insert(it).second; it = it->GetParent());
+			}
+		}
+
+		struct PendingRow
+		{
+			Node* RowNode;
+			uint32_t Depth;
+			int32_t ParentRow;
+		};
+		std::vector<PendingRow> stack;
+		for (int32_t i = roots.Size() - 1; i >= 0; i--)
+		{
+			stack.push_back(PendingRow{ roots[i], 0, -1 });
+		}
+		while (!stack.empty())
+		{
+			const PendingRow pending = stack.back();
+			stack.pop_back();
+			if (searching && !searchResults.contains(pending.RowNode)) continue;
+
+			const int32_t row = (int32_t)m_Rows.size();
+			m_Rows.push_back(OutlinerRow{ pending.RowNode, pending.Depth, pending.ParentRow, -1 });
+			m_RowIndices[pending.RowNode] = row;
+			if (pending.ParentRow != -1)
+			{
+				m_Rows[pending.ParentRow].LastChildRow = row;
+			}
+
+			if (searching || IsExpanded(pending.RowNode))
+			{
+				for (int32_t i = pending.RowNode->GetChildCount() - 1; i >= 0; i--)
+				{
+					stack.push_back(PendingRow{ pending.RowNode->GetChild(i), pending.Depth + 1, row });
+				}
+			}
 		}
+	}
+
+	bool LevelOutliner::IsExpanded(Node* node) const
+	{
+		auto It = m_DropDowns.find(node);
+		return It != m_DropDowns.end() && It->second;
+	}
+
+	float LevelOutliner::GetRowY(int32_t row) const
+	{
+		return GetHeight() - 35.0f - EntryHeight * (row + 1) + m_ScrollY;
+	}
 
+	float LevelOutliner::GetMaxScroll() const
+	{
+		const float scrollDown = GetHeight() - 35.0f - 35.0f - 5.0f - EntryHeight * m_Rows.size() - EntryHeight;
+		return scrollDown > 0 ? 0 : Math::Abs(scrollDown);
+	}
 
+	void LevelOutliner::DrawConnectors(int32_t firstRow, int32_t lastRow)
+	{
 		// Drawing the Parent/Child   v MyParentNode
 		//                            |
 		//                            |--> MyChildNode
-		// Stuff
-		if (node->GetParent())
+		// The vertical line of a parent runs down to its last child, so parents above the visible rows are included
+		auto drawVertical = [this](int32_t row)
+		{
+			const OutlinerRow& parent = m_Rows[row];
+			if (parent.LastChildRow == -1) return;
+			const float x = (parent.Depth + 1) * (EntryHeight + 6.0f);
+			const float y = GetRowY(parent.LastChildRow);
+			EditorUI::DrawRect(x - 0.64f * EntryHeight, y + 0.5f * EntryHeight, 2.0f, GetRowY(row) - y - 10.0f, 0.0f, Color(0.3f, 0.3f, 0.3f, 1.0f));
+		};
+		for (int32_t row = m_Rows[firstRow].ParentRow; row != -1; row = m_Rows[row].ParentRow)
 		{
-			EditorUI::DrawRect(x - 0.64f * EntryHeight, y + 0.5f * EntryHeight, EntryHeight * (node->HasChildren() ? 1.0f : 1.5f) - 10.0f, 2.0f, 0.0f, Color(0.3f, 0.3f, 0.3f, 1.0f));
-			EditorUI::DrawRect(x - 0.64f * EntryHeight, y + 0.5f * EntryHeight, 2.0f, m_TempYValuesOfParentNodes[node->GetParent()] - y - 10.0f, 0.0f, Color(0.3f, 0.3f, 0.3f, 1.0f));
+			drawVertical(row);
 		}
+		for (int32_t row = firstRow; row <= lastRow; row++)
+		{
+			drawVertical(row);
+			const OutlinerRow& child = m_Rows[row];
+			if (child.ParentRow != -1)
+			{
+				const float x = child.Depth * (EntryHeight + 6.0f);
+				EditorUI::DrawRect(x - 0.64f * EntryHeight, GetRowY(row) + 0.5f * EntryHeight, EntryHeight * (child.RowNode->HasChildren() ? 1.0f : 1.5f) - 10.0f, 2.0f, 0.0f, Color(0.3f, 0.3f, 0.3f, 1.0f));
+			}
+		}
+	}
 
+	void LevelOutliner::DrawRow(int32_t row)
+	{
+		Node* node = m_Rows[row].RowNode;
+		const float x = m_Rows[row].Depth * (EntryHeight + 6.0f);
+		const float y = GetRowY(row);
 
 		Vec2 mousePosition = EditorUI::GetInput();
 		const bool Hovering = mousePosition.x >= x + (EntryHeight + 6) && mousePosition.x <= 0 + GetWidth() && mousePosition.y > y && mousePosition.y <= y + EntryHeight && (mousePosition.y > 35.0f && mousePosition.y < GetHeight() - 35.0f && mousePosition.x < GetWidth() - 10.0f);
 		const bool Selected = (node == GetSelectedObject());
-		const bool DropDown = m_DropDowns[node];
+		const bool DropDown = !m_LowerSearchLabel.empty() || IsExpanded(node);
 
 		const bool isNode = node->GetClass().IsBlueprintClass();
 		Color LabelColor = isNode ? EditorPreferences::Get()->UiHighlightColor : Color(1.0f);
@@ -282,128 +557,117 @@ namespace Suora
 
 		if (Hovering && IsInputValid()) EditorUI::SetCursor(Cursor::Hand);
 
-		if (y > -EntryHeight || y < GetHeight())
+		if (Hovering && IsInputValid() && IsInputMode(EditorInputEvent::None) && NativeInput::GetMouseButtonDown(Mouse::ButtonLeft))
 		{
-			if (Hovering && IsInputValid() && IsInputMode(EditorInputEvent::None) && NativeInput::GetMouseButtonDown(Mouse::ButtonLeft))
-			{
-				SetSelectedObject(node);
-			}
-			else if (Hovering && IsInputValid() && IsInputMode(EditorInputEvent::None) && NativeInput::GetMouseButtonDown(Mouse::ButtonRight) && glm::distance(NativeInput::GetMouseDelta(), Vec2(0)) <= 10.0f)
-			{
-				SetSelectedObject(node);
+			SetSelectedObject(node);
+		}
+		else if (Hovering && IsInputValid() && IsInputMode(EditorInputEvent::None) && NativeInput::GetMouseButtonDown(Mouse::ButtonRight) && glm::distance(NativeInput::GetMouseDelta(), Vec2(0)) <= 10.0f)
+		{
+			SetSelectedObject(node);
 
-				EditorUI::CreateContextMenu({ EditorUI::ContextMenuElement{ CreateNodeMenu(nullptr, node),[node]() {
-					EditorUI::SubclassSelectionMenu(Node::StaticClass(), [node](const Class& cls)
+			EditorUI::CreateContextMenu({ EditorUI::ContextMenuElement{ CreateNodeMenu(nullptr, node, GetMajorTab()),[node, this]() {
+				EditorUI::SubclassSelectionMenu(Node::StaticClass(), [node, this](const Class& cls)
+				{
+					Node* n = node->CreateChild(cls);
+					n->m_IsActorLayer = true;
+					RecordSpawn(GetMajorTab(), n);
+				}); },"Create Child Node", nullptr }, EditorUI::ContextMenuElement{ {},[node, this]() {
+					if (node->m_IsActorLayer)
 					{
-						Node* n = node->CreateChild(cls);
-						n->m_IsActorLayer = true;
-					}); },"Create Child Node", nullptr }, EditorUI::ContextMenuElement{ {},[node, this]() {
-						if (node->m_IsActorLayer)
-						{
-							SetSelectedObject(nullptr);
-							node->Destroy();
-						}
-					}, (node->m_IsActorLayer ? "Delete Node" : "Cannot Delete Inherited Node"), nullptr}, EditorUI::ContextMenuElement{{},[node, this]() {
-						node->Duplicate();
-					},"Duplicate Node", nullptr } });
-			}
+						SetSelectedObject(nullptr);
+						GetMajorTab()->MakeEditorChange(NodeLifetimeChange::Destroy(node));
+					}
+				}, (node->m_IsActorLayer ? "Delete Node" : "Cannot Delete Inherited Node"), nullptr}, EditorUI::ContextMenuElement{{},[node, this]() {
+					RecordSpawn(GetMajorTab(), node->Duplicate());
+				},"Duplicate Node", nullptr } });
+		}
+
+		if (Hovering) EditorUI::DrawRectOutline(x, y, GetWidth() - x, EntryHeight, 1, Color(.5f, .5f, .5f, 1));
+		if (Selected)
+		{
+			EditorUI::DrawRect(x, y, GetWidth() * m_HeaderSeperator1 - x - 1, EntryHeight, 0, EditorPreferences::Get()->UiHighlightColor);
+			EditorUI::DrawRect(GetWidth() * m_HeaderSeperator1, y, GetWidth() * (m_HeaderSeperator2 - m_HeaderSeperator1) - 1, EntryHeight, 0, EditorPreferences::Get()->UiHighlightColor);
+			EditorUI::DrawRect(GetWidth() * m_HeaderSeperator2, y, GetWidth() - GetWidth() * m_HeaderSeperator2, EntryHeight, 0, EditorPreferences::Get()->UiHighlightColor);
+		}
 
-			if (Hovering) EditorUI::DrawRectOutline(x, y, GetWidth() - x, EntryHeight, 1, Color(.5f, .5f, .5f, 1));
-			if (Selected)
+		if (EditorUI::DragSource(0, y, GetWidth(), EntryHeight, 5.0f))
+		{
+			if (node->m_IsActorLayer)
 			{
-				EditorUI::DrawRect(x, y, GetWidth() * m_HeaderSeperator1 - x - 1, EntryHeight, 0, EditorPreferences::Get()->UiHighlightColor);
-				EditorUI::DrawRect(GetWidth() * m_HeaderSeperator1, y, GetWidth() * (m_HeaderSeperator2 - m_HeaderSeperator1) - 1, EntryHeight, 0, EditorPreferences::Get()->UiHighlightColor);
-				EditorUI::DrawRect(GetWidth() * m_HeaderSeperator2, y, GetWidth() - GetWidth() * m_HeaderSeperator2, EntryHeight, 0, EditorPreferences::Get()->UiHighlightColor);
+				m_DragNode = node;
 			}
-
-			if (EditorUI::DragSource(0, y, GetWidth(), EntryHeight, 5.0f))
+		}
+		EditorUI::ButtonParams dragParams = EditorUI::ButtonParams::Invisible();
+		dragParams.OverrideActivationEvent = true;
+		dragParams.OverrittenActivationEvent = []() { return NativeInput::GetMouseButtonUp(Mouse::ButtonLeft); };
+		if (m_DragNode && m_DragNode.Get() != node && EditorUI::Button("", 0, y, GetWidth(), EntryHeight, dragParams))
+		{
+			if (m_DragNode->GetParent() == node)
 			{
-				if (node->m_IsActorLayer)
-				{
-					m_DragNode = node;
-				}
+				GetMajorTab()->MakeEditorChange(NodeReparentChange::Reparent(m_DragNode.Get(), node->GetParent()));
 			}
-			EditorUI::ButtonParams dragParams = EditorUI::ButtonParams::Invisible();
-			dragParams.OverrideActivationEvent = true;
-			dragParams.OverrittenActivationEvent = []() { return NativeInput::GetMouseButtonUp(Mouse::ButtonLeft); };
-			if (m_DragNode && m_DragNode != node && EditorUI::Button("", 0, y, GetWidth(), EntryHeight, dragParams))
+			else
 			{
-				if (m_DragNode->GetParent() == node)
-				{
-					m_DragNode->SetParent(node->GetParent());
-				}
-				else
-				{
-					m_DragNode->SetParent(node);
-					m_DropDowns[node] = true;
-				}
+				GetMajorTab()->MakeEditorChange(NodeReparentChange::Reparent(m_DragNode.Get(), node));
+				m_DropDowns[node] = true;
 			}
+		}
 
-			if (node->HasChildren())
+		if (node->HasChildren())
+		{
+			EditorUI::ButtonParams Params;
+			Params.ButtonColor = Color(0.0f); Params.ButtonColorHover = Color(0.0f); Params.ButtonOutlineColor = Color(0.0f); Params.ButtonColorClicked = Color(0.0f);
+			if (EditorUI::Button("", x + 2, y, EntryHeight, EntryHeight, Params))
 			{
-				EditorUI::ButtonParams Params;
-				Params.ButtonColor = Color(0.0f); Params.ButtonColorHover = Color(0.0f); Params.ButtonOutlineColor = Color(0.0f); Params.ButtonColorClicked = Color(0.0f);
-				if (EditorUI::Button("", x + 2, y, EntryHeight, EntryHeight, Params)) m_DropDowns[node] = !DropDown;
-				if (GetSelectedObject() && GetSelectedObject()->IsChildOf(node)) m_DropDowns[node] = true;
-
-				const bool DropDownHovering = mousePosition.x >= x && mousePosition.x <= x + EntryHeight && mousePosition.y > y && mousePosition.y <= y + EntryHeight;
-				EditorUI::DrawTexturedRect(DropDown ? TexArrowDown->GetTexture() : TexArrowRight->GetTexture(), x + 5 + 2, y + 3 - 2, EntryHeight - 6, EntryHeight - 6, 0, Color(0, 0, 0, 0.25f));
-				EditorUI::DrawTexturedRect(DropDown ? TexArrowDown->GetTexture() : TexArrowRight->GetTexture(), x + 5, y + 3, EntryHeight - 6, EntryHeight - 6, 0, DropDownHovering ? EditorPreferences::Get()->UiHighlightColor : Color(1));
+				m_DropDowns[node] = !IsExpanded(node);
+				m_RowsDirty = true;
 			}
 
-			Texture* NodeIcon = EditorUI::GetClassIcon(node->GetClass())->GetTexture();
-			const Color Node3dIconColor = Math::Lerp(EditorPreferences::Get()->UiHighlightColor, Color(1.0f), 0.45f);
-			const Color NodeUiIconColor = Math::Lerp(Color(0.4f, 0.64f, 0.2f, 1.0f), Color(1.0f), 0.45f);
-			const Color NodeIconColor = node->IsA<Node3D>() ? Node3dIconColor : (node->IsA<UINode>() ? NodeUiIconColor : Color(1)); // Node3D - Color(0.40392f, 0.45490f, 0.6078f, 1) - Color(0.30588f, 0.149019f, 0.184313f, 1) ~ NodeUI - Color(0.40392f, 0.6078f, 0.45490f, 1)
-			EditorUI::DrawTexturedRect(NodeIcon, x + (EntryHeight + 6) + 3 + 2, y + 3 - 2, EntryHeight - 6, EntryHeight - 6, 0, Color(0, 0, 0, 0.25f));
-			EditorUI::DrawTexturedRect(NodeIcon, x + (EntryHeight + 6) + 3, y + 3, EntryHeight - 6, EntryHeight - 6, 0, NodeIconColor);
+			const bool DropDownHovering = mousePosition.x >= x && mousePosition.x <= x + EntryHeight && mousePosition.y > y && mousePosition.y <= y + EntryHeight;
+			EditorUI::DrawTexturedRect(DropDown ? TexArrowDown->GetTexture() : TexArrowRight->GetTexture(), x + 5 + 2, y + 3 - 2, EntryHeight - 6, EntryHeight - 6, 0, Color(0, 0, 0, 0.25f));
+			EditorUI::DrawTexturedRect(DropDown ? TexArrowDown->GetTexture() : TexArrowRight->GetTexture(), x + 5, y + 3, EntryHeight - 6, EntryHeight - 6, 0, DropDownHovering ? EditorPreferences::Get()->UiHighlightColor : Color(1));
+		}
 
+		Texture* NodeIcon = EditorUI::GetClassIcon(node->GetClass())->GetTexture();
+		const Color Node3dIconColor = Math::Lerp(EditorPreferences::Get()->UiHighlightColor, Color(1.0f), 0.45f);
+		const Color NodeUiIconColor = Math::Lerp(Color(0.4f, 0.64f, 0.2f, 1.0f), Color(1.0f), 0.45f);
+		const Color NodeIconColor = node->IsA<Node3D>() ? Node3dIconColor : (node->IsA<UINode>() ? NodeUiIconColor : Color(1)); // Node3D - Color(0.40392f, 0.45490f, 0.6078f, 1) - Color(0.30588f, 0.149019f, 0.184313f, 1) ~ NodeUI - Color(0.40392f, 0.6078f, 0.45490f, 1)
+		EditorUI::DrawTexturedRect(NodeIcon, x + (EntryHeight + 6) + 3 + 2, y + 3 - 2, EntryHeight - 6, EntryHeight - 6, 0, Color(0, 0, 0, 0.25f));
+		EditorUI::DrawTexturedRect(NodeIcon, x + (EntryHeight + 6) + 3, y + 3, EntryHeight - 6, EntryHeight - 6, 0, NodeIconColor);
 
-			const float nameX = x + (EntryHeight * 2 + 14.0f);
-			EditorUI::Text(node->m_Name, Font::Instance, nameX + 1, y - 1, GetWidth() * m_HeaderSeperator1 - nameX, EntryHeight, EntryHeight, Vec2(-1, 0), Color(0, 0, 0, node->IsEnabled() ? 0.15f : 0));
-			EditorUI::Text(node->m_Name, Font::Instance, nameX, y, GetWidth() * m_HeaderSeperator1 - nameX, EntryHeight, EntryHeight, Vec2(-1, 0), (Selected ? EditorPreferences::Get()->UiColor : LabelColor) * (node->IsEnabled() ? EditorPreferences::Get()->UiTextColor : EditorPreferences::Get()->UiTextColor * 0.65f));
 
-			if (node->GetParent())
+		const float nameX = x + (EntryHeight * 2 + 14.0f);
+		EditorUI::Text(node->m_Name, Font::Instance, nameX + 1, y - 1, GetWidth() * m_HeaderSeperator1 - nameX, EntryHeight, EntryHeight, Vec2(-1, 0), Color(0, 0, 0, node->IsEnabled() ? 0.15f : 0));
+		EditorUI::Text(node->m_Name, Font::Instance, nameX, y, GetWidth() * m_HeaderSeperator1 - nameX, EntryHeight, EntryHeight, Vec2(-1, 0), (Selected ? EditorPreferences::Get()->UiColor : LabelColor) * (node->IsEnabled() ? EditorPreferences::Get()->UiTextColor : EditorPreferences::Get()->UiTextColor * 0.65f));
+
+		if (node->GetParent())
+		{
+			String className = ClassReflector::GetClassName(node->GetNativeClass());
+			bool isNativeClass = true;
+			if (INodeScriptObject* obj = node->GetInterface<INodeScriptObject>())
 			{
-				String className = ClassReflector::GetClassName(node->GetNativeClass());
-				bool isNativeClass = true;
-				if (INodeScriptObject* obj = node->GetInterface<INodeScriptObject>())
+				Blueprint* blueprint = obj->m_Class.GetBlueprintClass();
+				if (blueprint)
 				{
-					Blueprint* blueprint = obj->m_Class.GetBlueprintClass();
-					if (blueprint)
+					className = blueprint->GetAssetName();
+					isNativeClass = false;
+					EditorUI::ButtonParams params = EditorUI::ButtonParams::Invisible();
+					if (EditorUI::Button("", GetWidth() * m_HeaderSeperator1, y, GetWidth() * (m_HeaderSeperator2 - m_HeaderSeperator1), EntryHeight, params))
+					{
+						NativeInput::ConsumeInput();
+						EditorWindow::GetCurrent()->OpenAsset(blueprint);
+					}
+					EditorUI::ButtonParams hoverParams = EditorUI::ButtonParams::Invisible();
+					hoverParams.OverrideActivationEvent = true;
+					hoverParams.OverrittenActivationEvent = []() { return true; };
+					if (EditorUI::Button("", GetWidth() * m_HeaderSeperator1, y, GetWidth() * (m_HeaderSeperator2 - m_HeaderSeperator1), EntryHeight, hoverParams))
 					{
-						className = blueprint->GetAssetName();
-						isNativeClass = false;
-						EditorUI::ButtonParams params = EditorUI::ButtonParams::Invisible();
-						if (EditorUI::Button("", GetWidth() * m_HeaderSeperator1, y, GetWidth() * (m_HeaderSeperator2 - m_HeaderSeperator1), EntryHeight, params))
-						{
-							NativeInput::ConsumeInput();
-							EditorWindow::GetCurrent()->OpenAsset(blueprint);
-						}
-						EditorUI::ButtonParams hoverParams = EditorUI::ButtonParams::Invisible();
-						hoverParams.OverrideActivationEvent = true;
-						hoverParams.OverrittenActivationEvent = []() { return true; };
-						if (EditorUI::Button("", GetWidth() * m_HeaderSeperator1, y, GetWidth() * (m_HeaderSeperator2 - m_HeaderSeperator1), EntryHeight, hoverParams))
-						{
-							float strWidth = Font::Instance->GetStringWidth(className, EntryHeight * 0.45f) + 7.5f;
-							EditorUI::DrawRect(GetWidth() * m_HeaderSeperator1 + 1.0f, y + EntryHeight * 0.1f, glm::min(GetWidth() * (m_HeaderSeperator2 - m_HeaderSeperator1), strWidth), EntryHeight * 0.075f, 0, Selected ? EditorPreferences::Get()->UiColor : EditorPreferences::Get()->UiHighlightColor);
-						}
+						float strWidth = Font::Instance->GetStringWidth(className, EntryHeight * 0.45f) + 7.5f;
+						EditorUI::DrawRect(GetWidth() * m_HeaderSeperator1 + 1.0f, y + EntryHeight * 0.1f, glm::min(GetWidth() * (m_HeaderSeperator2 - m_HeaderSeperator1), strWidth), EntryHeight * 0.075f, 0, Selected ? EditorPreferences::Get()->UiColor : EditorPreferences::Get()->UiHighlightColor);
 					}
 				}
-				EditorUI::Text(className, Font::Instance, GetWidth() * m_HeaderSeperator1, y, GetWidth() * (m_HeaderSeperator2 - m_HeaderSeperator1), EntryHeight, EntryHeight * 0.9f, Vec2(-0.95f, 0), Selected ? EditorPreferences::Get()->UiColor : (isNativeClass ? Color(0.65f) : EditorPreferences::Get()->UiHighlightColor));
 			}
+			EditorUI::Text(className, Font::Instance, GetWidth() * m_HeaderSeperator1, y, GetWidth() * (m_HeaderSeperator2 - m_HeaderSeperator1), EntryHeight, EntryHeight * 0.9f, Vec2(-0.95f, 0), Selected ? EditorPreferences::Get()->UiColor : (isNativeClass ? Color(0.65f) : EditorPreferences::Get()->UiHighlightColor));
 		}
-
-		y -= EntryHeight;
-		_EntryCount++;
-		if (node->HasChildren() && DropDown)
-		{
-			float inlinedX = x + (EntryHeight + 6.0f);
-			for (int i = 0; i < node->GetChildCount(); i++)
-			{
-				DrawNode(inlinedX, y, node->GetChild(i));
-			}
-		}
-
 	}
-}
\ No newline at end of file
+}
@@ -1,5 +1,6 @@
 #pragma once
 #include "Suora/Editor/Panels/MinorTab.h"
+#include "Suora/GameFramework/World.h"
 
 namespace Suora
 {
@@ -12,7 +13,7 @@ namespace Suora
 		LevelOutliner(MajorTab* majorTab);
 		~LevelOutliner();
 
-		static std::vector<EditorUI::ContextMenuElement> CreateNodeMenu(World* world, Node* node);
+		static std::vector<EditorUI::ContextMenuElement> CreateNodeMenu(World* world, Node* node, MajorTab* majorTab);
 
 		Texture2D* TexActorIcon = nullptr;
 		Texture2D* TexVisible0 = nullptr;
@@ -30,15 +31,59 @@ namespace Suora
 		virtual void Render(float deltaTime) override;
 
 		World* GetEditorWorld();
-		void DrawNode(float& x, float& y, Node* node);
+		/** Expands the parents of the Node and scrolls its row into view */
+		void ScrollToNode(Node* node);
 
 	private:
-		int _EntryCount = 0;
+		struct OutlinerEntry
+		{
+			String LowerName;
+			bool MatchesSearch = true;
+		};
+		struct OutlinerRow
+		{
+			Node* RowNode = nullptr;
+			uint32_t Depth = 0;
+			int32_t ParentRow = -1;
+			/** Row of the last child, -1 if the Node is collapsed or has no children */
+			int32_t LastChildRow = -1;
+		};
+
+		/** Subscribes to the hierarchy journal of the World and unsubscribes from the last one */
+		void SetModelWorld(World* world);
+		void SyncHierarchy(World* world);
+		void RebuildModel(World* world);
+		void UpdateEntry(Node* node, OutlinerEntry& entry) const;
+		void UpdateSearch();
+		void RebuildRows(World* world);
+		bool IsExpanded(Node* node) const;
+		float GetRowY(int32_t row) const;
+		float GetMaxScroll() const;
+		void DrawConnectors(int32_t firstRow, int32_t lastRow);
+		void DrawRow(int32_t row);
+
 		float m_HeaderSeperator1 = 0.75f;
 		float m_HeaderSeperator2 = 0.97f;
+		float m_ScrollY = 0.0f;
 		Ptr<Node> m_DragNode = nullptr;
 		Ptr<Node> m_RootNode = nullptr;
-		std::unordered_map<Node*, float> m_TempYValuesOfParentNodes;
+		Ptr<Node> m_ScrollTarget = nullptr;
+		Node* m_LastSelection = nullptr;
+
+		/** The cached model of the hierarchy, kept up to date from the hierarchy journal of the World */
+		Ptr<World> m_ModelWorld = nullptr;
+		uint64_t m_ModelRevision = 0;
+		std::unordered_map<Node*, OutlinerEntry> m_Entries;
+		Array<WorldHierarchyChange> m_HierarchyChanges;
+
+		/** The flattened, visible part of the hierarchy in drawing order. Rebuilt only when the hierarchy, the expanded Nodes or the search changes */
+		std::vector<OutlinerRow> m_Rows;
+		std::unordered_map<Node*, int32_t> m_RowIndices;
+		bool m_RowsDirty = true;
+
+		String m_SearchLabel = "";
+		String m_LastSearchLabel = "";
+		String m_LowerSearchLabel = "";
 
 		friend class NodeClassEditor;
 	};
@@ -11,7 +11,7 @@
 namespace Suora
 {
 
-	void ViewportCameraGizmo::DrawDebugGizmos(World* world, CameraNode* camera, int* pickingID, Map<int, Node*>* pickingMap, bool isHandlingMousePick)
+	void ViewportCameraGizmo::DrawDebugGizmos(World* world, CameraNode* camera)
 	{
 		Array<CameraNode*> cameras = world->FindNodesByClass<CameraNode>();
 		for (CameraNode* cam : cameras)
@@ -22,7 +22,7 @@ namespace Suora
 			tr.SetPosition(cam->GetPosition());
 			tr.SetRotation(cam->GetRotation());
 			tr.SetScale(Vec3(0.1f));
-			Renderer3D::DrawMesh(camera, cam->GetTransformMatrix(), *AssetManager::GetAsset<Mesh>(SuoraID("c37609b9-9067-4e3a-ac04-c493ed2d8009")), GizmoMaterial(isHandlingMousePick, pickingID, Vec3(1.0f), SuoraID("317cf1ef-ac75-46d8-a62f-184891456960")), isHandlingMousePick ? MaterialType::ObjectID : MaterialType::Material);
+			Renderer3D::DrawMesh(camera, cam->GetTransformMatrix(), *AssetManager::GetAsset<Mesh>(SuoraID("c37609b9-9067-4e3a-ac04-c493ed2d8009")), GizmoMaterial(Vec3(1.0f), SuoraID("317cf1ef-ac75-46d8-a62f-184891456960")), MaterialType::Material);
 
 			Vec3 corners[4];
 			{
@@ -65,12 +65,15 @@ namespace Suora
 			Renderer3D::DrawLine3D(camera, corners[1], corners[3], Color(0.66f, 1.0f, 0.66f, 0.5f));
 			Renderer3D::DrawLine3D(camera, corners[2], corners[0], Color(0.66f, 1.0f, 0.66f, 0.5f));
 			Renderer3D::DrawLine3D(camera, corners[3], corners[2], Color(0.66f, 1.0f, 0.66f, 0.5f));
+		}
+	}
 
-			if (isHandlingMousePick)
-			{
-				(*pickingMap)[*pickingID] = cam;
-				(*pickingID)++;
-			}
+	void ViewportCameraGizmo::AddPickingProxies(World* world, CameraNode* camera, SceneQuery& query)
+	{
+		Mesh* cameraMesh = AssetManager::GetAsset<Mesh>(SuoraID("c37609b9-9067-4e3a-ac04-c493ed2d8009"));
+		for (CameraNode* cam : world->FindNodesByClass<CameraNode>())
+		{
+			if (cameraMesh) query.AddMesh(cam, cam->GetTransformMatrix(), *cameraMesh);
 		}
 	}
 
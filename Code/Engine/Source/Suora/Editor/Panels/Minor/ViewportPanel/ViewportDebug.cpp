@@ -17,32 +17,27 @@
 namespace Suora
 {
 
-	Material* ViewportDebugGizmo::GizmoMaterial(bool useIdShader, int* i, const Vec3& color, const SuoraID& uuid)
+	Material* ViewportDebugGizmo::GizmoMaterial(const Vec3& color, const SuoraID& uuid)
 	{
 		Material* mat = AssetManager::GetAsset<Material>(uuid);
 		if (UniformSlot* uniform = mat->GetUniformSlot("Color"))
 		{
 			uniform->m_Vec3 = color;
 		}
-		if (useIdShader)
-		{
-			if (mat && mat->GetShaderGraph()) mat->GetShaderGraph()->GetIDShader()->SetInt("u_ID", *i);
-		}
 		return mat;
 	}
 
-	void ViewportPanel::DrawDebugShapes(World* world, CameraNode* camera, int* pickingID, Map<int, Node*>* pickingMap)
+	void ViewportPanel::DrawDebugShapes(World* world, CameraNode* camera)
 	{
-		const bool HandlingMousePick = pickingID;
 		if (NativeInput::GetKeyDown(Key::G)) m_DrawDebugGizmos = !m_DrawDebugGizmos;
 		if (!m_DrawDebugGizmos) return;
-		if (!HandlingMousePick) m_GizmoBuffer->Bind();
+		m_GizmoBuffer->Bind();
 
 		for (Ref<ViewportDebugGizmo> It : m_ViewportDebugGizmos)
 		{
 			if (It)
 			{
-				It->DrawDebugGizmos(world, camera, pickingID, pickingMap, HandlingMousePick);
+				It->DrawDebugGizmos(world, camera);
 			}
 		}
 		
@@ -13,7 +13,7 @@
 namespace Suora
 {
 
-	void ViewportGridGizmo::DrawDebugGizmos(World* world, CameraNode* camera, int* pickingID, Map<int, Node*>* pickingMap, bool isHandlingMousePick)
+	void ViewportGridGizmo::DrawDebugGizmos(World* world, CameraNode* camera)
 	{
 		if (!GetViewport()->m_ShowGrid)
 		{
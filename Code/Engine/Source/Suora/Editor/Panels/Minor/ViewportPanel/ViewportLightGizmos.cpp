@@ -13,25 +13,34 @@
 namespace Suora
 {
 
-	void ViewportPointLightGizmo::DrawDebugGizmos(World* world, CameraNode* camera, int* pickingID, Map<int, Node*>* pickingMap, bool isHandlingMousePick)
+	/** Light Gizmos are textured quads facing the camera */
+	static Mat4 GetBillboardTransform(Node3D* light, CameraNode* camera)
+	{
+		Node3D tr;
+		tr.SetPosition(light->GetPosition());
+		tr.SetRotation(camera->GetRotation());
+		return tr.GetTransformMatrix();
+	}
+
+	void ViewportPointLightGizmo::DrawDebugGizmos(World* world, CameraNode* camera)
 	{
 		Array<PointLightNode*> plights = world->FindNodesByClass<PointLightNode>();
 		for (PointLightNode* light : plights)
 		{
-			Node3D tr;
-			tr.SetPosition(light->GetPosition());
-			tr.SetRotation(camera->GetRotation());
-			Material* gizmoMat = ViewportDebugGizmo::GizmoMaterial(isHandlingMousePick, pickingID, Vec3(light->m_Color));
+			Material* gizmoMat = ViewportDebugGizmo::GizmoMaterial(Vec3(light->m_Color));
 			const UniformSlot uniform = gizmoMat->m_UniformSlots[0];
 			gizmoMat->m_UniformSlots[0].m_Texture2D = AssetManager::GetAsset<Texture2D>(SuoraID("f789d2bf-dcda-4e30-b2d9-3db979b7c6da"));
-			Renderer3D::DrawMesh(camera, tr.GetTransformMatrix(), *AssetManager::GetAsset<Mesh>(SuoraID("75f466f7-baec-4c5a-a23b-a5e3dc3d22bc")), gizmoMat, isHandlingMousePick ? MaterialType::ObjectID : MaterialType::Material);
+			Renderer3D::DrawMesh(camera, GetBillboardTransform(light, camera), *AssetManager::GetAsset<Mesh>(SuoraID("75f466f7-baec-4c5a-a23b-a5e3dc3d22bc")), gizmoMat, MaterialType::Material);
 			gizmoMat->m_UniformSlots[0] = uniform;
+		}
+	}
 
-			if (isHandlingMousePick)
-			{
-				(*pickingMap)[*pickingID] = light;
-				(*pickingID)++;
-			}
+	void ViewportPointLightGizmo::AddPickingProxies(World* world, CameraNode* camera, SceneQuery& query)
+	{
+		Mesh* billboard = AssetManager::GetAsset<Mesh>(SuoraID("75f466f7-baec-4c5a-a23b-a5e3dc3d22bc"));
+		for (PointLightNode* light : world->FindNodesByClass<PointLightNode>())
+		{
+			if (billboard) query.AddMesh(light, GetBillboardTransform(light, camera), *billboard);
 		}
 	}
 
@@ -68,18 +77,15 @@ namespace Suora
 		}
 	}
 
-	void ViewportDirectionalLightGizmo::DrawDebugGizmos(World* world, CameraNode* camera, int* pickingID, Map<int, Node*>* pickingMap, bool isHandlingMousePick)
+	void ViewportDirectionalLightGizmo::DrawDebugGizmos(World* world, CameraNode* camera)
 	{
 		Array<DirectionalLightNode*> dlights = world->FindNodesByClass<DirectionalLightNode>();
 		for (DirectionalLightNode* light : dlights)
 		{
-			Node3D tr;
-			tr.SetPosition(light->GetPosition());
-			tr.SetRotation(camera->GetRotation());
-			Material* gizmoMat = ViewportDebugGizmo::GizmoMaterial(isHandlingMousePick, pickingID, Vec3(1.0f));
+			Material* gizmoMat = ViewportDebugGizmo::GizmoMaterial(Vec3(1.0f));
 			const UniformSlot uniform = gizmoMat->m_UniformSlots[0];
 			gizmoMat->m_UniformSlots[0].m_Texture2D = AssetManager::GetAsset<Texture2D>(SuoraID("64738d74-08a9-4383-8659-620808d5269a"));
-			Renderer3D::DrawMesh(camera, tr.GetTransformMatrix(), *AssetManager::GetAsset<Mesh>(SuoraID("75f466f7-baec-4c5a-a23b-a5e3dc3d22bc")), gizmoMat, isHandlingMousePick ? MaterialType::ObjectID : MaterialType::Material);
+			Renderer3D::DrawMesh(camera, GetBillboardTransform(light, camera), *AssetManager::GetAsset<Mesh>(SuoraID("75f466f7-baec-4c5a-a23b-a5e3dc3d22bc")), gizmoMat, MaterialType::Material);
 			gizmoMat->m_UniformSlots[0] = uniform;
 			Node3D tr2;
 			tr2.SetPosition(light->GetPosition());
@@ -87,12 +93,15 @@ namespace Suora
 			tr2.SetScale(Vec3(0.25f));
 
 			Draw3DArrow(camera, light);
+		}
+	}
 
-			if (isHandlingMousePick)
-			{
-				(*pickingMap)[*pickingID] = light;
-				(*pickingID)++;
-			}
+	void ViewportDirectionalLightGizmo::AddPickingProxies(World* world, CameraNode* camera, SceneQuery& query)
+	{
+		Mesh* billboard = AssetManager::GetAsset<Mesh>(SuoraID("75f466f7-baec-4c5a-a23b-a5e3dc3d22bc"));
+		for (DirectionalLightNode* light : world->FindNodesByClass<DirectionalLightNode>())
+		{
+			if (billboard) query.AddMesh(light, GetBillboardTransform(light, camera), *billboard);
 		}
 	}
 
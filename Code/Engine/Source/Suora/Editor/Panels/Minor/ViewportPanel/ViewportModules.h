@@ -12,7 +12,8 @@ namespace Suora
 	{
 		SUORA_CLASS(46783823473333);
 	public:
-		virtual void DrawDebugGizmos(World* world, CameraNode* camera, int* pickingID, Map<int, Node*>* pickingMap, bool isHandlingMousePick)  override;
+		virtual void DrawDebugGizmos(World* world, CameraNode* camera) override;
+		virtual void AddPickingProxies(World* world, CameraNode* camera, SceneQuery& query) override;
 
 	};
 
@@ -20,7 +21,8 @@ namespace Suora
 	{
 		SUORA_CLASS(879543879523232);
 	public:
-		virtual void DrawDebugGizmos(World* world, CameraNode* camera, int* pickingID, Map<int, Node*>* pickingMap, bool isHandlingMousePick)  override;
+		virtual void DrawDebugGizmos(World* world, CameraNode* camera) override;
+		virtual void AddPickingProxies(World* world, CameraNode* camera, SceneQuery& query) override;
 
 	};
 
@@ -28,28 +30,29 @@ namespace Suora
 	{
 		SUORA_CLASS(578457489353);
 	public:
-		virtual void DrawDebugGizmos(World* world, CameraNode* camera, int* pickingID, Map<int, Node*>* pickingMap, bool isHandlingMousePick)  override;
+		virtual void DrawDebugGizmos(World* world, CameraNode* camera) override;
+		virtual void AddPickingProxies(World* world, CameraNode* camera, SceneQuery& query) override;
 	};
 
 	class ViewportGridGizmo : public ViewportDebugGizmo
 	{
 		SUORA_CLASS(98075328790333);
 	public:
-		virtual void DrawDebugGizmos(World* world, CameraNode* camera, int* pickingID, Map<int, Node*>* pickingMap, bool isHandlingMousePick)  override;
+		virtual void DrawDebugGizmos(World* world, CameraNode* camera) override;
 	};
 
 	class ViewportOriginGizmo : public ViewportDebugGizmo
 	{
 		SUORA_CLASS(5473898564395);
 	public:
-		virtual void DrawDebugGizmos(World* world, CameraNode* camera, int* pickingID, Map<int, Node*>* pickingMap, bool isHandlingMousePick)  override;
+		virtual void DrawDebugGizmos(World* world, CameraNode* camera) override;
 	};
 
 	class ViewportShapeGizmos : public ViewportDebugGizmo
 	{
 		SUORA_CLASS(578964325349);
 	public:
-		virtual void DrawDebugGizmos(World* world, CameraNode* camera, int* pickingID, Map<int, Node*>* pickingMap, bool isHandlingMousePick)  override;
+		virtual void DrawDebugGizmos(World* world, CameraNode* camera) override;
 	};
 
 }
\ No newline at end of file
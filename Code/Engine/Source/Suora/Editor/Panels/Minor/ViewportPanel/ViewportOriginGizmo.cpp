@@ -13,7 +13,7 @@
 namespace Suora
 {
 
-	void ViewportOriginGizmo::DrawDebugGizmos(World* world, CameraNode* camera, int* pickingID, Map<int, Node*>* pickingMap, bool isHandlingMousePick)
+	void ViewportOriginGizmo::DrawDebugGizmos(World* world, CameraNode* camera)
 	{
 		if (!GetViewport()->m_ShowOrigin)
 		{
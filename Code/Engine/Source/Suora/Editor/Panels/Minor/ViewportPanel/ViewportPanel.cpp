@@ -17,6 +17,7 @@
 #include "Suora/GameFramework/Nodes/Light/DirectionalLightNode.h"
 #include "Suora/GameFramework/InputModule.h"
 #include "Suora/Editor/Panels/Major/NodeClassEditor.h"
+#include "Suora/Editor/Util/NodeTransaction.h"
 
 namespace Suora
 {
@@ -53,14 +54,6 @@ namespace Suora
 
 			m_GizmoBuffer = Framebuffer::Create(spec);
 		} 
-		{
-			FramebufferSpecification spec;
-			spec.Width = 1920;
-			spec.Height = 1080;
-			spec.Attachments.Attachments.push_back(FramebufferTextureFormat::R32I);
-			spec.Attachments.Attachments.push_back(FramebufferTextureFormat::Depth);
-			m_PickingBuffer = Framebuffer::Create(spec);
-		}
 		{
 			FramebufferSpecification spec;
 			spec.Width = 192;
@@ -132,53 +125,126 @@ namespace Suora
 		RenderPipeline::RenderFramebufferIntoFramebuffer(*m_SelectionOutlineFramebuffer, *m_Framebuffer, *m_SelectionOutlineShader, glm::ivec4(0, 0, m_Framebuffer->GetSize().x, m_Framebuffer->GetSize().y), "u_Texture", 0, false);
 	}
 
-	void ViewportPanel::HandleMousePick(const glm::ivec2& pos)
+	World* ViewportPanel::GetPickingWorld() const
 	{
-		m_PickingBuffer->Bind();
-		RenderCommand::SetClearColor(Color(0.0f));
-		RenderCommand::SetViewport(0, 0, GetWidth(), GetHeight());
-		RenderCommand::Clear();
+		if (GetMajorTab()->IsA<NodeClassEditor>()) return GetMajorTab()->As<NodeClassEditor>()->GetEditorWorld();
 
-		Array<MeshNode*> nodes;
-		if (GetMajorTab()->IsA<NodeClassEditor>()) nodes = GetMajorTab()->As<NodeClassEditor>()->GetEditorWorld()->FindNodesByClass<MeshNode>();
-		else
+		SuoraError("Cannot handle >World< in ViewportPanel::GetPickingWorld()");
+		return nullptr;
+	}
+
+	void ViewportPanel::UpdateSceneQuery(World* world, bool includeGizmos)
+	{
+		m_GizmoQuery.Clear();
+		if (!world)
 		{
-			SuoraError("Cannot handle >World< in ViewportPanel::HandleMousePick()");
+			m_SceneQuery.Clear();
+			return;
 		}
 
-		Map<int, Node*> IDs;
-		int i = 1;
-		for (MeshNode* meshNode : nodes)
+		m_SceneQuery.Update(*world);
+		if (includeGizmos && m_DrawDebugGizmos)
 		{
-			if (meshNode->IsEnabled() && meshNode->GetMesh())
+			for (Ref<ViewportDebugGizmo> It : m_ViewportDebugGizmos)
 			{
-				IDs[i] = meshNode;
-				for (Material* submaterial : meshNode->GetMaterials().Materials) if (submaterial && submaterial->GetShaderGraph()) submaterial->GetShaderGraph()->GetIDShader()->SetInt("u_ID", i);
-				Renderer3D::DrawMesh(GetEditorCamera(), meshNode->GetTransformMatrix(), *meshNode->GetMesh(), meshNode->GetMaterials(), MaterialType::ObjectID);
+				if (It) It->AddPickingProxies(world, GetEditorCamera(), m_GizmoQuery);
 			}
-			i++;
 		}
-		i++;
+	}
 
-		DrawDebugShapes(GetMajorTab()->IsA<NodeClassEditor>() ? GetMajorTab()->As<NodeClassEditor>()->GetEditorWorld() : nullptr, GetEditorCamera(), &i, &IDs);
+	Vec2 ViewportPanel::ViewportToNDC(const Vec2& pos) const
+	{
+		return Vec2(pos.x / (float)GetWidth(), pos.y / (float)GetHeight()) * 2.0f - 1.0f;
+	}
+
+	Ray ViewportPanel::GetViewportRay(const Vec2& pos) const
+	{
+		return Ray::FromNDC(GetEditorCamera()->GetViewProjectionMatrix(), ViewportToNDC(pos));
+	}
 
-		int32_t id = m_PickingBuffer->ReadPixel_R32I(pos);
+	void ViewportPanel::HandleMousePick(const glm::ivec2& pos)
+	{
+		UpdateSceneQuery(GetPickingWorld(), true);
 
-		Node* selection = IDs.ContainsKey(id) ? IDs[id] : nullptr;
+		const Ray ray = GetViewportRay(pos);
+		SceneQueryHit hit, gizmoHit;
+		Node* selection = m_SceneQuery.Raycast(ray, hit) ? hit.Node : nullptr;
+		if (m_GizmoQuery.Raycast(ray, gizmoHit, selection ? hit.Distance : FLT_MAX))
+		{
+			selection = gizmoHit.Node;
+		}
 		SuoraLog("Selected Node: {0}", selection ? selection->GetName() : "None");
+
+		SelectNode(selection);
+	}
+
+	void ViewportPanel::HandleMarqueeSelection(bool& mousePickReady)
+	{
+		const Vec2 mousePos = EditorUI::GetInput();
+		if (!m_IsMarqueeSelecting)
+		{
+			if (!(IsInputValid() && IsInputMode(EditorInputEvent::None) && mousePickReady && NativeInput::GetKey(Key::LeftControl) && NativeInput::GetMouseButtonDown(Mouse::ButtonLeft)))
+			{
+				return;
+			}
+			m_IsMarqueeSelecting = true;
+			m_MarqueeStart = mousePos;
+		}
+
+		// Neither pick on mouse down, nor move the camera while dragging
+		mousePickReady = false;
+		if (NativeInput::GetMouseButton(Mouse::ButtonLeft))
+		{
+			return;
+		}
+		m_IsMarqueeSelecting = false;
+
+		const Vec2 rectMin = glm::min(m_MarqueeStart, mousePos);
+		const Vec2 rectMax = glm::max(m_MarqueeStart, mousePos);
+		if (rectMax.x - rectMin.x < 3.0f && rectMax.y - rectMin.y < 3.0f)
+		{
+			HandleMousePick(m_MarqueeStart);
+			return;
+		}
+
+		UpdateSceneQuery(GetPickingWorld(), true);
+		const Mat4 viewProjection = GetEditorCamera()->GetViewProjectionMatrix();
+		Array<Node3D*> nodes = m_SceneQuery.QueryBox(viewProjection, ViewportToNDC(rectMin), ViewportToNDC(rectMax));
+		for (Node3D* gizmoNode : m_GizmoQuery.QueryBox(viewProjection, ViewportToNDC(rectMin), ViewportToNDC(rectMax)))
+		{
+			nodes.Add(gizmoNode);
+		}
+
+		// The editor selects a single Object, so the Node closest to the camera wins
+		Node3D* closest = nullptr;
+		float closestDistance = FLT_MAX;
+		for (Node3D* node : nodes)
+		{
+			const float distance = Vec::Distance(node->GetPosition(), GetEditorCamera()->GetPosition());
+			if (distance < closestDistance)
+			{
+				closest = node;
+				closestDistance = distance;
+			}
+		}
+		SuoraLog("Marquee Selection: {0} Nodes", nodes.Size());
+
+		SelectNode(closest);
+	}
+
+	void ViewportPanel::SelectNode(Node* selection)
+	{
 		Node* actor = selection ? selection->GetActorNode() : nullptr;
 
-		Node* currentSelection = GetMajorTab()->IsA<NodeClassEditor>() ? GetMajorTab()->As<NodeClassEditor>()->m_SelectedObject->As<Node>() : nullptr;
+		Node* currentSelection = (GetMajorTab()->IsA<NodeClassEditor>() && GetMajorTab()->As<NodeClassEditor>()->m_SelectedObject) ? GetMajorTab()->As<NodeClassEditor>()->m_SelectedObject->As<Node>() : nullptr;
 
 		if (!currentSelection || !(selection && selection->IsChildOf(currentSelection))) selection = actor;
 
 		if (GetMajorTab()->IsA<NodeClassEditor>()) GetMajorTab()->As<NodeClassEditor>()->m_SelectedObject = selection;
 		else
 		{
-			SuoraError("Cannot handle 'selection' in ViewportPanel::HandleMousePick()");
+			SuoraError("Cannot handle 'selection' in ViewportPanel::SelectNode()");
 		}
-
-		m_Framebuffer->Bind();
 	}
 
 
@@ -204,13 +270,14 @@ namespace Suora
 					{
 						AssetDragDropNode = m_World->Spawn(ContentBrowser::s_DraggedAsset->As<Blueprint>());
 					}
+					// Once per drag; the dragged Node moves every frame, but is filtered out below
+					UpdateSceneQuery(m_World, false);
 				}
-				// Update Position each Frame
-				m_RParams.GetGBuffer()->Bind();
-				
-				const Vec2 ScreenPos = Vec2(EditorUI::GetInput().x / GetWidth() * (m_RParams.Resolution.x), EditorUI::GetInput().y / GetHeight() * (m_RParams.Resolution.y));
-				const Vec3 Position = m_RParams.GetGBuffer()->ReadPixel_RGB32F(ScreenPos, (int)GBuffer::WorldPosition);
-				if (AssetDragDropNode && AssetDragDropNode->IsA<Node3D>()) AssetDragDropNode->As<Node3D>()->SetPosition(Position);
+				// Update Position each Frame, on the surface below the cursor
+				Node* draggedNode = AssetDragDropNode;
+				SceneQueryHit placement;
+				m_SceneQuery.FindPlacement(GetViewportRay(EditorUI::GetInput()), placement, [draggedNode](Node3D* node) { return node != draggedNode && !(draggedNode && node->IsChildOf(draggedNode)); });
+				if (AssetDragDropNode && AssetDragDropNode->IsA<Node3D>()) AssetDragDropNode->As<Node3D>()->SetPosition(placement.Position);
 
 				if (NativeInput::GetMouseButtonUp(Mouse::ButtonLeft) && AssetDragDropNode)
 				{
@@ -444,9 +511,22 @@ namespace Suora
 			if (mousePickReady)
 			{
 				Node* node = GetMajorTab()->IsA<NodeClassEditor>() ? GetMajorTab()->As<NodeClassEditor>()->m_SelectedObject->As<Node>() : nullptr;
-				if (Node3D* node3D = node->As<Node3D>()) mousePickReady = !DrawTransformGizmo(node3D);
+				if (Node3D* node3D = node->As<Node3D>())
+				{
+					const NodeTransformState transformBefore = NodeTransformState::Capture(node3D);
+					mousePickReady = !DrawTransformGizmo(node3D);
+					// Recorded every frame of a drag, the UndoStack coalesces it into one entry
+					if (!(NodeTransformState::Capture(node3D) == transformBefore))
+					{
+						GetMajorTab()->MakeEditorChange(CreateRef<NodeTransformChange>(node3D, transformBefore));
+					}
+				}
 			}
 		}
+		if (GetMajorTab()->IsA<NodeClassEditor>() && GetMajorTab()->As<NodeClassEditor>()->m_CurrentPlayState != PlayState::Playing)
+		{
+			HandleMarqueeSelection(mousePickReady);
+		}
 		if (IsInputValid() && IsInputMode(EditorInputEvent::None) && mousePickReady && (GetMajorTab()->IsA<NodeClassEditor>() && GetMajorTab()->As<NodeClassEditor>()->m_CurrentPlayState != PlayState::Playing))
 		{
 			if (NativeInput::GetMouseButtonDown(Mouse::ButtonLeft))
@@ -469,6 +549,14 @@ namespace Suora
 		if (Engine::Get()->GetRenderPipeline()->IsA<RenderPipeline>())
 			RenderPipeline::RenderFramebufferIntoFramebuffer(*m_GizmoBuffer, *m_Framebuffer, *RenderPipeline::GetFullscreenPassShaderStatic(), glm::ivec4(0, 0, m_Framebuffer->GetSize()), "u_Texture", 0, false);
 
+		if (m_IsMarqueeSelecting)
+		{
+			const Vec2 rectMin = glm::min(m_MarqueeStart, EditorUI::GetInput());
+			const Vec2 rectSize = glm::max(m_MarqueeStart, EditorUI::GetInput()) - rectMin;
+			const Color highlight = EditorPreferences::Get()->UiHighlightColor;
+			EditorUI::DrawRect(rectMin.x, rectMin.y, rectSize.x, rectSize.y, 0.0f, Color(highlight.r, highlight.g, highlight.b, 0.15f));
+			EditorUI::DrawRectOutline(rectMin.x, rectMin.y, rectSize.x, rectSize.y, 1.0f, highlight);
+		}
 
 		RenderCommand::SetDepthTest(false);
 		RenderCommand::SetCullingMode(CullingMode::None);
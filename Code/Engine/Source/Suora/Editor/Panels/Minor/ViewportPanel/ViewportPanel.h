@@ -1,6 +1,7 @@
 #pragma once
 #include "Suora/Editor/Panels/MinorTab.h"
 #include "Suora/Renderer/RenderPipeline.h"
+#include "Suora/GameFramework/SceneQuery.h"
 #include "ViewportPanel.generated.h"
 
 #define _ENUM_BODY_6476475
@@ -19,13 +20,15 @@ namespace Suora
 	{
 		SUORA_CLASS(5487987495);
 	public:
-		virtual void DrawDebugGizmos(World* world, CameraNode* camera, int* pickingID, Map<int, Node*>* pickingMap, bool isHandlingMousePick) = 0;
+		virtual void DrawDebugGizmos(World* world, CameraNode* camera) = 0;
+		/** Makes the Gizmos selectable, by adding their shapes for the Nodes they represent */
+		virtual void AddPickingProxies(World* world, CameraNode* camera, SceneQuery& query) { }
 		virtual int32_t GetOrderIndex() const { return 0; }
 
 		void SetViewport(ViewportPanel* InViewportPanel) { m_ViewportPanel = InViewportPanel; }
 		ViewportPanel* GetViewport() const { return m_ViewportPanel; }
 
-		static Material* GizmoMaterial(bool useIdShader, int* i, const Vec3& color, const SuoraID& uuid = SuoraID("72b2a0e4-6541-4907-9527-47aa742ede45"));
+		static Material* GizmoMaterial(const Vec3& color, const SuoraID& uuid = SuoraID("72b2a0e4-6541-4907-9527-47aa742ede45"));
 
 	private:
 		ViewportPanel* m_ViewportPanel = nullptr;
@@ -57,7 +60,15 @@ namespace Suora
 		~ViewportPanel();
 
 	private:
-		Ref<Framebuffer> m_GizmoBuffer, m_PickingBuffer, m_TranformGizmoPickingBuffer;
+		Ref<Framebuffer> m_GizmoBuffer, m_TranformGizmoPickingBuffer;
+		/** Kept between interactions, and only refit or rebuilt when the MeshNodes of the World change */
+		SceneQuery m_SceneQuery;
+		/** The Gizmos face the camera, so their proxies are gathered for each interaction */
+		SceneQuery m_GizmoQuery;
+
+		/** Ctrl + Drag selects the front most Actor within the rectangle */
+		bool m_IsMarqueeSelecting = false;
+		Vec2 m_MarqueeStart = Vec2(0.0f);
 
 		int TransformGizmo_Tool = 1;
 		bool TransformGizmo_Local = false;
@@ -72,8 +83,15 @@ namespace Suora
 		Ref<Framebuffer> m_SelectionOutlineFramebuffer;
 		Ref<Shader> m_SelectionOutlineShader;
 		void DrawSelectionOutline(Node3D* node, const Color& color);
-		void DrawDebugShapes(World* world, CameraNode* camera, int* pickingID = nullptr, Map<int, Node*>* pickingMap = nullptr);
+		void DrawDebugShapes(World* world, CameraNode* camera);
+		World* GetPickingWorld() const;
+		/** Updates m_SceneQuery with the MeshNodes of the World, and rebuilds m_GizmoQuery from the pickable Gizmos */
+		void UpdateSceneQuery(World* world, bool includeGizmos);
+		Ray GetViewportRay(const Vec2& pos) const;
+		Vec2 ViewportToNDC(const Vec2& pos) const;
 		void HandleMousePick(const glm::ivec2& pos);
+		void HandleMarqueeSelection(bool& mousePickReady);
+		void SelectNode(Node* selection);
 		void DrawDebugView(Framebuffer& buffer, World& world, CameraNode& camera);
 		
 		void HandleAssetDragDrop();
@@ -194,7 +194,7 @@ namespace Suora
 		}
 	}
 
-	void ViewportShapeGizmos::DrawDebugGizmos(World* world, CameraNode* camera, int* pickingID, Map<int, Node*>* pickingMap, bool isHandlingMousePick)
+	void ViewportShapeGizmos::DrawDebugGizmos(World* world, CameraNode* camera)
 	{
 		Array<BoxShapeNode*> boxes = world->FindNodesByClass<BoxShapeNode>();
 		for (BoxShapeNode* box : boxes)
@@ -16,6 +16,7 @@
 #include "Suora/GameFramework/Nodes/Light/PointLightNode.h"
 #include "Suora/GameFramework/Nodes/Light/DirectionalLightNode.h"
 #include "Suora/GameFramework/InputModule.h"
+#include "Suora/Editor/Util/NodeTransaction.h"
 
 namespace Suora
 {
@@ -200,7 +201,10 @@ namespace Suora
 		{
 			if (NativeInput::GetKey(Key::LeftAlt) || NativeInput::GetKey(Key::RightAlt))
 			{
-				node->Duplicate();
+				if (Node* duplicate = node->Duplicate())
+				{
+					GetMajorTab()->MakeEditorChange(NodeLifetimeChange::Spawn(duplicate));
+				}
 			}
 			SetInputMode(EditorInputEvent::TransformGizmo);
 			RayRayTime(node->GetPosition(), dir, rayPos, rayDir, lastFrameTranlate_T, u, p1, p2);
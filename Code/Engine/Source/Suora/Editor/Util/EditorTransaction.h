@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <functional>
 
 namespace Suora
@@ -9,13 +10,22 @@ namespace Suora
 	{
 		EditorTransaction() {}
 		EditorTransaction(void* memory) { m_MemoryDependency = memory; }
+		virtual ~EditorTransaction() { }
 		virtual void Undo() { };
 		virtual void Redo() { };
 
+		/** Approximate size of the change, counted against MajorTab::UndoMemoryBudget */
+		virtual size_t GetMemorySize() const { return sizeof(EditorTransaction); }
+		/** Absorbs a later change with the same coalesce key: keeps this state before and takes the state after of next */
+		virtual bool Merge(const EditorTransaction& next) { return false; }
+
 		void TickMemory(void* from, void* to);
 
 		void* m_MemoryDependency = nullptr;
+		/** Changes with the same nonzero key, that are made in one mouse interaction (e.g. a gizmo drag), become one entry */
+		uint64_t m_CoalesceKey = 0;
 	private:
+		uint64_t m_Interaction = 0;
 		class MajorTab* m_MajorTab = nullptr;
 		friend class MajorTab;
 	};
@@ -25,6 +35,7 @@ namespace Suora
 
 		void Undo() override { m_Undo(*this); }
 		void Redo() override { m_Redo(*this); }
+		size_t GetMemorySize() const override { return sizeof(EditorLambdaChange); }
 
 		std::function<void(EditorLambdaChange&)> m_Undo;
 		std::function<void(EditorLambdaChange&)> m_Redo;
@@ -0,0 +1,371 @@
+#include "Precompiled.h"
+#include "NodeTransaction.h"
+#include "Suora/GameFramework/Node.h"
+#include "Suora/GameFramework/World.h"
+#include "Suora/Serialization/Yaml.h"
+#include "Suora/Reflection/Property.h"
+
+namespace Suora
+{
+
+	uint64_t EditorNodeIDs::GetID(Node* node)
+	{
+		if (!node) return 0;
+
+		auto it = s_IDs.find(node);
+		if (it != s_IDs.end())
+		{
+			// The address might belong to a Node that was deleted since, and is reused now
+			auto nodeIt = s_Nodes.find(it->second);
+			if (nodeIt != s_Nodes.end() && nodeIt->second.Get() == node)
+			{
+				return it->second;
+			}
+			s_IDs.erase(it);
+		}
+
+		const uint64_t id = s_NextID++;
+		Rebind(id, node);
+		return id;
+	}
+
+	Node* EditorNodeIDs::GetNode(uint64_t id)
+	{
+		auto it = s_Nodes.find(id);
+		return (it != s_Nodes.end()) ? it->second.Get() : nullptr;
+	}
+
+	void EditorNodeIDs::Rebind(uint64_t id, Node* node)
+	{
+		s_Nodes[id] = node;
+		s_IDs[node] = id;
+
+		if (s_Nodes.size() >= s_NextCleanupSize)
+		{
+			RemoveDeadIDs();
+			s_NextCleanupSize = std::max<size_t>(1024, s_Nodes.size() * 2);
+		}
+	}
+
+	void EditorNodeIDs::RemoveDeadIDs()
+	{
+		// IDs of deleted Nodes are kept on purpose, Undo might recreate them. Only the stale reverse lookups go.
+		for (auto it = s_IDs.begin(); it != s_IDs.end(); )
+		{
+			auto nodeIt = s_Nodes.find(it->second);
+			if (nodeIt == s_Nodes.end() || nodeIt->second.Get() != it->first)
+			{
+				it = s_IDs.erase(it);
+			}
+			else
+			{
+				it++;
+			}
+		}
+	}
+
+	NodePropertyValue NodePropertyValue::Read(Node* node, const ClassMemberProperty& member)
+	{
+		NodePropertyValue value;
+		switch (member.m_Property->GetType())
+		{
+		case PropertyType::Int32:			value.Value = *ClassMemberProperty::AccessMember<int32_t>(node, member.m_MemberOffset); break;
+		case PropertyType::Float:			value.Value = *ClassMemberProperty::AccessMember<float>(node, member.m_MemberOffset); break;
+		case PropertyType::Bool:			value.Value = *ClassMemberProperty::AccessMember<bool>(node, member.m_MemberOffset); break;
+		case PropertyType::Vec3:			value.Value = *ClassMemberProperty::AccessMember<Vec3>(node, member.m_MemberOffset); break;
+		case PropertyType::Vec4:			value.Value = *ClassMemberProperty::AccessMember<Vec4>(node, member.m_MemberOffset); break;
+		case PropertyType::ObjectPtr:		value.Value = *ClassMemberProperty::AccessMember<Asset*>(node, member.m_MemberOffset); break;
+		case PropertyType::Class:			value.Value = *ClassMemberProperty::AccessMember<Class>(node, member.m_MemberOffset); break;
+		case PropertyType::SubclassOf:		value.Value = *ClassMemberProperty::AccessMember<TSubclassOf>(node, member.m_MemberOffset); break;
+		case PropertyType::MaterialSlots:	value.Value = *ClassMemberProperty::AccessMember<MaterialSlots>(node, member.m_MemberOffset); break;
+		default: break;
+		}
+		return value;
+	}
+
+	void NodePropertyValue::Write(Node* node, const ClassMemberProperty& member) const
+	{
+		switch (member.m_Property->GetType())
+		{
+		case PropertyType::Int32:			*ClassMemberProperty::AccessMember<int32_t>(node, member.m_MemberOffset) = std::get<int32_t>(Value); break;
+		case PropertyType::Float:			*ClassMemberProperty::AccessMember<float>(node, member.m_MemberOffset) = std::get<float>(Value); break;
+		case PropertyType::Bool:			*ClassMemberProperty::AccessMember<bool>(node, member.m_MemberOffset) = std::get<bool>(Value); break;
+		case PropertyType::Vec3:			*ClassMemberProperty::AccessMember<Vec3>(node, member.m_MemberOffset) = std::get<Vec3>(Value); break;
+		case PropertyType::Vec4:			*ClassMemberProperty::AccessMember<Vec4>(node, member.m_MemberOffset) = std::get<Vec4>(Value); break;
+		case PropertyType::ObjectPtr:		*ClassMemberProperty::AccessMember<Asset*>(node, member.m_MemberOffset) = std::get<Asset*>(Value); break;
+		case PropertyType::Class:			*ClassMemberProperty::AccessMember<Class>(node, member.m_MemberOffset) = std::get<Class>(Value); break;
+		case PropertyType::SubclassOf:		*ClassMemberProperty::AccessMember<TSubclassOf>(node, member.m_MemberOffset) = std::get<TSubclassOf>(Value); break;
+		case PropertyType::MaterialSlots:	*ClassMemberProperty::AccessMember<MaterialSlots>(node, member.m_MemberOffset) = std::get<MaterialSlots>(Value); break;
+		default: break;
+		}
+	}
+
+	size_t NodePropertyValue::GetMemorySize() const
+	{
+		const MaterialSlots* slots = std::get_if<MaterialSlots>(&Value);
+		return sizeof(NodePropertyValue) + (slots ? slots->Materials.Size() * sizeof(Material*) : 0);
+	}
+
+	NodePropertyChange::NodePropertyChange(Node* node, const ClassMemberProperty& member, uint32_t propertyIndex, const NodePropertyValue& before, bool wasOverwritten)
+		: m_NodeID(EditorNodeIDs::GetID(node)), m_Member(&member), m_PropertyIndex(propertyIndex), m_Before(before), m_WasOverwritten(wasOverwritten)
+	{
+		m_After = NodePropertyValue::Read(node, member);
+		m_IsOverwritten = node->m_OverwrittenProperties.Contains(member.m_MemberName);
+		m_CoalesceKey = (m_NodeID << 20) | (uint64_t)(propertyIndex + 1);
+	}
+
+	void NodePropertyChange::Undo()
+	{
+		Apply(m_Before, m_WasOverwritten);
+	}
+
+	void NodePropertyChange::Redo()
+	{
+		Apply(m_After, m_IsOverwritten);
+	}
+
+	size_t NodePropertyChange::GetMemorySize() const
+	{
+		return sizeof(NodePropertyChange) - 2 * sizeof(NodePropertyValue) + m_Before.GetMemorySize() + m_After.GetMemorySize();
+	}
+
+	bool NodePropertyChange::Merge(const EditorTransaction& next)
+	{
+		const NodePropertyChange* change = dynamic_cast<const NodePropertyChange*>(&next);
+		if (!change || change->m_NodeID != m_NodeID || change->m_Member != m_Member) return false;
+
+		m_After = change->m_After;
+		m_IsOverwritten = change->m_IsOverwritten;
+		return true;
+	}
+
+	void NodePropertyChange::Apply(const NodePropertyValue& value, bool overwritten)
+	{
+		Node* node = EditorNodeIDs::GetNode(m_NodeID);
+		if (!node) return;
+
+		value.Write(node, *m_Member);
+		if (overwritten && !node->m_OverwrittenProperties.Contains(m_Member->m_MemberName))
+		{
+			node->m_OverwrittenProperties.Add(m_Member->m_MemberName);
+		}
+		else if (!overwritten && node->m_OverwrittenProperties.Contains(m_Member->m_MemberName))
+		{
+			node->m_OverwrittenProperties.Remove(m_Member->m_MemberName);
+		}
+		node->MarkPropertyDirty(m_PropertyIndex);
+	}
+
+	NodeTransformState NodeTransformState::Capture(Node3D* node)
+	{
+		NodeTransformState state;
+		state.LocalTransform = node->m_LocalTransformMatrix;
+		state.WorldTransform = node->m_WorldTransformMatrix;
+		return state;
+	}
+
+	void NodeTransformState::Apply(Node3D* node) const
+	{
+		node->m_WorldTransformMatrix = WorldTransform;
+		node->TickTransform(true);
+		// TickTransform(true) derived the local matrix from the world matrix
+		node->m_LocalTransformMatrix = LocalTransform;
+	}
+
+	bool NodeTransformState::operator==(const NodeTransformState& other) const
+	{
+		return LocalTransform == other.LocalTransform && WorldTransform == other.WorldTransform;
+	}
+
+	NodeTransformChange::NodeTransformChange(Node3D* node, const NodeTransformState& before)
+		: m_NodeID(EditorNodeIDs::GetID(node)), m_Before(before), m_After(NodeTransformState::Capture(node))
+	{
+		// The lowest 20 bits are zero, NodePropertyChanges never share the key
+		m_CoalesceKey = m_NodeID << 20;
+	}
+
+	void NodeTransformChange::Undo()
+	{
+		if (Node* node = EditorNodeIDs::GetNode(m_NodeID))
+		{
+			m_Before.Apply(node->As<Node3D>());
+		}
+	}
+
+	void NodeTransformChange::Redo()
+	{
+		if (Node* node = EditorNodeIDs::GetNode(m_NodeID))
+		{
+			m_After.Apply(node->As<Node3D>());
+		}
+	}
+
+	bool NodeTransformChange::Merge(const EditorTransaction& next)
+	{
+		const NodeTransformChange* change = dynamic_cast<const NodeTransformChange*>(&next);
+		if (!change || change->m_NodeID != m_NodeID) return false;
+
+		m_After = change->m_After;
+		return true;
+	}
+
+	Ref<NodeReparentChange> NodeReparentChange::Reparent(Node* node, Node* parent)
+	{
+		Ref<NodeReparentChange> change = CreateRef<NodeReparentChange>();
+		change->m_NodeID = EditorNodeIDs::GetID(node);
+		change->m_OldParentID = EditorNodeIDs::GetID(node->GetParent());
+		change->m_OldChildIndex = node->GetChildIndex();
+		Node3D* node3D = node->As<Node3D>();
+		change->m_HasTransform = node3D != nullptr;
+		if (node3D) change->m_OldTransform = NodeTransformState::Capture(node3D);
+
+		node->SetParent(parent);
+
+		change->m_NewParentID = EditorNodeIDs::GetID(node->GetParent());
+		change->m_NewChildIndex = node->GetChildIndex();
+		if (node3D) change->m_NewTransform = NodeTransformState::Capture(node3D);
+		return change;
+	}
+
+	void NodeReparentChange::Undo()
+	{
+		Apply(m_OldParentID, m_OldChildIndex, m_OldTransform);
+	}
+
+	void NodeReparentChange::Redo()
+	{
+		Apply(m_NewParentID, m_NewChildIndex, m_NewTransform);
+	}
+
+	void NodeReparentChange::Apply(uint64_t parentID, int32_t childIndex, const NodeTransformState& transform)
+	{
+		Node* node = EditorNodeIDs::GetNode(m_NodeID);
+		Node* parent = EditorNodeIDs::GetNode(parentID);
+		if (!node || (parentID != 0 && !parent)) return;
+
+		node->SetParent(parent);
+		node->SetChildIndex(childIndex);
+		if (m_HasTransform && node->IsA<Node3D>())
+		{
+			transform.Apply(node->As<Node3D>());
+		}
+	}
+
+	static void CollectSubtree(Node* node, Array<Node*>& outNodes)
+	{
+		outNodes.Add(node);
+		for (int32_t i = 0; i < node->GetChildCount(); i++)
+		{
+			CollectSubtree(node->GetChild(i), outNodes);
+		}
+	}
+
+	Ref<NodeLifetimeChange> NodeLifetimeChange::Spawn(Node* node)
+	{
+		Ref<NodeLifetimeChange> change = CreateRef<NodeLifetimeChange>();
+		change->m_IsSpawn = true;
+		change->m_Subtree.Add({ EditorNodeIDs::GetID(node), node->m_IsActorLayer });
+		return change;
+	}
+
+	Ref<NodeLifetimeChange> NodeLifetimeChange::Destroy(Node* node)
+	{
+		Ref<NodeLifetimeChange> change = CreateRef<NodeLifetimeChange>();
+		change->m_IsSpawn = false;
+		change->m_Subtree.Add({ EditorNodeIDs::GetID(node), node->m_IsActorLayer });
+		change->Remove();
+		return change;
+	}
+
+	void NodeLifetimeChange::Undo()
+	{
+		if (m_IsSpawn) Remove();
+		else Restore();
+	}
+
+	void NodeLifetimeChange::Redo()
+	{
+		if (m_IsSpawn) Restore();
+		else Remove();
+	}
+
+	size_t NodeLifetimeChange::GetMemorySize() const
+	{
+		return sizeof(NodeLifetimeChange) + m_Snapshot.capacity() + m_Subtree.Size() * sizeof(SubtreeNode);
+	}
+
+	void NodeLifetimeChange::Capture(Node* node)
+	{
+		m_Subtree.Clear();
+		m_ParentID = EditorNodeIDs::GetID(node->GetParent());
+		m_ChildIndex = node->GetChildIndex();
+
+		Array<Node*> subtree;
+		CollectSubtree(node, subtree);
+		for (Node* it : subtree)
+		{
+			SubtreeNode entry = { EditorNodeIDs::GetID(it), it->m_IsActorLayer };
+			if (Node3D* node3D = it->As<Node3D>())
+			{
+				entry.IsNode3D = true;
+				entry.Transform = NodeTransformState::Capture(node3D);
+			}
+			m_Subtree.Add(entry);
+		}
+
+		// Same as Node::Duplicate()
+		Yaml::Node serialized;
+		node->Serialize(serialized);
+		serialized["RootParentClass"] = node->GetClass().ToString();
+		Yaml::Serialize(serialized, m_Snapshot);
+		m_Snapshot.shrink_to_fit();
+	}
+
+	void NodeLifetimeChange::Restore()
+	{
+		Node* parent = EditorNodeIDs::GetNode(m_ParentID);
+		Node* existing = EditorNodeIDs::GetNode(m_Subtree[0].ID);
+		if (m_Snapshot.empty() || !parent || !parent->GetWorld() || (existing && !existing->IsPendingKill())) return;
+
+		Yaml::Node serialized;
+		Yaml::Parse(serialized, m_Snapshot);
+		Node* node = Node::Deserialize(serialized, true);
+		if (!node) return;
+
+		if (parent->IsInitialized())
+		{
+			node->InitializeNode(*parent->GetWorld());
+		}
+		node->SetParent(parent);
+		node->SetChildIndex(m_ChildIndex);
+		if (node->IsA<Node3D>())
+		{
+			node->As<Node3D>()->TickTransform();
+		}
+
+		Array<Node*> subtree;
+		CollectSubtree(node, subtree);
+		for (int32_t i = 0; i < subtree.Size() && i < m_Subtree.Size(); i++)
+		{
+			subtree[i]->m_IsActorLayer = m_Subtree[i].IsActorLayer;
+			EditorNodeIDs::Rebind(m_Subtree[i].ID, subtree[i]);
+			// Pre-order, so the parent is exact before its children are
+			if (m_Subtree[i].IsNode3D && subtree[i]->IsA<Node3D>())
+			{
+				m_Subtree[i].Transform.Apply(subtree[i]->As<Node3D>());
+			}
+		}
+	}
+
+	void NodeLifetimeChange::Remove()
+	{
+		Node* node = EditorNodeIDs::GetNode(m_Subtree[0].ID);
+		if (node && !node->IsPendingKill())
+		{
+			// Every later change is undone at this point, so this is the state to recreate
+			Capture(node);
+			node->Destroy();
+		}
+	}
+
+}
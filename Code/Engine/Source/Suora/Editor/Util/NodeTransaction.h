@@ -0,0 +1,157 @@
+#pragma once
+#include <cstdint>
+#include <variant>
+#include <unordered_map>
+#include "EditorTransaction.h"
+#include "Suora/Core/Base.h"
+#include "Suora/Common/Array.h"
+#include "Suora/Common/VectorUtils.h"
+#include "Suora/Core/Object/Pointer.h"
+#include "Suora/Reflection/Class.h"
+#include "Suora/Reflection/SubclassOf.h"
+#include "Suora/Assets/Material.h"
+
+namespace Suora
+{
+	class Node;
+	class Node3D;
+	class Asset;
+	struct ClassMemberProperty;
+
+	/** IDs for Nodes in the editor, that stay the same when Undo or Redo recreate a destroyed Node.
+	 *  Transactions refer to Nodes only by these IDs, never by pointer.                           */
+	class EditorNodeIDs
+	{
+	public:
+		/** Assigns an ID on first use; 0 for nullptr */
+		static uint64_t GetID(Node* node);
+		/** nullptr, if no living Node has the ID */
+		static Node* GetNode(uint64_t id);
+		/** Hands the ID over to a recreated Node */
+		static void Rebind(uint64_t id, Node* node);
+
+	private:
+		static void RemoveDeadIDs();
+
+		inline static std::unordered_map<uint64_t, Ptr<Node>> s_Nodes;
+		inline static std::unordered_map<Node*, uint64_t> s_IDs;
+		inline static uint64_t s_NextID = 1;
+		inline static size_t s_NextCleanupSize = 1024;
+	};
+
+	/** A copy of a reflected property, of any type that the NodeSerialization supports */
+	struct NodePropertyValue
+	{
+		std::variant<std::monostate, int32_t, float, bool, Vec3, Vec4, Asset*, Class, TSubclassOf, MaterialSlots> Value;
+
+		static NodePropertyValue Read(Node* node, const ClassMemberProperty& member);
+		void Write(Node* node, const ClassMemberProperty& member) const;
+		size_t GetMemorySize() const;
+	};
+
+	/** An edit of one reflected property, see NodeDetails */
+	struct NodePropertyChange : public EditorTransaction
+	{
+		/** Call after the edit; before is the value the property had prior to it */
+		NodePropertyChange(Node* node, const ClassMemberProperty& member, uint32_t propertyIndex, const NodePropertyValue& before, bool wasOverwritten);
+
+		void Undo() override;
+		void Redo() override;
+		size_t GetMemorySize() const override;
+		bool Merge(const EditorTransaction& next) override;
+
+	private:
+		void Apply(const NodePropertyValue& value, bool overwritten);
+
+		uint64_t m_NodeID = 0;
+		const ClassMemberProperty* m_Member = nullptr;
+		uint32_t m_PropertyIndex = 0;
+		NodePropertyValue m_Before, m_After;
+		bool m_WasOverwritten = false, m_IsOverwritten = false;
+	};
+
+	/** Both matrices of a Node3D. Deriving one from the other is not exact, so Undo restores both bit for bit */
+	struct NodeTransformState
+	{
+		Mat4 LocalTransform = Mat4(1.0f);
+		Mat4 WorldTransform = Mat4(1.0f);
+
+		static NodeTransformState Capture(Node3D* node);
+		/** Also updates the Transforms of the children */
+		void Apply(Node3D* node) const;
+		bool operator==(const NodeTransformState& other) const;
+	};
+
+	/** A local transform edit, e.g. by the transform gizmo. Every frame of a drag is recorded, but coalesced into one entry */
+	struct NodeTransformChange : public EditorTransaction
+	{
+		NodeTransformChange(Node3D* node, const NodeTransformState& before);
+
+		void Undo() override;
+		void Redo() override;
+		size_t GetMemorySize() const override { return sizeof(NodeTransformChange); }
+		bool Merge(const EditorTransaction& next) override;
+
+	private:
+		uint64_t m_NodeID = 0;
+		NodeTransformState m_Before, m_After;
+	};
+
+	struct NodeReparentChange : public EditorTransaction
+	{
+		/** Reparents the Node and returns the change */
+		static Ref<NodeReparentChange> Reparent(Node* node, Node* parent);
+
+		void Undo() override;
+		void Redo() override;
+		size_t GetMemorySize() const override { return sizeof(NodeReparentChange); }
+
+	private:
+		void Apply(uint64_t parentID, int32_t childIndex, const NodeTransformState& transform);
+
+		uint64_t m_NodeID = 0;
+		uint64_t m_OldParentID = 0, m_NewParentID = 0;
+		int32_t m_OldChildIndex = -1, m_NewChildIndex = -1;
+		/** Reparenting keeps the world Transform, but recalculates the local one */
+		bool m_HasTransform = false;
+		NodeTransformState m_OldTransform, m_NewTransform;
+	};
+
+	/* Spawning or destroying a Node with its children. The subtree is serialized whenever the change removes it, which
+	 * also picks up a parent that was assigned after spawning; the snapshot covers that subtree only, so the cost
+	 * scales with the edit and not with the World. Recreated Nodes take over the IDs of the removed ones, so older
+	 * entries of the UndoStack keep working on them.                                                               */
+	struct NodeLifetimeChange : public EditorTransaction
+	{
+		/** Call after the Node was created, e.g. by Node::Duplicate() or World::Spawn() */
+		static Ref<NodeLifetimeChange> Spawn(Node* node);
+		/** Destroys the Node and returns the change */
+		static Ref<NodeLifetimeChange> Destroy(Node* node);
+
+		void Undo() override;
+		void Redo() override;
+		size_t GetMemorySize() const override;
+
+	private:
+		void Capture(Node* node);
+		void Restore();
+		void Remove();
+
+		struct SubtreeNode
+		{
+			uint64_t ID = 0;
+			bool IsActorLayer = false;
+			/** The snapshot only keeps the world Transforms as text */
+			bool IsNode3D = false;
+			NodeTransformState Transform;
+		};
+
+		bool m_IsSpawn = false;
+		uint64_t m_ParentID = 0;
+		int32_t m_ChildIndex = -1;
+		/** Pre-order, matches the hierarchy of the snapshot. The first entry is the removed Node itself */
+		Array<SubtreeNode> m_Subtree;
+		std::string m_Snapshot;
+	};
+
+}
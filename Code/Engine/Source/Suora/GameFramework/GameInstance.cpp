@@ -1,10 +1,12 @@
 #include "Precompiled.h"
 #include "GameInstance.h"
 #include "World.h"
+#include "LevelStreamer.h"
 #include "Suora/Core/Engine.h"
 #include "Suora/Assets/Level.h"
 #include "Suora/Renderer/Framebuffer.h"
 #include "Suora/Renderer/RenderPipeline.h"
+#include "Suora/Debug/Profiler.h"
 #include "InputModule.h"
 
 namespace Suora
@@ -12,7 +14,7 @@ namespace Suora
 
 	GameInstance::GameInstance()
 	{
-		
+		m_LevelStreamer = CreateRef<LevelStreamer>(this);
 	}
 	void GameInstance::Initialize()
 	{
@@ -43,6 +45,8 @@ namespace Suora
 	GameInstance::~GameInstance()
 	{
 		m_CurrentWorld = nullptr;
+		// Waits for pending loads, before their Worlds are gone
+		m_LevelStreamer = nullptr;
 		for (int32_t i = 0; i < m_Worlds.Size(); i++)
 		{
 			delete m_Worlds[i];
@@ -65,6 +69,24 @@ namespace Suora
 		return world;
 	}
 
+	World* GameInstance::LoadLevelAsync(Blueprint* level)
+	{
+		LevelLoadParams params;
+		params.SwitchWhenLoaded = true;
+		Ref<LevelLoadRequest> request = m_LevelStreamer->LoadLevelAsync(level, params);
+		return request ? request->GetWorld() : nullptr;
+	}
+
+	bool GameInstance::IsLoadingLevel() const
+	{
+		return m_LevelStreamer->IsLoading();
+	}
+
+	float GameInstance::GetLevelLoadingProgress() const
+	{
+		return m_LevelStreamer->GetProgress();
+	}
+
 	World* GameInstance::CreateWorld()
 	{
 		World* world = new World();
@@ -73,6 +95,20 @@ namespace Suora
 		return world;
 	}
 
+	void GameInstance::DestroyWorld(World* world)
+	{
+		const int32_t index = m_Worlds.IndexOf(world);
+		if (index < 0)
+		{
+			SUORA_ASSERT(false, "World must be known to GameInstance!");
+			return;
+		}
+
+		if (m_CurrentWorld.Get() == world) m_CurrentWorld = nullptr;
+		m_Worlds.RemoveAt(index);
+		delete world;
+	}
+
 	void GameInstance::SwitchToWorld(World* world)
 	{
 		for (World* It : m_Worlds)
@@ -94,10 +130,13 @@ namespace Suora
 
 	void GameInstance::Update(float deltaTime)
 	{
+		SUORA_PROFILE_SCOPE("GameInstance::Update");
+
 		for (auto& It : m_GameModules)
 		{
 			It->Update(deltaTime);
 		}
+		m_LevelStreamer->Update();
 		if (m_CurrentWorld)
 		{
 			m_CurrentWorld->Update(deltaTime);
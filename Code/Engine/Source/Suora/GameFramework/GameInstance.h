@@ -9,6 +9,7 @@ namespace Suora
 	class Level;
 	class World;
 	class Engine;
+	class LevelStreamer;
 
 	class GameModule;
 
@@ -23,8 +24,19 @@ namespace Suora
 
 		FUNCTION(Callable)
 		World* LoadLevel(Blueprint* level);
+		/** Loads the Level in the background and switches to its World once it is loaded, see LevelStreamer.
+		 *  The World is destroyed again, if the load fails or is cancelled. */
+		FUNCTION(Callable)
+		World* LoadLevelAsync(Blueprint* level);
+		FUNCTION(Callable, Pure)
+		bool IsLoadingLevel() const;
+		/** Combined progress of all pending Level loads, for loading screens */
+		FUNCTION(Callable, Pure)
+		float GetLevelLoadingProgress() const;
 		FUNCTION(Callable)
 		World* CreateWorld();
+		/** Deletes a World of CreateWorld(), the GameInstance is left without a current World if it was the current one */
+		void DestroyWorld(World* world);
 		FUNCTION(Callable)
 		void SwitchToWorld(World* world);
 		FUNCTION(Callable, Pure)
@@ -33,6 +45,7 @@ namespace Suora
 		void Update(float deltaTime);
 
 		Engine* GetEngine() const { return m_Engine; }
+		LevelStreamer& GetLevelStreamer() const { return *m_LevelStreamer; }
 		Framebuffer* GetFinalFramebuffer() const;
 	private:
 		Engine* m_Engine = nullptr;
@@ -40,6 +53,7 @@ namespace Suora
 		Ptr<World> m_CurrentWorld;
 		Ref<Framebuffer> m_Framebuffer;
 		Array<Ref<GameModule>> m_GameModules;
+		Ref<LevelStreamer> m_LevelStreamer;
 
 		friend class Engine;
 	};
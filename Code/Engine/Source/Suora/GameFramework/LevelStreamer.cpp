@@ -0,0 +1,257 @@
+#include "Precompiled.h"
+#include "LevelStreamer.h"
+#include <chrono>
+#include "GameInstance.h"
+#include "Node.h"
+#include "World.h"
+#include "Suora/Assets/Level.h"
+
+namespace Suora
+{
+
+	float LevelLoadRequest::GetProgress() const
+	{
+		switch (m_State)
+		{
+		case LevelLoadState::Instantiating: return 0.0f;
+		case LevelLoadState::Attaching: return 0.5f + 0.5f * (m_Staged.NodeCount ? (float)m_AttachedNodes / m_Staged.NodeCount : 1.0f);
+		default: return 1.0f;
+		}
+	}
+
+	Node* LevelLoadRequest::GetRoot() const
+	{
+		return m_Root.Get();
+	}
+
+	LevelStreamer::LevelStreamer(GameInstance* gameInstance)
+		: m_GameInstance(gameInstance)
+	{
+	}
+
+	LevelStreamer::~LevelStreamer()
+	{
+		// The worker threads still reference the Level assets, they have to finish before anything is torn down
+		for (const Ref<LevelLoadRequest>& request : m_Requests)
+		{
+			// Instantiations that did not start yet are skipped
+			request->m_Task.Cancel();
+			request->m_Task.Wait();
+			if (request->m_Task.IsReady()) request->m_Staged = request->m_Task.Get();
+			FinishRequest(*request, LevelLoadState::Cancelled);
+		}
+	}
+
+	Ref<LevelLoadRequest> LevelStreamer::LoadLevelAsync(Blueprint* level, const LevelLoadParams& params)
+	{
+		if (!level) return nullptr;
+
+		Ref<LevelLoadRequest> request = CreateRef<LevelLoadRequest>();
+		request->m_Level = level;
+		request->m_IsSubLevel = params.TargetWorld != nullptr;
+		request->m_World = params.TargetWorld ? params.TargetWorld : m_GameInstance->CreateWorld();
+		request->m_SwitchWhenLoaded = params.SwitchWhenLoaded && !request->m_IsSubLevel;
+		request->m_Task = TaskScheduler::Run([level]() { return Instantiate(level); }, TaskPriority::Low, "LevelStreamer::Instantiate");
+		m_Requests.Add(request);
+
+		return request;
+	}
+
+	void LevelStreamer::Unload(const Ref<LevelLoadRequest>& request)
+	{
+		if (!request) return;
+
+		if (!request->IsDone())
+		{
+			// Resolved in Update(); skips the instantiation, unless it already started
+			request->m_UnloadRequested = true;
+			request->m_Task.Cancel();
+			return;
+		}
+		if (request->m_State == LevelLoadState::Loaded && !m_PendingUnloads.Contains(request))
+		{
+			m_PendingUnloads.Add(request);
+		}
+	}
+
+	LevelStreamer::StagedLevel LevelStreamer::Instantiate(Blueprint* level)
+	{
+		StagedLevel staged;
+		Object* instance = level->CreateInstance(false);
+		staged.Root = instance ? instance->As<Node>() : nullptr;
+		if (!staged.Root)
+		{
+			delete instance;
+			return staged;
+		}
+		staged.Root->m_IsActorLayer = true;
+		staged.NodeCount = 1;
+
+		// The children are detached directly, so the tree is restored exactly as it was deserialized
+		staged.Actors = staged.Root->m_Children;
+		staged.Root->m_Children.Clear();
+		Array<Node*> stack;
+		for (Node* actor : staged.Actors)
+		{
+			actor->m_Parent = nullptr;
+
+			uint32_t count = 0;
+			stack.Add(actor);
+			while (!stack.IsEmpty())
+			{
+				Node* node = stack[stack.Last()];
+				stack.RemoveLastItem();
+				count++;
+				for (Node* child : node->m_Children) stack.Add(child);
+			}
+			staged.ActorNodeCounts.Add(count);
+			staged.NodeCount += count;
+		}
+		return staged;
+	}
+
+	void LevelStreamer::DeleteStaged(StagedLevel& staged, int32_t firstActor)
+	{
+		for (int32_t i = firstActor; i < staged.Actors.Size(); i++)
+		{
+			delete staged.Actors[i];
+		}
+		// Once attaching began, the Root belongs to the World
+		if (firstActor == 0 && staged.Root && !staged.Root->GetWorld())
+		{
+			delete staged.Root;
+		}
+		staged = StagedLevel();
+	}
+
+	void LevelStreamer::BeginAttach(LevelLoadRequest& request)
+	{
+		Node* root = request.m_Staged.Root;
+		root->InitializeNode(*request.m_World);
+		request.m_Root = root;
+		request.m_AttachedNodes = 1;
+		if (!request.m_IsSubLevel)
+		{
+			request.m_World->m_SourceLevel = request.m_Level->As<Level>();
+		}
+		request.m_State = LevelLoadState::Attaching;
+	}
+
+	uint32_t LevelStreamer::AttachActor(LevelLoadRequest& request)
+	{
+		Node* root = request.m_Root.Get();
+		const int32_t index = request.m_NextActor++;
+		Node* actor = request.m_Staged.Actors[index];
+
+		actor->m_Parent = root;
+		root->m_Children.Add(actor);
+		actor->InitializeNode(*request.m_World);
+
+		request.m_AttachedNodes += request.m_Staged.ActorNodeCounts[index];
+		return request.m_Staged.ActorNodeCounts[index];
+	}
+
+	void LevelStreamer::FinishRequest(LevelLoadRequest& request, LevelLoadState state)
+	{
+		DeleteStaged(request.m_Staged, request.m_NextActor);
+		request.m_State = state;
+
+		if (state == LevelLoadState::Loaded)
+		{
+			SUORA_INFO(LogCategory::Gameplay, "Loaded Level {0}", request.m_Level->GetAssetName());
+			if (request.m_SwitchWhenLoaded)
+			{
+				m_GameInstance->SwitchToWorld(request.m_World);
+			}
+		}
+		else if (state == LevelLoadState::Failed)
+		{
+			SUORA_ERROR(LogCategory::Gameplay, "Failed to load Level {0}", request.m_Level->GetAssetName());
+		}
+
+		// Nothing else knows about the World of a Level, that never made it
+		if (state != LevelLoadState::Loaded && !request.m_IsSubLevel && m_GameInstance)
+		{
+			m_GameInstance->DestroyWorld(request.m_World);
+			request.m_World = nullptr;
+		}
+	}
+
+	void LevelStreamer::Update()
+	{
+		const auto deadline = std::chrono::steady_clock::now() + std::chrono::duration<float, std::milli>(m_FrameBudget);
+		bool attachedAny = false;
+
+		for (const Ref<LevelLoadRequest>& request : m_PendingUnloads)
+		{
+			if (Node* root = request->m_Root.Get()) root->Destroy();
+			request->m_State = LevelLoadState::Unloaded;
+		}
+		m_PendingUnloads.Clear();
+
+		for (const Ref<LevelLoadRequest>& request : m_Requests)
+		{
+			if (request->m_State == LevelLoadState::Instantiating)
+			{
+				if (request->m_Task.GetStatus() == TaskStatus::Cancelled)
+				{
+					FinishRequest(*request, LevelLoadState::Cancelled);
+					continue;
+				}
+				if (!request->m_Task.IsReady()) continue;
+
+				request->m_Staged = request->m_Task.Get();
+				request->m_Task = Task<StagedLevel>();
+				if (request->m_UnloadRequested)
+				{
+					FinishRequest(*request, LevelLoadState::Cancelled);
+					continue;
+				}
+				if (!request->m_Staged.Root)
+				{
+					FinishRequest(*request, LevelLoadState::Failed);
+					continue;
+				}
+				BeginAttach(*request);
+			}
+
+			if (request->m_State == LevelLoadState::Attaching)
+			{
+				if (request->m_UnloadRequested || !request->m_Root)
+				{
+					if (Node* root = request->m_Root.Get()) root->Destroy();
+					FinishRequest(*request, LevelLoadState::Cancelled);
+					continue;
+				}
+				while (request->m_NextActor < request->m_Staged.Actors.Size())
+				{
+					if (attachedAny && std::chrono::steady_clock::now() >= deadline) break;
+					AttachActor(*request);
+					attachedAny = true;
+				}
+				if (request->m_NextActor == request->m_Staged.Actors.Size())
+				{
+					FinishRequest(*request, LevelLoadState::Loaded);
+				}
+			}
+		}
+
+		for (int32_t i = m_Requests.Last(); i >= 0; i--)
+		{
+			if (m_Requests[i]->IsDone()) m_Requests.RemoveAt(i);
+		}
+	}
+
+	float LevelStreamer::GetProgress() const
+	{
+		if (m_Requests.IsEmpty()) return 1.0f;
+
+		float progress = 0.0f;
+		for (const Ref<LevelLoadRequest>& request : m_Requests)
+		{
+			progress += request->GetProgress();
+		}
+		return progress / m_Requests.Size();
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,122 @@
+#pragma once
+#include <cstdint>
+#include "Suora/Common/Array.h"
+#include "Suora/Core/Base.h"
+#include "Suora/Core/TaskScheduler.h"
+#include "Suora/Core/Object/Pointer.h"
+
+namespace Suora
+{
+	class Blueprint;
+	class GameInstance;
+	class Node;
+	class World;
+
+	enum class LevelLoadState : uint8_t
+	{
+		/** The Node tree is deserialized on a worker thread */
+		Instantiating = 0,
+		/** The Node tree is attached to the World, a few Actors per frame */
+		Attaching,
+		Loaded,
+		Unloaded,
+		Cancelled,
+		Failed
+	};
+
+	struct LevelLoadParams
+	{
+		/** Attaches the Level as a sub-level to this World, instead of loading it into a new World */
+		World* TargetWorld = nullptr;
+		/** Switches the GameInstance to the new World once it is loaded, only for Levels with their own World */
+		bool SwitchWhenLoaded = false;
+	};
+
+	/** Handle of an asynchronous Level load, created by the LevelStreamer */
+	class LevelLoadRequest
+	{
+	public:
+		LevelLoadState GetState() const { return m_State; }
+		bool IsDone() const { return m_State != LevelLoadState::Instantiating && m_State != LevelLoadState::Attaching; }
+		/** 0 to 1, instantiating counts as the first half and attaching as the second. Meant for loading screens. */
+		float GetProgress() const;
+
+		Blueprint* GetLevel() const { return m_Level; }
+		/** Valid right away, the World is empty until the Level is attached.
+		 *  A World of its own is destroyed if the load fails or is cancelled, this returns nullptr then. */
+		World* GetWorld() const { return m_World; }
+		/** The root of the Level in the World, once attaching started */
+		Node* GetRoot() const;
+		bool IsSubLevel() const { return m_IsSubLevel; }
+
+	private:
+		/** A Node tree, that is not part of any World yet */
+		struct StagedLevel
+		{
+			Node* Root = nullptr;
+			/** The children of the Root, detached so the Root can enter the World on its own */
+			Array<Node*> Actors;
+			Array<uint32_t> ActorNodeCounts;
+			uint32_t NodeCount = 0;
+		};
+
+		Blueprint* m_Level = nullptr;
+		World* m_World = nullptr;
+		Ptr<Node> m_Root;
+		bool m_IsSubLevel = false;
+		bool m_SwitchWhenLoaded = false;
+		bool m_UnloadRequested = false;
+		LevelLoadState m_State = LevelLoadState::Instantiating;
+
+		Task<StagedLevel> m_Task;
+		StagedLevel m_Staged;
+		int32_t m_NextActor = 0;
+		uint32_t m_AttachedNodes = 0;
+
+		friend class LevelStreamer;
+	};
+
+	/* Loads Levels without stalling the game. Deserializing the Level composition and instantiating its Nodes happens
+	 * on a worker thread, into a Node tree that is detached from any World. The main thread then attaches the tree
+	 * Actor by Actor (the direct children of the Level root), within a time budget per frame, so every Actor enters
+	 * the World complete. Owned and updated by the GameInstance, see also LevelStreamingVolumeNode. */
+	class LevelStreamer
+	{
+	public:
+		LevelStreamer(GameInstance* gameInstance);
+		~LevelStreamer();
+
+		Ref<LevelLoadRequest> LoadLevelAsync(Blueprint* level, const LevelLoadParams& params = LevelLoadParams());
+		/** Cancels a pending load, or removes an attached Level from its World. Deferred to the next Update(),
+		*   so it is safe to call while the World resolves its pending kills. */
+		void Unload(const Ref<LevelLoadRequest>& request);
+
+		void Update();
+
+		/** Milliseconds per frame, that are spent attaching Nodes. At least one Actor is attached every frame. */
+		void SetFrameBudget(float milliseconds) { m_FrameBudget = milliseconds; }
+		float GetFrameBudget() const { return m_FrameBudget; }
+
+		bool IsLoading() const { return !m_Requests.IsEmpty(); }
+		uint32_t GetPendingRequestCount() const { return (uint32_t)m_Requests.Size(); }
+		/** Combined progress of all pending requests, 1 if nothing is loading */
+		float GetProgress() const;
+
+	private:
+		using StagedLevel = LevelLoadRequest::StagedLevel;
+
+		static StagedLevel Instantiate(Blueprint* level);
+		static void DeleteStaged(StagedLevel& staged, int32_t firstActor);
+
+		void BeginAttach(LevelLoadRequest& request);
+		/** Returns the number of attached Nodes */
+		uint32_t AttachActor(LevelLoadRequest& request);
+		void FinishRequest(LevelLoadRequest& request, LevelLoadState state);
+
+		GameInstance* m_GameInstance = nullptr;
+		Array<Ref<LevelLoadRequest>> m_Requests;
+		Array<Ref<LevelLoadRequest>> m_PendingUnloads;
+		float m_FrameBudget = 4.0f;
+	};
+
+}
\ No newline at end of file
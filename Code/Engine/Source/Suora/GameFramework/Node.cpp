@@ -1,6 +1,7 @@
 #include "Precompiled.h"
 #include "Node.h"
 #include "World.h"
+#include "NodeAllocator.h"
 
 #define GLM_ENABLE_EXPERIMENTAL
 #include <glm/gtx/quaternion.hpp>
@@ -56,6 +57,24 @@ namespace Suora
 		}
 	}
 
+	void* Node::operator new(size_t size)
+	{
+		return NodeAllocator::Allocate(size);
+	}
+	void Node::operator delete(void* ptr, size_t size)
+	{
+		NodeAllocator::Free(ptr, size);
+	}
+	void* Node::operator new(size_t size, std::align_val_t alignment)
+	{
+		// Over-aligned Nodes bypass the pools
+		return ::operator new(size, alignment);
+	}
+	void Node::operator delete(void* ptr, size_t size, std::align_val_t alignment)
+	{
+		::operator delete(ptr, alignment);
+	}
+
 	void Node::WorldUpdate(float deltaTime)
 	{
 		NODESCRIPT_EVENT_DISPATCH("Node::WorldUpdate(float)", deltaTime);
@@ -152,6 +171,7 @@ namespace Suora
 			return;
 		}
 
+		const String previousName = m_Name;
 		if (m_WasBeginCalled)
 		{
 			m_Name = name;
@@ -170,6 +190,11 @@ namespace Suora
 				IncrementNameIndex();
 			}
 		}
+
+		if (m_World && m_Name != previousName)
+		{
+			m_World->NotifyHierarchyChange(WorldHierarchyEvent::Renamed, this);
+		}
 	}
 
 	String Node::GetName() const
@@ -179,17 +204,37 @@ namespace Suora
 
 	Node* Node::Duplicate()
 	{
-		Yaml::Node Serialized;
-		Serialize(Serialized);
-		Serialized["RootParentClass"] = GetClass().ToString();
-
 		if (!GetWorld())
 		{
 			SuoraError("Node::Duplicate(): Cannot duplicate Node. No World context.");
 			return nullptr;
 		}
 
-		Node* duplicate = Deserialize(Serialized, true);
+		Node* duplicate = Clone();
+		FinishDuplicate(duplicate);
+
+		return duplicate;
+	}
+
+	Array<Node*> Node::DuplicateMultiple(int32_t count)
+	{
+		if (!GetWorld())
+		{
+			SuoraError("Node::DuplicateMultiple(): Cannot duplicate Node. No World context.");
+			return Array<Node*>();
+		}
+
+		Array<Node*> duplicates = Clone(count);
+		for (Node* duplicate : duplicates)
+		{
+			FinishDuplicate(duplicate);
+		}
+
+		return duplicates;
+	}
+
+	void Node::FinishDuplicate(Node* duplicate)
+	{
 		if (IsInitialized())
 		{
 			duplicate->InitializeNode(*GetWorld());
@@ -200,8 +245,6 @@ namespace Suora
 			duplicate->As<Node3D>()->TickTransform();
 		}
 
-		// Still bad....
-		// TODO: Fix -> Some ChildNodes dont get properly deserialized
 		duplicate->m_IsActorLayer = true;
 
 		if (!m_WasBeginCalled)
@@ -211,8 +254,6 @@ namespace Suora
 				duplicate->SetName(duplicate->GetName());
 			}
 		}
-
-		return duplicate;
 	}
 
 	void Node::Destroy()
@@ -237,7 +278,6 @@ namespace Suora
 		}
 
 		SuoraAssert(GetWorld());
-		SuoraAssert(GetWorld()->m_PendingKills.Contains(this) == false);
 		GetWorld()->m_PendingKills.Add(this);
 	}
 
@@ -294,12 +334,7 @@ namespace Suora
 
 	void Node::Replicate(bool b)
 	{
-		if (IsInitialized())
-		{
-			SuoraWarn("You may not change replication status after initialization.");
-			return;
-		}
-
+		// The NetworkContext of the server looks for replicated root Nodes before every snapshot, so this may change at any time
 		m_Replicated = b;
 	}
 
@@ -393,6 +428,28 @@ namespace Suora
 
 		return -1;
 	}
+	void Node::SetChildIndex(int32_t index)
+	{
+		const int32_t current = GetChildIndex();
+		if (current < 0)
+		{
+			return;
+		}
+		index = std::clamp(index, 0, GetParent()->m_Children.Size() - 1);
+		if (index == current)
+		{
+			return;
+		}
+
+		Node* self = this;
+		GetParent()->m_Children.RemoveAt(current);
+		GetParent()->m_Children.Insert(index, self);
+
+		if (m_World)
+		{
+			m_World->NotifyHierarchyChange(WorldHierarchyEvent::Reparented, this);
+		}
+	}
 
 	Node* Node::GetParentNodeOfClass(const Class& cls, bool includeSelf)
 	{
@@ -404,7 +461,7 @@ namespace Suora
 	{
 		SUORA_ASSERT(GetWorld() == nullptr);
 		if (GetName() == "New Node") SetName(GetClass().GetClassName());
-		world.m_WorldNodes.Add(this);
+		world.RegisterNode(this);
 		m_World = &world;
 		m_Initialized = true;
 
@@ -531,6 +588,11 @@ namespace Suora
 
 			transform->RecalculateTransformMatrix();
 		}
+
+		if (m_World)
+		{
+			m_World->NotifyHierarchyChange(WorldHierarchyEvent::Reparented, this);
+		}
 	}
 	void Node::SetParent(Node* parent, bool keepWorldTransform)
 	{
@@ -627,6 +689,13 @@ namespace Suora
 		m_WorldTransformMatrix = glm::translate(Mat4(1), GetPosition()) * rotated;
 		TickTransform(true);
 	}
+	void Node3D::SetPositionAndRotation(const Vec3& position, const Quat& rot)
+	{
+		const auto& scaled = glm::scale(Mat4(1), GetScale());
+		const auto& rotated = glm::toMat4(rot) * scaled;
+		m_WorldTransformMatrix = glm::translate(Mat4(1), position) * rotated;
+		TickTransform(true);
+	}
 	void Node3D::SetLocalRotation(const Quat& rot)
 	{
 		const auto& scaled = glm::scale(Mat4(1), GetLocalScale());
@@ -21,6 +21,7 @@ namespace Suora
 	class UINode;
 	class LevelNode;
 	class PlayerInputNode;
+	struct NodeClonePlan;
 
 	/** Baseclass for all Nodes in the GameFramework */
 	class Node : public Object
@@ -39,14 +40,30 @@ namespace Suora
 		bool m_WasBeginCalled = false;
 		bool m_IsPendingKill = false;
 
+		// Indices into the World's Node lists, for constant time unregistering
+		int32_t m_WorldNodeIndex = -1;
+		int32_t m_WorldUpdateIndex = -1;
+		int32_t m_LocalUpdateIndex = -1;
+		bool m_IsBeingRecycled = false;
+
 		// Serialization
 		bool m_IsActorLayer = false;
 	public:
 		Node();
 		virtual ~Node();
 
+		/** Nodes are allocated from pooled slabs, see NodeAllocator */
+		static void* operator new(size_t size);
+		static void operator delete(void* ptr, size_t size);
+		static void* operator new(size_t size, std::align_val_t alignment);
+		static void operator delete(void* ptr, size_t size, std::align_val_t alignment);
+
 		FUNCTION(NodeEvent) virtual void Begin() { NODESCRIPT_EVENT_DISPATCH("Node::Begin()"); }
 		FUNCTION(NodeEvent) virtual void OnNodeDestroy() { NODESCRIPT_EVENT_DISPATCH("Node::OnNodeDestroy()"); }
+		/** Called instead of deleting the Node, if its Actor Class was registered with World::EnableRecycling(...).
+		*   Reflected properties are reset on respawn, other gameplay state has to be reset here.
+		*   The Node will receive Begin() again once it is respawned. */
+		FUNCTION(NodeEvent) virtual void OnRecycle() { NODESCRIPT_EVENT_DISPATCH("Node::OnRecycle()"); }
 		FUNCTION(NodeEvent) virtual void WorldUpdate(float deltaTime);
 		FUNCTION(NodeEvent) virtual void LocalUpdate(float deltaTime);
 		FUNCTION(NodeEvent) virtual void PawnUpdate(float deltaTime) { NODESCRIPT_EVENT_DISPATCH("Node::PawnUpdate(float)", deltaTime); }
@@ -74,6 +91,14 @@ namespace Suora
 
 		FUNCTION(Callable)
 		Node* Duplicate();
+		/** Duplicates the Node count times, the reflection lookups are shared by all copies */
+		Array<Node*> DuplicateMultiple(int32_t count);
+
+		/** Copies the Node and its children in memory, without a serialization round trip. References between Nodes of the
+		 *  subtree, including delegate bindings, point to the copies; Assets and Nodes outside the subtree are shared.
+		 *  The copy has no parent and is not initialized. See NodeCloning.cpp                                            */
+		Node* Clone();
+		Array<Node*> Clone(int32_t count);
 
 		FUNCTION(Callable)
 		void Destroy();
@@ -95,6 +120,7 @@ namespace Suora
 		Node* GetRootNode();
 
 		/** Replication */
+		/** Only root Nodes are replicated. Turning it off on the server destroys the Node on all clients. */
 		FUNCTION(Callable)
 		void Replicate(bool b);
 		FUNCTION(Callable, Pure)
@@ -138,6 +164,8 @@ namespace Suora
 			return out;
 		}
 		int32_t GetChildIndex() const;
+		/** Moves the Node among its siblings, the index is clamped */
+		void SetChildIndex(int32_t index);
 		Node* GetParentNodeOfClass(const Class& cls, bool includeSelf = false);
 		template<class T>
 		T* GetParentNodeOfClass(bool includeSelf = false)
@@ -217,6 +245,15 @@ namespace Suora
 		}
 
 	private:
+		void FinishDuplicate(Node* duplicate);
+		static Node* InstantiateClone(const struct NodeClonePlan& plan);
+		static void CopyCloneLayout(Node* source, Node* target);
+		static Ref<NodeClonePlan> CreateClonePlan(Node* root);
+		/** Resets the reflected properties, transforms and enabled states of this Hierarchy to the ones of the plan's source,
+		 *  e.g. the class default object. Children are matched by index and native Class; the ones without a counterpart,
+		 *  e.g. added at runtime, keep their state. Names and UpdateFlags are kept as well. See NodeCloning.cpp         */
+		void RestoreFromClonePlan(const NodeClonePlan& plan);
+
 		/** Serialization & Deserialization */
 		void SerializeAsChildNode(Yaml::Node& root, struct NodeSerializer& serializer);
 	public:
@@ -232,10 +269,12 @@ namespace Suora
 		friend class World;
 		friend class GameInstance;
 		friend class Level;
+		friend class LevelStreamer;
 		friend class NodeDetails;
 		friend class ViewportPanel;
 		friend class LevelOutliner;
 		friend class NodeClassEditor;
+		friend struct NodeLifetimeChange;
 	};
 
 
@@ -271,6 +310,8 @@ namespace Suora
 		Vec3 GetLocalEulerRotation() const;
 		void SetRotation(const Quat& rot);
 		void SetLocalRotation(const Quat& rot);
+		/** Ticks the Transform of the hierarchy once, instead of once per component */
+		void SetPositionAndRotation(const Vec3& position, const Quat& rot);
 		void SetEulerRotation(const Vec3& eulerAngles);
 		void SetLocalEulerRotation(const Vec3& eulerAngles);
 
@@ -315,6 +356,8 @@ namespace Suora
 		friend class Node;
 		friend class NodeDetails;
 		friend class ViewportPanel;
+		friend struct NodeLifetimeChange;
+		friend struct NodeTransformState;
 		friend class Physics::PhysicsWorld;
 	};
 
@@ -361,6 +404,7 @@ namespace Suora
 		inline static uint32_t s_UIViewportWidth = 1920;
 		inline static uint32_t s_UIViewportHeight = 1080;
 
+		friend class Node;
 		friend class NodeDetails;
 		friend class ViewportPanel;
 		friend class Runtime;
@@ -0,0 +1,98 @@
+#include "Precompiled.h"
+#include "NodeAllocator.h"
+#include <mutex>
+#include <new>
+
+namespace Suora
+{
+
+	struct NodeAllocator::State
+	{
+		struct FreeBlock
+		{
+			FreeBlock* Next;
+		};
+
+		std::mutex Mutex;
+		FreeBlock* FreeLists[s_MaxPooledSize / s_Granularity] = {};
+		NodeAllocatorStats Stats;
+	};
+
+	NodeAllocator::State& NodeAllocator::GetState()
+	{
+		// Intentionally leaked: Nodes owned by static objects may still be deleted during static destruction
+		static State* state = new State();
+		return *state;
+	}
+
+	void* NodeAllocator::Allocate(size_t size)
+	{
+		const size_t blockSize = (std::max(size, sizeof(State::FreeBlock)) + s_Granularity - 1) / s_Granularity * s_Granularity;
+		State& state = GetState();
+
+		if (blockSize > s_MaxPooledSize)
+		{
+			std::lock_guard<std::mutex> lock(state.Mutex);
+			state.Stats.Allocations++;
+			state.Stats.LiveNodes++;
+			return ::operator new(size);
+		}
+
+		std::lock_guard<std::mutex> lock(state.Mutex);
+		State::FreeBlock*& freeList = state.FreeLists[blockSize / s_Granularity - 1];
+		if (!freeList)
+		{
+			// Carve a new slab into blocks of this size class
+			const size_t blockCount = std::max<size_t>(1, s_SlabSize / blockSize);
+			uint8_t* slab = (uint8_t*)::operator new(blockCount * blockSize);
+			for (size_t i = blockCount; i > 0; i--)
+			{
+				State::FreeBlock* block = (State::FreeBlock*)(slab + (i - 1) * blockSize);
+				block->Next = freeList;
+				freeList = block;
+			}
+			state.Stats.ReservedBytes += blockCount * blockSize;
+			state.Stats.FreeBytes += blockCount * blockSize;
+		}
+
+		State::FreeBlock* block = freeList;
+		freeList = block->Next;
+		state.Stats.FreeBytes -= blockSize;
+		state.Stats.Allocations++;
+		state.Stats.LiveNodes++;
+		return block;
+	}
+
+	void NodeAllocator::Free(void* ptr, size_t size)
+	{
+		if (!ptr) return;
+
+		const size_t blockSize = (std::max(size, sizeof(State::FreeBlock)) + s_Granularity - 1) / s_Granularity * s_Granularity;
+		State& state = GetState();
+
+		if (blockSize > s_MaxPooledSize)
+		{
+			::operator delete(ptr);
+			std::lock_guard<std::mutex> lock(state.Mutex);
+			state.Stats.Deallocations++;
+			state.Stats.LiveNodes--;
+			return;
+		}
+
+		std::lock_guard<std::mutex> lock(state.Mutex);
+		State::FreeBlock* block = (State::FreeBlock*)ptr;
+		block->Next = state.FreeLists[blockSize / s_Granularity - 1];
+		state.FreeLists[blockSize / s_Granularity - 1] = block;
+		state.Stats.FreeBytes += blockSize;
+		state.Stats.Deallocations++;
+		state.Stats.LiveNodes--;
+	}
+
+	NodeAllocatorStats NodeAllocator::GetStats()
+	{
+		State& state = GetState();
+		std::lock_guard<std::mutex> lock(state.Mutex);
+		return state.Stats;
+	}
+
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+namespace Suora
+{
+
+	struct NodeAllocatorStats
+	{
+		uint64_t Allocations = 0;
+		uint64_t Deallocations = 0;
+		uint64_t LiveNodes = 0;
+		/** Memory taken from the OS for Node slabs */
+		uint64_t ReservedBytes = 0;
+		/** Memory in the free lists, ready to be reused */
+		uint64_t FreeBytes = 0;
+	};
+
+	/* Backs operator new/delete of all Nodes. Nodes are grouped into size classes, every size class carves its Nodes
+	 * out of larger slabs and keeps freed Nodes in a free list. Since every Node class has a fixed size, this acts as a
+	 * per-class pool: spawning after destroying reuses memory instead of going through the global heap.
+	 * Slabs are never returned to the OS. Sizes above s_MaxPooledSize go straight to the global heap. Thread-safe. */
+	class NodeAllocator
+	{
+	public:
+		static void* Allocate(size_t size);
+		static void Free(void* ptr, size_t size);
+
+		static NodeAllocatorStats GetStats();
+
+		static constexpr size_t s_Granularity = 16;
+		static constexpr size_t s_MaxPooledSize = 4096;
+		static constexpr size_t s_SlabSize = 64 * 1024;
+
+	private:
+		struct State;
+		static State& GetState();
+	};
+
+}
@@ -0,0 +1,305 @@
+#include "Precompiled.h"
+#include "Node.h"
+#include "Suora/Common/Delegate.h"
+#include "Suora/Assets/Material.h"
+#include "Suora/Reflection/New.h"
+#include "Suora/Reflection/ClassReflector.h"
+#include "Suora/NodeScript/NodeScriptObject.h"
+#include "Suora/Serialization/Yaml.h"
+#include <unordered_map>
+
+namespace Suora
+{
+
+	/** Everything Node::Clone() looks up once per source subtree; shared by all copies */
+	struct NodeClonePlan
+	{
+		struct Entry
+		{
+			Node* Source = nullptr;
+			/** Index of the parent Entry, -1 for the root */
+			int32_t Parent = -1;
+			Class NativeClass = Class::None;
+			const Array<Ref<ClassMemberProperty>>* Members = nullptr;
+		};
+
+		/** Pre-order, parents always come before their children */
+		Array<Entry> Entries;
+		/** Source Node -> Entry, to remap references within the subtree */
+		std::unordered_map<const Object*, int32_t> Indices;
+		/** Script class instances (e.g. C#) own state in their ScriptEngine, that can only be recreated by serialization */
+		bool IsSupported = true;
+
+		NodeClonePlan(Node* root)
+		{
+			Add(root, -1);
+		}
+
+	private:
+		void Add(Node* node, int32_t parent)
+		{
+			const int32_t index = Entries.Size();
+
+			Entry entry;
+			entry.Source = node;
+			entry.Parent = parent;
+			entry.NativeClass = node->GetNativeClass();
+
+			const ClassReflector* refl = &ClassReflector::GetByClass(entry.NativeClass);
+			auto it = m_Members.find(refl);
+			if (it == m_Members.end())
+			{
+				it = m_Members.emplace(refl, refl->GetAllClassMemberProperties()).first;
+			}
+			entry.Members = &it->second;
+
+			if (node->GetClass().IsScriptClass())
+			{
+				IsSupported = false;
+			}
+
+			Entries.Add(entry);
+			Indices[node] = index;
+
+			for (int32_t i = 0; i < node->GetChildCount(); i++)
+			{
+				Add(node->GetChild(i), index);
+			}
+		}
+
+		std::unordered_map<const ClassReflector*, Array<Ref<ClassMemberProperty>>> m_Members;
+	};
+
+	template<class T>
+	static void CopyMember(const ClassMemberProperty& member, Node* from, Node* to)
+	{
+		*ClassMemberProperty::AccessMember<T>(to, member.m_MemberOffset) = *ClassMemberProperty::AccessMember<T>(from, member.m_MemberOffset);
+	}
+
+	/** clones holds nullptr for Nodes of the plan without a counterpart, references to them are cleared */
+	static Node* RemapNode(Node* node, const NodeClonePlan& plan, const Array<Node*>& clones)
+	{
+		auto it = plan.Indices.find(node);
+		return (it != plan.Indices.end()) ? clones[it->second] : node;
+	}
+
+	static void CopyProperties(const NodeClonePlan& plan, const NodeClonePlan::Entry& entry, Node* clone, const Array<Node*>& clones)
+	{
+		Node* source = entry.Source;
+
+		for (const Ref<ClassMemberProperty>& member : *entry.Members)
+		{
+			switch (member->m_Property->GetType())
+			{
+			case PropertyType::Char:			CopyMember<char>(*member, source, clone); break;
+			case PropertyType::Int8:			CopyMember<int8_t>(*member, source, clone); break;
+			case PropertyType::Int16:			CopyMember<int16_t>(*member, source, clone); break;
+			case PropertyType::Int32:			CopyMember<int32_t>(*member, source, clone); break;
+			case PropertyType::Int64:			CopyMember<int64_t>(*member, source, clone); break;
+			case PropertyType::UInt8:			CopyMember<uint8_t>(*member, source, clone); break;
+			case PropertyType::UInt16:			CopyMember<uint16_t>(*member, source, clone); break;
+			case PropertyType::UInt32:			CopyMember<uint32_t>(*member, source, clone); break;
+			case PropertyType::UInt64:			CopyMember<uint64_t>(*member, source, clone); break;
+			case PropertyType::Bool:			CopyMember<bool>(*member, source, clone); break;
+			case PropertyType::Float:			CopyMember<float>(*member, source, clone); break;
+			case PropertyType::Double:			CopyMember<double>(*member, source, clone); break;
+			case PropertyType::Vec2:			CopyMember<Vec2>(*member, source, clone); break;
+			case PropertyType::Vec3:			CopyMember<Vec3>(*member, source, clone); break;
+			case PropertyType::Vec4:			CopyMember<Vec4>(*member, source, clone); break;
+			case PropertyType::Quat:			CopyMember<Quat>(*member, source, clone); break;
+			case PropertyType::String:			CopyMember<String>(*member, source, clone); break;
+			case PropertyType::MaterialSlots:	CopyMember<MaterialSlots>(*member, source, clone); break;
+			case PropertyType::SuoraID:			CopyMember<SuoraID>(*member, source, clone); break;
+			case PropertyType::Class:			CopyMember<Class>(*member, source, clone); break;
+			case PropertyType::SubclassOf:		CopyMember<TSubclassOf>(*member, source, clone); break;
+			case PropertyType::ObjectPtr:
+			{
+				// Assets are immutable at runtime and shared, Nodes of the subtree are remapped to their copies
+				Object* object = *ClassMemberProperty::AccessMember<Object*>(source, member->m_MemberOffset);
+				Node* node = object ? Cast<Node>(object) : nullptr;
+				*ClassMemberProperty::AccessMember<Object*>(clone, member->m_MemberOffset) = node ? RemapNode(node, plan, clones) : object;
+			} break;
+			case PropertyType::Delegate:
+			{
+				const TDelegate* from = ClassMemberProperty::AccessMember<TDelegate>(source, member->m_MemberOffset);
+				TDelegate* to = ClassMemberProperty::AccessMember<TDelegate>(clone, member->m_MemberOffset);
+				to->Bindings.Clear();
+				for (const TDelegate::SciptDelegateBinding& binding : from->Bindings)
+				{
+					Node* node = binding.NodeBinding.Get();
+					if (Node* remapped = node ? RemapNode(node, plan, clones) : nullptr)
+					{
+						to->Bindings.Add(TDelegate::SciptDelegateBinding(remapped, binding.ScriptFunctionHash));
+					}
+				}
+			} break;
+			default: /* Array: not reflected by value, same as in the NodeSerialization */ break;
+			}
+		}
+	}
+
+	void Node::CopyCloneLayout(Node* source, Node* target)
+	{
+		// Same hierarchy, so both matrices carry over as they are
+		if (source->IsA<Node3D>())
+		{
+			const Node3D* from = source->As<Node3D>();
+			Node3D* to = target->As<Node3D>();
+			to->m_WorldTransformMatrix = from->m_WorldTransformMatrix;
+			to->m_LocalTransformMatrix = from->m_LocalTransformMatrix;
+		}
+		if (source->IsA<UINode>())
+		{
+			const UINode* from = source->As<UINode>();
+			UINode* to = target->As<UINode>();
+			to->m_Anchor = from->m_Anchor;
+			to->m_IsWidthRelative = from->m_IsWidthRelative;
+			to->m_Width = from->m_Width;
+			to->m_IsHeightRelative = from->m_IsHeightRelative;
+			to->m_Height = from->m_Height;
+			to->m_Pivot = from->m_Pivot;
+			to->m_AbsolutePixelOffset = from->m_AbsolutePixelOffset;
+			to->m_EulerRotationAroundAnchor = from->m_EulerRotationAroundAnchor;
+		}
+	}
+
+	Node* Node::InstantiateClone(const NodeClonePlan& plan)
+	{
+		Array<Node*> clones;
+
+		for (const NodeClonePlan::Entry& entry : plan.Entries)
+		{
+			const Node* source = entry.Source;
+			Node* clone = New(entry.NativeClass, false)->As<Node>();
+			SUORA_ASSERT(clone);
+
+			clone->m_Name = source->m_Name;
+			clone->m_Enabled = source->m_Enabled;
+			clone->m_EnabledInHierarchy = source->m_EnabledInHierarchy;
+			clone->m_UpdateFlags = source->m_UpdateFlags;
+			clone->m_Replicated = source->m_Replicated;
+			clone->m_IsActorLayer = source->m_IsActorLayer;
+			clone->m_OverwrittenProperties = source->m_OverwrittenProperties;
+
+			// The copies are not part of a World yet, so they are linked directly instead of by ForceSetParent()
+			if (entry.Parent >= 0)
+			{
+				clone->m_Parent = clones[entry.Parent];
+				clone->m_Parent->m_Children.Add(clone);
+			}
+			else
+			{
+				clone->m_EnabledInHierarchy = clone->m_Enabled;
+			}
+
+			CopyCloneLayout(entry.Source, clone);
+
+			// Blueprint instances; the ScriptClasses are owned by the Blueprint and shared
+			if (INodeScriptObject* from = entry.Source->GetInterface<INodeScriptObject>())
+			{
+				clone->Implement<INodeScriptObject>();
+				INodeScriptObject* to = clone->GetInterface<INodeScriptObject>();
+				to->m_Class = from->m_Class;
+				to->m_ScriptClasses = from->m_ScriptClasses;
+				to->m_BlueprintLinks = from->m_BlueprintLinks;
+			}
+
+			clones.Add(clone);
+		}
+
+		// Every Node a reference could be remapped to exists now
+		for (int32_t i = 0; i < clones.Size(); i++)
+		{
+			CopyProperties(plan, plan.Entries[i], clones[i], clones);
+		}
+
+		return clones[0];
+	}
+
+	Ref<NodeClonePlan> Node::CreateClonePlan(Node* root)
+	{
+		return CreateRef<NodeClonePlan>(root);
+	}
+
+	void Node::RestoreFromClonePlan(const NodeClonePlan& plan)
+	{
+		// Children are matched by their index and native Class, the ones added at runtime have no counterpart
+		Array<Node*> targets;
+		Array<int32_t> matchedChildren;
+		for (const NodeClonePlan::Entry& entry : plan.Entries)
+		{
+			Node* target = nullptr;
+			if (entry.Parent < 0)
+			{
+				target = this;
+			}
+			else if (Node* parent = targets[entry.Parent])
+			{
+				const int32_t index = matchedChildren[entry.Parent]++;
+				target = index < parent->GetChildCount() ? parent->GetChild(index) : nullptr;
+			}
+			if (target && target->GetNativeClass() != entry.NativeClass)
+			{
+				target = nullptr;
+			}
+			targets.Add(target);
+			matchedChildren.Add(0);
+		}
+
+		for (int32_t i = 0; i < targets.Size(); i++)
+		{
+			Node* target = targets[i];
+			if (!target) continue;
+
+			Node* source = plan.Entries[i].Source;
+			target->m_Enabled = source->m_Enabled;
+			target->m_EnabledInHierarchy = (i == 0) ? source->m_Enabled : source->m_EnabledInHierarchy;
+			target->m_Replicated = source->m_Replicated;
+			CopyCloneLayout(source, target);
+			CopyProperties(plan, plan.Entries[i], target, targets);
+		}
+	}
+
+	Node* Node::Clone()
+	{
+		const NodeClonePlan plan = NodeClonePlan(this);
+		if (!plan.IsSupported)
+		{
+			Yaml::Node serialized;
+			Serialize(serialized);
+			serialized["RootParentClass"] = GetClass().ToString();
+			return Deserialize(serialized, true);
+		}
+
+		return InstantiateClone(plan);
+	}
+
+	Array<Node*> Node::Clone(int32_t count)
+	{
+		Array<Node*> clones;
+		if (count <= 0)
+		{
+			return clones;
+		}
+
+		const NodeClonePlan plan = NodeClonePlan(this);
+		if (!plan.IsSupported)
+		{
+			Yaml::Node serialized;
+			Serialize(serialized);
+			serialized["RootParentClass"] = GetClass().ToString();
+			for (int32_t i = 0; i < count; i++)
+			{
+				clones.Add(Deserialize(serialized, true));
+			}
+			return clones;
+		}
+
+		for (int32_t i = 0; i < count; i++)
+		{
+			clones.Add(InstantiateClone(plan));
+		}
+		return clones;
+	}
+
+}
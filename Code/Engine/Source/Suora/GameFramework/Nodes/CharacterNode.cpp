@@ -19,6 +19,15 @@ namespace Suora
 		}
 	}
 
+	void CharacterNode::UnInitializeNode(World& world)
+	{
+		Super::UnInitializeNode(world);
+
+		// Recycled Nodes are not deleted, their Controller is created again in Begin()
+		m_Controller = nullptr;
+		world.GetPhysicsWorld()->DestroyCharacterNode(this);
+	}
+
 	void CharacterNode::Begin()
 	{
 		Super::Begin();
@@ -13,6 +13,7 @@ namespace Suora
 		SUORA_CLASS(875943291347);
 	public:
 		virtual ~CharacterNode();
+		void UnInitializeNode(World& world) override;
 		void Begin() override;
 		void TickTransform(bool inverseParentTransform) override;
 
@@ -0,0 +1,77 @@
+#include "Precompiled.h"
+#include "LevelStreamingVolumeNode.h"
+#include "CameraNode.h"
+#include "Suora/GameFramework/GameInstance.h"
+#include "Suora/GameFramework/LevelStreamer.h"
+#include "Suora/GameFramework/World.h"
+
+namespace Suora
+{
+
+	LevelStreamingVolumeNode::LevelStreamingVolumeNode()
+	{
+		SetUpdateFlag(UpdateFlag::WorldUpdate);
+	}
+	LevelStreamingVolumeNode::~LevelStreamingVolumeNode()
+	{
+	}
+
+	void LevelStreamingVolumeNode::WorldUpdate(float deltaTime)
+	{
+		Super::WorldUpdate(deltaTime);
+
+		World* world = GetWorld();
+		Node3D* viewer = world->GetPlayerPawn() ? world->GetPlayerPawn()->As<Node3D>() : nullptr;
+		if (!viewer) viewer = world->GetMainCamera();
+		if (!viewer || !m_Level) return;
+
+		const float distance = glm::distance(viewer->GetPosition(), GetPosition());
+		if (!m_Request && distance <= m_LoadDistance)
+		{
+			LoadSubLevel();
+		}
+		else if (m_Request && distance > std::max(m_UnloadDistance, m_LoadDistance))
+		{
+			UnloadSubLevel();
+		}
+	}
+
+	void LevelStreamingVolumeNode::UnInitializeNode(World& world)
+	{
+		Super::UnInitializeNode(world);
+		UnloadSubLevel();
+	}
+
+	bool LevelStreamingVolumeNode::IsSubLevelLoaded() const
+	{
+		return m_Request && m_Request->GetState() == LevelLoadState::Loaded;
+	}
+
+	float LevelStreamingVolumeNode::GetStreamingProgress() const
+	{
+		return m_Request ? m_Request->GetProgress() : 0.0f;
+	}
+
+	void LevelStreamingVolumeNode::LoadSubLevel()
+	{
+		// Worlds of the Editor have no GameInstance and never stream
+		GameInstance* gameInstance = GetWorld()->GetGameInstance();
+		if (!gameInstance) return;
+
+		LevelLoadParams params;
+		params.TargetWorld = GetWorld();
+		m_Request = gameInstance->GetLevelStreamer().LoadLevelAsync(m_Level, params);
+	}
+
+	void LevelStreamingVolumeNode::UnloadSubLevel()
+	{
+		if (!m_Request) return;
+
+		if (GameInstance* gameInstance = GetWorld() ? GetWorld()->GetGameInstance() : nullptr)
+		{
+			gameInstance->GetLevelStreamer().Unload(m_Request);
+		}
+		m_Request = nullptr;
+	}
+
+}
\ No newline at end of file
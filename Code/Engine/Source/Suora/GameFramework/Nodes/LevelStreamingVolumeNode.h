@@ -0,0 +1,42 @@
+#pragma once
+#include "Suora/GameFramework/Node.h"
+#include "Suora/Assets/Level.h"
+#include "LevelStreamingVolumeNode.generated.h"
+
+namespace Suora
+{
+	class LevelLoadRequest;
+
+	/** Streams a sub-level into the World, while the player Pawn (or the main Camera) is within m_LoadDistance.
+	*   It is unloaded again beyond m_UnloadDistance, the gap keeps it from reloading at the border. */
+	class LevelStreamingVolumeNode : public Node3D
+	{
+		SUORA_CLASS(648137290);
+
+	public:
+		PROPERTY()
+		Level* m_Level = nullptr;
+		PROPERTY()
+		float m_LoadDistance = 100.0f;
+		PROPERTY()
+		float m_UnloadDistance = 125.0f;
+
+		LevelStreamingVolumeNode();
+		~LevelStreamingVolumeNode();
+		void WorldUpdate(float deltaTime) override;
+		void UnInitializeNode(World& world) override;
+
+		FUNCTION(Callable, Pure)
+		bool IsSubLevelLoaded() const;
+		/** 0 to 1, also 0 while nothing is streamed in */
+		FUNCTION(Callable, Pure)
+		float GetStreamingProgress() const;
+
+	private:
+		void LoadSubLevel();
+		void UnloadSubLevel();
+
+		Ref<LevelLoadRequest> m_Request;
+	};
+
+}
\ No newline at end of file
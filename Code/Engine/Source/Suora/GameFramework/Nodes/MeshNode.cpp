@@ -48,7 +48,7 @@ namespace Suora
 
 	void MeshNode::SetMesh(Mesh* mesh)
 	{
-		m_Mesh = mesh;
+		SetProperty(m_Mesh, mesh, PropertyIndex::m_Mesh);
 	}
 
 	Mesh* MeshNode::GetMesh() const
@@ -71,6 +71,8 @@ namespace Suora
 				GetWorld()->m_ShadowRenderables.Remove(this);
 			}
 		}
+		// Recycled Nodes are initialized again
+		m_WasInitliazed = false;
 	}
 
 }
\ No newline at end of file
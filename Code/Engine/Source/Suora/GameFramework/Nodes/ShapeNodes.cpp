@@ -25,6 +25,13 @@ namespace Suora
 		Super::InitializeNode(world);
 
 	}
+	void ShapeNode::UnInitializeNode(World& world)
+	{
+		Super::UnInitializeNode(world);
+
+		// Recycled Nodes are not deleted, their Body is created again in Begin()
+		world.GetPhysicsWorld()->DestroyShapeNode(this);
+	}
 	void ShapeNode::Begin()
 	{
 		Super::Begin();
@@ -84,6 +91,21 @@ namespace Suora
 		return m_IsStatic;
 	}
 
+	Vec3 ShapeNode::GetContactPoint() const
+	{
+		return m_CurrentContact.Point;
+	}
+
+	Vec3 ShapeNode::GetContactNormal() const
+	{
+		return m_CurrentContact.Normal;
+	}
+
+	float ShapeNode::GetContactImpulse() const
+	{
+		return m_CurrentContact.Impulse;
+	}
+
 	void ShapeNode::TickShapeNode()
 	{
 		if (ShouldUpdateInCurrentContext() && !Physics::PhysicsWorld::s_InPhysicsSimulation)
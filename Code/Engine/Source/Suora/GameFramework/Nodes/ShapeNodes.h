@@ -4,6 +4,7 @@
 #include "Suora/GameFramework/Node.h"
 #include "Suora/Common/Delegate.h"
 #include "Suora/Common/Array.h"
+#include "Suora/Physics/CollisionMatrix.h"
 #include "ShapeNodes.generated.h"
 
 namespace Suora
@@ -17,6 +18,17 @@ namespace Suora
 		Capsule
 	};
 
+	/** Contact data of the Trigger/Collision event that is currently dispatched, seen from the receiving ShapeNode */
+	struct ContactInfo
+	{
+		Vec3 Point = Vec3(0.0f);
+		/** Points from the other ShapeNode towards the receiving one */
+		Vec3 Normal = Vec3(0.0f);
+		float PenetrationDepth = 0.0f;
+		/** Estimated impulse needed to stop the approach along the Normal, zero for Exit events */
+		float Impulse = 0.0f;
+	};
+
 	class ShapeNode : public Node3D
 	{
 		SUORA_CLASS(47638332);
@@ -33,6 +45,7 @@ namespace Suora
 		ShapeNode(ShapeType type) : Type(type) { }
 		virtual ~ShapeNode();
 		void InitializeNode(World& world) override;
+		void UnInitializeNode(World& world) override;
 		void Begin() override;
 		virtual void OnNodeDestroy() override;
 		void TickTransform(bool inverseParentTransform) override;
@@ -51,6 +64,8 @@ namespace Suora
 		bool IsStatic() const;
 
 		ShapeType GetType() const { return Type; }
+		/** m_CollisionLayer clamped to the layers of the CollisionMatrix, out of range values must not wrap into another layer */
+		int32_t GetCollisionLayer() const { return glm::clamp(m_CollisionLayer, 0, (int32_t)Physics::CollisionMatrix::s_LayerCount - 1); }
 
 		PROPERTY() Delegate<ShapeNode*> OnTriggerEnter;
 		PROPERTY() Delegate<ShapeNode*> OnTriggerStay;
@@ -60,6 +75,15 @@ namespace Suora
 		PROPERTY() Delegate<ShapeNode*> OnCollisionStay;
 		PROPERTY() Delegate<ShapeNode*> OnCollisionExit;
 
+		/** Only valid while one of the Trigger/Collision Delegates is invoked */
+		const ContactInfo& GetCurrentContact() const { return m_CurrentContact; }
+		FUNCTION(Callable, Pure)
+		Vec3 GetContactPoint() const;
+		FUNCTION(Callable, Pure)
+		Vec3 GetContactNormal() const;
+		FUNCTION(Callable, Pure)
+		float GetContactImpulse() const;
+
 	public:
 		PROPERTY()
 		bool m_IsTrigger = false;
@@ -85,9 +109,15 @@ namespace Suora
 		PROPERTY()
 		bool m_IsStatic = true;
 
+		/** Physics layer in [0, 16), which layers collide is configured in the ProjectSettings */
+		PROPERTY()
+		int32_t m_CollisionLayer = 0;
+
 	private:
 		void TickShapeNode();
 
+		ContactInfo m_CurrentContact;
+
 		friend class Physics::PhysicsWorld;
 	};
 	
@@ -1,5 +1,6 @@
 #include "Precompiled.h"
 #include "TimerNode.h"
+#include "Suora/GameFramework/World.h"
 
 namespace Suora
 {
@@ -10,36 +11,111 @@ namespace Suora
 	}
 	TimerNode::~TimerNode()
 	{
-
+		ClearTimer();
 	}
 
 	void TimerNode::Begin()
 	{
-		SetUpdateFlag(UpdateFlag::WorldUpdate);
+		Schedule(m_TargetTime);
 	}
 
-	void TimerNode::WorldUpdate(float deltaTime)
+	void TimerNode::UnInitializeNode(World& world)
 	{
-		m_ElapsedTime += deltaTime;
+		Super::UnInitializeNode(world);
+		ClearTimer();
+	}
+
+	void TimerNode::Schedule(float delay)
+	{
+		ClearTimer();
+
+		World* world = GetWorld();
+		if (!world) return;
 
-		if (m_ElapsedTime >= m_TargetTime)
+		TimerParams params;
+		params.Clock = m_UseRealTime ? TimerClock::Real : TimerClock::Game;
+		params.Loop = m_Loop;
+		params.FirstDelay = delay;
+		m_Handle = world->GetTimerManager().SetTimer(m_TargetTime, [this]() { OnTimerExpired(); }, params);
+		m_TimerWorld = world;
+	}
+
+	void TimerNode::ClearTimer()
+	{
+		if (m_TimerWorld)
 		{
-			OnTimerComplete(TDelegate::NoParam);
+			m_TimerWorld->GetTimerManager().ClearTimer(m_Handle);
+			m_TimerWorld = nullptr;
+		}
+	}
 
-			if (m_Loop) m_ElapsedTime = 0;
-			else Destroy();
+	void TimerNode::OnTimerExpired()
+	{
+		if (IsPendingKill())
+		{
+			ClearTimer();
+			return;
 		}
 
+		OnTimerComplete(TDelegate::NoParam);
+
+		if (IsPendingKill()) return;
+		const bool isLooping = m_TimerWorld && m_TimerWorld->GetTimerManager().IsTimerActive(m_Handle);
+		if (!m_Loop)
+		{
+			ClearTimer();
+			Destroy();
+		}
+		else if (!isLooping)
+		{
+			// m_Loop was enabled after the timer was scheduled
+			Schedule(m_TargetTime);
+		}
 	}
 
 	void TimerNode::SetTimer(float time)
 	{
+		if (!m_TimerWorld)
+		{
+			m_TargetTime = time;
+			return;
+		}
+
+		// Keeps the elapsed time, like changing the target of a running stopwatch
+		TimerManager& timers = m_TimerWorld->GetTimerManager();
+		const float elapsed = m_TargetTime - timers.GetTimerRemaining(m_Handle);
+		const bool paused = timers.IsTimerPaused(m_Handle);
 		m_TargetTime = time;
+		Schedule(std::max(0.0f, time - elapsed));
+		if (paused) PauseTimer();
 	}
 
 	void TimerNode::ResetTimer()
 	{
-		m_ElapsedTime = 0;
+		if (m_TimerWorld)
+		{
+			Schedule(m_TargetTime);
+		}
+	}
+
+	void TimerNode::PauseTimer()
+	{
+		if (m_TimerWorld) m_TimerWorld->GetTimerManager().PauseTimer(m_Handle);
+	}
+
+	void TimerNode::ResumeTimer()
+	{
+		if (m_TimerWorld) m_TimerWorld->GetTimerManager().ResumeTimer(m_Handle);
+	}
+
+	bool TimerNode::IsTimerPaused() const
+	{
+		return m_TimerWorld && m_TimerWorld->GetTimerManager().IsTimerPaused(m_Handle);
+	}
+
+	float TimerNode::GetRemainingTime() const
+	{
+		return m_TimerWorld ? m_TimerWorld->GetTimerManager().GetTimerRemaining(m_Handle) : m_TargetTime;
 	}
 
 }
\ No newline at end of file
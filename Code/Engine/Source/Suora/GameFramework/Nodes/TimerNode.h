@@ -1,5 +1,6 @@
 #pragma once
 #include "Suora/GameFramework/Node.h"
+#include "Suora/GameFramework/TimerManager.h"
 #include "Suora/Common/Delegate.h"
 #include <vector>
 #include "TimerNode.generated.h"
@@ -7,6 +8,8 @@
 namespace Suora
 {
 
+	/** Fires OnTimerComplete after the set time and destroys itself, unless it loops.
+	*   Runs on the TimerManager of the World, the Node itself is never updated. */
 	class TimerNode : public Node
 	{
 		SUORA_CLASS(754685479);
@@ -14,18 +17,37 @@ namespace Suora
 	public:
 		Delegate<DelegateNoParams> OnTimerComplete;
 		bool m_Loop = false;
+		/** Keeps running while the TimerManager is paused and ignores its TimeDilation */
+		bool m_UseRealTime = false;
 
 		TimerNode();
 		~TimerNode();
 		void Begin() override;
-		void WorldUpdate(float deltaTime) override;
+		void UnInitializeNode(World& world) override;
 
+		FUNCTION(Callable)
 		void SetTimer(float time);
+		FUNCTION(Callable)
 		void ResetTimer();
+		FUNCTION(Callable)
+		void PauseTimer();
+		FUNCTION(Callable)
+		void ResumeTimer();
+		FUNCTION(Callable, Pure)
+		bool IsTimerPaused() const;
+		FUNCTION(Callable, Pure)
+		float GetRemainingTime() const;
+
+		TimerHandle GetTimerHandle() const { return m_Handle; }
 
 	private:
-		float m_ElapsedTime = 0;
+		void Schedule(float delay);
+		void ClearTimer();
+		void OnTimerExpired();
+
 		float m_TargetTime = 0;
+		TimerHandle m_Handle;
+		World* m_TimerWorld = nullptr;
 	};
 
 }
\ No newline at end of file
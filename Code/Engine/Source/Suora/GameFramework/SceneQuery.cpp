@@ -0,0 +1,885 @@
+#include "Precompiled.h"
+#include "SceneQuery.h"
+#include <algorithm>
+#include <numeric>
+#include <unordered_set>
+#include <glm/gtc/matrix_access.hpp>
+#include "Suora/Assets/Mesh.h"
+#include "Suora/GameFramework/Node.h"
+#include "Suora/GameFramework/World.h"
+#include "Suora/GameFramework/Nodes/MeshNode.h"
+
+namespace Suora
+{
+	/** Triangles of one Mesh in local space, with a BVH over them */
+	struct SceneQueryTriangleMesh
+	{
+		std::vector<Vec3> Positions;
+		/** Three per triangle, in the order of the BVH leaves */
+		std::vector<uint32_t> Indices;
+		/** The index of each triangle in the Mesh */
+		std::vector<uint32_t> TriangleIDs;
+		std::vector<SceneQuery::BVHNode> Nodes;
+		AABB Bounds;
+
+		/** To notice when the Mesh was rebuilt or streamed out and in again */
+		const void* SourceVertices = nullptr;
+		const void* SourceIndices = nullptr;
+		size_t SourceVertexCount = 0;
+		size_t SourceIndexCount = 0;
+		uint32_t LastUsedBuild = 0;
+	};
+
+	static constexpr uint32_t s_MaxProxiesPerLeaf = 2;
+	static constexpr uint32_t s_MaxTrianglesPerLeaf = 4;
+
+	static Vec3 SafeInverse(const Vec3& direction)
+	{
+		auto inverse = [](float value) { return 1.0f / (glm::abs(value) > 1e-20f ? value : (value < 0.0f ? -1e-20f : 1e-20f)); };
+		return Vec3(inverse(direction.x), inverse(direction.y), inverse(direction.z));
+	}
+
+	static float GetMaxScale(const Mat4& transform)
+	{
+		return glm::max(glm::length(Vec3(transform[0])), glm::max(glm::length(Vec3(transform[1])), glm::length(Vec3(transform[2]))));
+	}
+
+	static bool IsDegenerated(const Mat4& transform)
+	{
+		return glm::abs(glm::determinant(glm::mat3(transform))) < 1e-12f;
+	}
+
+	/** Double sided Moeller-Trumbore, the direction does not have to be normalized */
+	static bool IntersectTriangle(const Vec3& origin, const Vec3& direction, const Vec3& a, const Vec3& b, const Vec3& c, float& outDistance)
+	{
+		const Vec3 edge1 = b - a;
+		const Vec3 edge2 = c - a;
+		const Vec3 p = glm::cross(direction, edge2);
+		const float determinant = glm::dot(edge1, p);
+		if (glm::abs(determinant) < 1e-20f) return false;
+
+		const float inverseDeterminant = 1.0f / determinant;
+		const Vec3 s = origin - a;
+		const float u = glm::dot(s, p) * inverseDeterminant;
+		if (u < 0.0f || u > 1.0f) return false;
+
+		const Vec3 q = glm::cross(s, edge1);
+		const float v = glm::dot(direction, q) * inverseDeterminant;
+		if (v < 0.0f || u + v > 1.0f) return false;
+
+		outDistance = glm::dot(edge2, q) * inverseDeterminant;
+		return outDistance > 0.0f;
+	}
+
+	static bool IntersectSphere(const Ray& ray, const Vec3& center, float radius, float& outDistance)
+	{
+		const Vec3 offset = ray.Origin - center;
+		const float b = glm::dot(offset, ray.Direction);
+		const float c = glm::dot(offset, offset) - radius * radius;
+		if (c > 0.0f && b > 0.0f) return false;
+		const float discriminant = b * b - c;
+		if (discriminant < 0.0f) return false;
+		outDistance = glm::max(-b - glm::sqrt(discriminant), 0.0f);
+		return true;
+	}
+
+	/** False, if the box lies entirely on the negative side of one of the planes */
+	static bool IsBoxInsidePlanes(const AABB& box, const Vec4 planes[6], bool* outFullyInside = nullptr)
+	{
+		bool fullyInside = true;
+		for (int i = 0; i < 6; i++)
+		{
+			const Vec3 normal = Vec3(planes[i]);
+			const Vec3 positive = Vec3(normal.x >= 0.0f ? box.Max.x : box.Min.x, normal.y >= 0.0f ? box.Max.y : box.Min.y, normal.z >= 0.0f ? box.Max.z : box.Min.z);
+			if (glm::dot(normal, positive) + planes[i].w < 0.0f) return false;
+			const Vec3 negative = Vec3(normal.x >= 0.0f ? box.Min.x : box.Max.x, normal.y >= 0.0f ? box.Min.y : box.Max.y, normal.z >= 0.0f ? box.Min.z : box.Max.z);
+			if (glm::dot(normal, negative) + planes[i].w < 0.0f) fullyInside = false;
+		}
+		if (outFullyInside) *outFullyInside = fullyInside;
+		return true;
+	}
+
+	static void GetAABBCorners(const AABB& box, Vec3 corners[8])
+	{
+		for (int i = 0; i < 8; i++)
+		{
+			corners[i] = Vec3((i & 1) ? box.Max.x : box.Min.x, (i & 2) ? box.Max.y : box.Min.y, (i & 4) ? box.Max.z : box.Min.z);
+		}
+	}
+
+	/** Separating axis test of a projected triangle against the rectangle */
+	static bool TriangleOverlapsRect(const Vec2 triangle[3], const Vec2& rectMin, const Vec2& rectMax)
+	{
+		const Vec2 triangleMin = glm::min(triangle[0], glm::min(triangle[1], triangle[2]));
+		const Vec2 triangleMax = glm::max(triangle[0], glm::max(triangle[1], triangle[2]));
+		if (triangleMin.x > rectMax.x || triangleMax.x < rectMin.x || triangleMin.y > rectMax.y || triangleMax.y < rectMin.y) return false;
+
+		const Vec2 rect[4] = { rectMin, Vec2(rectMax.x, rectMin.y), rectMax, Vec2(rectMin.x, rectMax.y) };
+		for (int edge = 0; edge < 3; edge++)
+		{
+			const Vec2 a = triangle[edge];
+			const Vec2 b = triangle[(edge + 1) % 3];
+			const Vec2 axis = Vec2(a.y - b.y, b.x - a.x);
+			const float triangleSide = glm::dot(axis, triangle[(edge + 2) % 3] - a);
+			if (triangleSide == 0.0f) continue;
+
+			bool separated = true;
+			for (const Vec2& corner : rect)
+			{
+				if (glm::dot(axis, corner - a) * triangleSide >= 0.0f)
+				{
+					separated = false;
+					break;
+				}
+			}
+			if (separated) return false;
+		}
+		return true;
+	}
+
+	/** Iterates the leaves hit by the Ray front to back, onLeaf(first, count) may shorten maxDistance */
+	template<class NodeArray, class Func>
+	static void TraverseRay(const NodeArray& nodes, const Ray& ray, const Vec3& invDirection, float& maxDistance, std::vector<std::pair<uint32_t, float>>& stack, Func&& onLeaf)
+	{
+		float distance = 0.0f;
+		if (nodes.empty() || !nodes[0].Bounds.IntersectsRay(ray, invDirection, maxDistance, distance)) return;
+
+		stack.clear();
+		stack.push_back({ 0, distance });
+		while (!stack.empty())
+		{
+			const std::pair<uint32_t, float> entry = stack.back();
+			stack.pop_back();
+			if (entry.second > maxDistance) continue;
+
+			const auto& node = nodes[entry.first];
+			if (node.Count > 0)
+			{
+				onLeaf(node.First, node.Count);
+				continue;
+			}
+
+			float nearDistance = 0.0f, farDistance = 0.0f;
+			uint32_t nearChild = node.First, farChild = node.First + 1;
+			const bool hitNear = nodes[nearChild].Bounds.IntersectsRay(ray, invDirection, maxDistance, nearDistance);
+			const bool hitFar = nodes[farChild].Bounds.IntersectsRay(ray, invDirection, maxDistance, farDistance);
+			if (hitNear && hitFar && farDistance < nearDistance)
+			{
+				std::swap(nearChild, farChild);
+				std::swap(nearDistance, farDistance);
+			}
+			// The nearer child is pushed last, so it is visited first
+			if (hitFar) stack.push_back({ farChild, farDistance });
+			if (hitNear) stack.push_back({ nearChild, nearDistance });
+		}
+	}
+
+	Ray::Ray(const Vec3& origin, const Vec3& direction)
+		: Origin(origin), Direction(glm::normalize(direction))
+	{
+	}
+
+	Ray Ray::FromNDC(const Mat4& viewProjection, const Vec2& ndc)
+	{
+		const Mat4 inverse = glm::inverse(viewProjection);
+		Vec4 nearPoint = inverse * Vec4(ndc.x, ndc.y, -1.0f, 1.0f);
+		Vec4 farPoint = inverse * Vec4(ndc.x, ndc.y, 1.0f, 1.0f);
+		nearPoint /= nearPoint.w;
+		farPoint /= farPoint.w;
+		return Ray(Vec3(nearPoint), Vec3(farPoint) - Vec3(nearPoint));
+	}
+
+	void AABB::Expand(const Vec3& point)
+	{
+		Min = glm::min(Min, point);
+		Max = glm::max(Max, point);
+	}
+
+	void AABB::Expand(const AABB& other)
+	{
+		Min = glm::min(Min, other.Min);
+		Max = glm::max(Max, other.Max);
+	}
+
+	float AABB::GetSurfaceArea() const
+	{
+		if (!IsValid()) return 0.0f;
+		const Vec3 size = GetSize();
+		return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+	}
+
+	AABB AABB::Transform(const Mat4& transform) const
+	{
+		if (!IsValid()) return AABB();
+
+		// Arvo: each axis of the transform contributes its smaller and larger product to the new bounds
+		const Vec3 translation = Vec3(transform[3]);
+		AABB result = AABB(translation, translation);
+		for (int axis = 0; axis < 3; axis++)
+		{
+			const Vec3 a = Vec3(transform[axis]) * Min[axis];
+			const Vec3 b = Vec3(transform[axis]) * Max[axis];
+			result.Min += glm::min(a, b);
+			result.Max += glm::max(a, b);
+		}
+		return result;
+	}
+
+	bool AABB::IntersectsRay(const Ray& ray, const Vec3& invDirection, float maxDistance, float& outDistance) const
+	{
+		const Vec3 t0 = (Min - ray.Origin) * invDirection;
+		const Vec3 t1 = (Max - ray.Origin) * invDirection;
+		const Vec3 tMin = glm::min(t0, t1);
+		const Vec3 tMax = glm::max(t0, t1);
+		const float enter = glm::max(glm::max(tMin.x, tMin.y), glm::max(tMin.z, 0.0f));
+		const float exit = glm::min(glm::min(tMax.x, tMax.y), glm::min(tMax.z, maxDistance));
+		outDistance = enter;
+		return enter <= exit;
+	}
+
+	SceneQuery::SceneQuery()
+	{
+	}
+
+	SceneQuery::~SceneQuery()
+	{
+		SetWorld(nullptr);
+	}
+
+	void SceneQuery::Build(World& world)
+	{
+		ClearProxies();
+		SetWorld(&world);
+		m_WorldRevision = world.GetHierarchyRevision();
+
+		// Meshes that were not queried since the last build are probably gone
+		m_BuildIndex++;
+		for (auto It = m_TriangleMeshes.begin(); It != m_TriangleMeshes.end(); )
+		{
+			if (It->second->LastUsedBuild + 1 < m_BuildIndex) It = m_TriangleMeshes.erase(It);
+			else It++;
+		}
+
+		// Disabled MeshNodes are tracked as well, so Update() notices when they are enabled
+		for (MeshNode* node : world.FindNodesByClass<MeshNode>())
+		{
+			TrackedMeshNode tracked;
+			tracked.Node = node;
+			tracked.NodeMesh = node->GetMesh();
+			tracked.Transform = node->GetTransformMatrix();
+			tracked.IsEnabled = node->IsEnabled();
+			tracked.IsStreaming = tracked.NodeMesh && tracked.NodeMesh->IsStreamingInProgress();
+			tracked.FirstProxy = (uint32_t)m_Proxies.size();
+			if (tracked.IsEnabled)
+			{
+				AddMeshNode(node);
+			}
+			tracked.ProxyCount = (uint32_t)m_Proxies.size() - tracked.FirstProxy;
+
+			m_TrackedNodeIndices[node] = (uint32_t)m_TrackedNodes.size();
+			m_TrackedNodes.push_back(tracked);
+		}
+	}
+
+	bool SceneQuery::Update(World& world)
+	{
+		if (m_World.Get() != &world || HasStructuralChanges(world))
+		{
+			Build(world);
+			return true;
+		}
+
+		bool moved = false;
+		for (TrackedMeshNode& tracked : m_TrackedNodes)
+		{
+			MeshNode* node = tracked.Node;
+			if (node->IsEnabled() != tracked.IsEnabled || node->GetMesh() != tracked.NodeMesh || (tracked.IsStreaming && !tracked.NodeMesh->IsStreamingInProgress()))
+			{
+				Build(world);
+				return true;
+			}
+
+			const Mat4 transform = node->GetTransformMatrix();
+			if (transform == tracked.Transform)
+			{
+				continue;
+			}
+			// AddMesh() skips degenerated transforms, so the number of proxies changes
+			if (tracked.IsEnabled && tracked.NodeMesh && (IsDegenerated(transform) || IsDegenerated(tracked.Transform)))
+			{
+				Build(world);
+				return true;
+			}
+
+			const float scale = GetMaxScale(transform) / GetMaxScale(tracked.Transform);
+			for (uint32_t i = tracked.FirstProxy; i < tracked.FirstProxy + tracked.ProxyCount; i++)
+			{
+				Proxy& proxy = m_Proxies[i];
+				if (proxy.Triangles)
+				{
+					proxy.Transform = transform;
+					proxy.InverseTransform = glm::inverse(transform);
+					proxy.WorldBounds = proxy.LocalBounds.Transform(transform);
+				}
+				else
+				{
+					proxy.SphereCenter = Vec3(transform[3]);
+					proxy.SphereRadius *= scale;
+					proxy.LocalBounds = AABB(proxy.SphereCenter - Vec3(proxy.SphereRadius), proxy.SphereCenter + Vec3(proxy.SphereRadius));
+					proxy.WorldBounds = proxy.LocalBounds;
+				}
+			}
+			tracked.Transform = transform;
+			moved = true;
+		}
+
+		if (moved)
+		{
+			RefitBVH();
+		}
+		return false;
+	}
+
+	bool SceneQuery::HasStructuralChanges(World& world)
+	{
+		Array<WorldHierarchyChange> changes;
+		if (!world.GetHierarchyChanges(m_WorldRevision, changes))
+		{
+			return true;
+		}
+
+		// Only the latest change of a Node tells, whether it is still alive and may be dereferenced
+		std::unordered_map<Node*, bool> alive;
+		for (const WorldHierarchyChange& change : changes)
+		{
+			if (change.Event == WorldHierarchyEvent::Added || change.Event == WorldHierarchyEvent::Removed)
+			{
+				alive[change.ChangedNode] = (change.Event == WorldHierarchyEvent::Added);
+			}
+		}
+		for (const auto& [node, isAlive] : alive)
+		{
+			// Either a tracked MeshNode was removed, or its address is taken by a new Node
+			if (m_TrackedNodeIndices.contains(node) || (isAlive && node->IsA<MeshNode>()))
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void SceneQuery::SetWorld(World* world)
+	{
+		if (m_World.Get() == world)
+		{
+			return;
+		}
+		if (m_World)
+		{
+			m_World->UnsubscribeFromHierarchyChanges();
+		}
+		m_World = world;
+		if (world)
+		{
+			m_WorldRevision = world->SubscribeToHierarchyChanges();
+		}
+	}
+
+	void SceneQuery::Clear()
+	{
+		ClearProxies();
+		SetWorld(nullptr);
+	}
+
+	void SceneQuery::ClearProxies()
+	{
+		m_Proxies.clear();
+		m_Nodes.clear();
+		m_ProxyOrder.clear();
+		m_IsBVHDirty = true;
+		m_TrackedNodes.clear();
+		m_TrackedNodeIndices.clear();
+	}
+
+	void SceneQuery::AddMeshNode(MeshNode* node)
+	{
+		if (node && node->GetMesh())
+		{
+			AddMesh(node, node->GetTransformMatrix(), *node->GetMesh());
+		}
+	}
+
+	void SceneQuery::AddMesh(Node3D* node, const Mat4& transform, Mesh& mesh)
+	{
+		if (mesh.IsMasterMesh() && mesh.m_Submeshes.Size() > 0)
+		{
+			for (const Ref<Mesh>& submesh : mesh.m_Submeshes)
+			{
+				if (submesh) AddMesh(node, transform, *submesh);
+			}
+			return;
+		}
+		// Degenerated transforms cannot be inverted, and would not be visible anyway
+		if (IsDegenerated(transform))
+		{
+			return;
+		}
+
+		Ref<SceneQueryTriangleMesh> triangles = GetTriangleMesh(mesh);
+		if (!triangles)
+		{
+			AddSphere(node, Vec3(transform[3]), mesh.m_BoundingSphereRadius * GetMaxScale(transform));
+			return;
+		}
+
+		Proxy proxy;
+		proxy.Node = node;
+		proxy.Transform = transform;
+		proxy.InverseTransform = glm::inverse(transform);
+		proxy.LocalBounds = triangles->Bounds;
+		proxy.WorldBounds = triangles->Bounds.Transform(transform);
+		proxy.Triangles = triangles;
+		m_Proxies.push_back(proxy);
+		m_IsBVHDirty = true;
+	}
+
+	void SceneQuery::AddSphere(Node3D* node, const Vec3& center, float radius)
+	{
+		Proxy proxy;
+		proxy.Node = node;
+		proxy.SphereCenter = center;
+		proxy.SphereRadius = glm::max(radius, 0.0f);
+		proxy.LocalBounds = AABB(center - Vec3(proxy.SphereRadius), center + Vec3(proxy.SphereRadius));
+		proxy.WorldBounds = proxy.LocalBounds;
+		m_Proxies.push_back(proxy);
+		m_IsBVHDirty = true;
+	}
+
+	bool SceneQuery::Raycast(const Ray& ray, SceneQueryHit& outHit, float maxDistance, const SceneQueryFilter& filter)
+	{
+		EnsureBVH();
+
+		bool hasHit = false;
+		std::vector<std::pair<uint32_t, float>> stack;
+		TraverseRay(m_Nodes, ray, SafeInverse(ray.Direction), maxDistance, stack, [&](uint32_t first, uint32_t count)
+		{
+			for (uint32_t i = first; i < first + count; i++)
+			{
+				const Proxy& proxy = m_Proxies[m_ProxyOrder[i]];
+				if (filter && !filter(proxy.Node)) continue;
+
+				SceneQueryHit hit;
+				if (RaycastProxy(proxy, ray, maxDistance, hit))
+				{
+					outHit = hit;
+					maxDistance = hit.Distance;
+					hasHit = true;
+				}
+			}
+		});
+		return hasHit;
+	}
+
+	Array<Node3D*> SceneQuery::QueryBox(const Mat4& viewProjection, const Vec2& ndcMin, const Vec2& ndcMax, SceneQueryBoxMode mode, const SceneQueryFilter& filter)
+	{
+		EnsureBVH();
+
+		const Vec2 rectMin = glm::min(ndcMin, ndcMax);
+		const Vec2 rectMax = glm::max(ndcMin, ndcMax);
+
+		// The sub-frustum of the rectangle, as planes in world space that face inwards
+		const Vec4 row0 = glm::row(viewProjection, 0);
+		const Vec4 row1 = glm::row(viewProjection, 1);
+		const Vec4 row2 = glm::row(viewProjection, 2);
+		const Vec4 row3 = glm::row(viewProjection, 3);
+		const Vec4 planes[6] =
+		{
+			row0 - row3 * rectMin.x,
+			row3 * rectMax.x - row0,
+			row1 - row3 * rectMin.y,
+			row3 * rectMax.y - row1,
+			row2 + row3,
+			row3 - row2
+		};
+
+		Array<Node3D*> result;
+		std::unordered_set<Node3D*> selected;
+		if (m_Nodes.empty()) return result;
+
+		std::vector<uint32_t> stack = { 0 };
+		while (!stack.empty())
+		{
+			const BVHNode& node = m_Nodes[stack.back()];
+			stack.pop_back();
+			if (!IsBoxInsidePlanes(node.Bounds, planes)) continue;
+
+			if (node.Count == 0)
+			{
+				stack.push_back(node.First);
+				stack.push_back(node.First + 1);
+				continue;
+			}
+			for (uint32_t i = node.First; i < node.First + node.Count; i++)
+			{
+				const Proxy& proxy = m_Proxies[m_ProxyOrder[i]];
+				if (selected.find(proxy.Node) != selected.end()) continue;
+				if (filter && !filter(proxy.Node)) continue;
+
+				const bool isInside = (mode == SceneQueryBoxMode::Intersect) ? ProxyOverlapsBox(proxy, viewProjection, planes, rectMin, rectMax)
+																			   : ProxyInsideBox(proxy, viewProjection, rectMin, rectMax);
+				if (isInside)
+				{
+					selected.insert(proxy.Node);
+					result.Add(proxy.Node);
+				}
+			}
+		}
+		return result;
+	}
+
+	bool SceneQuery::FindPlacement(const Ray& ray, SceneQueryHit& outHit, const SceneQueryFilter& filter, float fallbackDistance)
+	{
+		if (Raycast(ray, outHit, FLT_MAX, filter))
+		{
+			return true;
+		}
+
+		outHit = SceneQueryHit();
+		if (ray.Direction.y < -1e-4f && ray.Origin.y >= 0.0f)
+		{
+			outHit.Distance = -ray.Origin.y / ray.Direction.y;
+			outHit.Position = ray.GetPoint(outHit.Distance);
+			outHit.Position.y = 0.0f;
+			return true;
+		}
+
+		outHit.Distance = fallbackDistance;
+		outHit.Position = ray.GetPoint(fallbackDistance);
+		outHit.Normal = -ray.Direction;
+		return false;
+	}
+
+	void SceneQuery::BuildBVH(std::vector<BVHNode>& nodes, std::vector<uint32_t>& order, const std::vector<AABB>& bounds, uint32_t maxLeafSize)
+	{
+		nodes.clear();
+		order.resize(bounds.size());
+		std::iota(order.begin(), order.end(), 0u);
+		if (bounds.empty()) return;
+
+		std::vector<Vec3> centers(bounds.size());
+		for (size_t i = 0; i < bounds.size(); i++)
+		{
+			centers[i] = bounds[i].GetCenter();
+		}
+
+		nodes.reserve(bounds.size() * 2);
+		nodes.push_back(BVHNode{ AABB(), 0, (uint32_t)bounds.size() });
+
+		std::vector<uint32_t> pending = { 0 };
+		while (!pending.empty())
+		{
+			const uint32_t index = pending.back();
+			pending.pop_back();
+			const uint32_t first = nodes[index].First;
+			const uint32_t count = nodes[index].Count;
+
+			AABB box, centerBox;
+			for (uint32_t i = first; i < first + count; i++)
+			{
+				box.Expand(bounds[order[i]]);
+				centerBox.Expand(centers[order[i]]);
+			}
+			nodes[index].Bounds = box;
+			if (count <= maxLeafSize) continue;
+
+			// Split at the middle of the longest axis of the centers, or at the median if that leaves one side empty
+			const Vec3 size = centerBox.GetSize();
+			const int axis = (size.x > size.y) ? (size.x > size.z ? 0 : 2) : (size.y > size.z ? 1 : 2);
+			uint32_t* begin = order.data() + first;
+			uint32_t* end = begin + count;
+			uint32_t* middle = begin + count / 2;
+			if (size[axis] > 0.0f)
+			{
+				const float split = centerBox.GetCenter()[axis];
+				uint32_t* partition = std::partition(begin, end, [&](uint32_t i) { return centers[i][axis] < split; });
+				if (partition != begin && partition != end) middle = partition;
+				else std::nth_element(begin, middle, end, [&](uint32_t a, uint32_t b) { return centers[a][axis] < centers[b][axis]; });
+			}
+
+			const uint32_t leftCount = (uint32_t)(middle - begin);
+			const uint32_t child = (uint32_t)nodes.size();
+			nodes.push_back(BVHNode{ AABB(), first, leftCount });
+			nodes.push_back(BVHNode{ AABB(), first + leftCount, count - leftCount });
+			nodes[index].First = child;
+			nodes[index].Count = 0;
+			pending.push_back(child);
+			pending.push_back(child + 1);
+		}
+	}
+
+	void SceneQuery::EnsureBVH()
+	{
+		if (!m_IsBVHDirty) return;
+
+		std::vector<AABB> bounds(m_Proxies.size());
+		for (size_t i = 0; i < m_Proxies.size(); i++)
+		{
+			bounds[i] = m_Proxies[i].WorldBounds;
+		}
+		BuildBVH(m_Nodes, m_ProxyOrder, bounds, s_MaxProxiesPerLeaf);
+		m_IsBVHDirty = false;
+	}
+
+	void SceneQuery::RefitBVH()
+	{
+		if (m_IsBVHDirty) return;
+
+		// Children are always stored after their parent
+		for (size_t i = m_Nodes.size(); i-- > 0; )
+		{
+			BVHNode& node = m_Nodes[i];
+			AABB bounds;
+			if (node.Count > 0)
+			{
+				for (uint32_t j = node.First; j < node.First + node.Count; j++)
+				{
+					bounds.Expand(m_Proxies[m_ProxyOrder[j]].WorldBounds);
+				}
+			}
+			else
+			{
+				bounds.Expand(m_Nodes[node.First].Bounds);
+				bounds.Expand(m_Nodes[node.First + 1].Bounds);
+			}
+			node.Bounds = bounds;
+		}
+	}
+
+	Ref<SceneQueryTriangleMesh> SceneQuery::GetTriangleMesh(Mesh& mesh)
+	{
+		// The streaming thread fills its own MeshBuffer, which is moved into the Mesh on the main thread. The GPU upload
+		// does not matter for queries, so procedural Meshes and headless Worlds are queried by their triangles as well.
+		if (mesh.IsStreamingInProgress())
+		{
+			return nullptr;
+		}
+		const std::vector<Vertex>& vertices = mesh.m_MeshBuffer.Vertices;
+		const std::vector<uint32_t>& indices = (mesh.IsDecimaMesh() && mesh.m_MainCluster) ? mesh.m_MainCluster->Indices : mesh.m_MeshBuffer.Indices;
+		if (vertices.empty() || indices.size() < 3)
+		{
+			return nullptr;
+		}
+
+		auto It = m_TriangleMeshes.find(&mesh);
+		if (It != m_TriangleMeshes.end())
+		{
+			const Ref<SceneQueryTriangleMesh>& cached = It->second;
+			if (cached->SourceVertices == vertices.data() && cached->SourceIndices == indices.data() && cached->SourceVertexCount == vertices.size() && cached->SourceIndexCount == indices.size())
+			{
+				cached->LastUsedBuild = m_BuildIndex;
+				return cached;
+			}
+		}
+
+		Ref<SceneQueryTriangleMesh> triangles = CreateRef<SceneQueryTriangleMesh>();
+		triangles->SourceVertices = vertices.data();
+		triangles->SourceIndices = indices.data();
+		triangles->SourceVertexCount = vertices.size();
+		triangles->SourceIndexCount = indices.size();
+		triangles->LastUsedBuild = m_BuildIndex;
+
+		triangles->Positions.resize(vertices.size());
+		for (size_t i = 0; i < vertices.size(); i++)
+		{
+			triangles->Positions[i] = vertices[i].Position;
+		}
+
+		std::vector<uint32_t> validTriangles;
+		std::vector<AABB> bounds;
+		const uint32_t triangleCount = (uint32_t)(indices.size() / 3);
+		validTriangles.reserve(triangleCount);
+		bounds.reserve(triangleCount);
+		for (uint32_t i = 0; i < triangleCount; i++)
+		{
+			const uint32_t a = indices[i * 3 + 0], b = indices[i * 3 + 1], c = indices[i * 3 + 2];
+			if (a >= vertices.size() || b >= vertices.size() || c >= vertices.size()) continue;
+
+			AABB box;
+			box.Expand(triangles->Positions[a]);
+			box.Expand(triangles->Positions[b]);
+			box.Expand(triangles->Positions[c]);
+			validTriangles.push_back(i);
+			bounds.push_back(box);
+		}
+		if (validTriangles.empty())
+		{
+			return nullptr;
+		}
+
+		std::vector<uint32_t> order;
+		BuildBVH(triangles->Nodes, order, bounds, s_MaxTrianglesPerLeaf);
+		triangles->Bounds = triangles->Nodes[0].Bounds;
+
+		triangles->Indices.resize(order.size() * 3);
+		triangles->TriangleIDs.resize(order.size());
+		for (size_t i = 0; i < order.size(); i++)
+		{
+			const uint32_t triangle = validTriangles[order[i]];
+			triangles->Indices[i * 3 + 0] = indices[triangle * 3 + 0];
+			triangles->Indices[i * 3 + 1] = indices[triangle * 3 + 1];
+			triangles->Indices[i * 3 + 2] = indices[triangle * 3 + 2];
+			triangles->TriangleIDs[i] = triangle;
+		}
+
+		m_TriangleMeshes[&mesh] = triangles;
+		return triangles;
+	}
+
+	bool SceneQuery::RaycastProxy(const Proxy& proxy, const Ray& ray, float maxDistance, SceneQueryHit& outHit) const
+	{
+		if (!proxy.Triangles)
+		{
+			float distance = 0.0f;
+			if (!IntersectSphere(ray, proxy.SphereCenter, proxy.SphereRadius, distance) || distance > maxDistance) return false;
+			outHit.Node = proxy.Node;
+			outHit.Distance = distance;
+			outHit.Position = ray.GetPoint(distance);
+			outHit.Normal = distance > 0.0f ? glm::normalize(outHit.Position - proxy.SphereCenter) : -ray.Direction;
+			outHit.Triangle = -1;
+			return true;
+		}
+
+		// The local direction is not normalized, so distances along it stay in world units
+		Ray localRay;
+		localRay.Origin = Vec3(proxy.InverseTransform * Vec4(ray.Origin, 1.0f));
+		localRay.Direction = glm::mat3(proxy.InverseTransform) * ray.Direction;
+
+		const SceneQueryTriangleMesh& mesh = *proxy.Triangles;
+		int32_t hitTriangle = -1;
+		std::vector<std::pair<uint32_t, float>> stack;
+		TraverseRay(mesh.Nodes, localRay, SafeInverse(localRay.Direction), maxDistance, stack, [&](uint32_t first, uint32_t count)
+		{
+			for (uint32_t i = first; i < first + count; i++)
+			{
+				float distance = 0.0f;
+				const Vec3& a = mesh.Positions[mesh.Indices[i * 3 + 0]];
+				const Vec3& b = mesh.Positions[mesh.Indices[i * 3 + 1]];
+				const Vec3& c = mesh.Positions[mesh.Indices[i * 3 + 2]];
+				if (IntersectTriangle(localRay.Origin, localRay.Direction, a, b, c, distance) && distance < maxDistance)
+				{
+					maxDistance = distance;
+					hitTriangle = (int32_t)i;
+				}
+			}
+		});
+		if (hitTriangle < 0) return false;
+
+		const Vec3& a = mesh.Positions[mesh.Indices[hitTriangle * 3 + 0]];
+		const Vec3& b = mesh.Positions[mesh.Indices[hitTriangle * 3 + 1]];
+		const Vec3& c = mesh.Positions[mesh.Indices[hitTriangle * 3 + 2]];
+		Vec3 normal = glm::transpose(glm::mat3(proxy.InverseTransform)) * glm::cross(b - a, c - a);
+		normal = glm::length(normal) > 0.0f ? glm::normalize(normal) : -ray.Direction;
+		if (glm::dot(normal, ray.Direction) > 0.0f) normal = -normal;
+
+		outHit.Node = proxy.Node;
+		outHit.Distance = maxDistance;
+		outHit.Position = ray.GetPoint(maxDistance);
+		outHit.Normal = normal;
+		outHit.Triangle = (int32_t)mesh.TriangleIDs[hitTriangle];
+		return true;
+	}
+
+	bool SceneQuery::ProxyOverlapsBox(const Proxy& proxy, const Mat4& viewProjection, const Vec4 planes[6], const Vec2& ndcMin, const Vec2& ndcMax) const
+	{
+		bool fullyInside = false;
+		if (!IsBoxInsidePlanes(proxy.WorldBounds, planes, &fullyInside)) return false;
+		if (fullyInside) return true;
+
+		if (!proxy.Triangles)
+		{
+			for (int i = 0; i < 6; i++)
+			{
+				if (glm::dot(Vec3(planes[i]), proxy.SphereCenter) + planes[i].w < -proxy.SphereRadius * glm::length(Vec3(planes[i]))) return false;
+			}
+			return true;
+		}
+
+		// dot(plane, transform * v) == dot(transpose(transform) * plane, v)
+		Vec4 localPlanes[6];
+		const Mat4 transposed = glm::transpose(proxy.Transform);
+		for (int i = 0; i < 6; i++)
+		{
+			localPlanes[i] = transposed * planes[i];
+		}
+		const Mat4 clipTransform = viewProjection * proxy.Transform;
+
+		const SceneQueryTriangleMesh& mesh = *proxy.Triangles;
+		std::vector<uint32_t> stack = { 0 };
+		while (!stack.empty())
+		{
+			const BVHNode& node = mesh.Nodes[stack.back()];
+			stack.pop_back();
+
+			bool nodeInside = false;
+			if (!IsBoxInsidePlanes(node.Bounds, localPlanes, &nodeInside)) continue;
+			if (nodeInside) return true;
+
+			if (node.Count == 0)
+			{
+				stack.push_back(node.First);
+				stack.push_back(node.First + 1);
+				continue;
+			}
+			for (uint32_t i = node.First; i < node.First + node.Count; i++)
+			{
+				Vec4 clip[3];
+				bool isBehindCamera = false;
+				for (int v = 0; v < 3; v++)
+				{
+					clip[v] = clipTransform * Vec4(mesh.Positions[mesh.Indices[i * 3 + v]], 1.0f);
+					isBehindCamera |= clip[v].w <= 1e-6f;
+				}
+
+				bool isOutside = false;
+				for (int p = 0; p < 6 && !isOutside; p++)
+				{
+					const Vec4& plane = localPlanes[p];
+					isOutside = true;
+					for (int v = 0; v < 3; v++)
+					{
+						if (glm::dot(Vec3(plane), mesh.Positions[mesh.Indices[i * 3 + v]]) + plane.w >= 0.0f)
+						{
+							isOutside = false;
+							break;
+						}
+					}
+				}
+				if (isOutside) continue;
+
+				// Triangles crossing the camera plane cannot be projected, they are accepted conservatively
+				if (isBehindCamera) return true;
+
+				const Vec2 projected[3] = { Vec2(clip[0]) / clip[0].w, Vec2(clip[1]) / clip[1].w, Vec2(clip[2]) / clip[2].w };
+				if (TriangleOverlapsRect(projected, ndcMin, ndcMax)) return true;
+			}
+		}
+		return false;
+	}
+
+	bool SceneQuery::ProxyInsideBox(const Proxy& proxy, const Mat4& viewProjection, const Vec2& ndcMin, const Vec2& ndcMax) const
+	{
+		Vec3 corners[8];
+		GetAABBCorners(proxy.LocalBounds, corners);
+		const Mat4 clipTransform = proxy.Triangles ? viewProjection * proxy.Transform : viewProjection;
+		for (const Vec3& corner : corners)
+		{
+			const Vec4 clip = clipTransform * Vec4(corner, 1.0f);
+			if (clip.w <= 1e-6f) return false;
+
+			const Vec2 ndc = Vec2(clip) / clip.w;
+			if (ndc.x < ndcMin.x || ndc.x > ndcMax.x || ndc.y < ndcMin.y || ndc.y > ndcMax.y) return false;
+		}
+		return true;
+	}
+
+}
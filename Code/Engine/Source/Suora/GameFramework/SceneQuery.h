@@ -0,0 +1,180 @@
+#pragma once
+#include <cstdint>
+#include <cfloat>
+#include <functional>
+#include <vector>
+#include <unordered_map>
+#include "Suora/Common/Array.h"
+#include "Suora/Common/VectorUtils.h"
+#include "Suora/Core/Base.h"
+#include "Suora/Core/Object/Pointer.h"
+
+namespace Suora
+{
+	class Mesh;
+	class Node;
+	class Node3D;
+	class MeshNode;
+	class World;
+
+	struct Ray
+	{
+		Vec3 Origin = Vec3(0.0f);
+		/** Normalized, so hit distances are in world units */
+		Vec3 Direction = Vec3(0.0f, 0.0f, 1.0f);
+
+		Ray() = default;
+		Ray(const Vec3& origin, const Vec3& direction);
+
+		Vec3 GetPoint(float distance) const { return Origin + Direction * distance; }
+
+		/** ndc in [-1, 1], with (-1, -1) at the bottom left, works for perspective and orthographic projections */
+		static Ray FromNDC(const Mat4& viewProjection, const Vec2& ndc);
+	};
+
+	struct AABB
+	{
+		Vec3 Min = Vec3(FLT_MAX);
+		Vec3 Max = Vec3(-FLT_MAX);
+
+		AABB() = default;
+		AABB(const Vec3& min, const Vec3& max) : Min(min), Max(max) { }
+
+		bool IsValid() const { return Min.x <= Max.x && Min.y <= Max.y && Min.z <= Max.z; }
+		void Expand(const Vec3& point);
+		void Expand(const AABB& other);
+		Vec3 GetCenter() const { return (Min + Max) * 0.5f; }
+		Vec3 GetSize() const { return Max - Min; }
+		float GetSurfaceArea() const;
+		/** The bounds of the transformed box */
+		AABB Transform(const Mat4& transform) const;
+		/** Slab test, invDirection is 1 / ray.Direction. Returns the entry distance, clamped to 0, in outDistance */
+		bool IntersectsRay(const Ray& ray, const Vec3& invDirection, float maxDistance, float& outDistance) const;
+	};
+
+	struct SceneQueryHit
+	{
+		/** Null, if FindPlacement() fell back to the ground plane or a point along the Ray */
+		Node3D* Node = nullptr;
+		Vec3 Position = Vec3(0.0f);
+		Vec3 Normal = Vec3(0.0f, 1.0f, 0.0f);
+		float Distance = 0.0f;
+		/** Index of the triangle in the Mesh, or -1 for bounding sphere proxies */
+		int32_t Triangle = -1;
+	};
+
+	enum class SceneQueryBoxMode : uint8_t
+	{
+		/** Selects everything that overlaps the box on screen */
+		Intersect = 0,
+		/** Selects only what lies entirely inside the box */
+		Contain
+	};
+
+	/** Returns false to skip a Node */
+	using SceneQueryFilter = std::function<bool(Node3D*)>;
+
+	struct SceneQueryTriangleMesh;
+
+	/* Answers ray, box and placement queries against the renderables of a World on the CPU, without rendering them.
+	 * Every proxy (a Mesh with its transform) is placed in a bounding volume hierarchy over its world bounds, whose
+	 * leaves are refined against a second hierarchy over the triangles of the Mesh. The triangle hierarchies are built
+	 * from the CPU side MeshBuffer (the main Cluster for Decima Meshes) and cached by Mesh across Build() calls.
+	 * Meshes without CPU data, e.g. while streamed out, are approximated by their bounding sphere.
+	 * Build() once and Update() before each use; the query subscribes to the hierarchy journal of the World, until
+	 * it is cleared or destroyed.                                                                                 */
+	class SceneQuery
+	{
+	public:
+		SceneQuery();
+		~SceneQuery();
+		SceneQuery(const SceneQuery&) = delete;
+		SceneQuery& operator=(const SceneQuery&) = delete;
+
+		/** Gathers all enabled MeshNodes of the World, and remembers them for Update() */
+		void Build(World& world);
+		/** Brings the query up to date with the World. MeshNodes that only moved are refit in place; added or removed
+		 *  MeshNodes, other Meshes, enabled states and Meshes that finished streaming rebuild it, as does another World.
+		 *  Proxies added by hand do not survive a rebuild. Returns true, if the query was rebuilt.                     */
+		bool Update(World& world);
+		void Clear();
+
+		void AddMeshNode(MeshNode* node);
+		/** Adds a proxy for the Node, for instance an editor gizmo, that is not necessarily the Node's own Mesh */
+		void AddMesh(Node3D* node, const Mat4& transform, Mesh& mesh);
+		void AddSphere(Node3D* node, const Vec3& center, float radius);
+
+		/** The closest hit along the Ray */
+		bool Raycast(const Ray& ray, SceneQueryHit& outHit, float maxDistance = FLT_MAX, const SceneQueryFilter& filter = nullptr);
+		/** All Nodes within the rectangle (given in ndc) as seen through viewProjection, in no particular order */
+		Array<Node3D*> QueryBox(const Mat4& viewProjection, const Vec2& ndcMin, const Vec2& ndcMax, SceneQueryBoxMode mode = SceneQueryBoxMode::Intersect, const SceneQueryFilter& filter = nullptr);
+		/** Where something dropped along the Ray should be placed: the surface it hits, else the ground plane (y = 0),
+		 *  else the point at fallbackDistance. Returns false only in the last case.                                 */
+		bool FindPlacement(const Ray& ray, SceneQueryHit& outHit, const SceneQueryFilter& filter = nullptr, float fallbackDistance = 10.0f);
+
+		uint32_t GetProxyCount() const { return (uint32_t)m_Proxies.size(); }
+
+	private:
+		struct BVHNode
+		{
+			AABB Bounds;
+			/** Index of the first child for inner nodes, of the first primitive for leaves */
+			uint32_t First = 0;
+			/** 0 for inner nodes */
+			uint32_t Count = 0;
+		};
+		struct Proxy
+		{
+			Node3D* Node = nullptr;
+			Mat4 Transform = Mat4(1.0f);
+			Mat4 InverseTransform = Mat4(1.0f);
+			AABB LocalBounds;
+			AABB WorldBounds;
+			/** Null for bounding sphere proxies */
+			Ref<SceneQueryTriangleMesh> Triangles;
+			Vec3 SphereCenter = Vec3(0.0f);
+			float SphereRadius = 0.0f;
+		};
+
+		struct TrackedMeshNode
+		{
+			MeshNode* Node = nullptr;
+			const Mesh* NodeMesh = nullptr;
+			Mat4 Transform = Mat4(1.0f);
+			bool IsEnabled = false;
+			/** Its bounding sphere stands in for the Mesh until the next build */
+			bool IsStreaming = false;
+			uint32_t FirstProxy = 0;
+			uint32_t ProxyCount = 0;
+		};
+
+		static void BuildBVH(std::vector<BVHNode>& nodes, std::vector<uint32_t>& order, const std::vector<AABB>& bounds, uint32_t maxLeafSize);
+		void EnsureBVH();
+		/** Recomputes the bounds of the BVH nodes, keeping their structure */
+		void RefitBVH();
+		void ClearProxies();
+		void SetWorld(World* world);
+		/** True, if MeshNodes were added to or removed from the World since the last build */
+		bool HasStructuralChanges(World& world);
+		Ref<SceneQueryTriangleMesh> GetTriangleMesh(Mesh& mesh);
+		bool RaycastProxy(const Proxy& proxy, const Ray& ray, float maxDistance, SceneQueryHit& outHit) const;
+		bool ProxyOverlapsBox(const Proxy& proxy, const Mat4& viewProjection, const Vec4 planes[6], const Vec2& ndcMin, const Vec2& ndcMax) const;
+		bool ProxyInsideBox(const Proxy& proxy, const Mat4& viewProjection, const Vec2& ndcMin, const Vec2& ndcMax) const;
+
+		std::vector<Proxy> m_Proxies;
+		std::vector<BVHNode> m_Nodes;
+		std::vector<uint32_t> m_ProxyOrder;
+		bool m_IsBVHDirty = true;
+
+		Ptr<World> m_World;
+		uint64_t m_WorldRevision = 0;
+		std::vector<TrackedMeshNode> m_TrackedNodes;
+		std::unordered_map<const Node*, uint32_t> m_TrackedNodeIndices;
+
+		std::unordered_map<const Mesh*, Ref<SceneQueryTriangleMesh>> m_TriangleMeshes;
+		uint32_t m_BuildIndex = 0;
+
+		friend struct SceneQueryTriangleMesh;
+	};
+
+}
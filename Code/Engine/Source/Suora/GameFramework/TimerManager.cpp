@@ -0,0 +1,304 @@
+#include "Precompiled.h"
+#include "TimerManager.h"
+#include <cmath>
+
+namespace Suora
+{
+
+	TimerManager::TimerManager()
+	{
+		for (Wheel& wheel : m_Wheels)
+		{
+			wheel.Buckets.resize(s_WheelCount * s_SlotsPerWheel, s_Invalid);
+		}
+	}
+
+	uint64_t TimerManager::SecondsToTicks(double seconds)
+	{
+		// Rounded to the nearest tick, float intervals like 0.1f are slightly above their value and would lose a tick per expiration
+		return seconds > 0.0 ? (uint64_t)std::llround(seconds * s_TicksPerSecond) : 0;
+	}
+
+	TimerHandle TimerManager::SetTimer(float interval, const std::function<void()>& callback, const TimerParams& params)
+	{
+		const uint32_t index = AllocateTimer();
+		Timer& timer = m_Timers[index];
+		timer.Callback = callback;
+		timer.Clock = params.Clock;
+		timer.Loop = params.Loop;
+		timer.IntervalTicks = std::max<uint64_t>(1, SecondsToTicks(interval));
+
+		const Wheel& wheel = GetWheel(timer);
+		const float delay = params.FirstDelay >= 0.0f ? params.FirstDelay : interval;
+		timer.ExpireTick = std::max(SecondsToTicks(wheel.Time + delay), wheel.CurrentTick + 1);
+		Link(index);
+		m_ActiveTimers++;
+
+		return TimerHandle{ index, timer.Generation };
+	}
+
+	bool TimerManager::ClearTimer(TimerHandle& handle)
+	{
+		Timer* timer = Resolve(handle);
+		handle.Invalidate();
+		if (!timer) return false;
+
+		const uint32_t index = (uint32_t)(timer - m_Timers.data());
+		if (!timer->Paused) Unlink(index);
+		FreeTimer(index);
+		m_ActiveTimers--;
+		return true;
+	}
+
+	void TimerManager::ClearAllTimers()
+	{
+		for (uint32_t i = 0; i < (uint32_t)m_Timers.size(); i++)
+		{
+			if (m_Timers[i].Active)
+			{
+				if (!m_Timers[i].Paused) Unlink(i);
+				FreeTimer(i);
+			}
+		}
+		m_ActiveTimers = 0;
+	}
+
+	void TimerManager::PauseTimer(const TimerHandle& handle)
+	{
+		Timer* timer = Resolve(handle);
+		if (!timer || timer->Paused) return;
+
+		timer->PausedTicks = timer->ExpireTick - GetWheel(*timer).CurrentTick;
+		Unlink((uint32_t)(timer - m_Timers.data()));
+		timer->Paused = true;
+	}
+
+	void TimerManager::ResumeTimer(const TimerHandle& handle)
+	{
+		Timer* timer = Resolve(handle);
+		if (!timer || !timer->Paused) return;
+
+		timer->ExpireTick = GetWheel(*timer).CurrentTick + std::max<uint64_t>(1, timer->PausedTicks);
+		timer->Paused = false;
+		Link((uint32_t)(timer - m_Timers.data()));
+	}
+
+	bool TimerManager::IsTimerActive(const TimerHandle& handle) const
+	{
+		return Resolve(handle) != nullptr;
+	}
+
+	bool TimerManager::IsTimerPaused(const TimerHandle& handle) const
+	{
+		const Timer* timer = Resolve(handle);
+		return timer && timer->Paused;
+	}
+
+	float TimerManager::GetTimerRemaining(const TimerHandle& handle) const
+	{
+		const Timer* timer = Resolve(handle);
+		if (!timer) return 0.0f;
+		if (timer->Paused) return (float)timer->PausedTicks / s_TicksPerSecond;
+
+		return (float)std::max(0.0, (double)timer->ExpireTick / s_TicksPerSecond - GetWheel(*timer).Time);
+	}
+
+	float TimerManager::GetTimerElapsed(const TimerHandle& handle) const
+	{
+		const Timer* timer = Resolve(handle);
+		if (!timer) return 0.0f;
+
+		return std::max(0.0f, (float)timer->IntervalTicks / s_TicksPerSecond - GetTimerRemaining(handle));
+	}
+
+	double TimerManager::GetTime(TimerClock clock) const
+	{
+		return m_Wheels[(uint32_t)clock].Time;
+	}
+
+	void TimerManager::Advance(float deltaTime)
+	{
+		Wheel& game = m_Wheels[(uint32_t)TimerClock::Game];
+		if (!m_Paused)
+		{
+			game.Time += (double)deltaTime * m_TimeDilation;
+		}
+		AdvanceWheel(game, (uint64_t)(game.Time * s_TicksPerSecond));
+
+		Wheel& real = m_Wheels[(uint32_t)TimerClock::Real];
+		real.Time += deltaTime;
+		AdvanceWheel(real, (uint64_t)(real.Time * s_TicksPerSecond));
+	}
+
+	void TimerManager::AdvanceWheel(Wheel& wheel, uint64_t targetTick)
+	{
+		while (wheel.CurrentTick < targetTick)
+		{
+			if (wheel.LinkedTimers == 0)
+			{
+				// Nothing to fire or cascade, the buckets are only addressed relative to CurrentTick
+				wheel.CurrentTick = targetTick;
+				return;
+			}
+
+			const uint64_t tick = ++wheel.CurrentTick;
+
+			// Move the timers of the next coarser slot down, before the finest slot of this tick is fired
+			for (uint32_t level = s_WheelCount - 1; level > 0; level--)
+			{
+				if ((tick & ((1ull << (s_SlotBits * level)) - 1)) == 0)
+				{
+					Cascade(wheel, level);
+				}
+			}
+
+			uint32_t& bucket = wheel.Buckets[tick & (s_SlotsPerWheel - 1)];
+			while (bucket != s_Invalid)
+			{
+				const uint32_t index = bucket;
+				Unlink(index);
+				Expire(index);
+			}
+		}
+	}
+
+	void TimerManager::Cascade(Wheel& wheel, uint32_t level)
+	{
+		const uint32_t slot = (uint32_t)(wheel.CurrentTick >> (s_SlotBits * level)) & (s_SlotsPerWheel - 1);
+		uint32_t& bucket = wheel.Buckets[level * s_SlotsPerWheel + slot];
+		while (bucket != s_Invalid)
+		{
+			const uint32_t index = bucket;
+			Unlink(index);
+			Link(index);
+		}
+	}
+
+	void TimerManager::Expire(uint32_t index)
+	{
+		Timer& timer = m_Timers[index];
+
+		// The callback may set or clear timers (even this one), so it is moved out of the Timer while it runs
+		std::function<void()> callback = std::move(timer.Callback);
+		timer.Callback = nullptr;
+		const uint32_t generation = timer.Generation;
+		const bool loop = timer.Loop;
+
+		if (loop)
+		{
+			timer.ExpireTick = std::max(timer.ExpireTick + timer.IntervalTicks, GetWheel(timer).CurrentTick + 1);
+			Link(index);
+		}
+		else
+		{
+			FreeTimer(index);
+			m_ActiveTimers--;
+		}
+
+		if (callback)
+		{
+			callback();
+		}
+
+		if (loop)
+		{
+			Timer& again = m_Timers[index];
+			if (again.Active && again.Generation == generation && !again.Callback)
+			{
+				again.Callback = std::move(callback);
+			}
+		}
+	}
+
+	void TimerManager::Link(uint32_t index)
+	{
+		Timer& timer = m_Timers[index];
+		Wheel& wheel = GetWheel(timer);
+
+		// The finest wheel, whose slots reach the expiration, takes the timer
+		uint32_t level = 0;
+		uint64_t slot = timer.ExpireTick;
+		while (level < s_WheelCount)
+		{
+			slot = timer.ExpireTick >> (s_SlotBits * level);
+			if (slot - (wheel.CurrentTick >> (s_SlotBits * level)) < s_SlotsPerWheel) break;
+			level++;
+		}
+		if (level == s_WheelCount)
+		{
+			// Beyond the range of the coarsest wheel, park it in its last slot and cascade again from there
+			level = s_WheelCount - 1;
+			slot = (wheel.CurrentTick >> (s_SlotBits * level)) + s_SlotsPerWheel - 1;
+		}
+
+		timer.Bucket = level * s_SlotsPerWheel + (uint32_t)(slot & (s_SlotsPerWheel - 1));
+		uint32_t& head = wheel.Buckets[timer.Bucket];
+		timer.Prev = s_Invalid;
+		timer.Next = head;
+		if (head != s_Invalid) m_Timers[head].Prev = index;
+		head = index;
+		wheel.LinkedTimers++;
+	}
+
+	void TimerManager::Unlink(uint32_t index)
+	{
+		Timer& timer = m_Timers[index];
+		Wheel& wheel = GetWheel(timer);
+
+		if (timer.Prev != s_Invalid) m_Timers[timer.Prev].Next = timer.Next;
+		else wheel.Buckets[timer.Bucket] = timer.Next;
+		if (timer.Next != s_Invalid) m_Timers[timer.Next].Prev = timer.Prev;
+
+		timer.Prev = s_Invalid;
+		timer.Next = s_Invalid;
+		timer.Bucket = s_Invalid;
+		wheel.LinkedTimers--;
+	}
+
+	uint32_t TimerManager::AllocateTimer()
+	{
+		uint32_t index = 0;
+		if (!m_FreeTimers.IsEmpty())
+		{
+			index = m_FreeTimers[m_FreeTimers.Last()];
+			m_FreeTimers.RemoveLastItem();
+		}
+		else
+		{
+			index = (uint32_t)m_Timers.size();
+			m_Timers.emplace_back();
+		}
+
+		Timer& timer = m_Timers[index];
+		timer.Active = true;
+		timer.Paused = false;
+		timer.PausedTicks = 0;
+		return index;
+	}
+
+	void TimerManager::FreeTimer(uint32_t index)
+	{
+		Timer& timer = m_Timers[index];
+		timer.Callback = nullptr;
+		timer.Active = false;
+		timer.Paused = false;
+		// Invalidates all handles to this slot
+		timer.Generation++;
+		m_FreeTimers.Add(index);
+	}
+
+	TimerManager::Timer* TimerManager::Resolve(const TimerHandle& handle)
+	{
+		if (handle.Index >= m_Timers.size()) return nullptr;
+		Timer& timer = m_Timers[handle.Index];
+		return (timer.Active && timer.Generation == handle.Generation) ? &timer : nullptr;
+	}
+
+	const TimerManager::Timer* TimerManager::Resolve(const TimerHandle& handle) const
+	{
+		if (handle.Index >= m_Timers.size()) return nullptr;
+		const Timer& timer = m_Timers[handle.Index];
+		return (timer.Active && timer.Generation == handle.Generation) ? &timer : nullptr;
+	}
+
+}
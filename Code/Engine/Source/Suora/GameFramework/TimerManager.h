@@ -0,0 +1,128 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include "Suora/Common/Array.h"
+
+namespace Suora
+{
+
+	/** Identifies a timer of a TimerManager. Stays invalid after the timer completed or was cancelled. */
+	struct TimerHandle
+	{
+		uint32_t Index = UINT32_MAX;
+		uint32_t Generation = 0;
+
+		bool IsValid() const { return Index != UINT32_MAX; }
+		void Invalidate() { Index = UINT32_MAX; }
+		bool operator==(const TimerHandle& other) const { return Index == other.Index && Generation == other.Generation; }
+	};
+
+	enum class TimerClock : uint8_t
+	{
+		/** Scaled by the TimeDilation and stopped while the game is paused */
+		Game = 0,
+		/** Unscaled time, keeps running while paused */
+		Real
+	};
+
+	struct TimerParams
+	{
+		TimerClock Clock = TimerClock::Game;
+		/** Reschedules the timer after every expiration */
+		bool Loop = false;
+		/** Delay of the first expiration, negative uses the interval */
+		float FirstDelay = -1.0f;
+	};
+
+	/* Schedules callbacks on a hierarchical timer wheel, one per TimerClock. Timers are kept in buckets of four wheels
+	 * with 256 slots each, so scheduling and cancelling are O(1) and advancing only touches the buckets of elapsed
+	 * ticks, instead of visiting every timer every frame. Timers expire at a resolution of s_TicksPerSecond.
+	 * Owned by the World and advanced at the beginning of its WorldUpdate, not thread-safe. */
+	class TimerManager
+	{
+	public:
+		static constexpr uint32_t s_TicksPerSecond = 1000;
+
+		TimerManager();
+
+		TimerHandle SetTimer(float interval, const std::function<void()>& callback, const TimerParams& params = TimerParams());
+		/** Returns false, if the handle did not belong to a running or paused timer */
+		bool ClearTimer(TimerHandle& handle);
+		void ClearAllTimers();
+
+		void PauseTimer(const TimerHandle& handle);
+		void ResumeTimer(const TimerHandle& handle);
+		bool IsTimerActive(const TimerHandle& handle) const;
+		bool IsTimerPaused(const TimerHandle& handle) const;
+		/** Seconds left until the next expiration, 0 for invalid handles */
+		float GetTimerRemaining(const TimerHandle& handle) const;
+		float GetTimerElapsed(const TimerHandle& handle) const;
+
+		/** Fires all timers that expire within deltaTime */
+		void Advance(float deltaTime);
+
+		void SetPaused(bool paused) { m_Paused = paused; }
+		bool IsPaused() const { return m_Paused; }
+		void SetTimeDilation(float timeDilation) { m_TimeDilation = timeDilation >= 0.0f ? timeDilation : 0.0f; }
+		float GetTimeDilation() const { return m_TimeDilation; }
+		/** Seconds of the clock since the TimerManager was created */
+		double GetTime(TimerClock clock) const;
+
+		uint32_t GetActiveTimerCount() const { return m_ActiveTimers; }
+
+	private:
+		static constexpr uint32_t s_Invalid = UINT32_MAX;
+		static constexpr uint32_t s_SlotBits = 8;
+		static constexpr uint32_t s_SlotsPerWheel = 1 << s_SlotBits;
+		static constexpr uint32_t s_WheelCount = 4;
+
+		struct Timer
+		{
+			std::function<void()> Callback;
+			uint64_t ExpireTick = 0;
+			uint64_t IntervalTicks = 0;
+			/** Ticks that were left when the timer was paused */
+			uint64_t PausedTicks = 0;
+			uint32_t Prev = s_Invalid;
+			uint32_t Next = s_Invalid;
+			uint32_t Bucket = s_Invalid;
+			uint32_t Generation = 0;
+			TimerClock Clock = TimerClock::Game;
+			bool Loop = false;
+			bool Active = false;
+			bool Paused = false;
+		};
+		struct Wheel
+		{
+			/** Heads of the bucket lists, bucket = wheel * s_SlotsPerWheel + slot */
+			std::vector<uint32_t> Buckets;
+			/** The last tick, whose timers were fired */
+			uint64_t CurrentTick = 0;
+			uint32_t LinkedTimers = 0;
+			double Time = 0.0;
+		};
+
+		Timer* Resolve(const TimerHandle& handle);
+		const Timer* Resolve(const TimerHandle& handle) const;
+		uint32_t AllocateTimer();
+		void FreeTimer(uint32_t index);
+		void Link(uint32_t index);
+		void Unlink(uint32_t index);
+		void AdvanceWheel(Wheel& wheel, uint64_t targetTick);
+		void Cascade(Wheel& wheel, uint32_t level);
+		void Expire(uint32_t index);
+		Wheel& GetWheel(const Timer& timer) { return m_Wheels[(uint32_t)timer.Clock]; }
+		const Wheel& GetWheel(const Timer& timer) const { return m_Wheels[(uint32_t)timer.Clock]; }
+
+		static uint64_t SecondsToTicks(double seconds);
+
+		std::vector<Timer> m_Timers;
+		Array<uint32_t> m_FreeTimers;
+		Wheel m_Wheels[2];
+		uint32_t m_ActiveTimers = 0;
+		bool m_Paused = false;
+		float m_TimeDilation = 1.0f;
+	};
+
+}
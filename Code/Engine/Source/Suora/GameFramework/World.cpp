@@ -3,8 +3,12 @@
 #include "Suora/GameFramework/Node.h"
 #include "Suora/Reflection/New.h"
 #include "Suora/Core/Engine.h"
+#include "Suora/Core/TaskScheduler.h"
+#include "Suora/Debug/Profiler.h"
 #include "Suora/Physics/PhysicsEngine.h"
 #include "Suora/Physics/PhysicsWorld.h"
+#include "Suora/GameFramework/Nodes/CameraNode.h"
+#include "Suora/Networking/Networking.h"
 
 #define LOCAL_UPDATE_CHUNKS_PER_THREAD 128
 
@@ -15,8 +19,39 @@ namespace Suora
 	{
 	}
 
+	/** Swap-removal keeps removing from the Node lists constant time, the order of the lists is not relevant */
+	static void AddIndexedNode(Array<Node*>& nodes, Node* node, int32_t Node::* index)
+	{
+		if (node->*index != -1) return;
+
+		node->*index = nodes.Size();
+		nodes.Add(node);
+	}
+	static void RemoveIndexedNode(Array<Node*>& nodes, Node* node, int32_t Node::* index)
+	{
+		const int32_t i = node->*index;
+		if (i == -1) return;
+
+		Node* last = nodes[nodes.Last()];
+		nodes[i] = last;
+		if (last) last->*index = i;
+		nodes.RemoveLastItem();
+		node->*index = -1;
+	}
+
 	World::~World()
 	{
+		SetNetworkContext(nullptr);
+
+		for (auto& [cls, pool] : m_RecyclePools)
+		{
+			for (Node* node : pool.m_Nodes)
+			{
+				delete node;
+			}
+		}
+		m_RecyclePools.clear();
+
 		for (Node* node : m_WorldNodes)
 		{
 			node->ForceSetParent(nullptr, true, false);
@@ -32,7 +67,18 @@ namespace Suora
 		LOCAL_UPDATE_LOCK();
 		SuoraAssert(!cls.Inherits(Component::StaticClass()), "A RootNode may not be a Component!");
 
-		Node* node = Cast<Node>(New(cls, false));
+		Node* node = nullptr;
+		auto pool = m_RecyclePools.find(cls);
+		if (pool != m_RecyclePools.end() && !pool->second.m_Nodes.IsEmpty())
+		{
+			node = pool->second.m_Nodes[pool->second.m_Nodes.Last()];
+			pool->second.m_Nodes.RemoveLastItem();
+			node->RestoreFromClonePlan(*pool->second.m_Defaults);
+		}
+		else
+		{
+			node = Cast<Node>(New(cls, false));
+		}
 		SuoraVerify(node);
 
 		node->m_IsActorLayer = true;
@@ -76,6 +122,24 @@ namespace Suora
 		return m_GameInstance;
 	}
 
+	void World::SetNetworkContext(const Ref<NetworkContext>& context)
+	{
+		if (m_NetworkContext)
+		{
+			m_NetworkContext->Stop();
+			m_NetworkContext->m_World = nullptr;
+		}
+		m_NetworkContext = context;
+		if (m_NetworkContext)
+		{
+			m_NetworkContext->m_World = this;
+		}
+	}
+	NetworkContext* World::GetNetworkContext() const
+	{
+		return m_NetworkContext.get();
+	}
+
 	void World::SetPawn(Node* pawn)
 	{
 		m_Pawn = pawn;
@@ -99,13 +163,106 @@ namespace Suora
 		return m_WorldNodes;
 	}
 
+	static bool AreIndicesValid(const Array<Node*>& nodes, int32_t Node::* index, bool allowEmptySlots)
+	{
+		for (int32_t i = 0; i < nodes.Size(); i++)
+		{
+			if (!nodes[i])
+			{
+				if (!allowEmptySlots) return false;
+				continue;
+			}
+			if (nodes[i]->*index != i) return false;
+		}
+		return true;
+	}
+	bool World::ValidateNodeIndices() const
+	{
+		// Slots of m_WorldUpdateNodes are cleared during WorldUpdate() and compacted by the next one
+		if (!AreIndicesValid(m_WorldNodes, &Node::m_WorldNodeIndex, false)
+			|| !AreIndicesValid(m_WorldUpdateNodes, &Node::m_WorldUpdateIndex, true)
+			|| !AreIndicesValid(m_LocalUpdateNodes, &Node::m_LocalUpdateIndex, false))
+		{
+			return false;
+		}
+		for (Node* node : m_WorldNodes)
+		{
+			if (node->m_World != this) return false;
+			if (node->m_WorldUpdateIndex != -1 && (node->m_WorldUpdateIndex >= m_WorldUpdateNodes.Size() || m_WorldUpdateNodes[node->m_WorldUpdateIndex] != node)) return false;
+			if (node->m_LocalUpdateIndex != -1 && (node->m_LocalUpdateIndex >= m_LocalUpdateNodes.Size() || m_LocalUpdateNodes[node->m_LocalUpdateIndex] != node)) return false;
+		}
+		return true;
+	}
+
+	uint64_t World::SubscribeToHierarchyChanges()
+	{
+		if (m_HierarchySubscribers++ == 0)
+		{
+			// Nothing was recorded since the last subscriber left
+			m_HierarchyRevision++;
+			m_HierarchyChangesBase = m_HierarchyRevision;
+		}
+		return m_HierarchyRevision;
+	}
+	void World::UnsubscribeFromHierarchyChanges()
+	{
+		SuoraVerify(m_HierarchySubscribers > 0);
+		if (m_HierarchySubscribers > 0 && --m_HierarchySubscribers == 0)
+		{
+			m_HierarchyChanges.clear();
+			m_HierarchyChanges.shrink_to_fit();
+			m_HierarchyChangesBase = m_HierarchyRevision;
+		}
+	}
+
+	bool World::GetHierarchyChanges(uint64_t& revision, Array<WorldHierarchyChange>& outChanges) const
+	{
+		// A revision from the future belongs to another World
+		if (m_HierarchySubscribers == 0 || revision < m_HierarchyChangesBase || revision > m_HierarchyRevision)
+		{
+			revision = m_HierarchyRevision;
+			return false;
+		}
+		for (size_t i = revision - m_HierarchyChangesBase; i < m_HierarchyChanges.size(); i++)
+		{
+			outChanges.Add(m_HierarchyChanges[i]);
+		}
+		revision = m_HierarchyRevision;
+		return true;
+	}
+
 	bool World::Raycast(const Vec3& start, const Vec3& end, HitResult& result, const RaycastParams& params)
 	{
 		return GetPhysicsWorld()->Raycast(start, end, result, params);
 	}
+	bool World::RaycastAll(const Vec3& start, const Vec3& end, Array<HitResult>& results, const RaycastParams& params)
+	{
+		return GetPhysicsWorld()->RaycastAll(start, end, results, params);
+	}
+	bool World::ShapeCast(const ShapeCastQuery& query, HitResult& result, const RaycastParams& params)
+	{
+		return GetPhysicsWorld()->ShapeCast(query, result, params);
+	}
+	bool World::Overlap(const OverlapQuery& query, Array<ShapeNode*>& results, const RaycastParams& params)
+	{
+		return GetPhysicsWorld()->Overlap(query, results, params);
+	}
+	void World::RaycastBatch(const Array<RaycastQuery>& queries, Array<HitResult>& results, const RaycastParams& params)
+	{
+		GetPhysicsWorld()->RaycastBatch(queries, results, params);
+	}
+	void World::ShapeCastBatch(const Array<ShapeCastQuery>& queries, Array<HitResult>& results, const RaycastParams& params)
+	{
+		GetPhysicsWorld()->ShapeCastBatch(queries, results, params);
+	}
+	void World::OverlapBatch(const Array<OverlapQuery>& queries, Array<Array<ShapeNode*>>& results, const RaycastParams& params)
+	{
+		GetPhysicsWorld()->OverlapBatch(queries, results, params);
+	}
 
 	void World::Update(float deltaTime)
 	{
+		SUORA_PROFILE_SCOPE("World::Update");
 		m_DeltaTime = deltaTime;
 
 		ResolveAllBeginPlayIssues();
@@ -124,22 +281,28 @@ namespace Suora
 
 		m_WorldUpdateThread.join();
 		m_PrepareLocalUpdateThread.join();*/
+		m_TimerManager.Advance(deltaTime);
 		WorldUpdate(deltaTime);
 		PrepareLocalUpdate();
 
 		// LocalUpdate
 		UpdateRules::s_LocalUpdate = true;
-		for (LocalUpdateChunk& chunk : m_LocalUpdateChunks)
+		SUORA_PROFILE_COUNTER_SET("LocalUpdate Chunks", m_LocalUpdateChunks.Size());
+		TaskScheduler::ParallelFor((uint32_t)m_LocalUpdateChunks.Size(), [this, deltaTime](uint32_t begin, uint32_t end)
 		{
-			chunk.m_Thread = std::thread(&World::LocalUpdate, this, deltaTime, &chunk);
-		}
-		for (LocalUpdateChunk& chunk : m_LocalUpdateChunks)
-		{
-			chunk.m_Thread.join();
-		}
+			for (uint32_t i = begin; i < end; i++)
+			{
+				LocalUpdate(deltaTime, &m_LocalUpdateChunks[i]);
+			}
+		});
 		UpdateRules::s_LocalUpdate = false;
 
 		ResolvePendingKills();
+
+		if (m_NetworkContext)
+		{
+			m_NetworkContext->Update(deltaTime);
+		}
 	}
 
 	Array<Node*> World::FindNodesByClass(const Class& cls)
@@ -155,16 +318,112 @@ namespace Suora
 		return nodes;
 	}
 
+	void World::EnableRecycling(const Class& cls, uint32_t maxPooledNodes)
+	{
+		SuoraAssert(cls.Inherits(Node::StaticClass()) && !cls.Inherits(Component::StaticClass()), "Only Actor Classes can be recycled!");
+		if (cls.IsScriptClass())
+		{
+			SUORA_WARN(LogCategory::Gameplay, "Script class {0} cannot be reset on respawn and is not recycled.", cls.GetClassName());
+			return;
+		}
+		NodeRecyclePool& pool = m_RecyclePools[cls];
+		if (!pool.m_Defaults)
+		{
+			pool.m_Defaults = Node::CreateClonePlan(cls.GetClassDefaultObject()->As<Node>());
+		}
+		pool.m_Capacity = maxPooledNodes;
+
+		while ((uint32_t)pool.m_Nodes.Size() > pool.m_Capacity)
+		{
+			delete pool.m_Nodes[pool.m_Nodes.Last()];
+			pool.m_Nodes.RemoveLastItem();
+		}
+	}
+	void World::DisableRecycling(const Class& cls)
+	{
+		auto pool = m_RecyclePools.find(cls);
+		if (pool == m_RecyclePools.end()) return;
+
+		for (Node* node : pool->second.m_Nodes)
+		{
+			delete node;
+		}
+		m_RecyclePools.erase(pool);
+	}
+	uint32_t World::GetRecycledNodeCount(const Class& cls) const
+	{
+		auto pool = m_RecyclePools.find(cls);
+		return pool != m_RecyclePools.end() ? pool->second.m_Nodes.Size() : 0;
+	}
+
+	void World::RegisterNode(Node* node)
+	{
+		AddIndexedNode(m_WorldNodes, node, &Node::m_WorldNodeIndex);
+		NotifyHierarchyChange(WorldHierarchyEvent::Added, node);
+	}
 	void World::UnregisterNode(Node* node)
 	{
-		if (m_WorldNodes.Contains(node)) m_WorldNodes.Remove(node);
-		if (node->IsUpdateFlagSet(UpdateFlag::WorldUpdate) && m_WorldUpdateNodes.Contains(node)) m_WorldUpdateNodes[m_WorldUpdateNodes.IndexOf(node)] = nullptr;
-		if (node->IsUpdateFlagSet(UpdateFlag::LocalUpdate) && m_LocalUpdateNodes.Contains(node)) m_LocalUpdateNodes.Remove(node);
+		RemoveIndexedNode(m_WorldNodes, node, &Node::m_WorldNodeIndex);
+		RemoveIndexedNode(m_LocalUpdateNodes, node, &Node::m_LocalUpdateIndex);
+
+		// WorldUpdate() might currently iterate the list, the slot is cleared there
+		if (node->m_WorldUpdateIndex != -1)
+		{
+			m_WorldUpdateNodes[node->m_WorldUpdateIndex] = nullptr;
+			node->m_WorldUpdateIndex = -1;
+		}
+		NotifyHierarchyChange(WorldHierarchyEvent::Removed, node);
+	}
+	void World::RecordHierarchyChange(WorldHierarchyEvent event, Node* node)
+	{
+		// Views that fall behind by more than this rebuild from scratch, dropping the older half keeps appending amortized constant
+		static constexpr size_t MaxHierarchyChanges = 16384;
+		if (m_HierarchyChanges.size() >= MaxHierarchyChanges)
+		{
+			m_HierarchyChanges.erase(m_HierarchyChanges.begin(), m_HierarchyChanges.begin() + MaxHierarchyChanges / 2);
+			m_HierarchyChangesBase += MaxHierarchyChanges / 2;
+		}
+		m_HierarchyChanges.push_back(WorldHierarchyChange{ event, node });
+		m_HierarchyRevision++;
 	}
 	void World::ReregisterNode(Node* node)
 	{
-		if (node->IsUpdateFlagSet(UpdateFlag::WorldUpdate) && !m_WorldUpdateNodes.Contains(node)) m_WorldUpdateNodes.Add(node);
-		if (node->IsUpdateFlagSet(UpdateFlag::LocalUpdate) && !m_LocalUpdateNodes.Contains(node)) m_LocalUpdateNodes.Add(node);
+		if (node->IsUpdateFlagSet(UpdateFlag::WorldUpdate)) AddIndexedNode(m_WorldUpdateNodes, node, &Node::m_WorldUpdateIndex);
+		if (node->IsUpdateFlagSet(UpdateFlag::LocalUpdate)) AddIndexedNode(m_LocalUpdateNodes, node, &Node::m_LocalUpdateIndex);
+	}
+
+	void World::MarkHierarchyForRecycling(Node* node)
+	{
+		node->m_IsBeingRecycled = true;
+		for (Node* child : node->m_Children)
+		{
+			MarkHierarchyForRecycling(child);
+		}
+	}
+
+	void World::RecycleNode(Node* node)
+	{
+		node->OnRecycle();
+		UnregisterNode(node);
+
+		node->m_IsBeingRecycled = false;
+		node->m_IsPendingKill = false;
+		node->m_WasBeginCalled = false;
+		node->m_Initialized = false;
+		node->m_World = nullptr;
+		if (CameraNode* camera = node->As<CameraNode>(); camera && m_MainCamera.Get() == camera) m_MainCamera = nullptr;
+		if (m_Pawn.Get() == node) m_Pawn = nullptr;
+
+		// Every Node of the Hierarchy passes through here, so no Ptr survives into the pool
+		InternalPtr::Nullify(node);
+
+		if (node->GetParent())
+		{
+			return;
+		}
+
+		// Only the Actor itself is pooled, its Children travel along
+		m_RecyclePools[node->GetClass()].m_Nodes.Add(node);
 	}
 
 	void World::ResolveAllBeginPlayIssues()
@@ -188,17 +447,46 @@ namespace Suora
 
 	void World::ResolvePendingKills()
 	{
+		if (m_PendingKills.IsEmpty()) return;
+
+		// Destroyed Actors of recycled Classes are kept as a whole Hierarchy, as long as their pool has space left
+		for (Node* node : m_PendingKills)
+		{
+			if (node->GetParent() || node->m_IsBeingRecycled) continue;
+
+			auto pool = m_RecyclePools.find(node->GetClass());
+			if (pool != m_RecyclePools.end() && (uint32_t)pool->second.m_Nodes.Size() + pool->second.m_PendingNodes < pool->second.m_Capacity)
+			{
+				MarkHierarchyForRecycling(node);
+				pool->second.m_PendingNodes++;
+			}
+		}
+		for (auto& [cls, pool] : m_RecyclePools)
+		{
+			pool.m_PendingNodes = 0;
+		}
+
 		// Kill all Nodes in m_PendingKills
 		for (Node* node : m_PendingKills)
 		{
 			node->UnInitializeNode(*this);
-			delete node;
+			if (node->m_IsBeingRecycled)
+			{
+				RecycleNode(node);
+			}
+			else
+			{
+				delete node;
+			}
 		}
 		m_PendingKills.Clear();
 	}
 
 	void World::WorldUpdate(float deltaTime)
 	{
+		SUORA_PROFILE_SCOPE("World::WorldUpdate");
+		uint32_t updatedNodes = 0;
+
 		for (int64_t i = m_WorldUpdateNodes.Last(); i >= 0; i--)
 		{
 			if (m_WorldUpdateNodes[i])
@@ -206,25 +494,36 @@ namespace Suora
 				if (m_WorldUpdateNodes[i]->ShouldUpdateInCurrentContext())
 				{
 					m_WorldUpdateNodes[i]->WorldUpdate(deltaTime);
+					updatedNodes++;
 				}
 			}
 			else
 			{
-				m_WorldUpdateNodes.RemoveAt(i);
+				// The last entry was already updated in this loop
+				m_WorldUpdateNodes[i] = m_WorldUpdateNodes[m_WorldUpdateNodes.Last()];
+				if (m_WorldUpdateNodes[i]) m_WorldUpdateNodes[i]->m_WorldUpdateIndex = i;
+				m_WorldUpdateNodes.RemoveLastItem();
 			}
 		}
+
+		SUORA_PROFILE_COUNTER_ADD("Nodes Updated", updatedNodes);
 	}
 	void World::LocalUpdate(float deltaTime, LocalUpdateChunk* chunk)
 	{
 		SUORA_ASSERT(chunk, "LocalUpdateChunk is invalid!");
+		SUORA_PROFILE_SCOPE("World::LocalUpdate");
+		uint32_t updatedNodes = 0;
 
 		for (Node* node : chunk->m_Nodes)
 		{
 			if (node->ShouldUpdateInCurrentContext())
 			{
 				node->LocalUpdate(deltaTime);
+				updatedNodes++;
 			}
 		}
+
+		SUORA_PROFILE_COUNTER_ADD("Nodes Updated", updatedNodes);
 	}
 	void World::PrepareLocalUpdate()
 	{
@@ -4,6 +4,7 @@
 #include "Suora/Assets/Blueprint.h"
 #include "Suora/Core/Update.h"
 #include "Node.h"
+#include "TimerManager.h"
 #include "World.generated.h"
 
 namespace Suora::Physics
@@ -19,25 +20,96 @@ namespace Suora
 	class Level;
 	class GameInstance;
 	class RenderableNode3D;
+	class NetworkContext;
 	
 	struct HitResult
 	{
-		Vec3 Normal;
-		Vec3 Point;
-		class CollisionNode* Collider = nullptr;
-		class PhysicsNode* PhysicsBody = nullptr;
+		Vec3 Normal = Vec3(0.0f);
+		Vec3 Point = Vec3(0.0f);
+		float Distance = 0.0f;
+		class ShapeNode* Shape = nullptr;
+		/** Identifies the hit part of compound shapes */
+		uint32_t SubShapeID = 0;
+		/** Results of batched queries are always written, this tells whether the query hit anything */
+		bool Hit = false;
 	};
 	struct RaycastParams
 	{
 		Array<class ShapeNode*> IgnoredCollisionNodes;
+		/** Bit i enables collisions with physics layer i */
+		uint32_t LayerMask = ~0u;
+		/** If set, the query additionally only hits layers that collide with this layer in the CollisionMatrix */
+		int32_t CollisionLayer = -1;
+		bool IgnoreTriggers = false;
 	};
 
+	/** Shape of a ShapeCast or Overlap query, the query places it in the World */
+	struct QueryShape
+	{
+		enum class Kind : uint8_t { Sphere = 0, Box, Capsule };
+
+		Kind Type = Kind::Sphere;
+		/** Sphere and Capsule */
+		float Radius = 0.5f;
+		/** Total height of a Capsule, like CapsuleShapeNode */
+		float Height = 2.0f;
+		Vec3 HalfExtends = Vec3(0.5f);
+
+		static QueryShape Sphere(float radius) { QueryShape shape; shape.Type = Kind::Sphere; shape.Radius = radius; return shape; }
+		static QueryShape Box(const Vec3& halfExtends) { QueryShape shape; shape.Type = Kind::Box; shape.HalfExtends = halfExtends; return shape; }
+		static QueryShape Capsule(float radius, float height) { QueryShape shape; shape.Type = Kind::Capsule; shape.Radius = radius; shape.Height = height; return shape; }
+	};
+	struct RaycastQuery
+	{
+		Vec3 Start = Vec3(0.0f);
+		Vec3 End = Vec3(0.0f);
+	};
+	struct ShapeCastQuery
+	{
+		QueryShape Shape;
+		Vec3 Start = Vec3(0.0f);
+		Vec3 End = Vec3(0.0f);
+		Quat Rotation = Quat(1.0f, 0.0f, 0.0f, 0.0f);
+	};
+	struct OverlapQuery
+	{
+		QueryShape Shape;
+		Vec3 Position = Vec3(0.0f);
+		Quat Rotation = Quat(1.0f, 0.0f, 0.0f, 0.0f);
+	};
+
+	/** Updated in parallel with the other chunks, on the workers of the TaskScheduler */
 	struct LocalUpdateChunk
 	{
-		std::thread m_Thread;
 		Array<Node*> m_Nodes;
 	};
 
+	/** Destroyed Actors of one Class, that wait to be respawned. See World::EnableRecycling(...) */
+	struct NodeRecyclePool
+	{
+		Array<Node*> m_Nodes;
+		/** Of the class default object, respawned Nodes are reset to it */
+		Ref<NodeClonePlan> m_Defaults;
+		uint32_t m_Capacity = 0;
+		/** Nodes, that will be added at the end of the current ResolvePendingKills() */
+		uint32_t m_PendingNodes = 0;
+	};
+
+	enum class WorldHierarchyEvent : uint8_t
+	{
+		Added = 0,
+		Removed,
+		Reparented,
+		Renamed
+	};
+
+	struct WorldHierarchyChange
+	{
+		WorldHierarchyEvent Event = WorldHierarchyEvent::Added;
+		/** Must not be dereferenced, if the latest change of the Node is its removal */
+		Node* ChangedNode = nullptr;
+	};
+
 	/** Container for all Nodes during Gameplay */
 	class World : public Object
 	{
@@ -58,6 +130,8 @@ namespace Suora
 		Ptr<CameraNode> m_MainCamera;
 		Level* m_SourceLevel = nullptr;
 		Ref<Physics::PhysicsWorld> m_PhysicsWorld;
+		TimerManager m_TimerManager;
+		Ref<NetworkContext> m_NetworkContext;
 
 		/* Rendering */
 		Array<RenderableNode3D*> m_DeferredRenderables;
@@ -74,6 +148,10 @@ namespace Suora
 		Level* GetSourceLevel() const;
 		Physics::PhysicsWorld* GetPhysicsWorld();
 		GameInstance* GetGameInstance() const;
+		TimerManager& GetTimerManager() { return m_TimerManager; }
+		/** The NetworkContext replicates this World as server, or mirrors the server as client */
+		void SetNetworkContext(const Ref<NetworkContext>& context);
+		NetworkContext* GetNetworkContext() const;
 
 		Node* Spawn(const Class& cls);
 		Node* Spawn(const Class& cls, const Vec3& position, const Quat& rotation);
@@ -84,7 +162,25 @@ namespace Suora
 			return dynamic_cast<T*>(Spawn(T::StaticClass()));
 		}
 
+		/** Opt-in: Destroyed root Nodes of this exact Class keep their Hierarchy and are reused by Spawn(...),
+		*   instead of being deleted and instantiated again. Up to maxPooledNodes Nodes are kept.
+		*   Recycled Nodes receive OnRecycle() and are unreachable through Ptrs, until they are respawned.
+		*   On respawn, the reflected properties, transforms and enabled states of the Nodes of the Class are reset to
+		*   its class default object. Anything else, e.g. members that are not reflected or Children added at runtime,
+		*   has to be reset by OnRecycle(). Script classes (e.g. C#) cannot be reset in place and are not recycled.  */
+		void EnableRecycling(const Class& cls, uint32_t maxPooledNodes = 64);
+		/** Deletes all pooled Nodes of the Class */
+		void DisableRecycling(const Class& cls);
+		uint32_t GetRecycledNodeCount(const Class& cls) const;
+
 		bool Raycast(const Vec3& start, const Vec3& end, HitResult& result, const RaycastParams& params = RaycastParams());
+		bool RaycastAll(const Vec3& start, const Vec3& end, Array<HitResult>& results, const RaycastParams& params = RaycastParams());
+		bool ShapeCast(const ShapeCastQuery& query, HitResult& result, const RaycastParams& params = RaycastParams());
+		bool Overlap(const OverlapQuery& query, Array<ShapeNode*>& results, const RaycastParams& params = RaycastParams());
+		/** Resolves all queries at once, in parallel if the PhysicsWorld supports it. results[i] belongs to queries[i]. */
+		void RaycastBatch(const Array<RaycastQuery>& queries, Array<HitResult>& results, const RaycastParams& params = RaycastParams());
+		void ShapeCastBatch(const Array<ShapeCastQuery>& queries, Array<HitResult>& results, const RaycastParams& params = RaycastParams());
+		void OverlapBatch(const Array<OverlapQuery>& queries, Array<Array<ShapeNode*>>& results, const RaycastParams& params = RaycastParams());
 
 		void SetPawn(Node* pawn);
 		Node* GetPlayerPawn() const;
@@ -92,6 +188,20 @@ namespace Suora
 		CameraNode* GetMainCamera() const;
 
 		Array<Node*> GetAllNodes() const;
+		/** Checks that every Node knows its slot in the Node lists of the World, for tests and debugging */
+		bool ValidateNodeIndices() const;
+
+		/** Opt-in journal of added, removed, reparented and renamed Nodes, for editor views that mirror the hierarchy.
+		*   Changes are only recorded while at least one view is subscribed. Subscribing after a pause restarts the
+		*   journal, so every older revision has to be rebuilt from. Returns the revision to start from.         */
+		uint64_t SubscribeToHierarchyChanges();
+		void UnsubscribeFromHierarchyChanges();
+		bool IsHierarchyJournaled() const { return m_HierarchySubscribers > 0; }
+		/** Appends all changes after 'revision' and advances it to the current revision. Returns false, if the
+		*   changes are no longer kept or nobody is subscribed; the caller has to rebuild its view from
+		*   GetAllNodes() in that case.                                                                          */
+		bool GetHierarchyChanges(uint64_t& revision, Array<WorldHierarchyChange>& outChanges) const;
+		uint64_t GetHierarchyRevision() const { return m_HierarchyRevision; }
 
 		Array<Node*> FindNodesByClass(const Class& cls);
 		template<class T>
@@ -109,8 +219,25 @@ namespace Suora
 		}
 
 	private:
+		void RegisterNode(Node* node);
 		void UnregisterNode(Node* node);
 		void ReregisterNode(Node* node);
+		void RecycleNode(Node* node);
+		void MarkHierarchyForRecycling(Node* node);
+		void NotifyHierarchyChange(WorldHierarchyEvent event, Node* node)
+		{
+			// Runtime Worlds have no editor views, and pay for a single compare
+			if (m_HierarchySubscribers > 0) RecordHierarchyChange(event, node);
+		}
+		void RecordHierarchyChange(WorldHierarchyEvent event, Node* node);
+
+		std::vector<WorldHierarchyChange> m_HierarchyChanges;
+		/** Revision of m_HierarchyChanges[0] */
+		uint64_t m_HierarchyChangesBase = 0;
+		uint64_t m_HierarchyRevision = 0;
+		uint32_t m_HierarchySubscribers = 0;
+
+		std::unordered_map<Class, NodeRecyclePool> m_RecyclePools;
 
 		Array<Node*> m_WorldUpdateNodes;
 		Array<Node*> m_LocalUpdateNodes;
@@ -139,5 +266,7 @@ namespace Suora
 		friend class RenderableNode3D;
 		friend class DirectionalLightNode;
 		friend class PointLightNode;
+		friend class NetworkContext;
+		friend class LevelStreamer;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,209 @@
+#include "Precompiled.h"
+#include "BitStream.h"
+#include <cmath>
+
+namespace Suora
+{
+
+	void BitWriter::WriteBits(uint32_t value, uint32_t bits)
+	{
+		for (uint32_t i = 0; i < bits;)
+		{
+			const uint32_t byte = m_BitCount / 8;
+			const uint32_t offset = m_BitCount % 8;
+			if (byte >= m_Data.size()) m_Data.push_back(0);
+
+			const uint32_t count = std::min(8 - offset, bits - i);
+			const uint32_t chunk = (value >> i) & ((1u << count) - 1);
+			m_Data[byte] |= (uint8_t)(chunk << offset);
+			m_BitCount += count;
+			i += count;
+		}
+	}
+
+	void BitWriter::WriteBool(bool value)
+	{
+		WriteBits(value ? 1 : 0, 1);
+	}
+
+	void BitWriter::WriteVarUInt(uint64_t value)
+	{
+		do
+		{
+			const uint32_t group = (uint32_t)(value & 0x7F);
+			value >>= 7;
+			WriteBits(group | (value ? 0x80 : 0), 8);
+		} while (value);
+	}
+
+	void BitWriter::WriteString(const String& str)
+	{
+		WriteVarUInt(str.size());
+		for (char c : str)
+		{
+			WriteBits((uint8_t)c, 8);
+		}
+	}
+
+	void BitWriter::Append(const BitWriter& other)
+	{
+		uint32_t remaining = other.m_BitCount;
+		for (size_t i = 0; remaining > 0; i++)
+		{
+			const uint32_t bits = std::min<uint32_t>(8, remaining);
+			WriteBits(other.m_Data[i], bits);
+			remaining -= bits;
+		}
+	}
+
+	void BitWriter::Clear()
+	{
+		m_Data.clear();
+		m_BitCount = 0;
+	}
+
+	BitReader::BitReader(const uint8_t* data, size_t size)
+		: m_Data(data), m_BitSize((uint32_t)size * 8)
+	{
+	}
+
+	uint32_t BitReader::ReadBits(uint32_t bits)
+	{
+		if (bits > GetRemainingBits())
+		{
+			m_Overflown = true;
+			m_BitPosition = m_BitSize;
+			return 0;
+		}
+
+		uint32_t value = 0;
+		for (uint32_t i = 0; i < bits;)
+		{
+			const uint32_t byte = m_BitPosition / 8;
+			const uint32_t offset = m_BitPosition % 8;
+			const uint32_t count = std::min(8 - offset, bits - i);
+			const uint32_t chunk = (m_Data[byte] >> offset) & ((1u << count) - 1);
+			value |= chunk << i;
+			m_BitPosition += count;
+			i += count;
+		}
+		return value;
+	}
+
+	bool BitReader::ReadBool()
+	{
+		return ReadBits(1) != 0;
+	}
+
+	uint64_t BitReader::ReadVarUInt()
+	{
+		uint64_t value = 0;
+		for (uint32_t shift = 0; shift < 64 && !m_Overflown; shift += 7)
+		{
+			const uint32_t group = ReadBits(8);
+			value |= (uint64_t)(group & 0x7F) << shift;
+			if (!(group & 0x80)) break;
+		}
+		return value;
+	}
+
+	String BitReader::ReadString()
+	{
+		const uint64_t size = ReadVarUInt();
+		if (size * 8 > GetRemainingBits())
+		{
+			m_Overflown = true;
+			return String();
+		}
+		String str;
+		str.resize((size_t)size);
+		for (char& c : str)
+		{
+			c = (char)ReadBits(8);
+		}
+		return str;
+	}
+
+	namespace Quantization
+	{
+		static constexpr float s_FixedScale = 1024.0f;
+		static constexpr float s_QuatRange = 0.70710678f;
+		static constexpr uint32_t s_QuatMax = (1 << 10) - 1;
+
+		uint32_t PackFixed(float value)
+		{
+			const double scaled = std::round((double)value * s_FixedScale);
+			return (uint32_t)(int32_t)std::clamp(scaled, (double)INT32_MIN, (double)INT32_MAX);
+		}
+		float UnpackFixed(uint32_t value)
+		{
+			return (float)((int32_t)value / (double)s_FixedScale);
+		}
+
+		uint32_t PackQuat(const Quat& quat)
+		{
+			const Quat q = glm::normalize(quat);
+			uint32_t largest = 0;
+			for (uint32_t i = 1; i < 4; i++)
+			{
+				if (std::abs(q[i]) > std::abs(q[largest])) largest = i;
+			}
+			// q and -q are the same rotation, so the largest component can always be positive
+			const float sign = q[largest] < 0.0f ? -1.0f : 1.0f;
+
+			uint32_t packed = largest << 30;
+			uint32_t shift = 20;
+			for (uint32_t i = 0; i < 4; i++)
+			{
+				if (i == largest) continue;
+				const float normalized = (q[i] * sign / s_QuatRange) * 0.5f + 0.5f;
+				packed |= (uint32_t)std::round(std::clamp(normalized, 0.0f, 1.0f) * s_QuatMax) << shift;
+				shift -= 10;
+			}
+			return packed;
+		}
+		Quat UnpackQuat(uint32_t value)
+		{
+			const uint32_t largest = value >> 30;
+			Quat q;
+			float sum = 0.0f;
+			uint32_t shift = 20;
+			for (uint32_t i = 0; i < 4; i++)
+			{
+				if (i == largest) continue;
+				q[i] = (((value >> shift) & s_QuatMax) / (float)s_QuatMax - 0.5f) * 2.0f * s_QuatRange;
+				sum += q[i] * q[i];
+				shift -= 10;
+			}
+			q[largest] = std::sqrt(std::max(0.0f, 1.0f - sum));
+			return glm::normalize(q);
+		}
+
+		void WriteDelta(BitWriter& writer, uint32_t value, uint32_t baseline)
+		{
+			const int32_t delta = (int32_t)(value - baseline);
+			const uint32_t zigzag = ((uint32_t)delta << 1) ^ (uint32_t)(delta >> 31);
+			if (zigzag == 0)
+			{
+				writer.WriteBool(false);
+				return;
+			}
+			writer.WriteBool(true);
+
+			uint32_t bits = 32;
+			while (!(zigzag & (1u << (bits - 1)))) bits--;
+			writer.WriteBits(bits - 1, 5);
+			writer.WriteBits(zigzag, bits);
+		}
+		uint32_t ReadDelta(BitReader& reader, uint32_t baseline)
+		{
+			if (!reader.ReadBool()) return baseline;
+
+			const uint32_t bits = reader.ReadBits(5) + 1;
+			const uint32_t zigzag = reader.ReadBits(bits);
+			const int32_t delta = (int32_t)(zigzag >> 1) ^ -(int32_t)(zigzag & 1);
+			return baseline + (uint32_t)delta;
+		}
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,68 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "Suora/Common/StringUtils.h"
+#include "Suora/Common/VectorUtils.h"
+
+namespace Suora
+{
+
+	/** Writes values with an arbitrary number of bits, least significant bit first */
+	class BitWriter
+	{
+	public:
+		void WriteBits(uint32_t value, uint32_t bits);
+		void WriteBool(bool value);
+		/** 7 bits per byte, small values take one byte */
+		void WriteVarUInt(uint64_t value);
+		void WriteString(const String& str);
+		/** Appends all bits of another writer */
+		void Append(const BitWriter& other);
+
+		uint32_t GetBitCount() const { return m_BitCount; }
+		uint32_t GetByteCount() const { return (m_BitCount + 7) / 8; }
+		const std::vector<uint8_t>& GetData() const { return m_Data; }
+		void Clear();
+
+	private:
+		std::vector<uint8_t> m_Data;
+		uint32_t m_BitCount = 0;
+	};
+
+	/** Counterpart of the BitWriter. Reading past the end returns zeros and marks the reader as overflown. */
+	class BitReader
+	{
+	public:
+		BitReader(const uint8_t* data, size_t size);
+
+		uint32_t ReadBits(uint32_t bits);
+		bool ReadBool();
+		uint64_t ReadVarUInt();
+		String ReadString();
+
+		bool IsOverflown() const { return m_Overflown; }
+		uint32_t GetRemainingBits() const { return m_BitSize - m_BitPosition; }
+
+	private:
+		const uint8_t* m_Data = nullptr;
+		uint32_t m_BitSize = 0;
+		uint32_t m_BitPosition = 0;
+		bool m_Overflown = false;
+	};
+
+	namespace Quantization
+	{
+		/** Fixed point with 1/1024 units, covers +-2097km */
+		uint32_t PackFixed(float value);
+		float UnpackFixed(uint32_t value);
+
+		/** Smallest three: 2 bits index of the largest component, 10 bits for each of the others */
+		uint32_t PackQuat(const Quat& quat);
+		Quat UnpackQuat(uint32_t value);
+
+		/** Writes the difference to the baseline as a zigzag encoded integer with a 5 bit length prefix */
+		void WriteDelta(BitWriter& writer, uint32_t value, uint32_t baseline);
+		uint32_t ReadDelta(BitReader& reader, uint32_t baseline);
+	}
+
+}
\ No newline at end of file
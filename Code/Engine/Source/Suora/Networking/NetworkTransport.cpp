@@ -0,0 +1,265 @@
+#include "Precompiled.h"
+#include "NetworkTransport.h"
+#include "Suora/Core/Log.h"
+
+#ifdef SUORA_PLATFORM_WINDOWS
+	// <Windows.h> already pulled in winsock.h
+	#include <winsock.h>
+	#pragma comment(lib, "Ws2_32.lib")
+	using SocketHandle = SOCKET;
+	using SocketLength = int;
+	#define SUORA_CLOSE_SOCKET closesocket
+#else
+	#include <arpa/inet.h>
+	#include <fcntl.h>
+	#include <netinet/in.h>
+	#include <sys/socket.h>
+	#include <unistd.h>
+	using SocketHandle = int;
+	using SocketLength = socklen_t;
+	#define SUORA_CLOSE_SOCKET close
+#endif
+
+namespace Suora
+{
+
+	NetworkAddress NetworkAddress::FromString(const String& str)
+	{
+		NetworkAddress address;
+		address.Host = 0x7F000001;
+
+		const size_t colon = str.find(':');
+		const String host = colon != String::npos ? str.substr(0, colon) : String();
+		const String port = colon != String::npos ? str.substr(colon + 1) : str;
+
+		if (!host.empty() && host != "localhost")
+		{
+			uint32_t parts[4] = { 0, 0, 0, 0 };
+			if (sscanf(host.c_str(), "%u.%u.%u.%u", &parts[0], &parts[1], &parts[2], &parts[3]) != 4)
+			{
+				return NetworkAddress();
+			}
+			address.Host = ((parts[0] & 0xFF) << 24) | ((parts[1] & 0xFF) << 16) | ((parts[2] & 0xFF) << 8) | (parts[3] & 0xFF);
+		}
+		const long value = strtol(port.c_str(), nullptr, 10);
+		address.Port = (value > 0 && value <= UINT16_MAX) ? (uint16_t)value : 0;
+		return address;
+	}
+
+	String NetworkAddress::ToString() const
+	{
+		return std::to_string((Host >> 24) & 0xFF) + "." + std::to_string((Host >> 16) & 0xFF) + "." + std::to_string((Host >> 8) & 0xFF)
+			+ "." + std::to_string(Host & 0xFF) + ":" + std::to_string(Port);
+	}
+
+	/******************************************************************************************************************/
+
+	LoopbackTransport::LoopbackTransport(uint16_t port)
+	{
+		std::lock_guard<std::mutex> lock(s_Mutex);
+		if (port == 0)
+		{
+			do
+			{
+				port = s_NextPort++;
+				if (s_NextPort == 0) s_NextPort = 49152;
+			} while (s_Transports.find(port) != s_Transports.end());
+		}
+		if (s_Transports.find(port) != s_Transports.end())
+		{
+			SUORA_WARN(LogCategory::Networking, "LoopbackTransport: Port {0} is already in use!", port);
+			return;
+		}
+		m_Port = port;
+		s_Transports[port] = this;
+	}
+
+	LoopbackTransport::~LoopbackTransport()
+	{
+		std::lock_guard<std::mutex> lock(s_Mutex);
+		auto it = s_Transports.find(m_Port);
+		if (it != s_Transports.end() && it->second == this)
+		{
+			s_Transports.erase(it);
+		}
+	}
+
+	bool LoopbackTransport::Send(const NetworkAddress& address, const uint8_t* data, size_t size)
+	{
+		if (m_Port == 0 || size > GetMaxPacketSize()) return false;
+
+		m_Stats.SentPackets++;
+		m_Stats.SentBytes += size;
+
+		if (m_PacketLoss > 0.0f)
+		{
+			// xorshift, so the loss pattern does not depend on rand() calls elsewhere
+			m_LossRandom ^= m_LossRandom << 13;
+			m_LossRandom ^= m_LossRandom >> 17;
+			m_LossRandom ^= m_LossRandom << 5;
+			if ((m_LossRandom & 0xFFFF) < (uint32_t)(m_PacketLoss * 0xFFFF)) return true;
+		}
+
+		std::lock_guard<std::mutex> lock(s_Mutex);
+		auto it = s_Transports.find(address.Port);
+		if (it == s_Transports.end()) return true;
+
+		NetworkPacket& packet = it->second->m_Queue.emplace_back();
+		packet.Address = GetLocalAddress();
+		packet.Data.assign(data, data + size);
+		return true;
+	}
+
+	bool LoopbackTransport::Receive(NetworkPacket& packet)
+	{
+		std::lock_guard<std::mutex> lock(s_Mutex);
+		if (m_Queue.empty()) return false;
+
+		packet = std::move(m_Queue.front());
+		m_Queue.pop_front();
+		m_Stats.ReceivedPackets++;
+		m_Stats.ReceivedBytes += packet.Data.size();
+		return true;
+	}
+
+	NetworkAddress LoopbackTransport::GetLocalAddress() const
+	{
+		return NetworkAddress{ 0x7F000001, m_Port };
+	}
+
+	/******************************************************************************************************************/
+
+	static bool InitSockets()
+	{
+#ifdef SUORA_PLATFORM_WINDOWS
+		static const bool s_Initialized = []()
+		{
+			WSADATA data;
+			return WSAStartup(MAKEWORD(2, 2), &data) == 0;
+		}();
+		return s_Initialized;
+#else
+		return true;
+#endif
+	}
+
+	UdpTransport::~UdpTransport()
+	{
+		Close();
+	}
+
+	bool UdpTransport::Open(uint16_t port)
+	{
+		Close();
+		if (!InitSockets())
+		{
+			SUORA_ERROR(LogCategory::Networking, "UdpTransport: Could not initialize sockets!");
+			return false;
+		}
+
+		const SocketHandle handle = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+		if ((int64_t)handle < 0 || (uint64_t)handle == ~0ull)
+		{
+			SUORA_ERROR(LogCategory::Networking, "UdpTransport: Could not create socket!");
+			return false;
+		}
+		m_Socket = (uint64_t)handle;
+
+		sockaddr_in address = {};
+		address.sin_family = AF_INET;
+		address.sin_addr.s_addr = htonl(INADDR_ANY);
+		address.sin_port = htons(port);
+		if (bind(handle, (const sockaddr*)&address, sizeof(address)) != 0)
+		{
+			SUORA_ERROR(LogCategory::Networking, "UdpTransport: Could not bind port {0}!", port);
+			Close();
+			return false;
+		}
+
+#ifdef SUORA_PLATFORM_WINDOWS
+		u_long nonBlocking = 1;
+		const bool success = ioctlsocket(handle, FIONBIO, &nonBlocking) == 0;
+#else
+		const int flags = fcntl(handle, F_GETFL, 0);
+		const bool success = flags != -1 && fcntl(handle, F_SETFL, flags | O_NONBLOCK) != -1;
+#endif
+		if (!success)
+		{
+			SUORA_ERROR(LogCategory::Networking, "UdpTransport: Could not make the socket non-blocking!");
+			Close();
+			return false;
+		}
+
+		SocketLength length = sizeof(address);
+		getsockname(handle, (sockaddr*)&address, &length);
+		m_Port = ntohs(address.sin_port);
+		m_ReceiveBuffer.resize(GetMaxPacketSize());
+		return true;
+	}
+
+	void UdpTransport::Close()
+	{
+		if (IsOpen())
+		{
+			SUORA_CLOSE_SOCKET((SocketHandle)m_Socket);
+		}
+		m_Socket = ~0ull;
+		m_Port = 0;
+	}
+
+	bool UdpTransport::IsOpen() const
+	{
+		return m_Socket != ~0ull;
+	}
+
+	bool UdpTransport::Send(const NetworkAddress& address, const uint8_t* data, size_t size)
+	{
+		if (!IsOpen() || size > GetMaxPacketSize()) return false;
+
+		sockaddr_in target = {};
+		target.sin_family = AF_INET;
+		target.sin_addr.s_addr = htonl(address.Host);
+		target.sin_port = htons(address.Port);
+		const auto sent = sendto((SocketHandle)m_Socket, (const char*)data, (int)size, 0, (const sockaddr*)&target, sizeof(target));
+		if (sent != (decltype(sent))size) return false;
+
+		m_Stats.SentPackets++;
+		m_Stats.SentBytes += size;
+		return true;
+	}
+
+	bool UdpTransport::Receive(NetworkPacket& packet)
+	{
+		if (!IsOpen()) return false;
+
+		while (true)
+		{
+			sockaddr_in from = {};
+			SocketLength length = sizeof(from);
+			const auto received = recvfrom((SocketHandle)m_Socket, (char*)m_ReceiveBuffer.data(), (int)m_ReceiveBuffer.size(), 0, (sockaddr*)&from, &length);
+			if (received < 0)
+			{
+#ifdef SUORA_PLATFORM_WINDOWS
+				// A previous send to a closed port is reported here, skip it
+				if (WSAGetLastError() == WSAECONNRESET) continue;
+#endif
+				// Usually just nothing pending
+				return false;
+			}
+			if (received == 0) continue;
+
+			packet.Address.Host = ntohl(from.sin_addr.s_addr);
+			packet.Address.Port = ntohs(from.sin_port);
+			packet.Data.assign(m_ReceiveBuffer.data(), m_ReceiveBuffer.data() + received);
+			m_Stats.ReceivedPackets++;
+			m_Stats.ReceivedBytes += (uint64_t)received;
+			return true;
+		}
+	}
+
+	NetworkAddress UdpTransport::GetLocalAddress() const
+	{
+		return NetworkAddress{ 0x7F000001, m_Port };
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,109 @@
+#pragma once
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include "Suora/Common/StringUtils.h"
+
+namespace Suora
+{
+
+	struct NetworkAddress
+	{
+		/** IPv4 address in host byte order, 0x7F000001 is localhost */
+		uint32_t Host = 0;
+		uint16_t Port = 0;
+
+		bool IsValid() const { return Port != 0; }
+		bool operator==(const NetworkAddress& other) const { return Host == other.Host && Port == other.Port; }
+		bool operator!=(const NetworkAddress& other) const { return !(*this == other); }
+
+		/** Parses "a.b.c.d:port", "localhost:port" or just "port" */
+		static NetworkAddress FromString(const String& str);
+		String ToString() const;
+	};
+
+	struct NetworkPacket
+	{
+		NetworkAddress Address;
+		std::vector<uint8_t> Data;
+	};
+
+	struct NetworkTransportStats
+	{
+		uint64_t SentPackets = 0;
+		uint64_t SentBytes = 0;
+		uint64_t ReceivedPackets = 0;
+		uint64_t ReceivedBytes = 0;
+	};
+
+	/** Unreliable, unordered datagrams. The NetworkContext takes care of everything else. */
+	class NetworkTransport
+	{
+	public:
+		virtual ~NetworkTransport() = default;
+
+		virtual bool Send(const NetworkAddress& address, const uint8_t* data, size_t size) = 0;
+		/** Non-blocking, returns false if no packet is pending */
+		virtual bool Receive(NetworkPacket& packet) = 0;
+		virtual NetworkAddress GetLocalAddress() const = 0;
+		/** Upper bound for the size of a single datagram */
+		virtual size_t GetMaxPacketSize() const { return 1200; }
+
+		const NetworkTransportStats& GetStats() const { return m_Stats; }
+
+	protected:
+		NetworkTransportStats m_Stats;
+	};
+
+	/** Delivers packets to other LoopbackTransports of the same process, keyed by port.
+	 *  Used for listen servers and to run server and client headless without touching the network. */
+	class LoopbackTransport : public NetworkTransport
+	{
+	public:
+		/** Port 0 picks an unused port */
+		LoopbackTransport(uint16_t port = 0);
+		~LoopbackTransport();
+
+		virtual bool Send(const NetworkAddress& address, const uint8_t* data, size_t size) override;
+		virtual bool Receive(NetworkPacket& packet) override;
+		virtual NetworkAddress GetLocalAddress() const override;
+
+		/** Drops the given fraction of outgoing packets, to exercise the acking */
+		void SetSimulatedPacketLoss(float loss) { m_PacketLoss = loss; }
+
+	private:
+		uint16_t m_Port = 0;
+		float m_PacketLoss = 0.0f;
+		uint32_t m_LossRandom = 0x9E3779B9;
+		std::deque<NetworkPacket> m_Queue;
+
+		inline static std::mutex s_Mutex;
+		inline static std::unordered_map<uint16_t, LoopbackTransport*> s_Transports;
+		inline static uint16_t s_NextPort = 49152;
+	};
+
+	/** Non-blocking IPv4 UDP socket */
+	class UdpTransport : public NetworkTransport
+	{
+	public:
+		UdpTransport() = default;
+		~UdpTransport();
+
+		/** Binds to the port on all interfaces, port 0 lets the system pick one */
+		bool Open(uint16_t port);
+		void Close();
+		bool IsOpen() const;
+
+		virtual bool Send(const NetworkAddress& address, const uint8_t* data, size_t size) override;
+		virtual bool Receive(NetworkPacket& packet) override;
+		virtual NetworkAddress GetLocalAddress() const override;
+
+	private:
+		uint64_t m_Socket = ~0ull;
+		uint16_t m_Port = 0;
+		std::vector<uint8_t> m_ReceiveBuffer;
+	};
+
+}
\ No newline at end of file
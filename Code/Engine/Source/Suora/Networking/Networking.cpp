@@ -1,7 +1,663 @@
 #include "Precompiled.h"
 #include "Networking.h"
+#include <algorithm>
+#include <cfloat>
+#include "BitStream.h"
+#include "Replication.h"
+#include "Suora/Core/Log.h"
+#include "Suora/GameFramework/Node.h"
+#include "Suora/GameFramework/World.h"
+#include "Suora/GameFramework/Nodes/CameraNode.h"
 
 namespace Suora
 {
+	static constexpr uint32_t s_ProtocolID = 0x5355;
+	/** Snapshots are skipped, until the bandwidth budget of a client allows at least this much */
+	static constexpr size_t s_MinSnapshotBytes = 32;
+
+	NetworkContext::NetworkContext()
+	{
+	}
+
+	NetworkContext::~NetworkContext()
+	{
+		Stop();
+	}
+
+	bool NetworkContext::StartServer(const Ref<NetworkTransport>& transport)
+	{
+		Stop();
+		if (!transport)
+		{
+			SUORA_ERROR(LogCategory::Networking, "Cannot start a server without a transport!");
+			return false;
+		}
+		m_Mode = NetworkMode::Server;
+		m_Transport = transport;
+		m_SnapshotTimer = 0.0f;
+		SUORA_INFO(LogCategory::Networking, "Server started on {0}", m_Transport->GetLocalAddress().ToString());
+		return true;
+	}
+
+	bool NetworkContext::StartClient(const Ref<NetworkTransport>& transport, const NetworkAddress& server)
+	{
+		Stop();
+		if (!transport || !server.IsValid())
+		{
+			SUORA_ERROR(LogCategory::Networking, "Cannot start a client without a transport and server address!");
+			return false;
+		}
+		m_Mode = NetworkMode::Client;
+		m_Transport = transport;
+		m_ServerAddress = server;
+		m_ConnectTimer = 0.0f;
+		m_TimeSinceReceive = 0.0f;
+		SUORA_INFO(LogCategory::Networking, "Connecting to {0}", server.ToString());
+		return true;
+	}
+
+	void NetworkContext::Stop()
+	{
+		if (m_Mode == NetworkMode::Server)
+		{
+			for (const std::unique_ptr<ClientConnection>& client : m_Clients)
+			{
+				SendPacket(client->Address, PacketType::Disconnect);
+			}
+		}
+		else if (m_Mode == NetworkMode::Client)
+		{
+			SendPacket(m_ServerAddress, PacketType::Disconnect);
+		}
+
+		m_Mode = NetworkMode::None;
+		m_Transport = nullptr;
+		m_ServerEntities.clear();
+		m_NodeKeys.clear();
+		m_Clients.clear();
+		m_NextKey = 1;
+		m_ReplicatedNodes.clear();
+		m_Connected = false;
+		m_LastSequence = 0;
+		m_AckMask = 0;
+		m_RequestResync = false;
+		m_Stats.ConnectedClients = 0;
+		m_Stats.ReplicatedNodes = 0;
+	}
+
+	void NetworkContext::Update(float deltaTime)
+	{
+		if (!m_World || !m_Transport) return;
+
+		if (m_Mode == NetworkMode::Server) ServerUpdate(deltaTime);
+		else if (m_Mode == NetworkMode::Client) ClientUpdate(deltaTime);
+	}
+
+	NetworkKey NetworkContext::GetNetworkKey(Node* node) const
+	{
+		if (!node) return 0;
+		if (m_Mode == NetworkMode::Server)
+		{
+			auto it = m_NodeKeys.find(node);
+			return it != m_NodeKeys.end() ? it->second : 0;
+		}
+		for (const auto& [key, replicated] : m_ReplicatedNodes)
+		{
+			if (replicated.NodePtr.Get() == node) return key;
+		}
+		return 0;
+	}
+
+	Node* NetworkContext::GetNode(NetworkKey key) const
+	{
+		if (m_Mode == NetworkMode::Server)
+		{
+			auto it = m_ServerEntities.find(key);
+			return it != m_ServerEntities.end() ? it->second.NodePtr.Get() : nullptr;
+		}
+		auto it = m_ReplicatedNodes.find(key);
+		return it != m_ReplicatedNodes.end() ? it->second.NodePtr.Get() : nullptr;
+	}
+
+	void NetworkContext::WritePacketHeader(BitWriter& writer, PacketType type) const
+	{
+		writer.WriteBits(s_ProtocolID, 16);
+		writer.WriteBits((uint32_t)type, 3);
+	}
+
+	/** Returns false for packets of other protocols */
+	static bool ReadPacketHeader(BitReader& reader, uint32_t& type)
+	{
+		if (reader.ReadBits(16) != s_ProtocolID) return false;
+		type = reader.ReadBits(3);
+		return !reader.IsOverflown();
+	}
+
+	void NetworkContext::SendPacket(const NetworkAddress& address, const BitWriter& writer)
+	{
+		if (m_Transport)
+		{
+			m_Transport->Send(address, writer.GetData().data(), writer.GetByteCount());
+		}
+	}
+
+	void NetworkContext::SendPacket(const NetworkAddress& address, PacketType type)
+	{
+		BitWriter writer;
+		WritePacketHeader(writer, type);
+		SendPacket(address, writer);
+	}
+
+	/******************************************************************************************************************/
+	/* Server                                                                                                         */
+	/******************************************************************************************************************/
+
+	void NetworkContext::ServerUpdate(float deltaTime)
+	{
+		ServerReceive();
+
+		for (int64_t i = (int64_t)m_Clients.size() - 1; i >= 0; i--)
+		{
+			m_Clients[i]->TimeSinceReceive += deltaTime;
+			if (m_Clients[i]->TimeSinceReceive > m_Settings.ConnectionTimeout)
+			{
+				SUORA_WARN(LogCategory::Networking, "Client {0} timed out.", m_Clients[i]->Address.ToString());
+				m_Clients.erase(m_Clients.begin() + i);
+			}
+		}
+		m_Stats.ConnectedClients = (uint32_t)m_Clients.size();
+
+		m_SnapshotTimer += deltaTime;
+		if (m_SnapshotTimer < 1.0f / std::max(m_Settings.SnapshotRate, 0.001f)) return;
+		const float elapsed = m_SnapshotTimer;
+		m_SnapshotTimer = 0.0f;
+
+		DiscoverNodes();
+		for (const std::unique_ptr<ClientConnection>& client : m_Clients)
+		{
+			SendSnapshot(*client, elapsed);
+		}
+	}
+
+	void NetworkContext::ServerReceive()
+	{
+		NetworkPacket packet;
+		while (m_Transport->Receive(packet))
+		{
+			BitReader reader(packet.Data.data(), packet.Data.size());
+			uint32_t type = 0;
+			if (!ReadPacketHeader(reader, type)) continue;
+
+			ClientConnection* client = FindClient(packet.Address);
+			if (client) client->TimeSinceReceive = 0.0f;
+
+			switch ((PacketType)type)
+			{
+			case PacketType::Connect:
+				if (!client)
+				{
+					if (m_Clients.size() >= m_Settings.MaxClients)
+					{
+						SendPacket(packet.Address, PacketType::Disconnect);
+						break;
+					}
+					m_Clients.push_back(std::make_unique<ClientConnection>());
+					client = m_Clients.back().get();
+					client->Address = packet.Address;
+					client->Bandwidth = (float)m_Settings.BytesPerSecond;
+					SUORA_INFO(LogCategory::Networking, "Client {0} connected.", packet.Address.ToString());
+				}
+				// Accepts can get lost, so repeated Connects are answered as well
+				SendPacket(packet.Address, PacketType::Accept);
+				break;
+			case PacketType::Ack:
+				if (client) ProcessAck(*client, reader);
+				break;
+			case PacketType::Disconnect:
+				if (client)
+				{
+					SUORA_INFO(LogCategory::Networking, "Client {0} disconnected.", packet.Address.ToString());
+					m_Clients.erase(std::find_if(m_Clients.begin(), m_Clients.end(), [client](const std::unique_ptr<ClientConnection>& it) { return it.get() == client; }));
+				}
+				break;
+			default:
+				break;
+			}
+		}
+	}
+
+	NetworkContext::ClientConnection* NetworkContext::FindClient(const NetworkAddress& address)
+	{
+		for (const std::unique_ptr<ClientConnection>& client : m_Clients)
+		{
+			if (client->Address == address) return client.get();
+		}
+		return nullptr;
+	}
+
+	void NetworkContext::DiscoverNodes()
+	{
+		// Drop Nodes that are gone first, a new Node might have been allocated at the address of a deleted one
+		for (auto it = m_ServerEntities.begin(); it != m_ServerEntities.end();)
+		{
+			Node* node = it->second.NodePtr.Get();
+			if (node && !node->IsPendingKill() && node->IsReplicated() && !node->GetParent())
+			{
+				it++;
+				continue;
+			}
+			for (const std::unique_ptr<ClientConnection>& client : m_Clients)
+			{
+				auto state = client->Entities.find(it->first);
+				if (state != client->Entities.end()) state->second.PendingDestroy = true;
+			}
+			for (auto key = m_NodeKeys.begin(); key != m_NodeKeys.end(); key++)
+			{
+				if (key->second == it->first)
+				{
+					m_NodeKeys.erase(key);
+					break;
+				}
+			}
+			it = m_ServerEntities.erase(it);
+		}
+
+		// Only root Nodes are replicated, their children are spawned along with them
+		for (Node* node : m_World->m_WorldNodes)
+		{
+			if (!node->IsReplicated() || node->GetParent() || node->IsPendingKill() || m_NodeKeys.find(node) != m_NodeKeys.end()) continue;
+
+			const NetworkKey key = m_NextKey++;
+			m_NodeKeys[node] = key;
+			ServerEntity& entity = m_ServerEntities[key];
+			entity.NodePtr = node;
+			entity.NodeClass = node->GetClass();
+			entity.Layout = &ReplicationLayout::Get(entity.NodeClass);
+		}
+
+		for (auto& [key, entity] : m_ServerEntities)
+		{
+			Node* node = entity.NodePtr.Get();
+			entity.Layout->Capture(node, entity.Words);
+			if (entity.Layout->HasTransform()) entity.Position = node->As<Node3D>()->GetPosition();
+		}
+		m_Stats.ReplicatedNodes = (uint32_t)m_ServerEntities.size();
+	}
+
+	void NetworkContext::SendSnapshot(ClientConnection& client, float deltaTime)
+	{
+		// At most one second worth of budget is saved up
+		client.Bandwidth = std::min(client.Bandwidth + m_Settings.BytesPerSecond * deltaTime, (float)m_Settings.BytesPerSecond);
+		const size_t maxBytes = std::min(m_Transport->GetMaxPacketSize(), (size_t)client.Bandwidth);
+		if (maxBytes < s_MinSnapshotBytes) return;
+
+		struct Candidate
+		{
+			NetworkKey Key = 0;
+			float Priority = 0.0f;
+		};
+		std::vector<Candidate> candidates;
+		for (auto& [key, state] : client.Entities)
+		{
+			// Destroys are sent until they are acknowledged, ahead of everything else
+			if (state.PendingDestroy) candidates.push_back(Candidate{ key, FLT_MAX });
+		}
+		for (const auto& [key, entity] : m_ServerEntities)
+		{
+			float weight = 1.0f;
+			if (m_Settings.RelevanceDistance > 0.0f && client.HasViewPosition && entity.Layout->HasTransform())
+			{
+				const float distance = glm::distance(entity.Position, client.ViewPosition);
+				if (distance > m_Settings.RelevanceDistance)
+				{
+					// The client destroys its copy like the one of a removed Node, and gets a create once it is relevant again
+					auto state = client.Entities.find(key);
+					if (state == client.Entities.end() || state->second.PendingDestroy) continue;
+					if (state->second.Created || state->second.LastSentSequence != 0)
+					{
+						state->second.PendingDestroy = true;
+						candidates.push_back(Candidate{ key, FLT_MAX });
+					}
+					else
+					{
+						client.Entities.erase(state);
+					}
+					continue;
+				}
+				weight += 1.0f - distance / m_Settings.RelevanceDistance;
+			}
+
+			ClientEntityState& state = client.Entities[key];
+			// Back in relevance before the destroy was acknowledged, the create follows the acknowledgement
+			if (state.PendingDestroy) continue;
+			if (state.Created && state.LastSentSequence == state.BaselineSequence && state.Baseline == entity.Words)
+			{
+				// The client is up to date
+				state.Priority = 0.0f;
+				continue;
+			}
+			state.Priority += deltaTime * weight * (state.Created ? 1.0f : 2.0f);
+			candidates.push_back(Candidate{ key, state.Priority });
+		}
+		std::sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b) { return a.Priority > b.Priority; });
+
+		const uint32_t sequence = client.NextSequence++;
+		SentSnapshot& sent = client.History[sequence % s_HistorySize];
+		sent.Sequence = sequence;
+		sent.Records.clear();
+
+		BitWriter writer;
+		WritePacketHeader(writer, PacketType::Snapshot);
+		writer.WriteVarUInt(sequence);
+
+		static const std::vector<uint32_t> s_ZeroBaseline;
+		BitWriter record;
+		for (const Candidate& candidate : candidates)
+		{
+			ClientEntityState& state = client.Entities[candidate.Key];
+			auto entity = m_ServerEntities.find(candidate.Key);
+			const RecordKind kind = state.PendingDestroy ? RecordKind::Destroy : (state.Created ? RecordKind::Update : RecordKind::Create);
+
+			record.Clear();
+			record.WriteBool(true);
+			record.WriteVarUInt(candidate.Key);
+			record.WriteBits((uint32_t)kind, 2);
+			if (kind != RecordKind::Destroy)
+			{
+				const std::vector<uint32_t>& words = entity->second.Words;
+				if (kind == RecordKind::Create) record.WriteString(entity->second.NodeClass.ToString());
+				else record.WriteVarUInt(state.BaselineSequence);
+
+				for (size_t i = 0; i < words.size(); i++)
+				{
+					Quantization::WriteDelta(record, words[i], kind == RecordKind::Update ? state.Baseline[i] : 0);
+				}
+			}
+
+			// One bit is reserved for the terminator, smaller records further down might still fit
+			if (writer.GetBitCount() + record.GetBitCount() + 1 > maxBytes * 8)
+			{
+				m_Stats.DeferredUpdates++;
+				continue;
+			}
+			writer.Append(record);
+			sent.Records.push_back(SentRecord{ candidate.Key, kind, kind != RecordKind::Destroy ? entity->second.Words : s_ZeroBaseline });
+			state.Priority = 0.0f;
+			state.LastSentSequence = sequence;
+		}
+		writer.WriteBool(false);
+
+		SendPacket(client.Address, writer);
+		client.Bandwidth -= (float)writer.GetByteCount();
+		m_Stats.SentSnapshots++;
+		m_Stats.LastSnapshotBytes = writer.GetByteCount();
+	}
+
+	void NetworkContext::ProcessAck(ClientConnection& client, BitReader& reader)
+	{
+		const uint32_t ack = (uint32_t)reader.ReadVarUInt();
+		const uint32_t mask = reader.ReadBits(32);
+		const bool resync = reader.ReadBool();
+		client.HasViewPosition = reader.ReadBool();
+		if (client.HasViewPosition)
+		{
+			for (uint32_t i = 0; i < 3; i++) client.ViewPosition[i] = Quantization::UnpackFixed(reader.ReadBits(32));
+		}
+		if (reader.IsOverflown()) return;
+
+		if (resync)
+		{
+			// The client lost track of its baselines, everything is sent from scratch
+			for (auto& [key, state] : client.Entities)
+			{
+				state.Created = false;
+				state.BaselineSequence = 0;
+				state.Baseline.clear();
+			}
+			for (SentSnapshot& sent : client.History)
+			{
+				sent.Sequence = 0;
+				sent.Records.clear();
+			}
+			return;
+		}
+
+		for (uint32_t i = 0; i <= 32; i++)
+		{
+			if (i > 0 && !(mask & (1u << (i - 1)))) continue;
+			const uint32_t sequence = ack - i;
+			if (sequence == 0 || sequence > ack) break;
+
+			SentSnapshot& sent = client.History[sequence % s_HistorySize];
+			if (sent.Sequence != sequence) continue;
+
+			for (SentRecord& record : sent.Records)
+			{
+				auto state = client.Entities.find(record.Key);
+				if (state == client.Entities.end()) continue;
+
+				if (record.Kind == RecordKind::Destroy)
+				{
+					// A late acknowledgement must not forget a Node that was created again in the meantime
+					if (state->second.PendingDestroy) client.Entities.erase(state);
+				}
+				else if (!state->second.PendingDestroy && sequence > state->second.BaselineSequence)
+				{
+					state->second.Created = true;
+					state->second.BaselineSequence = sequence;
+					state->second.Baseline = std::move(record.Words);
+				}
+			}
+			sent.Sequence = 0;
+			sent.Records.clear();
+		}
+	}
+
+	/******************************************************************************************************************/
+	/* Client                                                                                                         */
+	/******************************************************************************************************************/
+
+	void NetworkContext::ClientUpdate(float deltaTime)
+	{
+		ClientReceive();
+		if (m_Mode != NetworkMode::Client) return;
+
+		m_TimeSinceReceive += deltaTime;
+		if (m_TimeSinceReceive > m_Settings.ConnectionTimeout)
+		{
+			if (m_Connected) SUORA_WARN(LogCategory::Networking, "Connection to {0} timed out.", m_ServerAddress.ToString());
+			else SUORA_WARN(LogCategory::Networking, "Could not connect to {0}.", m_ServerAddress.ToString());
+			Stop();
+			return;
+		}
+
+		if (!m_Connected)
+		{
+			m_ConnectTimer -= deltaTime;
+			if (m_ConnectTimer <= 0.0f)
+			{
+				SendPacket(m_ServerAddress, PacketType::Connect);
+				m_ConnectTimer = m_Settings.ConnectRetryInterval;
+			}
+		}
+	}
+
+	void NetworkContext::ClientReceive()
+	{
+		NetworkPacket packet;
+		while (m_Transport && m_Transport->Receive(packet))
+		{
+			if (packet.Address != m_ServerAddress) continue;
+
+			BitReader reader(packet.Data.data(), packet.Data.size());
+			uint32_t type = 0;
+			if (!ReadPacketHeader(reader, type)) continue;
+			m_TimeSinceReceive = 0.0f;
+
+			switch ((PacketType)type)
+			{
+			case PacketType::Accept:
+			case PacketType::Snapshot:
+				if (!m_Connected)
+				{
+					// The server owns all replicated Nodes from now on
+					m_Connected = true;
+					DestroyReplicatedNodes();
+					SUORA_INFO(LogCategory::Networking, "Connected to {0}", m_ServerAddress.ToString());
+				}
+				if ((PacketType)type == PacketType::Snapshot)
+				{
+					const uint32_t sequence = (uint32_t)reader.ReadVarUInt();
+					// An older snapshot would roll back the Nodes of the newer one. It is not acknowledged either, so the
+					// server resends the records that its budget kept out of the newer snapshots.
+					if (reader.IsOverflown() || sequence <= m_LastSequence)
+					{
+						m_Stats.DiscardedSnapshots++;
+						break;
+					}
+					if (ReadSnapshot(reader, sequence))
+					{
+						const uint32_t shift = sequence - m_LastSequence;
+						m_AckMask = shift >= 32 ? 0 : (m_AckMask << shift);
+						if (m_LastSequence != 0 && shift <= 32) m_AckMask |= 1u << (shift - 1);
+						m_LastSequence = sequence;
+						m_RequestResync = false;
+						m_Stats.ReceivedSnapshots++;
+					}
+					else
+					{
+						m_Stats.DiscardedSnapshots++;
+						m_RequestResync = true;
+					}
+					SendAck();
+				}
+				break;
+			case PacketType::Disconnect:
+				SUORA_INFO(LogCategory::Networking, "Disconnected by the server.");
+				m_Mode = NetworkMode::None;
+				Stop();
+				return;
+			default:
+				break;
+			}
+		}
+	}
+
+	bool NetworkContext::ReadSnapshot(BitReader& reader, uint32_t sequence)
+	{
+		struct DecodedRecord
+		{
+			NetworkKey Key = 0;
+			RecordKind Kind = RecordKind::Update;
+			Class NodeClass = Class::None;
+			const ReplicationLayout* Layout = nullptr;
+			std::vector<uint32_t> Words;
+		};
+
+		// Everything is decoded before anything is applied, so a broken snapshot leaves the World untouched
+		std::vector<DecodedRecord> records;
+		while (reader.ReadBool() && !reader.IsOverflown())
+		{
+			DecodedRecord& record = records.emplace_back();
+			record.Key = (NetworkKey)reader.ReadVarUInt();
+			record.Kind = (RecordKind)reader.ReadBits(2);
+			if (record.Kind == RecordKind::Destroy) continue;
+
+			const std::vector<uint32_t>* baseline = nullptr;
+			if (record.Kind == RecordKind::Create)
+			{
+				record.NodeClass = Class::FromString(reader.ReadString());
+				if (record.NodeClass == Class::None || !record.NodeClass.Inherits(Node::StaticClass())) return false;
+			}
+			else if (record.Kind == RecordKind::Update)
+			{
+				const uint32_t baselineSequence = (uint32_t)reader.ReadVarUInt();
+				auto it = m_ReplicatedNodes.find(record.Key);
+				if (it == m_ReplicatedNodes.end()) return false;
+
+				const ReceivedState& state = it->second.History[baselineSequence % s_HistorySize];
+				if (state.Sequence != baselineSequence || baselineSequence == 0) return false;
+				record.NodeClass = it->second.NodeClass;
+				baseline = &state.Words;
+			}
+			else
+			{
+				return false;
+			}
+
+			record.Layout = &ReplicationLayout::Get(record.NodeClass);
+			record.Words.resize(record.Layout->GetWordCount());
+			if (baseline && baseline->size() != record.Words.size()) return false;
+			for (size_t i = 0; i < record.Words.size(); i++)
+			{
+				record.Words[i] = Quantization::ReadDelta(reader, baseline ? (*baseline)[i] : 0);
+			}
+		}
+		if (reader.IsOverflown()) return false;
+
+		for (DecodedRecord& record : records)
+		{
+			if (record.Kind == RecordKind::Destroy)
+			{
+				auto it = m_ReplicatedNodes.find(record.Key);
+				if (it == m_ReplicatedNodes.end()) continue;
+				if (Node* node = it->second.NodePtr.Get()) node->Destroy();
+				m_ReplicatedNodes.erase(it);
+				continue;
+			}
+
+			ReplicatedNode& replicated = m_ReplicatedNodes[record.Key];
+			if (record.Kind == RecordKind::Create && (replicated.NodeClass != record.NodeClass || !replicated.NodePtr))
+			{
+				if (Node* node = replicated.NodePtr.Get()) node->Destroy();
+				replicated.NodePtr = m_World->Spawn(record.NodeClass);
+				replicated.NodeClass = record.NodeClass;
+				replicated.Layout = record.Layout;
+				for (ReceivedState& state : replicated.History) state.Sequence = 0;
+			}
+
+			if (Node* node = replicated.NodePtr.Get())
+			{
+				replicated.Layout->Apply(node, record.Words.data());
+			}
+			ReceivedState& state = replicated.History[sequence % s_HistorySize];
+			state.Sequence = sequence;
+			state.Words = std::move(record.Words);
+			replicated.LatestSequence = sequence;
+		}
+		return true;
+	}
+
+	void NetworkContext::SendAck()
+	{
+		BitWriter writer;
+		WritePacketHeader(writer, PacketType::Ack);
+		writer.WriteVarUInt(m_LastSequence);
+		writer.WriteBits(m_AckMask, 32);
+		writer.WriteBool(m_RequestResync);
+
+		// The server uses the view for relevance
+		Node3D* view = m_World->GetPlayerPawn() ? m_World->GetPlayerPawn()->As<Node3D>() : nullptr;
+		if (!view) view = m_World->GetMainCamera();
+		writer.WriteBool(view != nullptr);
+		if (view)
+		{
+			const Vec3 position = view->GetPosition();
+			for (uint32_t i = 0; i < 3; i++) writer.WriteBits(Quantization::PackFixed(position[i]), 32);
+		}
+		SendPacket(m_ServerAddress, writer);
+	}
+
+	void NetworkContext::DestroyReplicatedNodes()
+	{
+		for (Node* node : m_World->m_WorldNodes)
+		{
+			if (node->IsReplicated() && !node->GetParent() && !node->IsPendingKill())
+			{
+				node->Destroy();
+			}
+		}
+		m_ReplicatedNodes.clear();
+	}
 
 }
\ No newline at end of file
@@ -1,17 +1,197 @@
 #pragma once
+#include <array>
+#include <unordered_map>
+#include <vector>
 #include "Suora/Core/Object/Object.h"
+#include "Suora/Core/Object/Pointer.h"
+#include "NetworkTransport.h"
 #include "Networking.generated.h"
 
 namespace Suora
 {
+	class Node;
+	class World;
+	class BitWriter;
+	class BitReader;
+	class ReplicationLayout;
 
+	/** Identifies a replicated Node on the server and all clients, 0 is invalid */
 	using NetworkKey = uint32_t;
 
+	enum class NetworkMode : uint8_t
+	{
+		None = 0,
+		Server,
+		Client
+	};
+
+	struct NetworkSettings
+	{
+		/** Snapshots per second, that the server sends to each client */
+		float SnapshotRate = 20.0f;
+		uint32_t MaxClients = 16;
+		/** Nodes farther away from the view of a client are destroyed on it, and created again once they come closer.
+		 *  0 disables the relevance check. */
+		float RelevanceDistance = 0.0f;
+		/** Budget per client, a snapshot never exceeds the max packet size of the transport either */
+		uint32_t BytesPerSecond = 64 * 1024;
+		/** Connections without any packet for this long are dropped */
+		float ConnectionTimeout = 10.0f;
+		float ConnectRetryInterval = 0.5f;
+	};
+
+	struct NetworkStats
+	{
+		uint32_t ConnectedClients = 0;
+		uint32_t ReplicatedNodes = 0;
+		uint64_t SentSnapshots = 0;
+		uint64_t ReceivedSnapshots = 0;
+		/** Out of order, or the client was missing a baseline */
+		uint64_t DiscardedSnapshots = 0;
+		/** Node updates, that did not fit into the budget and were deferred to a later snapshot */
+		uint64_t DeferredUpdates = 0;
+		uint32_t LastSnapshotBytes = 0;
+	};
+
+	/* Server-authoritative replication of Nodes. The server discovers all replicated root Nodes of its World and sends
+	 * each client snapshots of their state, delta compressed against the last snapshot that client acknowledged.
+	 * Nodes are prioritized by relevance and time since their last update, and each snapshot is limited by a bandwidth
+	 * budget. Clients spawn, update and destroy the Nodes accordingly. Attach it with World::SetNetworkContext(...). */
 	class NetworkContext : public Object
 	{
 		SUORA_CLASS(57658479);
 	public:
+		NetworkContext();
+		~NetworkContext();
+
+		bool StartServer(const Ref<NetworkTransport>& transport);
+		bool StartClient(const Ref<NetworkTransport>& transport, const NetworkAddress& server);
+		/** Disconnects all clients, or from the server */
+		void Stop();
+		/** Called by the World at the end of its Update */
+		void Update(float deltaTime);
+
+		NetworkMode GetMode() const { return m_Mode; }
+		bool IsServer() const { return m_Mode == NetworkMode::Server; }
+		bool IsClient() const { return m_Mode == NetworkMode::Client; }
+		/** Clients only, true once the server accepted the connection */
+		bool IsConnected() const { return m_Connected; }
+
+		NetworkSettings& GetSettings() { return m_Settings; }
+		const NetworkStats& GetStats() const { return m_Stats; }
+		NetworkTransport* GetTransport() const { return m_Transport.get(); }
+		World* GetWorld() const { return m_World; }
+
+		/** Returns 0, if the Node is not replicated */
+		NetworkKey GetNetworkKey(Node* node) const;
+		Node* GetNode(NetworkKey key) const;
+
+	private:
+		static constexpr uint32_t s_HistorySize = 64;
+
+		enum class PacketType : uint8_t { Connect = 0, Accept, Snapshot, Ack, Disconnect };
+		enum class RecordKind : uint8_t { Update = 0, Create, Destroy };
+
+		struct ServerEntity
+		{
+			Ptr<Node> NodePtr;
+			Class NodeClass = Class::None;
+			const ReplicationLayout* Layout = nullptr;
+			/** Captured once per snapshot, shared by all clients */
+			std::vector<uint32_t> Words;
+			Vec3 Position = Vec3(0.0f);
+		};
+		/** What a client knows about a ServerEntity */
+		struct ClientEntityState
+		{
+			/** The client acknowledged a snapshot with the create record */
+			bool Created = false;
+			bool PendingDestroy = false;
+			uint32_t BaselineSequence = 0;
+			std::vector<uint32_t> Baseline;
+			uint32_t LastSentSequence = 0;
+			float Priority = 0.0f;
+		};
+		struct SentRecord
+		{
+			NetworkKey Key = 0;
+			RecordKind Kind = RecordKind::Update;
+			std::vector<uint32_t> Words;
+		};
+		struct SentSnapshot
+		{
+			uint32_t Sequence = 0;
+			std::vector<SentRecord> Records;
+		};
+		struct ClientConnection
+		{
+			NetworkAddress Address;
+			std::unordered_map<NetworkKey, ClientEntityState> Entities;
+			std::array<SentSnapshot, s_HistorySize> History;
+			uint32_t NextSequence = 1;
+			float Bandwidth = 0.0f;
+			float TimeSinceReceive = 0.0f;
+			bool HasViewPosition = false;
+			Vec3 ViewPosition = Vec3(0.0f);
+		};
+
+		struct ReceivedState
+		{
+			uint32_t Sequence = 0;
+			std::vector<uint32_t> Words;
+		};
+		struct ReplicatedNode
+		{
+			Ptr<Node> NodePtr;
+			Class NodeClass = Class::None;
+			const ReplicationLayout* Layout = nullptr;
+			/** States of the received snapshots, the baselines of future deltas */
+			std::array<ReceivedState, s_HistorySize> History;
+			uint32_t LatestSequence = 0;
+		};
+
+		void ServerUpdate(float deltaTime);
+		void ServerReceive();
+		void DiscoverNodes();
+		void SendSnapshot(ClientConnection& client, float deltaTime);
+		void ProcessAck(ClientConnection& client, BitReader& reader);
+		ClientConnection* FindClient(const NetworkAddress& address);
+
+		void ClientUpdate(float deltaTime);
+		void ClientReceive();
+		bool ReadSnapshot(BitReader& reader, uint32_t sequence);
+		void SendAck();
+		void DestroyReplicatedNodes();
+
+		void WritePacketHeader(BitWriter& writer, PacketType type) const;
+		void SendPacket(const NetworkAddress& address, const BitWriter& writer);
+		void SendPacket(const NetworkAddress& address, PacketType type);
+
+		NetworkMode m_Mode = NetworkMode::None;
+		NetworkSettings m_Settings;
+		NetworkStats m_Stats;
+		Ref<NetworkTransport> m_Transport;
+		World* m_World = nullptr;
+		float m_SnapshotTimer = 0.0f;
+
+		/* Server */
+		std::unordered_map<NetworkKey, ServerEntity> m_ServerEntities;
+		std::unordered_map<Node*, NetworkKey> m_NodeKeys;
+		std::vector<std::unique_ptr<ClientConnection>> m_Clients;
+		NetworkKey m_NextKey = 1;
+
+		/* Client */
+		NetworkAddress m_ServerAddress;
+		std::unordered_map<NetworkKey, ReplicatedNode> m_ReplicatedNodes;
+		bool m_Connected = false;
+		float m_ConnectTimer = 0.0f;
+		float m_TimeSinceReceive = 0.0f;
+		uint32_t m_LastSequence = 0;
+		uint32_t m_AckMask = 0;
+		/** Set after a snapshot could not be decoded, asks the server to send full states again */
+		bool m_RequestResync = false;
 
+		friend class World;
 	};
 
 }
\ No newline at end of file
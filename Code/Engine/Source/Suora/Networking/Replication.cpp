@@ -0,0 +1,128 @@
+#include "Precompiled.h"
+#include "Replication.h"
+#include <cstring>
+#include "BitStream.h"
+#include "Suora/GameFramework/Node.h"
+#include "Suora/Reflection/ClassReflector.h"
+
+namespace Suora
+{
+
+	const ReplicationLayout& ReplicationLayout::Get(const Class& cls)
+	{
+		auto it = s_Layouts.find(cls);
+		if (it != s_Layouts.end()) return it->second;
+
+		ReplicationLayout& layout = s_Layouts[cls];
+		layout.m_HasTransform = cls.Inherits(Node3D::StaticClass());
+		layout.m_WordCount = layout.m_HasTransform ? s_TransformWords : 0;
+
+		for (const Ref<ClassMemberProperty>& member : ClassReflector::GetByClass(cls).GetAllClassMemberProperties())
+		{
+			const PropertyType type = member->m_Property->GetType();
+			const uint32_t wordCount = GetWordCount(type);
+			if (wordCount == 0) continue;
+
+			layout.m_Fields.push_back(Field{ member->m_MemberOffset, type, layout.m_WordCount, wordCount });
+			layout.m_WordCount += wordCount;
+		}
+		return layout;
+	}
+
+	uint32_t ReplicationLayout::GetWordCount(PropertyType type)
+	{
+		switch (type)
+		{
+		case PropertyType::Char:
+		case PropertyType::Int8:
+		case PropertyType::Int16:
+		case PropertyType::Int32:
+		case PropertyType::UInt8:
+		case PropertyType::UInt16:
+		case PropertyType::UInt32:
+		case PropertyType::Bool:
+		case PropertyType::Float: return 1;
+		case PropertyType::Int64:
+		case PropertyType::UInt64:
+		case PropertyType::Double:
+		case PropertyType::Vec2: return 2;
+		case PropertyType::Vec3: return 3;
+		case PropertyType::Vec4:
+		case PropertyType::Quat: return 4;
+		default: return 0;
+		}
+	}
+
+	/** Size of the member in bytes, words beyond it are zero */
+	static size_t GetMemberSize(PropertyType type)
+	{
+		switch (type)
+		{
+		case PropertyType::Char:
+		case PropertyType::Int8:
+		case PropertyType::UInt8:
+		case PropertyType::Bool: return 1;
+		case PropertyType::Int16:
+		case PropertyType::UInt16: return 2;
+		case PropertyType::Int32:
+		case PropertyType::UInt32:
+		case PropertyType::Float: return 4;
+		case PropertyType::Int64:
+		case PropertyType::UInt64:
+		case PropertyType::Double: return 8;
+		case PropertyType::Vec2: return sizeof(Vec2);
+		case PropertyType::Vec3: return sizeof(Vec3);
+		case PropertyType::Vec4: return sizeof(Vec4);
+		case PropertyType::Quat: return sizeof(Quat);
+		default: return 0;
+		}
+	}
+
+	void ReplicationLayout::Capture(Node* node, std::vector<uint32_t>& words) const
+	{
+		words.assign(m_WordCount, 0);
+
+		if (m_HasTransform)
+		{
+			Node3D* node3D = node->As<Node3D>();
+			const Vec3 position = node3D->GetPosition();
+			const Vec3 scale = node3D->GetScale();
+			for (uint32_t i = 0; i < 3; i++)
+			{
+				words[i] = Quantization::PackFixed(position[i]);
+				words[4 + i] = Quantization::PackFixed(scale[i]);
+			}
+			words[3] = Quantization::PackQuat(node3D->GetRotation());
+		}
+
+		for (const Field& field : m_Fields)
+		{
+			// Small members are widened bytewise, the sign does not matter for the delta compression
+			std::memcpy(&words[field.FirstWord], ClassMemberProperty::AccessMember<uint8_t>(node, field.Offset), GetMemberSize(field.Type));
+		}
+	}
+
+	void ReplicationLayout::Apply(Node* node, const uint32_t* words) const
+	{
+		if (m_HasTransform)
+		{
+			Node3D* node3D = node->As<Node3D>();
+			const Vec3 position = Vec3(Quantization::UnpackFixed(words[0]), Quantization::UnpackFixed(words[1]), Quantization::UnpackFixed(words[2]));
+			const Vec3 scale = Vec3(Quantization::UnpackFixed(words[4]), Quantization::UnpackFixed(words[5]), Quantization::UnpackFixed(words[6]));
+			node3D->SetPositionAndRotation(position, Quantization::UnpackQuat(words[3]));
+			node3D->SetScale(scale);
+		}
+
+		for (const Field& field : m_Fields)
+		{
+			if (field.Type == PropertyType::Bool)
+			{
+				// Any other byte than 0 or 1 in a bool is undefined behaviour, and the words come from the network
+				*ClassMemberProperty::AccessMember<bool>(node, field.Offset) = words[field.FirstWord] != 0;
+				continue;
+			}
+			std::memcpy(ClassMemberProperty::AccessMember<uint8_t>(node, field.Offset), &words[field.FirstWord], GetMemberSize(field.Type));
+		}
+	}
+
+}
\ No newline at end of file
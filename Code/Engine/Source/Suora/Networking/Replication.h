@@ -0,0 +1,49 @@
+#pragma once
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "Suora/Reflection/Class.h"
+#include "Suora/Reflection/Property.h"
+
+namespace Suora
+{
+	class Node;
+
+	/** Flattens the replicated state of a Class into 32 bit words, that can be delta compressed against each other.
+	 *  Root transforms (if the Class inherits Node3D) are quantized, all reflected primitive properties follow bit-exact.
+	 *  Strings, Object pointers, Arrays, Delegates and Classes are not replicated. */
+	class ReplicationLayout
+	{
+	public:
+		struct Field
+		{
+			size_t Offset = 0;
+			PropertyType Type = PropertyType::None;
+			uint32_t FirstWord = 0;
+			uint32_t WordCount = 0;
+		};
+
+		/** Position (3), Rotation (1) and Scale (3) */
+		static constexpr uint32_t s_TransformWords = 7;
+
+		/** Cached per Class */
+		static const ReplicationLayout& Get(const Class& cls);
+
+		void Capture(Node* node, std::vector<uint32_t>& words) const;
+		void Apply(Node* node, const uint32_t* words) const;
+
+		bool HasTransform() const { return m_HasTransform; }
+		uint32_t GetWordCount() const { return m_WordCount; }
+		const std::vector<Field>& GetFields() const { return m_Fields; }
+
+	private:
+		static uint32_t GetWordCount(PropertyType type);
+
+		std::vector<Field> m_Fields;
+		uint32_t m_WordCount = 0;
+		bool m_HasTransform = false;
+
+		inline static std::unordered_map<Class, ReplicationLayout> s_Layouts;
+	};
+
+}
\ No newline at end of file
@@ -4,6 +4,8 @@
 #include "Suora/Serialization/Yaml.h"
 #include "Suora/NodeScript/ScriptTypes.h"
 #include "Suora/NodeScript/Scripting/ScriptVM.h"
+#include "Suora/NodeScript/Scripting/ScriptOptimizer.h"
+#include "Suora/Assets/AssetManager.h"
 
 #include "Suora/GameFramework/InputModule.h"
 
@@ -55,11 +57,17 @@ namespace Suora
 		}
 		return false;
 	}
-	void BlueprintCompiler::Compile(Blueprint& blueprint)
+	void BlueprintCompiler::Compile(Blueprint& blueprint, ScriptOptimizerStats* stats)
 	{
 		blueprint.m_DelegateEventsToBindDuringGameplay.Clear();
 		blueprint.m_InputEventsToBeBound.Clear();
 
+		CompileOutput output{ *blueprint.m_ScriptClass, blueprint.m_DelegateEventsToBindDuringGameplay };
+		Compile(blueprint, DeserializeEventGraphs(blueprint), output, stats);
+	}
+
+	Array<Ref<VisualNodeGraph>> BlueprintCompiler::DeserializeEventGraphs(Blueprint& blueprint)
+	{
 		Array<Ref<VisualNodeGraph>> eventGraphs;
 		Yaml::Node& graphs = blueprint.m_YamlNode_EditorOnly["Node"]["Graphs"];
 		int i = 0;
@@ -72,12 +80,38 @@ namespace Suora
 			eventGraphs.Add(bng);
 			i++;
 		}
-		Compile(blueprint, eventGraphs);
+		return eventGraphs;
+	}
+
+	void BlueprintCompiler::LogOptimizationReport()
+	{
+		ScriptOptimizerStats total;
+		for (Blueprint* blueprint : AssetManager::GetAssets<Blueprint>())
+		{
+			// Compiling into the Blueprint would replace the ScriptFunctions and binds that running Nodes use
+			ScriptClassInternal scratchClass;
+			Array<Blueprint::DelegateEventBind> scratchDelegateEvents;
+			CompileOutput output{ scratchClass, scratchDelegateEvents };
+			ScriptOptimizerStats stats;
+			Compile(*blueprint, DeserializeEventGraphs(*blueprint), output, &stats);
+			if (stats.Functions == 0) continue;
+
+			SuoraLog("{0}: {1} -> {2} instructions, {3} -> {4} local variables in {5} functions", blueprint->GetAssetName(), stats.InstructionsBefore, stats.InstructionsAfter, stats.LocalVarsBefore, stats.LocalVarsAfter, stats.Functions);
+			total += stats;
+		}
+
+		const float saved = total.InstructionsBefore > 0 ? 100.0f * (1.0f - (float)total.InstructionsAfter / (float)total.InstructionsBefore) : 0.0f;
+		SuoraLog("Blueprint bytecode: {0} -> {1} instructions ({2}% fewer) in {3} functions", total.InstructionsBefore, total.InstructionsAfter, saved, total.Functions);
+		SuoraLog("  {0} constants folded, {1} subexpressions reused, {2} dead stores, {3} peepholes", total.ConstantsFolded, total.SubexpressionsReused, total.StoresRemoved, total.PeepholesApplied);
+		if (total.VerificationFailures > 0)
+		{
+			SuoraWarn("  {0} functions failed verification and were not optimized", total.VerificationFailures);
+		}
 	}
 
-	void BlueprintCompiler::Compile(Blueprint& blueprint, const Array<Ref<VisualNodeGraph>>& eventGraphs)
+	void BlueprintCompiler::Compile(Blueprint& blueprint, const Array<Ref<VisualNodeGraph>>& eventGraphs, CompileOutput& output, ScriptOptimizerStats* stats)
 	{
-		blueprint.m_ScriptClass->m_Functions.clear();
+		output.ScriptClass.m_Functions.clear();
 		uint64_t hashCounter = 1;
 
 		for (Ref<VisualNodeGraph> graph : eventGraphs)
@@ -95,7 +129,7 @@ namespace Suora
 						if (pin.PinID == 1 && pin.Target) exec = &pin;
 					}
 					if (exec)
-						CompileEvent(blueprint, *event, *exec, graph, std::stoull(event->m_InputPins[0].m_AdditionalData));
+						CompileEvent(blueprint, *event, *exec, graph, std::stoull(event->m_InputPins[0].m_AdditionalData), output, stats);
 				}
 				else if (event->m_NodeID == NODE_ID_DELEGATE)
 				{
@@ -108,17 +142,17 @@ namespace Suora
 					if (exec)
 					{
 						size_t hash = hashCounter++;
-						CompileEvent(blueprint, *event, *exec, graph, hash);
-						blueprint.m_DelegateEventsToBindDuringGameplay.Add(Blueprint::DelegateEventBind(event->m_InputPins[0].m_AdditionalData, event->m_InputPins[1].m_AdditionalData, hash));
+						CompileEvent(blueprint, *event, *exec, graph, hash, output, stats);
+						output.DelegateEvents.Add(Blueprint::DelegateEventBind(event->m_InputPins[0].m_AdditionalData, event->m_InputPins[1].m_AdditionalData, hash));
 					}
 				}
 			}
 		}
 	}
-	void BlueprintCompiler::CompileEvent(Blueprint& blueprint, VisualNode& event, VisualNodePin& exec, Ref<VisualNodeGraph> graph, size_t hash)
+	void BlueprintCompiler::CompileEvent(Blueprint& blueprint, VisualNode& event, VisualNodePin& exec, Ref<VisualNodeGraph> graph, size_t hash, CompileOutput& output, ScriptOptimizerStats* stats)
 	{
-		blueprint.m_ScriptClass->m_Functions.push_back(ScriptFunction());
-		ScriptFunction& func = blueprint.m_ScriptClass->m_Functions[blueprint.m_ScriptClass->m_Functions.size() - 1];
+		output.ScriptClass.m_Functions.push_back(ScriptFunction());
+		ScriptFunction& func = output.ScriptClass.m_Functions[output.ScriptClass.m_Functions.size() - 1];
 		func.m_IsEvent = true;
 		func.m_Hash = hash;
 
@@ -140,6 +174,8 @@ namespace Suora
 		}
 		CompileVisualNode(func, Class(blueprint), *exec.Target->GetNode(), exec.Target, cache, graph);
 		func.m_LocalVarCount = cache.LocalVars.Size();
+
+		ScriptOptimizer::Optimize(func, stats);
 	}
 	bool BlueprintCompiler::CompileVisualNode(ScriptFunction& func, const Class& cls, VisualNode& node, VisualNodePin* exec, CompilerCache& cache, Ref<VisualNodeGraph> graph)
 	{
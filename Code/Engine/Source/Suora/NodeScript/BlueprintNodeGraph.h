@@ -6,6 +6,8 @@ namespace Suora
 {
 	class Blueprint;
 	struct ScriptFunction;
+	struct ScriptClassInternal;
+	struct ScriptOptimizerStats;
 
 	struct BlueprintCompiler
 	{
@@ -19,13 +21,25 @@ namespace Suora
 			Array<LocalVar> LocalVars;
 		};
 
-		static void Compile(Blueprint& blueprint);
+		/** Every compiled ScriptFunction is verified and optimized, the ScriptOptimizerStats are accumulated into stats */
+		static void Compile(Blueprint& blueprint, ScriptOptimizerStats* stats = nullptr);
+		/** Compiles all Blueprints of the project into scratch ScriptClasses, and logs the instruction counts before and
+		 *  after optimization. The Blueprints themselves are left untouched.                                           */
+		static void LogOptimizationReport();
 
 	private:
+		/** Receives the compiled ScriptFunctions and delegate binds; the Blueprint itself, or a scratch copy */
+		struct CompileOutput
+		{
+			ScriptClassInternal& ScriptClass;
+			Array<Blueprint::DelegateEventBind>& DelegateEvents;
+		};
+
+		static Array<Ref<VisualNodeGraph>> DeserializeEventGraphs(Blueprint& blueprint);
 		static bool IsVisualNodePinUsed(VisualNodePin& pin, Ref<VisualNodeGraph> graph);
 		static bool IsVisualNodePinLocalVar(VisualNodePin& pin, CompilerCache& cache, int& ID);
-		static void Compile(Blueprint& blueprint, const Array<Ref<VisualNodeGraph>>& eventGraphs);
-		static void CompileEvent(Blueprint& blueprint, VisualNode& event, VisualNodePin& exec, Ref<VisualNodeGraph> graph, size_t hash);
+		static void Compile(Blueprint& blueprint, const Array<Ref<VisualNodeGraph>>& eventGraphs, CompileOutput& output, ScriptOptimizerStats* stats);
+		static void CompileEvent(Blueprint& blueprint, VisualNode& event, VisualNodePin& exec, Ref<VisualNodeGraph> graph, size_t hash, CompileOutput& output, ScriptOptimizerStats* stats);
 		static bool CompileVisualNode(ScriptFunction& func, const Class& cls, VisualNode& node, VisualNodePin* exec, CompilerCache& cache, Ref<VisualNodeGraph> graph);
 		static bool CompileVisualNodePin(ScriptFunction& func, const Class& cls, VisualNodePin& pin, CompilerCache& cache, Ref<VisualNodeGraph> graph);
 	};
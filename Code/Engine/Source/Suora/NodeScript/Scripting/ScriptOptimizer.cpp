@@ -0,0 +1,465 @@
+#include "Precompiled.h"
+#include "ScriptOptimizer.h"
+#include <map>
+#include <unordered_map>
+#include "Suora/NodeScript/Scripting/ScriptVM.h"
+#include "Suora/Core/Object/NativeFunctionManager.h"
+
+namespace Suora
+{
+
+	static std::unordered_map<size_t, ScriptConstantFolder>& GetConstantFolders()
+	{
+		static std::unordered_map<size_t, ScriptConstantFolder> folders =
+		{
+			{ std::hash<String>{}("NodeScriptLibrary::Sin(float)"), [](const int64_t* args) { return ScriptStack::ConvertToStack<float>(glm::sin(ScriptStack::ConvertFromStack<float>(args[0]))); } },
+			{ std::hash<String>{}("NodeScriptLibrary::Cos(float)"), [](const int64_t* args) { return ScriptStack::ConvertToStack<float>(glm::cos(ScriptStack::ConvertFromStack<float>(args[0]))); } },
+		};
+		return folders;
+	}
+
+	static const NativeFunction* FindNativeFunction(size_t hash)
+	{
+		for (const NativeFunction* func : NativeFunction::s_NativeFunctions)
+		{
+			if (func->m_Hash == hash) return func;
+		}
+		return nullptr;
+	}
+
+	static bool IsPushWithoutSideEffects(EScriptInstruction instruction)
+	{
+		return instruction == EScriptInstruction::PushConstant || instruction == EScriptInstruction::PushSelf
+			|| instruction == EScriptInstruction::PushLocalVar || instruction == EScriptInstruction::UpStack;
+	}
+
+	ScriptOptimizerStats& ScriptOptimizerStats::operator+=(const ScriptOptimizerStats& other)
+	{
+		Functions += other.Functions;
+		InstructionsBefore += other.InstructionsBefore;
+		InstructionsAfter += other.InstructionsAfter;
+		LocalVarsBefore += other.LocalVarsBefore;
+		LocalVarsAfter += other.LocalVarsAfter;
+		ConstantsFolded += other.ConstantsFolded;
+		SubexpressionsReused += other.SubexpressionsReused;
+		StoresRemoved += other.StoresRemoved;
+		PeepholesApplied += other.PeepholesApplied;
+		VerificationFailures += other.VerificationFailures;
+		return *this;
+	}
+
+	void ScriptOptimizer::RegisterConstantFolder(size_t nativeHash, const ScriptConstantFolder& folder)
+	{
+		GetConstantFolders()[nativeHash] = folder;
+	}
+
+	bool ScriptOptimizer::GetStackEffect(const ScriptInstruction& instruction, StackEffect& effect)
+	{
+		effect = StackEffect();
+		switch (instruction.m_Instruction)
+		{
+		case EScriptInstruction::IfNotThenJump:
+			return true;
+		case EScriptInstruction::CallNativeFunction:
+		{
+			const NativeFunction* native = FindNativeFunction((size_t)instruction.m_Args[0]);
+			if (!native) return false;
+			effect.Pops = (int32_t)native->m_Params.size() + (native->IsFlagSet(FunctionFlags::Static) ? 0 : 1);
+			effect.Pushes = native->m_ReturnType != "void" ? 1 : 0;
+			effect.IsPure = native->IsFlagSet(FunctionFlags::Pure);
+			return true;
+		}
+		case EScriptInstruction::PushConstant:
+		case EScriptInstruction::PushSelf:
+		case EScriptInstruction::PushLocalVar:
+			effect.Pushes = 1;
+			effect.IsPure = true;
+			return true;
+		case EScriptInstruction::PushToLocalVar:
+		case EScriptInstruction::Pop:
+			effect.Pops = 1;
+			return true;
+		case EScriptInstruction::UpStack:
+			effect.Pops = 1;
+			effect.Pushes = 2;
+			effect.IsPure = true;
+			return true;
+		case EScriptInstruction::Multiply_Vec3_Float:
+			effect.Pops = 2;
+			effect.Pushes = 1;
+			effect.IsPure = true;
+			return true;
+
+		// CallScriptFunction is not implemented by the VM
+		case EScriptInstruction::CallScriptFunction:
+		case EScriptInstruction::None:
+		default:
+			return false;
+		}
+	}
+
+	bool ScriptOptimizer::Analyze(const ScriptFunction& func, String* error, int32_t& netStackEffect)
+	{
+		auto fail = [error](size_t index, const String& message)
+		{
+			if (error) *error = "Instruction " + std::to_string(index) + ": " + message;
+			return false;
+		};
+
+		bool hasJumps = false;
+		for (const ScriptInstruction& instruction : func.m_Instructions)
+		{
+			if (instruction.m_Instruction == EScriptInstruction::IfNotThenJump) hasJumps = true;
+		}
+
+		std::vector<bool> written(func.m_LocalVarCount, false);
+		int32_t depth = 0;
+		int32_t minDepth = 0;
+		for (size_t i = 0; i < func.m_Instructions.size(); i++)
+		{
+			const ScriptInstruction& instruction = func.m_Instructions[i];
+			StackEffect effect;
+			if (!GetStackEffect(instruction, effect))
+			{
+				return fail(i, "Unknown instruction or NativeFunction");
+			}
+
+			if (instruction.m_Instruction == EScriptInstruction::IfNotThenJump)
+			{
+				// The VM increments the instruction index after the jump
+				if (instruction.m_Args[1] < -1 || instruction.m_Args[1] >= (int64_t)func.m_Instructions.size())
+				{
+					return fail(i, "Jump target out of range");
+				}
+			}
+			if (instruction.m_Instruction == EScriptInstruction::PushToLocalVar || instruction.m_Instruction == EScriptInstruction::PushLocalVar)
+			{
+				const int64_t localVar = instruction.m_Args[0];
+				if (localVar < 0 || localVar >= (int64_t)func.m_LocalVarCount)
+				{
+					return fail(i, "Local variable out of range");
+				}
+				if (instruction.m_Instruction == EScriptInstruction::PushToLocalVar)
+				{
+					written[localVar] = true;
+				}
+				else if (!hasJumps && !written[localVar])
+				{
+					return fail(i, "Local variable is read before it is written");
+				}
+			}
+
+			depth -= effect.Pops;
+			// Events receive their parameters on the stack
+			if (depth < 0 && !func.m_IsEvent)
+			{
+				return fail(i, "Stack underflow");
+			}
+			minDepth = std::min(minDepth, depth);
+			depth += effect.Pushes;
+		}
+
+		if (!hasJumps && depth != minDepth)
+		{
+			return fail(func.m_Instructions.size(), std::to_string(depth - minDepth) + " values are left on the stack");
+		}
+		netStackEffect = depth;
+		return true;
+	}
+
+	bool ScriptOptimizer::Verify(const ScriptFunction& func, String* error)
+	{
+		int32_t netStackEffect = 0;
+		return Analyze(func, error, netStackEffect);
+	}
+
+	bool ScriptOptimizer::Optimize(ScriptFunction& func, ScriptOptimizerStats* stats)
+	{
+		ScriptOptimizerStats functionStats;
+		functionStats.Functions = 1;
+		functionStats.InstructionsBefore = (uint32_t)func.m_Instructions.size();
+		functionStats.LocalVarsBefore = func.m_LocalVarCount;
+
+		bool changed = false;
+		String error;
+		int32_t netStackEffect = 0;
+		if (!Analyze(func, &error, netStackEffect))
+		{
+			SuoraWarn("ScriptOptimizer: ScriptFunction {0} failed verification and is not optimized. {1}", func.m_Hash, error);
+			functionStats.VerificationFailures++;
+		}
+		else if (s_Enabled)
+		{
+			ScriptFunction optimized = func;
+			ScriptOptimizerStats passStats = functionStats;
+			if (Rewrite(optimized, passStats))
+			{
+				while (CleanUp(optimized, passStats));
+				CompactLocalVars(optimized);
+
+				int32_t optimizedNetStackEffect = 0;
+				if (Analyze(optimized, &error, optimizedNetStackEffect) && optimizedNetStackEffect == netStackEffect)
+				{
+					func = std::move(optimized);
+					functionStats = passStats;
+					changed = true;
+				}
+				else
+				{
+					SuoraError("ScriptOptimizer: Optimized ScriptFunction {0} failed verification, keeping the original. {1}", func.m_Hash, error);
+					functionStats.VerificationFailures++;
+				}
+			}
+		}
+
+		functionStats.InstructionsAfter = (uint32_t)func.m_Instructions.size();
+		functionStats.LocalVarsAfter = func.m_LocalVarCount;
+		if (stats) *stats += functionStats;
+		return changed;
+	}
+
+	bool ScriptOptimizer::Rewrite(ScriptFunction& func, ScriptOptimizerStats& stats)
+	{
+		struct StackValue
+		{
+			uint32_t ID = 0;
+			/** First output instruction that computes this value */
+			size_t Begin = 0;
+			/** Computed by pure instructions only, so the instructions from Begin on can be dropped */
+			bool IsRemovable = false;
+		};
+		struct CachedValue
+		{
+			uint32_t ID = 0;
+			uint32_t LocalVar = 0;
+			/** Output index of the PushToLocalVar */
+			size_t Store = 0;
+		};
+
+		for (const ScriptInstruction& instruction : func.m_Instructions)
+		{
+			// Removing instructions would move the jump targets
+			if (instruction.m_Instruction == EScriptInstruction::IfNotThenJump) return false;
+		}
+
+		// Symbolic execution: every stack slot holds a value number, equal numbers are equal values
+		std::vector<ScriptInstruction> out;
+		out.reserve(func.m_Instructions.size());
+		std::vector<StackValue> stack;
+		std::unordered_map<int64_t, uint32_t> constantIDs;
+		std::unordered_map<uint32_t, int64_t> constantValues;
+		std::vector<uint32_t> localVarIDs(func.m_LocalVarCount, 0);
+		std::map<std::vector<int64_t>, CachedValue> cache;
+		uint32_t nextID = 1;
+		const uint32_t selfID = nextID++;
+		uint32_t localVarCount = func.m_LocalVarCount;
+		// Output instructions before the barrier have side effects or consume values of the caller, they always stay
+		size_t barrier = 0;
+
+		auto getConstantID = [&](int64_t value)
+		{
+			auto it = constantIDs.find(value);
+			if (it != constantIDs.end()) return it->second;
+			const uint32_t id = nextID++;
+			constantIDs[value] = id;
+			constantValues[id] = value;
+			return id;
+		};
+		auto truncate = [&](size_t size)
+		{
+			out.resize(size);
+			for (auto it = cache.begin(); it != cache.end();)
+			{
+				if (it->second.Store >= size) it = cache.erase(it);
+				else it++;
+			}
+		};
+
+		for (const ScriptInstruction& instruction : func.m_Instructions)
+		{
+			StackEffect effect;
+			if (!GetStackEffect(instruction, effect)) return false;
+
+			switch (instruction.m_Instruction)
+			{
+			case EScriptInstruction::PushConstant:
+				stack.push_back({ getConstantID(instruction.m_Args[0]), out.size(), true });
+				out.push_back(instruction);
+				continue;
+			case EScriptInstruction::PushSelf:
+				stack.push_back({ selfID, out.size(), true });
+				out.push_back(instruction);
+				continue;
+			case EScriptInstruction::PushLocalVar:
+				stack.push_back({ localVarIDs[instruction.m_Args[0]], out.size(), true });
+				out.push_back(instruction);
+				continue;
+			case EScriptInstruction::UpStack:
+				// Duplicating a parameter of the event gives an unknown value
+				stack.push_back({ stack.empty() ? nextID++ : stack.back().ID, out.size(), !stack.empty() });
+				out.push_back(instruction);
+				continue;
+			case EScriptInstruction::PushToLocalVar:
+				localVarIDs[instruction.m_Args[0]] = stack.empty() ? nextID++ : stack.back().ID;
+				if (!stack.empty()) stack.pop_back();
+				out.push_back(instruction);
+				barrier = out.size();
+				continue;
+			case EScriptInstruction::Pop:
+				if (!stack.empty()) stack.pop_back();
+				out.push_back(instruction);
+				barrier = out.size();
+				continue;
+			default:
+				break;
+			}
+
+			// Calls: CallNativeFunction and the builtin operators
+			const bool hasAllArguments = stack.size() >= (size_t)effect.Pops;
+			const size_t firstArgument = hasAllArguments ? stack.size() - effect.Pops : 0;
+			const size_t begin = (hasAllArguments && effect.Pops > 0) ? stack[firstArgument].Begin : out.size();
+			bool isRemovable = hasAllArguments && effect.IsPure && begin >= barrier;
+			bool isConstant = hasAllArguments;
+			std::vector<int64_t> key = { (int64_t)instruction.m_Instruction, instruction.m_Args[0] };
+			std::vector<int64_t> constants;
+			for (size_t i = firstArgument; i < stack.size(); i++)
+			{
+				isRemovable &= stack[i].IsRemovable;
+				key.push_back(stack[i].ID);
+				auto constant = constantValues.find(stack[i].ID);
+				if (constant != constantValues.end()) constants.push_back(constant->second);
+				else isConstant = false;
+			}
+			stack.resize(firstArgument);
+
+			if (!effect.IsPure || effect.Pushes != 1)
+			{
+				// Impure calls may change anything a pure call reads
+				if (!effect.IsPure) cache.clear();
+				out.push_back(instruction);
+				barrier = out.size();
+				if (effect.Pushes > 0) stack.push_back({ nextID++, out.size() - 1, false });
+				continue;
+			}
+
+			if (isRemovable && isConstant && instruction.m_Instruction == EScriptInstruction::CallNativeFunction)
+			{
+				auto folder = GetConstantFolders().find((size_t)instruction.m_Args[0]);
+				if (folder != GetConstantFolders().end())
+				{
+					const int64_t value = folder->second(constants.data());
+					truncate(begin);
+					stack.push_back({ getConstantID(value), out.size(), true });
+					out.push_back(ScriptInstruction(EScriptInstruction::PushConstant, { value }));
+					stats.ConstantsFolded++;
+					continue;
+				}
+			}
+
+			auto cached = cache.find(key);
+			if (isRemovable && cached != cache.end() && cached->second.Store < begin)
+			{
+				const CachedValue value = cached->second;
+				truncate(begin);
+				stack.push_back({ value.ID, out.size(), true });
+				out.push_back(ScriptInstruction(EScriptInstruction::PushLocalVar, { (int64_t)value.LocalVar }));
+				stats.SubexpressionsReused++;
+				continue;
+			}
+
+			const uint32_t id = nextID++;
+			out.push_back(instruction);
+			stack.push_back({ id, begin, isRemovable });
+
+			// Keep a copy for later identical calls, CleanUp removes the copies nobody reads
+			const uint32_t localVar = localVarCount++;
+			out.push_back(ScriptInstruction(EScriptInstruction::UpStack));
+			out.push_back(ScriptInstruction(EScriptInstruction::PushToLocalVar, { (int64_t)localVar }));
+			cache[key] = { id, localVar, out.size() - 1 };
+		}
+
+		func.m_Instructions = std::move(out);
+		func.m_LocalVarCount = localVarCount;
+		return true;
+	}
+
+	bool ScriptOptimizer::CleanUp(ScriptFunction& func, ScriptOptimizerStats& stats)
+	{
+		// Counts only go down during a pass, so stale counts are conservative
+		std::vector<uint32_t> reads(func.m_LocalVarCount, 0);
+		std::vector<uint32_t> writes(func.m_LocalVarCount, 0);
+		for (const ScriptInstruction& instruction : func.m_Instructions)
+		{
+			if (instruction.m_Instruction == EScriptInstruction::PushLocalVar) reads[instruction.m_Args[0]]++;
+			if (instruction.m_Instruction == EScriptInstruction::PushToLocalVar) writes[instruction.m_Args[0]]++;
+		}
+
+		bool changed = false;
+		std::vector<ScriptInstruction> out;
+		out.reserve(func.m_Instructions.size());
+		for (ScriptInstruction instruction : func.m_Instructions)
+		{
+			// Dead store
+			if (instruction.m_Instruction == EScriptInstruction::PushToLocalVar && reads[instruction.m_Args[0]] == 0)
+			{
+				instruction = ScriptInstruction(EScriptInstruction::Pop);
+				stats.StoresRemoved++;
+				changed = true;
+			}
+
+			if (!out.empty() && instruction.m_Instruction == EScriptInstruction::Pop)
+			{
+				// Pushed and immediately popped
+				if (IsPushWithoutSideEffects(out.back().m_Instruction))
+				{
+					out.pop_back();
+					stats.PeepholesApplied++;
+					changed = true;
+					continue;
+				}
+				// The result of a pure call is discarded, so are its arguments
+				StackEffect effect;
+				if (GetStackEffect(out.back(), effect) && effect.IsPure && effect.Pushes == 1)
+				{
+					out.pop_back();
+					for (int32_t i = 0; i < effect.Pops; i++) out.push_back(ScriptInstruction(EScriptInstruction::Pop));
+					stats.PeepholesApplied++;
+					changed = true;
+					continue;
+				}
+			}
+
+			// A single-use local that is read right after it is written can stay on the stack
+			if (!out.empty() && instruction.m_Instruction == EScriptInstruction::PushLocalVar && out.back().m_Instruction == EScriptInstruction::PushToLocalVar
+				&& out.back().m_Args[0] == instruction.m_Args[0] && reads[instruction.m_Args[0]] == 1 && writes[instruction.m_Args[0]] == 1)
+			{
+				out.pop_back();
+				stats.PeepholesApplied++;
+				changed = true;
+				continue;
+			}
+
+			out.push_back(instruction);
+		}
+
+		func.m_Instructions = std::move(out);
+		return changed;
+	}
+
+	void ScriptOptimizer::CompactLocalVars(ScriptFunction& func)
+	{
+		std::vector<int64_t> remap(func.m_LocalVarCount, -1);
+		int64_t localVarCount = 0;
+		for (ScriptInstruction& instruction : func.m_Instructions)
+		{
+			if (instruction.m_Instruction == EScriptInstruction::PushLocalVar || instruction.m_Instruction == EScriptInstruction::PushToLocalVar)
+			{
+				int64_t& localVar = remap[instruction.m_Args[0]];
+				if (localVar < 0) localVar = localVarCount++;
+				instruction.m_Args[0] = localVar;
+			}
+		}
+		func.m_LocalVarCount = (uint32_t)localVarCount;
+	}
+
+}
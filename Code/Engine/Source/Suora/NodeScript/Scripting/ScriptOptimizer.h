@@ -0,0 +1,66 @@
+#pragma once
+#include <functional>
+#include <cstdint>
+#include "Suora/Common/StringUtils.h"
+
+namespace Suora
+{
+	struct ScriptFunction;
+	struct ScriptInstruction;
+
+	struct ScriptOptimizerStats
+	{
+		uint32_t Functions = 0;
+		uint32_t InstructionsBefore = 0;
+		uint32_t InstructionsAfter = 0;
+		uint32_t LocalVarsBefore = 0;
+		uint32_t LocalVarsAfter = 0;
+		uint32_t ConstantsFolded = 0;
+		uint32_t SubexpressionsReused = 0;
+		uint32_t StoresRemoved = 0;
+		uint32_t PeepholesApplied = 0;
+		/** Functions that were kept unoptimized because they (or the optimized version) failed the Verifier */
+		uint32_t VerificationFailures = 0;
+
+		ScriptOptimizerStats& operator+=(const ScriptOptimizerStats& other);
+	};
+
+	/** Evaluates a pure NativeFunction on constant stack values, the arguments are in push order */
+	using ScriptConstantFolder = std::function<int64_t(const int64_t* args)>;
+
+	/* Optimizes the bytecode generated by the BlueprintCompiler. The compiler emits the whole subtree of a pure Node for
+	 * every consumer, so the optimizer:
+	 *  - folds pure NativeFunctions with a registered ScriptConstantFolder if all arguments are constants,
+	 *  - reuses the result of identical pure calls through a local variable, until the next impure call,
+	 *  - replaces stores to locals that are never read and removes the pushes they consumed,
+	 *  - fuses PushToLocalVar/PushLocalVar pairs of single-use locals and compacts the local variables.
+	 * Functions containing jumps are only verified. If the result fails the Verifier, the original function is kept. */
+	class ScriptOptimizer
+	{
+	public:
+		/** Returns true if the function was changed */
+		static bool Optimize(ScriptFunction& func, ScriptOptimizerStats* stats = nullptr);
+
+		/** Checks instructions, NativeFunction hashes, local variable indices, jump targets and the stack balance */
+		static bool Verify(const ScriptFunction& func, String* error = nullptr);
+
+		static void RegisterConstantFolder(size_t nativeHash, const ScriptConstantFolder& folder);
+
+		inline static bool s_Enabled = true;
+
+	private:
+		struct StackEffect
+		{
+			int32_t Pops = 0;
+			int32_t Pushes = 0;
+			bool IsPure = false;
+		};
+		static bool GetStackEffect(const ScriptInstruction& instruction, StackEffect& effect);
+		static bool Analyze(const ScriptFunction& func, String* error, int32_t& netStackEffect);
+
+		static bool Rewrite(ScriptFunction& func, ScriptOptimizerStats& stats);
+		static bool CleanUp(ScriptFunction& func, ScriptOptimizerStats& stats);
+		static void CompactLocalVars(ScriptFunction& func);
+	};
+
+}
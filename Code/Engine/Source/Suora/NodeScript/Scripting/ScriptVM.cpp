@@ -5,6 +5,7 @@
 #include "Suora/Serialization/Yaml.h"
 #include "Suora/Core/Object/Object.h"
 #include "Suora/Common/VectorUtils.h"
+#include "Suora/Debug/Profiler.h"
 
 namespace Suora
 {
@@ -25,6 +26,7 @@ namespace Suora
 
 	void ScriptFunction::Call(Object* obj, ScriptStack& stack)
 	{
+		SUORA_PROFILE_SCOPE("ScriptFunction::Call");
 		std::vector<int64_t> LocalVars = std::vector<int64_t>(m_LocalVarCount);
 		
 		// Switch-Statement PreAllocations
@@ -1,6 +1,7 @@
 #include "Precompiled.h"
 #include "ShaderNodeGraph.h"
 #include "Suora/Assets/ShaderGraph.h"
+#include "Suora/Assets/DerivedDataCache.h"
 
 namespace Suora
 {
@@ -316,6 +317,11 @@ namespace Suora
 	/*********************************************************************/
 
 	String ShaderGraphCompiler::CompileShaderNode(VisualNode& node, VisualNodePin& pin, bool vertex, bool& error)
+	{
+		return CompileNodeExpression(node, pin, vertex, error, [vertex, &error](VisualNodePin& input) { return CompilePin(input, vertex, error); });
+	}
+
+	String ShaderGraphCompiler::CompileNodeExpression(VisualNode& node, VisualNodePin& pin, bool vertex, bool& error, const std::function<String(VisualNodePin&)>& compilePin)
 	{
 		int outPinIndex = node.m_OutputPins.IndexOf(pin);
 
@@ -326,31 +332,31 @@ namespace Suora
 
 		if (node.m_NodeID == 100)
 		{
-			return "vec3(" + CompilePin(node.m_InputPins[0], vertex, error) + ", "
-				+ CompilePin(node.m_InputPins[1], vertex, error) + ", "
-				+ CompilePin(node.m_InputPins[2], vertex, error) + ")";
+			return "vec3(" + compilePin(node.m_InputPins[0]) + ", "
+				+ compilePin(node.m_InputPins[1]) + ", "
+				+ compilePin(node.m_InputPins[2]) + ")";
 		}
 		if (node.m_NodeID == 101)
 		{
-			return "vec4(" + CompilePin(node.m_InputPins[0], vertex, error) + ", "
-				+ CompilePin(node.m_InputPins[1], vertex, error) + ", "
-				+ CompilePin(node.m_InputPins[2], vertex, error) + ", "
-				+ CompilePin(node.m_InputPins[3], vertex, error) + ")";
+			return "vec4(" + compilePin(node.m_InputPins[0]) + ", "
+				+ compilePin(node.m_InputPins[1]) + ", "
+				+ compilePin(node.m_InputPins[2]) + ", "
+				+ compilePin(node.m_InputPins[3]) + ")";
 		}
 		if (node.m_NodeID == 102)
 		{
 			if (outPinIndex == 0)
 			{
-				return "texture(" + CompilePin(node.m_InputPins[0], vertex, error) + ", " + CompilePin(node.m_InputPins[1], vertex, error) + ")";
+				return "texture(" + compilePin(node.m_InputPins[0]) + ", " + compilePin(node.m_InputPins[1]) + ")";
 			}
 			else if (outPinIndex == 1)
 			{
-				return "(texture(" + CompilePin(node.m_InputPins[0], vertex, error) + ", " + CompilePin(node.m_InputPins[1], vertex, error) + ").xyz)";
+				return "(texture(" + compilePin(node.m_InputPins[0]) + ", " + compilePin(node.m_InputPins[1]) + ").xyz)";
 			}
-			else if (outPinIndex == 2) { return "(texture(" + CompilePin(node.m_InputPins[0], vertex, error) + ", " + CompilePin(node.m_InputPins[1], vertex, error) + ").x)"; }
-			else if (outPinIndex == 3) { return "(texture(" + CompilePin(node.m_InputPins[0], vertex, error) + ", " + CompilePin(node.m_InputPins[1], vertex, error) + ").y)"; }
-			else if (outPinIndex == 4) { return "(texture(" + CompilePin(node.m_InputPins[0], vertex, error) + ", " + CompilePin(node.m_InputPins[1], vertex, error) + ").z)"; }
-			else if (outPinIndex == 5) { return "(texture(" + CompilePin(node.m_InputPins[0], vertex, error) + ", " + CompilePin(node.m_InputPins[1], vertex, error) + ").w)"; }
+			else if (outPinIndex == 2) { return "(texture(" + compilePin(node.m_InputPins[0]) + ", " + compilePin(node.m_InputPins[1]) + ").x)"; }
+			else if (outPinIndex == 3) { return "(texture(" + compilePin(node.m_InputPins[0]) + ", " + compilePin(node.m_InputPins[1]) + ").y)"; }
+			else if (outPinIndex == 4) { return "(texture(" + compilePin(node.m_InputPins[0]) + ", " + compilePin(node.m_InputPins[1]) + ").z)"; }
+			else if (outPinIndex == 5) { return "(texture(" + compilePin(node.m_InputPins[0]) + ", " + compilePin(node.m_InputPins[1]) + ").w)"; }
 		}
 		if (node.m_NodeID == 103)
 		{
@@ -359,13 +365,13 @@ namespace Suora
 		}
 		if (node.m_NodeID == 104)
 		{
-			return "(" + CompilePin(node.m_InputPins[0], vertex, error) + ")"
+			return "(" + compilePin(node.m_InputPins[0]) + ")"
 				+ ((outPinIndex == 0) ? ".x" : ".y");
 
 		}
 		if (node.m_NodeID == 105)
 		{
-			return "(SampleNormal(" + CompilePin(node.m_InputPins[0], vertex, error) + ", " + CompilePin(node.m_InputPins[2], vertex, error) + ") * " + CompilePin(node.m_InputPins[1], vertex, error) + ")";
+			return "(SampleNormal(" + compilePin(node.m_InputPins[0]) + ", " + compilePin(node.m_InputPins[2]) + ") * " + compilePin(node.m_InputPins[1]) + ")";
 
 		}
 		if (node.m_NodeID == 106)
@@ -375,40 +381,40 @@ namespace Suora
 
 		if (node.m_NodeID == 107)
 		{
-			return "(" + CompilePin(node.m_InputPins[3], vertex, error) + " + (" + CompilePin(node.m_InputPins[0], vertex, error) + " - " + CompilePin(node.m_InputPins[1], vertex, error) + ") * (" + CompilePin(node.m_InputPins[4], vertex, error) + " - " + CompilePin(node.m_InputPins[3], vertex, error) + ") / (" + CompilePin(node.m_InputPins[2], vertex, error) + " - " + CompilePin(node.m_InputPins[1], vertex, error) + "))";
+			return "(" + compilePin(node.m_InputPins[3]) + " + (" + compilePin(node.m_InputPins[0]) + " - " + compilePin(node.m_InputPins[1]) + ") * (" + compilePin(node.m_InputPins[4]) + " - " + compilePin(node.m_InputPins[3]) + ") / (" + compilePin(node.m_InputPins[2]) + " - " + compilePin(node.m_InputPins[1]) + "))";
 		}
 
 		// Multiply
 		if (node.m_NodeID == 1001)
 		{
-			return "((" + CompilePin(node.m_InputPins[0], vertex, error) + ") * (" + CompilePin(node.m_InputPins[1], vertex, error) + "))";
+			return "((" + compilePin(node.m_InputPins[0]) + ") * (" + compilePin(node.m_InputPins[1]) + "))";
 		}
 		if (node.m_NodeID == 1002)
 		{
-			return "((" + CompilePin(node.m_InputPins[0], vertex, error) + ") * (vec3(" + CompilePin(node.m_InputPins[1], vertex, error) + ")))";
+			return "((" + compilePin(node.m_InputPins[0]) + ") * (vec3(" + compilePin(node.m_InputPins[1]) + ")))";
 		}
 		if (node.m_NodeID == 1003)
 		{
-			return "((" + CompilePin(node.m_InputPins[0], vertex, error) + ") * (" + CompilePin(node.m_InputPins[1], vertex, error) + "))";
+			return "((" + compilePin(node.m_InputPins[0]) + ") * (" + compilePin(node.m_InputPins[1]) + "))";
 		}
 		if (node.m_NodeID == 1004)
 		{
-			return "((" + CompilePin(node.m_InputPins[0], vertex, error) + ") * (vec2(" + CompilePin(node.m_InputPins[1], vertex, error) + ")))";
+			return "((" + compilePin(node.m_InputPins[0]) + ") * (vec2(" + compilePin(node.m_InputPins[1]) + ")))";
 		}
 
 		// Cast
 		if (node.m_NodeID == 2001)
 		{
-			return "vec4(" + CompilePin(node.m_InputPins[0], vertex, error) + ", " + CompilePin(node.m_InputPins[1], vertex, error) + ")";
+			return "vec4(" + compilePin(node.m_InputPins[0]) + ", " + compilePin(node.m_InputPins[1]) + ")";
 		}
 
 		if (node.m_NodeID == 10001)
 		{
-			return "min(" + CompilePin(node.m_InputPins[0], vertex, error) + ", " + CompilePin(node.m_InputPins[1], vertex, error) + ")";
+			return "min(" + compilePin(node.m_InputPins[0]) + ", " + compilePin(node.m_InputPins[1]) + ")";
 		}
 		if (node.m_NodeID == 10002)
 		{
-			return "max(" + CompilePin(node.m_InputPins[0], vertex, error) + ", " + CompilePin(node.m_InputPins[1], vertex, error) + ")";
+			return "max(" + compilePin(node.m_InputPins[0]) + ", " + compilePin(node.m_InputPins[1]) + ")";
 		}
 
 		SuoraError("Could not compile ShaderGraph Node! NodeID: {0}", node.m_NodeID);
@@ -421,4 +427,143 @@ namespace Suora
 		return (pin.Target ? CompileShaderNode(*(pin.Target->GetNode()), *(pin.Target), vertex, error) : (std::to_string(StringUtil::StringToFloat(pin.m_AdditionalData))/*pin.m_AdditionalData != "" ? pin.m_AdditionalData : "0.0"*/));
 	}
 
+	uint64_t ShaderGraphCompiler::HashSubgraph(VisualNodePin& pin, bool vertex, std::unordered_map<const VisualNodePin*, uint64_t>& memo)
+	{
+		auto it = memo.find(&pin);
+		if (it != memo.end()) return it->second;
+
+		VisualNode& node = *pin.GetNode();
+		const int32_t outPinIndex = node.m_OutputPins.IndexOf(pin);
+		uint64_t hash = DerivedDataCache::HashBytes(&node.m_NodeID, sizeof(node.m_NodeID));
+		hash = DerivedDataCache::HashBytes(&outPinIndex, sizeof(outPinIndex), hash);
+		hash = DerivedDataCache::HashBytes(&vertex, sizeof(vertex), hash);
+		for (VisualNodePin& input : node.m_InputPins)
+		{
+			if (input.Target)
+			{
+				const uint64_t inputHash = HashSubgraph(*input.Target, vertex, memo);
+				hash = DerivedDataCache::HashBytes(&inputHash, sizeof(inputHash), hash);
+			}
+			else
+			{
+				hash = DerivedDataCache::HashBytes(input.m_AdditionalData.data(), input.m_AdditionalData.size(), hash);
+			}
+			// Separates the pins, so that moving a value from one pin to the next changes the hash
+			hash = DerivedDataCache::HashBytes("|", 1, hash);
+		}
+
+		memo[&pin] = hash;
+		return hash;
+	}
+
+	/*********************************************************************/
+
+	ShaderGraphStageCompiler::ShaderGraphStageCompiler(bool vertex, const Array<int32_t>& blockParents)
+		: m_Vertex(vertex), m_BlockParents(blockParents)
+	{
+	}
+
+	int32_t ShaderGraphStageCompiler::AddRoot(VisualNodePin& pin, int32_t block, int32_t declarationBlock)
+	{
+		const int32_t root = m_Roots.Size();
+		m_Roots.Add(Root{ &pin, block, declarationBlock });
+		if (m_UseCounts[&pin]++ == 0) CountUses(pin);
+		MarkRoot(pin, root);
+		return root;
+	}
+
+	String ShaderGraphStageCompiler::Compile(int32_t root, String& temporaries)
+	{
+		m_CurrentRoot = root;
+		m_Temporaries = &temporaries;
+		String expression = CompileOutput(*m_Roots[root].Pin);
+		m_Temporaries = nullptr;
+		return expression;
+	}
+
+	String ShaderGraphStageCompiler::CompileOutput(VisualNodePin& output)
+	{
+		auto it = m_TemporaryNames.find(&output);
+		if (it != m_TemporaryNames.end()) return it->second;
+
+		String expression = ShaderGraphCompiler::CompileNodeExpression(*output.GetNode(), output, m_Vertex, m_Error, [this](VisualNodePin& input) { return CompileInput(input); });
+		if (m_UseCounts[&output] < 2 || !CanBeTemporary(output))
+		{
+			return expression;
+		}
+
+		// Dependencies were compiled first, so their temporaries are already declared above this one
+		const String name = "sg_Temp" + std::to_string(m_TemporaryCount++);
+		*m_Temporaries += "\t" + ShaderNodeGraph::ShaderGraphDataTypeToString((ShaderGraphDataType)output.PinID) + " " + name + " = " + expression + ";\n";
+		m_TemporaryNames[&output] = name;
+		return name;
+	}
+
+	String ShaderGraphStageCompiler::CompileInput(VisualNodePin& input)
+	{
+		return (input.Target ? CompileOutput(*input.Target) : std::to_string(StringUtil::StringToFloat(input.m_AdditionalData)));
+	}
+
+	void ShaderGraphStageCompiler::CountUses(VisualNodePin& output)
+	{
+		// Walks the Nodes exactly like the code generation does, so every reference in the generated expression is counted
+		bool error = false;
+		ShaderGraphCompiler::CompileNodeExpression(*output.GetNode(), output, m_Vertex, error, [this](VisualNodePin& input)
+		{
+			if (input.Target && m_UseCounts[input.Target]++ == 0) CountUses(*input.Target);
+			return String();
+		});
+	}
+
+	void ShaderGraphStageCompiler::MarkRoot(VisualNodePin& output, int32_t root)
+	{
+		Array<int32_t>& roots = m_RootsOfOutput[&output];
+		if (!roots.IsEmpty() && roots[roots.Last()] == root) return;
+		roots.Add(root);
+
+		bool error = false;
+		ShaderGraphCompiler::CompileNodeExpression(*output.GetNode(), output, m_Vertex, error, [this, root](VisualNodePin& input)
+		{
+			if (input.Target) MarkRoot(*input.Target, root);
+			return String();
+		});
+	}
+
+	bool ShaderGraphStageCompiler::CanBeTemporary(const VisualNodePin& output) const
+	{
+		// Uniforms, UV and FragDepth are cheaper to reference than to copy
+		const int64_t nodeID = output.GetNode()->m_NodeID;
+		if (nodeID == 2 || nodeID == 103 || nodeID == 106) return false;
+
+		// The declaration has to be visible to every later use, and the BaseShader may declare locals (like UV) in
+		// nested blocks, so a temporary can only live in front of the first use
+		const Array<int32_t>& roots = m_RootsOfOutput.at(&output);
+		const int32_t declarationBlock = m_Roots[m_CurrentRoot].DeclarationBlock;
+		if (roots[0] != m_CurrentRoot || declarationBlock == -1) return false;
+		for (int32_t root : roots)
+		{
+			if (!IsInsideBlock(m_Roots[root].Block, declarationBlock)) return false;
+		}
+
+		switch ((ShaderGraphDataType)output.PinID)
+		{
+		case ShaderGraphDataType::Float:
+		case ShaderGraphDataType::Vec2:
+		case ShaderGraphDataType::Vec3:
+		case ShaderGraphDataType::Vec4:
+			return true;
+		default:
+			return false;
+		}
+	}
+
+	bool ShaderGraphStageCompiler::IsInsideBlock(int32_t block, int32_t outer) const
+	{
+		for (; block != -1; block = m_BlockParents[block])
+		{
+			if (block == outer) return true;
+		}
+		return false;
+	}
+
 }
\ No newline at end of file
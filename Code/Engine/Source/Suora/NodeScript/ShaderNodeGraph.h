@@ -1,6 +1,8 @@
 #pragma once
 
 #include "NodeGraph.h"
+#include <functional>
+#include <unordered_map>
 
 namespace Suora
 {
@@ -8,8 +10,59 @@ namespace Suora
 
 	struct ShaderGraphCompiler
 	{
+		/** Compiles the output pin into a single expression, shared Nodes are compiled again for every consumer */
 		static String CompileShaderNode(VisualNode& node, VisualNodePin& pin, bool vertex, bool& error);
 		static String CompilePin(VisualNodePin& pin, bool vertex, bool& error);
+
+		/** Builds the expression of an output pin, the input pins are compiled through compilePin */
+		static String CompileNodeExpression(VisualNode& node, VisualNodePin& pin, bool vertex, bool& error, const std::function<String(VisualNodePin&)>& compilePin);
+		/** Hashes the subgraph that feeds the output pin (NodeIDs, connections and unconnected pin values) */
+		static uint64_t HashSubgraph(VisualNodePin& pin, bool vertex, std::unordered_map<const VisualNodePin*, uint64_t>& memo);
+	};
+
+	/** Compiles the inputs of one shader stage as a DAG: Node outputs that are consumed more than once are emitted
+	 *  only once, into a temporary that is declared in front of the statement of their first use. Outputs whose later
+	 *  uses are outside of that block are inlined instead. */
+	struct ShaderGraphStageCompiler
+	{
+		/** blockParents is the nesting of the blocks of the BaseShader, see ShaderGraphTemplate::BlockParents */
+		ShaderGraphStageCompiler(bool vertex, const Array<int32_t>& blockParents);
+
+		/** Registers the pin of an input in the block 'block', temporaries that are first used by it are declared in
+		 *  'declarationBlock' (-1 disables them). All roots have to be added in source order before the first Compile(). */
+		int32_t AddRoot(VisualNodePin& pin, int32_t block, int32_t declarationBlock);
+		/** Compiles the roots in the order they were added, the temporaries a root declares are appended to 'temporaries' */
+		String Compile(int32_t root, String& temporaries);
+
+		uint32_t GetTemporaryCount() const { return m_TemporaryCount; }
+		bool HasError() const { return m_Error; }
+
+	private:
+		struct Root
+		{
+			VisualNodePin* Pin = nullptr;
+			int32_t Block = -1;
+			int32_t DeclarationBlock = -1;
+		};
+
+		String CompileOutput(VisualNodePin& output);
+		String CompileInput(VisualNodePin& input);
+		void CountUses(VisualNodePin& output);
+		void MarkRoot(VisualNodePin& output, int32_t root);
+		bool CanBeTemporary(const VisualNodePin& output) const;
+		bool IsInsideBlock(int32_t block, int32_t outer) const;
+
+		bool m_Vertex = false;
+		bool m_Error = false;
+		Array<int32_t> m_BlockParents;
+		Array<Root> m_Roots;
+		int32_t m_CurrentRoot = -1;
+		String* m_Temporaries = nullptr;
+		uint32_t m_TemporaryCount = 0;
+		std::unordered_map<const VisualNodePin*, uint32_t> m_UseCounts;
+		/** The roots that reach an output, in ascending order */
+		std::unordered_map<const VisualNodePin*, Array<int32_t>> m_RootsOfOutput;
+		std::unordered_map<const VisualNodePin*, String> m_TemporaryNames;
 	};
 
 	struct ShaderNodeGraph : VisualNodeGraph
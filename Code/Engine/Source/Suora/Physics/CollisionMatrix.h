@@ -0,0 +1,80 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <utility>
+
+namespace Suora::Physics
+{
+
+	/* Which physics layers collide with each other. Always symmetric.
+	 * Filled from the ProjectSettings and read by the physics backends, also from their worker threads while a Step runs.
+	 * The masks are atomic words, so editing the matrix during a Step is safe. A pair may see the old or new state for that Step. */
+	class CollisionMatrix
+	{
+	public:
+		static constexpr uint32_t s_LayerCount = 16;
+		static constexpr uint32_t s_AllLayers = (1u << s_LayerCount) - 1;
+
+		static bool ShouldCollide(uint32_t layerA, uint32_t layerB)
+		{
+			return (GetMask(layerA) & (1u << (layerB % s_LayerCount))) != 0;
+		}
+		static void SetShouldCollide(uint32_t layerA, uint32_t layerB, bool collide)
+		{
+			layerA %= s_LayerCount;
+			layerB %= s_LayerCount;
+			if (collide)
+			{
+				s_Masks[layerA].fetch_or(1u << layerB, std::memory_order_relaxed);
+				s_Masks[layerB].fetch_or(1u << layerA, std::memory_order_relaxed);
+			}
+			else
+			{
+				s_Masks[layerA].fetch_and(~(1u << layerB), std::memory_order_relaxed);
+				s_Masks[layerB].fetch_and(~(1u << layerA), std::memory_order_relaxed);
+			}
+		}
+
+		/** Bit i is set, if the layer collides with layer i */
+		static uint32_t GetMask(uint32_t layer)
+		{
+			return s_Masks[layer % s_LayerCount].load(std::memory_order_relaxed);
+		}
+		static std::array<uint32_t, s_LayerCount> GetMasks()
+		{
+			std::array<uint32_t, s_LayerCount> masks;
+			for (uint32_t i = 0; i < s_LayerCount; i++)
+			{
+				masks[i] = GetMask(i);
+			}
+			return masks;
+		}
+		/** Two layers only collide if both masks agree */
+		static void SetMasks(const std::array<uint32_t, s_LayerCount>& masks)
+		{
+			for (uint32_t a = 0; a < s_LayerCount; a++)
+			{
+				uint32_t mask = 0;
+				for (uint32_t b = 0; b < s_LayerCount; b++)
+				{
+					if ((masks[a] & (1u << b)) && (masks[b] & (1u << a)))
+					{
+						mask |= (1u << b);
+					}
+				}
+				s_Masks[a].store(mask, std::memory_order_relaxed);
+			}
+		}
+
+	private:
+		template<size_t... Layers>
+		static std::array<std::atomic<uint32_t>, s_LayerCount> AllLayersCollide(std::index_sequence<Layers...>)
+		{
+			return { ((void)Layers, s_AllLayers)... };
+		}
+
+		inline static std::array<std::atomic<uint32_t>, s_LayerCount> s_Masks = AllLayersCollide(std::make_index_sequence<s_LayerCount>());
+	};
+
+}
\ No newline at end of file
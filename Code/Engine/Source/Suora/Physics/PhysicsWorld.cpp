@@ -4,12 +4,14 @@
 
 #include "Suora/GameFramework/World.h"
 #include "Suora/GameFramework/Nodes/ShapeNodes.h"
+#include "Suora/Debug/Profiler.h"
 
 namespace Suora::Physics
 {
 
 	void PhysicsWorld::Update(float deltaTime)
 	{
+		SUORA_PROFILE_SCOPE("PhysicsWorld::Update");
 		s_InPhysicsSimulation = true;
 
 		m_Accumulator += deltaTime;
@@ -17,8 +19,15 @@ namespace Suora::Physics
 		{
 			Step(m_TimeStep);
 			m_Accumulator -= m_TimeStep;
+
+			// Outside of the simulation, so that transform changes made by gameplay code reach the physics bodies
+			s_InPhysicsSimulation = false;
+			DispatchContactEvents();
+			s_InPhysicsSimulation = true;
 		}
 
+		WriteBackTransforms(m_InterpolateTransforms ? glm::clamp(m_Accumulator / m_TimeStep, 0.0f, 1.0f) : 1.0f);
+
 		s_InPhysicsSimulation = false;
 
 	}
@@ -29,5 +38,88 @@ namespace Suora::Physics
 		return false;
 	}
 
+	bool PhysicsWorld::RaycastAll(const Vec3& start, const Vec3& end, Array<HitResult>& results, const RaycastParams& params)
+	{
+		SuoraVerify(false, "Not implemented!");
+		return false;
+	}
+
+	bool PhysicsWorld::ShapeCast(const ShapeCastQuery& query, HitResult& result, const RaycastParams& params)
+	{
+		SuoraVerify(false, "Not implemented!");
+		return false;
+	}
+
+	bool PhysicsWorld::Overlap(const OverlapQuery& query, Array<ShapeNode*>& results, const RaycastParams& params)
+	{
+		SuoraVerify(false, "Not implemented!");
+		return false;
+	}
+
+	void PhysicsWorld::RaycastBatch(const Array<RaycastQuery>& queries, Array<HitResult>& results, const RaycastParams& params)
+	{
+		results.GetData().assign(queries.Size(), HitResult());
+		for (int32_t i = 0; i < queries.Size(); i++)
+		{
+			results[i].Hit = Raycast(queries[i].Start, queries[i].End, results[i], params);
+		}
+	}
+
+	void PhysicsWorld::ShapeCastBatch(const Array<ShapeCastQuery>& queries, Array<HitResult>& results, const RaycastParams& params)
+	{
+		results.GetData().assign(queries.Size(), HitResult());
+		for (int32_t i = 0; i < queries.Size(); i++)
+		{
+			results[i].Hit = ShapeCast(queries[i], results[i], params);
+		}
+	}
+
+	void PhysicsWorld::OverlapBatch(const Array<OverlapQuery>& queries, Array<Array<ShapeNode*>>& results, const RaycastParams& params)
+	{
+		results.GetData().assign(queries.Size(), Array<ShapeNode*>());
+		for (int32_t i = 0; i < queries.Size(); i++)
+		{
+			Overlap(queries[i], results[i], params);
+		}
+	}
+
+	static void DispatchContactToShape(ShapeNode* shape, ShapeNode* other, ContactPhase phase)
+	{
+		switch (phase)
+		{
+		case ContactPhase::Enter: if (shape->IsTrigger()) shape->OnTriggerEnter(other); else shape->OnCollisionEnter(other); break;
+		case ContactPhase::Stay:  if (shape->IsTrigger()) shape->OnTriggerStay(other);  else shape->OnCollisionStay(other);  break;
+		case ContactPhase::Exit:  if (shape->IsTrigger()) shape->OnTriggerExit(other);  else shape->OnCollisionExit(other);  break;
+		}
+	}
+
+	void PhysicsWorld::DispatchContact(ShapeNode* shapeA, ShapeNode* shapeB, ContactPhase phase, const ContactInfo& contact)
+	{
+		if (!shapeA || !shapeB || (shapeA->IsTrigger() && shapeB->IsTrigger()))
+		{
+			return;
+		}
+		if (shapeA->IsPendingKill() || shapeB->IsPendingKill())
+		{
+			return;
+		}
+		if (m_ContactFilter && !m_ContactFilter(shapeA, shapeB))
+		{
+			return;
+		}
+
+		shapeA->m_CurrentContact = contact;
+		DispatchContactToShape(shapeA, shapeB, phase);
+
+		// shapeA's Delegates may have destroyed shapeB
+		if (shapeB->IsPendingKill())
+		{
+			return;
+		}
+		shapeB->m_CurrentContact = contact;
+		shapeB->m_CurrentContact.Normal = -contact.Normal;
+		DispatchContactToShape(shapeB, shapeA, phase);
+	}
+
 
 }
\ No newline at end of file
@@ -1,10 +1,12 @@
 #pragma once
 #include <unordered_map>
+#include <functional>
 #include "Suora/Core/Base.h"
 #include "Suora/Common/VectorUtils.h"
 #include "Suora/Common/Array.h"
 #include "Suora/Common/Math.h"
 #include "Suora/Core/Object/Pointer.h"
+#include "CollisionMatrix.h"
 #include "PhysicsWorld.generated.h"
 
 namespace Suora
@@ -18,11 +20,36 @@ namespace Suora
 
 	struct HitResult;
 	struct RaycastParams;
+	struct RaycastQuery;
+	struct ShapeCastQuery;
+	struct OverlapQuery;
+	struct ContactInfo;
 }
 
 namespace Suora::Physics
 {
 
+	enum class ContactPhase : uint8_t
+	{
+		Enter = 0,
+		Stay,
+		Exit
+	};
+
+	struct PhysicsStats
+	{
+		uint32_t BodyCount = 0;
+		uint32_t ActiveBodyCount = 0;
+		/** Body pairs the broadphase tested against the CollisionMatrix in the last Step, requires s_CollectStats */
+		uint32_t BroadphasePairTests = 0;
+		/** Pairs of BroadphasePairTests, that were rejected by the CollisionMatrix */
+		uint32_t BroadphasePairsRejected = 0;
+		/** Body pairs that were touching after the last Step */
+		uint32_t ContactPairs = 0;
+		/** Broadphase, narrowphase and solver of the last Step */
+		float SimulationTimeMs = 0.0f;
+	};
+
 	class PhysicsWorld : public Object
 	{
 		SUORA_CLASS(42387984338);
@@ -42,12 +69,42 @@ namespace Suora::Physics
 		}
 
 		virtual bool Raycast(const Vec3& start, const Vec3& end, HitResult& result, const RaycastParams& params);
+		/** All hits along the ray, sorted by distance */
+		virtual bool RaycastAll(const Vec3& start, const Vec3& end, Array<HitResult>& results, const RaycastParams& params);
+		/** Sweeps the shape from query.Start to query.End and reports the first hit */
+		virtual bool ShapeCast(const ShapeCastQuery& query, HitResult& result, const RaycastParams& params);
+		/** All ShapeNodes that intersect the shape, each reported once */
+		virtual bool Overlap(const OverlapQuery& query, Array<ShapeNode*>& results, const RaycastParams& params);
+
+		// Batched queries: results[i] belongs to queries[i]. Backends resolve them in parallel, the fallback runs them one by one.
+		virtual void RaycastBatch(const Array<RaycastQuery>& queries, Array<HitResult>& results, const RaycastParams& params);
+		virtual void ShapeCastBatch(const Array<ShapeCastQuery>& queries, Array<HitResult>& results, const RaycastParams& params);
+		virtual void OverlapBatch(const Array<OverlapQuery>& queries, Array<Array<ShapeNode*>>& results, const RaycastParams& params);
 
 		Vec3 m_Gravity = Vec3(0, -9.81f, 0);
 
 		float m_Accumulator = 0.0f;
 		float m_TimeStep = 1.0f / 60.0f;
 		inline static bool s_InPhysicsSimulation = false;
+		/** Moving bodies are written back interpolated between the last two Steps, which smooths out the fixed timestep */
+		bool m_InterpolateTransforms = true;
+
+		const PhysicsStats& GetStats() const { return m_Stats; }
+		/** Counting broadphase pairs is done in the innermost loop of the broadphase, so it is opt-in */
+		inline static bool s_CollectStats = false;
+
+		/** Optional per-pair filter, evaluated on the main thread before the contact events of a pair are dispatched */
+		std::function<bool(ShapeNode*, ShapeNode*)> m_ContactFilter;
+
+	protected:
+		/** Called on the main thread after every Step, gameplay code may freely mutate the World in here */
+		virtual void DispatchContactEvents() { }
+		/** Called once per Update after all Steps. alpha in [0, 1] is the progress from the previous to the last Step. */
+		virtual void WriteBackTransforms(float alpha) { }
+		/** Invokes the Trigger/Collision Delegates of both ShapeNodes. The contact is seen from shapeA. */
+		void DispatchContact(ShapeNode* shapeA, ShapeNode* shapeB, ContactPhase phase, const ContactInfo& contact);
+
+		PhysicsStats m_Stats;
 
 	private:
 
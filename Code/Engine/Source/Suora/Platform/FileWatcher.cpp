@@ -0,0 +1,394 @@
+#include "Precompiled.h"
+#include "FileWatcher.h"
+#include "Platform.h"
+
+#if defined(SUORA_PLATFORM_LINUX)
+	#include <sys/inotify.h>
+	#include <sys/eventfd.h>
+	#include <poll.h>
+	#include <unistd.h>
+	#include <errno.h>
+#endif
+
+namespace Suora
+{
+
+	FileWatcher::FileWatcher(const std::filesystem::path& directory, bool recursive)
+		: m_Directory(directory), m_Recursive(recursive)
+	{
+		m_NativeBackend = InitNativeBackend();
+		if (!m_NativeBackend)
+		{
+			SuoraWarn("FileWatcher: No native backend available for '{0}', falling back to polling.", m_Directory.string());
+		}
+
+		m_Running = true;
+		m_Thread = std::thread([this]()
+		{
+			if (m_NativeBackend) RunNativeBackend();
+			else RunPollingBackend();
+		});
+	}
+
+	FileWatcher::~FileWatcher()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_StopMutex);
+			m_Running = false;
+		}
+		m_StopCondition.notify_all();
+#if defined(SUORA_PLATFORM_WINDOWS)
+		if (m_StopEvent) SetEvent((HANDLE)m_StopEvent);
+#elif defined(SUORA_PLATFORM_LINUX)
+		if (m_WakeHandle >= 0)
+		{
+			const uint64_t wake = 1;
+			[[maybe_unused]] const ssize_t written = write(m_WakeHandle, &wake, sizeof(wake));
+		}
+#endif
+
+		if (m_Thread.joinable())
+		{
+			m_Thread.join();
+		}
+
+		if (m_NativeBackend)
+		{
+			ShutdownNativeBackend();
+		}
+	}
+
+	Array<FileWatchEvent> FileWatcher::PollEvents()
+	{
+		Array<FileWatchEvent> events;
+		const float now = Platform::GetTime();
+
+		std::lock_guard<std::mutex> lock(m_EventMutex);
+		for (auto It = m_PendingEvents.begin(); It != m_PendingEvents.end();)
+		{
+			if (now - It->second.LastChangeTime >= s_SettleTime)
+			{
+				events.Add(It->second.Event);
+				It = m_PendingEvents.erase(It);
+			}
+			else
+			{
+				It++;
+			}
+		}
+
+		return events;
+	}
+
+	void FileWatcher::PushEvent(const std::filesystem::path& path, FileWatchAction action)
+	{
+		const float now = Platform::GetTime();
+		const String key = path.lexically_normal().generic_string();
+
+		std::lock_guard<std::mutex> lock(m_EventMutex);
+		auto It = m_PendingEvents.find(key);
+		if (It == m_PendingEvents.end())
+		{
+			m_PendingEvents[key] = PendingEvent{ FileWatchEvent{ path, action, now }, now };
+			return;
+		}
+
+		// Coalesce with the pending Event of the same path
+		FileWatchEvent& pending = It->second.Event;
+		It->second.LastChangeTime = now;
+
+		if (pending.m_Action == FileWatchAction::Rescan || action == FileWatchAction::Rescan)
+		{
+			pending.m_Action = FileWatchAction::Rescan;
+		}
+		else if (pending.m_Action == FileWatchAction::Added && action == FileWatchAction::Removed)
+		{
+			// The file only existed temporarily
+			m_PendingEvents.erase(It);
+		}
+		else if (pending.m_Action == FileWatchAction::Removed && action != FileWatchAction::Removed)
+		{
+			// Replaced, e.g. by saving to a temporary file and renaming it afterwards
+			pending.m_Action = FileWatchAction::Modified;
+		}
+		else if (pending.m_Action != FileWatchAction::Added)
+		{
+			// An added file stays added, however often it is written afterwards
+			pending.m_Action = action;
+		}
+	}
+
+	void FileWatcher::RunPollingBackend()
+	{
+		std::unordered_map<String, std::filesystem::file_time_type> snapshot;
+
+		auto scan = [this]()
+		{
+			std::unordered_map<String, std::filesystem::file_time_type> entries;
+			std::error_code error;
+			auto add = [&entries](const std::filesystem::directory_entry& entry)
+			{
+				std::error_code timeError;
+				const auto time = entry.last_write_time(timeError);
+				entries[entry.path().generic_string()] = timeError ? std::filesystem::file_time_type() : time;
+			};
+			if (m_Recursive)
+			{
+				for (auto it = std::filesystem::recursive_directory_iterator(m_Directory, error); !error && it != std::filesystem::recursive_directory_iterator(); it.increment(error)) add(*it);
+			}
+			else
+			{
+				for (auto it = std::filesystem::directory_iterator(m_Directory, error); !error && it != std::filesystem::directory_iterator(); it.increment(error)) add(*it);
+			}
+			return entries;
+		};
+
+		snapshot = scan();
+
+		while (m_Running)
+		{
+			{
+				std::unique_lock<std::mutex> lock(m_StopMutex);
+				m_StopCondition.wait_for(lock, std::chrono::duration<float>(s_PollingInterval), [this]() { return !m_Running; });
+			}
+			if (!m_Running) break;
+
+			std::unordered_map<String, std::filesystem::file_time_type> current = scan();
+			for (const auto& It : current)
+			{
+				auto previous = snapshot.find(It.first);
+				if (previous == snapshot.end()) PushEvent(It.first, FileWatchAction::Added);
+				else if (previous->second != It.second) PushEvent(It.first, FileWatchAction::Modified);
+			}
+			for (const auto& It : snapshot)
+			{
+				if (current.find(It.first) == current.end()) PushEvent(It.first, FileWatchAction::Removed);
+			}
+			snapshot = std::move(current);
+		}
+	}
+
+#if defined(SUORA_PLATFORM_LINUX)
+
+	static constexpr uint32_t s_NotifyMask = IN_CREATE | IN_DELETE | IN_MODIFY | IN_CLOSE_WRITE | IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF | IN_ATTRIB;
+
+	static void AddNotifyWatch(int notifyHandle, std::unordered_map<int, std::filesystem::path>& watches, const std::filesystem::path& directory, bool recursive)
+	{
+		const int watch = inotify_add_watch(notifyHandle, directory.string().c_str(), s_NotifyMask);
+		if (watch < 0)
+		{
+			SuoraWarn("FileWatcher: Cannot watch '{0}' (errno {1})", directory.string(), errno);
+			return;
+		}
+		watches[watch] = directory;
+
+		if (!recursive) return;
+
+		std::error_code error;
+		for (auto it = std::filesystem::directory_iterator(directory, error); !error && it != std::filesystem::directory_iterator(); it.increment(error))
+		{
+			if (it->is_directory(error)) AddNotifyWatch(notifyHandle, watches, it->path(), recursive);
+		}
+	}
+
+	bool FileWatcher::InitNativeBackend()
+	{
+		m_NotifyHandle = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+		if (m_NotifyHandle < 0)
+		{
+			return false;
+		}
+
+		AddNotifyWatch(m_NotifyHandle, m_NotifyWatches, m_Directory, m_Recursive);
+		m_WakeHandle = eventfd(0, EFD_CLOEXEC);
+		if (m_NotifyWatches.empty() || m_WakeHandle < 0)
+		{
+			ShutdownNativeBackend();
+			return false;
+		}
+		return true;
+	}
+
+	void FileWatcher::ShutdownNativeBackend()
+	{
+		if (m_NotifyHandle >= 0)
+		{
+			close(m_NotifyHandle);
+			m_NotifyHandle = -1;
+		}
+		if (m_WakeHandle >= 0)
+		{
+			close(m_WakeHandle);
+			m_WakeHandle = -1;
+		}
+		m_NotifyWatches.clear();
+	}
+
+	void FileWatcher::RunNativeBackend()
+	{
+		alignas(inotify_event) char buffer[64 * 1024];
+
+		while (m_Running)
+		{
+			// The destructor signals m_WakeHandle, so shutting down does not wait for a timeout
+			pollfd descriptors[2] = { { m_NotifyHandle, POLLIN, 0 }, { m_WakeHandle, POLLIN, 0 } };
+			if (poll(descriptors, 2, -1) <= 0) continue;
+			if (descriptors[1].revents != 0) break;
+
+			while (true)
+			{
+				const ssize_t length = read(m_NotifyHandle, buffer, sizeof(buffer));
+				if (length <= 0) break;
+
+				for (char* ptr = buffer; ptr < buffer + length; ptr += sizeof(inotify_event) + ((inotify_event*)ptr)->len)
+				{
+					const inotify_event* event = (const inotify_event*)ptr;
+
+					if (event->mask & IN_Q_OVERFLOW)
+					{
+						PushEvent(m_Directory, FileWatchAction::Rescan);
+						continue;
+					}
+
+					auto watch = m_NotifyWatches.find(event->wd);
+					if (watch == m_NotifyWatches.end()) continue;
+
+					if (event->mask & IN_IGNORED)
+					{
+						m_NotifyWatches.erase(watch);
+						continue;
+					}
+					if (event->len == 0) continue;
+
+					const std::filesystem::path path = watch->second / event->name;
+
+					if (event->mask & (IN_CREATE | IN_MOVED_TO))
+					{
+						if ((event->mask & IN_ISDIR) && m_Recursive)
+						{
+							AddNotifyWatch(m_NotifyHandle, m_NotifyWatches, path, true);
+							// Files may have been created before the watch was added
+							std::error_code error;
+							for (auto it = std::filesystem::recursive_directory_iterator(path, error); !error && it != std::filesystem::recursive_directory_iterator(); it.increment(error))
+							{
+								PushEvent(it->path(), FileWatchAction::Added);
+							}
+						}
+						PushEvent(path, FileWatchAction::Added);
+					}
+					else if (event->mask & (IN_DELETE | IN_MOVED_FROM))
+					{
+						PushEvent(path, FileWatchAction::Removed);
+					}
+					else if (event->mask & (IN_MODIFY | IN_CLOSE_WRITE | IN_ATTRIB))
+					{
+						PushEvent(path, FileWatchAction::Modified);
+					}
+				}
+			}
+		}
+	}
+
+#elif defined(SUORA_PLATFORM_WINDOWS)
+
+	bool FileWatcher::InitNativeBackend()
+	{
+		HANDLE directory = CreateFileW(m_Directory.wstring().c_str(), FILE_LIST_DIRECTORY, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+									   nullptr, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+		if (directory == INVALID_HANDLE_VALUE)
+		{
+			return false;
+		}
+
+		m_DirectoryHandle = directory;
+		m_StopEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+		return true;
+	}
+
+	void FileWatcher::ShutdownNativeBackend()
+	{
+		if (m_DirectoryHandle)
+		{
+			CloseHandle((HANDLE)m_DirectoryHandle);
+			m_DirectoryHandle = nullptr;
+		}
+		if (m_StopEvent)
+		{
+			CloseHandle((HANDLE)m_StopEvent);
+			m_StopEvent = nullptr;
+		}
+	}
+
+	void FileWatcher::RunNativeBackend()
+	{
+		alignas(DWORD) char buffer[64 * 1024];
+		OVERLAPPED overlapped = {};
+		overlapped.hEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+		const DWORD filter = FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_SIZE;
+
+		while (m_Running)
+		{
+			ResetEvent(overlapped.hEvent);
+			if (!ReadDirectoryChangesW((HANDLE)m_DirectoryHandle, buffer, sizeof(buffer), m_Recursive, filter, nullptr, &overlapped, nullptr))
+			{
+				SuoraError("FileWatcher: ReadDirectoryChangesW failed for '{0}'", m_Directory.string());
+				break;
+			}
+
+			HANDLE handles[2] = { overlapped.hEvent, (HANDLE)m_StopEvent };
+			if (WaitForMultipleObjects(2, handles, FALSE, INFINITE) != WAIT_OBJECT_0)
+			{
+				CancelIoEx((HANDLE)m_DirectoryHandle, &overlapped);
+				DWORD ignored = 0;
+				GetOverlappedResult((HANDLE)m_DirectoryHandle, &overlapped, &ignored, TRUE);
+				break;
+			}
+
+			DWORD bytes = 0;
+			if (!GetOverlappedResult((HANDLE)m_DirectoryHandle, &overlapped, &bytes, FALSE)) continue;
+			if (bytes == 0)
+			{
+				// The internal Buffer overflowed
+				PushEvent(m_Directory, FileWatchAction::Rescan);
+				continue;
+			}
+
+			for (char* ptr = buffer;;)
+			{
+				const FILE_NOTIFY_INFORMATION* info = (const FILE_NOTIFY_INFORMATION*)ptr;
+				const std::filesystem::path path = m_Directory / std::wstring(info->FileName, info->FileNameLength / sizeof(WCHAR));
+
+				switch (info->Action)
+				{
+				case FILE_ACTION_ADDED:
+				case FILE_ACTION_RENAMED_NEW_NAME: PushEvent(path, FileWatchAction::Added); break;
+				case FILE_ACTION_REMOVED:
+				case FILE_ACTION_RENAMED_OLD_NAME: PushEvent(path, FileWatchAction::Removed); break;
+				case FILE_ACTION_MODIFIED: PushEvent(path, FileWatchAction::Modified); break;
+				default: break;
+				}
+
+				if (info->NextEntryOffset == 0) break;
+				ptr += info->NextEntryOffset;
+			}
+		}
+
+		CloseHandle(overlapped.hEvent);
+	}
+
+#else
+
+	bool FileWatcher::InitNativeBackend()
+	{
+		return false;
+	}
+	void FileWatcher::ShutdownNativeBackend()
+	{
+	}
+	void FileWatcher::RunNativeBackend()
+	{
+	}
+
+#endif
+
+}
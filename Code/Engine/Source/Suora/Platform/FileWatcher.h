@@ -0,0 +1,85 @@
+#pragma once
+#include <filesystem>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include <unordered_map>
+#include "Suora/Common/Array.h"
+
+namespace Suora
+{
+
+	enum class FileWatchAction : uint32_t
+	{
+		Added = 0,
+		Modified,
+		Removed,
+		/** Changes got lost (e.g. the OS event queue overflowed). Everything below the path has to be checked again. */
+		Rescan
+	};
+
+	struct FileWatchEvent
+	{
+		std::filesystem::path m_Path;
+		FileWatchAction m_Action = FileWatchAction::Modified;
+		/** Platform::GetTime() of the first notification that got coalesced into this Event */
+		float m_DetectionTime = 0.0f;
+	};
+
+	/* Watches a directory on a background thread and coalesces all changes per path.
+	 * Uses inotify on Linux and ReadDirectoryChangesW on Windows. If no native backend is available,
+	 * the watcher falls back to comparing last write times in a fixed interval.                   */
+	class FileWatcher
+	{
+	public:
+		FileWatcher(const std::filesystem::path& directory, bool recursive = true);
+		~FileWatcher();
+
+		/** Returns all Events, that did not receive further changes for at least s_SettleTime.
+		 *  Has to be called regularly, usually once per Frame.                                 */
+		Array<FileWatchEvent> PollEvents();
+
+		bool IsNativeBackend() const { return m_NativeBackend; }
+		bool IsRecursive() const { return m_Recursive; }
+		const std::filesystem::path& GetDirectory() const { return m_Directory; }
+
+		// Editors often write a file in multiple steps, those are collapsed into one Event
+		inline static float s_SettleTime = 0.1f;
+		inline static float s_PollingInterval = 1.0f;
+
+	private:
+		struct PendingEvent
+		{
+			FileWatchEvent Event;
+			float LastChangeTime = 0.0f;
+		};
+
+		void PushEvent(const std::filesystem::path& path, FileWatchAction action);
+
+		bool InitNativeBackend();
+		void ShutdownNativeBackend();
+		void RunNativeBackend();
+		void RunPollingBackend();
+
+		std::filesystem::path m_Directory;
+		bool m_Recursive = true;
+		bool m_NativeBackend = false;
+
+		std::thread m_Thread;
+		std::atomic<bool> m_Running = false;
+		std::mutex m_StopMutex;
+		std::condition_variable m_StopCondition;
+
+		std::mutex m_EventMutex;
+		std::unordered_map<String, PendingEvent> m_PendingEvents;
+
+		// Native Backend
+		int m_NotifyHandle = -1;
+		int m_WakeHandle = -1;
+		std::unordered_map<int, std::filesystem::path> m_NotifyWatches;
+		void* m_DirectoryHandle = nullptr;
+		void* m_StopEvent = nullptr;
+	};
+
+}
@@ -7,12 +7,20 @@
 namespace Suora 
 {
 
-	OpenGLContext::OpenGLContext(GLFWwindow* windowHandle)
-		: m_WindowHandle(windowHandle)
+	OpenGLContext::OpenGLContext(GLFWwindow* windowHandle, bool ownsWindow)
+		: m_WindowHandle(windowHandle), m_OwnsWindow(ownsWindow)
 	{
 		SUORA_ASSERT(windowHandle, "Window handle is null!");
 	}
 
+	OpenGLContext::~OpenGLContext()
+	{
+		if (m_OwnsWindow)
+		{
+			glfwDestroyWindow(m_WindowHandle);
+		}
+	}
+
 	void OpenGLContext::Init()
 	{
 		glfwMakeContextCurrent(m_WindowHandle);
@@ -37,4 +45,31 @@ namespace Suora
 		glfwMakeContextCurrent(m_WindowHandle);
 	}
 
+	void OpenGLContext::ReleaseCurrent()
+	{
+		if (glfwGetCurrentContext() == m_WindowHandle)
+		{
+			glfwMakeContextCurrent(nullptr);
+		}
+	}
+
+	void OpenGLContext::Finish()
+	{
+		glFinish();
+	}
+
+	Scope<GraphicsContext> OpenGLContext::CreateSharedContext()
+	{
+		glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+		GLFWwindow* window = glfwCreateWindow(1, 1, "SharedContext", nullptr, m_WindowHandle);
+		glfwWindowHint(GLFW_VISIBLE, GLFW_TRUE);
+
+		if (!window)
+		{
+			SUORA_WARN(LogCategory::Rendering, "Could not create a shared OpenGL context!");
+			return nullptr;
+		}
+		return CreateScope<OpenGLContext>(window, true);
+	}
+
 }
@@ -10,13 +10,19 @@ namespace Suora
 	class OpenGLContext : public GraphicsContext
 	{
 	public:
-		OpenGLContext(GLFWwindow* windowHandle);
+		OpenGLContext(GLFWwindow* windowHandle, bool ownsWindow = false);
+		~OpenGLContext();
 
 		virtual void Init() override;
 		virtual void SwapBuffers() override;
 		virtual void MakeCurrent() override;
+		virtual void ReleaseCurrent() override;
+		virtual void Finish() override;
+		virtual Scope<GraphicsContext> CreateSharedContext() override;
 	private:
 		GLFWwindow* m_WindowHandle;
+		/** Shared contexts own their hidden window */
+		bool m_OwnsWindow = false;
 	};
 
 }
\ No newline at end of file
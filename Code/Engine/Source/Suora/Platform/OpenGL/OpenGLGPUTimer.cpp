@@ -0,0 +1,58 @@
+#include "Precompiled.h"
+#include "Suora/Platform/OpenGL/OpenGLGPUTimer.h"
+
+#include <glad/glad.h>
+
+namespace Suora
+{
+
+	OpenGLGPUTimer::OpenGLGPUTimer()
+	{
+		glGenQueries(2, m_Queries);
+	}
+
+	OpenGLGPUTimer::~OpenGLGPUTimer()
+	{
+		glDeleteQueries(2, m_Queries);
+	}
+
+	void OpenGLGPUTimer::Begin()
+	{
+		glQueryCounter(m_Queries[0], GL_TIMESTAMP);
+	}
+
+	void OpenGLGPUTimer::End()
+	{
+		glQueryCounter(m_Queries[1], GL_TIMESTAMP);
+	}
+
+	bool OpenGLGPUTimer::IsResultAvailable() const
+	{
+		// The queries complete in order
+		GLint available = 0;
+		glGetQueryObjectiv(m_Queries[1], GL_QUERY_RESULT_AVAILABLE, &available);
+		return available != 0;
+	}
+
+	uint64_t OpenGLGPUTimer::GetBeginNs() const
+	{
+		GLuint64 time = 0;
+		glGetQueryObjectui64v(m_Queries[0], GL_QUERY_RESULT, &time);
+		return time;
+	}
+
+	uint64_t OpenGLGPUTimer::GetEndNs() const
+	{
+		GLuint64 time = 0;
+		glGetQueryObjectui64v(m_Queries[1], GL_QUERY_RESULT, &time);
+		return time;
+	}
+
+	uint64_t OpenGLGPUTimer::GetGPUTime()
+	{
+		GLint64 time = 0;
+		glGetInteger64v(GL_TIMESTAMP, &time);
+		return (uint64_t)time;
+	}
+
+}
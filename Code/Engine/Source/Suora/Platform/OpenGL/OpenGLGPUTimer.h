@@ -0,0 +1,27 @@
+#pragma once
+
+#include "Suora/Renderer/GPUTimer.h"
+
+namespace Suora
+{
+
+	/** Two GL_TIMESTAMP queries */
+	class OpenGLGPUTimer : public GPUTimer
+	{
+	public:
+		OpenGLGPUTimer();
+		virtual ~OpenGLGPUTimer();
+
+		virtual void Begin() override;
+		virtual void End() override;
+		virtual bool IsResultAvailable() const override;
+		virtual uint64_t GetBeginNs() const override;
+		virtual uint64_t GetEndNs() const override;
+
+		static uint64_t GetGPUTime();
+
+	private:
+		uint32_t m_Queries[2] = { 0, 0 };
+	};
+
+}
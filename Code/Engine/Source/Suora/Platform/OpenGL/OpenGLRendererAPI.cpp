@@ -8,6 +8,7 @@
 #include "Suora/Renderer/Shader.h"
 #include "Suora/Assets/AssetManager.h"
 #include "Suora/Core/Log.h"
+#include "Suora/Debug/Profiler.h"
 
 #include <glad/glad.h>
 
@@ -156,12 +157,14 @@ namespace Suora
 	{
 		uint32_t count = indexCount ? indexCount : vertexArray->GetIndexBuffer()->GetCount();
 		glDrawElements(GL_TRIANGLES, count, GL_UNSIGNED_INT, nullptr);
+		SUORA_PROFILE_COUNTER_ADD("Draw Calls", 1);
 		//glBindTexture(GL_TEXTURE_2D, 0);
 	}
 	void OpenGLRendererAPI::DrawIndexed(VertexArray* vertexArray, uint32_t indexCount)
 	{
 		uint32_t count = indexCount ? indexCount : vertexArray->GetIndexBuffer()->GetCount();
 		glDrawElements(GL_TRIANGLES, count, GL_UNSIGNED_INT, nullptr);
+		SUORA_PROFILE_COUNTER_ADD("Draw Calls", 1);
 		//glBindTexture(GL_TEXTURE_2D, 0);
 	}
 
@@ -169,6 +172,7 @@ namespace Suora
 	{
 		uint32_t count = vertexArray->GetIndexBuffer()->GetCount();
 		glDrawElementsInstanced(GL_TRIANGLES, count, GL_UNSIGNED_INT, nullptr, instanceCount);
+		SUORA_PROFILE_COUNTER_ADD("Draw Calls", 1);
 	}
 	struct DrawElementsIndirectCommand
 	{
@@ -187,8 +191,8 @@ namespace Suora
 
 			uint32_t count = It->GetIndexBuffer()->GetCount();
 			glDrawElements(GL_TRIANGLES, count, GL_UNSIGNED_INT, nullptr);
-
 		}
+		SUORA_PROFILE_COUNTER_ADD("Draw Calls", arrays.size());
 
 	}
 
@@ -6,6 +6,9 @@
 
 #include <glm/gtc/type_ptr.hpp>
 #include "Suora/Assets/ShaderGraph.h"
+#include "Suora/Assets/DerivedDataCache.h"
+#include "Suora/Assets/VirtualFileSystem.h"
+#include "Suora/Renderer/ShaderPermutation.h"
 
 namespace Suora 
 {
@@ -21,6 +24,17 @@ namespace Suora
 		return 0;
 	}
 
+	static String GetProgramBinaryKey(const ShaderPermutation& permutation)
+	{
+		// Program binaries are only valid for the driver that created them
+		static const String driver = String((const char*)glGetString(GL_VENDOR)) + "/" + (const char*)glGetString(GL_RENDERER) + "/" + (const char*)glGetString(GL_VERSION);
+		const uint64_t driverHash = DerivedDataCache::HashBytes(driver.data(), driver.size());
+
+		char key[40];
+		snprintf(key, sizeof(key), "%016llx%016llx", (unsigned long long)permutation.Key, (unsigned long long)driverHash);
+		return String(key);
+	}
+
 	OpenGLShader::OpenGLShader(const String& filepath)
 	{
 		String source = ReadFile(filepath);
@@ -52,6 +66,24 @@ namespace Suora
 		m_Name = shader.m_Name;
 	}
 
+	OpenGLShader::OpenGLShader(const ShaderPermutation& permutation)
+		: m_Name(permutation.Name)
+	{
+		const String key = GetProgramBinaryKey(permutation);
+		if (LoadProgramBinary(key))
+		{
+			return;
+		}
+
+		std::unordered_map<GLenum, String> sources;
+		sources[GL_VERTEX_SHADER] = permutation.VertexSource;
+		sources[GL_FRAGMENT_SHADER] = permutation.FragmentSource;
+		if (Compile(sources, true))
+		{
+			StoreProgramBinary(key);
+		}
+	}
+
 	OpenGLShader::~OpenGLShader()
 	{
 		glDeleteProgram(m_RendererID);
@@ -60,6 +92,10 @@ namespace Suora
 	String OpenGLShader::ReadFile(const String& filepath)
 	{
 		String result;
+		if (VirtualFileSystem::ReadFile(filepath, result))
+		{
+			return result;
+		}
 		std::ifstream in(filepath, std::ios::in | std::ios::binary); // ifstream closes itself due to RAII
 		if (in)
 		{
@@ -98,9 +134,54 @@ namespace Suora
 		return shaderSources;
 	}
 
-	void OpenGLShader::Compile(const std::unordered_map<GLenum, String>& shaderSources)
+	bool OpenGLShader::LoadProgramBinary(const String& key)
 	{
+		uint32_t binaryFormat = 0;
+		std::vector<uint8_t> binary;
+		if (!DerivedDataCache::LoadShaderProgram(key, binaryFormat, binary))
+		{
+			return false;
+		}
+
 		GLuint program = glCreateProgram();
+		glProgramBinary(program, binaryFormat, binary.data(), (GLsizei)binary.size());
+
+		// Drivers reject binaries after updates, the program is compiled from source then
+		GLint isLinked = 0;
+		glGetProgramiv(program, GL_LINK_STATUS, &isLinked);
+		if (isLinked == GL_FALSE)
+		{
+			glDeleteProgram(program);
+			return false;
+		}
+
+		m_RendererID = program;
+		return true;
+	}
+
+	void OpenGLShader::StoreProgramBinary(const String& key)
+	{
+		GLint binaryLength = 0;
+		glGetProgramiv(m_RendererID, GL_PROGRAM_BINARY_LENGTH, &binaryLength);
+		if (binaryLength <= 0)
+		{
+			return;
+		}
+
+		std::vector<uint8_t> binary(binaryLength);
+		GLenum binaryFormat = 0;
+		glGetProgramBinary(m_RendererID, binaryLength, &binaryLength, &binaryFormat, binary.data());
+		binary.resize(binaryLength);
+		DerivedDataCache::StoreShaderProgram(key, binaryFormat, binary);
+	}
+
+	bool OpenGLShader::Compile(const std::unordered_map<GLenum, String>& shaderSources, bool retrievableBinary)
+	{
+		GLuint program = glCreateProgram();
+		if (retrievableBinary)
+		{
+			glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+		}
 		SUORA_ASSERT(shaderSources.size() <= 2, "We only support 2 shaders for now");
 		std::array<GLenum, 2> glShaderIDs;
 		int glShaderIDIndex = 0;
@@ -162,7 +243,7 @@ namespace Suora
 
 			//SUORA_ERROR(LogCategory::Rendering, "{0}", infoLog.data());
 			SUORA_ASSERT(false, "Shader link failure!");
-			return;
+			return false;
 		}
 
 		for (auto id : glShaderIDs)
@@ -170,6 +251,7 @@ namespace Suora
 			glDetachShader(program, id);
 			glDeleteShader(id);
 		}
+		return true;
 	}
 
 	void OpenGLShader::Bind() const
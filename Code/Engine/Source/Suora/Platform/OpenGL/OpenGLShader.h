@@ -10,6 +10,7 @@ namespace Suora
 {
 
 	class ShaderGraph;
+	struct ShaderPermutation;
 
 	class OpenGLShader : public Shader
 	{
@@ -17,6 +18,8 @@ namespace Suora
 		OpenGLShader(const String& filepath);
 		OpenGLShader(const String& name, const String& vertexSrc, const String& fragmentSrc);
 		OpenGLShader(const ShaderGraph& shader);
+		/** Loads the program binary from the DerivedDataCache, compiles and stores it on a miss */
+		OpenGLShader(const ShaderPermutation& permutation);
 		virtual ~OpenGLShader();
 
 		virtual void Bind() const override;
@@ -48,7 +51,9 @@ namespace Suora
 	private:
 		String ReadFile(const String& filepath);
 		std::unordered_map<GLenum, String> PreProcess(const String& source);
-		void Compile(const std::unordered_map<GLenum, String>& shaderSources);
+		bool Compile(const std::unordered_map<GLenum, String>& shaderSources, bool retrievableBinary = false);
+		bool LoadProgramBinary(const String& key);
+		void StoreProgramBinary(const String& key);
 	private:
 		uint32_t m_RendererID;
 		String m_Name;
@@ -1,8 +1,19 @@
 #include "Precompiled.h"
 #include "Suora/Platform/OpenGL/OpenGLTexture.h"
 
+#include "Suora/Renderer/TexturePipeline.h"
+#include "Suora/Assets/VirtualFileSystem.h"
+
 #include <stb_image.h>
 
+// S3TC is not part of core OpenGL, but supported by every desktop driver
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+	#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+	#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+
 namespace Suora 
 {
 
@@ -28,6 +39,12 @@ namespace Suora
 		int width, height, channels;
 		stbi_set_flip_vertically_on_load(1);
 		stbi_uc* data = nullptr;
+		std::vector<uint8_t> packaged;
+		if (VirtualFileSystem::ReadFile(path, packaged))
+		{
+			data = stbi_load_from_memory(packaged.data(), (int)packaged.size(), &width, &height, &channels, 0);
+		}
+		else
 		{
 			data = stbi_load(path.c_str(), &width, &height, &channels, 0);
 		}
@@ -107,11 +124,79 @@ namespace Suora
 
 	}
 
+	OpenGLTexture2D::OpenGLTexture2D(const CookedTexture& cooked)
+		: m_Width(cooked.m_Width), m_Height(cooked.m_Height)
+	{
+		SUORA_ASSERT(!cooked.m_Mips.empty(), "Cooked Texture has no data!");
+
+		m_DataFormat = 0;
+		switch (cooked.m_Format)
+		{
+		case ETextureFormat::R8:    m_InternalFormat = GL_R8;    m_DataFormat = GL_RED;  break;
+		case ETextureFormat::RGB8:  m_InternalFormat = GL_RGB8;  m_DataFormat = GL_RGB;  break;
+		case ETextureFormat::RGBA8: m_InternalFormat = GL_RGBA8; m_DataFormat = GL_RGBA; break;
+		case ETextureFormat::BC1:   m_InternalFormat = GL_COMPRESSED_RGB_S3TC_DXT1_EXT;  break;
+		case ETextureFormat::BC3:   m_InternalFormat = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT; break;
+		case ETextureFormat::BC5:   m_InternalFormat = GL_COMPRESSED_RG_RGTC2;           break;
+		case ETextureFormat::BC7:   m_InternalFormat = GL_COMPRESSED_RGBA_BPTC_UNORM;    break;
+		default: SUORA_ASSERT(false, "Format not supported!"); break;
+		}
+		m_MipCount = (uint32_t)cooked.m_Mips.size();
+		m_MemorySize = cooked.GetDataSize();
+
+		glCreateTextures(GL_TEXTURE_2D, 1, &m_RendererID);
+		glTextureStorage2D(m_RendererID, m_MipCount, m_InternalFormat, m_Width, m_Height);
+
+		glTextureParameteri(m_RendererID, GL_TEXTURE_MIN_FILTER, m_MipCount > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+		glTextureParameteri(m_RendererID, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		glTextureParameteri(m_RendererID, GL_TEXTURE_MAX_LEVEL, m_MipCount - 1);
+
+		glTextureParameteri(m_RendererID, GL_TEXTURE_WRAP_S, GL_REPEAT);
+		glTextureParameteri(m_RendererID, GL_TEXTURE_WRAP_T, GL_REPEAT);
+
+		// Rows of R8 and RGB8 Mips are tightly packed
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+		uint32_t mipWidth = m_Width, mipHeight = m_Height;
+		for (uint32_t mip = 0; mip < m_MipCount; mip++)
+		{
+			const std::vector<uint8_t>& data = cooked.m_Mips[mip];
+			if (TexturePipeline::IsBlockCompressed(cooked.m_Format))
+			{
+				glCompressedTextureSubImage2D(m_RendererID, mip, 0, 0, mipWidth, mipHeight, m_InternalFormat, (GLsizei)data.size(), data.data());
+			}
+			else
+			{
+				glTextureSubImage2D(m_RendererID, mip, 0, 0, mipWidth, mipHeight, m_DataFormat, GL_UNSIGNED_BYTE, data.data());
+			}
+			mipWidth = std::max(1u, mipWidth / 2);
+			mipHeight = std::max(1u, mipHeight / 2);
+		}
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	}
+
 	OpenGLTexture2D::~OpenGLTexture2D()
 	{
 		glDeleteTextures(1, &m_RendererID);
 	}
 
+	uint64_t OpenGLTexture2D::GetMemorySize() const
+	{
+		if (m_MemorySize != 0)
+		{
+			return m_MemorySize;
+		}
+
+		uint64_t bpp = 4;
+		switch (m_InternalFormat)
+		{
+		case GL_RGB8: bpp = 3; break;
+		case GL_RGBA8: bpp = 4; break;
+		case GL_R32F: bpp = 4; break;
+		default: break;
+		}
+		return (uint64_t)m_Width * (uint64_t)m_Height * bpp;
+	}
+
 	void OpenGLTexture2D::SetData(void* data, uint32_t size)
 	{
 		uint32_t bpp = m_DataFormat == GL_RGBA ? 4 : 3;
@@ -124,11 +209,11 @@ namespace Suora
 		switch (filter)
 		{
 		case ETextureFilter::Linear:
-			glTextureParameteri(m_RendererID, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+			glTextureParameteri(m_RendererID, GL_TEXTURE_MIN_FILTER, m_MipCount > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
 			glTextureParameteri(m_RendererID, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 			break;
 		case ETextureFilter::Nearest:
-			glTextureParameteri(m_RendererID, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+			glTextureParameteri(m_RendererID, GL_TEXTURE_MIN_FILTER, m_MipCount > 1 ? GL_NEAREST_MIPMAP_NEAREST : GL_NEAREST);
 			glTextureParameteri(m_RendererID, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
 			break;
 		default:
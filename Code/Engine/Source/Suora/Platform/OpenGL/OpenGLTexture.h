@@ -13,11 +13,13 @@ namespace Suora
 		OpenGLTexture2D(uint32_t width, uint32_t height);
 		OpenGLTexture2D(const String& path);
 		OpenGLTexture2D(TextureBuffer_stbi& buffer);
+		OpenGLTexture2D(const CookedTexture& cooked);
 		virtual ~OpenGLTexture2D();
 
 		virtual uint32_t GetWidth() const override { return m_Width;  }
 		virtual uint32_t GetHeight() const override { return m_Height; }
 		virtual uint32_t GetRendererID() const override { return m_RendererID; }
+		virtual uint64_t GetMemorySize() const override;
 		
 		virtual void SetData(void* data, uint32_t size) override;
 		virtual void SetFilter(ETextureFilter filter) override;
@@ -33,6 +35,8 @@ namespace Suora
 		uint32_t m_Width, m_Height;
 		uint32_t m_RendererID;
 		GLenum m_InternalFormat, m_DataFormat;
+		uint32_t m_MipCount = 1;
+		uint64_t m_MemorySize = 0;
 	};
 
 }
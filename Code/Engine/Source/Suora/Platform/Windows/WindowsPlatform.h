@@ -4,6 +4,7 @@
 #include "Suora/Core/Window.h"
 #include "WindowsWindow.h"
 #include "Suora/Core/Application.h"
+#include "Suora/Assets/VirtualFileSystem.h"
 
 #include "Windows.h"
 #include <windows.h>
@@ -42,6 +43,12 @@ namespace Suora
 	}
 	String Platform::ReadFromFile(const String& filePath)
 	{
+		String packaged;
+		if (VirtualFileSystem::ReadFile(filePath, packaged))
+		{
+			return packaged;
+		}
+
 		std::ifstream reader(filePath);
 		String str((std::istreambuf_iterator<char>(reader)), std::istreambuf_iterator<char>());
 		reader.close();
@@ -4,6 +4,7 @@
 #include "Suora/Core/NativeInput.h"
 #include "Suora/Assets/SuoraProject.h"
 #include "Suora/Assets/Texture2D.h"
+#include "Suora/Assets/VirtualFileSystem.h"
 #include "Suora/Events/ApplicationEvent.h"
 #include "Suora/Events/MouseEvent.h"
 #include "Suora/Events/KeyEvent.h"
@@ -330,7 +331,15 @@ namespace Suora
 			GLFWimage images[1];
 			int channels = 4;
 			stbi_set_flip_vertically_on_load(0);
-			images[0].pixels = stbi_load(m_CurrentIconTexture->GetSourceAssetPath().string().c_str(), &images[0].width, &images[0].height, &channels, channels); //rgba channels 
+			std::vector<uint8_t> packagedIcon;
+			if (VirtualFileSystem::ReadFile(m_CurrentIconTexture->GetSourceAssetPath(), packagedIcon))
+			{
+				images[0].pixels = stbi_load_from_memory(packagedIcon.data(), (int)packagedIcon.size(), &images[0].width, &images[0].height, &channels, channels);
+			}
+			else
+			{
+				images[0].pixels = stbi_load(m_CurrentIconTexture->GetSourceAssetPath().string().c_str(), &images[0].width, &images[0].height, &channels, channels); //rgba channels 
+			}
 			stbi_set_flip_vertically_on_load(1);
 			images->width = texture->GetWidth();
 			images->height = texture->GetHeight();
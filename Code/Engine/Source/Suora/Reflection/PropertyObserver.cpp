@@ -0,0 +1,128 @@
+#include "Precompiled.h"
+#include "PropertyObserver.h"
+#include "Suora/Core/Object/Object.h"
+#include <algorithm>
+#include <bit>
+
+namespace Suora
+{
+
+	void PropertyObserver::Observe(Object* obj)
+	{
+		if (!obj || obj->m_PropertyObservation) return;
+
+		obj->m_PropertyObservation = new PropertyObservation();
+	}
+
+	void PropertyObserver::Unobserve(Object* obj)
+	{
+		if (!obj || !obj->m_PropertyObservation) return;
+
+		{
+			std::lock_guard<std::mutex> lock(s_Mutex);
+			if (obj->m_PropertyObservation->IsPendingCollection)
+			{
+				s_ChangedObjects.erase(std::remove(s_ChangedObjects.begin(), s_ChangedObjects.end(), obj), s_ChangedObjects.end());
+			}
+		}
+		delete obj->m_PropertyObservation;
+		obj->m_PropertyObservation = nullptr;
+	}
+
+	bool PropertyObserver::IsObserved(const Object* obj)
+	{
+		return obj && obj->m_PropertyObservation;
+	}
+
+	uint64_t PropertyObserver::AddCallback(Object* obj, const PropertyChangeCallback& callback)
+	{
+		Observe(obj);
+
+		std::lock_guard<std::mutex> lock(s_Mutex);
+		const uint64_t handle = s_NextCallbackHandle++;
+		obj->m_PropertyObservation->Callbacks.push_back({ handle, callback });
+		return handle;
+	}
+
+	void PropertyObserver::RemoveCallback(Object* obj, uint64_t handle)
+	{
+		if (!obj || !obj->m_PropertyObservation) return;
+
+		std::lock_guard<std::mutex> lock(s_Mutex);
+		auto& callbacks = obj->m_PropertyObservation->Callbacks;
+		callbacks.erase(std::remove_if(callbacks.begin(), callbacks.end(), [handle](const auto& it) { return it.first == handle; }), callbacks.end());
+	}
+
+	bool PropertyObserver::IsPropertyDirty(const Object* obj, uint32_t propertyIndex)
+	{
+		if (!obj || !obj->m_PropertyObservation) return false;
+
+		std::lock_guard<std::mutex> lock(s_Mutex);
+		const std::vector<uint64_t>& bits = obj->m_PropertyObservation->DirtyBits;
+		const size_t word = propertyIndex / 64;
+		return word < bits.size() && (bits[word] & (1ull << (propertyIndex % 64)));
+	}
+
+	void PropertyObserver::ClearDirty(Object* obj)
+	{
+		if (!obj || !obj->m_PropertyObservation) return;
+
+		std::lock_guard<std::mutex> lock(s_Mutex);
+		std::fill(obj->m_PropertyObservation->DirtyBits.begin(), obj->m_PropertyObservation->DirtyBits.end(), 0ull);
+	}
+
+	void PropertyObserver::CollectChanges(Array<PropertyChangeSet>& outChanges)
+	{
+		std::lock_guard<std::mutex> lock(s_Mutex);
+		for (Object* obj : s_ChangedObjects)
+		{
+			PropertyObservation& observation = *obj->m_PropertyObservation;
+			observation.IsPendingCollection = false;
+
+			PropertyChangeSet changeSet;
+			changeSet.ChangedObject = obj;
+			for (size_t word = 0; word < observation.DirtyBits.size(); word++)
+			{
+				for (uint64_t bits = observation.DirtyBits[word]; bits; bits &= bits - 1)
+				{
+					changeSet.Properties.Add((uint32_t)(word * 64 + std::countr_zero(bits)));
+				}
+				observation.DirtyBits[word] = 0;
+			}
+			// ClearDirty() might have emptied the set already
+			if (changeSet.Properties.Size() > 0)
+			{
+				outChanges.Add(changeSet);
+			}
+		}
+		s_ChangedObjects.clear();
+	}
+
+	void PropertyObserver::MarkDirty(Object* obj, uint32_t propertyIndex)
+	{
+		PropertyObservation& observation = *obj->m_PropertyObservation;
+		std::vector<std::pair<uint64_t, PropertyChangeCallback>> callbacks;
+		{
+			std::lock_guard<std::mutex> lock(s_Mutex);
+			const size_t word = propertyIndex / 64;
+			if (observation.DirtyBits.size() <= word)
+			{
+				observation.DirtyBits.resize(word + 1, 0ull);
+			}
+			observation.DirtyBits[word] |= (1ull << (propertyIndex % 64));
+			if (!observation.IsPendingCollection)
+			{
+				observation.IsPendingCollection = true;
+				s_ChangedObjects.push_back(obj);
+			}
+			callbacks = observation.Callbacks;
+		}
+
+		// Invoked without the lock, so callbacks may write properties or remove themselves
+		for (auto& [handle, callback] : callbacks)
+		{
+			callback(obj, propertyIndex);
+		}
+	}
+
+}
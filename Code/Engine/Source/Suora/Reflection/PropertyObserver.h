@@ -0,0 +1,66 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <vector>
+#include "Suora/Common/Array.h"
+
+namespace Suora
+{
+	class Object;
+
+	/** propertyIndex is the PropertyIndex the HeaderTool generates, i.e. the index in ClassReflector::GetAllClassMemberProperties() */
+	using PropertyChangeCallback = std::function<void(Object* obj, uint32_t propertyIndex)>;
+
+	/** The changes of one Object, see PropertyObserver::CollectChanges() */
+	struct PropertyChangeSet
+	{
+		Object* ChangedObject = nullptr;
+		/** Ascending */
+		Array<uint32_t> Properties;
+	};
+
+	/** The state of an observed Object, owned by the Object */
+	struct PropertyObservation
+	{
+		/** One bit per reflected property */
+		std::vector<uint64_t> DirtyBits;
+		std::vector<std::pair<uint64_t, PropertyChangeCallback>> Callbacks;
+		/** Listed in the changed Objects of the PropertyObserver */
+		bool IsPendingCollection = false;
+	};
+
+	/* Opt-in observation of reflected properties. Observed Objects keep a dirty bit per property, keyed by the
+	 * PropertyIndex the HeaderTool generates for every SUORA_CLASS, and invoke their callbacks on each change.
+	 * Changes are reported by Object::SetProperty(...) or Object::MarkPropertyDirty(...); for Objects that are not
+	 * observed, both only test a pointer, so setters can report changes unconditionally.
+	 * Consumers, e.g. the editor or the replication, gather all changes of a frame at once with CollectChanges(). */
+	class PropertyObserver
+	{
+	public:
+		static void Observe(Object* obj);
+		/** Also done by the destructor of the Object */
+		static void Unobserve(Object* obj);
+		static bool IsObserved(const Object* obj);
+
+		/** Observes the Object, if it is not yet. Returns the handle for RemoveCallback() */
+		static uint64_t AddCallback(Object* obj, const PropertyChangeCallback& callback);
+		static void RemoveCallback(Object* obj, uint64_t handle);
+
+		static bool IsPropertyDirty(const Object* obj, uint32_t propertyIndex);
+		static void ClearDirty(Object* obj);
+		/** Appends all Objects that changed since the last call and clears their dirty bits */
+		static void CollectChanges(Array<PropertyChangeSet>& outChanges);
+
+	private:
+		static void MarkDirty(Object* obj, uint32_t propertyIndex);
+
+		inline static std::mutex s_Mutex;
+		/** Observed Objects with dirty bits, that were not collected yet */
+		inline static std::vector<Object*> s_ChangedObjects;
+		inline static uint64_t s_NextCallbackHandle = 1;
+
+		friend class Object;
+	};
+
+}
@@ -6,7 +6,6 @@
 #include "Suora/GameFramework/World.h"
 #include "Suora/GameFramework/Nodes/MeshNode.h"
 #include "Suora/GameFramework/Nodes/CameraNode.h"
-#include "Suora/Core/Threading.h"
 #include "Suora/Common/Math.h"
 #include "Suora/Common/VectorUtils.h"
 #include <mutex>
@@ -82,6 +81,15 @@ namespace Suora
 		return Clusters;
 	}
 
+	Decima::~Decima()
+	{
+		for (auto& It : m_Jobs)
+		{
+			It.second.Cancel();
+			It.second.Wait();
+		}
+	}
+
 	void Decima::Run(World* world, CameraNode* camera)
 	{
 		Array<MeshNode*> meshNodes = world->FindNodesByClass<MeshNode>();
@@ -102,7 +110,10 @@ namespace Suora
 
 					if (m_Jobs.find(meshNode) == m_Jobs.end())
 					{
-						m_Jobs[meshNode] = std::async(std::launch::async, &Decima::Generate, this, meshNode->m_Mesh, meshNode->GetTransformMatrix(), camera->GetPosition(), camera->GetForwardVector(), camera->GetPerspectiveVerticalFOV());
+						m_Jobs[meshNode] = TaskScheduler::Run([this, mesh = meshNode->m_Mesh, transform = meshNode->GetTransformMatrix(), cameraPos = camera->GetPosition(), cameraForward = camera->GetForwardVector(), fov = camera->GetPerspectiveVerticalFOV()]()
+						{
+							return Generate(mesh, transform, cameraPos, cameraForward, fov);
+						}, TaskPriority::Low, "Decima::Generate");
 					}
 
 				}
@@ -113,11 +124,11 @@ namespace Suora
 		std::vector<MeshNode*> JobsPendingKill;
 		for (auto& It : m_Jobs)
 		{
-			if (/*m_OffFrames <= 0 && */IsFutureReady(It.second))
+			if (/*m_OffFrames <= 0 && */It.second.IsReady())
 			{
 				JobsPendingKill.push_back(It.first);
 
-				std::vector<Ref<Cluster>> Clusters = It.second.get();
+				std::vector<Ref<Cluster>> Clusters = It.second.Get();
 				std::vector<Ref<VertexArray>> vao;
 				for (auto& clusters : Clusters)
 				{
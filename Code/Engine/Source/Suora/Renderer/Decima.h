@@ -1,9 +1,9 @@
 #pragma once
-#include <future>
 #include <unordered_map>
 #include <thread>
 #include <cstdint>
 #include "Suora/Common/VectorUtils.h"
+#include "Suora/Core/TaskScheduler.h"
 
 namespace Suora
 {
@@ -23,7 +23,9 @@ namespace Suora
 		inline static uint32_t s_PerFrameTriangleBudget = 2400;
 		inline static uint32_t s_MaxAsyncMeshes = 8;
 
-		std::unordered_map<MeshNode*, std::future<std::vector<Ref<Cluster>>>> m_Jobs;
+		~Decima();
+
+		std::unordered_map<MeshNode*, Task<std::vector<Ref<Cluster>>>> m_Jobs;
 		int64_t m_Index = 0;
 		std::thread m_Thread;
 		bool m_ThreadInit = false;
@@ -0,0 +1,33 @@
+#include "Precompiled.h"
+#include "Suora/Renderer/GPUTimer.h"
+
+#include "Suora/Renderer/RendererAPI.h"
+#include "Suora/Platform/OpenGL/OpenGLGPUTimer.h"
+
+namespace Suora
+{
+
+	Ref<GPUTimer> GPUTimer::Create()
+	{
+		switch (RendererAPI::GetAPI())
+		{
+			case RendererAPI::API::None:    SUORA_ASSERT(false, "RendererAPI::None is currently not supported!"); return nullptr;
+			case RendererAPI::API::OpenGL:  return CreateRef<OpenGLGPUTimer>();
+		}
+
+		SUORA_ASSERT(false, "Unknown RendererAPI!");
+		return nullptr;
+	}
+
+	uint64_t GPUTimer::GetGPUTime()
+	{
+		switch (RendererAPI::GetAPI())
+		{
+			case RendererAPI::API::None:    return 0;
+			case RendererAPI::API::OpenGL:  return OpenGLGPUTimer::GetGPUTime();
+		}
+
+		return 0;
+	}
+
+}
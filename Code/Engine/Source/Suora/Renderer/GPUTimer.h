@@ -0,0 +1,27 @@
+#pragma once
+#include <cstdint>
+#include "Suora/Core/Base.h"
+
+namespace Suora
+{
+
+	/** Measures when the GPU reached two points in the command stream. Results arrive a few frames later. */
+	class GPUTimer
+	{
+	public:
+		virtual ~GPUTimer() = default;
+
+		virtual void Begin() = 0;
+		virtual void End() = 0;
+		/** Never blocks */
+		virtual bool IsResultAvailable() const = 0;
+		/** On the GPU clock, see GetGPUTime() */
+		virtual uint64_t GetBeginNs() const = 0;
+		virtual uint64_t GetEndNs() const = 0;
+
+		static Ref<GPUTimer> Create();
+		/** The current time of the GPU clock, in nanoseconds. Needs a current GraphicsContext. */
+		static uint64_t GetGPUTime();
+	};
+
+}
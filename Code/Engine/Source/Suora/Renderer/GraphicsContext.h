@@ -11,6 +11,13 @@ namespace Suora
 		virtual void Init() = 0;
 		virtual void SwapBuffers() = 0;
 		virtual void MakeCurrent() = 0;
+		virtual void ReleaseCurrent() { }
+		/** Waits until all commands issued on this context are completed */
+		virtual void Finish() { }
+
+		/** Hidden context that shares Shaders, Buffers and Textures with this one, for background threads.
+		 *  Has to be created and destroyed on the main thread. Returns nullptr if not supported. */
+		virtual Scope<GraphicsContext> CreateSharedContext() { return nullptr; }
 
 		static Scope<GraphicsContext> Create(void* window);
 	};
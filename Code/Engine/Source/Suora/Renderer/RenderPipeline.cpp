@@ -11,6 +11,7 @@
 #include "Suora/Assets/AssetManager.h"
 #include "Suora/Assets/ShaderGraph.h"
 #include "Suora/Assets/SuoraProject.h"
+#include "Suora/Debug/Profiler.h"
 
 #include "Suora/GameFramework/Nodes/MeshNode.h"
 #include "Suora/GameFramework/Nodes/DecalNode.h"
@@ -80,6 +81,8 @@ namespace Suora
 	void RenderPipeline::Render(Framebuffer& buffer, World& world, CameraNode& camera, RenderingParams& params)
 	{
 		SUORA_ASSERT(buffer.GetSpecification().Attachments.Attachments[0].TextureFormat == FramebufferTextureFormat::RGBA8);
+		SUORA_PROFILE_SCOPE("RenderPipeline::Render");
+		SUORA_PROFILE_GPU_SCOPE("Render");
 
 		params.ValidateBuffers();
 
@@ -168,6 +171,8 @@ namespace Suora
 
 	void RenderPipeline::ShadowPass(World& world, CameraNode& camera, RenderingParams& params)
 	{
+		SUORA_PROFILE_SCOPE("RenderPipeline::ShadowPass");
+		SUORA_PROFILE_GPU_SCOPE("ShadowPass");
 		Array<LightNode*> lights = world.FindNodesByClass<LightNode>();
 		for (LightNode* light : lights)
 		{
@@ -180,6 +185,8 @@ namespace Suora
 
 	void RenderPipeline::DeferredPass(World& world, CameraNode& camera, RenderingParams& params)
 	{
+		SUORA_PROFILE_SCOPE("RenderPipeline::DeferredPass");
+		SUORA_PROFILE_GPU_SCOPE("DeferredPass");
 		RenderCommand::SetClearColor(Color(0,0,0,1));
 		RenderGBuffer(world, camera, params);
 
@@ -408,6 +415,8 @@ namespace Suora
 
 	void RenderPipeline::ForwardPass(World& world, CameraNode& camera, RenderingParams& params)
 	{
+		SUORA_PROFILE_SCOPE("RenderPipeline::ForwardPass");
+		SUORA_PROFILE_GPU_SCOPE("ForwardPass");
 		SetFullscreenViewport(*params.GetGBuffer());
 
 		RenderCommand::SetWireframeMode(params.DrawWireframe);
@@ -429,6 +438,8 @@ namespace Suora
 
 	void RenderPipeline::PostProcessPass(World& world, CameraNode& camera, RenderingParams& params)
 	{
+		SUORA_PROFILE_SCOPE("RenderPipeline::PostProcessPass");
+		SUORA_PROFILE_GPU_SCOPE("PostProcessPass");
 		SetFullscreenViewport(*params.GetGBuffer());
 
 		bool resultIsInTempBuffer = false;
@@ -467,6 +478,8 @@ namespace Suora
 
 	void RenderPipeline::UserInterfacePass(World& world, const Mat4& view, Framebuffer& target, RenderingParams& params)
 	{
+		SUORA_PROFILE_SCOPE("RenderPipeline::UserInterfacePass");
+		SUORA_PROFILE_GPU_SCOPE("UserInterfacePass");
 		Array<UIRenderable*> renderables = world.FindNodesByClass<UIRenderable>();
 		for (UIRenderable* It : renderables)
 		{
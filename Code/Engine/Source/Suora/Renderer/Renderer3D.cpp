@@ -14,6 +14,8 @@
 #include "Suora/Assets/AssetManager.h"
 #include "Suora/Assets/Mesh.h"
 #include "Suora/Assets/Material.h"
+#include "Suora/Assets/Texture2D.h"
+#include "Suora/Assets/AssetResidencyManager.h"
 #include "Suora/Assets/ShaderGraph.h"
 #include "Suora/Assets/Font.h"
 #include "Suora/Common/Math.h"
@@ -62,6 +64,17 @@ namespace Suora
 		if (!material->GetShaderGraph()) return;
 		if (!material->GetShaderGraph()->GetShaderViaType(type)) return;
 
+		// Report usage and approximate screen size to the residency manager
+		{
+			const float scale = glm::max(glm::length(Vec3(transform[0])), glm::max(glm::length(Vec3(transform[1])), glm::length(Vec3(transform[2]))));
+			const float priority = AssetResidencyManager::CalculateStreamingPriority(camera->GetPosition(), camera->GetPerspectiveVerticalFOV(), Vec3(transform[3]), mesh.m_BoundingSphereRadius * scale);
+			AssetResidencyManager::MarkUsed(&mesh, priority);
+			for (const UniformSlot& slot : material->m_UniformSlots)
+			{
+				if (slot.m_Texture2D) AssetResidencyManager::MarkUsed(slot.m_Texture2D, priority);
+			}
+		}
+
 		VertexArray* vao = mesh.GetVertexArray();
 		if (!vao) return;
 
@@ -30,6 +30,18 @@ namespace Suora
 		SUORA_ASSERT(false, "Unknown RendererAPI!");
 		return nullptr;
 	}
+	Ref<Shader> Shader::Create(const ShaderPermutation& permutation)
+	{
+		switch (RendererAPI::GetAPI())
+		{
+			case RendererAPI::API::None:    SUORA_ASSERT(false, "RendererAPI::None is currently not supported!"); return nullptr;
+			case RendererAPI::API::OpenGL:  return CreateRef<OpenGLShader>(permutation);
+		}
+
+		SUORA_ASSERT(false, "Unknown RendererAPI!");
+		return nullptr;
+	}
+
 	Shader* Shader::CreatePtr(const String& filepath)
 	{
 		switch (RendererAPI::GetAPI())
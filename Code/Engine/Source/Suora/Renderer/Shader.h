@@ -7,6 +7,7 @@
 namespace Suora 
 {
 	class ShaderGraph;
+	struct ShaderPermutation;
 
 	class Shader
 	{
@@ -29,6 +30,8 @@ namespace Suora
 
 		static Ref<Shader> Create(const String& filepath);
 		static Ref<Shader> Create(const String& name, const String& vertexSrc, const String& fragmentSrc);
+		/** Uses the program binary in the DerivedDataCache if possible. Prefer ShaderCache::Get, which compiles in the background. */
+		static Ref<Shader> Create(const ShaderPermutation& permutation);
 		static Shader* CreatePtr(const String& filepath);
 		static Shader* CreatePtr(const String& name, const String& vertexSrc, const String& fragmentSrc);
 		static Shader* CreatePtr(const ShaderGraph& shader);
@@ -0,0 +1,206 @@
+#include "Precompiled.h"
+#include "Suora/Renderer/ShaderCache.h"
+
+#include <chrono>
+#include "Suora/Renderer/Shader.h"
+
+namespace Suora
+{
+
+	void ShaderCache::Initialize(GraphicsContext& mainContext)
+	{
+		SUORA_ASSERT(!s_Running, "ShaderCache is already initialized!");
+
+		s_Context = mainContext.CreateSharedContext();
+		if (!s_Context)
+		{
+			SUORA_WARN(LogCategory::Rendering, "ShaderCache: No shared GraphicsContext, Shaders are compiled on demand.");
+			return;
+		}
+
+		s_Running = true;
+		s_Worker = std::thread(&ShaderCache::WorkerThread);
+	}
+
+	void ShaderCache::Shutdown()
+	{
+		{
+			std::lock_guard<std::mutex> lock(s_Mutex);
+			s_Running = false;
+			s_Queue.clear();
+		}
+		s_QueueCondition.notify_all();
+
+		if (s_Worker.joinable())
+		{
+			s_Worker.join();
+		}
+		s_Context = nullptr;
+
+		std::lock_guard<std::mutex> lock(s_Mutex);
+		s_Entries.clear();
+	}
+
+	void ShaderCache::Prepare(const ShaderPermutation& permutation)
+	{
+		{
+			std::lock_guard<std::mutex> lock(s_Mutex);
+			Entry& entry = s_Entries[permutation.Key];
+			entry.Users++;
+			if (!s_Running || entry.State != EntryState::None)
+			{
+				return;
+			}
+			entry.State = EntryState::Queued;
+			entry.Permutation = permutation;
+			s_Queue.push_back(permutation.Key);
+		}
+		s_QueueCondition.notify_one();
+	}
+
+	void ShaderCache::Release(uint64_t key)
+	{
+		std::lock_guard<std::mutex> lock(s_Mutex);
+		auto it = s_Entries.find(key);
+		if (it == s_Entries.end() || it->second.Users == 0)
+		{
+			return;
+		}
+		if (--it->second.Users > 0)
+		{
+			return;
+		}
+
+		// Whoever compiles it evicts it afterwards. Queued keys are skipped by the worker once their entry is gone.
+		if (it->second.State != EntryState::Compiling)
+		{
+			s_Entries.erase(it);
+			s_Stats.Evicted++;
+		}
+	}
+
+	Ref<Shader> ShaderCache::Get(const ShaderPermutation& permutation)
+	{
+		std::unique_lock<std::mutex> lock(s_Mutex);
+		s_Stats.Requests++;
+
+		auto it = s_Entries.find(permutation.Key);
+		if (it != s_Entries.end() && it->second.State == EntryState::Ready)
+		{
+			return it->second.CompiledShader;
+		}
+
+		const auto start = std::chrono::high_resolution_clock::now();
+		if (it != s_Entries.end() && it->second.State == EntryState::Compiling)
+		{
+			// The entry is gone afterwards, if it was released while compiling
+			s_ReadyCondition.wait(lock, [&permutation]()
+			{
+				auto entry = s_Entries.find(permutation.Key);
+				return entry == s_Entries.end() || entry->second.State != EntryState::Compiling;
+			});
+			it = s_Entries.find(permutation.Key);
+			if (it != s_Entries.end() && it->second.State == EntryState::Ready)
+			{
+				s_Stats.BlockingTimeMs += std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+				return it->second.CompiledShader;
+			}
+		}
+
+		// Not started yet, compiling right here is faster than waiting for the queue
+		s_Entries[permutation.Key].State = EntryState::Compiling;
+		lock.unlock();
+		Ref<Shader> shader = Shader::Create(permutation);
+		lock.lock();
+
+		FinishCompilation(permutation.Key, shader);
+		s_Stats.CompiledOnDemand++;
+		s_Stats.BlockingTimeMs += std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+		lock.unlock();
+		s_ReadyCondition.notify_all();
+
+		return shader;
+	}
+
+	void ShaderCache::FinishCompilation(uint64_t key, const Ref<Shader>& shader)
+	{
+		auto it = s_Entries.find(key);
+		if (it == s_Entries.end())
+		{
+			return;
+		}
+		if (it->second.Users == 0)
+		{
+			s_Entries.erase(it);
+			s_Stats.Evicted++;
+			return;
+		}
+
+		it->second.CompiledShader = shader;
+		it->second.Permutation = ShaderPermutation();
+		it->second.State = EntryState::Ready;
+	}
+
+	bool ShaderCache::IsReady(uint64_t key)
+	{
+		std::lock_guard<std::mutex> lock(s_Mutex);
+		auto it = s_Entries.find(key);
+		return it != s_Entries.end() && it->second.State == EntryState::Ready;
+	}
+
+	size_t ShaderCache::GetEntryCount()
+	{
+		std::lock_guard<std::mutex> lock(s_Mutex);
+		return s_Entries.size();
+	}
+
+	ShaderCacheStats ShaderCache::GetStats()
+	{
+		std::lock_guard<std::mutex> lock(s_Mutex);
+		return s_Stats;
+	}
+
+	void ShaderCache::WorkerThread()
+	{
+		s_Context->MakeCurrent();
+
+		while (true)
+		{
+			uint64_t key = 0;
+			ShaderPermutation permutation;
+			{
+				std::unique_lock<std::mutex> lock(s_Mutex);
+				s_QueueCondition.wait(lock, []() { return !s_Running || !s_Queue.empty(); });
+				if (!s_Running)
+				{
+					break;
+				}
+
+				key = s_Queue.front();
+				s_Queue.pop_front();
+				auto it = s_Entries.find(key);
+				// Released, or Get() compiled it in the meantime
+				if (it == s_Entries.end() || it->second.State != EntryState::Queued)
+				{
+					continue;
+				}
+				it->second.State = EntryState::Compiling;
+				permutation = it->second.Permutation;
+			}
+
+			Ref<Shader> shader = Shader::Create(permutation);
+			// Other contexts may only use the program once it is completely linked
+			s_Context->Finish();
+
+			{
+				std::lock_guard<std::mutex> lock(s_Mutex);
+				FinishCompilation(key, shader);
+				s_Stats.CompiledInBackground++;
+			}
+			s_ReadyCondition.notify_all();
+		}
+
+		s_Context->ReleaseCurrent();
+	}
+
+}
@@ -0,0 +1,84 @@
+#pragma once
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <deque>
+#include <unordered_map>
+#include "Suora/Core/Base.h"
+#include "Suora/Renderer/GraphicsContext.h"
+#include "Suora/Renderer/ShaderPermutation.h"
+
+namespace Suora
+{
+	class Shader;
+
+	struct ShaderCacheStats
+	{
+		uint64_t Requests = 0;
+		uint64_t CompiledInBackground = 0;
+		/** Programs that were requested before the background thread got to them */
+		uint64_t CompiledOnDemand = 0;
+		/** Time spent in Get() waiting for or compiling programs */
+		float BlockingTimeMs = 0.0f;
+		/** Entries dropped, because every owner released them */
+		uint64_t Evicted = 0;
+	};
+
+	/* Compiles ShaderPermutations ahead of time on a background thread with a shared GraphicsContext.
+	 * Permutations with equal keys share one Shader. The Shader backend keeps the linked program binaries
+	 * in the DerivedDataCache, so later runs with the same driver skip compilation entirely.
+	 * Without a shared context all Shaders are compiled on demand.
+	 * Entries are reference counted by Prepare() and Release(), so regenerated ShaderGraphs do not leak their old programs. */
+	class ShaderCache
+	{
+	public:
+		/** Call on the main thread, once the first GraphicsContext exists */
+		static void Initialize(GraphicsContext& mainContext);
+		static void Shutdown();
+
+		/** Queues the permutation for the background thread and keeps it cached until it is released. Can be called from any thread. */
+		static void Prepare(const ShaderPermutation& permutation);
+		/** Undoes one Prepare(). Once nobody prepared the key anymore its entry is evicted, Shaders handed out by Get() stay valid. */
+		static void Release(uint64_t key);
+		/** Only blocks if the permutation is not compiled yet. Needs a current GraphicsContext.
+		 *  Permutations that were not prepared are compiled, but not kept. */
+		static Ref<Shader> Get(const ShaderPermutation& permutation);
+		static bool IsReady(uint64_t key);
+		static size_t GetEntryCount();
+
+		static ShaderCacheStats GetStats();
+
+	private:
+		static void WorkerThread();
+		/** Needs s_Mutex. Stores the Shader, or evicts the entry if it was released while compiling. */
+		static void FinishCompilation(uint64_t key, const Ref<Shader>& shader);
+
+		enum class EntryState : uint8_t
+		{
+			None = 0,
+			Queued,
+			Compiling,
+			Ready
+		};
+		struct Entry
+		{
+			EntryState State = EntryState::None;
+			/** Kept until the Shader is compiled */
+			ShaderPermutation Permutation;
+			Ref<Shader> CompiledShader;
+			/** Prepare() calls that were not released yet */
+			uint32_t Users = 0;
+		};
+
+		inline static std::mutex s_Mutex;
+		inline static std::condition_variable s_QueueCondition;
+		inline static std::condition_variable s_ReadyCondition;
+		inline static std::unordered_map<uint64_t, Entry> s_Entries;
+		inline static std::deque<uint64_t> s_Queue;
+		inline static Scope<GraphicsContext> s_Context;
+		inline static std::thread s_Worker;
+		inline static bool s_Running = false;
+		inline static ShaderCacheStats s_Stats;
+	};
+
+}
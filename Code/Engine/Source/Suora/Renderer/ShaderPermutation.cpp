@@ -0,0 +1,87 @@
+#include "Precompiled.h"
+#include "Suora/Renderer/ShaderPermutation.h"
+
+#include "Suora/Renderer/Shader.h"
+#include "Suora/Assets/Material.h"
+#include "Suora/Assets/DerivedDataCache.h"
+
+namespace Suora
+{
+
+	// TODO: Opacity in Fragment shader
+	static const char* s_DepthFragmentSource = "\
+#version 330 core\n\
+\n\
+in vec2 UV;\n\
+out float out_Depth;\n\
+\n\
+\n\
+void main(void)\n\
+{\n\
+	 \n\
+}\n";
+
+	static const char* s_FlatWhiteFragmentSource = "\
+#version 330 core\n\
+\n\
+in vec2 UV;\n\
+out vec4 out_Color;\n\
+\n\
+\n\
+void main(void)\n\
+{\n\
+	out_Color = vec4(1.0);\n\
+}\n";
+
+	static const char* s_IDFragmentSource = "\
+#version 330 core\n\
+\n\
+in vec2 UV;\n\
+out int out_ID;\n\
+uniform int u_ID;\n\
+\n\
+void main(void)\n\
+{\n\
+	out_ID = u_ID;\n\
+}\n";
+
+	uint64_t ShaderPermutation::MakeKey(const String& vertexSource, const String& fragmentSource)
+	{
+		const uint64_t vertexLength = vertexSource.size();
+		uint64_t key = DerivedDataCache::HashBytes(&vertexLength, sizeof(vertexLength));
+		key = DerivedDataCache::HashBytes(vertexSource.data(), vertexSource.size(), key);
+		return DerivedDataCache::HashBytes(fragmentSource.data(), fragmentSource.size(), key);
+	}
+
+	Array<ShaderPermutation> ShaderPermutation::EnumerateShaderGraph(const String& name, const String& shaderGraphSource)
+	{
+		Array<ShaderPermutation> permutations;
+		if (shaderGraphSource == "")
+		{
+			return permutations;
+		}
+
+		// Preprocess once for all permutations
+		std::unordered_map<String, String> sources = Shader::PreProcess(shaderGraphSource);
+		const String& vertex = sources["vertex"];
+		const String& fragment = sources.find("fragment") != sources.end() ? sources["fragment"] : sources["pixel"];
+
+		auto add = [&](MaterialType type, const String& permutationName, const String& fragmentSource)
+		{
+			ShaderPermutation permutation;
+			permutation.Type = type;
+			permutation.Name = permutationName;
+			permutation.VertexSource = vertex;
+			permutation.FragmentSource = fragmentSource;
+			permutation.Key = MakeKey(vertex, fragmentSource);
+			permutations.Add(permutation);
+		};
+		add(MaterialType::Material, name, fragment);
+		add(MaterialType::Depth, "MaterialDepth", s_DepthFragmentSource);
+		add(MaterialType::FlatWhite, "FlatWhite", s_FlatWhiteFragmentSource);
+		add(MaterialType::ObjectID, "IDShader", s_IDFragmentSource);
+
+		return permutations;
+	}
+
+}
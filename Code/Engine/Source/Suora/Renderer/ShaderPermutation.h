@@ -0,0 +1,26 @@
+#pragma once
+#include <cstdint>
+#include "Suora/Common/StringUtils.h"
+#include "Suora/Common/Array.h"
+
+namespace Suora
+{
+	enum class MaterialType : int32_t;
+
+	/** One program a Material can be rendered with. Generating permutations needs no graphics context. */
+	struct ShaderPermutation
+	{
+		MaterialType Type = {};
+		String Name;
+		String VertexSource;
+		String FragmentSource;
+		/** Hash of both sources, permutations with equal keys share one program */
+		uint64_t Key = 0;
+
+		static uint64_t MakeKey(const String& vertexSource, const String& fragmentSource);
+
+		/** The Material, Depth, FlatWhite and ObjectID programs of a generated ShaderGraph source. Empty if the source is empty. */
+		static Array<ShaderPermutation> EnumerateShaderGraph(const String& name, const String& shaderGraphSource);
+	};
+
+}
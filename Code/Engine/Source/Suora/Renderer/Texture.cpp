@@ -1,6 +1,7 @@
 #include "Precompiled.h"
 #include "Suora/Renderer/Texture.h"
 #include "Suora/Assets/AssetManager.h"
+#include "Suora/Assets/VirtualFileSystem.h"
 
 #include "Suora/Renderer/RendererAPI.h"
 #include "Suora/Platform/OpenGL/OpenGLTexture.h"
@@ -13,6 +14,12 @@ namespace Suora
 	TextureBuffer_stbi::TextureBuffer_stbi(const String& path)
 	{
 		stbi_set_flip_vertically_on_load(1);
+		std::vector<uint8_t> packaged;
+		if (VirtualFileSystem::ReadFile(path, packaged))
+		{
+			m_Data = stbi_load_from_memory(packaged.data(), (int)packaged.size(), &m_Width, &m_Height, &m_Channels, 0);
+		}
+		else
 		{
 			m_Data = stbi_load(path.c_str(), &m_Width, &m_Height, &m_Channels, 0);
 		}
@@ -84,6 +91,18 @@ namespace Suora
 		return nullptr;
 	}
 
+	Texture* Texture::CreatePtr(const CookedTexture& cooked)
+	{
+		switch (RendererAPI::GetAPI())
+		{
+			case RendererAPI::API::None:    SUORA_ASSERT(false, "RendererAPI::None is currently not supported!"); return nullptr;
+			case RendererAPI::API::OpenGL:  return new OpenGLTexture2D(cooked);
+		}
+
+		SUORA_ASSERT(false, "Unknown RendererAPI!");
+		return nullptr;
+	}
+
 	static Texture* s_DefaultTexture = nullptr;
 
 	Texture* Texture::GetOrCreateDefaultTexture()
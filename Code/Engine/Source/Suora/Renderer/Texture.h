@@ -13,6 +13,29 @@ namespace Suora
 		Nearest
 	};
 
+	/** Pixel layout of cooked Texture data. Block compressed formats store 4x4 pixel blocks. */
+	enum class ETextureFormat : uint32_t
+	{
+		R8 = 0,
+		RGB8,
+		RGBA8,
+		BC1,
+		BC3,
+		BC5,
+		BC7
+	};
+
+	/** Compression requested by a Texture2D asset. Auto picks a format based on the image content. */
+	enum class ETextureCompression : uint32_t
+	{
+		Auto = 0,
+		None,
+		BC1,
+		BC3,
+		BC5,
+		BC7
+	};
+
 	/** For asynchronous Texture loading */
 	struct TextureBuffer_stbi
 	{
@@ -24,7 +47,22 @@ namespace Suora
 
 		TextureBuffer_stbi(const String& path);
 		~TextureBuffer_stbi();
+	};
 
+	/** Texture data after mip generation and compression, ready to be uploaded as is */
+	struct CookedTexture
+	{
+		ETextureFormat m_Format = ETextureFormat::RGBA8;
+		uint32_t m_Width = 0, m_Height = 0;
+		/** Mip 0 first */
+		std::vector<std::vector<uint8_t>> m_Mips;
+
+		uint64_t GetDataSize() const
+		{
+			uint64_t size = 0;
+			for (const std::vector<uint8_t>& mip : m_Mips) size += mip.size();
+			return size;
+		}
 	};
 //===============================================================
 
@@ -37,6 +75,7 @@ namespace Suora
 		static Texture* CreatePtr(uint32_t width, uint32_t height);
 		static Texture* CreatePtr(const String& path);
 		static Texture* CreatePtr(TextureBuffer_stbi& buffer);
+		static Texture* CreatePtr(const CookedTexture& cooked);
 		static Texture* GetOrCreateDefaultTexture();
 
 		virtual ~Texture() = default;
@@ -44,6 +83,8 @@ namespace Suora
 		virtual uint32_t GetWidth() const = 0;
 		virtual uint32_t GetHeight() const = 0;
 		virtual uint32_t GetRendererID() const = 0;
+		/** Approximate size of the Texture in video memory */
+		virtual uint64_t GetMemorySize() const = 0;
 
 		virtual void SetData(void* data, uint32_t size) = 0;
 		virtual void SetFilter(ETextureFilter filter) = 0;
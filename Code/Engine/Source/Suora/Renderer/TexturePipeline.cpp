@@ -0,0 +1,941 @@
+#include "Precompiled.h"
+#include "TexturePipeline.h"
+#include "Suora/Common/VectorUtils.h"
+#include "Suora/Platform/Platform.h"
+#include "Suora/Core/TaskScheduler.h"
+#include <cstring>
+#include <cmath>
+#include <cfloat>
+
+// SSE2 is part of every x86-64 CPU
+#if defined(_M_X64) || defined(__SSE2__)
+	#include <emmintrin.h>
+	#define SUORA_TEXTURE_SSE2
+#endif
+
+namespace Suora
+{
+	/** BC7 interpolation weights for 4 bit indices */
+	static constexpr int32_t BC7Weights[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+	static const float* GetSRGBToLinearTable()
+	{
+		static const std::array<float, 256> table = []()
+		{
+			std::array<float, 256> t;
+			for (int32_t i = 0; i < 256; i++)
+			{
+				const float c = i / 255.0f;
+				t[i] = c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+			}
+			return t;
+		}();
+		return table.data();
+	}
+
+	static uint8_t LinearToSRGB(float linear)
+	{
+		static const std::array<uint8_t, 4096> table = []()
+		{
+			std::array<uint8_t, 4096> t;
+			for (int32_t i = 0; i < 4096; i++)
+			{
+				const float l = i / 4095.0f;
+				const float c = l <= 0.0031308f ? l * 12.92f : 1.055f * std::pow(l, 1.0f / 2.4f) - 0.055f;
+				t[i] = (uint8_t)glm::clamp(c * 255.0f + 0.5f, 0.0f, 255.0f);
+			}
+			return t;
+		}();
+		return table[(int32_t)(glm::clamp(linear, 0.0f, 1.0f) * 4095.0f + 0.5f)];
+	}
+
+	static uint8_t ToByte(float value)
+	{
+		return (uint8_t)glm::clamp(value + 0.5f, 0.0f, 255.0f);
+	}
+
+#if defined(SUORA_TEXTURE_SSE2)
+	static __m128 LoadPixel(const uint8_t* pixel)
+	{
+		int32_t packed;
+		memcpy(&packed, pixel, sizeof(packed));
+		const __m128i zero = _mm_setzero_si128();
+		return _mm_cvtepi32_ps(_mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(packed), zero), zero));
+	}
+
+	/** Box filters 2x2 blocks of four RGBA8 pixels in two rows to two pixels, rounded like ToByte() */
+	static __m128i Average2x2(__m128i row0, __m128i row1)
+	{
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i left = _mm_add_epi16(_mm_unpacklo_epi8(row0, zero), _mm_unpacklo_epi8(row1, zero));
+		const __m128i right = _mm_add_epi16(_mm_unpackhi_epi8(row0, zero), _mm_unpackhi_epi8(row1, zero));
+		const __m128i sum = _mm_add_epi16(_mm_unpacklo_epi64(left, right), _mm_unpackhi_epi64(left, right));
+		return _mm_srli_epi16(_mm_add_epi16(sum, _mm_set1_epi16(2)), 2);
+	}
+#endif
+
+	/** Per channel sum of four RGBA8 pixels */
+	static Vec4 SumPixels(const uint8_t* const* p)
+	{
+#if defined(SUORA_TEXTURE_SSE2)
+		const __m128 sum = _mm_add_ps(_mm_add_ps(LoadPixel(p[0]), LoadPixel(p[1])), _mm_add_ps(LoadPixel(p[2]), LoadPixel(p[3])));
+		Vec4 result;
+		_mm_storeu_ps(&result.x, sum);
+		return result;
+#else
+		Vec4 sum = Vec4(0.0f);
+		for (int32_t i = 0; i < 4; i++)
+		{
+			sum += Vec4(p[i][0], p[i][1], p[i][2], p[i][3]);
+		}
+		return sum;
+#endif
+	}
+
+	/** Per channel sum of four sRGB pixels in linear space; alpha is linear already.
+	 *  Bound by the table lookups, which SSE2 cannot gather, so it stays scalar. */
+	static Vec4 SumLinearPixels(const uint8_t* const* p, const float* toLinear)
+	{
+		Vec4 sum = Vec4(0.0f);
+		for (int32_t i = 0; i < 4; i++)
+		{
+			sum += Vec4(toLinear[p[i][0]], toLinear[p[i][1]], toLinear[p[i][2]], p[i][3]);
+		}
+		return sum;
+	}
+
+	String TextureCookSettings::ToString() const
+	{
+		return "Compression=" + std::to_string((uint32_t)Compression) + ";Mips=" + std::to_string(GenerateMips)
+			+ ";NormalMap=" + std::to_string(IsNormalMap) + ";SRGB=" + std::to_string(IsSRGB);
+	}
+
+	void TexturePipeline::ParallelFor(uint32_t count, const std::function<void(uint32_t, uint32_t)>& func)
+	{
+		TaskScheduler::ParallelFor(count, func, s_MaxWorkerThreads);
+	}
+
+	bool TexturePipeline::IsBlockCompressed(ETextureFormat format)
+	{
+		return format == ETextureFormat::BC1 || format == ETextureFormat::BC3 || format == ETextureFormat::BC5 || format == ETextureFormat::BC7;
+	}
+
+	uint32_t TexturePipeline::GetFormatBlockSize(ETextureFormat format)
+	{
+		switch (format)
+		{
+		case ETextureFormat::R8: return 1;
+		case ETextureFormat::RGB8: return 3;
+		case ETextureFormat::RGBA8: return 4;
+		case ETextureFormat::BC1: return 8;
+		case ETextureFormat::BC3: return 16;
+		case ETextureFormat::BC5: return 16;
+		case ETextureFormat::BC7: return 16;
+		default: return 4;
+		}
+	}
+
+	uint64_t TexturePipeline::GetMipSize(ETextureFormat format, uint32_t width, uint32_t height)
+	{
+		if (IsBlockCompressed(format))
+		{
+			return (uint64_t)((width + 3) / 4) * (uint64_t)((height + 3) / 4) * GetFormatBlockSize(format);
+		}
+		return (uint64_t)width * (uint64_t)height * GetFormatBlockSize(format);
+	}
+
+	uint32_t TexturePipeline::GetMipCount(uint32_t width, uint32_t height)
+	{
+		uint32_t count = 1;
+		while (width > 1 || height > 1)
+		{
+			width = glm::max(1u, width / 2);
+			height = glm::max(1u, height / 2);
+			count++;
+		}
+		return count;
+	}
+
+	ETextureFormat TexturePipeline::ResolveFormat(const TextureCookSettings& settings, int32_t channels, bool hasAlpha)
+	{
+		switch (settings.Compression)
+		{
+		case ETextureCompression::BC1: return ETextureFormat::BC1;
+		case ETextureCompression::BC3: return ETextureFormat::BC3;
+		case ETextureCompression::BC5: return ETextureFormat::BC5;
+		case ETextureCompression::BC7: return ETextureFormat::BC7;
+		case ETextureCompression::None:
+			if (channels == 1) return ETextureFormat::R8;
+			if (channels == 3) return ETextureFormat::RGB8;
+			return ETextureFormat::RGBA8;
+		case ETextureCompression::Auto:
+		default:
+			// Single channel Textures are sampled as R, a block format would have to replicate them
+			if (channels == 1) return ETextureFormat::R8;
+			// BC7 keeps all three normal components, BC5 needs the shader to reconstruct Z
+			if (settings.IsNormalMap) return ETextureFormat::BC7;
+			return hasAlpha ? ETextureFormat::BC7 : ETextureFormat::BC1;
+		}
+	}
+
+	std::vector<uint8_t> TexturePipeline::GenerateMip(const std::vector<uint8_t>& rgba, uint32_t width, uint32_t height, const TextureCookSettings& settings)
+	{
+		const uint32_t mipWidth = glm::max(1u, width / 2), mipHeight = glm::max(1u, height / 2);
+		std::vector<uint8_t> mip((size_t)mipWidth * mipHeight * 4);
+		const float* toLinear = GetSRGBToLinearTable();
+
+		ParallelFor(mipHeight, [&](uint32_t rowBegin, uint32_t rowEnd)
+		{
+			for (uint32_t y = rowBegin; y < rowEnd; y++)
+			{
+				const uint32_t y0 = glm::min(y * 2, height - 1), y1 = glm::min(y * 2 + 1, height - 1);
+				uint32_t x = 0;
+#if defined(SUORA_TEXTURE_SSE2)
+				if (s_UseSIMD && !settings.IsNormalMap && !settings.IsSRGB)
+				{
+					// Four pixels per iteration, as long as no source pixel has to be clamped to the border
+					const uint8_t* row0 = &rgba[(size_t)y0 * width * 4];
+					const uint8_t* row1 = &rgba[(size_t)y1 * width * 4];
+					uint8_t* out = &mip[(size_t)y * mipWidth * 4];
+					for (; x + 4 <= width / 2; x += 4)
+					{
+						const __m128i first = Average2x2(_mm_loadu_si128((const __m128i*)(row0 + x * 8)), _mm_loadu_si128((const __m128i*)(row1 + x * 8)));
+						const __m128i second = Average2x2(_mm_loadu_si128((const __m128i*)(row0 + x * 8 + 16)), _mm_loadu_si128((const __m128i*)(row1 + x * 8 + 16)));
+						_mm_storeu_si128((__m128i*)(out + x * 4), _mm_packus_epi16(first, second));
+					}
+				}
+#endif
+				for (; x < mipWidth; x++)
+				{
+					const uint32_t x0 = glm::min(x * 2, width - 1), x1 = glm::min(x * 2 + 1, width - 1);
+					const uint8_t* p[4] = { &rgba[((size_t)y0 * width + x0) * 4], &rgba[((size_t)y0 * width + x1) * 4],
+											&rgba[((size_t)y1 * width + x0) * 4], &rgba[((size_t)y1 * width + x1) * 4] };
+					uint8_t* out = &mip[((size_t)y * mipWidth + x) * 4];
+
+					if (settings.IsNormalMap)
+					{
+						// Average the unit vectors and renormalize, averaging the colors would shorten the normals
+						const Vec4 sum = SumPixels(p);
+						Vec3 normal = Vec3(sum) / 127.5f - 4.0f;
+						const float length = glm::length(normal);
+						normal = length > 0.0001f ? normal / length : Vec3(0.0f, 0.0f, 1.0f);
+						normal = (normal + 1.0f) * 127.5f;
+						out[0] = ToByte(normal.x); out[1] = ToByte(normal.y); out[2] = ToByte(normal.z); out[3] = ToByte(sum.w * 0.25f);
+					}
+					else if (settings.IsSRGB)
+					{
+						const Vec4 sum = SumLinearPixels(p, toLinear) * 0.25f;
+						out[0] = LinearToSRGB(sum.x); out[1] = LinearToSRGB(sum.y); out[2] = LinearToSRGB(sum.z); out[3] = ToByte(sum.w);
+					}
+					else
+					{
+						const Vec4 sum = SumPixels(p) * 0.25f;
+						out[0] = ToByte(sum.x); out[1] = ToByte(sum.y); out[2] = ToByte(sum.z); out[3] = ToByte(sum.w);
+					}
+				}
+			}
+		});
+
+		return mip;
+	}
+
+	/** Copies a 4x4 block, pixels outside of the image are clamped to the border */
+	static void FetchBlock(const uint8_t* rgba, uint32_t width, uint32_t height, uint32_t blockX, uint32_t blockY, uint8_t* block)
+	{
+		for (uint32_t y = 0; y < 4; y++)
+		{
+			const uint32_t py = glm::min(blockY * 4 + y, height - 1);
+			for (uint32_t x = 0; x < 4; x++)
+			{
+				const uint32_t px = glm::min(blockX * 4 + x, width - 1);
+				memcpy(&block[(y * 4 + x) * 4], &rgba[((size_t)py * width + px) * 4], 4);
+			}
+		}
+	}
+
+	static void StoreBlock(const uint8_t* block, uint32_t width, uint32_t height, uint32_t blockX, uint32_t blockY, uint8_t* rgba)
+	{
+		for (uint32_t y = 0; y < 4 && blockY * 4 + y < height; y++)
+		{
+			for (uint32_t x = 0; x < 4 && blockX * 4 + x < width; x++)
+			{
+				memcpy(&rgba[((size_t)(blockY * 4 + y) * width + blockX * 4 + x) * 4], &block[(y * 4 + x) * 4], 4);
+			}
+		}
+	}
+
+	std::vector<uint8_t> TexturePipeline::Encode(const uint8_t* rgba, uint32_t width, uint32_t height, ETextureFormat format)
+	{
+		std::vector<uint8_t> data(GetMipSize(format, width, height));
+
+		if (!IsBlockCompressed(format))
+		{
+			const uint32_t channels = GetFormatBlockSize(format);
+			const size_t pixelCount = (size_t)width * height;
+			for (size_t i = 0; i < pixelCount; i++)
+			{
+				memcpy(&data[i * channels], &rgba[i * 4], channels);
+			}
+			return data;
+		}
+
+		const uint32_t blocksX = (width + 3) / 4, blocksY = (height + 3) / 4;
+		const uint32_t blockSize = GetFormatBlockSize(format);
+
+		ParallelFor(blocksY, [&](uint32_t rowBegin, uint32_t rowEnd)
+		{
+			uint8_t pixels[64];
+			for (uint32_t by = rowBegin; by < rowEnd; by++)
+			{
+				for (uint32_t bx = 0; bx < blocksX; bx++)
+				{
+					uint8_t* block = &data[((size_t)by * blocksX + bx) * blockSize];
+					FetchBlock(rgba, width, height, bx, by, pixels);
+					switch (format)
+					{
+					case ETextureFormat::BC1:
+						EncodeBC1Block(pixels, block);
+						break;
+					case ETextureFormat::BC3:
+						EncodeBC4Block(pixels, 3, block);
+						EncodeBC1Block(pixels, block + 8);
+						break;
+					case ETextureFormat::BC5:
+						EncodeBC4Block(pixels, 0, block);
+						EncodeBC4Block(pixels, 1, block + 8);
+						break;
+					case ETextureFormat::BC7:
+						EncodeBC7Block(pixels, block);
+						break;
+					default:
+						break;
+					}
+				}
+			}
+		});
+
+		return data;
+	}
+
+	std::vector<uint8_t> TexturePipeline::Decode(const uint8_t* data, uint32_t width, uint32_t height, ETextureFormat format)
+	{
+		std::vector<uint8_t> rgba((size_t)width * height * 4, 255);
+
+		if (!IsBlockCompressed(format))
+		{
+			const uint32_t channels = GetFormatBlockSize(format);
+			const size_t pixelCount = (size_t)width * height;
+			for (size_t i = 0; i < pixelCount; i++)
+			{
+				memcpy(&rgba[i * 4], &data[i * channels], channels);
+			}
+			return rgba;
+		}
+
+		const uint32_t blocksX = (width + 3) / 4, blocksY = (height + 3) / 4;
+		const uint32_t blockSize = GetFormatBlockSize(format);
+
+		ParallelFor(blocksY, [&](uint32_t rowBegin, uint32_t rowEnd)
+		{
+			uint8_t pixels[64];
+			for (uint32_t by = rowBegin; by < rowEnd; by++)
+			{
+				for (uint32_t bx = 0; bx < blocksX; bx++)
+				{
+					const uint8_t* block = &data[((size_t)by * blocksX + bx) * blockSize];
+					memset(pixels, 255, sizeof(pixels));
+					switch (format)
+					{
+					case ETextureFormat::BC1:
+						DecodeBC1Block(block, pixels);
+						break;
+					case ETextureFormat::BC3:
+						DecodeBC1Block(block + 8, pixels);
+						DecodeBC4Block(block, 3, pixels);
+						break;
+					case ETextureFormat::BC5:
+						DecodeBC4Block(block, 0, pixels);
+						DecodeBC4Block(block + 8, 1, pixels);
+						for (int32_t i = 0; i < 16; i++) pixels[i * 4 + 2] = 0;
+						break;
+					case ETextureFormat::BC7:
+						DecodeBC7Block(block, pixels);
+						break;
+					default:
+						break;
+					}
+					StoreBlock(pixels, width, height, bx, by, rgba.data());
+				}
+			}
+		});
+
+		return rgba;
+	}
+
+	float TexturePipeline::ComputePSNR(const uint8_t* a, const uint8_t* b, uint32_t width, uint32_t height, uint32_t channels)
+	{
+		const size_t pixelCount = (size_t)width * height;
+		double squaredError = 0.0;
+		for (size_t i = 0; i < pixelCount; i++)
+		{
+			for (uint32_t c = 0; c < channels; c++)
+			{
+				const double delta = (double)a[i * 4 + c] - (double)b[i * 4 + c];
+				squaredError += delta * delta;
+			}
+		}
+
+		const double mse = squaredError / (double)(pixelCount * channels);
+		if (mse <= 0.0)
+		{
+			return 99.0f;
+		}
+		return (float)(10.0 * std::log10(255.0 * 255.0 / mse));
+	}
+
+	// ---------------------------------------------------------------- Endpoint fitting
+
+	/** Principal axis of the points through power iteration on the covariance matrix */
+	template<int32_t N>
+	static glm::vec<N, float> PrincipalAxis(const glm::vec<N, float>* points, int32_t count, const glm::vec<N, float>& mean)
+	{
+		using VecN = glm::vec<N, float>;
+		float covariance[N][N] = {};
+		VecN minPoint = points[0], maxPoint = points[0];
+		for (int32_t i = 0; i < count; i++)
+		{
+			const VecN d = points[i] - mean;
+			for (int32_t r = 0; r < N; r++)
+			{
+				for (int32_t c = 0; c < N; c++)
+				{
+					covariance[r][c] += d[r] * d[c];
+				}
+			}
+			minPoint = glm::min(minPoint, points[i]);
+			maxPoint = glm::max(maxPoint, points[i]);
+		}
+
+		// The bounding box diagonal is a good first guess and avoids iterating from a degenerate vector
+		VecN axis = maxPoint - minPoint;
+		if (glm::dot(axis, axis) < 0.0001f)
+		{
+			return VecN(0.0f);
+		}
+		for (int32_t iteration = 0; iteration < 8; iteration++)
+		{
+			VecN next = VecN(0.0f);
+			for (int32_t r = 0; r < N; r++)
+			{
+				for (int32_t c = 0; c < N; c++)
+				{
+					next[r] += covariance[r][c] * axis[c];
+				}
+			}
+			const float length = glm::length(next);
+			if (length < 0.0001f)
+			{
+				break;
+			}
+			axis = next / length;
+		}
+		return glm::normalize(axis);
+	}
+
+	/** Solves the endpoints that minimize the squared error for given interpolation weights (0 = first, 1 = second endpoint) */
+	template<int32_t N>
+	static bool LeastSquaresEndpoints(const glm::vec<N, float>* points, const float* weights, int32_t count, glm::vec<N, float>& e0, glm::vec<N, float>& e1)
+	{
+		using VecN = glm::vec<N, float>;
+		float aa = 0.0f, ab = 0.0f, bb = 0.0f;
+		VecN ax = VecN(0.0f), bx = VecN(0.0f);
+		for (int32_t i = 0; i < count; i++)
+		{
+			const float b = weights[i], a = 1.0f - b;
+			aa += a * a; ab += a * b; bb += b * b;
+			ax += a * points[i];
+			bx += b * points[i];
+		}
+
+		const float det = aa * bb - ab * ab;
+		if (std::abs(det) < 0.0001f)
+		{
+			return false;
+		}
+		e0 = glm::clamp((ax * bb - bx * ab) / det, VecN(0.0f), VecN(255.0f));
+		e1 = glm::clamp((bx * aa - ax * ab) / det, VecN(0.0f), VecN(255.0f));
+		return true;
+	}
+
+	// ---------------------------------------------------------------- BC1
+
+	static uint16_t PackRGB565(const Vec3& color)
+	{
+		const uint32_t r = (uint32_t)glm::clamp(color.r * 31.0f / 255.0f + 0.5f, 0.0f, 31.0f);
+		const uint32_t g = (uint32_t)glm::clamp(color.g * 63.0f / 255.0f + 0.5f, 0.0f, 63.0f);
+		const uint32_t b = (uint32_t)glm::clamp(color.b * 31.0f / 255.0f + 0.5f, 0.0f, 31.0f);
+		return (uint16_t)((r << 11) | (g << 5) | b);
+	}
+
+	static Vec3 UnpackRGB565(uint16_t color)
+	{
+		const uint32_t r = (color >> 11) & 31, g = (color >> 5) & 63, b = color & 31;
+		return Vec3((float)((r << 3) | (r >> 2)), (float)((g << 2) | (g >> 4)), (float)((b << 3) | (b >> 2)));
+	}
+
+	/** Picks the closest four color palette entry per pixel, returns the squared error */
+	static float FitBC1Indices(const Vec3* colors, uint16_t c0, uint16_t c1, uint32_t& indices)
+	{
+		const Vec3 e0 = UnpackRGB565(c0), e1 = UnpackRGB565(c1);
+		const Vec3 palette[4] = { e0, e1, (2.0f * e0 + e1) / 3.0f, (e0 + 2.0f * e1) / 3.0f };
+
+		float error = 0.0f;
+		indices = 0;
+		for (int32_t i = 0; i < 16; i++)
+		{
+			float bestError = FLT_MAX;
+			uint32_t best = 0;
+			for (uint32_t p = 0; p < 4; p++)
+			{
+				const Vec3 d = colors[i] - palette[p];
+				const float e = glm::dot(d, d);
+				if (e < bestError)
+				{
+					bestError = e;
+					best = p;
+				}
+			}
+			indices |= best << (i * 2);
+			error += bestError;
+		}
+		return error;
+	}
+
+	static void WriteBC1(uint8_t* block, uint16_t c0, uint16_t c1, uint32_t indices)
+	{
+		block[0] = (uint8_t)(c0 & 0xFF); block[1] = (uint8_t)(c0 >> 8);
+		block[2] = (uint8_t)(c1 & 0xFF); block[3] = (uint8_t)(c1 >> 8);
+		block[4] = (uint8_t)(indices & 0xFF); block[5] = (uint8_t)((indices >> 8) & 0xFF);
+		block[6] = (uint8_t)((indices >> 16) & 0xFF); block[7] = (uint8_t)(indices >> 24);
+	}
+
+	void TexturePipeline::EncodeBC1Block(const uint8_t* rgba, uint8_t* block)
+	{
+		Vec3 colors[16];
+		Vec3 mean = Vec3(0.0f);
+		for (int32_t i = 0; i < 16; i++)
+		{
+			colors[i] = Vec3(rgba[i * 4 + 0], rgba[i * 4 + 1], rgba[i * 4 + 2]);
+			mean += colors[i];
+		}
+		mean /= 16.0f;
+
+		const Vec3 axis = PrincipalAxis<3>(colors, 16, mean);
+		float minT = 0.0f, maxT = 0.0f;
+		for (int32_t i = 0; i < 16; i++)
+		{
+			const float t = glm::dot(colors[i] - mean, axis);
+			minT = glm::min(minT, t);
+			maxT = glm::max(maxT, t);
+		}
+
+		uint16_t c0 = PackRGB565(glm::clamp(mean + axis * maxT, 0.0f, 255.0f));
+		uint16_t c1 = PackRGB565(glm::clamp(mean + axis * minT, 0.0f, 255.0f));
+		uint32_t indices = 0;
+		float error = FitBC1Indices(colors, c0, c1, indices);
+
+		// One refinement step with the endpoints that fit the chosen indices best
+		static constexpr float IndexWeights[4] = { 0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f };
+		float weights[16];
+		for (int32_t i = 0; i < 16; i++) weights[i] = IndexWeights[(indices >> (i * 2)) & 3];
+		Vec3 e0, e1;
+		if (LeastSquaresEndpoints<3>(colors, weights, 16, e0, e1))
+		{
+			const uint16_t r0 = PackRGB565(e0), r1 = PackRGB565(e1);
+			uint32_t refinedIndices = 0;
+			const float refinedError = FitBC1Indices(colors, r0, r1, refinedIndices);
+			if (refinedError < error)
+			{
+				c0 = r0; c1 = r1; indices = refinedIndices; error = refinedError;
+			}
+		}
+
+		// c0 > c1 selects the four color mode, the indices have to follow the swap
+		if (c0 < c1)
+		{
+			std::swap(c0, c1);
+			indices ^= 0x55555555;
+		}
+		else if (c0 == c1)
+		{
+			indices = 0;
+		}
+		WriteBC1(block, c0, c1, indices);
+	}
+
+	void TexturePipeline::DecodeBC1Block(const uint8_t* block, uint8_t* rgba)
+	{
+		const uint16_t c0 = (uint16_t)(block[0] | (block[1] << 8)), c1 = (uint16_t)(block[2] | (block[3] << 8));
+		const uint32_t indices = block[4] | (block[5] << 8) | (block[6] << 16) | ((uint32_t)block[7] << 24);
+		const Vec3 e0 = UnpackRGB565(c0), e1 = UnpackRGB565(c1);
+
+		Vec4 palette[4];
+		palette[0] = Vec4(e0, 255.0f);
+		palette[1] = Vec4(e1, 255.0f);
+		if (c0 > c1)
+		{
+			palette[2] = Vec4((2.0f * e0 + e1) / 3.0f, 255.0f);
+			palette[3] = Vec4((e0 + 2.0f * e1) / 3.0f, 255.0f);
+		}
+		else
+		{
+			palette[2] = Vec4((e0 + e1) * 0.5f, 255.0f);
+			palette[3] = Vec4(0.0f);
+		}
+
+		for (int32_t i = 0; i < 16; i++)
+		{
+			const Vec4& color = palette[(indices >> (i * 2)) & 3];
+			rgba[i * 4 + 0] = ToByte(color.r); rgba[i * 4 + 1] = ToByte(color.g);
+			rgba[i * 4 + 2] = ToByte(color.b); rgba[i * 4 + 3] = ToByte(color.a);
+		}
+	}
+
+	// ---------------------------------------------------------------- BC4 (BC3 alpha, BC5 channels)
+
+	static void GetBC4Palette(uint8_t a0, uint8_t a1, int32_t* palette)
+	{
+		palette[0] = a0;
+		palette[1] = a1;
+		if (a0 > a1)
+		{
+			for (int32_t i = 2; i < 8; i++) palette[i] = ((8 - i) * a0 + (i - 1) * a1) / 7;
+		}
+		else
+		{
+			for (int32_t i = 2; i < 6; i++) palette[i] = ((6 - i) * a0 + (i - 1) * a1) / 5;
+			palette[6] = 0;
+			palette[7] = 255;
+		}
+	}
+
+	void TexturePipeline::EncodeBC4Block(const uint8_t* rgba, uint32_t channel, uint8_t* block)
+	{
+		uint8_t minValue = 255, maxValue = 0;
+		for (int32_t i = 0; i < 16; i++)
+		{
+			minValue = glm::min(minValue, rgba[i * 4 + channel]);
+			maxValue = glm::max(maxValue, rgba[i * 4 + channel]);
+		}
+
+		block[0] = maxValue;
+		block[1] = minValue;
+		uint64_t indices = 0;
+		if (maxValue != minValue)
+		{
+			int32_t palette[8];
+			GetBC4Palette(maxValue, minValue, palette);
+			for (int32_t i = 0; i < 16; i++)
+			{
+				const int32_t value = rgba[i * 4 + channel];
+				int32_t bestError = INT32_MAX;
+				uint64_t best = 0;
+				for (int32_t p = 0; p < 8; p++)
+				{
+					const int32_t e = std::abs(value - palette[p]);
+					if (e < bestError)
+					{
+						bestError = e;
+						best = (uint64_t)p;
+					}
+				}
+				indices |= best << (i * 3);
+			}
+		}
+		for (int32_t i = 0; i < 6; i++)
+		{
+			block[2 + i] = (uint8_t)((indices >> (i * 8)) & 0xFF);
+		}
+	}
+
+	void TexturePipeline::DecodeBC4Block(const uint8_t* block, uint32_t channel, uint8_t* rgba)
+	{
+		int32_t palette[8];
+		GetBC4Palette(block[0], block[1], palette);
+
+		uint64_t indices = 0;
+		for (int32_t i = 0; i < 6; i++)
+		{
+			indices |= (uint64_t)block[2 + i] << (i * 8);
+		}
+		for (int32_t i = 0; i < 16; i++)
+		{
+			rgba[i * 4 + channel] = (uint8_t)palette[(indices >> (i * 3)) & 7];
+		}
+	}
+
+	// ---------------------------------------------------------------- BC7 (Mode 6: one subset, RGBA 7.7.7.7 endpoints with unique P-bits, 4 bit indices)
+
+	struct BC7BitWriter
+	{
+		uint8_t* Block;
+		uint32_t Offset = 0;
+
+		void Write(uint32_t value, uint32_t bits)
+		{
+			for (uint32_t i = 0; i < bits; i++, Offset++)
+			{
+				if ((value >> i) & 1) Block[Offset / 8] |= (uint8_t)(1 << (Offset % 8));
+			}
+		}
+	};
+
+	struct BC7BitReader
+	{
+		const uint8_t* Block;
+		uint32_t Offset = 0;
+
+		uint32_t Read(uint32_t bits)
+		{
+			uint32_t value = 0;
+			for (uint32_t i = 0; i < bits; i++, Offset++)
+			{
+				value |= (uint32_t)((Block[Offset / 8] >> (Offset % 8)) & 1) << i;
+			}
+			return value;
+		}
+	};
+
+	struct BC7Endpoint
+	{
+		uint32_t Value[4];
+		uint32_t PBit = 0;
+
+		Vec4 Unpack() const
+		{
+			return Vec4((float)((Value[0] << 1) | PBit), (float)((Value[1] << 1) | PBit), (float)((Value[2] << 1) | PBit), (float)((Value[3] << 1) | PBit));
+		}
+	};
+
+	/** Quantizes to 7 bits per channel, the shared P-bit is chosen by the lower error */
+	static BC7Endpoint QuantizeBC7Endpoint(const Vec4& endpoint)
+	{
+		BC7Endpoint best;
+		float bestError = FLT_MAX;
+		for (uint32_t pBit = 0; pBit < 2; pBit++)
+		{
+			BC7Endpoint candidate;
+			candidate.PBit = pBit;
+			for (int32_t c = 0; c < 4; c++)
+			{
+				candidate.Value[c] = (uint32_t)glm::clamp((endpoint[c] - pBit) * 0.5f + 0.5f, 0.0f, 127.0f);
+			}
+			const Vec4 d = candidate.Unpack() - endpoint;
+			const float error = glm::dot(d, d);
+			if (error < bestError)
+			{
+				bestError = error;
+				best = candidate;
+			}
+		}
+		return best;
+	}
+
+	static float FitBC7Indices(const Vec4* pixels, const BC7Endpoint& e0, const BC7Endpoint& e1, uint8_t* indices)
+	{
+		const Vec4 a = e0.Unpack(), b = e1.Unpack();
+		Vec4 palette[16];
+		for (int32_t i = 0; i < 16; i++)
+		{
+			palette[i] = glm::floor(((64.0f - BC7Weights[i]) * a + (float)BC7Weights[i] * b + 32.0f) / 64.0f);
+		}
+
+		float error = 0.0f;
+		for (int32_t i = 0; i < 16; i++)
+		{
+			float bestError = FLT_MAX;
+			for (uint8_t p = 0; p < 16; p++)
+			{
+				const Vec4 d = pixels[i] - palette[p];
+				const float e = glm::dot(d, d);
+				if (e < bestError)
+				{
+					bestError = e;
+					indices[i] = p;
+				}
+			}
+			error += bestError;
+		}
+		return error;
+	}
+
+	void TexturePipeline::EncodeBC7Block(const uint8_t* rgba, uint8_t* block)
+	{
+		Vec4 pixels[16];
+		Vec4 mean = Vec4(0.0f);
+		for (int32_t i = 0; i < 16; i++)
+		{
+			pixels[i] = Vec4(rgba[i * 4 + 0], rgba[i * 4 + 1], rgba[i * 4 + 2], rgba[i * 4 + 3]);
+			mean += pixels[i];
+		}
+		mean /= 16.0f;
+
+		const Vec4 axis = PrincipalAxis<4>(pixels, 16, mean);
+		float minT = 0.0f, maxT = 0.0f;
+		for (int32_t i = 0; i < 16; i++)
+		{
+			const float t = glm::dot(pixels[i] - mean, axis);
+			minT = glm::min(minT, t);
+			maxT = glm::max(maxT, t);
+		}
+
+		BC7Endpoint e0 = QuantizeBC7Endpoint(glm::clamp(mean + axis * minT, 0.0f, 255.0f));
+		BC7Endpoint e1 = QuantizeBC7Endpoint(glm::clamp(mean + axis * maxT, 0.0f, 255.0f));
+		uint8_t indices[16];
+		float error = FitBC7Indices(pixels, e0, e1, indices);
+
+		float weights[16];
+		for (int32_t i = 0; i < 16; i++) weights[i] = BC7Weights[indices[i]] / 64.0f;
+		Vec4 r0, r1;
+		if (LeastSquaresEndpoints<4>(pixels, weights, 16, r0, r1))
+		{
+			const BC7Endpoint q0 = QuantizeBC7Endpoint(r0), q1 = QuantizeBC7Endpoint(r1);
+			uint8_t refinedIndices[16];
+			const float refinedError = FitBC7Indices(pixels, q0, q1, refinedIndices);
+			if (refinedError < error)
+			{
+				e0 = q0; e1 = q1; error = refinedError;
+				memcpy(indices, refinedIndices, sizeof(indices));
+			}
+		}
+
+		// The most significant bit of the first index is implicit zero, the weights are symmetric so swapping the endpoints mirrors the indices
+		if (indices[0] >= 8)
+		{
+			std::swap(e0, e1);
+			for (int32_t i = 0; i < 16; i++) indices[i] = 15 - indices[i];
+		}
+
+		memset(block, 0, 16);
+		BC7BitWriter writer{ block };
+		writer.Write(1 << 6, 7);
+		for (int32_t c = 0; c < 4; c++)
+		{
+			writer.Write(e0.Value[c], 7);
+			writer.Write(e1.Value[c], 7);
+		}
+		writer.Write(e0.PBit, 1);
+		writer.Write(e1.PBit, 1);
+		writer.Write(indices[0], 3);
+		for (int32_t i = 1; i < 16; i++)
+		{
+			writer.Write(indices[i], 4);
+		}
+	}
+
+	void TexturePipeline::DecodeBC7Block(const uint8_t* block, uint8_t* rgba)
+	{
+		BC7BitReader reader{ block };
+		if (reader.Read(7) != (1 << 6))
+		{
+			// Only Mode 6 is produced by the encoder, other modes decode to magenta
+			for (int32_t i = 0; i < 16; i++)
+			{
+				rgba[i * 4 + 0] = 255; rgba[i * 4 + 1] = 0; rgba[i * 4 + 2] = 255; rgba[i * 4 + 3] = 255;
+			}
+			return;
+		}
+
+		BC7Endpoint e0, e1;
+		for (int32_t c = 0; c < 4; c++)
+		{
+			e0.Value[c] = reader.Read(7);
+			e1.Value[c] = reader.Read(7);
+		}
+		e0.PBit = reader.Read(1);
+		e1.PBit = reader.Read(1);
+
+		const Vec4 a = e0.Unpack(), b = e1.Unpack();
+		for (int32_t i = 0; i < 16; i++)
+		{
+			const int32_t weight = BC7Weights[reader.Read(i == 0 ? 3 : 4)];
+			for (int32_t c = 0; c < 4; c++)
+			{
+				rgba[i * 4 + c] = (uint8_t)(((64 - weight) * (int32_t)a[c] + weight * (int32_t)b[c] + 32) >> 6);
+			}
+		}
+	}
+
+	// ---------------------------------------------------------------- Cooking
+
+	Ref<CookedTexture> TexturePipeline::Cook(const TextureBuffer_stbi& source, const TextureCookSettings& settings, TextureCookStats* stats)
+	{
+		if (!source.m_Data || source.m_Width <= 0 || source.m_Height <= 0)
+		{
+			return nullptr;
+		}
+		const float startTime = Platform::GetTime();
+		const uint32_t width = (uint32_t)source.m_Width, height = (uint32_t)source.m_Height;
+		const size_t pixelCount = (size_t)width * height;
+
+		// Everything is processed as RGBA8, stb_image returns grey, grey-alpha, RGB or RGBA
+		std::vector<uint8_t> level(pixelCount * 4);
+		bool hasAlpha = false;
+		for (size_t i = 0; i < pixelCount; i++)
+		{
+			const uint8_t* src = &source.m_Data[i * source.m_Channels];
+			uint8_t* dst = &level[i * 4];
+			switch (source.m_Channels)
+			{
+			case 1: dst[0] = dst[1] = dst[2] = src[0]; dst[3] = 255; break;
+			case 2: dst[0] = dst[1] = dst[2] = src[0]; dst[3] = src[1]; break;
+			case 3: dst[0] = src[0]; dst[1] = src[1]; dst[2] = src[2]; dst[3] = 255; break;
+			default: memcpy(dst, src, 4); break;
+			}
+			hasAlpha |= dst[3] != 255;
+		}
+
+		Ref<CookedTexture> cooked = CreateRef<CookedTexture>();
+		cooked->m_Format = ResolveFormat(settings, source.m_Channels, hasAlpha);
+		cooked->m_Width = width;
+		cooked->m_Height = height;
+
+		uint32_t mipWidth = width, mipHeight = height;
+		while (true)
+		{
+			cooked->m_Mips.push_back(Encode(level.data(), mipWidth, mipHeight, cooked->m_Format));
+
+			if (stats && cooked->m_Mips.size() == 1)
+			{
+				stats->PSNR = 0.0f;
+				if (s_MeasureQuality && IsBlockCompressed(cooked->m_Format))
+				{
+					const uint32_t channels = cooked->m_Format == ETextureFormat::BC5 ? 2 : (cooked->m_Format == ETextureFormat::BC1 ? 3 : 4);
+					const std::vector<uint8_t> decoded = Decode(cooked->m_Mips[0].data(), width, height, cooked->m_Format);
+					stats->PSNR = ComputePSNR(level.data(), decoded.data(), width, height, channels);
+				}
+			}
+
+			if (!settings.GenerateMips || (mipWidth == 1 && mipHeight == 1))
+			{
+				break;
+			}
+			level = GenerateMip(level, mipWidth, mipHeight, settings);
+			mipWidth = glm::max(1u, mipWidth / 2);
+			mipHeight = glm::max(1u, mipHeight / 2);
+		}
+
+		if (stats)
+		{
+			stats->Format = cooked->m_Format;
+			stats->MipCount = (uint32_t)cooked->m_Mips.size();
+			stats->SourceSize = pixelCount * source.m_Channels;
+			stats->CookedSize = cooked->GetDataSize();
+			stats->CookTime = Platform::GetTime() - startTime;
+			stats->MegapixelsPerSecond = stats->CookTime > 0.0f ? (float)(pixelCount / 1000000.0) / stats->CookTime : 0.0f;
+		}
+
+		return cooked;
+	}
+
+}
@@ -0,0 +1,80 @@
+#pragma once
+#include <vector>
+#include <functional>
+#include "Suora/Core/Base.h"
+#include "Suora/Renderer/Texture.h"
+
+namespace Suora
+{
+
+	struct TextureCookSettings
+	{
+		ETextureCompression Compression = ETextureCompression::Auto;
+		bool GenerateMips = true;
+		/** Mips are renormalized instead of averaged in color space */
+		bool IsNormalMap = false;
+		/** Color Textures are filtered in linear space. Disable for data Textures (e.g. roughness). */
+		bool IsSRGB = true;
+
+		/** Part of the DerivedDataCache key */
+		String ToString() const;
+	};
+
+	struct TextureCookStats
+	{
+		ETextureFormat Format = ETextureFormat::RGBA8;
+		uint32_t MipCount = 0;
+		uint64_t SourceSize = 0;
+		uint64_t CookedSize = 0;
+		float CookTime = 0.0f;
+		float MegapixelsPerSecond = 0.0f;
+		/** Peak signal-to-noise ratio of Mip 0 in dB, 0 if the format is lossless or s_MeasureQuality is off */
+		float PSNR = 0.0f;
+	};
+
+	/* Turns decoded images into CookedTextures: Mip generation and CPU block compression (BC1, BC3, BC5, BC7).
+	 * All stages are split across worker threads and can be called from asynchronous loading threads.
+	 * Note: BC5 only stores two channels, shaders have to reconstruct the Z component of BC5 normal maps. */
+	class TexturePipeline
+	{
+	public:
+		static Ref<CookedTexture> Cook(const TextureBuffer_stbi& source, const TextureCookSettings& settings, TextureCookStats* stats = nullptr);
+
+		static ETextureFormat ResolveFormat(const TextureCookSettings& settings, int32_t channels, bool hasAlpha);
+		static bool IsBlockCompressed(ETextureFormat format);
+		/** Bytes per 4x4 block for compressed formats, bytes per pixel otherwise */
+		static uint32_t GetFormatBlockSize(ETextureFormat format);
+		static uint64_t GetMipSize(ETextureFormat format, uint32_t width, uint32_t height);
+		static uint32_t GetMipCount(uint32_t width, uint32_t height);
+
+		/** Downsamples a RGBA8 image by two with a box filter */
+		static std::vector<uint8_t> GenerateMip(const std::vector<uint8_t>& rgba, uint32_t width, uint32_t height, const TextureCookSettings& settings);
+
+		/** RGBA8 pixels to the layout of the format */
+		static std::vector<uint8_t> Encode(const uint8_t* rgba, uint32_t width, uint32_t height, ETextureFormat format);
+		/** The layout of the format back to RGBA8 pixels */
+		static std::vector<uint8_t> Decode(const uint8_t* data, uint32_t width, uint32_t height, ETextureFormat format);
+
+		/** Compares the first 'channels' channels of two RGBA8 images */
+		static float ComputePSNR(const uint8_t* a, const uint8_t* b, uint32_t width, uint32_t height, uint32_t channels);
+
+		// Single 4x4 blocks, the input is always 16 RGBA8 pixels
+		static void EncodeBC1Block(const uint8_t* rgba, uint8_t* block);
+		static void EncodeBC4Block(const uint8_t* rgba, uint32_t channel, uint8_t* block);
+		static void EncodeBC7Block(const uint8_t* rgba, uint8_t* block);
+		static void DecodeBC1Block(const uint8_t* block, uint8_t* rgba);
+		static void DecodeBC4Block(const uint8_t* block, uint32_t channel, uint8_t* rgba);
+		static void DecodeBC7Block(const uint8_t* block, uint8_t* rgba);
+
+		/** Runs func over [0, count) in chunks on up to s_MaxWorkerThreads threads of the TaskScheduler */
+		static void ParallelFor(uint32_t count, const std::function<void(uint32_t begin, uint32_t end)>& func);
+
+		/** 0 uses all workers of the TaskScheduler */
+		inline static uint32_t s_MaxWorkerThreads = 0;
+		/** Turns off the SSE2 paths, they produce the same bytes as the scalar code */
+		inline static bool s_UseSIMD = true;
+		/** Decodes Mip 0 after compression to log the PSNR. Costs a full decode per cook, so only tests and benchmarks turn it on. */
+		inline static bool s_MeasureQuality = false;
+	};
+
+}
@@ -117,25 +117,29 @@ namespace Suora::Physics
 	}
 
 	void JoltCharacterController::Simulate(float deltaTime)
+	{
+		Simulate(deltaTime, *GetTempAllocator());
+	}
+
+	void JoltCharacterController::Simulate(float deltaTime, JPH::TempAllocator& tempAllocator)
 	{
 		JPH::Vec3 oldPosition = m_Controller->GetPosition();
 
 		bool groundToAir = m_Controller->GetGroundState() != JPH::CharacterBase::EGroundState::InAir;
 		JPH::Vec3 gravity = Convert::ToRVec3(Vec3(0, -9.81f, 0));
 
-		auto broadPhaseLayerFilter = GetSystem()->GetDefaultBroadPhaseLayerFilter(JPH::ObjectLayer(m_CharacterNode->LayerID));
-		auto layerFilter = GetSystem()->GetDefaultLayerFilter(JPH::ObjectLayer(m_CharacterNode->LayerID));
-		JPH::TempAllocator* tempAllocator = GetTempAllocator();
+		auto broadPhaseLayerFilter = GetSystem()->GetDefaultBroadPhaseLayerFilter(JPH::ObjectLayer(JoltPhysicsWorld::ToObjectLayer(m_CharacterNode->LayerID, true)));
+		auto layerFilter = GetSystem()->GetDefaultLayerFilter(JPH::ObjectLayer(JoltPhysicsWorld::ToObjectLayer(m_CharacterNode->LayerID, true)));
 
-		m_Controller->Update(deltaTime, gravity, broadPhaseLayerFilter, layerFilter, {}, {}, *tempAllocator);
+		m_Controller->Update(deltaTime, gravity, broadPhaseLayerFilter, layerFilter, {}, {}, tempAllocator);
 
 		if (m_Controller->GetGroundState() != JPH::CharacterBase::EGroundState::InAir)
 			groundToAir = false;
 
-		UpdateStairWalking(deltaTime, oldPosition);
+		UpdateStairWalking(deltaTime, oldPosition, tempAllocator);
 	}
 
-	void JoltCharacterController::UpdateStairWalking(float deltaTime, const JPH::Vec3& oldPosition)
+	void JoltCharacterController::UpdateStairWalking(float deltaTime, const JPH::Vec3& oldPosition, JPH::TempAllocator& tempAllocator)
 	{
 		float stepLength = glm::length(m_MovementInput);
 
@@ -155,11 +159,10 @@ namespace Suora::Physics
 			JPH::Vec3 stepForward = stepForwardNormalized * glm::max(0.02f, stepLength - achievedHorizontalStepLength);
 			JPH::Vec3 stepForwardTest = stepForwardNormalized * 0.15f;
 
-			auto broadPhaseLayerFilter = GetSystem()->GetDefaultBroadPhaseLayerFilter(JPH::ObjectLayer(m_CharacterNode->LayerID));
-			auto layerFilter = GetSystem()->GetDefaultLayerFilter(JPH::ObjectLayer(m_CharacterNode->LayerID));
-			JPH::TempAllocator* tempAllocator = GetTempAllocator();
+			auto broadPhaseLayerFilter = GetSystem()->GetDefaultBroadPhaseLayerFilter(JPH::ObjectLayer(JoltPhysicsWorld::ToObjectLayer(m_CharacterNode->LayerID, true)));
+			auto layerFilter = GetSystem()->GetDefaultLayerFilter(JPH::ObjectLayer(JoltPhysicsWorld::ToObjectLayer(m_CharacterNode->LayerID, true)));
 
-			m_Controller->WalkStairs(deltaTime, JPH::Vec3(0.0f, m_StepOffset, 0.0f), stepForward, stepForwardTest, JPH::Vec3::sZero(), broadPhaseLayerFilter, layerFilter, { }, { }, *tempAllocator);
+			m_Controller->WalkStairs(deltaTime, JPH::Vec3(0.0f, m_StepOffset, 0.0f), stepForward, stepForwardTest, JPH::Vec3::sZero(), broadPhaseLayerFilter, layerFilter, { }, { }, tempAllocator);
 		}
 	}
 
@@ -177,6 +180,8 @@ namespace Suora::Physics
 			capsuleSettings->mRadius = m_CharacterNode->m_CapsuleRadius * radiusScale;
 			capsuleSettings->mHalfHeightOfCylinder = m_CharacterNode->m_CapsuleHalfHeight * m_CharacterNode->GetScale().y;
 			capsuleSettings->mMaterial = nullptr;
+			m_CapsuleRadius = capsuleSettings->mRadius;
+			m_CapsuleHalfHeight = capsuleSettings->mHalfHeightOfCylinder + capsuleSettings->mRadius;
 
 			auto result = capsuleSettings->Create();
 
@@ -199,6 +204,11 @@ namespace Suora::Physics
 		return m_CharacterNode->GetWorld()->GetPhysicsWorld()->As<JoltPhysicsWorld>()->m_PhysicsSystem.get();
 	}
 
+	void JoltCharacterController::AddSeparationVelocity(const Vec3& velocity)
+	{
+		m_Controller->SetLinearVelocity(m_Controller->GetLinearVelocity() + Convert::ToRVec3(velocity));
+	}
+
 	JPH::TempAllocator* JoltCharacterController::GetTempAllocator()
 	{
 		return m_CharacterNode->GetWorld()->GetPhysicsWorld()->As<JoltPhysicsWorld>()->m_TempAllocator.get();
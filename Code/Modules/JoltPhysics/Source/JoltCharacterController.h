@@ -39,8 +39,12 @@ namespace Suora::Physics
 	private:
 		virtual void PreSimulate(float deltaTime) override;
 		virtual void Simulate(float deltaTime) override;
+		/** Thread-safe, as long as every thread passes its own TempAllocator */
+		void Simulate(float deltaTime, JPH::TempAllocator& tempAllocator);
+		/** Pushes overlapping characters apart in the next Simulate, see JoltPhysicsWorld::UpdateCharacters */
+		void AddSeparationVelocity(const Vec3& velocity);
 
-		void UpdateStairWalking(float deltaTime, const JPH::Vec3& oldPosition);
+		void UpdateStairWalking(float deltaTime, const JPH::Vec3& oldPosition, JPH::TempAllocator& tempAllocator);
 
 		void Create();
 
@@ -71,6 +75,11 @@ namespace Suora::Physics
 		bool m_HasGravity = true;
 		bool m_AllowSliding = false;
 		float m_StepOffset = 0.0f;
+		float m_CapsuleRadius = 0.0f;
+		/** Including the hemispheres */
+		float m_CapsuleHalfHeight = 0.0f;
+		/** Index in JoltPhysicsWorld::m_CharacterUpdateOrder */
+		uint32_t m_UpdateIndex = 0;
 
 		ECollisionFlags m_CollisionFlags = ECollisionFlags::None;
 
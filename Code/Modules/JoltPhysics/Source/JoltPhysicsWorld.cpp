@@ -23,69 +23,49 @@
 #include <Jolt/Physics/Body/BodyActivationListener.h>
 #include <Jolt/Physics/Collision/RayCast.h>
 #include <Jolt/Physics/Collision/CastResult.h>
+#include <Jolt/Physics/Collision/ShapeCast.h>
+#include <Jolt/Physics/Collision/CollideShape.h>
+#include <Jolt/Physics/Collision/CollisionCollectorImpl.h>
+#include <Jolt/Physics/Body/BodyLock.h>
 
 // STL includes
 #include <iostream>
 #include <cstdarg>
 #include <thread>
+#include <atomic>
+#include <unordered_set>
+#include <algorithm>
+#include <chrono>
 
 #include "JoltTypeConversion.h"
 
 namespace Suora::Physics
 {
 
-	struct Physics3DLayer
-	{
-		static constexpr uint8_t STATIC = 0;
-		static constexpr uint8_t DEFAULT = 1;
-		static constexpr uint8_t OTHER2 = 2;
-		static constexpr uint8_t OTHER3 = 3;
-		static constexpr uint8_t OTHER4 = 4;
-		static constexpr uint8_t OTHER5 = 5;
-		static constexpr uint8_t OTHER6 = 6;
-		static constexpr uint8_t OTHER7 = 7;
-		static constexpr uint8_t OTHER8 = 8;
-		static constexpr uint8_t OTHER9 = 9;
-		static constexpr uint8_t OTHER10 = 10;
-		static constexpr uint8_t OTHER11 = 11;
-		static constexpr uint8_t OTHER12 = 12;
-		static constexpr uint8_t OTHER13 = 13;
-		static constexpr uint8_t OTHER14 = 14;
-		static constexpr uint8_t OTHER15 = 15;
-
-		static constexpr uint8_t NUM_LAYERS = 16;
-	};
-
+	/* Object layers encode the physics layer of a body and whether it can move: [0, 16) for static bodies, [16, 32) for
+	 * kinematic and dynamic ones. Static bodies live in their own broadphase tree, that is never tested against itself. */
 	namespace BroadPhaseLayers
 	{
-		static constexpr JPH::BroadPhaseLayer STATIC(0);
-		static constexpr JPH::BroadPhaseLayer DEFAULT(1);
-		static constexpr JPH::uint NUM_LAYERS = 3;
+		static constexpr JPH::BroadPhaseLayer NON_MOVING(0);
+		static constexpr JPH::BroadPhaseLayer MOVING(1);
+		static constexpr JPH::uint NUM_LAYERS = 2;
 	};
 
+	static constexpr JPH::uint NUM_OBJECT_LAYERS = CollisionMatrix::s_LayerCount * 2;
+
+	static bool IsMovingObjectLayer(JPH::ObjectLayer layer)
+	{
+		return layer >= CollisionMatrix::s_LayerCount;
+	}
+
+	uint16_t JoltPhysicsWorld::ToObjectLayer(uint32_t collisionLayer, bool isMoving)
+	{
+		return static_cast<uint16_t>(collisionLayer % CollisionMatrix::s_LayerCount + (isMoving ? CollisionMatrix::s_LayerCount : 0));
+	}
+
 	class BPLayerInterfaceImpl final : public JPH::BroadPhaseLayerInterface
 	{
 	public:
-		BPLayerInterfaceImpl()
-		{
-			mObjectToBroadPhase[Physics3DLayer::STATIC] = BroadPhaseLayers::STATIC;
-			mObjectToBroadPhase[Physics3DLayer::DEFAULT] = BroadPhaseLayers::DEFAULT;
-			mObjectToBroadPhase[Physics3DLayer::OTHER2] = BroadPhaseLayers::DEFAULT;
-			mObjectToBroadPhase[Physics3DLayer::OTHER3] = BroadPhaseLayers::DEFAULT;
-			mObjectToBroadPhase[Physics3DLayer::OTHER4] = BroadPhaseLayers::DEFAULT;
-			mObjectToBroadPhase[Physics3DLayer::OTHER5] = BroadPhaseLayers::DEFAULT;
-			mObjectToBroadPhase[Physics3DLayer::OTHER6] = BroadPhaseLayers::DEFAULT;
-			mObjectToBroadPhase[Physics3DLayer::OTHER7] = BroadPhaseLayers::DEFAULT;
-			mObjectToBroadPhase[Physics3DLayer::OTHER8] = BroadPhaseLayers::DEFAULT;
-			mObjectToBroadPhase[Physics3DLayer::OTHER9] = BroadPhaseLayers::DEFAULT;
-			mObjectToBroadPhase[Physics3DLayer::OTHER10] = BroadPhaseLayers::DEFAULT;
-			mObjectToBroadPhase[Physics3DLayer::OTHER11] = BroadPhaseLayers::DEFAULT;
-			mObjectToBroadPhase[Physics3DLayer::OTHER12] = BroadPhaseLayers::DEFAULT;
-			mObjectToBroadPhase[Physics3DLayer::OTHER13] = BroadPhaseLayers::DEFAULT;
-			mObjectToBroadPhase[Physics3DLayer::OTHER14] = BroadPhaseLayers::DEFAULT;
-			mObjectToBroadPhase[Physics3DLayer::OTHER15] = BroadPhaseLayers::DEFAULT;
-		}
-
 		JPH::uint GetNumBroadPhaseLayers() const override
 		{
 			return BroadPhaseLayers::NUM_LAYERS;
@@ -93,57 +73,134 @@ namespace Suora::Physics
 
 		JPH::BroadPhaseLayer GetBroadPhaseLayer(JPH::ObjectLayer inLayer) const override
 		{
-			SuoraAssert(inLayer < Physics3DLayer::NUM_LAYERS)
-			return mObjectToBroadPhase[inLayer];
+			SuoraAssert(inLayer < NUM_OBJECT_LAYERS);
+			return IsMovingObjectLayer(inLayer) ? BroadPhaseLayers::MOVING : BroadPhaseLayers::NON_MOVING;
 		}
 
 #if defined(JPH_EXTERNAL_PROFILE) || defined(JPH_PROFILE_ENABLED)
-		const char* GetBroadPhaseLayerName(BroadPhaseLayer inLayer) const override
+		const char* GetBroadPhaseLayerName(JPH::BroadPhaseLayer inLayer) const override
 		{
-			switch ((BroadPhaseLayer::Type)inLayer)
+			switch ((JPH::BroadPhaseLayer::Type)inLayer)
 			{
-			case (BroadPhaseLayer::Type)BroadPhaseLayers::NON_MOVING:	return "NON_MOVING";
-			case (BroadPhaseLayer::Type)BroadPhaseLayers::MOVING:		return "MOVING";
-			default:													JPH_ASSERT(false); return "INVALID";
+			case (JPH::BroadPhaseLayer::Type)BroadPhaseLayers::NON_MOVING:	return "NON_MOVING";
+			case (JPH::BroadPhaseLayer::Type)BroadPhaseLayers::MOVING:		return "MOVING";
+			default:														JPH_ASSERT(false); return "INVALID";
 			}
 		}
 #endif // JPH_EXTERNAL_PROFILE || JPH_PROFILE_ENABLED
-
-	private:
-		JPH::BroadPhaseLayer mObjectToBroadPhase[Physics3DLayer::NUM_LAYERS];
 	};
 
-	static bool Physics3DBroadPhaseCanCollide(JPH::ObjectLayer inLayer1, JPH::BroadPhaseLayer inLayer2)
-	{
-		/*if (inLayer1 == Physics3DLayer::STATIC)
-			return inLayer2 != BroadPhaseLayers::STATIC;*/
-
-		return true;
-	}
 	class ObjectVsBroadPhaseLayerFilter final : public JPH::ObjectVsBroadPhaseLayerFilter
 	{
 	public:
 		virtual bool ShouldCollide(JPH::ObjectLayer inLayer1, JPH::BroadPhaseLayer inLayer2) const override
 		{
-			return Physics3DBroadPhaseCanCollide(inLayer1, inLayer2);
+			// Static bodies never look for static bodies
+			return IsMovingObjectLayer(inLayer1) || inLayer2 == BroadPhaseLayers::MOVING;
 		}
 	};
 
-	static bool Physics3DObjectCanCollide(JPH::ObjectLayer inObject1, JPH::ObjectLayer inObject2)
-	{
-		return true;
-		/*const NodeLayer layer1 = BIT(inObject1);
-		const NodeLayer layer2 = BIT(inObject2);
-		return	(layer1 & World::LayerCollisionMask.at(layer2).Flags) == layer1 &&
-				(layer2 & World::LayerCollisionMask.at(layer1).Flags) == layer2;*/
-	};
 	class ObjectLayerPairFilter : public JPH::ObjectLayerPairFilter
 	{
 	public:
-		virtual bool ShouldCollide(JPH::ObjectLayer inLayer1, JPH::ObjectLayer inLayer2) const
+		virtual bool ShouldCollide(JPH::ObjectLayer inLayer1, JPH::ObjectLayer inLayer2) const override
 		{
-			return Physics3DObjectCanCollide(inLayer1, inLayer2);
+			const bool collide = (IsMovingObjectLayer(inLayer1) || IsMovingObjectLayer(inLayer2)) && CollisionMatrix::ShouldCollide(inLayer1, inLayer2);
+
+			if (PhysicsWorld::s_CollectStats)
+			{
+				m_PairTests.fetch_add(1, std::memory_order_relaxed);
+				if (!collide) m_PairsRejected.fetch_add(1, std::memory_order_relaxed);
+			}
+			return collide;
 		}
+
+		alignas(64) mutable std::atomic<uint32_t> m_PairTests = 0;
+		alignas(64) mutable std::atomic<uint32_t> m_PairsRejected = 0;
+	};
+
+	enum class ContactEventType : uint8_t
+	{
+		Added = 0,
+		Persisted,
+		Removed
+	};
+
+	struct JoltContactEvent
+	{
+		/** Both BodyIDs, the smaller one in the upper 32 bits */
+		uint64_t PairKey = 0;
+		ContactEventType Type = ContactEventType::Added;
+		/** Seen from the Body with the smaller BodyID */
+		ContactInfo Contact;
+
+		JPH::BodyID GetBodyA() const { return JPH::BodyID(static_cast<JPH::uint32>(PairKey >> 32)); }
+		JPH::BodyID GetBodyB() const { return JPH::BodyID(static_cast<JPH::uint32>(PairKey)); }
+	};
+
+	static uint64_t MakeContactPairKey(const JPH::BodyID& body1, const JPH::BodyID& body2)
+	{
+		const uint64_t id1 = body1.GetIndexAndSequenceNumber();
+		const uint64_t id2 = body2.GetIndexAndSequenceNumber();
+		return id1 < id2 ? (id1 << 32) | id2 : (id2 << 32) | id1;
+	}
+
+	/* Contact events are reported by the Jolt worker threads during PhysicsSystem::Update. Every thread appends to its own
+	 * buffer, which it claims once per Step with a single atomic increment, so recording an event never takes a lock. */
+	struct ContactEventQueue
+	{
+		struct alignas(64) ThreadBuffer
+		{
+			std::vector<JoltContactEvent> Events;
+		};
+
+		ContactEventQueue(uint32_t threadCount)
+			: Buffers(threadCount)
+		{
+		}
+
+		void BeginStep()
+		{
+			Generation = s_NextGeneration.fetch_add(1, std::memory_order_relaxed);
+			UsedBuffers.store(0, std::memory_order_relaxed);
+		}
+
+		std::vector<JoltContactEvent>& GetThreadBuffer()
+		{
+			// Generations are unique across all worlds, a stale thread_local can never alias a buffer of another Step
+			thread_local uint64_t t_Generation = 0;
+			thread_local std::vector<JoltContactEvent>* t_Buffer = nullptr;
+
+			if (t_Generation != Generation)
+			{
+				const uint32_t index = UsedBuffers.fetch_add(1, std::memory_order_relaxed);
+				SuoraVerify(index < Buffers.size(), "More physics threads than contact event buffers!");
+				t_Buffer = &Buffers[index].Events;
+				t_Generation = Generation;
+			}
+			return *t_Buffer;
+		}
+
+		/** Main thread, after PhysicsSystem::Update */
+		void EndStep()
+		{
+			const uint32_t usedBuffers = UsedBuffers.load(std::memory_order_relaxed);
+			for (uint32_t i = 0; i < usedBuffers && i < Buffers.size(); i++)
+			{
+				Events.insert(Events.end(), Buffers[i].Events.begin(), Buffers[i].Events.end());
+				Buffers[i].Events.clear();
+			}
+		}
+
+		std::vector<ThreadBuffer> Buffers;
+		std::atomic<uint32_t> UsedBuffers = 0;
+		uint64_t Generation = 0;
+		inline static std::atomic<uint64_t> s_NextGeneration = 1;
+
+		/** Merged events of all Steps since the last dispatch */
+		std::vector<JoltContactEvent> Events;
+		/** Body pairs that received an Enter but no Exit yet */
+		std::unordered_set<uint64_t> ActivePairs;
 	};
 
 	class ShapeNodeContactListener : public JPH::ContactListener
@@ -155,82 +212,115 @@ namespace Suora::Physics
 		}
 		virtual void OnContactAdded(const JPH::Body& inBody1, const JPH::Body& inBody2, const JPH::ContactManifold& inManifold, JPH::ContactSettings& ioSettings) override
 		{
-			ShapeNode* shapeA = m_World->m_Body_Rigidbody[(JPH::Body*)&inBody1];
-			ShapeNode* shapeB = m_World->m_Body_Rigidbody[(JPH::Body*)&inBody2];
-
-			if (shapeA && shapeB && !(shapeA->IsTrigger() && shapeB->IsTrigger()))
-			{
-				if (shapeA->IsTrigger())
-					shapeA->OnTriggerEnter(shapeB);
-				else
-					shapeA->OnCollisionEnter(shapeB);
-
-				if (shapeB->IsTrigger())
-					shapeB->OnTriggerEnter(shapeA);
-				else
-					shapeB->OnCollisionEnter(shapeA);
-			}
+			RecordContact(ContactEventType::Added, inBody1, inBody2, inManifold);
 		}
 
 		virtual void OnContactPersisted(const JPH::Body& inBody1, const JPH::Body& inBody2, const JPH::ContactManifold& inManifold, JPH::ContactSettings& ioSettings) override
 		{
-			ShapeNode* shapeA = m_World->m_Body_Rigidbody[(JPH::Body*)&inBody1];
-			ShapeNode* shapeB = m_World->m_Body_Rigidbody[(JPH::Body*)&inBody2];
-
-			if (shapeA && shapeB && !(shapeA->IsTrigger() && shapeB->IsTrigger()))
-			{
-				if (shapeA->IsTrigger())
-					shapeA->OnTriggerStay(shapeB);
-				else
-					shapeA->OnCollisionStay(shapeB);
-
-				if (shapeB->IsTrigger())
-					shapeB->OnTriggerStay(shapeA);
-				else
-					shapeB->OnCollisionStay(shapeA);
-			}
+			RecordContact(ContactEventType::Persisted, inBody1, inBody2, inManifold);
 		}
 
 		virtual void OnContactRemoved(const JPH::SubShapeIDPair& inSubShapePair) override
 		{
-			ShapeNode* shapeA = nullptr;
-			ShapeNode* shapeB = nullptr;
-			const JPH::BodyLockInterfaceNoLock& lock_interface = m_World->m_PhysicsSystem->GetBodyLockInterfaceNoLock();
+			// The Bodies might not be accessible anymore, they are resolved on the main thread
+			JoltContactEvent& event = m_World->m_ContactEventQueue->GetThreadBuffer().emplace_back();
+			event.PairKey = MakeContactPairKey(inSubShapePair.GetBody1ID(), inSubShapePair.GetBody2ID());
+			event.Type = ContactEventType::Removed;
+		}
 
+	private:
+		void RecordContact(ContactEventType type, const JPH::Body& body1, const JPH::Body& body2, const JPH::ContactManifold& manifold)
+		{
+			// Only Bodies of ShapeNodes carry UserData, two triggers never report to each other
+			if (!body1.GetUserData() || !body2.GetUserData() || (body1.IsSensor() && body2.IsSensor()))
 			{
-				JPH::BodyLockRead lock(lock_interface, inSubShapePair.GetBody1ID());
-				if (lock.Succeeded())
-				{
-					const JPH::Body& body = lock.GetBody();
-					shapeA = m_World->m_Body_Rigidbody[(JPH::Body*)&body];
-				}
+				return;
 			}
+
+			JoltContactEvent& event = m_World->m_ContactEventQueue->GetThreadBuffer().emplace_back();
+			event.PairKey = MakeContactPairKey(body1.GetID(), body2.GetID());
+			event.Type = type;
+
+			// The manifold normal points from body1 towards body2
+			const bool body1IsA = body1.GetID() < body2.GetID();
+			const JPH::Vec3 normal = manifold.mWorldSpaceNormal;
+			event.Contact.Normal = Convert::ToVec3(body1IsA ? -normal : normal);
+			event.Contact.PenetrationDepth = manifold.mPenetrationDepth;
+
+			if (!manifold.mRelativeContactPointsOn1.empty())
 			{
-				JPH::BodyLockRead lock(lock_interface, inSubShapePair.GetBody2ID());
-				if (lock.Succeeded())
-				{
-					const JPH::Body& body = lock.GetBody();
-					shapeB = m_World->m_Body_Rigidbody[(JPH::Body*)&body];
-				}
+				const JPH::RVec3 point = manifold.GetWorldSpaceContactPointOn1(0);
+				event.Contact.Point = Convert::ToVec3(point);
+
+				// Jolt does not expose solver impulses to the listener, estimate the impulse that stops the approach instead
+				const float approachSpeed = glm::max(0.0f, -(body2.GetPointVelocity(point) - body1.GetPointVelocity(point)).Dot(normal));
+				const float inverseMass = (body1.IsDynamic() ? body1.GetMotionProperties()->GetInverseMass() : 0.0f)
+										+ (body2.IsDynamic() ? body2.GetMotionProperties()->GetInverseMass() : 0.0f);
+				event.Contact.Impulse = inverseMass > 0.0f ? approachSpeed / inverseMass : 0.0f;
 			}
+		}
+
+		JoltPhysicsWorld* m_World;
+	};
 
-			if (shapeA && shapeB && !(shapeA->IsTrigger() && shapeB->IsTrigger()))
+	class QueryObjectLayerFilter final : public JPH::ObjectLayerFilter
+	{
+	public:
+		QueryObjectLayerFilter(const RaycastParams& params)
+			: m_LayerMask(params.LayerMask)
+		{
+			if (params.CollisionLayer >= 0)
 			{
-				if (shapeA->IsTrigger())
-					shapeA->OnTriggerExit(shapeB);
-				else
-					shapeA->OnCollisionExit(shapeB);
-
-				if (shapeB->IsTrigger())
-					shapeB->OnTriggerExit(shapeA);
-				else
-					shapeB->OnCollisionExit(shapeA);
+				m_LayerMask &= CollisionMatrix::GetMask(params.CollisionLayer);
 			}
 		}
+		virtual bool ShouldCollide(JPH::ObjectLayer inLayer) const override
+		{
+			return (m_LayerMask & (1u << (inLayer % CollisionMatrix::s_LayerCount))) != 0;
+		}
 
-		JoltPhysicsWorld* m_World;
+	private:
+		uint32_t m_LayerMask;
 	};
 
+	class QueryBodyFilter final : public JPH::BodyFilter
+	{
+	public:
+		QueryBodyFilter(const RaycastParams& params)
+			: m_Params(params)
+		{
+		}
+		virtual bool ShouldCollideLocked(const JPH::Body& inBody) const override
+		{
+			if (m_Params.IgnoreTriggers && inBody.IsSensor())
+			{
+				return false;
+			}
+			return m_Params.IgnoredCollisionNodes.IsEmpty() || !m_Params.IgnoredCollisionNodes.Contains(reinterpret_cast<ShapeNode*>(inBody.GetUserData()));
+		}
+
+	private:
+		const RaycastParams& m_Params;
+	};
+
+	static JPH::Ref<JPH::Shape> CreateQueryShape(const QueryShape& shape)
+	{
+		switch (shape.Type)
+		{
+		case QueryShape::Kind::Box:
+		{
+			const Vec3 halfExtends = glm::max(glm::abs(shape.HalfExtends), Vec3(0.001f));
+			const float convexRadius = glm::min(JPH::cDefaultConvexRadius, glm::min(glm::min(halfExtends.x, halfExtends.y), halfExtends.z));
+			return new JPH::BoxShape(Convert::ToRVec3(halfExtends), convexRadius);
+		}
+		case QueryShape::Kind::Capsule:
+			return new JPH::CapsuleShape(glm::max(0.001f, shape.Height / 2.0f), glm::max(0.001f, shape.Radius));
+		case QueryShape::Kind::Sphere:
+		default:
+			return new JPH::SphereShape(glm::max(0.001f, shape.Radius));
+		}
+	}
+
 	JoltPhysicsWorld::JoltPhysicsWorld()
 	{
 	}
@@ -272,7 +362,7 @@ namespace Suora::Physics
 		}
 
 		// Create the settings for the body itself. Note that here you can also set other properties like the restitution / friction.
-		JPH::BodyCreationSettings settings = JPH::BodyCreationSettings(shape, Convert::ToRVec3(node->GetPosition()), Convert::ToJoltQuat(node->GetRotation()), static_cast<JPH::EMotionType>(node->GetBodyType()), 0);
+		JPH::BodyCreationSettings settings = JPH::BodyCreationSettings(shape, Convert::ToRVec3(node->GetPosition()), Convert::ToJoltQuat(node->GetRotation()), static_cast<JPH::EMotionType>(node->GetBodyType()), ToObjectLayer(node->GetCollisionLayer(), static_cast<JPH::EMotionType>(node->GetBodyType()) != JPH::EMotionType::Static));
 
 		JPH::MassProperties massProperties;
 		massProperties.mMass = glm::max(0.01f, node->m_Mass);
@@ -284,6 +374,8 @@ namespace Suora::Physics
 		settings.mAngularDamping = glm::max(0.0f, node->m_AngularDrag);
 		settings.mMotionQuality = node->m_IsContinuous ? JPH::EMotionQuality::LinearCast : JPH::EMotionQuality::Discrete;
 		settings.mGravityFactor = node->m_GravityScale;
+		// Lets the contact listener identify ShapeNodes without touching m_Body_Rigidbody from worker threads
+		settings.mUserData = reinterpret_cast<JPH::uint64>(node);
 
 		// Create the actual rigid body
 		JPH::Body* rigidbody = bodyInterface.CreateBody(settings); // Note that if we run out of bodies this can return nullptr
@@ -295,6 +387,11 @@ namespace Suora::Physics
 		m_Body_Rigidbody[rigidbody] = node;
 		m_Rigidbody_Body[node] = rigidbody;
 
+		BodyTransformState& state = GetBodyTransformState(rigidbody->GetID().GetIndex());
+		state = BodyTransformState();
+		state.Node = node;
+		state.BodyID = rigidbody->GetID().GetIndexAndSequenceNumber();
+
 		TickShapeNode(node);
 	}
 
@@ -307,9 +404,13 @@ namespace Suora::Physics
 		JPH::Body* body = m_Rigidbody_Body[node];
 
 		JPH::BodyInterface& bodyInterface = m_PhysicsSystem->GetBodyInterface();
+		const JPH::uint32 bodyID = body->GetID().GetIndexAndSequenceNumber();
+		GetBodyTransformState(body->GetID().GetIndex()) = BodyTransformState();
 		bodyInterface.RemoveBody(body->GetID());
 		bodyInterface.DestroyBody(body->GetID());
 
+		std::erase_if(m_ContactEventQueue->ActivePairs, [bodyID](uint64_t pairKey) { return (pairKey >> 32) == bodyID || static_cast<JPH::uint32>(pairKey) == bodyID; });
+
 		m_Rigidbody_Body.erase(node);
 		m_Body_Rigidbody.erase(body);
 	}
@@ -317,13 +418,26 @@ namespace Suora::Physics
 	void JoltPhysicsWorld::TickShapeNode(ShapeNode* node)
 	{
 		JPH::BodyInterface& body_interface = m_PhysicsSystem->GetBodyInterface();
-		body_interface.SetPosition(m_Rigidbody_Body[node]->GetID(), Convert::ToRVec3(node->GetPosition()), JPH::EActivation::DontActivate);
-		m_Rigidbody_Body[node]->SetIsSensor(node->IsTrigger());
+		JPH::Body* body = m_Rigidbody_Body[node];
+		body_interface.SetPosition(body->GetID(), Convert::ToRVec3(node->GetPosition()), JPH::EActivation::DontActivate);
+		// Moved by gameplay code, do not interpolate from the old pose
+		GetBodyTransformState(body->GetID().GetIndex()).IsValid = false;
+		body->SetIsSensor(node->IsTrigger());
+
+		const JPH::ObjectLayer layer = ToObjectLayer(node->GetCollisionLayer(), IsMovingObjectLayer(body->GetObjectLayer()));
+		if (body->GetObjectLayer() != layer)
+		{
+			body_interface.SetObjectLayer(body->GetID(), layer);
+		}
 	}
 
 	Ref<CharacterController> JoltPhysicsWorld::CreateCharacterNode(CharacterNode* node)
 	{
+		DestroyCharacterNode(node);
+
 		Ref<JoltCharacterController> characterController = CreateRef<JoltCharacterController>(node);
+		characterController->m_UpdateIndex = static_cast<uint32_t>(m_CharacterUpdateOrder.size());
+		m_CharacterUpdateOrder.push_back(characterController.get());
 		m_CharacterControllers[node] = characterController;
 		return characterController;
 	}
@@ -331,7 +445,14 @@ namespace Suora::Physics
 	void JoltPhysicsWorld::DestroyCharacterNode(CharacterNode* node)
 	{
 		if (auto it = m_CharacterControllers.find(node); it != m_CharacterControllers.end())
+		{
+			JoltCharacterController* character = static_cast<JoltCharacterController*>(it->second.get());
+			m_CharacterUpdateOrder[character->m_UpdateIndex] = m_CharacterUpdateOrder.back();
+			m_CharacterUpdateOrder[character->m_UpdateIndex]->m_UpdateIndex = character->m_UpdateIndex;
+			m_CharacterUpdateOrder.pop_back();
+
 			m_CharacterControllers.erase(it);
+		}
 	}
 
 	void JoltPhysicsWorld::TickCharacterNode(CharacterNode* node)
@@ -341,78 +462,464 @@ namespace Suora::Physics
 		characterController->SetInternalRotation(node->GetRotation());
 	}
 
+	void JoltPhysicsWorld::FillHitResult(const JPH::RRayCast& ray, const JPH::RayCastResult& hit, HitResult& result) const
+	{
+		const JPH::RVec3 point = ray.GetPointOnRay(hit.mFraction);
+		result.Point = Convert::ToVec3(point);
+		result.Distance = ray.mDirection.Length() * hit.mFraction;
+		result.SubShapeID = hit.mSubShapeID2.GetValue();
+		result.Hit = true;
+
+		JPH::BodyLockRead lock(m_PhysicsSystem->GetBodyLockInterface(), hit.mBodyID);
+		if (lock.Succeeded())
+		{
+			const JPH::Body& body = lock.GetBody();
+			result.Normal = Convert::ToVec3(body.GetWorldSpaceSurfaceNormal(hit.mSubShapeID2, point));
+			result.Shape = reinterpret_cast<ShapeNode*>(body.GetUserData());
+		}
+	}
+
 	bool JoltPhysicsWorld::Raycast(const Vec3& start, const Vec3& end, HitResult& result, const RaycastParams& params)
 	{
+		result = HitResult();
+
 		JPH::RRayCast ray;
+		ray.mOrigin = Convert::ToRVec3(start);
+		ray.mDirection = Convert::ToRVec3(end - start);
+
 		JPH::RayCastResult castResult;
+		if (!m_PhysicsSystem->GetNarrowPhaseQuery().CastRay(ray, castResult, JPH::BroadPhaseLayerFilter(), QueryObjectLayerFilter(params), QueryBodyFilter(params)))
+		{
+			return false;
+		}
+
+		FillHitResult(ray, castResult, result);
+		return true;
+	}
+
+	bool JoltPhysicsWorld::RaycastAll(const Vec3& start, const Vec3& end, Array<HitResult>& results, const RaycastParams& params)
+	{
+		results.Clear();
 
+		JPH::RRayCast ray;
 		ray.mOrigin = Convert::ToRVec3(start);
-		ray.mDirection = Convert::ToRVec3(end - start) * glm::distance(start, end);
+		ray.mDirection = Convert::ToRVec3(end - start);
 
-		if (m_PhysicsSystem->GetNarrowPhaseQuery().CastRay(ray, castResult, JPH::BroadPhaseLayerFilter(), JPH::ObjectLayerFilter(), JPH::BodyFilter()))
-		{
-			JPH::Vec3 hitPosition = ray.GetPointOnRay(castResult.mFraction);
+		JPH::AllHitCollisionCollector<JPH::CastRayCollector> collector;
+		m_PhysicsSystem->GetNarrowPhaseQuery().CastRay(ray, JPH::RayCastSettings(), collector, JPH::BroadPhaseLayerFilter(), QueryObjectLayerFilter(params), QueryBodyFilter(params));
+		collector.Sort();
 
-			result.Point = Convert::ToVec3(hitPosition);
-			// TODO: Rest of HitResult
-			return true;
+		results.GetData().resize(collector.mHits.size());
+		for (size_t i = 0; i < collector.mHits.size(); i++)
+		{
+			FillHitResult(ray, collector.mHits[i], results[static_cast<int32_t>(i)]);
 		}
-		else
+		return !results.IsEmpty();
+	}
+
+	bool JoltPhysicsWorld::ShapeCast(const ShapeCastQuery& query, HitResult& result, const RaycastParams& params)
+	{
+		result = HitResult();
+
+		JPH::Ref<JPH::Shape> shape = CreateQueryShape(query.Shape);
+		const JPH::RMat44 transform = JPH::RMat44::sRotationTranslation(Convert::ToJoltQuat(query.Rotation), Convert::ToRVec3(query.Start));
+		const JPH::RShapeCast shapeCast = JPH::RShapeCast::sFromWorldTransform(shape, JPH::Vec3::sReplicate(1.0f), transform, Convert::ToRVec3(query.End - query.Start));
+
+		JPH::ClosestHitCollisionCollector<JPH::CastShapeCollector> collector;
+		m_PhysicsSystem->GetNarrowPhaseQuery().CastShape(shapeCast, JPH::ShapeCastSettings(), JPH::RVec3::sZero(), collector, JPH::BroadPhaseLayerFilter(), QueryObjectLayerFilter(params), QueryBodyFilter(params));
+		if (!collector.HadHit())
 		{
 			return false;
 		}
 
-		return false;
+		const JPH::ShapeCastResult& hit = collector.mHit;
+		result.Point = Convert::ToVec3(hit.mContactPointOn2);
+		result.Normal = Convert::ToVec3(-hit.mPenetrationAxis.NormalizedOr(JPH::Vec3::sZero()));
+		result.Distance = glm::distance(query.Start, query.End) * hit.mFraction;
+		result.SubShapeID = hit.mSubShapeID2.GetValue();
+		result.Shape = reinterpret_cast<ShapeNode*>(m_PhysicsSystem->GetBodyInterface().GetUserData(hit.mBodyID2));
+		result.Hit = true;
+		return true;
 	}
 
-	void JoltPhysicsWorld::Step(double timeStep)
+	bool JoltPhysicsWorld::Overlap(const OverlapQuery& query, Array<ShapeNode*>& results, const RaycastParams& params)
+	{
+		results.Clear();
+
+		JPH::Ref<JPH::Shape> shape = CreateQueryShape(query.Shape);
+		const JPH::RMat44 transform = JPH::RMat44::sRotationTranslation(Convert::ToJoltQuat(query.Rotation), Convert::ToRVec3(query.Position));
+
+		JPH::AllHitCollisionCollector<JPH::CollideShapeCollector> collector;
+		m_PhysicsSystem->GetNarrowPhaseQuery().CollideShape(shape, JPH::Vec3::sReplicate(1.0f), transform, JPH::CollideShapeSettings(), JPH::RVec3::sZero(), collector, JPH::BroadPhaseLayerFilter(), QueryObjectLayerFilter(params), QueryBodyFilter(params));
+
+		// One entry per Body, ordered by BodyID to be independent of the broadphase traversal
+		std::vector<JPH::BodyID> bodies;
+		bodies.reserve(collector.mHits.size());
+		for (const JPH::CollideShapeResult& hit : collector.mHits)
+		{
+			bodies.push_back(hit.mBodyID2);
+		}
+		std::sort(bodies.begin(), bodies.end());
+		bodies.erase(std::unique(bodies.begin(), bodies.end()), bodies.end());
+
+		JPH::BodyInterface& bodyInterface = m_PhysicsSystem->GetBodyInterface();
+		for (const JPH::BodyID& body : bodies)
+		{
+			if (ShapeNode* node = reinterpret_cast<ShapeNode*>(bodyInterface.GetUserData(body)))
+			{
+				results.Add(node);
+			}
+		}
+		return !results.IsEmpty();
+	}
+
+	void JoltPhysicsWorld::ParallelFor(uint32_t count, const std::function<void(uint32_t index, uint32_t worker)>& func)
 	{
-		for (auto& It : m_CharacterControllers)
+		// Small chunks balance expensive items, big enough to keep the atomic out of the way
+		constexpr uint32_t itemsPerChunk = 32;
+		const uint32_t chunkCount = (count + itemsPerChunk - 1) / itemsPerChunk;
+		const uint32_t jobCount = glm::min(chunkCount, static_cast<uint32_t>(m_JobSystem->GetMaxConcurrency()));
+
+		std::atomic<uint32_t> nextItem = 0;
+		auto worker = [&](uint32_t workerIndex)
 		{
-			It.second->Simulate(timeStep);
+			for (uint32_t begin = nextItem.fetch_add(itemsPerChunk); begin < count; begin = nextItem.fetch_add(itemsPerChunk))
+			{
+				const uint32_t end = glm::min(begin + itemsPerChunk, count);
+				for (uint32_t i = begin; i < end; i++)
+				{
+					func(i, workerIndex);
+				}
+			}
+		};
+
+		if (jobCount <= 1)
+		{
+			worker(0);
+			return;
 		}
-		for (auto& It : m_CharacterControllers)
+
+		// The calling thread executes jobs while it waits for the barrier
+		JPH::JobSystem::Barrier* barrier = m_JobSystem->CreateBarrier();
+		for (uint32_t i = 0; i < jobCount; i++)
 		{
-			It.second->PreSimulate(timeStep);
+			barrier->AddJob(m_JobSystem->CreateJob("SuoraParallelFor", JPH::Color::sCyan, [&worker, i]() { worker(i); }));
 		}
+		m_JobSystem->WaitForJobs(barrier);
+		m_JobSystem->DestroyBarrier(barrier);
+	}
+
+	void JoltPhysicsWorld::RaycastBatch(const Array<RaycastQuery>& queries, Array<HitResult>& results, const RaycastParams& params)
+	{
+		results.GetData().assign(queries.Size(), HitResult());
+		ParallelFor(queries.Size(), [&](uint32_t i, uint32_t)
+		{
+			Raycast(queries[i].Start, queries[i].End, results[i], params);
+		});
+	}
 
+	void JoltPhysicsWorld::ShapeCastBatch(const Array<ShapeCastQuery>& queries, Array<HitResult>& results, const RaycastParams& params)
+	{
+		results.GetData().assign(queries.Size(), HitResult());
+		ParallelFor(queries.Size(), [&](uint32_t i, uint32_t)
+		{
+			ShapeCast(queries[i], results[i], params);
+		});
+	}
+
+	void JoltPhysicsWorld::OverlapBatch(const Array<OverlapQuery>& queries, Array<Array<ShapeNode*>>& results, const RaycastParams& params)
+	{
+		results.GetData().assign(queries.Size(), Array<ShapeNode*>());
+		ParallelFor(queries.Size(), [&](uint32_t i, uint32_t)
+		{
+			Overlap(queries[i], results[i], params);
+		});
+	}
+
+	void JoltPhysicsWorld::Step(double timeStep)
+	{
+		// Every character is simulated exactly once per Step, before the bodies react to it
+		UpdateCharacters(static_cast<float>(timeStep));
+
+		m_ContactEventQueue->BeginStep();
+		m_ObjectLayerPairFilter->m_PairTests = 0;
+		m_ObjectLayerPairFilter->m_PairsRejected = 0;
+
+		const auto simulationStart = std::chrono::high_resolution_clock::now();
 		m_PhysicsSystem->Update(timeStep, 1, m_TempAllocator.get(), m_JobSystem.get());
+		m_Stats.SimulationTimeMs = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - simulationStart).count();
+
+		m_ContactEventQueue->EndStep();
+		m_Stats.BodyCount = m_PhysicsSystem->GetNumBodies();
+		m_Stats.ActiveBodyCount = m_PhysicsSystem->GetNumActiveBodies(JPH::EBodyType::RigidBody);
+		m_Stats.BroadphasePairTests = m_ObjectLayerPairFilter->m_PairTests;
+		m_Stats.BroadphasePairsRejected = m_ObjectLayerPairFilter->m_PairsRejected;
 
-		for (auto It : m_Body_Rigidbody)
+		UpdateBodyTransformStates();
+
+		for (JoltCharacterController* character : m_CharacterUpdateOrder)
 		{
-			if (!It.second->IsStatic() && It.second->ShouldUpdateInCurrentContext())
+			CharacterNode* node = character->m_CharacterNode;
+			const Vec3 newPosition = Convert::ToVec3(character->m_Controller->GetPosition());
+			const Quat newRotation = Convert::ToSuoraQuat(character->m_Controller->GetRotation());
+			const Vec3 nodePosition = node->GetPosition();
+
+			if (glm::distance(newPosition, nodePosition) <= 0.01f)
 			{
-				JPH::BodyInterface& body_interface = m_PhysicsSystem->GetBodyInterface();
-				It.second->SetPosition(Convert::ToVec3(body_interface.GetPosition(It.first->GetID())));
-				It.second->SetRotation(Convert::ToSuoraQuat(body_interface.GetRotation(It.first->GetID())));
+				character->m_Controller->SetPosition(Convert::ToRVec3(nodePosition));
+				node->SetRotation(newRotation);
 			}
+			else
+			{
+				node->SetPositionAndRotation(newPosition, newRotation);
+			}
+		}
+	}
+
+	void JoltPhysicsWorld::UpdateCharacters(float deltaTime)
+	{
+		const uint32_t characterCount = static_cast<uint32_t>(m_CharacterUpdateOrder.size());
+		if (characterCount == 0)
+		{
+			return;
+		}
+
+		// Characters only see each other through this snapshot, so the result does not depend on the order of the jobs
+		float maxRadius = 0.0f;
+		m_CharacterSnapshots.resize(characterCount);
+		for (uint32_t i = 0; i < characterCount; i++)
+		{
+			const JoltCharacterController* character = m_CharacterUpdateOrder[i];
+			m_CharacterSnapshots[i].Position = Convert::ToVec3(character->m_Controller->GetPosition());
+			m_CharacterSnapshots[i].Radius = character->m_CapsuleRadius;
+			m_CharacterSnapshots[i].HalfHeight = character->m_CapsuleHalfHeight;
+			maxRadius = glm::max(maxRadius, character->m_CapsuleRadius);
 		}
-		for (auto& It : m_CharacterControllers)
+
+		// Uniform grid on the XZ plane, two neighbouring characters are at most one cell apart
+		const float cellSize = glm::max(2.0f * maxRadius, 0.01f);
+		m_CharacterCells.resize(characterCount);
+		for (uint32_t i = 0; i < characterCount; i++)
 		{
-			It.second->Simulate(timeStep);
+			m_CharacterCells[i] = { GetCharacterCell(m_CharacterSnapshots[i].Position, cellSize, 0, 0), i };
 		}
-		for (auto& It : m_CharacterControllers)
+		std::sort(m_CharacterCells.begin(), m_CharacterCells.end());
+
+		ParallelFor(characterCount, [&](uint32_t i, uint32_t worker)
 		{
-			JoltCharacterController* joltCharacterController = (JoltCharacterController*)It.second.get();
+			JoltCharacterController* character = m_CharacterUpdateOrder[i];
+			character->PreSimulate(deltaTime);
 
-			const Vec3 newPos = Convert::ToVec3(joltCharacterController->m_Controller->GetPosition());
-			if (glm::distance(newPos, It.first->GetPosition()) <= 0.01f)
+			const Vec3 separation = ComputeCharacterSeparation(i, cellSize);
+			if (separation != Vec3(0.0f))
 			{
-				joltCharacterController->m_Controller->SetPosition(Convert::ToRVec3(It.first->GetPosition()));
+				character->AddSeparationVelocity(separation / deltaTime);
+			}
+
+			character->Simulate(deltaTime, *m_JobTempAllocators[worker]);
+		});
+	}
+
+	uint64_t JoltPhysicsWorld::GetCharacterCell(const Vec3& position, float cellSize, int32_t offsetX, int32_t offsetZ)
+	{
+		const int32_t x = static_cast<int32_t>(glm::floor(position.x / cellSize)) + offsetX;
+		const int32_t z = static_cast<int32_t>(glm::floor(position.z / cellSize)) + offsetZ;
+		return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(z);
+	}
+
+	Vec3 JoltPhysicsWorld::ComputeCharacterSeparation(uint32_t index, float cellSize) const
+	{
+		const CharacterSnapshot& self = m_CharacterSnapshots[index];
+		Vec3 separation = Vec3(0.0f);
+
+		for (int32_t offsetX = -1; offsetX <= 1; offsetX++)
+		{
+			for (int32_t offsetZ = -1; offsetZ <= 1; offsetZ++)
+			{
+				const uint64_t cell = GetCharacterCell(self.Position, cellSize, offsetX, offsetZ);
+				auto it = std::lower_bound(m_CharacterCells.begin(), m_CharacterCells.end(), std::pair<uint64_t, uint32_t>(cell, 0));
+				for (; it != m_CharacterCells.end() && it->first == cell; it++)
+				{
+					const uint32_t otherIndex = it->second;
+					const CharacterSnapshot& other = m_CharacterSnapshots[otherIndex];
+					if (otherIndex == index || glm::abs(self.Position.y - other.Position.y) >= self.HalfHeight + other.HalfHeight)
+					{
+						continue;
+					}
+
+					const Vec2 delta = Vec2(self.Position.x - other.Position.x, self.Position.z - other.Position.z);
+					const float minDistance = self.Radius + other.Radius;
+					const float distanceSq = glm::dot(delta, delta);
+					if (distanceSq >= minDistance * minDistance)
+					{
+						continue;
+					}
+
+					// Both characters resolve half of the penetration, exactly overlapping ones are split by their index
+					const float distance = glm::sqrt(distanceSq);
+					const Vec2 direction = distance > 0.0001f ? delta / distance : Vec2(index < otherIndex ? 1.0f : -1.0f, 0.0f);
+					separation += Vec3(direction.x, 0.0f, direction.y) * ((minDistance - distance) * 0.5f);
+				}
+			}
+		}
+
+		return separation;
+	}
+
+	JoltPhysicsWorld::BodyTransformState& JoltPhysicsWorld::GetBodyTransformState(uint32_t bodyIndex)
+	{
+		if (bodyIndex >= m_BodyTransformStates.size())
+		{
+			m_BodyTransformStates.resize(bodyIndex + 1);
+		}
+		return m_BodyTransformStates[bodyIndex];
+	}
+
+	void JoltPhysicsWorld::RecordBodyTransform(uint32_t bodyIndex, const JPH::Body& body)
+	{
+		BodyTransformState& state = m_BodyTransformStates[bodyIndex];
+		const Vec3 position = Convert::ToVec3(body.GetPosition());
+		const Quat rotation = Convert::ToSuoraQuat(body.GetRotation());
+
+		state.PreviousPosition = state.IsValid ? state.Position : position;
+		state.PreviousRotation = state.IsValid ? state.Rotation : rotation;
+		state.Position = position;
+		state.Rotation = rotation;
+		state.IsValid = true;
+		state.LastStep = m_StepCount;
+		m_MovingBodies.push_back(bodyIndex);
+	}
+
+	void JoltPhysicsWorld::UpdateBodyTransformStates()
+	{
+		m_StepCount++;
+		std::swap(m_MovingBodies, m_PreviousMovingBodies);
+		m_MovingBodies.clear();
+
+		// Only Jolt's active bodies can have moved, sleeping and static bodies are never touched
+		const JPH::BodyLockInterfaceNoLock& bodies = m_PhysicsSystem->GetBodyLockInterfaceNoLock();
+		const JPH::BodyID* activeBodies = m_PhysicsSystem->GetActiveBodiesUnsafe(JPH::EBodyType::RigidBody);
+		const JPH::uint32 activeBodyCount = m_PhysicsSystem->GetNumActiveBodies(JPH::EBodyType::RigidBody);
+		for (JPH::uint32 i = 0; i < activeBodyCount; i++)
+		{
+			const JPH::Body* body = bodies.TryGetBody(activeBodies[i]);
+			if (body && body->GetUserData())
+			{
+				const JPH::uint32 bodyIndex = activeBodies[i].GetIndex();
+				GetBodyTransformState(bodyIndex).Node = reinterpret_cast<ShapeNode*>(body->GetUserData());
+				RecordBodyTransform(bodyIndex, *body);
+			}
+		}
+
+		// Bodies that fell asleep in this Step are kept, until their final pose has been written without interpolation
+		for (JPH::uint32 bodyIndex : m_PreviousMovingBodies)
+		{
+			const BodyTransformState& state = m_BodyTransformStates[bodyIndex];
+			if (state.LastStep == m_StepCount || !state.Node)
+			{
+				continue;
+			}
+			if (state.IsValid && state.PreviousPosition == state.Position && state.PreviousRotation == state.Rotation)
+			{
+				continue;
+			}
+			if (const JPH::Body* body = bodies.TryGetBody(JPH::BodyID(state.BodyID)))
+			{
+				RecordBodyTransform(bodyIndex, *body);
+			}
+		}
+	}
+
+	void JoltPhysicsWorld::WriteBackTransforms(float alpha)
+	{
+		for (JPH::uint32 bodyIndex : m_MovingBodies)
+		{
+			const BodyTransformState& state = m_BodyTransformStates[bodyIndex];
+			if (!state.Node || !state.IsValid || state.Node->IsStatic() || !state.Node->ShouldUpdateInCurrentContext())
+			{
+				continue;
+			}
+			state.Node->SetPositionAndRotation(glm::mix(state.PreviousPosition, state.Position, alpha), glm::slerp(state.PreviousRotation, state.Rotation, alpha));
+		}
+	}
+
+	void JoltPhysicsWorld::DispatchContactEvents()
+	{
+		std::vector<JoltContactEvent>& events = m_ContactEventQueue->Events;
+		if (events.empty())
+		{
+			return;
+		}
+
+		// BodyIDs are handed out deterministically, so this order does not depend on thread scheduling
+		std::sort(events.begin(), events.end(), [](const JoltContactEvent& a, const JoltContactEvent& b)
+		{
+			if (a.PairKey != b.PairKey) return a.PairKey < b.PairKey;
+			if (a.Type != b.Type) return a.Type < b.Type;
+			if (a.Contact.Impulse != b.Contact.Impulse) return a.Contact.Impulse > b.Contact.Impulse;
+			if (a.Contact.Point.x != b.Contact.Point.x) return a.Contact.Point.x < b.Contact.Point.x;
+			if (a.Contact.Point.y != b.Contact.Point.y) return a.Contact.Point.y < b.Contact.Point.y;
+			return a.Contact.Point.z < b.Contact.Point.z;
+		});
+
+		JPH::BodyInterface& bodyInterface = m_PhysicsSystem->GetBodyInterface();
+		std::unordered_set<uint64_t>& activePairs = m_ContactEventQueue->ActivePairs;
+
+		for (size_t begin = 0; begin < events.size(); )
+		{
+			// Jolt reports every SubShape pair on its own, collapse them into one event per Body pair
+			const uint64_t pairKey = events[begin].PairKey;
+			const JoltContactEvent* touching = nullptr;
+			bool removed = false;
+			size_t end = begin;
+			for (; end < events.size() && events[end].PairKey == pairKey; end++)
+			{
+				if (events[end].Type == ContactEventType::Removed)
+					removed = true;
+				else if (!touching)
+					touching = &events[end];
+			}
+
+			ContactPhase phase;
+			bool dispatch = true;
+			if (touching)
+			{
+				phase = activePairs.insert(pairKey).second ? ContactPhase::Enter : ContactPhase::Stay;
 			}
 			else
 			{
-				It.first->SetPosition(newPos);
+				// Other SubShapes of the pair still touching would have reported as persisted
+				phase = ContactPhase::Exit;
+				dispatch = removed && activePairs.erase(pairKey) > 0;
+			}
+
+			if (dispatch)
+			{
+				ShapeNode* shapeA = reinterpret_cast<ShapeNode*>(bodyInterface.GetUserData(events[begin].GetBodyA()));
+				ShapeNode* shapeB = reinterpret_cast<ShapeNode*>(bodyInterface.GetUserData(events[begin].GetBodyB()));
+				DispatchContact(shapeA, shapeB, phase, touching ? touching->Contact : ContactInfo());
 			}
-			It.first->SetRotation(Convert::ToSuoraQuat(joltCharacterController->m_Controller->GetRotation()));
 
+			begin = end;
 		}
+
+		events.clear();
+		m_Stats.ContactPairs = static_cast<uint32_t>(activePairs.size());
 	}
 
 	void JoltPhysicsWorld::Inititalize()
 	{
+		const int workerThreads = glm::max(0, static_cast<int>(JPH::thread::hardware_concurrency()) - 1);
+
 		m_TempAllocator = Ref<JPH::TempAllocatorImpl>(new JPH::TempAllocatorImpl(20 * 1024 * 1024));
-		m_JobSystem = Ref<JPH::JobSystemThreadPool>(new JPH::JobSystemThreadPool(JPH::cMaxPhysicsJobs, JPH::cMaxPhysicsBarriers, static_cast<int>(JPH::thread::hardware_concurrency()) - 1));
+		m_JobSystem = Ref<JPH::JobSystemThreadPool>(new JPH::JobSystemThreadPool(JPH::cMaxPhysicsJobs, JPH::cMaxPhysicsBarriers, workerThreads));
+		// The calling thread executes jobs as well
+		m_ContactEventQueue = CreateRef<ContactEventQueue>(static_cast<uint32_t>(workerThreads) + 1);
+		// Every ParallelFor job owns a TempAllocator, TempAllocatorImpl is not thread-safe
+		for (int i = 0; i < m_JobSystem->GetMaxConcurrency(); i++)
+		{
+			m_JobTempAllocators.Add(Ref<JPH::TempAllocator>(new JPH::TempAllocatorImpl(1024 * 1024)));
+		}
 		constexpr JPH::uint cMaxBodies = 65536;
 		constexpr JPH::uint cNumBodyMutexes = 0;
 		constexpr JPH::uint cMaxBodyPairs = 65536;
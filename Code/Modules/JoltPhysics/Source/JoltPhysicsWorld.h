@@ -1,4 +1,5 @@
 #pragma once
+#include <vector>
 #include "Suora/Physics/PhysicsWorld.h"
 #include "JoltPhysicsWorld.generated.h"
 
@@ -10,6 +11,8 @@ namespace JPH
 	class ContactListener;
 
 	class Body;
+	struct RRayCast;
+	class RayCastResult;
 }
 
 namespace Suora::Physics
@@ -30,11 +33,59 @@ namespace Suora::Physics
 		virtual void TickCharacterNode(CharacterNode* node) override;
 
 		virtual bool Raycast(const Vec3& start, const Vec3& end, HitResult& result, const RaycastParams& params) override;
+		virtual bool RaycastAll(const Vec3& start, const Vec3& end, Array<HitResult>& results, const RaycastParams& params) override;
+		virtual bool ShapeCast(const ShapeCastQuery& query, HitResult& result, const RaycastParams& params) override;
+		virtual bool Overlap(const OverlapQuery& query, Array<ShapeNode*>& results, const RaycastParams& params) override;
+
+		virtual void RaycastBatch(const Array<RaycastQuery>& queries, Array<HitResult>& results, const RaycastParams& params) override;
+		virtual void ShapeCastBatch(const Array<ShapeCastQuery>& queries, Array<HitResult>& results, const RaycastParams& params) override;
+		virtual void OverlapBatch(const Array<OverlapQuery>& queries, Array<Array<ShapeNode*>>& results, const RaycastParams& params) override;
 
 		virtual void Step(double timeStep) override;
 
 		void Inititalize();
 
+		/** Jolt ObjectLayer of a body on the physics layer */
+		static uint16_t ToObjectLayer(uint32_t collisionLayer, bool isMoving);
+
+	protected:
+		virtual void DispatchContactEvents() override;
+		virtual void WriteBackTransforms(float alpha) override;
+
+	private:
+		/** Last two simulated poses of a moving body, indexed by JPH::BodyID::GetIndex() */
+		struct BodyTransformState
+		{
+			ShapeNode* Node = nullptr;
+			/** JPH::BodyID::GetIndexAndSequenceNumber() */
+			uint32_t BodyID = 0;
+			Vec3 PreviousPosition = Vec3(0.0f);
+			Vec3 Position = Vec3(0.0f);
+			Quat PreviousRotation = Quat(1.0f, 0.0f, 0.0f, 0.0f);
+			Quat Rotation = Quat(1.0f, 0.0f, 0.0f, 0.0f);
+			uint64_t LastStep = 0;
+			/** Cleared when gameplay code moves the body, the next Step then starts without interpolation */
+			bool IsValid = false;
+		};
+		BodyTransformState& GetBodyTransformState(uint32_t bodyIndex);
+		void RecordBodyTransform(uint32_t bodyIndex, const JPH::Body& body);
+		void UpdateBodyTransformStates();
+
+		void FillHitResult(const JPH::RRayCast& ray, const JPH::RayCastResult& hit, HitResult& result) const;
+		/** Runs func for all indices in [0, count) on the job system, the calling thread participates. worker < GetMaxConcurrency() identifies the job. */
+		void ParallelFor(uint32_t count, const std::function<void(uint32_t index, uint32_t worker)>& func);
+
+		struct CharacterSnapshot
+		{
+			Vec3 Position = Vec3(0.0f);
+			float Radius = 0.0f;
+			float HalfHeight = 0.0f;
+		};
+		/** Simulates all characters in parallel, overlapping characters are pushed apart */
+		void UpdateCharacters(float deltaTime);
+		static uint64_t GetCharacterCell(const Vec3& position, float cellSize, int32_t offsetX, int32_t offsetZ);
+		Vec3 ComputeCharacterSeparation(uint32_t index, float cellSize) const;
+
 	public:
 		Ref<JPH::PhysicsSystem> m_PhysicsSystem;
 		Ref<JPH::TempAllocator> m_TempAllocator;
@@ -45,10 +96,25 @@ namespace Suora::Physics
 		Ref<class ObjectLayerPairFilter> m_ObjectLayerPairFilter;
 
 		Ref<class JPH::ContactListener> m_ShapeContactListener;
+		Ref<struct ContactEventQueue> m_ContactEventQueue;
 
 		std::unordered_map<JPH::Body*, Suora::ShapeNode*> m_Body_Rigidbody;
 		std::unordered_map<Suora::ShapeNode*, JPH::Body*> m_Rigidbody_Body;
 		std::unordered_map<CharacterNode*, Ref<CharacterController>> m_CharacterControllers;
+
+	private:
+		std::vector<BodyTransformState> m_BodyTransformStates;
+		/** Indices of the bodies, whose transforms are written back */
+		std::vector<uint32_t> m_MovingBodies;
+		std::vector<uint32_t> m_PreviousMovingBodies;
+		uint64_t m_StepCount = 0;
+
+		/** Deterministic update order, independent of the hash map */
+		std::vector<class JoltCharacterController*> m_CharacterUpdateOrder;
+		std::vector<CharacterSnapshot> m_CharacterSnapshots;
+		/** Grid cell and index of every character, sorted */
+		std::vector<std::pair<uint64_t, uint32_t>> m_CharacterCells;
+		Array<Ref<JPH::TempAllocator>> m_JobTempAllocators;
 	};
 
 }
\ No newline at end of file
@@ -232,6 +232,7 @@ private:\n\
 		// Property Reflection
 		{
 			generated += "static void ReflClass(struct ClassReflector& desc)\n{\n\t/*Super::ReflClass(desc);*/\n\tdesc.SetClassName(\"" + header->m_ClassName + "\");\n\tdesc.SetNativeParentClass(" + header->m_ParentClass + "::StaticClass());\n\tdesc.SetClassSize(sizeof(" + header->m_ClassName + "));\n";
+			std::vector<std::string> memberNames;
 			size_t offset = header->m_ClassBodyBegin;
 			while (true)
 			{
@@ -251,9 +252,10 @@ private:\n\
 					offset++;
 					if (header->str[offset] != '\n' && header->str[offset] != '\t') member += header->str[offset];
 				}
-				GeneratePropertyReflection(header->m_ClassName, generated, meta, member);
+				memberNames.push_back(GeneratePropertyReflection(header->m_ClassName, generated, meta, member));
 			}
 			generated += "}\n";
+			GeneratePropertyIndices(generated, memberNames);
 		}
 
 		if (!header->m_IsStruct) generated += "\nprivate:";
@@ -304,7 +306,7 @@ private:\n\
 		str += "\n";
 	}
 
-	void HeaderTool::GeneratePropertyReflection(const std::string& className, std::string& str, const std::string& meta, std::string member)
+	std::string HeaderTool::GeneratePropertyReflection(const std::string& className, std::string& str, const std::string& meta, std::string member)
 	{
 		// Receive Member Info
 		bool erase = false;
@@ -340,6 +342,21 @@ private:\n\
 		str += "\t\tdesc.AddClassProperty(\"" + memberName + "\", " + offset + ", " + PropertyGenerator::GeneratePropertyRef(memberType) + ");\n";
 
 		str += "\t}\n";
+
+		return memberName;
+	}
+
+	// struct PropertyIndex { enum : uint32_t { m_Member = Super::PropertyIndex::PropertyCount, ..., PropertyCount }; };
+	// Matches the order of ClassReflector::GetAllClassMemberProperties(), which lists the properties of the Super first
+	void HeaderTool::GeneratePropertyIndices(std::string& str, const std::vector<std::string>& memberNames)
+	{
+		str += "struct PropertyIndex\n{\n\tenum : uint32_t\n\t{\n";
+		for (size_t i = 0; i < memberNames.size(); i++)
+		{
+			str += "\t\t" + memberNames[i] + (i == 0 ? " = Super::PropertyIndex::PropertyCount" : "") + ",\n";
+		}
+		str += std::string("\t\tPropertyCount") + (memberNames.empty() ? " = Super::PropertyIndex::PropertyCount" : "") + "\n";
+		str += "\t};\n};\n";
 	}
 
 	// FUNCTION(...meta...)
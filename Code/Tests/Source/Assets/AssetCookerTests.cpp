@@ -0,0 +1,150 @@
+#include "Test.h"
+#include <unordered_map>
+#include "Suora/Assets/AssetCooker.h"
+#include "Suora/Serialization/Yaml.h"
+
+namespace Suora::Tests
+{
+
+	static String ToYamlText(const Yaml::Node& root)
+	{
+		String text;
+		Yaml::Serialize(root, text);
+		return text;
+	}
+
+	SUORA_TEST(AssetCooker, CookedYamlRoundTrips)
+	{
+		Yaml::Node root;
+		root["UUID"] = "5d3f8a2e-1b4c-4f7a-9e6d-0c2b8a7f1e3d";
+		root["Empty"] = "";
+		root["Multiline"] = "First line\nSecond line: with a colon";
+		root["Node"]["Class"] = "Native$Node3D";
+		Yaml::Node& children = root["NodeComposition"]["Children"];
+		for (int32_t i = 0; i < 40; i++)
+		{
+			Yaml::Node& child = children[std::to_string(i)];
+			child["Name"] = "Child" + std::to_string(i);
+			Yaml::Node& sequence = child["Tags"];
+			for (int32_t j = 0; j <= i % 4; j++)
+			{
+				sequence.PushBack() = "Tag" + std::to_string(j);
+			}
+			// Sequences of maps and sequences
+			sequence.PushBack()["Nested"]["Deeper"] = std::to_string(i);
+			sequence.PushBack().PushBack() = "Inner";
+		}
+
+		std::vector<uint8_t> cooked;
+		AssetCooker::WriteCookedYaml(root, cooked);
+		SUORA_CHECK(AssetCooker::IsCookedYaml(cooked.data(), cooked.size()));
+
+		Yaml::Node read;
+		SUORA_REQUIRE(AssetCooker::ReadCookedYaml(cooked.data(), cooked.size(), read));
+		SUORA_CHECK_EQ(ToYamlText(read), ToYamlText(root));
+		SUORA_CHECK_EQ(read["NodeComposition"]["Children"]["7"]["Tags"][4]["Nested"]["Deeper"].As<String>(), String("7"));
+
+		// An empty document survives as well
+		Yaml::Node empty, emptyRead;
+		AssetCooker::WriteCookedYaml(empty, cooked);
+		SUORA_CHECK(AssetCooker::ReadCookedYaml(cooked.data(), cooked.size(), emptyRead));
+		SUORA_CHECK(emptyRead.IsNone());
+	}
+
+	SUORA_TEST(AssetCooker, DamagedCookedYamlFails)
+	{
+		Yaml::Node root;
+		root["Name"] = "Level";
+		root["Children"]["0"]["Name"] = "Child";
+		root["List"].PushBack() = "Entry";
+		std::vector<uint8_t> cooked;
+		AssetCooker::WriteCookedYaml(root, cooked);
+
+		// Text Assets are not cooked Yaml
+		const String text = ToYamlText(root);
+		Yaml::Node read;
+		SUORA_CHECK(!AssetCooker::IsCookedYaml((const uint8_t*)text.data(), text.size()));
+		SUORA_CHECK(!AssetCooker::ReadCookedYaml((const uint8_t*)text.data(), text.size(), read));
+
+		for (size_t size = 0; size < cooked.size(); size++)
+		{
+			Yaml::Node truncated;
+			SUORA_CHECK(!AssetCooker::ReadCookedYaml(cooked.data(), size, truncated));
+		}
+
+		// Unknown node types
+		std::vector<uint8_t> damaged = cooked;
+		damaged[4] = 0xEE;
+		SUORA_CHECK(!AssetCooker::ReadCookedYaml(damaged.data(), damaged.size(), read));
+
+		// Deeper than any Asset, e.g. a loop of map headers
+		std::vector<uint8_t> deep(cooked.begin(), cooked.begin() + 4);
+		for (int32_t i = 0; i < 1000; i++)
+		{
+			deep.insert(deep.end(), { (uint8_t)Yaml::Node::SequenceType, 1 });
+		}
+		Yaml::Node deepRead;
+		SUORA_CHECK(!AssetCooker::ReadCookedYaml(deep.data(), deep.size(), deepRead));
+	}
+
+	SUORA_TEST(AssetCooker, FindsReferencesInAssetFiles)
+	{
+		const String a = "0a1b2c3d-4e5f-6a7b-8c9d-0e1f2a3b4c5d";
+		const String b = "FFFFFFFF-0000-1111-2222-333344445555";
+		const String text = "UUID: " + a + "\nm_Mesh:\n  AssetPtr: " + b + "\n"
+			// Longer hex runs and wrong separators are no SuoraIDs
+			+ "Hash: 7" + a + "\nOther: " + a + "0\nBroken: 0a1b2c3d_4e5f-6a7b-8c9d-0e1f2a3b4c5d\n"
+			+ "Adjacent: [" + b + "," + a + "]";
+
+		const std::vector<String> references = AssetCooker::FindAssetReferences(text);
+		SUORA_CHECK(references == std::vector<String>({ a, b, b, a }));
+		SUORA_CHECK(AssetCooker::FindAssetReferences("").empty());
+		SUORA_CHECK(AssetCooker::FindAssetReferences(a) == std::vector<String>({ a }));
+	}
+
+	SUORA_TEST(AssetCooker, OnlyReachableAssetsAreWalked)
+	{
+		auto id = [](int32_t i)
+		{
+			String str = "00000000-0000-0000-0000-000000000000";
+			str.replace(str.size() - 2, 2, (i < 10 ? "0" : "") + std::to_string(i));
+			return str;
+		};
+
+		// 0 is the root. 3 references the root back, 4 references an Asset, that does not exist.
+		// 5 and 6 reference each other, but nothing reachable references them.
+		std::unordered_map<String, String> files;
+		files[id(0)] = "Level: " + id(1) + "\nMesh: " + id(2);
+		files[id(1)] = "Material: " + id(3) + "\nAgain: " + id(2);
+		files[id(2)] = "Texture: " + id(4);
+		files[id(3)] = "Parent: " + id(0);
+		files[id(4)] = "Missing: " + id(99);
+		files[id(5)] = "Other: " + id(6);
+		files[id(6)] = "Other: " + id(5);
+
+		std::vector<String> reads;
+		const std::vector<String> reachable = AssetCooker::WalkAssetReferences({ id(0) }, [&](const String& asset, String& text)
+		{
+			reads.push_back(asset);
+			auto It = files.find(asset);
+			if (It == files.end()) return false;
+			text = It->second;
+			return true;
+		});
+
+		// Breadth first, every Asset is read once
+		SUORA_CHECK(reachable == std::vector<String>({ id(0), id(1), id(2), id(3), id(4) }));
+		SUORA_CHECK(reads == std::vector<String>({ id(0), id(1), id(2), id(3), id(4), id(99) }));
+
+		// Several roots, duplicates among them are walked once
+		const std::vector<String> both = AssetCooker::WalkAssetReferences({ id(5), id(2), id(5) }, [&](const String& asset, String& text)
+		{
+			auto It = files.find(asset);
+			if (It == files.end()) return false;
+			text = It->second;
+			return true;
+		});
+		SUORA_CHECK(both == std::vector<String>({ id(5), id(2), id(6), id(4) }));
+	}
+
+}
@@ -0,0 +1,254 @@
+#include "Test.h"
+#include <filesystem>
+#include "Suora/Assets/AssetManager.h"
+#include "Suora/Assets/Level.h"
+#include "Suora/Assets/Mesh.h"
+#include "Suora/Common/VectorUtils.h"
+#include "Suora/GameFramework/GameInstance.h"
+#include "Suora/GameFramework/LevelStreamer.h"
+#include "Suora/GameFramework/Nodes/MeshNode.h"
+#include "Suora/GameFramework/World.h"
+#include "Suora/Platform/Platform.h"
+#include "Suora/Serialization/Yaml.h"
+
+namespace Suora::Tests
+{
+
+	/** A Level file in the temp directory, that is deleted together with its Asset once the test returns */
+	class StreamingLevelFile
+	{
+	public:
+		StreamingLevelFile(const String& name)
+			: m_Name(name), m_Path(std::filesystem::temp_directory_path() / (name + ".level"))
+		{
+		}
+		~StreamingLevelFile()
+		{
+			Asset* level = AssetManager::GetAssetByPath(m_Path);
+			if (level) AssetManager::RemoveAsset(level);
+			else Platform::RemoveFile(m_Path);
+		}
+		StreamingLevelFile(const StreamingLevelFile&) = delete;
+		StreamingLevelFile& operator=(const StreamingLevelFile&) = delete;
+
+		const String& GetName() const { return m_Name; }
+		const std::filesystem::path& GetPath() const { return m_Path; }
+	private:
+		String m_Name;
+		std::filesystem::path m_Path;
+	};
+
+	/** A flat Level of Node3D Actors. The first ones are MeshNodes that reference Meshes, which do not exist yet,
+	 *  so the instantiation on the worker thread creates missing Assets. */
+	static Level* CreateStreamingLevel(const StreamingLevelFile& file, int32_t actorCount, const Array<String>& missingMeshes)
+	{
+		const String& name = file.GetName();
+		Yaml::Node root;
+		root["UUID"] = SuoraID::Generate().GetString();
+		root["Node"]["Class"] = Node::StaticClass().ToString();
+
+		Yaml::Node& composition = root["NodeComposition"];
+		composition["RootName"] = name;
+		composition["RootParentClass"] = Node::StaticClass().ToString();
+		composition["RootEnabled"] = "true";
+		composition["ChildCount"] = std::to_string(actorCount);
+		for (int32_t i = 0; i < actorCount; i++)
+		{
+			Yaml::Node& child = composition["Children"][std::to_string(i)];
+			child["Name"] = "Actor" + std::to_string(i);
+			child["Enabled"] = "true";
+			child["Node3D"] = Vec::ToString<Mat4>(glm::translate(Mat4(1.0f), Vec3((float)(i % 316), 0.0f, (float)(i / 316))));
+			child["Class"] = (i < missingMeshes.Size() ? MeshNode::StaticClass() : Node3D::StaticClass()).ToString();
+			child["SocketName"] = "";
+		}
+		composition["PropertyCount"] = std::to_string(missingMeshes.Size());
+		for (int32_t i = 0; i < missingMeshes.Size(); i++)
+		{
+			Yaml::Node& property = composition["Properties"][std::to_string(i)];
+			property["NodeName"] = "Actor" + std::to_string(i);
+			property["PropertyName"] = "m_Mesh";
+			property["Value"]["AssetPtr"] = missingMeshes[i];
+		}
+
+		const std::filesystem::path& path = file.GetPath();
+		String content;
+		Yaml::Serialize(root, content);
+		Platform::WriteToFile(path.string(), content);
+		AssetManager::LoadAsset(path.string());
+
+		Asset* level = AssetManager::GetAssetByPath(path);
+		return level ? level->As<Level>() : nullptr;
+	}
+
+	static Array<String> GenerateMeshIDs(int32_t count)
+	{
+		Array<String> ids;
+		for (int32_t i = 0; i < count; i++) ids.Add(SuoraID::Generate().GetString());
+		return ids;
+	}
+
+	SUORA_TEST(LevelStreaming, CreatesMissingAssetsWhileTheMainThreadReads)
+	{
+		const Array<String> meshes = GenerateMeshIDs(256);
+		const StreamingLevelFile file("StreamingTestLevel_100k");
+		Level* level = CreateStreamingLevel(file, 100000, meshes);
+		SUORA_REQUIRE(level);
+
+		World world;
+		LevelStreamer streamer(nullptr);
+		LevelLoadParams params;
+		params.TargetWorld = &world;
+		Ref<LevelLoadRequest> request = streamer.LoadLevelAsync(level, params);
+
+		// Every reader and writer of the AssetManager, while the worker adds the missing Meshes
+		uint32_t rounds = 0;
+		while (request->GetState() == LevelLoadState::Instantiating)
+		{
+			AssetManager::GetAssets<Mesh>();
+			AssetManager::GetFirstAssetOfType<Mesh>();
+			AssetManager::GetAssetByName<Mesh>("NoSuchMesh");
+			AssetManager::GetAssetsByClass(Mesh::StaticClass());
+			AssetManager::InitializeAllAssets();
+			streamer.Update();
+			rounds++;
+		}
+		while (!request->IsDone())
+		{
+			streamer.Update();
+		}
+		SuoraLog("  {0} rounds of Asset reads during the instantiation", rounds);
+
+		SUORA_REQUIRE(request->GetState() == LevelLoadState::Loaded);
+		SUORA_CHECK_EQ(request->GetRoot()->GetChildCount(), 100000);
+
+		// Each missing Mesh was created exactly once, and all MeshNodes point at it
+		const Array<Asset*> allMeshes = AssetManager::GetAssetsByClass(Mesh::StaticClass());
+		for (int32_t i = 0; i < meshes.Size(); i++)
+		{
+			Asset* created = nullptr;
+			int32_t count = 0;
+			for (Asset* mesh : allMeshes)
+			{
+				if (mesh->m_UUID.GetString() != meshes[i]) continue;
+				created = mesh;
+				count++;
+			}
+			SUORA_CHECK_EQ(count, 1);
+			SUORA_CHECK(created && created->IsMissing());
+
+			MeshNode* node = request->GetRoot()->GetChild(i)->As<MeshNode>();
+			SUORA_CHECK(node && node->GetMesh() == created);
+		}
+	}
+
+	SUORA_TEST(LevelStreaming, AttachesWithinTheFrameBudget)
+	{
+		const StreamingLevelFile file("StreamingTestLevel_Budget");
+		Level* level = CreateStreamingLevel(file, 100000, {});
+		SUORA_REQUIRE(level);
+
+		World world;
+		LevelStreamer streamer(nullptr);
+		streamer.SetFrameBudget(1.0f);
+		LevelLoadParams params;
+		params.TargetWorld = &world;
+		Ref<LevelLoadRequest> request = streamer.LoadLevelAsync(level, params);
+
+		int32_t attachingFrames = 0;
+		float progress = 0.0f;
+		while (!request->IsDone())
+		{
+			streamer.Update();
+			SUORA_CHECK(request->GetProgress() >= progress);
+			progress = request->GetProgress();
+			if (request->GetState() == LevelLoadState::Attaching) attachingFrames++;
+		}
+
+		SUORA_CHECK(request->GetState() == LevelLoadState::Loaded);
+		SUORA_CHECK(attachingFrames > 1);
+		SUORA_CHECK_EQ(request->GetRoot()->GetChildCount(), 100000);
+		SUORA_CHECK_EQ(progress, 1.0f);
+	}
+
+	SUORA_TEST(LevelStreaming, UnloadCancelsAPendingLoad)
+	{
+		const StreamingLevelFile file("StreamingTestLevel_Cancel");
+		Level* level = CreateStreamingLevel(file, 100000, GenerateMeshIDs(16));
+		SUORA_REQUIRE(level);
+
+		World world;
+		LevelStreamer streamer(nullptr);
+		LevelLoadParams params;
+		params.TargetWorld = &world;
+		Ref<LevelLoadRequest> request = streamer.LoadLevelAsync(level, params);
+		streamer.Unload(request);
+		while (!request->IsDone())
+		{
+			streamer.Update();
+		}
+
+		SUORA_CHECK(request->GetState() == LevelLoadState::Cancelled);
+		SUORA_CHECK(request->GetRoot() == nullptr);
+		SUORA_CHECK_EQ(streamer.GetPendingRequestCount(), 0u);
+	}
+
+	SUORA_TEST(LevelStreaming, CancelledLoadsDestroyTheirWorld)
+	{
+		const StreamingLevelFile file("StreamingTestLevel_OwnWorld");
+		Level* level = CreateStreamingLevel(file, 1000, {});
+		SUORA_REQUIRE(level);
+
+		GameInstance game;
+		LevelStreamer& streamer = game.GetLevelStreamer();
+		Ref<LevelLoadRequest> request = streamer.LoadLevelAsync(level, LevelLoadParams());
+		Ptr<World> world = request->GetWorld();
+		SUORA_REQUIRE(world);
+		streamer.Unload(request);
+		while (!request->IsDone())
+		{
+			streamer.Update();
+		}
+
+		SUORA_CHECK(request->GetState() == LevelLoadState::Cancelled);
+		SUORA_CHECK(request->GetWorld() == nullptr);
+		SUORA_CHECK(!world);
+	}
+
+	SUORA_BENCHMARK(LevelStreaming, HundredThousandNodes)
+	{
+		const StreamingLevelFile file("StreamingTestLevel_Benchmark");
+		Level* level = CreateStreamingLevel(file, 100000, GenerateMeshIDs(256));
+		SUORA_REQUIRE(level);
+
+		World world;
+		LevelStreamer streamer(nullptr);
+		LevelLoadParams params;
+		params.TargetWorld = &world;
+
+		const auto begin = std::chrono::steady_clock::now();
+		Ref<LevelLoadRequest> request = streamer.LoadLevelAsync(level, params);
+		int32_t frames = 0;
+		double maxFrameMs = 0.0;
+		double instantiatedMs = 0.0;
+		while (!request->IsDone())
+		{
+			const auto frameBegin = std::chrono::steady_clock::now();
+			AssetManager::GetAssets<Mesh>();
+			streamer.Update();
+			const auto frameEnd = std::chrono::steady_clock::now();
+
+			maxFrameMs = glm::max(maxFrameMs, std::chrono::duration<double, std::milli>(frameEnd - frameBegin).count());
+			if (instantiatedMs == 0.0 && request->GetState() != LevelLoadState::Instantiating)
+			{
+				instantiatedMs = std::chrono::duration<double, std::milli>(frameEnd - begin).count();
+			}
+			frames++;
+		}
+		const double totalMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+
+		SUORA_CHECK(request->GetState() == LevelLoadState::Loaded);
+		SuoraLog("  100k Nodes streamed in {0:.1f} ms over {1} frames, instantiated after {2:.1f} ms. Longest frame {3:.3f} ms with a {4:.1f} ms budget",
+			totalMs, frames, instantiatedMs, maxFrameMs, streamer.GetFrameBudget());
+	}
+
+}
@@ -0,0 +1,238 @@
+#include "Test.h"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include "Suora/Assets/PackageArchive.h"
+
+namespace Suora::Tests
+{
+
+	static bool RoundTripsLZ4(const std::vector<uint8_t>& data, size_t* outCompressedSize = nullptr)
+	{
+		std::vector<uint8_t> compressed;
+		PackageCompressor::Compress(data.data(), data.size(), compressed);
+		if (outCompressedSize) *outCompressedSize = compressed.size();
+
+		std::vector<uint8_t> decompressed(data.size());
+		return PackageCompressor::Decompress(compressed.data(), compressed.size(), decompressed.data(), decompressed.size()) && decompressed == data;
+	}
+
+	static std::vector<uint8_t> RandomBytes(TestRandom& random, size_t size)
+	{
+		std::vector<uint8_t> data(size);
+		for (uint8_t& byte : data) byte = (uint8_t)random.Int(0, 255);
+		return data;
+	}
+
+	static std::filesystem::path GetTestPackagePath(const String& name)
+	{
+		return std::filesystem::temp_directory_path() / (name + ".pak");
+	}
+
+	SUORA_TEST(PackageArchive, LZ4RoundTrips)
+	{
+		TestRandom random(43);
+
+		SUORA_CHECK(RoundTripsLZ4({}));
+		// Below the 12 bytes, that the format needs for a match, everything is one run of literals
+		for (size_t size = 1; size < 16; size++)
+		{
+			SUORA_CHECK(RoundTripsLZ4(std::vector<uint8_t>(size, 'a')));
+			SUORA_CHECK(RoundTripsLZ4(RandomBytes(random, size)));
+		}
+
+		// Incompressible data grows by less than the worst case, the writer stores it uncompressed anyway
+		size_t compressedSize = 0;
+		const std::vector<uint8_t> noise = RandomBytes(random, 200000);
+		SUORA_CHECK(RoundTripsLZ4(noise, &compressedSize));
+		SUORA_CHECK(compressedSize <= noise.size() + noise.size() / 255 + 16);
+
+		// Long runs need length bytes beyond the token, and overlap their own output with offset 1
+		const std::vector<uint8_t> zeros(1 << 20, 0);
+		SUORA_CHECK(RoundTripsLZ4(zeros, &compressedSize));
+		SUORA_CHECK(compressedSize < zeros.size() / 200);
+
+		// Overlapping matches with offsets shorter than the match
+		for (size_t period : { 2, 3, 7, 15, 16, 17 })
+		{
+			std::vector<uint8_t> pattern(5000);
+			for (size_t i = 0; i < pattern.size(); i++) pattern[i] = (uint8_t)('a' + i % period);
+			SUORA_CHECK(RoundTripsLZ4(pattern));
+		}
+
+		// Text-like data with matches at every distance up to beyond the 64 KB window
+		std::vector<uint8_t> text;
+		const char* words[] = { "Node3D", "Transform", "m_Mesh: ", "UUID", "\n  ", "Children", "0.000000", "Enabled: true" };
+		while (text.size() < 300000)
+		{
+			const char* word = words[random.Int(0, 7)];
+			text.insert(text.end(), word, word + strlen(word));
+			if (random.Int(0, 9) == 0) text.push_back((uint8_t)random.Int(0, 255));
+		}
+		SUORA_CHECK(RoundTripsLZ4(text, &compressedSize));
+		SUORA_CHECK(compressedSize < text.size() / 2);
+	}
+
+	SUORA_TEST(PackageArchive, LZ4RejectsCorruptedBlocks)
+	{
+		std::vector<uint8_t> data(4000);
+		for (size_t i = 0; i < data.size(); i++) data[i] = (uint8_t)(i % 13 + i / 500);
+		std::vector<uint8_t> compressed;
+		PackageCompressor::Compress(data.data(), data.size(), compressed);
+		std::vector<uint8_t> out(data.size());
+
+		// Truncated blocks and blocks of a different size
+		for (size_t size : { (size_t)1, compressed.size() / 2, compressed.size() - 1 })
+		{
+			SUORA_CHECK(!PackageCompressor::Decompress(compressed.data(), size, out.data(), out.size()));
+		}
+		SUORA_CHECK(!PackageCompressor::Decompress(compressed.data(), compressed.size(), out.data(), out.size() - 1));
+		std::vector<uint8_t> larger(data.size() + 1);
+		SUORA_CHECK(!PackageCompressor::Decompress(compressed.data(), compressed.size(), larger.data(), larger.size()));
+
+		// A match in front of the output, a zero offset and literals beyond the input
+		const uint8_t matchBeforeStart[] = { 0x14, 'a', 0x05, 0x00, 0x00 };
+		const uint8_t zeroOffset[] = { 0x14, 'a', 0x00, 0x00, 0x00 };
+		const uint8_t literalsBeyondInput[] = { 0x50, 'a', 'b' };
+		const uint8_t unterminatedLength[] = { 0xF0, 255, 255 };
+		SUORA_CHECK(!PackageCompressor::Decompress(matchBeforeStart, sizeof(matchBeforeStart), out.data(), 5));
+		SUORA_CHECK(!PackageCompressor::Decompress(zeroOffset, sizeof(zeroOffset), out.data(), 5));
+		SUORA_CHECK(!PackageCompressor::Decompress(literalsBeyondInput, sizeof(literalsBeyondInput), out.data(), 5));
+		SUORA_CHECK(!PackageCompressor::Decompress(unterminatedLength, sizeof(unterminatedLength), out.data(), out.size()));
+
+		// Random damage either fails or stays inside the output, checked by the sanitizers of the Debug build
+		TestRandom random(4300);
+		for (int32_t i = 0; i < 2000; i++)
+		{
+			std::vector<uint8_t> damaged = compressed;
+			damaged[random.Int(0, (int32_t)damaged.size() - 1)] ^= (uint8_t)random.Int(1, 255);
+			PackageCompressor::Decompress(damaged.data(), damaged.size(), out.data(), out.size());
+		}
+	}
+
+	SUORA_TEST(PackageArchive, WriterAndArchiveRoundTrip)
+	{
+		const std::filesystem::path path = GetTestPackagePath("PackageArchiveRoundTrip");
+		TestRandom random(430);
+
+		std::vector<std::pair<String, std::vector<uint8_t>>> files;
+		files.push_back({ "Content/Empty.txt", {} });
+		files.push_back({ "Content/Noise.bin", RandomBytes(random, 50000) });
+		files.push_back({ "Content/Zeros.bin", std::vector<uint8_t>(100000, 0) });
+		files.push_back({ "EngineContent/Small.txt", { 'S', 'u', 'o', 'r', 'a' } });
+		{
+			PackageWriter writer;
+			SUORA_REQUIRE(writer.Open(path));
+			for (const auto& [name, data] : files)
+			{
+				SUORA_CHECK(writer.AddFile(name, data, PackageCompression::LZ4));
+			}
+			SUORA_CHECK(writer.AddHashOnly("Content/Source.fbx", 0x1234567890ull, 777));
+			SUORA_CHECK(!writer.AddFile("Content/Noise.bin", {}, PackageCompression::None));
+			SUORA_CHECK(!writer.AddHashOnly("Content/Source.fbx", 0, 0));
+			SUORA_CHECK_EQ(writer.GetStats().Entries, 5u);
+			SUORA_CHECK(writer.Finish());
+		}
+
+		Ref<PackageArchive> archive = PackageArchive::Open(path);
+		SUORA_REQUIRE(archive);
+		SUORA_CHECK_EQ(archive->GetEntries().size(), 5u);
+		for (const auto& [name, data] : files)
+		{
+			const PackageEntry* entry = archive->Find(name);
+			SUORA_REQUIRE(entry);
+			std::vector<uint8_t> read = { 1, 2, 3 };
+			SUORA_CHECK(archive->Read(*entry, read));
+			SUORA_CHECK(read == data);
+		}
+		// Only what shrinks is stored compressed
+		SUORA_CHECK(archive->Find("Content/Zeros.bin")->Compression == PackageCompression::LZ4);
+		SUORA_CHECK(archive->Find("Content/Noise.bin")->Compression == PackageCompression::None);
+
+		const PackageEntry* hashOnly = archive->Find("Content/Source.fbx");
+		SUORA_REQUIRE(hashOnly);
+		SUORA_CHECK(hashOnly->Flags & PackageEntryFlags::HashOnly);
+		SUORA_CHECK_EQ(hashOnly->Hash, 0x1234567890ull);
+		SUORA_CHECK_EQ(hashOnly->RawSize, 777u);
+		std::vector<uint8_t> nothing;
+		SUORA_CHECK(!archive->Read(*hashOnly, nothing));
+		SUORA_CHECK(archive->Find("Content/Missing.txt") == nullptr);
+
+		archive = nullptr;
+		std::filesystem::remove(path);
+	}
+
+	static void DamageByte(const std::filesystem::path& path, uint64_t offset)
+	{
+		std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+		file.seekg((std::streamoff)offset);
+		const char byte = (char)(file.get() ^ 0x5A);
+		file.seekp((std::streamoff)offset);
+		file.put(byte);
+	}
+
+	SUORA_TEST(PackageArchive, DamagedPackagesAreRejected)
+	{
+		const std::filesystem::path path = GetTestPackagePath("PackageArchiveDamaged");
+		TestRandom random(4301);
+		const std::vector<uint8_t> noise = RandomBytes(random, 1000);
+		std::vector<uint8_t> text(1000);
+		for (size_t i = 0; i < text.size(); i++) text[i] = (uint8_t)('a' + i % 5 + (i % 97 == 0));
+
+		auto write = [&]()
+		{
+			PackageWriter writer;
+			writer.Open(path);
+			writer.AddFile("Noise.bin", noise, PackageCompression::LZ4);
+			writer.AddFile("Text.txt", text, PackageCompression::LZ4);
+			return writer.Finish();
+		};
+
+		// The table of contents is the end of the file
+		SUORA_REQUIRE(write());
+		DamageByte(path, std::filesystem::file_size(path) - 3);
+		SUORA_CHECK(PackageArchive::Open(path) == nullptr);
+
+		auto getEntry = [&](const String& name)
+		{
+			Ref<PackageArchive> archive = PackageArchive::Open(path);
+			return archive ? *archive->Find(name) : PackageEntry();
+		};
+
+		// A damaged blob still opens, but reading it fails, even if it is stored uncompressed
+		SUORA_REQUIRE(write());
+		const PackageEntry noiseEntry = getEntry("Noise.bin");
+		SUORA_REQUIRE(noiseEntry.Compression == PackageCompression::None);
+		DamageByte(path, noiseEntry.Offset + 500);
+		{
+			Ref<PackageArchive> archive = PackageArchive::Open(path);
+			SUORA_REQUIRE(archive);
+			std::vector<uint8_t> data;
+			SUORA_CHECK(!archive->Read(*archive->Find("Noise.bin"), data));
+			SUORA_CHECK(data.empty());
+			SUORA_CHECK(archive->Read(*archive->Find("Text.txt"), data));
+			SUORA_CHECK(data == text);
+		}
+
+		// A literal inside a compressed blob decompresses to the right size, only the hash notices
+		SUORA_REQUIRE(write());
+		const PackageEntry textEntry = getEntry("Text.txt");
+		SUORA_REQUIRE(textEntry.Compression == PackageCompression::LZ4);
+		DamageByte(path, textEntry.Offset + 1);
+		{
+			Ref<PackageArchive> archive = PackageArchive::Open(path);
+			SUORA_REQUIRE(archive);
+			std::vector<uint8_t> data;
+			SUORA_CHECK(!archive->Read(*archive->Find("Text.txt"), data));
+		}
+
+		// Not a package at all
+		{
+			std::ofstream file(path, std::ios::binary | std::ios::trunc);
+			file << "Not a package";
+		}
+		SUORA_CHECK(PackageArchive::Open(path) == nullptr);
+		std::filesystem::remove(path);
+	}
+
+}
@@ -0,0 +1,311 @@
+#include "Test.h"
+#include <mutex>
+#include <thread>
+#include "Suora/Core/TaskScheduler.h"
+
+namespace Suora::Tests
+{
+
+	/** Restarts the TaskScheduler with a fixed number of workers, and with the default number again at the end */
+	struct ScopedTaskWorkers
+	{
+		explicit ScopedTaskWorkers(uint32_t workerCount)
+		{
+			TaskScheduler::Shutdown();
+			TaskScheduler::Initialize(workerCount);
+		}
+		~ScopedTaskWorkers()
+		{
+			TaskScheduler::Shutdown();
+			TaskScheduler::Initialize();
+		}
+	};
+
+	/** Occupies every worker, so that Tasks stay queued until Release() */
+	struct BlockedWorkers
+	{
+		std::atomic<bool> Released = false;
+		std::atomic<uint32_t> Started = 0;
+		std::vector<Task<void>> Blockers;
+
+		BlockedWorkers()
+		{
+			const uint32_t workerCount = TaskScheduler::GetWorkerCount();
+			for (uint32_t i = 0; i < workerCount; i++)
+			{
+				Blockers.push_back(TaskScheduler::Run([this]()
+				{
+					Started++;
+					while (!Released) std::this_thread::yield();
+				}, TaskPriority::High, "Blocker"));
+			}
+			// A blocked worker cannot take a second Blocker, so every worker holds one
+			while (Started < workerCount) std::this_thread::yield();
+		}
+		~BlockedWorkers()
+		{
+			Release();
+		}
+
+		void Release()
+		{
+			Released = true;
+			for (Task<void>& blocker : Blockers) blocker.Wait();
+		}
+	};
+
+	static void WaitForQueuedTasks()
+	{
+		while (TaskScheduler::GetStats().QueuedTasks > 0) std::this_thread::yield();
+	}
+
+	SUORA_TEST(TaskScheduler, TasksRunByPriority)
+	{
+		ScopedTaskWorkers workers(1);
+		BlockedWorkers blocked;
+
+		std::mutex mutex;
+		std::vector<char> order;
+		auto record = [&](char id)
+		{
+			return [&mutex, &order, id]()
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				order.push_back(id);
+			};
+		};
+		const std::pair<char, TaskPriority> submitted[] = { { 'A', TaskPriority::Low }, { 'B', TaskPriority::Normal }, { 'C', TaskPriority::High },
+			{ 'D', TaskPriority::Normal }, { 'E', TaskPriority::Low }, { 'F', TaskPriority::High } };
+		std::vector<Task<void>> tasks;
+		for (const auto& [id, priority] : submitted)
+		{
+			tasks.push_back(TaskScheduler::Run(record(id), priority));
+		}
+		SUORA_CHECK_EQ(TaskScheduler::GetStats().QueuedTasks, 6u);
+
+		// Waiting on the handles would run the Tasks on this thread, out of order
+		blocked.Release();
+		WaitForQueuedTasks();
+		for (Task<void>& task : tasks) task.Wait();
+
+		// By priority, first in first out within the same priority
+		SUORA_CHECK(order == std::vector<char>({ 'C', 'F', 'B', 'D', 'A', 'E' }));
+	}
+
+	SUORA_TEST(TaskScheduler, CancelledTasksNeitherRunNorContinue)
+	{
+		ScopedTaskWorkers workers(1);
+		std::atomic<bool> ran = false;
+		bool continued = false;
+		TaskScheduler::PumpMainThread(1000.0f);
+
+		{
+			BlockedWorkers blocked;
+			Task<int32_t> pending = TaskScheduler::Run([&ran]() { ran = true; return 1; }, [&continued]() { continued = true; });
+			pending.Cancel();
+			pending.Wait();
+			SUORA_CHECK(pending.GetStatus() == TaskStatus::Cancelled);
+			SUORA_CHECK(pending.IsCancelled());
+			SUORA_CHECK(!pending.IsReady());
+		}
+		WaitForQueuedTasks();
+		TaskScheduler::PumpMainThread(1000.0f);
+		SUORA_CHECK(!ran);
+		SUORA_CHECK(!continued);
+
+		// Running work finishes on its own terms, but its continuation is dropped
+		std::atomic<bool> started = false;
+		Task<int32_t> running = TaskScheduler::Run([&started]()
+		{
+			started = true;
+			while (!TaskScheduler::IsCancellationRequested()) std::this_thread::yield();
+			return 49;
+		}, [&continued]() { continued = true; });
+		while (!started) std::this_thread::yield();
+		running.Cancel();
+		running.Wait();
+		SUORA_CHECK(running.GetStatus() == TaskStatus::Completed);
+		SUORA_CHECK(running.IsCancelled());
+		SUORA_CHECK_EQ(running.Get(), 49);
+		TaskScheduler::PumpMainThread(1000.0f);
+		SUORA_CHECK(!continued);
+	}
+
+	SUORA_TEST(TaskScheduler, WaitRunsUnstartedTasksInline)
+	{
+		ScopedTaskWorkers workers(1);
+		std::atomic<uint32_t> runs = 0;
+		{
+			BlockedWorkers blocked;
+			Task<std::thread::id> task = TaskScheduler::Run([&runs]() { runs++; return std::this_thread::get_id(); });
+			SUORA_CHECK(task.GetStatus() == TaskStatus::Pending);
+			SUORA_CHECK(task.Get() == std::this_thread::get_id());
+			SUORA_CHECK(task.IsReady());
+
+			// Main thread jobs as well, when the main thread waits for them
+			Task<bool> mainThreadJob = TaskScheduler::RunOnMainThread([]() { return TaskScheduler::IsMainThread(); });
+			SUORA_CHECK(mainThreadJob.Get());
+		}
+
+		// The worker and PumpMainThread() find the queued jobs completed and skip them
+		WaitForQueuedTasks();
+		Task<void> after = TaskScheduler::Run([]() {});
+		after.Wait();
+		SUORA_CHECK_EQ(runs.load(), 1u);
+
+		const uint64_t executedBefore = TaskScheduler::GetStats().MainThreadJobsExecuted;
+		TaskScheduler::PumpMainThread(1000.0f);
+		SUORA_CHECK_EQ(TaskScheduler::GetStats().MainThreadJobsExecuted, executedBefore);
+		SUORA_CHECK_EQ(TaskScheduler::GetStats().QueuedMainThreadJobs, 0u);
+	}
+
+	SUORA_TEST(TaskScheduler, NestedParallelForCoversEveryIndexOnce)
+	{
+		constexpr uint32_t outerCount = 64, innerCount = 1000;
+		std::vector<std::atomic<uint32_t>> hits(outerCount * innerCount);
+
+		// The ranges of the inner loops are queued with High priority while the outer loop occupies the workers,
+		// every caller finishes its own ranges if nobody helps
+		TaskScheduler::ParallelFor(outerCount, [&hits](uint32_t outerBegin, uint32_t outerEnd)
+		{
+			for (uint32_t i = outerBegin; i < outerEnd; i++)
+			{
+				TaskScheduler::ParallelFor(innerCount, [&hits, i](uint32_t begin, uint32_t end)
+				{
+					for (uint32_t j = begin; j < end; j++) hits[i * innerCount + j]++;
+				});
+			}
+		});
+
+		uint32_t wrong = 0;
+		for (const std::atomic<uint32_t>& hit : hits)
+		{
+			if (hit != 1) wrong++;
+		}
+		SUORA_CHECK_EQ(wrong, 0u);
+
+		// Limited to one thread, everything runs as one range on the caller
+		std::vector<std::pair<uint32_t, uint32_t>> ranges;
+		TaskScheduler::ParallelFor(100, [&ranges](uint32_t begin, uint32_t end) { ranges.push_back({ begin, end }); }, 1);
+		SUORA_REQUIRE(ranges.size() == 1);
+		SUORA_CHECK(ranges[0] == std::make_pair(0u, 100u));
+	}
+
+	SUORA_TEST(TaskScheduler, PumpMainThreadKeepsItsBudget)
+	{
+		TaskScheduler::PumpMainThread(1000.0f);
+		constexpr int32_t normalCount = 20, highCount = 5;
+		int32_t normalRuns = 0, highRuns = 0;
+		auto sleepAndCount = [](int32_t& counter)
+		{
+			return [&counter]()
+			{
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+				counter++;
+			};
+		};
+
+		for (int32_t i = 0; i < normalCount; i++)
+		{
+			TaskScheduler::RunOnMainThread(sleepAndCount(normalRuns), TaskPriority::Normal);
+		}
+		// The first job always runs, the next ones only while the budget lasts
+		TaskScheduler::PumpMainThread(2.5f);
+		SUORA_CHECK(normalRuns >= 1 && normalRuns < normalCount);
+		SUORA_CHECK_EQ(TaskScheduler::GetStats().MainThreadJobsDeferred, (uint32_t)(normalCount - normalRuns));
+
+		// High priority jobs go first and ignore the budget
+		for (int32_t i = 0; i < highCount; i++)
+		{
+			TaskScheduler::RunOnMainThread(sleepAndCount(highRuns), TaskPriority::High);
+		}
+		const int32_t normalRunsBefore = normalRuns;
+		TaskScheduler::PumpMainThread(0.0f);
+		SUORA_CHECK_EQ(highRuns, highCount);
+		SUORA_CHECK_EQ(normalRuns, normalRunsBefore);
+
+		// The stat is the queue left by the last pump, not a sum over all frames
+		SUORA_CHECK_EQ(TaskScheduler::GetStats().MainThreadJobsDeferred, (uint32_t)(normalCount - normalRuns));
+		TaskScheduler::PumpMainThread(0.0f);
+		SUORA_CHECK_EQ(normalRuns, normalRunsBefore + 1);
+		SUORA_CHECK_EQ(TaskScheduler::GetStats().MainThreadJobsDeferred, (uint32_t)(normalCount - normalRuns));
+
+		TaskScheduler::PumpMainThread(1000.0f);
+		SUORA_CHECK_EQ(normalRuns, normalCount);
+		SUORA_CHECK_EQ(TaskScheduler::GetStats().MainThreadJobsDeferred, 0u);
+		SUORA_CHECK_EQ(TaskScheduler::GetStats().QueuedMainThreadJobs, 0u);
+	}
+
+	SUORA_TEST(TaskScheduler, ObserversChangeWhileTasksReport)
+	{
+		constexpr uint32_t taskCount = 20000;
+		std::atomic<uint32_t> observed = 0, toggledObserved = 0;
+		const uint64_t handle = TaskScheduler::AddObserver([&observed](const TaskEvent& event)
+		{
+			if (std::string_view(event.Name) == "Observed") observed++;
+		});
+
+		// Observers come and go on another thread, while the workers report against the published list
+		std::atomic<bool> done = false;
+		std::thread toggler([&]()
+		{
+			while (!done)
+			{
+				const uint64_t toggled = TaskScheduler::AddObserver([&toggledObserved](const TaskEvent&) { toggledObserved++; });
+				TaskScheduler::RemoveObserver(toggled);
+			}
+		});
+
+		std::vector<Task<void>> tasks;
+		tasks.reserve(taskCount);
+		for (uint32_t i = 0; i < taskCount; i++)
+		{
+			tasks.push_back(TaskScheduler::Run([]() {}, TaskPriority::Normal, "Observed"));
+		}
+		for (Task<void>& task : tasks) task.Wait();
+		done = true;
+		toggler.join();
+
+		// Tasks report before they complete, so every one of them was seen
+		SUORA_CHECK_EQ(observed.load(), taskCount);
+		TaskScheduler::RemoveObserver(handle);
+		const uint32_t observedBefore = observed;
+		TaskScheduler::Run([]() {}, TaskPriority::Normal, "Observed").Wait();
+		SUORA_CHECK_EQ(observed.load(), observedBefore);
+	}
+
+	SUORA_BENCHMARK(TaskScheduler, SubmitFromManyThreads)
+	{
+		constexpr uint32_t taskCount = 80000;
+		std::atomic<uint32_t> executed = 0;
+		SuoraLog("  {0} workers", TaskScheduler::GetWorkerCount());
+
+		// Every submitting thread waits for its own Tasks, the way a system waits for the work it scheduled
+		auto submit = [&executed](uint32_t count)
+		{
+			std::vector<Task<void>> tasks;
+			tasks.reserve(count);
+			for (uint32_t i = 0; i < count; i++)
+			{
+				tasks.push_back(TaskScheduler::Run([&executed]() { executed++; }));
+			}
+			for (Task<void>& task : tasks) task.Wait();
+		};
+
+		for (uint32_t threadCount : { 1u, 2u, 4u, 8u })
+		{
+			const double ms = Benchmark(std::to_string(threadCount) + " threads submit 80000 Tasks", 5, [&]()
+			{
+				std::vector<std::thread> threads;
+				for (uint32_t i = 0; i < threadCount; i++)
+				{
+					threads.emplace_back(submit, taskCount / threadCount);
+				}
+				for (std::thread& thread : threads) thread.join();
+			});
+			SuoraLog("  {0} Tasks per ms", (double)taskCount / ms);
+		}
+		SUORA_CHECK_EQ(executed.load(), taskCount * 6 * 4);
+	}
+
+}
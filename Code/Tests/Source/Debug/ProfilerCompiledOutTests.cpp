@@ -0,0 +1,43 @@
+#include "Test.h"
+// As in Dist builds, where Base.h leaves it undefined
+#undef SUORA_ENABLE_PROFILER
+#include "Suora/Debug/Profiler.h"
+
+namespace Suora::Tests
+{
+
+	static uint64_t CompiledOutWork(uint64_t value, uint32_t i)
+	{
+		SUORA_PROFILE_FUNCTION();
+		SUORA_PROFILE_SCOPE("ProfilerCompiledOutTests::Inner");
+		SUORA_PROFILE_COUNTER_ADD("ProfilerCompiledOutTests::Calls", 1);
+		return value * 6364136223846793005ull + i;
+	}
+
+	static uint64_t PlainWork(uint64_t value, uint32_t i)
+	{
+		return value * 6364136223846793005ull + i;
+	}
+
+	SUORA_BENCHMARK(Profiler, ZoneMacrosCompiledOut)
+	{
+		constexpr uint32_t zoneCount = 100000;
+		uint64_t compiledOut = 1, plain = 1;
+		Profiler::SetEnabled(true);
+		const uint64_t written = Profiler::GetThreadBuffer().WriteIndex.load();
+
+		// Both loops should take the same time, the macros leave nothing behind
+		Benchmark("100000 zones, compiled out", 20, [&]()
+		{
+			for (uint32_t i = 0; i < zoneCount; i++) compiledOut = CompiledOutWork(compiledOut, i);
+		});
+		Benchmark("100000 calls, without zones", 20, [&]()
+		{
+			for (uint32_t i = 0; i < zoneCount; i++) plain = PlainWork(plain, i);
+		});
+
+		SUORA_CHECK_EQ(compiledOut, plain);
+		SUORA_CHECK_EQ(Profiler::GetThreadBuffer().WriteIndex.load(), written);
+	}
+
+}
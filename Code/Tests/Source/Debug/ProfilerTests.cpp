@@ -0,0 +1,128 @@
+#include "Test.h"
+#include <thread>
+#include "Suora/Debug/Profiler.h"
+
+namespace Suora::Tests
+{
+
+	static const char* OuterZone = "ProfilerTests::Outer";
+	static const char* InnerZone = "ProfilerTests::Inner";
+	static const char* ExitedZone = "ProfilerTests::Exited";
+
+	static uint32_t CountZones(const ProfilerFrame& frame, const char* name)
+	{
+		uint32_t count = 0;
+		for (const ProfileZone& zone : frame.Zones)
+		{
+			if (zone.Name == name) count++;
+		}
+		return count;
+	}
+
+	/** Some work for the zones, that the compiler cannot throw away */
+	static uint64_t ProfiledWork(uint64_t value, uint32_t i)
+	{
+		SUORA_PROFILE_SCOPE(InnerZone);
+		return value * 6364136223846793005ull + i;
+	}
+
+	SUORA_TEST(Profiler, CollectsZonesWhileThreadsRecord)
+	{
+		constexpr uint32_t threadCount = 4, zonesPerThread = 100000;
+		Profiler::SetEnabled(true);
+		Profiler::SetPaused(false);
+		Profiler::EndFrame();
+		const uint64_t droppedBefore = Profiler::GetStats().DroppedZones;
+
+		// More zones than a ProfilerThreadBuffer holds, so the threads overwrite events while EndFrame() reads them
+		std::atomic<uint32_t> running = threadCount;
+		std::vector<std::thread> threads;
+		for (uint32_t t = 0; t < threadCount; t++)
+		{
+			threads.emplace_back([&running]()
+			{
+				uint64_t value = 1;
+				for (uint32_t i = 0; i < zonesPerThread / 2; i++)
+				{
+					SUORA_PROFILE_SCOPE(OuterZone);
+					value = ProfiledWork(value, i);
+				}
+				running--;
+				return value;
+			});
+		}
+
+		uint32_t collected = 0, wrong = 0;
+		auto collect = [&]()
+		{
+			Profiler::EndFrame();
+			const ProfilerFrame& frame = Profiler::GetFrames().back();
+			collected += CountZones(frame, OuterZone) + CountZones(frame, InnerZone);
+			for (const ProfileZone& zone : frame.Zones)
+			{
+				// A torn event would mix the fields of two zones
+				if (!zone.Name || zone.EndNs < zone.BeginNs) wrong++;
+			}
+		};
+		while (running > 0) collect();
+		for (std::thread& thread : threads) thread.join();
+		collect();
+
+		SUORA_CHECK_EQ(wrong, 0u);
+		SUORA_CHECK(collected > 0);
+		SUORA_CHECK_EQ(collected + (Profiler::GetStats().DroppedZones - droppedBefore), (uint64_t)threadCount * zonesPerThread);
+	}
+
+	SUORA_TEST(Profiler, ExitedThreadsHandTheirBuffersOn)
+	{
+		Profiler::SetEnabled(true);
+		Profiler::SetPaused(false);
+		auto recordOnThread = []()
+		{
+			std::thread([]()
+			{
+				SUORA_PROFILE_THREAD("ProfilerTests::ShortLived");
+				SUORA_PROFILE_SCOPE(ExitedZone);
+			}).join();
+		};
+		recordOnThread();
+		const size_t threadCount = Profiler::GetThreads().size();
+
+		for (int32_t i = 0; i < 20; i++)
+		{
+			recordOnThread();
+		}
+		SUORA_CHECK_EQ(Profiler::GetThreads().size(), threadCount);
+		for (const ProfilerThreadInfo& thread : Profiler::GetThreads())
+		{
+			SUORA_CHECK(thread.Name != "ProfilerTests::ShortLived");
+		}
+
+		// The zones of the exited threads are collected all the same
+		Profiler::EndFrame();
+		SUORA_CHECK_EQ(CountZones(Profiler::GetFrames().back(), ExitedZone), 21u);
+	}
+
+	SUORA_BENCHMARK(Profiler, ZoneMacros)
+	{
+		constexpr uint32_t zoneCount = 100000;
+		uint64_t value = 1;
+		SuoraLog("  Calibrated: {0} ns per zone, {1} ns while disabled", Profiler::GetStats().ZoneCostNs, Profiler::GetStats().DisabledZoneCostNs);
+
+		Profiler::SetEnabled(true);
+		Benchmark("100000 zones, enabled", 20, [&]()
+		{
+			for (uint32_t i = 0; i < zoneCount; i++) value = ProfiledWork(value, i);
+			Profiler::EndFrame();
+		});
+		Profiler::SetEnabled(false);
+		Benchmark("100000 zones, disabled at runtime", 20, [&]()
+		{
+			for (uint32_t i = 0; i < zoneCount; i++) value = ProfiledWork(value, i);
+			Profiler::EndFrame();
+		});
+		Profiler::SetEnabled(true);
+		SuoraLog("  {0}", value);
+	}
+
+}
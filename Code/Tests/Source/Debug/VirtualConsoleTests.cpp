@@ -0,0 +1,201 @@
+#include "Test.h"
+#include <deque>
+#include <thread>
+#include "Suora/Core/Log.h"
+#include "Suora/Debug/VirtualConsole.h"
+
+namespace Suora::Tests
+{
+
+	/** Drains whatever the Log pushed so far, so only the messages of the test are in the console */
+	static void ResetConsole()
+	{
+		VirtualConsole::Tick();
+		VirtualConsole::Clear();
+	}
+
+	static void Push(const String& text, LogLevel level = LogLevel::Info, LogCategory category = LogCategory::Gameplay)
+	{
+		VirtualConsole::PushMessage(ConsoleMessage(text, category, level));
+	}
+
+	static bool ViewEquals(const ConsoleMessageView& view, const std::deque<String>& expected)
+	{
+		if (view.Size() != expected.size()) return false;
+		for (size_t i = 0; i < expected.size(); i++)
+		{
+			if (view[i].m_Message != expected[i]) return false;
+		}
+		return true;
+	}
+
+	SUORA_TEST(VirtualConsole, IndexRingsWrapAround)
+	{
+		ResetConsole();
+		const uint64_t overwrittenBefore = VirtualConsole::GetStats().OverwrittenMessages;
+
+		// Every third message is a warning, so the index rings of Info and Warn advance at different speeds
+		// and wrap around at different points in time than the message ring itself
+		std::deque<String> all, infos, warnings, rendering;
+		constexpr uint32_t total = 5 * VirtualConsole::s_Capacity + 37;
+		for (uint32_t i = 0; i < total; i++)
+		{
+			const String text = "Message " + std::to_string(i);
+			const bool isWarning = i % 3 == 0;
+			const bool isRendering = i % 7 == 0;
+			Push(text, isWarning ? LogLevel::Warn : LogLevel::Info, isRendering ? LogCategory::Rendering : LogCategory::Gameplay);
+
+			all.push_back(text);
+			(isWarning ? warnings : infos).push_back(text);
+			if (isRendering) rendering.push_back(text);
+			if (all.size() > VirtualConsole::s_Capacity)
+			{
+				// The evicted message is the oldest one of its indices as well
+				const String& evicted = all.front();
+				if (!infos.empty() && infos.front() == evicted) infos.pop_front();
+				if (!warnings.empty() && warnings.front() == evicted) warnings.pop_front();
+				if (!rendering.empty() && rendering.front() == evicted) rendering.pop_front();
+				all.pop_front();
+			}
+
+			if (i % 97 == 0 || i + 1 == total)
+			{
+				VirtualConsole::Tick();
+				SUORA_REQUIRE(ViewEquals(VirtualConsole::GetMessages(), all));
+				SUORA_REQUIRE(ViewEquals(VirtualConsole::GetLogMessages(), infos));
+				SUORA_REQUIRE(ViewEquals(VirtualConsole::GetWarnMessages(), warnings));
+				SUORA_REQUIRE(ViewEquals(VirtualConsole::GetMessagesWithCategory(LogCategory::Rendering), rendering));
+			}
+		}
+
+		SUORA_CHECK_EQ(VirtualConsole::GetMessages().Size(), (size_t)VirtualConsole::s_Capacity);
+		SUORA_CHECK(VirtualConsole::GetErrorMessages().IsEmpty());
+		SUORA_CHECK_EQ(VirtualConsole::GetStats().OverwrittenMessages - overwrittenBefore, (uint64_t)(total - VirtualConsole::s_Capacity));
+		VirtualConsole::Clear();
+	}
+
+	SUORA_TEST(VirtualConsole, DuplicatesCollapseIgnoringTheTimestamp)
+	{
+		ResetConsole();
+		const uint64_t collapsedBefore = VirtualConsole::GetStats().CollapsedMessages;
+
+		Push("[12:00:01] Asset not found");
+		Push("[12:00:01] Asset not found");
+		Push("[12:00:02] Asset not found");
+		// Same text, but a different level or category is a different message
+		Push("[12:00:02] Asset not found", LogLevel::Warn);
+		Push("[12:00:02] Asset not found", LogLevel::Warn, LogCategory::Rendering);
+		Push("[12:00:03] Something else");
+		Push("[12:00:04] Asset not found");
+		VirtualConsole::Tick();
+
+		const ConsoleMessageView messages = VirtualConsole::GetMessages();
+		SUORA_REQUIRE(messages.Size() == 5);
+		SUORA_CHECK_EQ(messages[0].m_Count, 3u);
+		// The collapsed entry shows the latest timestamp
+		SUORA_CHECK_EQ(messages[0].m_Message, String("[12:00:02] Asset not found"));
+		SUORA_CHECK_EQ(messages[1].m_Count, 1u);
+		SUORA_CHECK_EQ(messages[2].m_Count, 1u);
+		SUORA_CHECK_EQ(messages[4].m_Count, 1u);
+		SUORA_CHECK_EQ(VirtualConsole::GetStats().CollapsedMessages - collapsedBefore, 2u);
+
+		// Collapsing does not add index entries
+		SUORA_CHECK_EQ(VirtualConsole::GetLogMessages().Size(), 3u);
+		SUORA_CHECK_EQ(VirtualConsole::GetWarnMessages().Size(), 2u);
+		SUORA_CHECK_EQ(VirtualConsole::GetLogMessages()[0].m_Count, 3u);
+
+		// Collapsing across two Ticks
+		Push("[12:00:05] Asset not found");
+		VirtualConsole::Tick();
+		SUORA_CHECK_EQ(VirtualConsole::GetMessages().Size(), 5u);
+		SUORA_CHECK_EQ(VirtualConsole::GetMessages()[4].m_Count, 2u);
+
+		VirtualConsole::s_CollapseDuplicates = false;
+		Push("[12:00:06] Asset not found");
+		VirtualConsole::Tick();
+		VirtualConsole::s_CollapseDuplicates = true;
+		SUORA_CHECK_EQ(VirtualConsole::GetMessages().Size(), 6u);
+		SUORA_CHECK_EQ(VirtualConsole::GetMessages()[5].m_Count, 1u);
+		VirtualConsole::Clear();
+	}
+
+	SUORA_TEST(VirtualConsole, ClearEmptiesTheRingAndAllIndices)
+	{
+		ResetConsole();
+		for (uint32_t i = 0; i < VirtualConsole::s_Capacity + 100; i++)
+		{
+			Push("Before " + std::to_string(i), i % 2 ? LogLevel::Error : LogLevel::Debug, LogCategory::Networking);
+		}
+		VirtualConsole::Tick();
+		VirtualConsole::Clear();
+
+		SUORA_CHECK(VirtualConsole::GetMessages().IsEmpty());
+		SUORA_CHECK(VirtualConsole::GetErrorMessages().IsEmpty());
+		SUORA_CHECK(VirtualConsole::GetDebugMessages().IsEmpty());
+		SUORA_CHECK(VirtualConsole::GetMessagesWithCategory(LogCategory::Networking).IsEmpty());
+
+		// The rings start over, nothing of the cleared messages shows up again
+		Push("After 0", LogLevel::Error, LogCategory::Networking);
+		Push("After 1", LogLevel::Debug, LogCategory::Networking);
+		VirtualConsole::Tick();
+		SUORA_CHECK(ViewEquals(VirtualConsole::GetMessages(), { "After 0", "After 1" }));
+		SUORA_CHECK(ViewEquals(VirtualConsole::GetErrorMessages(), { "After 0" }));
+		SUORA_CHECK(ViewEquals(VirtualConsole::GetDebugMessages(), { "After 1" }));
+		SUORA_CHECK(ViewEquals(VirtualConsole::GetMessagesWithCategory(LogCategory::Networking), { "After 0", "After 1" }));
+		VirtualConsole::Clear();
+	}
+
+	SUORA_TEST(VirtualConsole, PushesFromManyThreadsKeepTheirOrder)
+	{
+		ResetConsole();
+		constexpr uint32_t threadCount = 4, perThread = 200;
+		std::vector<std::thread> threads;
+		for (uint32_t t = 0; t < threadCount; t++)
+		{
+			threads.emplace_back([t]()
+			{
+				for (uint32_t i = 0; i < perThread; i++)
+				{
+					Push(std::to_string(t) + " " + std::to_string(i));
+				}
+			});
+		}
+		for (std::thread& thread : threads) thread.join();
+		VirtualConsole::Tick();
+
+		const ConsoleMessageView messages = VirtualConsole::GetMessages();
+		SUORA_REQUIRE(messages.Size() == threadCount * perThread);
+		uint32_t next[threadCount] = {};
+		for (size_t i = 0; i < messages.Size(); i++)
+		{
+			uint32_t thread = 0, index = 0;
+			SUORA_REQUIRE(sscanf(messages[i].m_Message.c_str(), "%u %u", &thread, &index) == 2 && thread < threadCount);
+			SUORA_CHECK_EQ(index, next[thread]);
+			next[thread] = index + 1;
+		}
+		VirtualConsole::Clear();
+	}
+
+	SUORA_TEST(VirtualConsole, FullPendingQueueDropsMessages)
+	{
+		ResetConsole();
+		const uint64_t droppedBefore = VirtualConsole::GetStats().DroppedMessages;
+
+		// Nobody ticks the console, the slots of the pending queue run out
+		for (uint32_t i = 0; i < VirtualConsole::s_MaxPendingMessages + 10; i++)
+		{
+			Push("Pending " + std::to_string(i));
+		}
+		VirtualConsole::Tick();
+		SUORA_CHECK_EQ(VirtualConsole::GetStats().DroppedMessages - droppedBefore, 10u);
+		SUORA_CHECK_EQ(VirtualConsole::GetMessages()[VirtualConsole::s_Capacity - 1].m_Message, "Pending " + std::to_string(VirtualConsole::s_MaxPendingMessages - 1));
+
+		// The freed slots take messages again
+		Push("Afterwards");
+		VirtualConsole::Tick();
+		SUORA_CHECK_EQ(VirtualConsole::GetStats().DroppedMessages - droppedBefore, 10u);
+		SUORA_CHECK_EQ(VirtualConsole::GetMessages()[VirtualConsole::s_Capacity - 1].m_Message, String("Afterwards"));
+		VirtualConsole::Clear();
+	}
+
+}
@@ -0,0 +1,313 @@
+#include "Test.h"
+#include "Suora/Editor/Panels/MajorTab.h"
+#include "Suora/Editor/Util/NodeTransaction.h"
+#include "Suora/GameFramework/World.h"
+#include "Suora/GameFramework/Node.h"
+#include "Suora/GameFramework/Nodes/Light/PointLightNode.h"
+#include "Suora/Reflection/ClassReflector.h"
+#include "Suora/Reflection/Property.h"
+#include "Suora/Serialization/Yaml.h"
+
+namespace Suora::Tests
+{
+
+	/** What the editor saves of the Level; every edit of the tests happens below it */
+	static String SerializeLevel(Node* level)
+	{
+		Yaml::Node root;
+		level->Serialize(root);
+		String text;
+		Yaml::Serialize(root, text);
+		return text;
+	}
+
+	static void CollectNodes(Node* node, Array<Node3D*>& outNodes)
+	{
+		outNodes.Add(node->As<Node3D>());
+		for (int32_t i = 0; i < node->GetChildCount(); i++)
+		{
+			CollectNodes(node->GetChild(i), outNodes);
+		}
+	}
+
+	/** A headless Level and a MajorTab, that records random edits the way the editor panels do */
+	struct UndoTestScene
+	{
+		World SceneWorld;
+		MajorTab Tab;
+		Node3D* Level = nullptr;
+		TestRandom Random;
+		uint32_t NextName = 0;
+
+		explicit UndoTestScene(uint32_t seed)
+			: Random(seed)
+		{
+			Level = SceneWorld.Spawn<Node3D>();
+			Level->SetName("Level");
+			for (int32_t i = 0; i < 12; i++)
+			{
+				AddNode(GetRandomNode(true), i % 3 != 0);
+			}
+			Step();
+		}
+
+		/* One editor frame. Afterwards, every world Transform is derived from the local ones: setting a local Transform
+		 * derives the local matrix back from the world matrix, and the rounding of that would otherwise decide,
+		 * whether reprojecting a child after an Undo gives the same bits as before.                                  */
+		void Step()
+		{
+			SceneWorld.Update(1.0f / 60.0f);
+			Level->SetTransformMatrix(Level->GetTransformMatrix());
+		}
+
+		Array<Node3D*> GetNodes() const
+		{
+			Array<Node3D*> nodes;
+			CollectNodes(Level, nodes);
+			return nodes;
+		}
+
+		Node3D* GetRandomNode(bool includeLevel)
+		{
+			const Array<Node3D*> nodes = GetNodes();
+			if (!includeLevel && nodes.Size() < 2) return nullptr;
+			return nodes[Random.Int(includeLevel ? 0 : 1, nodes.Size() - 1)];
+		}
+
+		Vec3 GetRandomVec3(float min, float max)
+		{
+			return Vec3(Random.Float(min, max), Random.Float(min, max), Random.Float(min, max));
+		}
+
+		Node3D* AddNode(Node3D* parent, bool isLight)
+		{
+			Node3D* node = isLight ? (Node3D*)parent->CreateChild<PointLightNode>() : parent->CreateChild<Node3D>();
+			node->SetName("Node" + std::to_string(NextName++));
+			node->m_IsActorLayer = true;
+			node->SetLocalPosition(GetRandomVec3(-4.0f, 4.0f));
+			node->SetLocalRotation(Quat(GetRandomVec3(-3.0f, 3.0f)));
+			return node;
+		}
+
+		/** Same as NodeDetails */
+		bool ChangeProperty()
+		{
+			Array<Node3D*> lights;
+			for (Node3D* node : GetNodes())
+			{
+				if (node->IsA<PointLightNode>()) lights.Add(node);
+			}
+			if (lights.Size() == 0) return false;
+
+			Node3D* node = lights[Random.Int(0, lights.Size() - 1)];
+			const Array<Ref<ClassMemberProperty>> members = ClassReflector::GetByClass(node->GetNativeClass()).GetAllClassMemberProperties();
+			const uint32_t memberIndex = (uint32_t)Random.Int(0, members.Size() - 1);
+			const ClassMemberProperty& member = *members[memberIndex];
+
+			const bool wasOverwritten = node->m_OverwrittenProperties.Contains(member.m_MemberName);
+			const NodePropertyValue before = NodePropertyValue::Read(node, member);
+			switch (member.m_Property->GetType())
+			{
+			case PropertyType::Int32:	*ClassMemberProperty::AccessMember<int32_t>(node, member.m_MemberOffset) = Random.Int(-100, 100); break;
+			case PropertyType::Float:	*ClassMemberProperty::AccessMember<float>(node, member.m_MemberOffset) = Random.Float(0.0f, 4.0f); break;
+			case PropertyType::Bool:	*ClassMemberProperty::AccessMember<bool>(node, member.m_MemberOffset) ^= true; break;
+			case PropertyType::Vec3:	*ClassMemberProperty::AccessMember<Vec3>(node, member.m_MemberOffset) = GetRandomVec3(0.0f, 4.0f); break;
+			case PropertyType::Vec4:	*ClassMemberProperty::AccessMember<Vec4>(node, member.m_MemberOffset) = Vec4(GetRandomVec3(0.0f, 1.0f), 1.0f); break;
+			default: return false;
+			}
+			if (!wasOverwritten)
+			{
+				node->m_OverwrittenProperties.Add(member.m_MemberName);
+			}
+			node->MarkPropertyDirty(memberIndex);
+			Tab.MakeEditorChange(CreateRef<NodePropertyChange>(node, member, memberIndex, before, wasOverwritten));
+			return true;
+		}
+
+		/** Same as the transform gizmo of the ViewportPanel */
+		bool ChangeTransform()
+		{
+			Node3D* node = GetRandomNode(false);
+			if (!node) return false;
+
+			const NodeTransformState before = NodeTransformState::Capture(node);
+			node->SetLocalPosition(GetRandomVec3(-4.0f, 4.0f));
+			if (Random.Int(0, 1)) node->SetLocalRotation(Quat(GetRandomVec3(-3.0f, 3.0f)));
+			if (Random.Int(0, 3) == 0) node->SetLocalScale(GetRandomVec3(0.5f, 2.0f));
+			Tab.MakeEditorChange(CreateRef<NodeTransformChange>(node, before));
+			return true;
+		}
+
+		/** Same as dragging a Node in the LevelOutliner */
+		bool Reparent()
+		{
+			Node3D* node = GetRandomNode(false);
+			Node3D* parent = GetRandomNode(true);
+			if (!node || parent == node || parent->IsChildOf(node)) return false;
+
+			Tab.MakeEditorChange(NodeReparentChange::Reparent(node, parent));
+			return true;
+		}
+
+		bool Spawn()
+		{
+			Node3D* node = AddNode(GetRandomNode(true), Random.Int(0, 1));
+			Tab.MakeEditorChange(NodeLifetimeChange::Spawn(node));
+			return true;
+		}
+
+		bool Destroy()
+		{
+			Node3D* node = GetRandomNode(false);
+			// Keeps the Level from running empty
+			if (!node || GetNodes().Size() < 8) return false;
+
+			Tab.MakeEditorChange(NodeLifetimeChange::Destroy(node));
+			return true;
+		}
+
+		void RandomEdit()
+		{
+			bool edited = false;
+			while (!edited)
+			{
+				switch (Random.Int(0, 5))
+				{
+				case 0:
+				case 1: edited = ChangeProperty(); break;
+				case 2: edited = ChangeTransform(); break;
+				case 3: edited = Reparent(); break;
+				case 4: edited = Spawn(); break;
+				case 5: edited = Destroy(); break;
+				}
+			}
+			Step();
+		}
+
+		size_t SumUndoMemory() const
+		{
+			size_t sum = 0;
+			for (const Ref<EditorTransaction>& change : Tab.UndoStack)
+			{
+				sum += change->GetMemorySize();
+			}
+			return sum;
+		}
+	};
+
+	SUORA_TEST(UndoStack, UndoingEverythingRestoresTheLevel)
+	{
+		for (uint32_t seed : { 47u, 470u, 4700u })
+		{
+			UndoTestScene scene(seed);
+			const String initial = SerializeLevel(scene.Level);
+
+			for (int32_t i = 0; i < 300; i++)
+			{
+				scene.RandomEdit();
+			}
+			const String edited = SerializeLevel(scene.Level);
+			SUORA_CHECK(edited != initial);
+			SUORA_CHECK(scene.Tab.UndoStack.Size() > 100);
+			SUORA_CHECK_EQ(scene.Tab.GetUndoMemoryUsage(), scene.SumUndoMemory());
+
+			while (scene.Tab.UndoStackIndex >= 0)
+			{
+				scene.Tab.Undo();
+				scene.Step();
+			}
+			// Byte for byte, including Transforms, property values, sibling order and the overwritten properties
+			SUORA_CHECK(SerializeLevel(scene.Level) == initial);
+
+			while (scene.Tab.UndoStackIndex + 1 < scene.Tab.UndoStack.Size())
+			{
+				scene.Tab.Redo();
+				scene.Step();
+			}
+			SUORA_CHECK(SerializeLevel(scene.Level) == edited);
+			SUORA_CHECK_EQ(scene.Tab.GetUndoMemoryUsage(), scene.SumUndoMemory());
+		}
+	}
+
+	/** Sets an int, so the tests can follow what Undo and Redo do after compaction */
+	struct IntTestChange : public EditorTransaction
+	{
+		IntTestChange(int32_t& value, int32_t after, uint64_t coalesceKey, size_t memorySize)
+			: m_Value(value), m_Before(value), m_After(after), m_MemorySize(memorySize)
+		{
+			m_CoalesceKey = coalesceKey;
+			value = after;
+		}
+
+		void Undo() override { m_Value = m_Before; }
+		void Redo() override { m_Value = m_After; }
+		size_t GetMemorySize() const override { return m_MemorySize; }
+		bool Merge(const EditorTransaction& next) override
+		{
+			m_After = static_cast<const IntTestChange&>(next).m_After;
+			return true;
+		}
+
+		int32_t& m_Value;
+		int32_t m_Before = 0, m_After = 0;
+		size_t m_MemorySize = 0;
+	};
+
+	SUORA_TEST(UndoStack, MemoryBudgetCompactsAndDropsOldestEntries)
+	{
+		MajorTab tab;
+		tab.UndoMemoryBudget = 10000;
+		int32_t value = 0;
+		auto push = [&](int32_t after, uint64_t coalesceKey)
+		{
+			tab.MakeEditorChange(CreateRef<IntTestChange>(value, after, coalesceKey, 1000));
+		};
+		auto undoAndRedo = [&]()
+		{
+			// Starts a new interaction, so the next change is not coalesced on its own
+			tab.Undo();
+			tab.Redo();
+		};
+
+		for (int32_t i = 1; i <= 4; i++) push(i, 0);
+		for (int32_t i = 5; i <= 7; i++)
+		{
+			undoAndRedo();
+			push(i, 7);
+		}
+		SUORA_CHECK_EQ(tab.UndoStack.Size(), 7);
+
+		// Redo history is discarded by the next change, and does not count towards the budget
+		push(8, 0);
+		push(9, 0);
+		tab.Undo();
+		tab.Undo();
+		SUORA_CHECK_EQ(tab.GetUndoMemoryUsage(), (size_t)9000);
+
+		// Over budget, the four neighbouring entries with key 7 become one
+		tab.UndoMemoryBudget = 6500;
+		push(10, 7);
+		SUORA_CHECK_EQ(tab.UndoStack.Size(), 5);
+		SUORA_CHECK_EQ(tab.UndoStackIndex, 4);
+		SUORA_CHECK_EQ(tab.GetUndoMemoryUsage(), (size_t)5000);
+		tab.Undo();
+		SUORA_CHECK_EQ(value, 4);
+		tab.Redo();
+		SUORA_CHECK_EQ(value, 10);
+
+		// Nothing left to compact, the oldest entries go
+		tab.UndoMemoryBudget = 2500;
+		push(11, 0);
+		SUORA_CHECK_EQ(tab.UndoStack.Size(), 2);
+		SUORA_CHECK_EQ(tab.UndoStackIndex, 1);
+		SUORA_CHECK_EQ(tab.GetUndoMemoryUsage(), (size_t)2000);
+
+		while (tab.UndoStackIndex >= 0) tab.Undo();
+		SUORA_CHECK_EQ(value, 4);
+		tab.Undo();
+		SUORA_CHECK_EQ(tab.UndoStackIndex, -1);
+		while (tab.UndoStackIndex + 1 < tab.UndoStack.Size()) tab.Redo();
+		SUORA_CHECK_EQ(value, 11);
+	}
+
+}
@@ -0,0 +1,53 @@
+#pragma once
+#include "Suora/GameFramework/Node.h"
+#include "Suora/GameFramework/World.h"
+#include "Suora/Common/Delegate.h"
+#include "Suora/Assets/Material.h"
+#include "Suora/Reflection/SubclassOf.h"
+#include "CloneTestNodes.generated.h"
+
+namespace Suora
+{
+
+	/** One reflected member per PropertyType, that Node::Clone() copies. Every type but Array. */
+	class CloneTestNode : public Node3D
+	{
+		SUORA_CLASS(2748306195);
+	public:
+		PROPERTY() char m_Char = 0;
+		PROPERTY() int8_t m_Int8 = 0;
+		PROPERTY() int16_t m_Int16 = 0;
+		PROPERTY() int32_t m_Int32 = 0;
+		PROPERTY() int64_t m_Int64 = 0;
+		PROPERTY() uint8_t m_UInt8 = 0;
+		PROPERTY() uint16_t m_UInt16 = 0;
+		PROPERTY() uint32_t m_UInt32 = 0;
+		PROPERTY() uint64_t m_UInt64 = 0;
+		PROPERTY() bool m_Bool = false;
+		PROPERTY() float m_Float = 0.0f;
+		PROPERTY() double m_Double = 0.0;
+		PROPERTY() Vec2 m_Vec2 = Vec2(0.0f);
+		PROPERTY() Vec3 m_Vec3 = Vec3(0.0f);
+		PROPERTY() Vec4 m_Vec4 = Vec4(0.0f);
+		PROPERTY() Quat m_Quat = Quat();
+		PROPERTY() String m_String;
+		PROPERTY() MaterialSlots m_MaterialSlots;
+		PROPERTY() SuoraID m_SuoraID;
+		PROPERTY() Class m_Class = Class::None;
+		PROPERTY() SubclassOf<Node> m_SubclassOf;
+		PROPERTY() Material* m_Material = nullptr;
+		PROPERTY() Node* m_Inside = nullptr;
+		PROPERTY() Node* m_Outside = nullptr;
+		PROPERTY() Delegate<Node*> m_OnEvent;
+
+		/** Same as Node::FinishDuplicate(), for copies of the old YAML round trip */
+		void AddToWorld(World& world, Node* parent)
+		{
+			InitializeNode(world);
+			SetParent(parent);
+			TickTransform();
+			m_IsActorLayer = true;
+		}
+	};
+
+}
@@ -0,0 +1,354 @@
+#include "Test.h"
+#include "CloneTestNodes.h"
+#include "Suora/GameFramework/World.h"
+#include "Suora/GameFramework/Node.h"
+#include "Suora/Reflection/ClassReflector.h"
+#include "Suora/Reflection/Property.h"
+#include "Suora/Serialization/Yaml.h"
+
+namespace Suora::Tests
+{
+
+	static String SerializeToText(Node* node)
+	{
+		Yaml::Node root;
+		node->Serialize(root);
+		String text;
+		Yaml::Serialize(root, text);
+		return text;
+	}
+
+	/** What Node::Duplicate() did before Node::Clone() */
+	static Node* DuplicateByYaml(Node* node)
+	{
+		Yaml::Node serialized;
+		node->Serialize(serialized);
+		serialized["RootParentClass"] = node->GetClass().ToString();
+		return Node::Deserialize(serialized, true);
+	}
+
+	static void CollectNodes(Node* node, Array<Node*>& outNodes)
+	{
+		outNodes.Add(node);
+		for (int32_t i = 0; i < node->GetChildCount(); i++)
+		{
+			CollectNodes(node->GetChild(i), outNodes);
+		}
+	}
+
+	static Node* Remap(Node* node, const Array<Node*>& sources, const Array<Node*>& copies)
+	{
+		for (int32_t i = 0; i < sources.Size(); i++)
+		{
+			if (sources[i] == node) return copies[i];
+		}
+		return node;
+	}
+
+	/** The script bindings of m_OnEvent, where the reflection of CloneTestNode and Node::Clone() find them */
+	static TDelegate& GetBindings(CloneTestNode* node)
+	{
+		return *ClassMemberProperty::AccessMember<TDelegate>(node, offsetof(CloneTestNode, m_OnEvent));
+	}
+
+	/** Multiples of 0.25 survive the 6 decimals of the YAML floats and every Transform multiplication exactly */
+	static float Quarter(TestRandom& random)
+	{
+		return random.Int(-64, 64) * 0.25f;
+	}
+
+	/** A random subtree below a CloneTestNode, one Node outside of it and a Material, that is not registered as an Asset */
+	struct CloneTestScene
+	{
+		World SceneWorld;
+		Material SharedMaterial;
+		Node3D* Outside = nullptr;
+		CloneTestNode* Root = nullptr;
+		Array<Node*> Nodes;
+		TestRandom Random;
+		uint32_t NextName = 0;
+
+		explicit CloneTestScene(uint32_t seed)
+			: Random(seed)
+		{
+			Outside = SceneWorld.Spawn<Node3D>();
+			Outside->SetName("Outside");
+			Root = SceneWorld.Spawn<CloneTestNode>();
+			SetupNode(Root);
+			AddChildren(Root, 0);
+			CollectNodes(Root, Nodes);
+
+			for (Node* node : Nodes)
+			{
+				if (CloneTestNode* testNode = node->As<CloneTestNode>()) RandomizeProperties(testNode);
+			}
+		}
+
+		void SetupNode(Node* node)
+		{
+			node->SetName("Node" + std::to_string(NextName++));
+			node->m_IsActorLayer = true;
+			if (Node3D* node3D = node->As<Node3D>())
+			{
+				node3D->SetLocalPosition(Vec3(Quarter(Random), Quarter(Random), Quarter(Random)));
+				node3D->SetLocalScale(Vec3(Random.Int(0, 1) ? 0.5f : 2.0f));
+			}
+		}
+
+		void AddChildren(Node* parent, int32_t depth)
+		{
+			const int32_t childCount = depth < 3 ? Random.Int(depth == 0 ? 2 : 0, 3) : 0;
+			for (int32_t i = 0; i < childCount; i++)
+			{
+				Node* child = nullptr;
+				switch (Random.Int(0, 2))
+				{
+				case 0: child = parent->CreateChild<CloneTestNode>(); break;
+				case 1: child = parent->CreateChild<Node3D>(); break;
+				case 2: child = parent->CreateChild(Node::StaticClass()); break;
+				}
+				SetupNode(child);
+				if (child->IsA<Node3D>()) AddChildren(child, depth + 1);
+				else if (Random.Int(0, 1)) child->SetEnabled(false);
+			}
+		}
+
+		void RandomizeProperties(CloneTestNode* node)
+		{
+			// Every property the NodeSerialization can write may be overwritten, the others are only changed at runtime
+			for (const char* name : { "m_Int32", "m_Bool", "m_Float", "m_Vec3", "m_Vec4", "m_MaterialSlots", "m_Material", "m_Class", "m_SubclassOf", "m_OnEvent" })
+			{
+				if (Random.Int(0, 1)) node->m_OverwrittenProperties.Add(name);
+			}
+			// The YAML round trip cannot look up the Material, so only runtime values reference it
+			auto getMaterial = [&](const char* name) { return node->m_OverwrittenProperties.Contains(name) ? nullptr : &SharedMaterial; };
+
+			node->m_Char = (char)Random.Int('a', 'z');
+			node->m_Int8 = (int8_t)Random.Int(-128, 127);
+			node->m_Int16 = (int16_t)Random.Int(-32768, 32767);
+			node->m_Int32 = Random.Int(-1000000, 1000000);
+			node->m_Int64 = (int64_t)Random.Int(-1000000, 1000000) << 24;
+			node->m_UInt8 = (uint8_t)Random.Int(1, 255);
+			node->m_UInt16 = (uint16_t)Random.Int(1, 65535);
+			node->m_UInt32 = (uint32_t)Random.Int(1, 1000000) << 8;
+			node->m_UInt64 = (uint64_t)Random.Int(1, 1000000) << 40;
+			node->m_Bool = Random.Int(0, 1) == 1;
+			node->m_Float = Quarter(Random);
+			node->m_Double = Quarter(Random) / 3.0;
+			node->m_Vec2 = Vec2(Quarter(Random), Quarter(Random));
+			node->m_Vec3 = Vec3(Quarter(Random), Quarter(Random), Quarter(Random));
+			node->m_Vec4 = Vec4(Quarter(Random), Quarter(Random), Quarter(Random), Quarter(Random));
+			node->m_Quat = glm::normalize(Quat(Random.Float(-1.0f, 1.0f), Random.Float(-1.0f, 1.0f), Random.Float(-1.0f, 1.0f), 1.0f));
+			node->m_String = "String" + std::to_string(Random.Int(0, 1000));
+			node->m_MaterialSlots.OverwritteMaterials = true;
+			node->m_MaterialSlots.Materials = Array<Material*>({ getMaterial("m_MaterialSlots"), nullptr });
+			node->m_SuoraID = SuoraID::Generate();
+			node->m_Class = Random.Int(0, 1) ? Node3D::StaticClass() : CloneTestNode::StaticClass();
+			node->m_SubclassOf.SetClass(Random.Int(0, 1) ? Node3D::StaticClass() : CloneTestNode::StaticClass());
+			node->m_Material = getMaterial("m_Material");
+
+			// Into the subtree, which includes the Node itself, and out of it
+			node->m_Inside = Nodes[Random.Int(0, Nodes.Size() - 1)];
+			node->m_Outside = Outside;
+
+			TDelegate& bindings = GetBindings(node);
+			bindings.Bindings.Add(TDelegate::SciptDelegateBinding(Nodes[Random.Int(0, Nodes.Size() - 1)], (size_t)Random.Int(1, 1000)));
+			bindings.Bindings.Add(TDelegate::SciptDelegateBinding(Outside, (size_t)Random.Int(1, 1000)));
+			bindings.Bindings.Add(TDelegate::SciptDelegateBinding(node, (size_t)Random.Int(1, 1000)));
+		}
+	};
+
+	static void CheckCopiedProperties(CloneTestNode* source, CloneTestNode* copy, const Array<Node*>& sources, const Array<Node*>& copies)
+	{
+		SUORA_CHECK_EQ(copy->m_Char, source->m_Char);
+		SUORA_CHECK_EQ(copy->m_Int8, source->m_Int8);
+		SUORA_CHECK_EQ(copy->m_Int16, source->m_Int16);
+		SUORA_CHECK_EQ(copy->m_Int32, source->m_Int32);
+		SUORA_CHECK_EQ(copy->m_Int64, source->m_Int64);
+		SUORA_CHECK_EQ(copy->m_UInt8, source->m_UInt8);
+		SUORA_CHECK_EQ(copy->m_UInt16, source->m_UInt16);
+		SUORA_CHECK_EQ(copy->m_UInt32, source->m_UInt32);
+		SUORA_CHECK_EQ(copy->m_UInt64, source->m_UInt64);
+		SUORA_CHECK_EQ(copy->m_Bool, source->m_Bool);
+		SUORA_CHECK_EQ(copy->m_Float, source->m_Float);
+		SUORA_CHECK_EQ(copy->m_Double, source->m_Double);
+		SUORA_CHECK(copy->m_Vec2 == source->m_Vec2);
+		SUORA_CHECK(copy->m_Vec3 == source->m_Vec3);
+		SUORA_CHECK(copy->m_Vec4 == source->m_Vec4);
+		SUORA_CHECK(copy->m_Quat == source->m_Quat);
+		SUORA_CHECK_EQ(copy->m_String, source->m_String);
+		SUORA_CHECK_EQ(copy->m_MaterialSlots.OverwritteMaterials, source->m_MaterialSlots.OverwritteMaterials);
+		SUORA_CHECK(copy->m_MaterialSlots.Materials.GetData() == source->m_MaterialSlots.Materials.GetData());
+		SUORA_CHECK(copy->m_SuoraID == source->m_SuoraID);
+		SUORA_CHECK(copy->m_Class == source->m_Class);
+		SUORA_CHECK(copy->m_SubclassOf.GetBase() == source->m_SubclassOf.GetBase());
+		SUORA_CHECK(copy->m_SubclassOf.GetClass() == source->m_SubclassOf.GetClass());
+
+		// Assets and Nodes outside of the subtree are shared, Nodes of the subtree are remapped to their copies
+		SUORA_CHECK(copy->m_Material == source->m_Material);
+		SUORA_CHECK(copy->m_Outside == source->m_Outside);
+		SUORA_CHECK(copy->m_Inside == Remap(source->m_Inside, sources, copies));
+		SUORA_CHECK(copy->m_Inside != source->m_Inside);
+
+		const TDelegate& from = GetBindings(source);
+		const TDelegate& to = GetBindings(copy);
+		Array<std::pair<Node*, size_t>> expected;
+		for (const TDelegate::SciptDelegateBinding& binding : from.Bindings)
+		{
+			// Bindings to deleted Nodes are dropped
+			if (binding.NodeBinding.Get()) expected.Add(std::make_pair(Remap(binding.NodeBinding.Get(), sources, copies), binding.ScriptFunctionHash));
+		}
+		SUORA_REQUIRE(to.Bindings.Size() == expected.Size());
+		for (int32_t i = 0; i < expected.Size(); i++)
+		{
+			SUORA_CHECK(to.Bindings[i].NodeBinding.Get() == expected[i].first);
+			SUORA_CHECK_EQ(to.Bindings[i].ScriptFunctionHash, expected[i].second);
+		}
+	}
+
+	/** copy is a Node::Clone() or Node::DuplicateMultiple() of the subtree, that sources lists in pre-order */
+	static void CheckCopiedSubtree(Node* copy, const Array<Node*>& sources)
+	{
+		Array<Node*> copies;
+		CollectNodes(copy, copies);
+		SUORA_REQUIRE(copies.Size() == sources.Size());
+
+		for (int32_t i = 0; i < sources.Size(); i++)
+		{
+			Node* source = sources[i];
+			Node* node = copies[i];
+			SUORA_CHECK(node != source);
+			SUORA_CHECK(node->GetClass() == source->GetClass());
+			SUORA_CHECK_EQ(node->GetName(), source->GetName());
+			SUORA_CHECK_EQ(node->IsEnabled(), source->IsEnabled());
+			SUORA_CHECK_EQ(node->GetChildCount(), source->GetChildCount());
+			SUORA_CHECK(node->m_OverwrittenProperties.GetData() == source->m_OverwrittenProperties.GetData());
+			if (i > 0)
+			{
+				SUORA_CHECK(node->GetParent() == Remap(source->GetParent(), sources, copies));
+			}
+			if (source->IsA<Node3D>())
+			{
+				SUORA_CHECK(node->As<Node3D>()->GetTransformMatrix() == source->As<Node3D>()->GetTransformMatrix());
+			}
+			if (source->IsA<CloneTestNode>())
+			{
+				CheckCopiedProperties(source->As<CloneTestNode>(), node->As<CloneTestNode>(), sources, copies);
+			}
+		}
+	}
+
+	SUORA_TEST(NodeCloning, TestNodeCoversEveryPropertyType)
+	{
+		// A PropertyType without a member here would go untested by the other NodeCloning tests
+		Array<PropertyType> types;
+		for (const Ref<ClassMemberProperty>& member : ClassReflector::GetByClass(CloneTestNode::StaticClass()).GetAllClassMemberProperties())
+		{
+			types.Add(member->m_Property->GetType());
+		}
+		for (uint32_t type = (uint32_t)PropertyType::Char; type <= (uint32_t)PropertyType::Delegate; type++)
+		{
+			SUORA_CHECK((PropertyType)type == PropertyType::Array || types.Contains((PropertyType)type));
+		}
+	}
+
+	SUORA_TEST(NodeCloning, ClonesCopyPropertiesAndRemapReferences)
+	{
+		for (uint32_t seed : { 48u, 480u, 4800u })
+		{
+			CloneTestScene scene(seed);
+
+			// A binding to a Node, that is gone by the time the subtree is cloned
+			Node3D* deleted = scene.SceneWorld.Spawn<Node3D>();
+			GetBindings(scene.Root).Bindings.Add(TDelegate::SciptDelegateBinding(deleted, 48));
+			delete deleted;
+
+			Node* clone = scene.Root->Clone();
+			SUORA_CHECK(clone->GetParent() == nullptr);
+			SUORA_CHECK(clone->GetWorld() == nullptr);
+			CheckCopiedSubtree(clone, scene.Nodes);
+			delete clone;
+
+			// Every copy of a batch references its own subtree
+			const Array<Node*> duplicates = scene.Root->DuplicateMultiple(3);
+			SUORA_REQUIRE(duplicates.Size() == 3);
+			for (Node* duplicate : duplicates)
+			{
+				SUORA_CHECK(duplicate->GetWorld() == &scene.SceneWorld);
+				SUORA_CHECK(duplicate->GetParent() == scene.Root->GetParent());
+				CheckCopiedSubtree(duplicate, scene.Nodes);
+			}
+			SUORA_CHECK(duplicates[0]->As<CloneTestNode>()->m_Inside != duplicates[1]->As<CloneTestNode>()->m_Inside);
+		}
+	}
+
+	SUORA_TEST(NodeCloning, SerializesLikeTheYamlRoundTrip)
+	{
+		for (uint32_t seed : { 48u, 480u, 4800u })
+		{
+			CloneTestScene scene(seed);
+			CloneTestNode* root = scene.Root;
+			root->m_Int64 = 48;
+
+			Node* clone = root->Clone();
+			Node* roundTrip = DuplicateByYaml(root);
+			SUORA_CHECK(SerializeToText(clone) == SerializeToText(roundTrip));
+			SUORA_CHECK(SerializeToText(clone) == SerializeToText(root));
+
+			// First difference: values changed at runtime carry over, even if they are not marked as overwritten
+			SUORA_CHECK_EQ(clone->As<CloneTestNode>()->m_Int64, (int64_t)48);
+			SUORA_CHECK_EQ(roundTrip->As<CloneTestNode>()->m_Int64, (int64_t)0);
+			SUORA_CHECK(clone->As<CloneTestNode>()->m_Inside != nullptr);
+			SUORA_CHECK(roundTrip->As<CloneTestNode>()->m_Inside == nullptr);
+			delete clone;
+			delete roundTrip;
+
+			// Second difference: the root keeps its enabled state, the round trip always enabled it
+			root->SetEnabled(false);
+			clone = root->Clone();
+			roundTrip = DuplicateByYaml(root);
+			SUORA_CHECK(!clone->IsEnabled());
+			SUORA_CHECK(roundTrip->IsEnabled());
+			roundTrip->SetEnabled(false);
+			SUORA_CHECK(SerializeToText(clone) == SerializeToText(roundTrip));
+			delete clone;
+			delete roundTrip;
+		}
+	}
+
+	SUORA_BENCHMARK(NodeCloning, DuplicateMultiple)
+	{
+		CloneTestScene scene(48);
+		SuoraLog("  {0} Nodes per copy", scene.Nodes.Size());
+
+		Array<Node*> duplicates;
+		auto destroyDuplicates = [&]()
+		{
+			for (Node* duplicate : duplicates) duplicate->Destroy();
+			duplicates.Clear();
+			scene.SceneWorld.Update(1.0f / 60.0f);
+		};
+
+		const double yaml = Benchmark("Serialize + Deserialize, 1000 copies", 5, [&]()
+		{
+			for (int32_t i = 0; i < 1000; i++)
+			{
+				CloneTestNode* duplicate = DuplicateByYaml(scene.Root)->As<CloneTestNode>();
+				duplicate->AddToWorld(scene.SceneWorld, scene.Root->GetParent());
+				duplicates.Add(duplicate);
+			}
+		});
+		SUORA_CHECK_EQ(duplicates.Size(), 6000);
+		destroyDuplicates();
+
+		const double clone = Benchmark("DuplicateMultiple(1000)", 5, [&]()
+		{
+			for (Node* duplicate : scene.Root->DuplicateMultiple(1000)) duplicates.Add(duplicate);
+		});
+		SUORA_CHECK_EQ(duplicates.Size(), 6000);
+		destroyDuplicates();
+
+		SuoraLog("  DuplicateMultiple is {0}x as fast", yaml / clone);
+	}
+
+}
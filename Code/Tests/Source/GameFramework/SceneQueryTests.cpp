@@ -0,0 +1,362 @@
+#include "Test.h"
+#include <glm/gtc/matrix_transform.hpp>
+#include "Suora/Assets/Mesh.h"
+#include "Suora/GameFramework/Node.h"
+#include "Suora/GameFramework/World.h"
+#include "Suora/GameFramework/Nodes/MeshNode.h"
+#include "Suora/GameFramework/SceneQuery.h"
+
+namespace Suora::Tests
+{
+
+	/** Axis aligned cube with the given half extends. Triangles 2 * face and 2 * face + 1 form the faces -x, +x, -y, +y, -z, +z. */
+	static void FillCubeMesh(Mesh& mesh, const Vec3& halfExtends = Vec3(0.5f))
+	{
+		std::vector<Vertex> vertices;
+		std::vector<uint32_t> indices;
+		for (int32_t face = 0; face < 6; face++)
+		{
+			const int32_t axis = face / 2;
+			const float side = (face % 2) ? 1.0f : -1.0f;
+			const int32_t u = (axis + 1) % 3, v = (axis + 2) % 3;
+			const uint32_t first = (uint32_t)vertices.size();
+			for (const Vec2& corner : { Vec2(-1.0f, -1.0f), Vec2(1.0f, -1.0f), Vec2(1.0f, 1.0f), Vec2(-1.0f, 1.0f) })
+			{
+				Vec3 position;
+				position[axis] = side * halfExtends[axis];
+				position[u] = corner.x * halfExtends[u];
+				position[v] = corner.y * halfExtends[v];
+				vertices.push_back(Vertex(position));
+			}
+			indices.insert(indices.end(), { first, first + 1, first + 2, first, first + 2, first + 3 });
+		}
+		mesh.m_MeshBuffer = MeshBuffer(vertices, indices);
+		mesh.m_BoundingSphereRadius = glm::length(halfExtends);
+	}
+
+	static bool IsTriangleOfFace(int32_t triangle, int32_t face)
+	{
+		return triangle == face * 2 || triangle == face * 2 + 1;
+	}
+
+	static bool AreNear(const Vec3& a, const Vec3& b, float epsilon = 1e-4f)
+	{
+		return glm::length(a - b) <= epsilon;
+	}
+
+	SUORA_TEST(SceneQuery, RaycastHitsKnownTriangles)
+	{
+		Mesh cube;
+		FillCubeMesh(cube);
+		Node3D* node = new Node3D();
+
+		SceneQuery query;
+		query.AddMesh(node, Mat4(1.0f), cube);
+		SUORA_CHECK_EQ(query.GetProxyCount(), 1u);
+
+		SceneQueryHit hit;
+		SUORA_REQUIRE(query.Raycast(Ray(Vec3(0.1f, 0.2f, -5.0f), Vec3(0.0f, 0.0f, 1.0f)), hit));
+		SUORA_CHECK(hit.Node == node);
+		SUORA_CHECK_NEAR(hit.Distance, 4.5f, 1e-4f);
+		SUORA_CHECK(AreNear(hit.Position, Vec3(0.1f, 0.2f, -0.5f)));
+		SUORA_CHECK(AreNear(hit.Normal, Vec3(0.0f, 0.0f, -1.0f)));
+		SUORA_CHECK(IsTriangleOfFace(hit.Triangle, 4));
+
+		// From above, diagonally onto the top face
+		SUORA_REQUIRE(query.Raycast(Ray(Vec3(-2.0f, 2.5f, 0.0f), Vec3(1.0f, -1.0f, 0.0f)), hit));
+		SUORA_CHECK(AreNear(hit.Position, Vec3(0.0f, 0.5f, 0.0f)));
+		SUORA_CHECK(AreNear(hit.Normal, Vec3(0.0f, 1.0f, 0.0f)));
+		SUORA_CHECK_NEAR(hit.Distance, glm::sqrt(8.0f), 1e-4f);
+		SUORA_CHECK(IsTriangleOfFace(hit.Triangle, 3));
+
+		// Next to the cube, away from it, and too short
+		SUORA_CHECK(!query.Raycast(Ray(Vec3(0.6f, 0.0f, -5.0f), Vec3(0.0f, 0.0f, 1.0f)), hit));
+		SUORA_CHECK(!query.Raycast(Ray(Vec3(0.0f, 0.0f, -5.0f), Vec3(0.0f, 0.0f, -1.0f)), hit));
+		SUORA_CHECK(!query.Raycast(Ray(Vec3(0.0f, 0.0f, -5.0f), Vec3(0.0f, 0.0f, 1.0f)), hit, 4.0f));
+
+		// Triangles are double sided, from the inside the back of the +x face is hit
+		SUORA_REQUIRE(query.Raycast(Ray(Vec3(0.0f), Vec3(1.0f, 0.0f, 0.0f)), hit));
+		SUORA_CHECK_NEAR(hit.Distance, 0.5f, 1e-4f);
+		SUORA_CHECK(AreNear(hit.Normal, Vec3(-1.0f, 0.0f, 0.0f)));
+		SUORA_CHECK(IsTriangleOfFace(hit.Triangle, 1));
+
+		delete node;
+	}
+
+	SUORA_TEST(SceneQuery, RaycastRespectsScaledAndRotatedTransforms)
+	{
+		Mesh cube;
+		FillCubeMesh(cube);
+		Node3D* node = new Node3D();
+
+		// Half extends (1, 0.5, 1.5), turned by 45 degrees around y
+		const Mat4 transform = glm::translate(Mat4(1.0f), Vec3(10.0f, 0.0f, 0.0f)) * glm::rotate(Mat4(1.0f), glm::radians(45.0f), Vec3(0.0f, 1.0f, 0.0f))
+			* glm::scale(Mat4(1.0f), Vec3(2.0f, 1.0f, 3.0f));
+		SceneQuery query;
+		query.AddMesh(node, transform, cube);
+
+		// Along z through the center, the local +x face is entered first, at z = -1 / sin(45)
+		SceneQueryHit hit;
+		SUORA_REQUIRE(query.Raycast(Ray(Vec3(10.0f, 0.0f, -10.0f), Vec3(0.0f, 0.0f, 1.0f)), hit));
+		SUORA_CHECK_NEAR(hit.Position.z, -glm::sqrt(2.0f), 1e-3f);
+		// Distances stay in world units, despite the scale
+		SUORA_CHECK_NEAR(hit.Distance, 10.0f - glm::sqrt(2.0f), 1e-3f);
+		// The normal of a non-uniformly scaled face is still perpendicular to it
+		SUORA_CHECK(AreNear(hit.Normal, glm::normalize(Vec3(1.0f, 0.0f, -1.0f)), 1e-3f));
+		SUORA_CHECK(IsTriangleOfFace(hit.Triangle, 1));
+
+		// Along x, the local -x face is entered at x = 10 - 1 / sin(45)
+		SUORA_REQUIRE(query.Raycast(Ray(Vec3(0.0f, 0.0f, 0.0f), Vec3(1.0f, 0.0f, 0.0f)), hit));
+		SUORA_CHECK_NEAR(hit.Position.x, 10.0f - glm::sqrt(2.0f), 1e-3f);
+		SUORA_CHECK(AreNear(hit.Normal, glm::normalize(Vec3(-1.0f, 0.0f, 1.0f)), 1e-3f));
+		SUORA_CHECK(IsTriangleOfFace(hit.Triangle, 0));
+
+		// Straight down onto the top face, close to the rotated +z face
+		SUORA_REQUIRE(query.Raycast(Ray(Vec3(10.0f + 1.0f, 10.0f, 1.0f), Vec3(0.0f, -1.0f, 0.0f)), hit));
+		SUORA_CHECK_NEAR(hit.Position.y, 0.5f, 1e-3f);
+		SUORA_CHECK(IsTriangleOfFace(hit.Triangle, 3));
+
+		// Inside the world bounds of the box, but past its rotated corner
+		SUORA_CHECK(!query.Raycast(Ray(Vec3(11.5f, 10.0f, 1.5f), Vec3(0.0f, -1.0f, 0.0f)), hit));
+
+		delete node;
+	}
+
+	SUORA_TEST(SceneQuery, RaycastReturnsTheClosestHitThatPassesTheFilter)
+	{
+		Mesh cube;
+		FillCubeMesh(cube);
+		std::vector<Node3D*> nodes;
+		SceneQuery query;
+		for (int32_t i = 0; i < 100; i++)
+		{
+			nodes.push_back(new Node3D());
+			query.AddMesh(nodes.back(), glm::translate(Mat4(1.0f), Vec3((float)(i % 10) * 2.0f, 0.0f, (float)(i / 10) * 2.0f)), cube);
+		}
+
+		SceneQueryHit hit;
+		SUORA_REQUIRE(query.Raycast(Ray(Vec3(4.0f, 0.0f, -10.0f), Vec3(0.0f, 0.0f, 1.0f)), hit));
+		SUORA_CHECK(hit.Node == nodes[2]);
+		SUORA_CHECK_NEAR(hit.Distance, 9.5f, 1e-4f);
+
+		SUORA_REQUIRE(query.Raycast(Ray(Vec3(4.0f, 0.0f, 30.0f), Vec3(0.0f, 0.0f, -1.0f)), hit));
+		SUORA_CHECK(hit.Node == nodes[92]);
+
+		const auto skipNearest = [&](Node3D* node) { return node != nodes[2] && node != nodes[12]; };
+		SUORA_REQUIRE(query.Raycast(Ray(Vec3(4.0f, 0.0f, -10.0f), Vec3(0.0f, 0.0f, 1.0f)), hit, FLT_MAX, skipNearest));
+		SUORA_CHECK(hit.Node == nodes[22]);
+		SUORA_CHECK_NEAR(hit.Distance, 13.5f, 1e-4f);
+
+		for (Node3D* node : nodes) delete node;
+	}
+
+	SUORA_TEST(SceneQuery, BoundingSphereProxies)
+	{
+		Node3D* sphere = new Node3D();
+		Node3D* unloaded = new Node3D();
+
+		// Meshes without CPU data are approximated by their bounding sphere, scaled with the transform
+		Mesh emptyMesh;
+		emptyMesh.m_BoundingSphereRadius = 1.5f;
+
+		SceneQuery query;
+		query.AddSphere(sphere, Vec3(0.0f, 0.0f, 5.0f), 2.0f);
+		query.AddMesh(unloaded, glm::translate(Mat4(1.0f), Vec3(0.0f, 0.0f, -10.0f)) * glm::scale(Mat4(1.0f), Vec3(1.0f, 2.0f, 1.0f)), emptyMesh);
+		SUORA_CHECK_EQ(query.GetProxyCount(), 2u);
+
+		SceneQueryHit hit;
+		SUORA_REQUIRE(query.Raycast(Ray(Vec3(0.0f), Vec3(0.0f, 0.0f, 1.0f)), hit));
+		SUORA_CHECK(hit.Node == sphere);
+		SUORA_CHECK_NEAR(hit.Distance, 3.0f, 1e-4f);
+		SUORA_CHECK(AreNear(hit.Normal, Vec3(0.0f, 0.0f, -1.0f)));
+		SUORA_CHECK_EQ(hit.Triangle, -1);
+
+		SUORA_REQUIRE(query.Raycast(Ray(Vec3(0.0f), Vec3(0.0f, 0.0f, -1.0f)), hit));
+		SUORA_CHECK(hit.Node == unloaded);
+		SUORA_CHECK_NEAR(hit.Distance, 10.0f - 3.0f, 1e-4f);
+		SUORA_CHECK_EQ(hit.Triangle, -1);
+
+		// Starting inside, the sphere is hit right away
+		SUORA_REQUIRE(query.Raycast(Ray(Vec3(0.0f, 0.0f, 5.0f), Vec3(1.0f, 0.0f, 0.0f)), hit));
+		SUORA_CHECK(hit.Node == sphere);
+		SUORA_CHECK_NEAR(hit.Distance, 0.0f, 1e-4f);
+
+		SUORA_CHECK(!query.Raycast(Ray(Vec3(0.0f, 2.1f, 0.0f), Vec3(0.0f, 0.0f, 1.0f)), hit));
+
+		delete sphere;
+		delete unloaded;
+	}
+
+	/** Looks down -z from (0, 0, 10), 60 degrees vertical field of view */
+	static Mat4 GetTestViewProjection()
+	{
+		return glm::perspective(glm::radians(60.0f), 1.0f, 0.1f, 100.0f) * glm::lookAt(Vec3(0.0f, 0.0f, 10.0f), Vec3(0.0f), Vec3(0.0f, 1.0f, 0.0f));
+	}
+
+	SUORA_TEST(SceneQuery, QueryBoxIntersectAndContain)
+	{
+		Mesh cube;
+		FillCubeMesh(cube);
+		Node3D* center = new Node3D();
+		Node3D* right = new Node3D();
+		Node3D* behind = new Node3D();
+		Node3D* sphere = new Node3D();
+
+		SceneQuery query;
+		// The front face of the center cube covers about [-0.091, 0.091] in ndc, the right cube is around x = 0.52
+		query.AddMesh(center, Mat4(1.0f), cube);
+		query.AddMesh(right, glm::translate(Mat4(1.0f), Vec3(3.0f, 0.0f, 0.0f)), cube);
+		query.AddMesh(behind, glm::translate(Mat4(1.0f), Vec3(0.0f, 0.0f, 20.0f)), cube);
+		query.AddSphere(sphere, Vec3(-3.0f, 0.0f, 0.0f), 0.5f);
+		const Mat4 viewProjection = GetTestViewProjection();
+
+		Array<Node3D*> selected = query.QueryBox(viewProjection, Vec2(-0.05f), Vec2(0.05f), SceneQueryBoxMode::Intersect);
+		SUORA_CHECK(selected.Size() == 1 && selected.Contains(center));
+		SUORA_CHECK(query.QueryBox(viewProjection, Vec2(-0.05f), Vec2(0.05f), SceneQueryBoxMode::Contain).Size() == 0);
+
+		selected = query.QueryBox(viewProjection, Vec2(-0.2f), Vec2(0.2f), SceneQueryBoxMode::Contain);
+		SUORA_CHECK(selected.Size() == 1 && selected.Contains(center));
+
+		// Only half of the right cube lies inside
+		selected = query.QueryBox(viewProjection, Vec2(-0.2f, -0.2f), Vec2(0.52f, 0.2f), SceneQueryBoxMode::Intersect);
+		SUORA_CHECK(selected.Size() == 2 && selected.Contains(center) && selected.Contains(right));
+		selected = query.QueryBox(viewProjection, Vec2(-0.2f, -0.2f), Vec2(0.52f, 0.2f), SceneQueryBoxMode::Contain);
+		SUORA_CHECK(selected.Size() == 1 && selected.Contains(center));
+
+		// The corners may be given in any order, nothing behind the camera is selected
+		selected = query.QueryBox(viewProjection, Vec2(1.0f), Vec2(-1.0f), SceneQueryBoxMode::Intersect);
+		SUORA_CHECK(selected.Size() == 3 && !selected.Contains(behind));
+		selected = query.QueryBox(viewProjection, Vec2(-1.0f), Vec2(1.0f), SceneQueryBoxMode::Contain);
+		SUORA_CHECK(selected.Size() == 3 && !selected.Contains(behind));
+
+		// Bounding sphere proxies and the filter
+		selected = query.QueryBox(viewProjection, Vec2(-0.6f, -0.1f), Vec2(-0.45f, 0.1f), SceneQueryBoxMode::Intersect);
+		SUORA_CHECK(selected.Size() == 1 && selected.Contains(sphere));
+		selected = query.QueryBox(viewProjection, Vec2(-1.0f), Vec2(1.0f), SceneQueryBoxMode::Intersect, [&](Node3D* node) { return node != center; });
+		SUORA_CHECK(selected.Size() == 2 && !selected.Contains(center));
+
+		delete center;
+		delete right;
+		delete behind;
+		delete sphere;
+	}
+
+	SUORA_TEST(SceneQuery, QueryBoxTestsTrianglesNotBounds)
+	{
+		Mesh cube;
+		FillCubeMesh(cube);
+		Node3D* bar = new Node3D();
+
+		// A thin bar along the diagonal, its bounds cover the whole square around it
+		SceneQuery query;
+		query.AddMesh(bar, glm::translate(Mat4(1.0f), Vec3(0.0f, 0.0f, -5.0f)) * glm::rotate(Mat4(1.0f), glm::radians(45.0f), Vec3(0.0f, 0.0f, 1.0f))
+			* glm::scale(Mat4(1.0f), Vec3(8.0f, 0.2f, 0.2f)), cube);
+		const Mat4 viewProjection = GetTestViewProjection();
+
+		SUORA_CHECK(query.QueryBox(viewProjection, Vec2(-0.3f, 0.2f), Vec2(-0.2f, 0.3f), SceneQueryBoxMode::Intersect).Size() == 0);
+		SUORA_CHECK(query.QueryBox(viewProjection, Vec2(0.2f, 0.2f), Vec2(0.3f, 0.3f), SceneQueryBoxMode::Intersect).Size() == 1);
+		SUORA_CHECK(query.QueryBox(viewProjection, Vec2(-0.01f), Vec2(0.01f), SceneQueryBoxMode::Intersect).Size() == 1);
+
+		delete bar;
+	}
+
+	SUORA_TEST(SceneQuery, FindPlacementFallsBackToTheGroundPlane)
+	{
+		Mesh cube;
+		FillCubeMesh(cube);
+		Node3D* node = new Node3D();
+		SceneQuery query;
+		query.AddMesh(node, glm::translate(Mat4(1.0f), Vec3(0.0f, 0.5f, 5.0f)), cube);
+
+		// Onto the top of the cube
+		SceneQueryHit hit;
+		SUORA_CHECK(query.FindPlacement(Ray(Vec3(0.0f, 10.0f, 5.0f), Vec3(0.0f, -1.0f, 0.0f)), hit));
+		SUORA_CHECK(hit.Node == node);
+		SUORA_CHECK(AreNear(hit.Position, Vec3(0.0f, 1.0f, 5.0f)));
+
+		// Past the cube onto the ground plane
+		SUORA_CHECK(query.FindPlacement(Ray(Vec3(0.0f, 5.0f, -5.0f), Vec3(0.0f, -1.0f, -1.0f)), hit));
+		SUORA_CHECK(hit.Node == nullptr);
+		SUORA_CHECK(AreNear(hit.Position, Vec3(0.0f, 0.0f, -10.0f)));
+		SUORA_CHECK(AreNear(hit.Normal, Vec3(0.0f, 1.0f, 0.0f)));
+		SUORA_CHECK_NEAR(hit.Distance, 5.0f * glm::sqrt(2.0f), 1e-4f);
+
+		// A filtered Node is placed through
+		SUORA_CHECK(query.FindPlacement(Ray(Vec3(0.0f, 10.0f, 5.0f), Vec3(0.0f, -1.0f, 0.0f)), hit, [&](Node3D* other) { return other != node; }));
+		SUORA_CHECK(hit.Node == nullptr);
+		SUORA_CHECK(AreNear(hit.Position, Vec3(0.0f, 0.0f, 5.0f)));
+
+		// Looking up, or from below the ground, only the point along the Ray remains
+		SUORA_CHECK(!query.FindPlacement(Ray(Vec3(0.0f, 5.0f, -5.0f), Vec3(0.0f, 1.0f, -1.0f)), hit, nullptr, 4.0f));
+		SUORA_CHECK(AreNear(hit.Position, Vec3(0.0f, 5.0f, -5.0f) + glm::normalize(Vec3(0.0f, 1.0f, -1.0f)) * 4.0f));
+		SUORA_CHECK(AreNear(hit.Normal, -glm::normalize(Vec3(0.0f, 1.0f, -1.0f))));
+		SUORA_CHECK(!query.FindPlacement(Ray(Vec3(0.0f, -1.0f, -5.0f), Vec3(0.0f, -1.0f, 0.0f)), hit));
+		SUORA_CHECK_NEAR(hit.Distance, 10.0f, 1e-4f);
+
+		delete node;
+	}
+
+	SUORA_TEST(SceneQuery, UpdateRefitsMovedMeshNodes)
+	{
+		Mesh cube;
+		FillCubeMesh(cube);
+		World world;
+		MeshNode* node = world.Spawn<MeshNode>();
+		node->SetMesh(&cube);
+
+		SceneQuery query;
+		SUORA_CHECK(query.Update(world));
+		SUORA_CHECK_EQ(query.GetProxyCount(), 1u);
+		SUORA_CHECK(!query.Update(world));
+
+		// Moved and scaled in place, without a rebuild
+		node->SetPosition(Vec3(10.0f, 0.0f, 0.0f));
+		node->SetScale(Vec3(2.0f));
+		SUORA_CHECK(!query.Update(world));
+		SceneQueryHit hit;
+		SUORA_CHECK(!query.Raycast(Ray(Vec3(0.0f, 0.0f, -5.0f), Vec3(0.0f, 0.0f, 1.0f)), hit));
+		SUORA_REQUIRE(query.Raycast(Ray(Vec3(10.0f, 0.0f, -5.0f), Vec3(0.0f, 0.0f, 1.0f)), hit));
+		SUORA_CHECK(hit.Node == node);
+		SUORA_CHECK_NEAR(hit.Distance, 4.0f, 1e-4f);
+
+		// A disabled MeshNode is rebuilt away
+		node->SetEnabled(false);
+		SUORA_CHECK(query.Update(world));
+		SUORA_CHECK_EQ(query.GetProxyCount(), 0u);
+
+		query.Clear();
+		SUORA_CHECK(!world.IsHierarchyJournaled());
+	}
+
+	SUORA_TEST(SceneQuery, UpdateRebuildsWhenMeshNodesComeAndGo)
+	{
+		Mesh cube;
+		FillCubeMesh(cube);
+		World world;
+		MeshNode* first = world.Spawn<MeshNode>();
+		first->SetMesh(&cube);
+
+		SceneQuery query;
+		query.Build(world);
+		SUORA_CHECK(world.IsHierarchyJournaled());
+
+		// Nodes without a Mesh proxy do not matter
+		world.Spawn<Node3D>()->SetName("Unrelated");
+		SUORA_CHECK(!query.Update(world));
+
+		MeshNode* second = world.Spawn<MeshNode>();
+		second->SetMesh(&cube);
+		second->SetPosition(Vec3(0.0f, 0.0f, 5.0f));
+		SUORA_CHECK(query.Update(world));
+		SUORA_CHECK_EQ(query.GetProxyCount(), 2u);
+
+		first->Destroy();
+		world.Update(1.0f / 60.0f);
+		SUORA_CHECK(query.Update(world));
+		SUORA_CHECK_EQ(query.GetProxyCount(), 1u);
+		SceneQueryHit hit;
+		SUORA_REQUIRE(query.Raycast(Ray(Vec3(0.0f, 0.0f, -5.0f), Vec3(0.0f, 0.0f, 1.0f)), hit));
+		SUORA_CHECK(hit.Node == second);
+	}
+
+}
@@ -0,0 +1,217 @@
+#include "Test.h"
+#include "Suora/GameFramework/TimerManager.h"
+
+namespace Suora::Tests
+{
+
+	static constexpr float TimerTestTimeStep = 1.0f / 60.0f;
+
+	SUORA_TEST(TimerManager, TimersFireInTheFrameOfTheirTick)
+	{
+		TestRandom random(40);
+		TimerManager timers;
+
+		// Delays across all four wheels, fired by frames of varying length
+		struct ScheduledTimer
+		{
+			uint64_t ExpireTick = 0;
+			int32_t FiredFrame = -1;
+		};
+		std::vector<ScheduledTimer> scheduled(10000);
+		int32_t frame = 0;
+		for (ScheduledTimer& timer : scheduled)
+		{
+			const float delay = random.Int(0, 3) == 0 ? random.Float(0.0f, 0.3f) : random.Float(0.0f, 90.0f);
+			timer.ExpireTick = std::max<uint64_t>((uint64_t)std::llround((double)delay * TimerManager::s_TicksPerSecond), 1);
+			timers.SetTimer(delay, [&timer, &frame]() { timer.FiredFrame = frame; });
+		}
+		SUORA_CHECK_EQ(timers.GetActiveTimerCount(), 10000u);
+
+		std::vector<uint64_t> frameTicks;
+		double time = 0.0;
+		while (time < 91.0)
+		{
+			const float deltaTime = random.Float(1.0f / 144.0f, 1.0f / 15.0f);
+			time += deltaTime;
+			frameTicks.push_back((uint64_t)(time * TimerManager::s_TicksPerSecond));
+			timers.Advance(deltaTime);
+			frame++;
+		}
+
+		for (const ScheduledTimer& timer : scheduled)
+		{
+			const int32_t expected = (int32_t)(std::lower_bound(frameTicks.begin(), frameTicks.end(), timer.ExpireTick) - frameTicks.begin());
+			SUORA_CHECK_EQ(timer.FiredFrame, expected);
+		}
+		SUORA_CHECK_EQ(timers.GetActiveTimerCount(), 0u);
+	}
+
+	SUORA_TEST(TimerManager, LoopingTimersDoNotDrift)
+	{
+		TimerManager timers;
+		uint32_t fired = 0;
+		TimerParams params;
+		params.Loop = true;
+		timers.SetTimer(0.1f, [&fired]() { fired++; }, params);
+
+		// 1/60 does not divide 0.1, an accumulating timer would drift by a frame every few expirations
+		for (int32_t i = 0; i < 6000; i++)
+		{
+			timers.Advance(TimerTestTimeStep);
+		}
+		SUORA_CHECK_EQ(fired, 1000u);
+		SUORA_CHECK_EQ(timers.GetActiveTimerCount(), 1u);
+	}
+
+	SUORA_TEST(TimerManager, ClearedAndPausedTimersDoNotFire)
+	{
+		TimerManager timers;
+		uint32_t fired = 0;
+		TimerHandle cleared = timers.SetTimer(0.5f, [&fired]() { fired++; });
+		TimerHandle paused = timers.SetTimer(1.0f, [&fired]() { fired += 10; });
+
+		SUORA_CHECK(timers.ClearTimer(cleared));
+		SUORA_CHECK(!cleared.IsValid());
+		SUORA_CHECK(!timers.ClearTimer(cleared));
+
+		timers.Advance(0.25f);
+		timers.PauseTimer(paused);
+		SUORA_CHECK(timers.IsTimerPaused(paused));
+		SUORA_CHECK_NEAR(timers.GetTimerRemaining(paused), 0.75f, 0.002f);
+		for (int32_t i = 0; i < 120; i++)
+		{
+			timers.Advance(TimerTestTimeStep);
+		}
+		SUORA_CHECK_EQ(fired, 0u);
+
+		timers.ResumeTimer(paused);
+		timers.Advance(0.7f);
+		SUORA_CHECK_EQ(fired, 0u);
+		timers.Advance(0.1f);
+		SUORA_CHECK_EQ(fired, 10u);
+		SUORA_CHECK(!timers.IsTimerActive(paused));
+	}
+
+	SUORA_TEST(TimerManager, GameClockFollowsPauseAndTimeDilation)
+	{
+		TimerManager timers;
+		bool gameFired = false, realFired = false;
+		timers.SetTimer(1.0f, [&gameFired]() { gameFired = true; });
+		TimerParams real;
+		real.Clock = TimerClock::Real;
+		timers.SetTimer(1.0f, [&realFired]() { realFired = true; }, real);
+
+		timers.SetPaused(true);
+		timers.Advance(1.5f);
+		SUORA_CHECK(!gameFired);
+		SUORA_CHECK(realFired);
+
+		timers.SetPaused(false);
+		timers.SetTimeDilation(2.0f);
+		timers.Advance(0.45f);
+		SUORA_CHECK(!gameFired);
+		timers.Advance(0.1f);
+		SUORA_CHECK(gameFired);
+		SUORA_CHECK_NEAR(timers.GetTime(TimerClock::Game), 1.1, 1e-6);
+	}
+
+	SUORA_TEST(TimerManager, CallbacksMaySetAndClearTimers)
+	{
+		TimerManager timers;
+		uint32_t loops = 0, chained = 0;
+		TimerParams params;
+		params.Loop = true;
+		TimerHandle loop;
+		loop = timers.SetTimer(0.1f, [&]()
+		{
+			// Clears itself, and hands over to a timer that is set from inside the callback
+			loops++;
+			timers.ClearTimer(loop);
+			timers.SetTimer(0.1f, [&chained]() { chained++; });
+		}, params);
+
+		for (int32_t i = 0; i < 60; i++)
+		{
+			timers.Advance(TimerTestTimeStep);
+		}
+		SUORA_CHECK_EQ(loops, 1u);
+		SUORA_CHECK_EQ(chained, 1u);
+		SUORA_CHECK_EQ(timers.GetActiveTimerCount(), 0u);
+	}
+
+	/** What every TimerNode did before the timer wheel: a virtual WorldUpdate per timer and frame */
+	struct PerNodeTimer
+	{
+		virtual ~PerNodeTimer() = default;
+		virtual void WorldUpdate(float deltaTime)
+		{
+			m_Time += deltaTime;
+			if (m_Time >= m_TargetTime)
+			{
+				m_Time -= m_TargetTime;
+				m_Fired++;
+			}
+		}
+		float m_Time = 0.0f;
+		float m_TargetTime = 1.0f;
+		uint32_t m_Fired = 0;
+	};
+
+	SUORA_BENCHMARK(TimerManager, HundredThousandTimers)
+	{
+		constexpr uint32_t timerCount = 100000;
+		TestRandom random(100000);
+
+		// Cooldowns and buffs: most timers run for seconds, every tenth one loops quickly
+		TimerManager timers;
+		uint32_t fired = 0;
+		std::function<void()> rearm;
+		rearm = [&]()
+		{
+			fired++;
+			timers.SetTimer(random.Float(0.5f, 60.0f), rearm);
+		};
+		Array<TimerHandle> handles;
+		Benchmark("Schedule 100k timers", 1, [&]()
+		{
+			timers.ClearAllTimers();
+			handles.Clear();
+			for (uint32_t i = 0; i < timerCount; i++)
+			{
+				TimerParams params;
+				params.Loop = i % 10 == 0;
+				handles.Add(params.Loop ? timers.SetTimer(random.Float(0.1f, 1.0f), [&fired]() { fired++; }, params) : timers.SetTimer(random.Float(0.5f, 60.0f), rearm));
+			}
+		});
+		SUORA_CHECK_EQ(timers.GetActiveTimerCount(), timerCount);
+
+		const double wheel = Benchmark("Advance 100k timers, one frame", 600, [&]() { timers.Advance(TimerTestTimeStep); });
+		SUORA_CHECK_EQ(timers.GetActiveTimerCount(), timerCount);
+		SUORA_CHECK(fired > 0);
+
+		Benchmark("Clear and set 10k timers", 10, [&]()
+		{
+			for (uint32_t i = 0; i < 10000; i++)
+			{
+				TimerHandle& handle = handles[random.Int(0, timerCount - 1)];
+				if (timers.ClearTimer(handle)) handle = timers.SetTimer(random.Float(0.5f, 60.0f), rearm);
+			}
+		});
+
+		std::vector<std::unique_ptr<PerNodeTimer>> nodes;
+		for (uint32_t i = 0; i < timerCount; i++)
+		{
+			nodes.push_back(std::make_unique<PerNodeTimer>());
+			nodes.back()->m_TargetTime = random.Float(0.5f, 60.0f);
+		}
+		const double perNode = Benchmark("Per-node WorldUpdate of 100k timers, one frame", 600, [&]()
+		{
+			for (const std::unique_ptr<PerNodeTimer>& node : nodes)
+			{
+				node->WorldUpdate(TimerTestTimeStep);
+			}
+		});
+		SuoraLog("  Timer wheel {0:.1f}x faster than per-node updates, {1} expirations", perNode / std::max(wheel, 1e-6), fired);
+	}
+
+}
@@ -0,0 +1,177 @@
+#include "Test.h"
+#include <unordered_map>
+#include "Suora/GameFramework/World.h"
+#include "Suora/GameFramework/Node.h"
+
+namespace Suora::Tests
+{
+
+	/** Not reflected, so it reports the Class of Node */
+	class HierarchyTestNode : public Node
+	{
+	public:
+		void AddToWorld(World& world)
+		{
+			InitializeNode(world);
+		}
+	};
+
+	static HierarchyTestNode* AddHierarchyNode(World& world)
+	{
+		HierarchyTestNode* node = new HierarchyTestNode();
+		node->AddToWorld(world);
+		return node;
+	}
+
+	using HierarchyChange = std::pair<WorldHierarchyEvent, Node*>;
+
+	static std::vector<HierarchyChange> TakeChanges(World& world, uint64_t& revision)
+	{
+		Array<WorldHierarchyChange> changes;
+		SUORA_CHECK(world.GetHierarchyChanges(revision, changes));
+		SUORA_CHECK_EQ(revision, world.GetHierarchyRevision());
+
+		std::vector<HierarchyChange> result;
+		for (const WorldHierarchyChange& change : changes)
+		{
+			result.push_back({ change.Event, change.ChangedNode });
+		}
+		return result;
+	}
+
+	SUORA_TEST(WorldHierarchy, JournalsEveryKindOfChange)
+	{
+		World world;
+		HierarchyTestNode* a = AddHierarchyNode(world);
+		uint64_t revision = world.SubscribeToHierarchyChanges();
+		const uint64_t subscribedAt = revision;
+
+		HierarchyTestNode* b = AddHierarchyNode(world);
+		HierarchyTestNode* c = AddHierarchyNode(world);
+		c->SetParent(b);
+		a->SetParent(b);
+		a->SetChildIndex(0);
+		b->SetName("Renamed");
+		// Neither moves nor renames anything
+		a->SetChildIndex(0);
+		b->SetName("Renamed");
+		SUORA_CHECK(b->GetChild(0) == a);
+
+		SUORA_CHECK(TakeChanges(world, revision) == std::vector<HierarchyChange>({
+			{ WorldHierarchyEvent::Added, b },
+			{ WorldHierarchyEvent::Added, c },
+			{ WorldHierarchyEvent::Reparented, c },
+			{ WorldHierarchyEvent::Reparented, a },
+			{ WorldHierarchyEvent::Reparented, a },
+			{ WorldHierarchyEvent::Renamed, b } }));
+		SUORA_CHECK_EQ(world.GetHierarchyRevision(), subscribedAt + 6);
+
+		// The destructor unparents the Node, before the World lets go of it
+		c->Destroy();
+		world.Update(1.0f / 60.0f);
+		SUORA_CHECK(TakeChanges(world, revision) == std::vector<HierarchyChange>({
+			{ WorldHierarchyEvent::Reparented, c },
+			{ WorldHierarchyEvent::Removed, c } }));
+		SUORA_CHECK(TakeChanges(world, revision).empty());
+		SUORA_CHECK_EQ(world.GetHierarchyRevision(), subscribedAt + 8);
+
+		world.UnsubscribeFromHierarchyChanges();
+	}
+
+	SUORA_TEST(WorldHierarchy, JournalsOnlyWhileSubscribed)
+	{
+		World world;
+		HierarchyTestNode* node = AddHierarchyNode(world);
+		const uint64_t unsubscribed = world.GetHierarchyRevision();
+		node->SetName("Unseen");
+		SUORA_CHECK(!world.IsHierarchyJournaled());
+		SUORA_CHECK_EQ(world.GetHierarchyRevision(), unsubscribed);
+
+		// Without a subscriber, no revision is up to date
+		uint64_t revision = unsubscribed;
+		Array<WorldHierarchyChange> changes;
+		SUORA_CHECK(!world.GetHierarchyChanges(revision, changes));
+
+		revision = world.SubscribeToHierarchyChanges();
+		uint64_t second = world.SubscribeToHierarchyChanges();
+		SUORA_CHECK(world.IsHierarchyJournaled());
+		SUORA_CHECK_EQ(revision, second);
+		node->SetName("Seen");
+		SUORA_CHECK_EQ(TakeChanges(world, revision).size(), (size_t)1);
+
+		// The journal keeps going, as long as one subscriber is left
+		world.UnsubscribeFromHierarchyChanges();
+		node->SetName("Seen again");
+		SUORA_CHECK_EQ(TakeChanges(world, second).size(), (size_t)2);
+		world.UnsubscribeFromHierarchyChanges();
+		SUORA_CHECK(!world.IsHierarchyJournaled());
+
+		// Changes of the pause are lost, so a revision from before it has to rebuild
+		node->SetName("Unseen again");
+		uint64_t stale = second;
+		world.SubscribeToHierarchyChanges();
+		SUORA_CHECK(!world.GetHierarchyChanges(stale, changes));
+		SUORA_CHECK(changes.Size() == 0);
+		SUORA_CHECK(TakeChanges(world, stale).empty());
+		world.UnsubscribeFromHierarchyChanges();
+	}
+
+	SUORA_TEST(WorldHierarchy, OverflowingTheJournalRequiresARebuild)
+	{
+		World world;
+		HierarchyTestNode* node = AddHierarchyNode(world);
+		uint64_t revision = world.SubscribeToHierarchyChanges();
+		const uint64_t subscribedAt = revision;
+
+		constexpr uint32_t renames = 20000;
+		for (uint32_t i = 0; i < renames; i++)
+		{
+			node->SetName(i % 2 ? "Odd" : "Even");
+		}
+		SUORA_CHECK_EQ(world.GetHierarchyRevision(), subscribedAt + renames);
+
+		Array<WorldHierarchyChange> changes;
+		SUORA_CHECK(!world.GetHierarchyChanges(revision, changes));
+		SUORA_CHECK(changes.Size() == 0);
+		SUORA_CHECK_EQ(revision, world.GetHierarchyRevision());
+
+		// The recent changes are still there
+		uint64_t recent = world.GetHierarchyRevision() - 100;
+		SUORA_CHECK(world.GetHierarchyChanges(recent, changes));
+		SUORA_CHECK_EQ(changes.Size(), 100);
+
+		// After the rebuild, the view continues from the returned revision
+		node->SetName("Rebuilt");
+		SUORA_CHECK(TakeChanges(world, revision) == std::vector<HierarchyChange>({ { WorldHierarchyEvent::Renamed, node } }));
+		world.UnsubscribeFromHierarchyChanges();
+	}
+
+	SUORA_TEST(WorldHierarchy, LatestChangeOfAReusedAddressWins)
+	{
+		World world;
+		HierarchyTestNode* removed = AddHierarchyNode(world);
+		uint64_t revision = world.SubscribeToHierarchyChanges();
+
+		// The NodeAllocator hands out the slot that was freed last
+		delete removed;
+		HierarchyTestNode* added = AddHierarchyNode(world);
+		SUORA_REQUIRE((Node*)added == (Node*)removed);
+
+		const std::vector<HierarchyChange> changes = TakeChanges(world, revision);
+		SUORA_CHECK(changes == std::vector<HierarchyChange>({
+			{ WorldHierarchyEvent::Reparented, added },
+			{ WorldHierarchyEvent::Removed, added },
+			{ WorldHierarchyEvent::Added, added } }));
+
+		// Views keep the Node, since only its latest change tells whether it is alive
+		std::unordered_map<Node*, bool> alive;
+		for (const HierarchyChange& change : changes)
+		{
+			alive[change.second] = change.first != WorldHierarchyEvent::Removed;
+		}
+		SUORA_CHECK(alive[added]);
+		SUORA_CHECK_EQ(world.GetAllNodes().Size(), 1);
+		world.UnsubscribeFromHierarchyChanges();
+	}
+
+}
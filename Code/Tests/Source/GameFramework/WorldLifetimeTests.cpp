@@ -0,0 +1,262 @@
+#include "Test.h"
+#include "Suora/GameFramework/World.h"
+#include "Suora/GameFramework/Node.h"
+#include "Suora/GameFramework/NodeAllocator.h"
+#include "Suora/GameFramework/Nodes/MeshNode.h"
+
+namespace Suora::Tests
+{
+
+	/** Not reflected, so it reports the Class of Node. Spawn(Node::StaticClass()) hands out recycled instances of it. */
+	class LifetimeTestNode : public Node
+	{
+	public:
+		void AddToWorld(World& world)
+		{
+			InitializeNode(world);
+		}
+
+		virtual void Begin() override
+		{
+			BeginCount++;
+		}
+		virtual void OnRecycle() override
+		{
+			RecycleCount++;
+		}
+		virtual void WorldUpdate(float deltaTime) override
+		{
+			UpdateCount++;
+			if (OnWorldUpdate) OnWorldUpdate(this);
+		}
+
+		uint32_t BeginCount = 0;
+		uint32_t RecycleCount = 0;
+		uint32_t UpdateCount = 0;
+		std::function<void(LifetimeTestNode*)> OnWorldUpdate;
+	};
+
+	static LifetimeTestNode* AddTestNode(World& world, bool worldUpdate = true)
+	{
+		LifetimeTestNode* node = new LifetimeTestNode();
+		if (worldUpdate) node->SetUpdateFlag(UpdateFlag::WorldUpdate);
+		node->AddToWorld(world);
+		return node;
+	}
+
+	SUORA_TEST(WorldLifetime, IndicesStayConsistentAcrossSwapRemoves)
+	{
+		World world;
+		TestRandom random(30);
+
+		std::vector<Ptr<Node>> nodes;
+		for (int32_t i = 0; i < 500; i++)
+		{
+			nodes.push_back(AddTestNode(world, i % 3 != 0));
+		}
+		world.Update(1.0f / 60.0f);
+		SUORA_CHECK(world.ValidateNodeIndices());
+
+		for (int32_t frame = 0; frame < 60; frame++)
+		{
+			// Nodes in the middle of the update list destroy or delete others, while WorldUpdate() iterates it
+			for (int32_t i = 0; i < 20; i++)
+			{
+				Ptr<Node>& node = nodes[random.Int(0, (int32_t)nodes.size() - 1)];
+				LifetimeTestNode* updater = node ? dynamic_cast<LifetimeTestNode*>(node.Get()) : nullptr;
+				if (!updater) continue;
+
+				const bool deleteDirectly = random.Int(0, 3) == 0;
+				Ptr<Node> victim = nodes[random.Int(0, (int32_t)nodes.size() - 1)];
+				updater->OnWorldUpdate = [victim, deleteDirectly](LifetimeTestNode* self)
+				{
+					self->OnWorldUpdate = nullptr;
+					if (!victim || victim.Get() == self || victim->IsPendingKill()) return;
+					if (deleteDirectly) delete victim.Get();
+					else victim->Destroy();
+				};
+			}
+			for (int32_t i = 0; i < 10; i++)
+			{
+				nodes.push_back(AddTestNode(world, random.Int(0, 1) == 0));
+			}
+
+			world.Update(1.0f / 60.0f);
+			SUORA_CHECK(world.ValidateNodeIndices());
+		}
+
+		// Every surviving Node with WorldUpdate is still updated exactly once per frame
+		std::vector<std::pair<LifetimeTestNode*, uint32_t>> survivors;
+		for (const Ptr<Node>& node : nodes)
+		{
+			LifetimeTestNode* testNode = node ? dynamic_cast<LifetimeTestNode*>(node.Get()) : nullptr;
+			if (testNode)
+			{
+				testNode->OnWorldUpdate = nullptr;
+				survivors.push_back({ testNode, testNode->UpdateCount });
+			}
+		}
+		SUORA_CHECK_EQ(world.GetAllNodes().Size(), (int32_t)survivors.size());
+		world.Update(1.0f / 60.0f);
+		world.Update(1.0f / 60.0f);
+		for (const auto& [node, updates] : survivors)
+		{
+			SUORA_CHECK_EQ(node->UpdateCount, node->IsUpdateFlagSet(UpdateFlag::WorldUpdate) ? updates + 2 : updates);
+		}
+		SUORA_CHECK(world.ValidateNodeIndices());
+	}
+
+	SUORA_TEST(WorldLifetime, RecycledHierarchiesBeginAgainWithNulledPtrs)
+	{
+		World world;
+		world.EnableRecycling(Node::StaticClass(), 4);
+
+		LifetimeTestNode* root = new LifetimeTestNode();
+		LifetimeTestNode* child = new LifetimeTestNode();
+		LifetimeTestNode* grandChild = new LifetimeTestNode();
+		child->SetParent(root);
+		grandChild->SetParent(child);
+		root->SetUpdateFlag(UpdateFlag::WorldUpdate);
+		root->AddToWorld(world);
+		world.Update(1.0f / 60.0f);
+		SUORA_CHECK_EQ(root->BeginCount, 1u);
+		SUORA_CHECK_EQ(grandChild->BeginCount, 1u);
+
+		Ptr<Node> rootPtr = root, childPtr = child, grandChildPtr = grandChild;
+		root->Destroy();
+		world.Update(1.0f / 60.0f);
+
+		// The whole Hierarchy is pooled, but nothing reaches it anymore
+		SUORA_CHECK_EQ(world.GetRecycledNodeCount(Node::StaticClass()), 1u);
+		SUORA_CHECK(rootPtr.Get() == nullptr);
+		SUORA_CHECK(childPtr.Get() == nullptr);
+		SUORA_CHECK(grandChildPtr.Get() == nullptr);
+		SUORA_CHECK_EQ(root->RecycleCount, 1u);
+		SUORA_CHECK_EQ(grandChild->RecycleCount, 1u);
+		SUORA_CHECK_EQ(world.GetAllNodes().Size(), 0);
+		SUORA_CHECK(world.ValidateNodeIndices());
+
+		Node* respawned = world.Spawn(Node::StaticClass());
+		SUORA_REQUIRE(respawned == root);
+		SUORA_CHECK(grandChild->GetParent() == child);
+		SUORA_CHECK(child->GetParent() == root);
+		SUORA_CHECK_EQ(world.GetRecycledNodeCount(Node::StaticClass()), 0u);
+
+		const uint32_t updates = root->UpdateCount;
+		world.Update(1.0f / 60.0f);
+		SUORA_CHECK_EQ(root->BeginCount, 2u);
+		SUORA_CHECK_EQ(child->BeginCount, 2u);
+		SUORA_CHECK_EQ(grandChild->BeginCount, 2u);
+		SUORA_CHECK_EQ(root->UpdateCount, updates + 1);
+		SUORA_CHECK(!root->IsPendingKill());
+		SUORA_CHECK_EQ(world.GetAllNodes().Size(), 3);
+		SUORA_CHECK(world.ValidateNodeIndices());
+
+		// New Ptrs to the respawned Nodes work as usual
+		Ptr<Node> newPtr = child;
+		SUORA_CHECK(newPtr.Get() == child);
+	}
+
+	SUORA_TEST(WorldLifetime, RecycledNodesRespawnWithClassDefaults)
+	{
+		World world;
+		world.EnableRecycling(MeshNode::StaticClass(), 4);
+
+		MeshNode* node = world.Spawn<MeshNode>();
+		LifetimeTestNode* runtimeChild = new LifetimeTestNode();
+		runtimeChild->SetParent(node);
+		runtimeChild->AddToWorld(world);
+		world.Update(1.0f / 60.0f);
+
+		node->m_CastShadow = false;
+		node->SetPosition(Vec3(1.0f, 2.0f, 3.0f));
+		node->SetEnabled(false);
+		node->Replicate(true);
+		node->Destroy();
+		world.Update(1.0f / 60.0f);
+		SUORA_CHECK_EQ(world.GetRecycledNodeCount(MeshNode::StaticClass()), 1u);
+
+		// Reset to the class default object, as if it was instantiated again
+		MeshNode* respawned = world.Spawn<MeshNode>();
+		SUORA_REQUIRE(respawned == node);
+		SUORA_CHECK(node->m_CastShadow);
+		SUORA_CHECK(node->GetPosition() == Vec3(0.0f));
+		SUORA_CHECK(node->IsEnabled());
+		SUORA_CHECK(!node->IsReplicated());
+
+		// Children added at runtime have no default, they travel along and are reset by OnRecycle()
+		SUORA_CHECK(runtimeChild->GetParent() == node);
+		SUORA_CHECK_EQ(runtimeChild->RecycleCount, 1u);
+		world.Update(1.0f / 60.0f);
+		SUORA_CHECK_EQ(runtimeChild->BeginCount, 2u);
+		SUORA_CHECK(world.ValidateNodeIndices());
+	}
+
+	SUORA_TEST(WorldLifetime, FullPoolsDeleteDestroyedNodes)
+	{
+		World world;
+		world.EnableRecycling(Node::StaticClass(), 2);
+
+		for (int32_t i = 0; i < 5; i++)
+		{
+			AddTestNode(world);
+		}
+		world.Update(1.0f / 60.0f);
+		for (Node* node : world.GetAllNodes())
+		{
+			node->Destroy();
+		}
+		world.Update(1.0f / 60.0f);
+
+		SUORA_CHECK_EQ(world.GetRecycledNodeCount(Node::StaticClass()), 2u);
+		SUORA_CHECK_EQ(world.GetAllNodes().Size(), 0);
+		world.DisableRecycling(Node::StaticClass());
+		SUORA_CHECK_EQ(world.GetRecycledNodeCount(Node::StaticClass()), 0u);
+	}
+
+	SUORA_BENCHMARK(WorldLifetime, FiveThousandSpawnsAndDestroysPerFrame)
+	{
+		constexpr int32_t nodesPerFrame = 5000;
+
+		auto run = [](bool recycle, const char* label)
+		{
+			World world;
+			if (recycle) world.EnableRecycling(Node3D::StaticClass(), nodesPerFrame);
+
+			// A standing population, so removals swap inside large lists
+			for (int32_t i = 0; i < 20000; i++)
+			{
+				world.Spawn<Node3D>()->SetUpdateFlag(UpdateFlag::WorldUpdate);
+			}
+			world.Update(1.0f / 60.0f);
+
+			Array<Node3D*> spawned;
+			const double ms = Benchmark(label, 60, [&]()
+			{
+				for (Node3D* node : spawned)
+				{
+					node->Destroy();
+				}
+				spawned.Clear();
+				for (int32_t i = 0; i < nodesPerFrame; i++)
+				{
+					Node3D* node = world.Spawn<Node3D>();
+					node->SetUpdateFlag(UpdateFlag::WorldUpdate);
+					spawned.Add(node);
+				}
+				world.Update(1.0f / 60.0f);
+			});
+			SUORA_CHECK(world.ValidateNodeIndices());
+			return ms;
+		};
+
+		const NodeAllocatorStats before = NodeAllocator::GetStats();
+		const double deleting = run(false, "Spawn and destroy 5k Nodes per frame");
+		const double recycling = run(true, "Spawn and destroy 5k Nodes per frame, recycled");
+		const NodeAllocatorStats after = NodeAllocator::GetStats();
+
+		SuoraLog("  Recycling {0:.2f}x faster. NodeAllocator: {1} allocations, {2} KB reserved", deleting / std::max(recycling, 1e-6),
+			after.Allocations - before.Allocations, after.ReservedBytes / 1024);
+	}
+
+}
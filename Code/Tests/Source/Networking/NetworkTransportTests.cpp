@@ -0,0 +1,134 @@
+#include "Test.h"
+#include <thread>
+#include "Suora/Networking/BitStream.h"
+#include "Suora/Networking/NetworkTransport.h"
+
+namespace Suora::Tests
+{
+
+	SUORA_TEST(BitStream, RoundTripsMixedWidths)
+	{
+		TestRandom random(41);
+		std::vector<uint32_t> values, widths;
+		std::vector<uint64_t> varInts;
+		BitWriter writer;
+		for (int32_t i = 0; i < 1000; i++)
+		{
+			const uint32_t bits = (uint32_t)random.Int(1, 32);
+			const uint32_t value = (uint32_t)random.Int(INT32_MIN, INT32_MAX) & (bits == 32 ? ~0u : (1u << bits) - 1);
+			writer.WriteBits(value, bits);
+			values.push_back(value);
+			widths.push_back(bits);
+
+			const uint64_t varInt = (uint64_t)(uint32_t)random.Int(0, INT32_MAX) << random.Int(0, 31);
+			writer.WriteVarUInt(varInt);
+			varInts.push_back(varInt);
+		}
+		writer.WriteString("Suora");
+		writer.WriteBool(true);
+
+		BitReader reader(writer.GetData().data(), writer.GetByteCount());
+		for (size_t i = 0; i < values.size(); i++)
+		{
+			SUORA_CHECK_EQ(reader.ReadBits(widths[i]), values[i]);
+			SUORA_CHECK_EQ(reader.ReadVarUInt(), varInts[i]);
+		}
+		SUORA_CHECK_EQ(reader.ReadString(), String("Suora"));
+		SUORA_CHECK(reader.ReadBool());
+		SUORA_CHECK(!reader.IsOverflown());
+
+		// Reading past the end returns zeros
+		SUORA_CHECK_EQ(reader.ReadBits(32), 0u);
+		SUORA_CHECK(reader.IsOverflown());
+	}
+
+	SUORA_TEST(BitStream, QuantizationStaysWithinItsPrecision)
+	{
+		TestRandom random(1024);
+		BitWriter writer;
+		std::vector<uint32_t> words;
+		for (int32_t i = 0; i < 1000; i++)
+		{
+			const float value = random.Float(-10000.0f, 10000.0f);
+			SUORA_CHECK_NEAR(Quantization::UnpackFixed(Quantization::PackFixed(value)), value, 0.5f / 1024.0f + std::abs(value) * 1e-7f);
+
+			const Quat rotation = glm::normalize(Quat(random.Float(-1.0f, 1.0f), random.Float(-1.0f, 1.0f), random.Float(-1.0f, 1.0f), random.Float(-1.0f, 1.0f)));
+			const Quat unpacked = Quantization::UnpackQuat(Quantization::PackQuat(rotation));
+			// q and -q are the same rotation
+			SUORA_CHECK(std::abs(glm::dot(rotation, unpacked)) > 0.9999f);
+
+			words.push_back(Quantization::PackFixed(value));
+		}
+
+		// Deltas against the previous word, including wrap-around and unchanged words
+		words.push_back(words.back());
+		words.push_back(0x80000000u);
+		words.push_back(0x7FFFFFFFu);
+		uint32_t baseline = 0;
+		for (uint32_t word : words)
+		{
+			Quantization::WriteDelta(writer, word, baseline);
+			baseline = word;
+		}
+		BitReader reader(writer.GetData().data(), writer.GetByteCount());
+		baseline = 0;
+		for (uint32_t word : words)
+		{
+			baseline = Quantization::ReadDelta(reader, baseline);
+			SUORA_CHECK_EQ(baseline, word);
+		}
+		SUORA_CHECK(!reader.IsOverflown());
+	}
+
+	SUORA_TEST(NetworkTransport, LoopbackDeliversByPort)
+	{
+		LoopbackTransport a, b;
+		SUORA_REQUIRE(a.GetLocalAddress().IsValid() && b.GetLocalAddress().IsValid());
+		SUORA_CHECK(a.GetLocalAddress() != b.GetLocalAddress());
+
+		const uint8_t payload[] = { 1, 2, 3, 4 };
+		SUORA_CHECK(a.Send(b.GetLocalAddress(), payload, sizeof(payload)));
+		NetworkPacket packet;
+		SUORA_CHECK(!a.Receive(packet));
+		SUORA_REQUIRE(b.Receive(packet));
+		SUORA_CHECK(packet.Address == a.GetLocalAddress());
+		SUORA_CHECK(packet.Data == std::vector<uint8_t>(payload, payload + sizeof(payload)));
+		SUORA_CHECK(!b.Receive(packet));
+
+		// Datagrams above the max packet size are refused instead of being split
+		std::vector<uint8_t> large(a.GetMaxPacketSize() + 1);
+		SUORA_CHECK(!a.Send(b.GetLocalAddress(), large.data(), large.size()));
+
+		a.SetSimulatedPacketLoss(0.25f);
+		for (int32_t i = 0; i < 4000; i++) a.Send(b.GetLocalAddress(), payload, sizeof(payload));
+		uint32_t received = 0;
+		while (b.Receive(packet)) received++;
+		SUORA_CHECK(received > 2800 && received < 3200);
+	}
+
+	SUORA_TEST(NetworkTransport, UdpSocketIsNonBlocking)
+	{
+		UdpTransport udp;
+		SUORA_REQUIRE(udp.Open(0));
+		SUORA_CHECK(udp.GetLocalAddress().IsValid());
+
+		// Has to return right away, a blocking socket would hang here
+		NetworkPacket packet;
+		SUORA_CHECK(!udp.Receive(packet));
+
+		const uint8_t payload[] = { 42, 7 };
+		SUORA_CHECK(udp.Send(udp.GetLocalAddress(), payload, sizeof(payload)));
+
+		bool received = false;
+		for (int32_t i = 0; i < 200 && !received; i++)
+		{
+			received = udp.Receive(packet);
+			if (!received) std::this_thread::sleep_for(std::chrono::milliseconds(5));
+		}
+		SUORA_REQUIRE(received);
+		SUORA_CHECK(packet.Data == std::vector<uint8_t>(payload, payload + sizeof(payload)));
+		udp.Close();
+		SUORA_CHECK(!udp.IsOpen());
+	}
+
+}
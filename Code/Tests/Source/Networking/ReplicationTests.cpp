@@ -0,0 +1,257 @@
+#include "Test.h"
+#include "Suora/GameFramework/World.h"
+#include "Suora/GameFramework/Node.h"
+#include "Suora/GameFramework/Nodes/ShapeNodes.h"
+#include "Suora/GameFramework/Nodes/CameraNode.h"
+#include "Suora/Networking/Networking.h"
+#include "Suora/Networking/Replication.h"
+
+namespace Suora::Tests
+{
+	static constexpr float NetworkTestTimeStep = 1.0f / 60.0f;
+
+	/** A server World and any number of client Worlds, connected through LoopbackTransports */
+	struct LoopbackSession
+	{
+		struct Peer
+		{
+			Ref<World> PeerWorld;
+			Ref<NetworkContext> Context;
+			Ref<LoopbackTransport> Transport;
+		};
+
+		Peer Server;
+		std::vector<Peer> Clients;
+
+		LoopbackSession(int32_t clientCount = 1, uint32_t bytesPerSecond = 64 * 1024, float packetLoss = 0.0f)
+		{
+			Server = CreatePeer(bytesPerSecond, packetLoss);
+			Server.Context->StartServer(Server.Transport);
+			for (int32_t i = 0; i < clientCount; i++)
+			{
+				Peer client = CreatePeer(bytesPerSecond, packetLoss);
+				client.Context->StartClient(client.Transport, Server.Transport->GetLocalAddress());
+				Clients.push_back(client);
+			}
+		}
+
+		World& GetServerWorld() const { return *Server.PeerWorld; }
+		World& GetClientWorld(int32_t client = 0) const { return *Clients[client].PeerWorld; }
+
+		void Step(int32_t frames = 1)
+		{
+			for (int32_t i = 0; i < frames; i++)
+			{
+				Server.PeerWorld->Update(NetworkTestTimeStep);
+				for (Peer& client : Clients) client.PeerWorld->Update(NetworkTestTimeStep);
+			}
+		}
+
+		/** The replicated counterpart of a server Node, nullptr if the client does not know it (yet) */
+		Node* GetClientNode(Node* serverNode, int32_t client = 0) const
+		{
+			const NetworkKey key = Server.Context->GetNetworkKey(serverNode);
+			return key ? Clients[client].Context->GetNode(key) : nullptr;
+		}
+
+	private:
+		static Peer CreatePeer(uint32_t bytesPerSecond, float packetLoss)
+		{
+			Peer peer;
+			peer.PeerWorld = CreateRef<World>();
+			peer.Context = CreateRef<NetworkContext>();
+			peer.Context->GetSettings().BytesPerSecond = bytesPerSecond;
+			peer.Transport = CreateRef<LoopbackTransport>();
+			peer.Transport->SetSimulatedPacketLoss(packetLoss);
+			peer.PeerWorld->SetNetworkContext(peer.Context);
+			return peer;
+		}
+	};
+
+	static Node3D* SpawnReplicated(World& world, const Vec3& position)
+	{
+		Node3D* node = world.Spawn<Node3D>();
+		node->SetPosition(position);
+		node->Replicate(true);
+		return node;
+	}
+
+	static bool Converged(const LoopbackSession& session, const std::vector<Node3D*>& nodes)
+	{
+		for (Node3D* node : nodes)
+		{
+			Node3D* replicated = session.GetClientNode(node) ? session.GetClientNode(node)->As<Node3D>() : nullptr;
+			if (!replicated || glm::distance(replicated->GetPosition(), node->GetPosition()) > 1.0f / 512.0f) return false;
+		}
+		return true;
+	}
+
+	SUORA_TEST(Replication, SpawnsUpdatesAndDestroysOnTheClient)
+	{
+		LoopbackSession session;
+		session.Step(10);
+		SUORA_REQUIRE(session.Clients[0].Context->IsConnected());
+
+		Node3D* a = SpawnReplicated(session.GetServerWorld(), Vec3(1.0f, 2.0f, 3.0f));
+		Node3D* b = SpawnReplicated(session.GetServerWorld(), Vec3(-4.0f, 0.5f, 100.25f));
+		session.GetServerWorld().Spawn<Node3D>();
+		session.Step(10);
+
+		SUORA_REQUIRE(session.GetClientNode(a) && session.GetClientNode(b));
+		SUORA_CHECK(session.GetClientNode(a)->GetClass() == Node3D::StaticClass());
+		SUORA_CHECK_NEAR(glm::distance(session.GetClientNode(a)->As<Node3D>()->GetPosition(), a->GetPosition()), 0.0f, 1.0f / 1024.0f);
+		SUORA_CHECK_NEAR(glm::distance(session.GetClientNode(b)->As<Node3D>()->GetPosition(), b->GetPosition()), 0.0f, 1.0f / 1024.0f);
+		SUORA_CHECK_EQ(session.Server.Context->GetStats().ReplicatedNodes, 2u);
+
+		a->SetPosition(Vec3(7.0f, -8.0f, 9.0f));
+		session.Step(10);
+		SUORA_CHECK_NEAR(glm::distance(session.GetClientNode(a)->As<Node3D>()->GetPosition(), a->GetPosition()), 0.0f, 1.0f / 1024.0f);
+
+		Ptr<Node> clientA = session.GetClientNode(a);
+		Ptr<Node> clientB = session.GetClientNode(b);
+		a->Destroy();
+		b->Replicate(false);
+		session.Step(10);
+		SUORA_CHECK(!clientA || clientA->IsPendingKill());
+		SUORA_CHECK(!clientB || clientB->IsPendingKill());
+		SUORA_CHECK_EQ(session.Server.Context->GetStats().ReplicatedNodes, 0u);
+	}
+
+	SUORA_TEST(Replication, NodesLeavingRelevanceAreDestroyedAndCreatedAgain)
+	{
+		LoopbackSession session;
+		session.Server.Context->GetSettings().RelevanceDistance = 50.0f;
+		CameraNode* view = session.GetClientWorld().Spawn<CameraNode>();
+		session.GetClientWorld().SetMainCamera(view);
+		session.Step(10);
+		SUORA_REQUIRE(session.Clients[0].Context->IsConnected());
+
+		Node3D* node = SpawnReplicated(session.GetServerWorld(), Vec3(10.0f, 0.0f, 0.0f));
+		session.Step(10);
+		Ptr<Node> first = session.GetClientNode(node);
+		SUORA_REQUIRE(first);
+
+		// Out of relevance, no ghost stays behind on the client
+		node->SetPosition(Vec3(500.0f, 0.0f, 0.0f));
+		session.Step(10);
+		SUORA_CHECK(!first || first->IsPendingKill());
+		SUORA_CHECK(session.GetClientNode(node) == nullptr);
+
+		// Back in relevance, the client gets a full create at the current position
+		node->SetPosition(Vec3(20.0f, 5.0f, 0.0f));
+		session.Step(10);
+		SUORA_REQUIRE(session.GetClientNode(node));
+		SUORA_CHECK(session.GetClientNode(node) != first.Get());
+		SUORA_CHECK(Converged(session, { node }));
+
+		// Leaving and coming back before the destroy is acknowledged ends with the Node on the client as well
+		node->SetPosition(Vec3(500.0f, 0.0f, 0.0f));
+		session.Step(3);
+		node->SetPosition(Vec3(-20.0f, 0.0f, 0.0f));
+		session.Step(20);
+		SUORA_CHECK(Converged(session, { node }));
+	}
+
+	SUORA_TEST(Replication, ConvergesUnderPacketLoss)
+	{
+		LoopbackSession session(1, 64 * 1024, 0.2f);
+		session.Step(30);
+		SUORA_REQUIRE(session.Clients[0].Context->IsConnected());
+
+		TestRandom random(41);
+		std::vector<Node3D*> nodes;
+		for (int32_t i = 0; i < 50; i++)
+		{
+			nodes.push_back(SpawnReplicated(session.GetServerWorld(), Vec3(random.Float(-50.0f, 50.0f), random.Float(-50.0f, 50.0f), random.Float(-50.0f, 50.0f))));
+		}
+		for (int32_t frame = 0; frame < 120; frame++)
+		{
+			for (Node3D* node : nodes) node->SetPosition(node->GetPosition() + Vec3(random.Float(-0.1f, 0.1f), 0.0f, random.Float(-0.1f, 0.1f)));
+			session.Step();
+		}
+
+		// Once the server stops moving them, the client catches up despite the lost snapshots and acks
+		session.Step(180);
+		SUORA_CHECK(Converged(session, nodes));
+	}
+
+	SUORA_TEST(Replication, DefersUpdatesBeyondTheBudget)
+	{
+		LoopbackSession session(1, 4 * 1024);
+		session.Step(10);
+		SUORA_REQUIRE(session.Clients[0].Context->IsConnected());
+
+		std::vector<Node3D*> nodes;
+		for (int32_t i = 0; i < 500; i++)
+		{
+			nodes.push_back(SpawnReplicated(session.GetServerWorld(), Vec3((float)i, 0.0f, 0.0f)));
+		}
+		session.Step(10);
+		SUORA_CHECK(session.Server.Context->GetStats().DeferredUpdates > 0);
+
+		session.Step(60 * 20);
+		SUORA_CHECK(Converged(session, nodes));
+	}
+
+	SUORA_TEST(Replication, AppliedBoolsAreNormalized)
+	{
+		World world;
+		BoxShapeNode* box = world.Spawn<BoxShapeNode>();
+		const ReplicationLayout& layout = ReplicationLayout::Get(BoxShapeNode::StaticClass());
+
+		const size_t offset = (size_t)((uint8_t*)&box->m_IsTrigger - (uint8_t*)(Object*)box);
+		const ReplicationLayout::Field* trigger = nullptr;
+		for (const ReplicationLayout::Field& field : layout.GetFields())
+		{
+			if (field.Offset == offset) trigger = &field;
+		}
+		SUORA_REQUIRE(trigger && trigger->Type == PropertyType::Bool);
+
+		std::vector<uint32_t> words;
+		layout.Capture(box, words);
+		for (uint32_t value : { 2u, 0x100u, 1u })
+		{
+			words[trigger->FirstWord] = value;
+			layout.Apply(box, words.data());
+			SUORA_CHECK_EQ(*(const uint8_t*)&box->m_IsTrigger, (uint8_t)1);
+		}
+		words[trigger->FirstWord] = 0;
+		layout.Apply(box, words.data());
+		SUORA_CHECK_EQ(*(const uint8_t*)&box->m_IsTrigger, (uint8_t)0);
+	}
+
+	SUORA_BENCHMARK(Replication, TenThousandMovingNodes)
+	{
+		constexpr int32_t clientCount = 4;
+		LoopbackSession session(clientCount, 256 * 1024);
+		session.Step(10);
+
+		TestRandom random(42);
+		std::vector<Node3D*> nodes;
+		for (int32_t i = 0; i < 10000; i++)
+		{
+			nodes.push_back(SpawnReplicated(session.GetServerWorld(), Vec3(random.Float(-500.0f, 500.0f), 0.0f, random.Float(-500.0f, 500.0f))));
+		}
+		session.Step(10);
+
+		uint64_t snapshots = 0;
+		uint64_t bytes = 0;
+		const double frameMs = Benchmark("World::Update of the server and 4 clients, 10k moving replicated Nodes", 300, [&]()
+		{
+			for (Node3D* node : nodes) node->SetPosition(node->GetPosition() + Vec3(0.01f, 0.0f, 0.0f));
+			const uint64_t sent = session.Server.Context->GetStats().SentSnapshots;
+			session.GetServerWorld().Update(NetworkTestTimeStep);
+			if (session.Server.Context->GetStats().SentSnapshots != sent)
+			{
+				snapshots += session.Server.Context->GetStats().SentSnapshots - sent;
+				bytes += session.Server.Context->GetStats().LastSnapshotBytes;
+			}
+			for (LoopbackSession::Peer& client : session.Clients) client.PeerWorld->Update(NetworkTestTimeStep);
+		});
+
+		SUORA_CHECK(snapshots > 0);
+		SuoraLog("  {0} snapshots sent, last snapshot of each round {1} bytes on average. {2:.3f} ms per frame",
+			snapshots, snapshots ? bytes * clientCount / snapshots : 0, frameMs);
+	}
+
+}
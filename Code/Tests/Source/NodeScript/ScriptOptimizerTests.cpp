@@ -0,0 +1,211 @@
+#include "Test.h"
+#include "Suora/Core/Object/NativeFunctionManager.h"
+#include "Suora/NodeScript/ScriptStack.h"
+#include "Suora/NodeScript/Scripting/ScriptVM.h"
+#include "Suora/NodeScript/Scripting/ScriptOptimizer.h"
+
+namespace Suora::Tests
+{
+
+	// Natives with observable behaviour: Square counts its calls, Record is the only side effect of a program
+	static uint32_t s_SquareCalls = 0;
+	static std::vector<int32_t> s_Recorded;
+
+	static void Native_Add(ScriptStack& stack)
+	{
+		const int32_t b = stack.PopItem<int32_t>();
+		const int32_t a = stack.PopItem<int32_t>();
+		// Wraps instead of overflowing, random programs square values over and over
+		stack.Proccess<int32_t>((int32_t)((uint32_t)a + (uint32_t)b));
+	}
+	static void Native_Square(ScriptStack& stack)
+	{
+		s_SquareCalls++;
+		const int32_t a = stack.PopItem<int32_t>();
+		stack.Proccess<int32_t>((int32_t)((uint32_t)a * (uint32_t)a));
+	}
+	static void Native_Record(ScriptStack& stack)
+	{
+		s_Recorded.push_back(stack.PopItem<int32_t>());
+	}
+
+	/** Registered on first use, the NativeFunction registry is not guaranteed to exist during static initialization */
+	struct TestNatives
+	{
+		NativeFunction Add = NativeFunction("ScriptOptimizerTests::Add(int32_t,int32_t)", &Native_Add, 0, { { "int32_t", "a" }, { "int32_t", "b" } }, "int32_t", FunctionFlags::Callable | FunctionFlags::Pure | FunctionFlags::Static);
+		NativeFunction Square = NativeFunction("ScriptOptimizerTests::Square(int32_t)", &Native_Square, 0, { { "int32_t", "a" } }, "int32_t", FunctionFlags::Callable | FunctionFlags::Pure | FunctionFlags::Static);
+		NativeFunction Record = NativeFunction("ScriptOptimizerTests::Record(int32_t)", &Native_Record, 0, { { "int32_t", "value" } }, "void", FunctionFlags::Callable | FunctionFlags::Static);
+
+		TestNatives()
+		{
+			ScriptOptimizer::RegisterConstantFolder(Add.m_Hash, [](const int64_t* args)
+			{
+				return ScriptStack::ConvertToStack<int32_t>((int32_t)((uint32_t)ScriptStack::ConvertFromStack<int32_t>(args[0]) + (uint32_t)ScriptStack::ConvertFromStack<int32_t>(args[1])));
+			});
+		}
+	};
+	static TestNatives& GetNatives()
+	{
+		static TestNatives natives;
+		return natives;
+	}
+
+	static ScriptInstruction Constant(int32_t value) { return ScriptInstruction(EScriptInstruction::PushConstant, { ScriptStack::ConvertToStack<int32_t>(value) }); }
+	static ScriptInstruction Call(const NativeFunction& native) { return ScriptInstruction(EScriptInstruction::CallNativeFunction, { (int64_t)native.m_Hash }); }
+	static ScriptInstruction Store(int64_t localVar) { return ScriptInstruction(EScriptInstruction::PushToLocalVar, { localVar }); }
+	static ScriptInstruction Load(int64_t localVar) { return ScriptInstruction(EScriptInstruction::PushLocalVar, { localVar }); }
+
+	static ScriptFunction MakeFunction(const std::vector<ScriptInstruction>& instructions, uint32_t localVarCount = 0)
+	{
+		ScriptFunction func;
+		func.m_Instructions = instructions;
+		func.m_LocalVarCount = localVarCount;
+		return func;
+	}
+
+	/** Returns what the function recorded */
+	static std::vector<int32_t> Execute(ScriptFunction& func, uint32_t* squareCalls = nullptr)
+	{
+		s_Recorded.clear();
+		s_SquareCalls = 0;
+		ScriptStack stack;
+		func.Call(nullptr, stack);
+		if (squareCalls) *squareCalls = s_SquareCalls;
+		return s_Recorded;
+	}
+
+	SUORA_TEST(ScriptOptimizer, FoldsConstantCalls)
+	{
+		ScriptFunction func = MakeFunction({ Constant(2), Constant(3), Call(GetNatives().Add), Call(GetNatives().Record) });
+		ScriptFunction optimized = func;
+
+		ScriptOptimizerStats stats;
+		SUORA_REQUIRE(ScriptOptimizer::Optimize(optimized, &stats));
+		SUORA_CHECK_EQ(stats.ConstantsFolded, 1u);
+		SUORA_CHECK_EQ(optimized.m_Instructions.size(), 2u);
+		SUORA_CHECK(Execute(optimized) == Execute(func));
+		SUORA_CHECK(Execute(optimized) == std::vector<int32_t>{ 5 });
+	}
+
+	SUORA_TEST(ScriptOptimizer, ReusesPureSubexpressions)
+	{
+		// What the BlueprintCompiler emits for a pure Node consumed twice
+		ScriptFunction func = MakeFunction({ Constant(7), Call(GetNatives().Square), Constant(7), Call(GetNatives().Square), Call(GetNatives().Add), Call(GetNatives().Record) });
+		ScriptFunction optimized = func;
+
+		ScriptOptimizerStats stats;
+		SUORA_REQUIRE(ScriptOptimizer::Optimize(optimized, &stats));
+		SUORA_CHECK_EQ(stats.SubexpressionsReused, 1u);
+
+		uint32_t callsBefore = 0, callsAfter = 0;
+		SUORA_CHECK(Execute(func, &callsBefore) == Execute(optimized, &callsAfter));
+		SUORA_CHECK_EQ(callsBefore, 2u);
+		SUORA_CHECK_EQ(callsAfter, 1u);
+		SUORA_CHECK(ScriptOptimizer::Verify(optimized));
+	}
+
+	SUORA_TEST(ScriptOptimizer, ImpureCallsEndReuse)
+	{
+		ScriptFunction func = MakeFunction({ Constant(3), Call(GetNatives().Square), Call(GetNatives().Record), Constant(3), Call(GetNatives().Square), Call(GetNatives().Record) });
+		ScriptFunction optimized = func;
+		ScriptOptimizer::Optimize(optimized);
+
+		uint32_t callsAfter = 0;
+		SUORA_CHECK(Execute(optimized, &callsAfter) == Execute(func));
+		SUORA_CHECK_EQ(callsAfter, 2u);
+	}
+
+	SUORA_TEST(ScriptOptimizer, RemovesDeadStoresAndLocalTraffic)
+	{
+		ScriptFunction func = MakeFunction({ Constant(1), Store(0), Constant(4), Store(1), Load(1), Call(GetNatives().Record) }, 2);
+		ScriptFunction optimized = func;
+
+		ScriptOptimizerStats stats;
+		SUORA_REQUIRE(ScriptOptimizer::Optimize(optimized, &stats));
+		SUORA_CHECK(stats.StoresRemoved >= 1);
+		SUORA_CHECK(stats.PeepholesApplied >= 1);
+		SUORA_CHECK_EQ(optimized.m_LocalVarCount, 0u);
+		SUORA_CHECK_EQ(optimized.m_Instructions.size(), 2u);
+		SUORA_CHECK(Execute(optimized) == Execute(func));
+	}
+
+	SUORA_TEST(ScriptOptimizer, KeepsFunctionsWithJumps)
+	{
+		ScriptFunction func = MakeFunction({ Constant(1), Constant(1), Call(GetNatives().Add), Call(GetNatives().Record), ScriptInstruction(EScriptInstruction::IfNotThenJump, { 0, 3 }) });
+		ScriptFunction optimized = func;
+		SUORA_CHECK(!ScriptOptimizer::Optimize(optimized));
+		SUORA_CHECK_EQ(optimized.m_Instructions.size(), func.m_Instructions.size());
+	}
+
+	SUORA_TEST(ScriptOptimizer, VerifierRejectsBrokenBytecode)
+	{
+		String error;
+		SUORA_CHECK(ScriptOptimizer::Verify(MakeFunction({ Constant(1), Call(GetNatives().Record) }), &error));
+
+		SUORA_CHECK(!ScriptOptimizer::Verify(MakeFunction({ ScriptInstruction(EScriptInstruction::Pop) }), &error));
+		SUORA_CHECK(!ScriptOptimizer::Verify(MakeFunction({ Constant(1), Store(2) }, 2), &error));
+		SUORA_CHECK(!ScriptOptimizer::Verify(MakeFunction({ Load(0), Call(GetNatives().Record) }, 1), &error));
+		SUORA_CHECK(!ScriptOptimizer::Verify(MakeFunction({ Constant(1), ScriptInstruction(EScriptInstruction::CallNativeFunction, { 12345 }) }), &error));
+		SUORA_CHECK(!ScriptOptimizer::Verify(MakeFunction({ Constant(1), ScriptInstruction(EScriptInstruction::IfNotThenJump, { 0, 5 }) }), &error));
+		SUORA_CHECK(!ScriptOptimizer::Verify(MakeFunction({ Constant(1), Constant(2) }), &error));
+		SUORA_CHECK(!error.empty());
+
+		// Broken input is reported and left alone
+		ScriptFunction broken = MakeFunction({ ScriptInstruction(EScriptInstruction::Pop) });
+		ScriptOptimizerStats stats;
+		SUORA_CHECK(!ScriptOptimizer::Optimize(broken, &stats));
+		SUORA_CHECK_EQ(stats.VerificationFailures, 1u);
+	}
+
+	/** Random straight-line programs, like the compiler generates them: every value is recorded or stored eventually */
+	static ScriptFunction MakeRandomFunction(TestRandom& random)
+	{
+		constexpr uint32_t localVarCount = 4;
+		std::vector<ScriptInstruction> instructions;
+		std::vector<bool> written(localVarCount, false);
+		int32_t depth = 0;
+
+		const int32_t length = random.Int(4, 40);
+		for (int32_t i = 0; i < length; i++)
+		{
+			const int32_t localVar = random.Int(0, localVarCount - 1);
+			switch (random.Int(0, 6))
+			{
+			case 0: instructions.push_back(Constant(random.Int(-3, 3))); depth++; break;
+			case 1: if (written[localVar]) { instructions.push_back(Load(localVar)); depth++; } break;
+			case 2: if (depth >= 1) { instructions.push_back(Call(GetNatives().Square)); } break;
+			case 3: if (depth >= 2) { instructions.push_back(Call(GetNatives().Add)); depth--; } break;
+			case 4: if (depth >= 1) { instructions.push_back(Call(GetNatives().Record)); depth--; } break;
+			case 5: if (depth >= 1) { instructions.push_back(Store(localVar)); written[localVar] = true; depth--; } break;
+			case 6: if (depth >= 1) { instructions.push_back(ScriptInstruction(EScriptInstruction::UpStack)); depth++; } break;
+			}
+		}
+		for (; depth > 0; depth--)
+		{
+			instructions.push_back(Call(GetNatives().Record));
+		}
+		return MakeFunction(instructions, localVarCount);
+	}
+
+	SUORA_TEST(ScriptOptimizer, RandomProgramsKeepTheirBehaviour)
+	{
+		TestRandom random(36);
+		ScriptOptimizerStats stats;
+		for (int32_t i = 0; i < 500; i++)
+		{
+			ScriptFunction func = MakeRandomFunction(random);
+			SUORA_REQUIRE(ScriptOptimizer::Verify(func));
+
+			ScriptFunction optimized = func;
+			ScriptOptimizer::Optimize(optimized, &stats);
+
+			uint32_t callsBefore = 0, callsAfter = 0;
+			SUORA_CHECK(Execute(func, &callsBefore) == Execute(optimized, &callsAfter));
+			SUORA_CHECK(callsAfter <= callsBefore);
+			SUORA_CHECK(optimized.m_Instructions.size() <= func.m_Instructions.size() + 2 * callsBefore);
+		}
+		SUORA_CHECK_EQ(stats.VerificationFailures, 0u);
+		SUORA_CHECK(stats.InstructionsAfter < stats.InstructionsBefore);
+	}
+
+}
@@ -0,0 +1,87 @@
+#include "Test.h"
+#include "PhysicsTestScene.h"
+
+namespace Suora::Tests
+{
+
+	/** Characters on a grid on top of a static ground box */
+	static Array<CharacterNode*> SpawnCrowd(World& world, int32_t count, float spacing)
+	{
+		SpawnBox(world, Vec3(0.0f, -1.0f, 0.0f), Vec3(500.0f, 1.0f, 500.0f));
+
+		Array<CharacterNode*> crowd;
+		const int32_t perRow = (int32_t)glm::ceil(glm::sqrt((float)count));
+		for (int32_t i = 0; i < count; i++)
+		{
+			CharacterNode* character = world.Spawn<CharacterNode>();
+			character->SetPosition(Vec3((i % perRow - perRow / 2) * spacing, character->m_CapsuleHalfHeight + character->m_CapsuleRadius + 0.05f, (i / perRow - perRow / 2) * spacing));
+			crowd.Add(character);
+		}
+		StepWorld(world);
+		return crowd;
+	}
+
+	/** Every character walks towards the center of the crowd */
+	static void MoveCrowd(Array<CharacterNode*>& crowd, float speed)
+	{
+		for (CharacterNode* character : crowd)
+		{
+			Vec3 direction = -character->GetPosition();
+			direction.y = 0.0f;
+			if (glm::length(direction) > 0.01f)
+			{
+				character->AddMovementInput(glm::normalize(direction) * speed * PhysicsTestTimeStep);
+			}
+		}
+	}
+
+	SUORA_TEST(CharacterCrowd, SeparatesOverlappingCharacters)
+	{
+		World world;
+		Array<CharacterNode*> crowd = SpawnCrowd(world, 2, 0.2f);
+		SUORA_REQUIRE(crowd.Size() == 2);
+		StepWorld(world, 60);
+
+		Vec3 offset = crowd[0]->GetPosition() - crowd[1]->GetPosition();
+		offset.y = 0.0f;
+		SUORA_CHECK(glm::length(offset) >= (crowd[0]->m_CapsuleRadius + crowd[1]->m_CapsuleRadius) * 0.9f);
+	}
+
+	SUORA_TEST(CharacterCrowd, SimulationIsDeterministic)
+	{
+		// Same input, two Worlds: the parallel jobs must not make the results depend on their scheduling
+		World worldA, worldB;
+		Array<CharacterNode*> crowdA = SpawnCrowd(worldA, 256, 1.2f);
+		Array<CharacterNode*> crowdB = SpawnCrowd(worldB, 256, 1.2f);
+
+		for (int32_t frame = 0; frame < 120; frame++)
+		{
+			MoveCrowd(crowdA, 4.0f);
+			MoveCrowd(crowdB, 4.0f);
+			StepWorld(worldA);
+			StepWorld(worldB);
+		}
+
+		int32_t mismatches = 0;
+		for (int32_t i = 0; i < crowdA.Size(); i++)
+		{
+			if (crowdA[i]->GetPosition() != crowdB[i]->GetPosition()) mismatches++;
+		}
+		SUORA_CHECK_EQ(mismatches, 0);
+	}
+
+	SUORA_BENCHMARK(CharacterCrowd, TwoThousandCapsules)
+	{
+		World world;
+		Physics::PhysicsWorld* physics = world.GetPhysicsWorld();
+		Array<CharacterNode*> crowd = SpawnCrowd(world, 2000, 1.5f);
+
+		const double frameMs = Benchmark("PhysicsWorld::Update, 2k characters walking into each other", 120, [&]()
+		{
+			MoveCrowd(crowd, 4.0f);
+			physics->Update(PhysicsTestTimeStep);
+		});
+		SuoraLog("  {0:.2f} us per character and step", frameMs * 1000.0 / crowd.Size());
+	}
+
+}
@@ -0,0 +1,52 @@
+#include "Test.h"
+#include "PhysicsTestScene.h"
+#include "Suora/Physics/CollisionMatrix.h"
+
+namespace Suora::Tests
+{
+	using Physics::CollisionMatrix;
+
+	SUORA_TEST(CollisionMatrix, SetMasksKeepsTheMatrixSymmetric)
+	{
+		const std::array<uint32_t, CollisionMatrix::s_LayerCount> previous = CollisionMatrix::GetMasks();
+
+		std::array<uint32_t, CollisionMatrix::s_LayerCount> masks;
+		masks.fill(CollisionMatrix::s_AllLayers);
+		// Only layer 2 disagrees, that is enough to separate the pair
+		masks[2] &= ~(1u << 5);
+		CollisionMatrix::SetMasks(masks);
+
+		SUORA_CHECK(!CollisionMatrix::ShouldCollide(2, 5));
+		SUORA_CHECK(!CollisionMatrix::ShouldCollide(5, 2));
+		SUORA_CHECK(CollisionMatrix::ShouldCollide(2, 4));
+
+		CollisionMatrix::SetShouldCollide(2, 5, true);
+		SUORA_CHECK(CollisionMatrix::ShouldCollide(5, 2));
+		SUORA_CHECK_EQ(CollisionMatrix::GetMask(2), CollisionMatrix::s_AllLayers);
+
+		CollisionMatrix::SetMasks(previous);
+	}
+
+	SUORA_TEST(CollisionMatrix, OutOfRangeLayersAreClamped)
+	{
+		World world;
+		BoxShapeNode* negative = SpawnBox(world, Vec3(0.0f), Vec3(1.0f), true, -1);
+		BoxShapeNode* tooLarge = SpawnBox(world, Vec3(0.0f, 0.0f, 5.0f), Vec3(1.0f), true, 100);
+		StepWorld(world);
+
+		SUORA_CHECK_EQ(negative->GetCollisionLayer(), 0);
+		SUORA_CHECK_EQ(tooLarge->GetCollisionLayer(), (int32_t)CollisionMatrix::s_LayerCount - 1);
+
+		// -1 would wrap to layer 15 through the modulo
+		RaycastParams params;
+		params.LayerMask = 1u << 0;
+		HitResult hit;
+		SUORA_REQUIRE(world.Raycast(Vec3(0.0f, 0.0f, -10.0f), Vec3(0.0f, 0.0f, 10.0f), hit, params));
+		SUORA_CHECK(hit.Shape == negative);
+
+		params.LayerMask = 1u << (CollisionMatrix::s_LayerCount - 1);
+		SUORA_REQUIRE(world.Raycast(Vec3(0.0f, 0.0f, -10.0f), Vec3(0.0f, 0.0f, 10.0f), hit, params));
+		SUORA_CHECK(hit.Shape == tooLarge);
+	}
+
+}
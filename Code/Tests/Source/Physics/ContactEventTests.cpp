@@ -0,0 +1,268 @@
+#include "Test.h"
+#include "PhysicsTestScene.h"
+
+namespace Suora::Tests
+{
+	using Physics::ContactPhase;
+
+	/** Every Collision event a ShapeNode received, in dispatch order */
+	struct ContactRecorder
+	{
+		struct Event
+		{
+			ShapeNode* Receiver = nullptr;
+			ShapeNode* Other = nullptr;
+			ContactPhase Phase = ContactPhase::Enter;
+			uint32_t Step = 0;
+		};
+
+		std::vector<Event> Events;
+		uint32_t Step = 0;
+
+		void Listen(ShapeNode* shape)
+		{
+			shape->OnCollisionEnter.Register([this, shape](ShapeNode* other) { Events.push_back({ shape, other, ContactPhase::Enter, Step }); });
+			shape->OnCollisionStay.Register([this, shape](ShapeNode* other) { Events.push_back({ shape, other, ContactPhase::Stay, Step }); });
+			shape->OnCollisionExit.Register([this, shape](ShapeNode* other) { Events.push_back({ shape, other, ContactPhase::Exit, Step }); });
+		}
+
+		void StepWorld(World& world, uint32_t steps = 1)
+		{
+			for (uint32_t i = 0; i < steps; i++)
+			{
+				Step++;
+				world.Update(PhysicsTestTimeStep);
+			}
+		}
+
+		std::vector<Event> GetEvents(ShapeNode* receiver, ShapeNode* other) const
+		{
+			std::vector<Event> events;
+			for (const Event& event : Events)
+			{
+				if (event.Receiver == receiver && event.Other == other) events.push_back(event);
+			}
+			return events;
+		}
+	};
+
+	static BoxShapeNode* SpawnAwakeBox(World& world, const Vec3& position, const Vec3& halfExtends)
+	{
+		BoxShapeNode* box = SpawnBox(world, position, halfExtends, false);
+		// Jolt does not report persisted contacts of sleeping bodies
+		box->m_AllowSleep = false;
+		return box;
+	}
+
+	SUORA_TEST(ContactEvents, StackReportsEnterStayAndExitOncePerPair)
+	{
+		World world;
+		ContactRecorder recorder;
+
+		BoxShapeNode* ground = SpawnBox(world, Vec3(0.0f, -1.0f, 0.0f), Vec3(20.0f, 1.0f, 20.0f));
+		std::vector<ShapeNode*> stack = { ground };
+		for (int32_t i = 0; i < 3; i++)
+		{
+			stack.push_back(SpawnAwakeBox(world, Vec3(0.0f, 0.5f + i * 1.0f, 0.0f), Vec3(0.5f)));
+		}
+		for (ShapeNode* shape : stack) recorder.Listen(shape);
+
+		recorder.StepWorld(world, 60);
+		const uint32_t touchingUntil = recorder.Step;
+
+		// Lift the top box far away, so only its pair separates
+		ShapeNode* top = stack.back();
+		top->SetPosition(top->GetPosition() + Vec3(0.0f, 10.0f, 0.0f));
+		recorder.StepWorld(world, 5);
+
+		for (size_t i = 0; i + 1 < stack.size(); i++)
+		{
+			// Both sides of the pair see the same sequence
+			for (const auto& [receiver, other] : { std::pair(stack[i], stack[i + 1]), std::pair(stack[i + 1], stack[i]) })
+			{
+				const std::vector<ContactRecorder::Event> events = recorder.GetEvents(receiver, other);
+				SUORA_REQUIRE(!events.empty());
+				SUORA_CHECK(events.front().Phase == ContactPhase::Enter);
+				SUORA_CHECK_EQ(events.front().Step, 1u);
+
+				uint32_t enters = 0, exits = 0;
+				for (size_t e = 0; e < events.size(); e++)
+				{
+					if (events[e].Phase == ContactPhase::Enter) enters++;
+					if (events[e].Phase == ContactPhase::Exit) exits++;
+					// One event per Step while touching
+					if (e > 0) SUORA_CHECK_EQ(events[e].Step, events[e - 1].Step + 1);
+				}
+				SUORA_CHECK_EQ(enters, 1u);
+
+				const bool separated = receiver == top || other == top;
+				SUORA_CHECK_EQ(exits, separated ? 1u : 0u);
+				if (separated)
+				{
+					SUORA_CHECK(events.back().Phase == ContactPhase::Exit);
+					SUORA_CHECK_EQ(events.back().Step, touchingUntil + 1);
+				}
+				else
+				{
+					SUORA_CHECK(events.back().Phase == ContactPhase::Stay);
+					SUORA_CHECK_EQ(events.back().Step, recorder.Step);
+				}
+			}
+		}
+
+		// Boxes that are not stacked on each other never touched
+		SUORA_CHECK(recorder.GetEvents(stack[1], stack[3]).empty());
+		SUORA_CHECK(recorder.GetEvents(ground, stack[2]).empty());
+	}
+
+	/** Spheres raining onto the ground, returns the dispatched events as indices of the spawned ShapeNodes */
+	static std::vector<std::tuple<int32_t, int32_t, ContactPhase, uint32_t>> RecordPile(uint32_t seed)
+	{
+		World world;
+		ContactRecorder recorder;
+		std::unordered_map<ShapeNode*, int32_t> indices;
+
+		ShapeNode* ground = SpawnBox(world, Vec3(0.0f, -1.0f, 0.0f), Vec3(10.0f, 1.0f, 10.0f));
+		indices[ground] = 0;
+		recorder.Listen(ground);
+
+		TestRandom random(seed);
+		for (int32_t i = 1; i <= 200; i++)
+		{
+			SphereShapeNode* sphere = SpawnSphere(world, Vec3(random.Float(-3.0f, 3.0f), random.Float(1.0f, 20.0f), random.Float(-3.0f, 3.0f)), 0.5f, false);
+			indices[sphere] = i;
+			recorder.Listen(sphere);
+		}
+		recorder.StepWorld(world, 180);
+
+		std::vector<std::tuple<int32_t, int32_t, ContactPhase, uint32_t>> events;
+		for (const ContactRecorder::Event& event : recorder.Events)
+		{
+			events.push_back({ indices[event.Receiver], indices[event.Other], event.Phase, event.Step });
+		}
+		return events;
+	}
+
+	SUORA_TEST(ContactEvents, DispatchOrderIsDeterministic)
+	{
+		const auto first = RecordPile(31);
+		const auto second = RecordPile(31);
+
+		SUORA_CHECK(first.size() > 200);
+		SUORA_REQUIRE(first.size() == second.size());
+		SUORA_CHECK(first == second);
+	}
+
+	SUORA_TEST(ContactEvents, ContactFilterSuppressesPairs)
+	{
+		World world;
+		ContactRecorder recorder;
+
+		BoxShapeNode* ground = SpawnBox(world, Vec3(0.0f, -1.0f, 0.0f), Vec3(20.0f, 1.0f, 20.0f));
+		BoxShapeNode* filtered = SpawnAwakeBox(world, Vec3(-3.0f, 0.5f, 0.0f), Vec3(0.5f));
+		BoxShapeNode* reported = SpawnAwakeBox(world, Vec3(3.0f, 0.5f, 0.0f), Vec3(0.5f));
+		recorder.Listen(ground);
+		recorder.Listen(filtered);
+		recorder.Listen(reported);
+
+		uint32_t filterCalls = 0;
+		world.GetPhysicsWorld()->m_ContactFilter = [&](ShapeNode* a, ShapeNode* b)
+		{
+			filterCalls++;
+			return a != filtered && b != filtered;
+		};
+		recorder.StepWorld(world, 30);
+
+		SUORA_CHECK(filterCalls > 0);
+		SUORA_CHECK(recorder.GetEvents(filtered, ground).empty());
+		SUORA_CHECK(recorder.GetEvents(ground, filtered).empty());
+		SUORA_CHECK_EQ(recorder.GetEvents(reported, ground).size(), 30u);
+		SUORA_CHECK_EQ(recorder.GetEvents(ground, reported).size(), 30u);
+
+		// The filter only hides events, the box still rests on the ground
+		SUORA_CHECK_NEAR(filtered->GetPosition().y, 0.5f, 0.05f);
+		world.GetPhysicsWorld()->m_ContactFilter = nullptr;
+	}
+
+	SUORA_TEST(ContactEvents, DestroyingNodesInsideCallbacksIsSafe)
+	{
+		World world;
+		ContactRecorder recorder;
+
+		BoxShapeNode* ground = SpawnBox(world, Vec3(0.0f, -1.0f, 0.0f), Vec3(20.0f, 1.0f, 20.0f));
+		recorder.Listen(ground);
+
+		// Every crate destroys itself and the ground destroys the bombs, all from inside the dispatch
+		std::vector<Ptr<ShapeNode>> crates, bombs;
+		for (int32_t i = 0; i < 20; i++)
+		{
+			BoxShapeNode* crate = SpawnAwakeBox(world, Vec3(i * 2.0f - 20.0f, 0.5f, -3.0f), Vec3(0.5f));
+			crate->OnCollisionEnter.Register([crate](ShapeNode* other) { crate->Destroy(); });
+			recorder.Listen(crate);
+			crates.push_back(crate);
+
+			BoxShapeNode* bomb = SpawnAwakeBox(world, Vec3(i * 2.0f - 20.0f, 0.5f, 3.0f), Vec3(0.5f));
+			recorder.Listen(bomb);
+			bombs.push_back(bomb);
+		}
+		ground->OnCollisionEnter.Register([&bombs](ShapeNode* other)
+		{
+			for (const Ptr<ShapeNode>& bomb : bombs)
+			{
+				if (bomb.Get() == other) other->Destroy();
+			}
+		});
+		// A second box on top of one crate loses its support
+		BoxShapeNode* survivor = SpawnAwakeBox(world, Vec3(-20.0f, 1.5f, -3.0f), Vec3(0.5f));
+		recorder.Listen(survivor);
+
+		recorder.StepWorld(world, 1);
+		for (const Ptr<ShapeNode>& crate : crates) SUORA_CHECK(crate.Get() == nullptr);
+		for (const Ptr<ShapeNode>& bomb : bombs) SUORA_CHECK(bomb.Get() == nullptr);
+
+		// Destroyed Nodes receive nothing afterwards, and nothing dispatches to them
+		const size_t eventsAfterDestroy = recorder.Events.size();
+		recorder.StepWorld(world, 60);
+		for (size_t i = eventsAfterDestroy; i < recorder.Events.size(); i++)
+		{
+			const ContactRecorder::Event& event = recorder.Events[i];
+			SUORA_CHECK((event.Receiver == ground || event.Receiver == survivor) && (event.Other == ground || event.Other == survivor));
+		}
+		SUORA_CHECK(!recorder.GetEvents(survivor, ground).empty());
+		SUORA_CHECK_NEAR(survivor->GetPosition().y, 0.5f, 0.05f);
+	}
+
+	SUORA_BENCHMARK(ContactEvents, ThousandsOfTouchingBodies)
+	{
+		World world;
+		Physics::PhysicsWorld* physics = world.GetPhysicsWorld();
+		SpawnBox(world, Vec3(0.0f, -1.0f, 0.0f), Vec3(200.0f, 1.0f, 200.0f));
+
+		// Boxes touching the ground and their four neighbours, about 6.8k pairs. More would exceed the contact constraints of the JoltPhysicsWorld.
+		uint64_t dispatched = 0;
+		constexpr int32_t perSide = 48;
+		for (int32_t x = 0; x < perSide; x++)
+		{
+			for (int32_t z = 0; z < perSide; z++)
+			{
+				BoxShapeNode* box = SpawnAwakeBox(world, Vec3(x - perSide / 2.0f, 0.5f, z - perSide / 2.0f), Vec3(0.5f));
+				box->OnCollisionStay.Register([&dispatched](ShapeNode* other) { dispatched++; });
+			}
+		}
+		StepWorld(world, 30);
+		SUORA_CHECK(physics->GetStats().ContactPairs > (uint32_t)(perSide * perSide));
+
+		dispatched = 0;
+		double simulationMs = 0.0;
+		const double frameMs = Benchmark("PhysicsWorld::Update, 2.3k touching bodies", 120, [&]()
+		{
+			physics->Update(PhysicsTestTimeStep);
+			simulationMs += physics->GetStats().SimulationTimeMs;
+		});
+		simulationMs /= 121.0;
+
+		SuoraLog("  {0} touching pairs, {1} Stay events per frame. Simulation {2:.3f} ms, contact dispatch and write-back {3:.3f} ms per frame",
+			physics->GetStats().ContactPairs, dispatched / 121, simulationMs, frameMs - simulationMs);
+	}
+
+}
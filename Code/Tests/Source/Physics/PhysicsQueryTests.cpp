@@ -0,0 +1,215 @@
+#include "Test.h"
+#include "PhysicsTestScene.h"
+
+namespace Suora::Tests
+{
+
+	SUORA_TEST(PhysicsQuery, RaycastHitsNearestFace)
+	{
+		World world;
+		BoxShapeNode* box = SpawnBox(world, Vec3(0.0f), Vec3(1.0f));
+		StepWorld(world);
+
+		HitResult hit;
+		SUORA_REQUIRE(world.Raycast(Vec3(0.0f, 0.0f, -10.0f), Vec3(0.0f, 0.0f, 10.0f), hit));
+		SUORA_CHECK(hit.Hit);
+		SUORA_CHECK(hit.Shape == box);
+		SUORA_CHECK_NEAR(hit.Distance, 9.0f, 0.001f);
+		SUORA_CHECK_NEAR(hit.Point.z, -1.0f, 0.001f);
+		SUORA_CHECK_NEAR(hit.Normal.z, -1.0f, 0.001f);
+
+		// The ray ends before the box
+		SUORA_CHECK(!world.Raycast(Vec3(0.0f, 0.0f, -10.0f), Vec3(0.0f, 0.0f, -2.0f), hit));
+		SUORA_CHECK(!hit.Hit);
+		// Passes next to the box
+		SUORA_CHECK(!world.Raycast(Vec3(2.0f, 0.0f, -10.0f), Vec3(2.0f, 0.0f, 10.0f), hit));
+	}
+
+	SUORA_TEST(PhysicsQuery, RaycastAllIsSortedByDistance)
+	{
+		World world;
+		BoxShapeNode* farBox = SpawnBox(world, Vec3(0.0f, 0.0f, 6.0f), Vec3(1.0f));
+		BoxShapeNode* nearBox = SpawnBox(world, Vec3(0.0f, 0.0f, 0.0f), Vec3(1.0f));
+		StepWorld(world);
+
+		Array<HitResult> hits;
+		SUORA_REQUIRE(world.RaycastAll(Vec3(0.0f, 0.0f, -10.0f), Vec3(0.0f, 0.0f, 20.0f), hits));
+		SUORA_REQUIRE(hits.Size() == 2);
+		SUORA_CHECK(hits[0].Shape == nearBox);
+		SUORA_CHECK(hits[1].Shape == farBox);
+		SUORA_CHECK(hits[0].Distance < hits[1].Distance);
+		SUORA_CHECK_NEAR(hits[1].Distance, 15.0f, 0.001f);
+	}
+
+	SUORA_TEST(PhysicsQuery, RaycastFiltersLayersAndIgnoredNodes)
+	{
+		World world;
+		BoxShapeNode* first = SpawnBox(world, Vec3(0.0f, 0.0f, 0.0f), Vec3(1.0f), true, 0);
+		BoxShapeNode* second = SpawnBox(world, Vec3(0.0f, 0.0f, 4.0f), Vec3(1.0f), true, 3);
+		BoxShapeNode* third = SpawnBox(world, Vec3(0.0f, 0.0f, 8.0f), Vec3(1.0f), true, 3);
+		StepWorld(world);
+
+		const Vec3 start = Vec3(0.0f, 0.0f, -10.0f);
+		const Vec3 end = Vec3(0.0f, 0.0f, 20.0f);
+		HitResult hit;
+
+		RaycastParams layerParams;
+		layerParams.LayerMask = 1u << 3;
+		SUORA_REQUIRE(world.Raycast(start, end, hit, layerParams));
+		SUORA_CHECK(hit.Shape == second);
+
+		RaycastParams ignoreParams;
+		ignoreParams.LayerMask = 1u << 3;
+		ignoreParams.IgnoredCollisionNodes.Add(second);
+		SUORA_REQUIRE(world.Raycast(start, end, hit, ignoreParams));
+		SUORA_CHECK(hit.Shape == third);
+
+		RaycastParams noLayers;
+		noLayers.LayerMask = 0;
+		SUORA_CHECK(!world.Raycast(start, end, hit, noLayers));
+
+		(void)first;
+	}
+
+	SUORA_TEST(PhysicsQuery, ShapeCastStopsAtContact)
+	{
+		World world;
+		BoxShapeNode* box = SpawnBox(world, Vec3(0.0f), Vec3(1.0f));
+		StepWorld(world);
+
+		ShapeCastQuery query;
+		query.Shape = QueryShape::Sphere(0.5f);
+		query.Start = Vec3(0.0f, 0.0f, -10.0f);
+		query.End = Vec3(0.0f, 0.0f, 10.0f);
+
+		HitResult hit;
+		SUORA_REQUIRE(world.ShapeCast(query, hit));
+		SUORA_CHECK(hit.Shape == box);
+		// The sphere touches the face at z = -1 after travelling 8.5, Jolt's convex radius allows a small slack
+		SUORA_CHECK_NEAR(hit.Distance, 8.5f, 0.06f);
+		SUORA_CHECK_NEAR(hit.Normal.z, -1.0f, 0.01f);
+
+		query.Start = Vec3(5.0f, 0.0f, -10.0f);
+		query.End = Vec3(5.0f, 0.0f, 10.0f);
+		SUORA_CHECK(!world.ShapeCast(query, hit));
+	}
+
+	SUORA_TEST(PhysicsQuery, OverlapReportsEveryShapeOnce)
+	{
+		World world;
+		BoxShapeNode* left = SpawnBox(world, Vec3(-1.5f, 0.0f, 0.0f), Vec3(1.0f));
+		SphereShapeNode* right = SpawnSphere(world, Vec3(1.5f, 0.0f, 0.0f), 1.0f);
+		SpawnBox(world, Vec3(20.0f, 0.0f, 0.0f), Vec3(1.0f));
+		StepWorld(world);
+
+		OverlapQuery query;
+		query.Shape = QueryShape::Box(Vec3(1.0f));
+		query.Position = Vec3(0.0f);
+
+		Array<ShapeNode*> results;
+		SUORA_REQUIRE(world.Overlap(query, results));
+		SUORA_CHECK_EQ(results.Size(), 2);
+		SUORA_CHECK(results.Contains(left));
+		SUORA_CHECK(results.Contains(right));
+
+		query.Position = Vec3(0.0f, 10.0f, 0.0f);
+		SUORA_CHECK(!world.Overlap(query, results));
+		SUORA_CHECK(results.IsEmpty());
+	}
+
+	SUORA_TEST(PhysicsQuery, BatchesMatchSingleQueries)
+	{
+		World world;
+		for (int32_t x = -5; x <= 5; x++)
+		{
+			for (int32_t z = -5; z <= 5; z++)
+			{
+				SpawnBox(world, Vec3(x * 4.0f, 0.0f, z * 4.0f), Vec3(1.0f));
+			}
+		}
+		StepWorld(world);
+
+		TestRandom random(42);
+		Array<RaycastQuery> rays;
+		Array<ShapeCastQuery> casts;
+		Array<OverlapQuery> overlaps;
+		for (int32_t i = 0; i < 500; i++)
+		{
+			RaycastQuery ray;
+			ray.Start = Vec3(random.Float(-25.0f, 25.0f), 10.0f, random.Float(-25.0f, 25.0f));
+			ray.End = Vec3(random.Float(-25.0f, 25.0f), -10.0f, random.Float(-25.0f, 25.0f));
+			rays.Add(ray);
+
+			ShapeCastQuery cast;
+			cast.Shape = QueryShape::Capsule(0.3f, 1.0f);
+			cast.Start = ray.Start;
+			cast.End = ray.End;
+			casts.Add(cast);
+
+			OverlapQuery overlap;
+			overlap.Shape = QueryShape::Sphere(random.Float(0.5f, 3.0f));
+			overlap.Position = Vec3(ray.Start.x, 0.0f, ray.Start.z);
+			overlaps.Add(overlap);
+		}
+
+		Array<HitResult> rayResults, castResults;
+		Array<Array<ShapeNode*>> overlapResults;
+		world.RaycastBatch(rays, rayResults);
+		world.ShapeCastBatch(casts, castResults);
+		world.OverlapBatch(overlaps, overlapResults);
+		SUORA_REQUIRE(rayResults.Size() == rays.Size() && castResults.Size() == casts.Size() && overlapResults.Size() == overlaps.Size());
+
+		for (int32_t i = 0; i < rays.Size(); i++)
+		{
+			HitResult single;
+			SUORA_CHECK_EQ(world.Raycast(rays[i].Start, rays[i].End, single), rayResults[i].Hit);
+			SUORA_CHECK(single.Shape == rayResults[i].Shape);
+			SUORA_CHECK_NEAR(single.Distance, rayResults[i].Distance, 0.0001f);
+
+			SUORA_CHECK_EQ(world.ShapeCast(casts[i], single), castResults[i].Hit);
+			SUORA_CHECK(single.Shape == castResults[i].Shape);
+
+			Array<ShapeNode*> overlap;
+			world.Overlap(overlaps[i], overlap);
+			SUORA_CHECK(overlap.GetData() == overlapResults[i].GetData());
+		}
+	}
+
+	SUORA_BENCHMARK(PhysicsQuery, LineOfSightThroughput)
+	{
+		World world;
+		TestRandom random(7);
+		for (int32_t i = 0; i < 10000; i++)
+		{
+			SpawnBox(world, Vec3(random.Float(-200.0f, 200.0f), random.Float(0.0f, 10.0f), random.Float(-200.0f, 200.0f)), Vec3(random.Float(0.5f, 2.0f)));
+		}
+		StepWorld(world);
+
+		// Agents checking the line of sight to each other, like the AI does every frame
+		constexpr int32_t rayCount = 50000;
+		Array<RaycastQuery> rays;
+		for (int32_t i = 0; i < rayCount; i++)
+		{
+			RaycastQuery ray;
+			ray.Start = Vec3(random.Float(-200.0f, 200.0f), 1.5f, random.Float(-200.0f, 200.0f));
+			ray.End = ray.Start + Vec3(random.Float(-40.0f, 40.0f), 0.0f, random.Float(-40.0f, 40.0f));
+			rays.Add(ray);
+		}
+
+		Array<HitResult> results;
+		const double batched = Benchmark("RaycastBatch, 50k rays", 10, [&]()
+		{
+			world.RaycastBatch(rays, results);
+		});
+		const double sequential = Benchmark("Raycast one by one, 50k rays", 10, [&]()
+		{
+			HitResult hit;
+			for (const RaycastQuery& ray : rays)
+			{
+				world.Raycast(ray.Start, ray.End, hit);
+			}
+		});
+		SuoraLog("  {0:.1f}M rays/s batched, {1:.2f}x faster than one by one", rayCount / batched / 1000.0, sequential / batched);
+	}
+
+}
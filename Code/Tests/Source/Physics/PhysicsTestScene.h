@@ -0,0 +1,39 @@
+#pragma once
+#include <Suora.h>
+#include "Suora/Physics/PhysicsWorld.h"
+
+namespace Suora::Tests
+{
+
+	constexpr float PhysicsTestTimeStep = 1.0f / 60.0f;
+
+	/** Bodies are created in Begin(), so spawned ShapeNodes only exist in the PhysicsWorld after the next World::Update */
+	inline void StepWorld(World& world, uint32_t steps = 1)
+	{
+		for (uint32_t i = 0; i < steps; i++)
+		{
+			world.Update(PhysicsTestTimeStep);
+		}
+	}
+
+	inline BoxShapeNode* SpawnBox(World& world, const Vec3& position, const Vec3& halfExtends, bool isStatic = true, int32_t collisionLayer = 0)
+	{
+		BoxShapeNode* box = world.Spawn<BoxShapeNode>();
+		box->m_HalfExtends = halfExtends;
+		box->m_IsStatic = isStatic;
+		box->m_CollisionLayer = collisionLayer;
+		box->SetPosition(position);
+		return box;
+	}
+
+	inline SphereShapeNode* SpawnSphere(World& world, const Vec3& position, float radius, bool isStatic = true, int32_t collisionLayer = 0)
+	{
+		SphereShapeNode* sphere = world.Spawn<SphereShapeNode>();
+		sphere->SetSphereRadius(radius);
+		sphere->m_IsStatic = isStatic;
+		sphere->m_CollisionLayer = collisionLayer;
+		sphere->SetPosition(position);
+		return sphere;
+	}
+
+}
@@ -0,0 +1,83 @@
+#include "Test.h"
+#include "PhysicsTestScene.h"
+
+namespace Suora::Tests
+{
+
+	SUORA_TEST(PhysicsWriteBack, InterpolatesBetweenSteps)
+	{
+		World world;
+		Physics::PhysicsWorld* physics = world.GetPhysicsWorld();
+		// Exactly representable, so the accumulator reaches a full step without rounding
+		physics->m_TimeStep = 1.0f / 64.0f;
+		physics->m_InterpolateTransforms = true;
+
+		SphereShapeNode* sphere = SpawnSphere(world, Vec3(0.0f, 100.0f, 0.0f), 0.5f, false);
+		world.Update(physics->m_TimeStep);
+		for (int32_t i = 0; i < 4; i++)
+		{
+			physics->Update(physics->m_TimeStep);
+		}
+
+		// Right after a Step the previous pose is shown, the accumulator is empty
+		const float previous = sphere->GetPosition().y;
+		physics->Update(physics->m_TimeStep / 2.0f);
+		const float halfway = sphere->GetPosition().y;
+		physics->Update(physics->m_TimeStep / 2.0f);
+		const float current = sphere->GetPosition().y;
+
+		SUORA_CHECK(previous > halfway);
+		SUORA_CHECK(halfway > current);
+		SUORA_CHECK_NEAR(halfway, (previous + current) / 2.0f, 0.0001f);
+
+		physics->m_InterpolateTransforms = false;
+		physics->Update(physics->m_TimeStep / 2.0f);
+		SUORA_CHECK(sphere->GetPosition().y < current);
+	}
+
+	SUORA_BENCHMARK(PhysicsWriteBack, FiftyThousandMostlySleepingBodies)
+	{
+		World world;
+		Physics::PhysicsWorld* physics = world.GetPhysicsWorld();
+
+		SpawnBox(world, Vec3(0.0f, -1.0f, 0.0f), Vec3(500.0f, 1.0f, 500.0f));
+
+		// 49k boxes resting on the ground, spaced so they do not touch each other
+		constexpr int32_t restingPerSide = 222;
+		for (int32_t x = 0; x < restingPerSide; x++)
+		{
+			for (int32_t z = 0; z < restingPerSide && x * restingPerSide + z < 49000; z++)
+			{
+				SpawnBox(world, Vec3(x * 4.0f - 440.0f, 0.5f, z * 4.0f - 440.0f), Vec3(0.5f), false);
+			}
+		}
+		StepWorld(world);
+
+		// Until the resting boxes fell asleep
+		for (int32_t i = 0; i < 180; i++)
+		{
+			physics->Update(PhysicsTestTimeStep);
+		}
+		SUORA_CHECK(physics->GetStats().ActiveBodyCount < 100);
+
+		// 1k boxes falling from high up stay active for the whole measurement
+		TestRandom random(34);
+		for (int32_t i = 0; i < 1000; i++)
+		{
+			SpawnBox(world, Vec3(random.Float(-400.0f, 400.0f), random.Float(200.0f, 400.0f), random.Float(-400.0f, 400.0f)), Vec3(0.5f), false);
+		}
+		StepWorld(world);
+
+		double simulationMs = 0.0;
+		const double frameMs = Benchmark("PhysicsWorld::Update, 50k bodies, 1k active", 120, [&]()
+		{
+			physics->Update(PhysicsTestTimeStep);
+			simulationMs += physics->GetStats().SimulationTimeMs;
+		});
+		simulationMs /= 121.0;
+
+		SUORA_CHECK(physics->GetStats().ActiveBodyCount >= 1000);
+		SuoraLog("  {0} bodies, {1} active. Simulation {2:.3f} ms, write-back and bookkeeping {3:.3f} ms per frame", physics->GetStats().BodyCount, physics->GetStats().ActiveBodyCount, simulationMs, frameMs - simulationMs);
+	}
+
+}
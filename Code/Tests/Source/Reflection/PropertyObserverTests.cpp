@@ -0,0 +1,193 @@
+#include "Test.h"
+#include "Suora/Core/Object/Object.h"
+#include "Suora/GameFramework/Nodes/Light/DirectionalLightNode.h"
+#include "Suora/Reflection/ClassReflector.h"
+#include "Suora/Reflection/Property.h"
+#include "Suora/Reflection/PropertyObserver.h"
+
+namespace Suora::Tests
+{
+
+	/** Not reflected, so the indices are spelled out. The last one lies in the second word of the dirty bits. */
+	class ObservedTestObject : public Object
+	{
+	public:
+		enum : uint32_t { ValueIndex = 0, NameIndex = 1, FarIndex = 70 };
+
+		int32_t m_Value = 0;
+		String m_Name;
+
+		void SetValue(int32_t value) { SetProperty(m_Value, value, ValueIndex); }
+		void SetName(const String& name) { SetProperty(m_Name, name, NameIndex); }
+	};
+
+	static bool IsMember(const Array<Ref<ClassMemberProperty>>& members, uint32_t index, const String& name)
+	{
+		return index < (uint32_t)members.Size() && members[index]->m_MemberName == name;
+	}
+
+	SUORA_TEST(PropertyObserver, PropertyIndicesMatchReflectionOrder)
+	{
+		// DirectionalLightNode continues the indices of LightNode, which declares properties as well
+		const Array<Ref<ClassMemberProperty>> members = ClassReflector::GetByClass(DirectionalLightNode::StaticClass()).GetAllClassMemberProperties();
+		SUORA_CHECK_EQ((uint32_t)members.Size(), (uint32_t)DirectionalLightNode::PropertyIndex::PropertyCount);
+
+		SUORA_CHECK(IsMember(members, DirectionalLightNode::PropertyIndex::m_Intensity, "m_Intensity"));
+		SUORA_CHECK(IsMember(members, DirectionalLightNode::PropertyIndex::m_ShadowMap, "m_ShadowMap"));
+		SUORA_CHECK(IsMember(members, DirectionalLightNode::PropertyIndex::m_Color, "m_Color"));
+		SUORA_CHECK(IsMember(members, DirectionalLightNode::PropertyIndex::m_Radius, "m_Radius"));
+		SUORA_CHECK(IsMember(members, DirectionalLightNode::PropertyIndex::m_SoftShadows, "m_SoftShadows"));
+		SUORA_CHECK(IsMember(members, DirectionalLightNode::PropertyIndex::m_ShadowDistance, "m_ShadowDistance"));
+
+		// The indices of the Super are the same in both classes
+		SUORA_CHECK_EQ((uint32_t)DirectionalLightNode::PropertyIndex::m_Color, (uint32_t)LightNode::PropertyIndex::PropertyCount);
+		const Array<Ref<ClassMemberProperty>> superMembers = ClassReflector::GetByClass(LightNode::StaticClass()).GetAllClassMemberProperties();
+		SUORA_REQUIRE((uint32_t)superMembers.Size() == LightNode::PropertyIndex::PropertyCount);
+		for (int32_t i = 0; i < superMembers.Size(); i++)
+		{
+			SUORA_CHECK_EQ(members[i]->m_MemberName, superMembers[i]->m_MemberName);
+			SUORA_CHECK_EQ(members[i]->m_MemberOffset, superMembers[i]->m_MemberOffset);
+		}
+	}
+
+	SUORA_TEST(PropertyObserver, CollectChangesClearsDirtyBits)
+	{
+		Array<PropertyChangeSet> changes;
+		PropertyObserver::CollectChanges(changes);
+		changes.Clear();
+
+		ObservedTestObject unobserved;
+		unobserved.SetValue(1);
+		SUORA_CHECK_EQ(unobserved.m_Value, 1);
+		SUORA_CHECK(!PropertyObserver::IsPropertyDirty(&unobserved, ObservedTestObject::ValueIndex));
+
+		ObservedTestObject a, b;
+		PropertyObserver::Observe(&a);
+		PropertyObserver::Observe(&b);
+		a.MarkPropertyDirty(ObservedTestObject::FarIndex);
+		a.SetName("Changed");
+		a.SetValue(5);
+		b.SetValue(7);
+		SUORA_CHECK(PropertyObserver::IsPropertyDirty(&a, ObservedTestObject::FarIndex));
+		SUORA_CHECK(PropertyObserver::IsPropertyDirty(&a, ObservedTestObject::ValueIndex));
+		SUORA_CHECK(!PropertyObserver::IsPropertyDirty(&b, ObservedTestObject::NameIndex));
+
+		// One set per Object in the order of their first change, the properties ascending
+		PropertyObserver::CollectChanges(changes);
+		SUORA_REQUIRE(changes.Size() == 2);
+		SUORA_CHECK(changes[0].ChangedObject == &a);
+		SUORA_CHECK(changes[0].Properties.GetData() == std::vector<uint32_t>({ ObservedTestObject::ValueIndex, ObservedTestObject::NameIndex, ObservedTestObject::FarIndex }));
+		SUORA_CHECK(changes[1].ChangedObject == &b);
+		SUORA_CHECK(changes[1].Properties.GetData() == std::vector<uint32_t>({ ObservedTestObject::ValueIndex }));
+
+		SUORA_CHECK(!PropertyObserver::IsPropertyDirty(&a, ObservedTestObject::FarIndex));
+		SUORA_CHECK(!PropertyObserver::IsPropertyDirty(&a, ObservedTestObject::ValueIndex));
+		changes.Clear();
+		PropertyObserver::CollectChanges(changes);
+		SUORA_CHECK(changes.Size() == 0);
+
+		// Writing the value it already has is no change
+		a.SetValue(5);
+		a.SetName("Changed");
+		PropertyObserver::CollectChanges(changes);
+		SUORA_CHECK(changes.Size() == 0);
+
+		// Neither are cleared or unobserved Objects
+		a.SetValue(6);
+		PropertyObserver::ClearDirty(&a);
+		b.SetValue(8);
+		PropertyObserver::Unobserve(&b);
+		SUORA_CHECK(!PropertyObserver::IsObserved(&b));
+		PropertyObserver::CollectChanges(changes);
+		SUORA_CHECK(changes.Size() == 0);
+
+		// Destroying an Object takes it out of the pending changes
+		{
+			ObservedTestObject destroyed;
+			PropertyObserver::Observe(&destroyed);
+			destroyed.SetValue(1);
+		}
+		PropertyObserver::CollectChanges(changes);
+		SUORA_CHECK(changes.Size() == 0);
+	}
+
+	SUORA_TEST(PropertyObserver, CallbacksSeeEveryChange)
+	{
+		ObservedTestObject obj;
+		std::vector<std::pair<Object*, uint32_t>> calls;
+		const uint64_t handle = PropertyObserver::AddCallback(&obj, [&calls](Object* changed, uint32_t propertyIndex) { calls.push_back({ changed, propertyIndex }); });
+		SUORA_CHECK(PropertyObserver::IsObserved(&obj));
+
+		// Called for every change, not only for the first one until the next CollectChanges()
+		obj.SetValue(1);
+		obj.SetValue(2);
+		obj.SetValue(2);
+		obj.SetName("Name");
+		SUORA_REQUIRE(calls.size() == 3);
+		SUORA_CHECK(calls[0] == std::make_pair((Object*)&obj, (uint32_t)ObservedTestObject::ValueIndex));
+		SUORA_CHECK(calls[1] == std::make_pair((Object*)&obj, (uint32_t)ObservedTestObject::ValueIndex));
+		SUORA_CHECK(calls[2] == std::make_pair((Object*)&obj, (uint32_t)ObservedTestObject::NameIndex));
+
+		// A callback may write properties itself
+		const uint64_t mirror = PropertyObserver::AddCallback(&obj, [&obj](Object* changed, uint32_t propertyIndex)
+		{
+			if (propertyIndex == ObservedTestObject::ValueIndex) obj.SetName(std::to_string(obj.m_Value));
+		});
+		obj.SetValue(3);
+		SUORA_CHECK_EQ(obj.m_Name, String("3"));
+
+		PropertyObserver::RemoveCallback(&obj, handle);
+		PropertyObserver::RemoveCallback(&obj, mirror);
+		calls.clear();
+		obj.SetValue(4);
+		SUORA_CHECK(calls.empty());
+
+		Array<PropertyChangeSet> changes;
+		PropertyObserver::CollectChanges(changes);
+	}
+
+	SUORA_BENCHMARK(PropertyObserver, SetProperty)
+	{
+		constexpr size_t objectCount = 1000;
+		std::vector<ObservedTestObject> objects(objectCount), observed(objectCount), withCallback(objectCount);
+		uint64_t callbacks = 0;
+		for (size_t i = 0; i < objectCount; i++)
+		{
+			PropertyObserver::Observe(&observed[i]);
+			PropertyObserver::AddCallback(&withCallback[i], [&callbacks](Object*, uint32_t) { callbacks++; });
+		}
+
+		// Every write changes the value, so observed Objects never take the early out
+		int32_t value = 0;
+		Array<PropertyChangeSet> changes;
+		Benchmark("Plain store, 1000 Objects", 1000, [&]()
+		{
+			value++;
+			for (ObservedTestObject& obj : objects) obj.m_Value = value;
+		});
+		Benchmark("SetProperty, unobserved, 1000 Objects", 1000, [&]()
+		{
+			value++;
+			for (ObservedTestObject& obj : objects) obj.SetValue(value);
+		});
+		Benchmark("SetProperty, observed, 1000 Objects", 1000, [&]()
+		{
+			value++;
+			for (ObservedTestObject& obj : observed) obj.SetValue(value);
+			changes.Clear();
+			PropertyObserver::CollectChanges(changes);
+		});
+		Benchmark("SetProperty, observed with callback, 1000 Objects", 1000, [&]()
+		{
+			value++;
+			for (ObservedTestObject& obj : withCallback) obj.SetValue(value);
+			changes.Clear();
+			PropertyObserver::CollectChanges(changes);
+		});
+
+		SUORA_CHECK_EQ(withCallback.back().m_Value, value);
+		SUORA_CHECK_EQ(callbacks, (uint64_t)objectCount * 1001);
+		SuoraLog("  {0} changed Objects in the last CollectChanges()", changes.Size());
+	}
+
+}
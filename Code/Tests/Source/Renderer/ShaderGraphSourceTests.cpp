@@ -0,0 +1,260 @@
+#include "Test.h"
+#include "Suora/Assets/ShaderGraph.h"
+#include "Suora/NodeScript/ShaderNodeGraph.h"
+
+namespace Suora::Tests
+{
+
+	/** Builds ShaderNodeGraphs by hand, with the pins of the Nodes that ShaderNodeGraph supports */
+	struct TestShaderNodeGraph
+	{
+		Array<Ref<VisualNode>> Nodes;
+		VisualNode* Master = nullptr;
+
+		TestShaderNodeGraph(const ShaderGraphTemplate& baseShader)
+		{
+			Master = &AddNode(1);
+			for (const BaseShaderInput& input : baseShader.Inputs)
+			{
+				Master->AddInputPin(input.m_Label, Vec4(1.0f), (int64_t)input.m_Type, true);
+			}
+		}
+		VisualNode& AddNode(int64_t nodeID)
+		{
+			Nodes.Add(CreateRef<VisualNode>());
+			Nodes[Nodes.Last()]->m_NodeID = nodeID;
+			return *Nodes[Nodes.Last()];
+		}
+		VisualNode& AddUniform(const String& name)
+		{
+			VisualNode& node = AddNode(2);
+			node.AddInputPin("Name", Vec4(1.0f), 0, false);
+			node.m_InputPins[0].m_AdditionalData = name;
+			node.AddOutputPin("Uniform", Vec4(1.0f), 0, false);
+			return node;
+		}
+		VisualNode& AddUV()
+		{
+			VisualNode& node = AddNode(103);
+			node.AddOutputPin("Vec2", Vec4(1.0f), (int64_t)ShaderGraphDataType::Vec2, false);
+			return node;
+		}
+		VisualNode& AddSampleTexture(VisualNode& texture, VisualNode& uv)
+		{
+			VisualNode& node = AddNode(102);
+			node.AddInputPin("Texture2D", Vec4(1.0f), (int64_t)ShaderGraphDataType::Texture2D, true);
+			node.AddInputPin("UV", Vec4(1.0f), (int64_t)ShaderGraphDataType::Vec2, true);
+			node.AddOutputPin("RGBA", Vec4(1.0f), (int64_t)ShaderGraphDataType::Vec4, false);
+			node.AddOutputPin("RGB", Vec4(1.0f), (int64_t)ShaderGraphDataType::Vec3, false);
+			for (const char* channel : { "R", "G", "B", "A" })
+			{
+				node.AddOutputPin(channel, Vec4(1.0f), (int64_t)ShaderGraphDataType::Float, false);
+			}
+			node.m_InputPins[0].Target = &texture.m_OutputPins[0];
+			node.m_InputPins[1].Target = &uv.m_OutputPins[0];
+			return node;
+		}
+		VisualNode& AddVec3(VisualNodePin& x, VisualNodePin& y, VisualNodePin& z)
+		{
+			VisualNode& node = AddNode(100);
+			for (const char* label : { "X", "Y", "Z" })
+			{
+				node.AddInputPin(label, Vec4(1.0f), (int64_t)ShaderGraphDataType::Float, true);
+			}
+			node.AddOutputPin("Vec3", Vec4(1.0f), (int64_t)ShaderGraphDataType::Vec3, false);
+			node.m_InputPins[0].Target = &x;
+			node.m_InputPins[1].Target = &y;
+			node.m_InputPins[2].Target = &z;
+			return node;
+		}
+		void Connect(const String& masterPin, VisualNodePin& output)
+		{
+			for (VisualNodePin& pin : Master->m_InputPins)
+			{
+				if (pin.Label == masterPin) pin.Target = &output;
+			}
+		}
+	};
+
+	/** Samples the red channel of u_Albedo once and feeds it into the Base Color and the Opacity */
+	static String GenerateSharedSampleSource(const String& baseShaderSource)
+	{
+		Ref<ShaderGraphTemplate> baseShader = ShaderGraphTemplate::Parse(baseShaderSource);
+		TestShaderNodeGraph graph(*baseShader);
+
+		VisualNode& albedo = graph.AddUniform("u_Albedo");
+		VisualNode& sample = graph.AddSampleTexture(albedo, graph.AddUV());
+		VisualNodePin& red = sample.m_OutputPins[2];
+		graph.Connect("Base Color", graph.AddVec3(red, red, red).m_OutputPins[0]);
+		graph.Connect("Opacity", red);
+
+		String source;
+		SUORA_CHECK(ShaderGraph::GenerateSource(*baseShader, graph.Master, "uniform sampler2D u_Albedo;\n", source));
+		return source;
+	}
+
+	static const char* s_TestVertexStage = "\
+#type vertex\n\
+#version 330 core\n\
+layout(location = 0) in vec3 a_Position;\n\
+$VERT_INPUTS\n\
+void main(void)\n\
+{\n\
+	vec3 offset = $VERT_INPUT(\"Offset\", vec3, { vec3(0.0) });\n\
+	gl_Position = vec4(a_Position + offset, 1.0);\n\
+}\n";
+
+	static const char* s_GeneratedTestVertexStage = "\
+#type vertex\n\
+#version 330 core\n\
+layout(location = 0) in vec3 a_Position;\n\
+uniform sampler2D u_Albedo;\n\
+\n\
+void main(void)\n\
+{\n\
+	vec3 offset =  vec3(0.0);\n\
+	gl_Position = vec4(a_Position + offset, 1.0);\n\
+}\n";
+
+	SUORA_TEST(ShaderGraphSource, TemplateTracksBlocksAndStatements)
+	{
+		Ref<ShaderGraphTemplate> baseShader = ShaderGraphTemplate::Parse(String(s_TestVertexStage) + "\
+#type fragment\n\
+#version 330 core\n\
+out vec4 out_Color;\n\
+$FRAG_INPUTS\n\
+void main(void)\n\
+{\n\
+	out_Color = vec4($FRAG_INPUT(\"Base Color\", vec3, { vec3(1.0) }), $FRAG_INPUT(\"Opacity\", float, { 1.0 }));\n\
+}\n");
+
+		SUORA_REQUIRE(baseShader->Inputs.Size() == 3);
+		SUORA_CHECK_EQ(baseShader->Inputs[0].m_Label, String("Offset"));
+		SUORA_CHECK(baseShader->Inputs[0].m_InVertexShader);
+		SUORA_CHECK_EQ(baseShader->BlockParents.Size(), 2);
+
+		Array<const ShaderGraphTemplate::Token*> inputs;
+		for (const ShaderGraphTemplate::Token& token : baseShader->Tokens)
+		{
+			if (token.Type == ShaderGraphTemplate::TokenType::VertexInput || token.Type == ShaderGraphTemplate::TokenType::FragmentInput) inputs.Add(&token);
+		}
+		SUORA_REQUIRE(inputs.Size() == 3);
+		SUORA_CHECK_EQ(inputs[0]->Block, 0);
+		SUORA_CHECK_EQ(inputs[1]->Block, 1);
+		// Both fragment inputs are part of the same statement, so they share its temporaries
+		SUORA_CHECK(inputs[0]->Temporaries != -1);
+		SUORA_CHECK(inputs[1]->Temporaries != -1 && inputs[1]->Temporaries != inputs[0]->Temporaries);
+		SUORA_CHECK_EQ(inputs[2]->Temporaries, inputs[1]->Temporaries);
+		SUORA_CHECK(baseShader->Tokens[inputs[1]->Temporaries].Type == ShaderGraphTemplate::TokenType::Temporaries);
+	}
+
+	SUORA_TEST(ShaderGraphSource, TemporariesFollowLocalsOfNestedBlocks)
+	{
+		// Like DeferredDecal.glsl, UV is a local of a nested block and not declared at the start of main()
+		const String source = GenerateSharedSampleSource(String(s_TestVertexStage) + "\
+#type fragment\n\
+#version 330 core\n\
+in vec2 PassUV;\n\
+out vec4 out_Color;\n\
+$FRAG_INPUTS\n\
+void main(void)\n\
+{\n\
+	if (PassUV.x > 0.5)\n\
+	{\n\
+		vec2 UV = PassUV * 2.0;\n\
+		vec3 baseColor = $FRAG_INPUT(\"Base Color\", vec3, { vec3(1.0) });\n\
+		float opacity = $FRAG_INPUT(\"Opacity\", float, { 1.0 });\n\
+		out_Color = vec4(baseColor, opacity);\n\
+	}\n\
+}\n");
+
+		SUORA_CHECK_EQ(source, String(s_GeneratedTestVertexStage) + "\
+#type fragment\n\
+#version 330 core\n\
+in vec2 PassUV;\n\
+out vec4 out_Color;\n\
+uniform sampler2D u_Albedo;\n\
+\n\
+void main(void)\n\
+{\n\
+	if (PassUV.x > 0.5)\n\
+	{\n\
+		vec2 UV = PassUV * 2.0;\n\
+	float sg_Temp0 = (texture((u_Albedo), UV).x);\n\
+		vec3 baseColor = vec3(sg_Temp0, sg_Temp0, sg_Temp0);\n\
+		float opacity = sg_Temp0;\n\
+		out_Color = vec4(baseColor, opacity);\n\
+	}\n\
+}\n");
+	}
+
+	SUORA_TEST(ShaderGraphSource, SiblingBlocksDoNotShareTemporaries)
+	{
+		const String source = GenerateSharedSampleSource(String(s_TestVertexStage) + "\
+#type fragment\n\
+#version 330 core\n\
+in vec2 UV;\n\
+out vec4 out_Color;\n\
+$FRAG_INPUTS\n\
+void main(void)\n\
+{\n\
+	if (UV.x > 0.5)\n\
+	{\n\
+		out_Color = vec4($FRAG_INPUT(\"Base Color\", vec3, { vec3(1.0) }), 1.0);\n\
+	}\n\
+	else\n\
+	{\n\
+		out_Color = vec4(vec3($FRAG_INPUT(\"Opacity\", float, { 1.0 })), 1.0);\n\
+	}\n\
+}\n");
+
+		SUORA_CHECK_EQ(source, String(s_GeneratedTestVertexStage) + "\
+#type fragment\n\
+#version 330 core\n\
+in vec2 UV;\n\
+out vec4 out_Color;\n\
+uniform sampler2D u_Albedo;\n\
+\n\
+void main(void)\n\
+{\n\
+	if (UV.x > 0.5)\n\
+	{\n\
+		out_Color = vec4(vec3((texture((u_Albedo), UV).x), (texture((u_Albedo), UV).x), (texture((u_Albedo), UV).x)), 1.0);\n\
+	}\n\
+	else\n\
+	{\n\
+		out_Color = vec4(vec3((texture((u_Albedo), UV).x)), 1.0);\n\
+	}\n\
+}\n");
+	}
+
+	SUORA_TEST(ShaderGraphSource, InputsOfOneStatementShareItsTemporaries)
+	{
+		const String source = GenerateSharedSampleSource(String(s_TestVertexStage) + "\
+#type fragment\n\
+#version 330 core\n\
+in vec2 UV;\n\
+out vec4 out_Color;\n\
+$FRAG_INPUTS\n\
+void main(void)\n\
+{\n\
+	float alphaClip = 0.05;\n\
+	out_Color = vec4($FRAG_INPUT(\"Base Color\", vec3, { vec3(1.0) }), max($FRAG_INPUT(\"Opacity\", float, { 1.0 }), alphaClip));\n\
+}\n");
+
+		SUORA_CHECK_EQ(source, String(s_GeneratedTestVertexStage) + "\
+#type fragment\n\
+#version 330 core\n\
+in vec2 UV;\n\
+out vec4 out_Color;\n\
+uniform sampler2D u_Albedo;\n\
+\n\
+void main(void)\n\
+{\n\
+	float alphaClip = 0.05;\n\
+	float sg_Temp0 = (texture((u_Albedo), UV).x);\n\
+	out_Color = vec4(vec3(sg_Temp0, sg_Temp0, sg_Temp0), max(sg_Temp0, alphaClip));\n\
+}\n");
+	}
+
+}
@@ -0,0 +1,118 @@
+#include "Test.h"
+#include "Suora/Assets/Material.h"
+#include "Suora/Renderer/ShaderCache.h"
+#include "Suora/Renderer/ShaderPermutation.h"
+
+namespace Suora::Tests
+{
+
+	static const char* s_TestShaderGraphSource = "\
+#type vertex\n\
+#version 330 core\n\
+layout (location = 0) in vec3 a_Position;\n\
+void main()\n\
+{\n\
+	gl_Position = vec4(a_Position, 1.0);\n\
+}\n\
+#type fragment\n\
+#version 330 core\n\
+out vec4 out_Color;\n\
+void main()\n\
+{\n\
+	out_Color = vec4(0.5);\n\
+}\n";
+
+	SUORA_TEST(ShaderPermutation, KeysDependOnBothSources)
+	{
+		SUORA_CHECK_EQ(ShaderPermutation::MakeKey("vertex", "fragment"), ShaderPermutation::MakeKey("vertex", "fragment"));
+		SUORA_CHECK(ShaderPermutation::MakeKey("vertex", "fragment") != ShaderPermutation::MakeKey("vertex", "fragment2"));
+		SUORA_CHECK(ShaderPermutation::MakeKey("vertex", "fragment") != ShaderPermutation::MakeKey("vertex2", "fragment"));
+		// The same characters split differently between the stages
+		SUORA_CHECK(ShaderPermutation::MakeKey("ab", "c") != ShaderPermutation::MakeKey("a", "bc"));
+	}
+
+	SUORA_TEST(ShaderPermutation, EnumeratesAllMaterialTypes)
+	{
+		SUORA_CHECK(ShaderPermutation::EnumerateShaderGraph("Empty", "").IsEmpty());
+
+		const Array<ShaderPermutation> permutations = ShaderPermutation::EnumerateShaderGraph("TestGraph", s_TestShaderGraphSource);
+		SUORA_REQUIRE(permutations.Size() == 4);
+		SUORA_CHECK(permutations[0].Type == MaterialType::Material);
+		SUORA_CHECK(permutations[1].Type == MaterialType::Depth);
+		SUORA_CHECK(permutations[2].Type == MaterialType::FlatWhite);
+		SUORA_CHECK(permutations[3].Type == MaterialType::ObjectID);
+		SUORA_CHECK_EQ(permutations[0].Name, String("TestGraph"));
+
+		SUORA_CHECK(permutations[0].FragmentSource.find("out_Color = vec4(0.5);") != String::npos);
+		SUORA_CHECK(permutations[0].FragmentSource.find("#type") == String::npos);
+		for (int32_t i = 0; i < permutations.Size(); i++)
+		{
+			// The vertex stage is shared, only the fragment stage differs
+			SUORA_CHECK_EQ(permutations[i].VertexSource, permutations[0].VertexSource);
+			SUORA_CHECK(permutations[i].VertexSource.find("gl_Position") != String::npos);
+			SUORA_CHECK_EQ(permutations[i].Key, ShaderPermutation::MakeKey(permutations[i].VertexSource, permutations[i].FragmentSource));
+			for (int32_t j = 0; j < i; j++)
+			{
+				SUORA_CHECK(permutations[i].Key != permutations[j].Key);
+			}
+		}
+
+		// Stable keys are what lets the program binary cache hit across runs
+		const Array<ShaderPermutation> again = ShaderPermutation::EnumerateShaderGraph("TestGraph", s_TestShaderGraphSource);
+		for (int32_t i = 0; i < permutations.Size(); i++)
+		{
+			SUORA_CHECK_EQ(again[i].Key, permutations[i].Key);
+		}
+	}
+
+	SUORA_TEST(ShaderCache, ReleasedPermutationsAreEvicted)
+	{
+		// The headless Application has no GraphicsContext, so nothing is compiled and only the bookkeeping runs
+		ShaderPermutation permutation;
+		permutation.VertexSource = "ShaderCacheTests vertex";
+		permutation.FragmentSource = "ShaderCacheTests fragment";
+		permutation.Key = ShaderPermutation::MakeKey(permutation.VertexSource, permutation.FragmentSource);
+
+		const size_t entries = ShaderCache::GetEntryCount();
+		const uint64_t evicted = ShaderCache::GetStats().Evicted;
+
+		// Two ShaderGraphs generated the same permutation
+		ShaderCache::Prepare(permutation);
+		ShaderCache::Prepare(permutation);
+		SUORA_CHECK_EQ(ShaderCache::GetEntryCount(), entries + 1);
+
+		ShaderCache::Release(permutation.Key);
+		SUORA_CHECK_EQ(ShaderCache::GetEntryCount(), entries + 1);
+		ShaderCache::Release(permutation.Key);
+		SUORA_CHECK_EQ(ShaderCache::GetEntryCount(), entries);
+		SUORA_CHECK_EQ(ShaderCache::GetStats().Evicted, evicted + 1);
+
+		// Releasing too often must not touch other entries
+		ShaderCache::Release(permutation.Key);
+		SUORA_CHECK_EQ(ShaderCache::GetEntryCount(), entries);
+	}
+
+	SUORA_TEST(ShaderCache, RegeneratedSourcesDoNotAccumulate)
+	{
+		const size_t entries = ShaderCache::GetEntryCount();
+
+		// What ShaderGraph::UpdatePermutations does on every edit
+		Array<ShaderPermutation> current;
+		for (int32_t edit = 0; edit < 50; edit++)
+		{
+			String source = s_TestShaderGraphSource;
+			source += "// Edit " + std::to_string(edit) + "\n";
+
+			Array<ShaderPermutation> previous = std::move(current);
+			current = ShaderPermutation::EnumerateShaderGraph("TestGraph", source);
+			for (const ShaderPermutation& permutation : current) ShaderCache::Prepare(permutation);
+			for (const ShaderPermutation& permutation : previous) ShaderCache::Release(permutation.Key);
+		}
+		// The edit lands in the fragment stage, so only the four permutations of the last edit remain
+		SUORA_CHECK_EQ(ShaderCache::GetEntryCount(), entries + 4);
+
+		for (const ShaderPermutation& permutation : current) ShaderCache::Release(permutation.Key);
+		SUORA_CHECK_EQ(ShaderCache::GetEntryCount(), entries);
+	}
+
+}
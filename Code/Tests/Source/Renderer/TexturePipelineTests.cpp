@@ -0,0 +1,230 @@
+#include "Test.h"
+#include <filesystem>
+#include <fstream>
+#include "Suora/Common/VectorUtils.h"
+#include "Suora/Renderer/TexturePipeline.h"
+
+namespace Suora::Tests
+{
+
+	/** Smooth gradients with a little noise, like a photo. Alpha is a gradient as well, so BC3 and BC7 have something to store. */
+	static std::vector<uint8_t> MakeTestImage(uint32_t width, uint32_t height, uint32_t seed)
+	{
+		TestRandom random(seed);
+		std::vector<uint8_t> rgba((size_t)width * height * 4);
+		for (uint32_t y = 0; y < height; y++)
+		{
+			for (uint32_t x = 0; x < width; x++)
+			{
+				const float u = (float)x / (float)width, v = (float)y / (float)height;
+				uint8_t* pixel = &rgba[((size_t)y * width + x) * 4];
+				pixel[0] = (uint8_t)glm::clamp(255.0f * u + random.Float(-4.0f, 4.0f), 0.0f, 255.0f);
+				pixel[1] = (uint8_t)glm::clamp(255.0f * v + random.Float(-4.0f, 4.0f), 0.0f, 255.0f);
+				pixel[2] = (uint8_t)glm::clamp(127.5f + 127.5f * std::sin(6.0f * (u + v)) + random.Float(-4.0f, 4.0f), 0.0f, 255.0f);
+				pixel[3] = (uint8_t)(255.0f * (1.0f - v));
+			}
+		}
+		return rgba;
+	}
+
+	static float EncodeDecodePSNR(const std::vector<uint8_t>& rgba, uint32_t width, uint32_t height, ETextureFormat format, uint32_t channels)
+	{
+		const std::vector<uint8_t> encoded = TexturePipeline::Encode(rgba.data(), width, height, format);
+		SUORA_CHECK_EQ(encoded.size(), TexturePipeline::GetMipSize(format, width, height));
+		const std::vector<uint8_t> decoded = TexturePipeline::Decode(encoded.data(), width, height, format);
+		SUORA_CHECK_EQ(decoded.size(), rgba.size());
+		return TexturePipeline::ComputePSNR(rgba.data(), decoded.data(), width, height, channels);
+	}
+
+	/** Stores the RGB channels as a binary PPM in the temp directory, which the TextureBuffer_stbi can read */
+	static std::filesystem::path WriteTestImage(const String& name, const std::vector<uint8_t>& rgba, uint32_t width, uint32_t height)
+	{
+		const std::filesystem::path path = std::filesystem::temp_directory_path() / (name + ".ppm");
+		std::ofstream file(path, std::ios::binary);
+		file << "P6\n" << width << " " << height << "\n255\n";
+		for (size_t i = 0; i < (size_t)width * height; i++)
+		{
+			file.write((const char*)&rgba[i * 4], 3);
+		}
+		return path;
+	}
+
+	SUORA_TEST(TexturePipeline, BlockFormatsKeepTheirQuality)
+	{
+		// Not a multiple of four, so the partial blocks at the borders are covered as well
+		constexpr uint32_t width = 130, height = 67;
+		const std::vector<uint8_t> rgba = MakeTestImage(width, height, 29);
+
+		const float bc1 = EncodeDecodePSNR(rgba, width, height, ETextureFormat::BC1, 3);
+		const float bc3 = EncodeDecodePSNR(rgba, width, height, ETextureFormat::BC3, 4);
+		const float bc5 = EncodeDecodePSNR(rgba, width, height, ETextureFormat::BC5, 2);
+		const float bc7 = EncodeDecodePSNR(rgba, width, height, ETextureFormat::BC7, 4);
+		SuoraLog("  PSNR BC1 {0:.2f} dB, BC3 {1:.2f} dB, BC5 {2:.2f} dB, BC7 {3:.2f} dB", bc1, bc3, bc5, bc7);
+
+		SUORA_CHECK(bc1 > 35.0f);
+		SUORA_CHECK(bc3 > 36.0f);
+		SUORA_CHECK(bc5 > 45.0f);
+		SUORA_CHECK(bc7 > 39.0f);
+		// BC7 interpolates with more weights and in all four channels
+		SUORA_CHECK(bc7 > bc1);
+	}
+
+	SUORA_TEST(TexturePipeline, CookMeasuresQualityOnlyWhenAsked)
+	{
+		const std::filesystem::path path = WriteTestImage("TexturePipelineTests_Cook", MakeTestImage(256, 128, 7), 256, 128);
+		{
+			TextureBuffer_stbi source(path.string());
+			TextureCookSettings settings;
+			settings.Compression = ETextureCompression::BC1;
+
+			TextureCookStats measured;
+			TexturePipeline::s_MeasureQuality = true;
+			SUORA_CHECK(TexturePipeline::Cook(source, settings, &measured));
+			TexturePipeline::s_MeasureQuality = false;
+			TextureCookStats unmeasured;
+			SUORA_CHECK(TexturePipeline::Cook(source, settings, &unmeasured));
+
+			SUORA_CHECK(measured.PSNR > 30.0f);
+			SUORA_CHECK_EQ(unmeasured.PSNR, 0.0f);
+			SUORA_CHECK_EQ(unmeasured.CookedSize, measured.CookedSize);
+		}
+		std::filesystem::remove(path);
+	}
+
+	SUORA_TEST(TexturePipeline, UncompressedFormatsAreLossless)
+	{
+		constexpr uint32_t width = 17, height = 9;
+		const std::vector<uint8_t> rgba = MakeTestImage(width, height, 3);
+
+		SUORA_CHECK_EQ(EncodeDecodePSNR(rgba, width, height, ETextureFormat::RGBA8, 4), 99.0f);
+		SUORA_CHECK_EQ(EncodeDecodePSNR(rgba, width, height, ETextureFormat::RGB8, 3), 99.0f);
+		SUORA_CHECK_EQ(EncodeDecodePSNR(rgba, width, height, ETextureFormat::R8, 1), 99.0f);
+	}
+
+	SUORA_TEST(TexturePipeline, SolidBlocksDecodeToTheirColor)
+	{
+		uint8_t pixels[64];
+		for (int32_t i = 0; i < 16; i++)
+		{
+			pixels[i * 4 + 0] = 200; pixels[i * 4 + 1] = 100; pixels[i * 4 + 2] = 50; pixels[i * 4 + 3] = 128;
+		}
+
+		uint8_t block[16], decoded[64];
+		TexturePipeline::EncodeBC7Block(pixels, block);
+		TexturePipeline::DecodeBC7Block(block, decoded);
+		for (int32_t i = 0; i < 64; i++)
+		{
+			SUORA_CHECK(std::abs((int32_t)decoded[i] - (int32_t)pixels[i]) <= 1);
+		}
+
+		// Alpha is stored with eight interpolated values, the endpoints themselves are exact
+		TexturePipeline::EncodeBC4Block(pixels, 3, block);
+		TexturePipeline::DecodeBC4Block(block, 3, decoded);
+		for (int32_t i = 0; i < 16; i++)
+		{
+			SUORA_CHECK_EQ(decoded[i * 4 + 3], 128);
+		}
+
+		// RGB565 quantizes to 5 and 6 bits
+		TexturePipeline::EncodeBC1Block(pixels, block);
+		TexturePipeline::DecodeBC1Block(block, decoded);
+		for (int32_t i = 0; i < 16; i++)
+		{
+			SUORA_CHECK(std::abs((int32_t)decoded[i * 4 + 0] - 200) <= 4);
+			SUORA_CHECK(std::abs((int32_t)decoded[i * 4 + 1] - 100) <= 2);
+			SUORA_CHECK(std::abs((int32_t)decoded[i * 4 + 2] - 50) <= 4);
+		}
+	}
+
+	SUORA_TEST(TexturePipeline, SIMDAndScalarMipsAreIdentical)
+	{
+		TextureCookSettings settings;
+		settings.IsSRGB = false;
+		settings.IsNormalMap = false;
+
+		// Odd sizes and sizes below one SSE2 iteration take the scalar tail and the border clamping
+		for (uint32_t width : { 1u, 2u, 7u, 8u, 9u, 16u, 33u, 67u, 256u })
+		{
+			for (uint32_t height : { 1u, 3u, 16u, 35u })
+			{
+				const std::vector<uint8_t> rgba = MakeTestImage(width, height, width * 131 + height);
+
+				TexturePipeline::s_UseSIMD = true;
+				const std::vector<uint8_t> simd = TexturePipeline::GenerateMip(rgba, width, height, settings);
+				TexturePipeline::s_UseSIMD = false;
+				const std::vector<uint8_t> scalar = TexturePipeline::GenerateMip(rgba, width, height, settings);
+				TexturePipeline::s_UseSIMD = true;
+
+				SUORA_CHECK(simd == scalar);
+			}
+		}
+	}
+
+	SUORA_TEST(TexturePipeline, NormalMapMipsStayNormalized)
+	{
+		constexpr uint32_t width = 64, height = 64;
+		TestRandom random(5);
+		std::vector<uint8_t> rgba((size_t)width * height * 4);
+		for (size_t i = 0; i < (size_t)width * height; i++)
+		{
+			const Vec3 normal = glm::normalize(Vec3(random.Float(-1.0f, 1.0f), random.Float(-1.0f, 1.0f), random.Float(0.2f, 1.0f)));
+			rgba[i * 4 + 0] = (uint8_t)((normal.x + 1.0f) * 127.5f);
+			rgba[i * 4 + 1] = (uint8_t)((normal.y + 1.0f) * 127.5f);
+			rgba[i * 4 + 2] = (uint8_t)((normal.z + 1.0f) * 127.5f);
+			rgba[i * 4 + 3] = 255;
+		}
+
+		TextureCookSettings settings;
+		settings.IsNormalMap = true;
+		const std::vector<uint8_t> mip = TexturePipeline::GenerateMip(rgba, width, height, settings);
+		SUORA_REQUIRE(mip.size() == (size_t)width * height);
+		for (size_t i = 0; i < mip.size() / 4; i++)
+		{
+			const Vec3 normal = Vec3(mip[i * 4 + 0], mip[i * 4 + 1], mip[i * 4 + 2]) / 127.5f - 1.0f;
+			SUORA_CHECK_NEAR(glm::length(normal), 1.0f, 0.02f);
+		}
+	}
+
+	SUORA_BENCHMARK(TexturePipeline, Throughput)
+	{
+		constexpr uint32_t width = 1024, height = 1024;
+		const std::vector<uint8_t> rgba = MakeTestImage(width, height, 1024);
+		const double megapixels = (double)width * height / 1000000.0;
+
+		const std::pair<ETextureFormat, const char*> formats[] = { { ETextureFormat::BC1, "BC1" }, { ETextureFormat::BC3, "BC3" }, { ETextureFormat::BC5, "BC5" }, { ETextureFormat::BC7, "BC7" } };
+		for (const auto& [format, name] : formats)
+		{
+			const double ms = Benchmark(String("Encode 1024x1024 as ") + name, 5, [&]()
+			{
+				TexturePipeline::Encode(rgba.data(), width, height, format);
+			});
+			SuoraLog("  {0:.1f} MPix/s", megapixels / (ms / 1000.0));
+		}
+
+		const std::filesystem::path path = WriteTestImage("TexturePipelineTests_Benchmark", rgba, width, height);
+		{
+			TextureBuffer_stbi source(path.string());
+			TextureCookSettings settings;
+			TextureCookStats stats;
+			const double unmeasured = Benchmark("Cook 1024x1024", 5, [&]() { TexturePipeline::Cook(source, settings, &stats); });
+			TexturePipeline::s_MeasureQuality = true;
+			const double measured = Benchmark("Cook 1024x1024, measuring the PSNR", 5, [&]() { TexturePipeline::Cook(source, settings, &stats); });
+			TexturePipeline::s_MeasureQuality = false;
+			SuoraLog("  {0:.2f} dB PSNR, measuring it adds {1:.1f} ms", stats.PSNR, measured - unmeasured);
+		}
+		std::filesystem::remove(path);
+
+		TextureCookSettings linear;
+		linear.IsSRGB = false;
+		TexturePipeline::s_UseSIMD = true;
+		const double simd = Benchmark("GenerateMip 1024x1024, SSE2", 50, [&]() { TexturePipeline::GenerateMip(rgba, width, height, linear); });
+		TexturePipeline::s_UseSIMD = false;
+		const double scalar = Benchmark("GenerateMip 1024x1024, scalar", 50, [&]() { TexturePipeline::GenerateMip(rgba, width, height, linear); });
+		TexturePipeline::s_UseSIMD = true;
+		SuoraLog("  SSE2 mips {0:.1f}x faster than scalar", scalar / std::max(simd, 1e-6));
+
+		TextureCookSettings srgb;
+		Benchmark("GenerateMip 1024x1024, sRGB", 50, [&]() { TexturePipeline::GenerateMip(rgba, width, height, srgb); });
+	}
+
+}
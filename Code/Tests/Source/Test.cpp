@@ -0,0 +1,65 @@
+#include "Test.h"
+#include "Suora/Core/Log.h"
+
+namespace Suora::Tests
+{
+
+	std::vector<TestCase>& TestRegistry::GetTests()
+	{
+		// Function-local, the cases register themselves during static initialization
+		static std::vector<TestCase> tests;
+		return tests;
+	}
+
+	bool TestRegistry::Register(const TestCase& test)
+	{
+		GetTests().push_back(test);
+		return true;
+	}
+
+	uint32_t TestRegistry::Run(const String& filter, bool runBenchmarks)
+	{
+		uint32_t executed = 0;
+		uint32_t failed = 0;
+
+		for (const TestCase& test : GetTests())
+		{
+			const String fullName = String(test.Suite) + "." + test.Name;
+			if (test.IsBenchmark && !runBenchmarks) continue;
+			if (!filter.empty() && fullName.find(filter) == String::npos) continue;
+
+			SUORA_LOG(LogCategory::Debug, LogLevel::Info, "[ RUN    ] {0}", fullName);
+			s_CurrentFailures = 0;
+
+			const auto start = std::chrono::steady_clock::now();
+			test.Function();
+			const double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+			executed++;
+			if (s_CurrentFailures == 0)
+			{
+				SUORA_LOG(LogCategory::Debug, LogLevel::Info, "[     OK ] {0} ({1:.1f} ms)", fullName, milliseconds);
+			}
+			else
+			{
+				failed++;
+				SUORA_LOG(LogCategory::Debug, LogLevel::Error, "[ FAILED ] {0} ({1} failed checks)", fullName, s_CurrentFailures);
+			}
+		}
+
+		SUORA_LOG(LogCategory::Debug, (failed == 0 ? LogLevel::Info : LogLevel::Error), "{0} of {1} test cases passed.", executed - failed, executed);
+		return failed;
+	}
+
+	void TestRegistry::ReportFailure(const char* file, int line, const String& expression)
+	{
+		s_CurrentFailures++;
+		SUORA_LOG(LogCategory::Debug, LogLevel::Error, "{0}({1}): Check failed: {2}", file, line, expression);
+	}
+
+	void TestRegistry::ReportBenchmark(const String& label, double milliseconds, uint32_t iterations)
+	{
+		SUORA_LOG(LogCategory::Debug, LogLevel::Info, "  {0}: {1:.4f} ms (average of {2})", label, milliseconds, iterations);
+	}
+
+}
@@ -0,0 +1,83 @@
+#pragma once
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+#include "Suora/Core/Base.h"
+
+namespace Suora::Tests
+{
+
+	struct TestCase
+	{
+		const char* Suite = "";
+		const char* Name = "";
+		void (*Function)() = nullptr;
+		/** Benchmarks only run with --bench. They log timings, checks inside them still count as failures. */
+		bool IsBenchmark = false;
+	};
+
+	/* Collects the SUORA_TEST and SUORA_BENCHMARK cases of the executable and runs them one after another on the main thread */
+	class TestRegistry
+	{
+	public:
+		static bool Register(const TestCase& test);
+
+		/** Runs every case, whose "Suite.Name" contains the filter. Returns the number of failed cases. */
+		static uint32_t Run(const String& filter, bool runBenchmarks);
+
+		static void ReportFailure(const char* file, int line, const String& expression);
+		static void ReportBenchmark(const String& label, double milliseconds, uint32_t iterations);
+
+	private:
+		static std::vector<TestCase>& GetTests();
+
+		inline static uint32_t s_CurrentFailures = 0;
+	};
+
+	/** Seeded, so a failing case fails the same way again */
+	class TestRandom
+	{
+	public:
+		explicit TestRandom(uint32_t seed) : m_Engine(seed) { }
+
+		float Float(float min, float max) { return std::uniform_real_distribution<float>(min, max)(m_Engine); }
+		int32_t Int(int32_t min, int32_t max) { return std::uniform_int_distribution<int32_t>(min, max)(m_Engine); }
+
+	private:
+		std::mt19937 m_Engine;
+	};
+
+	/** Calls func once to warm up and then 'iterations' times. Logs and returns the average duration in milliseconds. */
+	template<class Fn>
+	double Benchmark(const String& label, uint32_t iterations, Fn&& func)
+	{
+		func();
+
+		const auto start = std::chrono::steady_clock::now();
+		for (uint32_t i = 0; i < iterations; i++)
+		{
+			func();
+		}
+		const double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / (double)iterations;
+
+		TestRegistry::ReportBenchmark(label, milliseconds, iterations);
+		return milliseconds;
+	}
+
+}
+
+#define SUORA_TEST_CASE_IMPL(Suite, Name, IsBenchmark) \
+	static void SuoraTest_##Suite##_##Name(); \
+	static const bool s_SuoraTestRegistered_##Suite##_##Name = ::Suora::Tests::TestRegistry::Register({ #Suite, #Name, &SuoraTest_##Suite##_##Name, IsBenchmark }); \
+	static void SuoraTest_##Suite##_##Name()
+
+#define SUORA_TEST(Suite, Name)         SUORA_TEST_CASE_IMPL(Suite, Name, false)
+#define SUORA_BENCHMARK(Suite, Name)    SUORA_TEST_CASE_IMPL(Suite, Name, true)
+
+#define SUORA_CHECK(_Expr)                          do { if (!(_Expr)) ::Suora::Tests::TestRegistry::ReportFailure(__FILE__, __LINE__, #_Expr); } while (false)
+#define SUORA_CHECK_EQ(_A, _B)                      SUORA_CHECK((_A) == (_B))
+#define SUORA_CHECK_NEAR(_A, _B, _Epsilon)          SUORA_CHECK(std::abs((_A) - (_B)) <= (_Epsilon))
+// Stops the current case, if the expression is false
+#define SUORA_REQUIRE(_Expr)                        do { if (!(_Expr)) { ::Suora::Tests::TestRegistry::ReportFailure(__FILE__, __LINE__, #_Expr); return; } } while (false)
@@ -0,0 +1,50 @@
+#include <Suora.h>
+#include "Test.h"
+
+extern void Modules_Init();
+
+namespace Suora::Tests
+{
+
+	/* The Engine without a Window or GraphicsContext. Enough for everything that runs on the CPU:
+	 * Worlds, physics, scripting, assets and the TaskScheduler. */
+	class TestApplication : public Application
+	{
+	public:
+		TestApplication(const ApplicationParams& params)
+			: Application(params)
+		{
+			Modules_Init();
+		}
+	};
+
+}
+
+/** Usage: Tests [--bench] [filter]
+ *  Runs all unit tests whose "Suite.Name" contains the filter, with --bench the benchmarks as well.
+ *  Returns a non-zero exit code, if any case failed. */
+int main(int argc, char** argv)
+{
+	Suora::Log::Init();
+
+	bool runBenchmarks = false;
+	Suora::String filter;
+	for (int i = 1; i < argc; i++)
+	{
+		const Suora::String arg = argv[i];
+		if (arg == "--bench")
+		{
+			runBenchmarks = true;
+		}
+		else
+		{
+			filter = arg;
+		}
+	}
+
+	Suora::ApplicationParams params;
+	params.IsEditor = false;
+	Suora::Tests::TestApplication app(params);
+
+	return Suora::Tests::TestRegistry::Run(filter, runBenchmarks) == 0 ? 0 : 1;
+}
@@ -49,4 +49,5 @@ group ""
 include "Code/Engine/Engine.lua"
 include "Code/Editor/Editor.lua"
 include "Code/Runtime/Runtime.lua"
+include "Code/Tests/Tests.lua"
 include "Code/SuoraBuildTool/project.lua"